@@ -0,0 +1,85 @@
+# Compares two ways of computing n! with arbitrary-precision ints, both running through the
+# transpiler. The running product multiplies a growing product by one small factor at a time,
+# while binary splitting multiplies the products of both halves of the range recursively - so
+# that the large multiplications are between operands of similar sizes, where Karatsuba's
+# algorithm pays off. Both have to arrive at the same result. Build and run it with:
+#
+#     pyton build -O -i benchmarks/factorial.py
+#     pyton run -t factorial
+#
+# Only `while` loops are used, as the transpiler does not support `range` yet. As there is no
+# garbage collector yet either, every intermediate product stays allocated - so each size is
+# only repeated a fixed number of times, instead of for a minimum duration.
+
+from time import monotonic_ns
+
+# Pairs of `n` and the number of times to compute `n!` for.
+SIZES = [(20, 50), (100, 5), (1000, 1), (2000, 1)]
+
+def show(text):
+    print(text)
+
+def running_product(n):
+    result = 1
+    i = 2
+    while i <= n:
+        result *= i
+        i += 1
+
+    return result
+
+# Returns the product of all integers in [low, high).
+def range_product(low, high):
+    if high - low <= 8:
+        result = 1
+        while low < high:
+            result *= low
+            low += 1
+
+        return result
+
+    middle = (low + high) // 2
+    return range_product(low, middle) * range_product(middle, high)
+
+def split_product(n):
+    return range_product(2, n + 1)
+
+# Returns the average duration of `running_product(n)`, in nanoseconds, and its result.
+def time_running(n, runs):
+    result = 0
+    start = monotonic_ns()
+    i = 0
+    while i < runs:
+        result = running_product(n)
+        i += 1
+
+    return ((monotonic_ns() - start) // runs, result)
+
+# Returns the average duration of `split_product(n)`, in nanoseconds, and its result.
+def time_split(n, runs):
+    result = 0
+    start = monotonic_ns()
+    i = 0
+    while i < runs:
+        result = split_product(n)
+        i += 1
+
+    return ((monotonic_ns() - start) // runs, result)
+
+def report(name, ns):
+    show(name + ": " + str(ns) + " ns")
+
+def main():
+    for size in SIZES:
+        n = size[0]
+        runs = size[1]
+
+        running = time_running(n, runs)
+        split = time_split(n, runs)
+
+        show(str(n) + "! (" + str(len(str(running[1]))) + " digits)")
+        report("  running product", running[0])
+        report("  binary splitting", split[0])
+        show("  results match: " + str(running[1] == split[1]))
+
+main()
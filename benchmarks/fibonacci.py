@@ -0,0 +1,96 @@
+# Compares two ways of computing the n-th Fibonacci number, both running through the
+# transpiler. Iterating the recurrence performs n additions, of ints that grow by about 0.7
+# bits each step - which stay inline up to F(92), and are arbitrary-precision afterwards. Fast
+# doubling only needs a logarithmic number of steps, via the identities
+#
+#     F(2k)     = F(k) * (2 * F(k + 1) - F(k))
+#     F(2k + 1) = F(k)^2 + F(k + 1)^2
+#
+# and so mostly measures big int multiplication. Both have to arrive at the same result.
+# Build and run it with:
+#
+#     pyton build -O -i benchmarks/fibonacci.py
+#     pyton run -t fibonacci
+#
+# Only `while` loops are used, as the transpiler does not support `range` yet. As there is no
+# garbage collector yet either, every intermediate value stays allocated - so each size is
+# only repeated a fixed number of times, instead of for a minimum duration.
+
+from time import monotonic_ns
+
+# Pairs of `n` and the number of times to compute `F(n)` for.
+SIZES = [(90, 20), (1000, 2), (5000, 1)]
+
+def show(text):
+    print(text)
+
+def iterative_fibonacci(n):
+    a = 0
+    b = 1
+    i = 0
+    while i < n:
+        next_b = a + b
+        a = b
+        b = next_b
+        i += 1
+
+    return a
+
+# Returns the pair `(F(n), F(n + 1))`.
+def fibonacci_pair(n):
+    if n == 0:
+        return (0, 1)
+
+    half = fibonacci_pair(n // 2)
+    a = half[0]
+    b = half[1]
+
+    even = a * (2 * b - a)
+    odd = a * a + b * b
+    if n % 2 == 0:
+        return (even, odd)
+
+    return (odd, even + odd)
+
+def doubling_fibonacci(n):
+    return fibonacci_pair(n)[0]
+
+# Returns the average duration of `iterative_fibonacci(n)`, in nanoseconds, and its result.
+def time_iterative(n, runs):
+    result = 0
+    start = monotonic_ns()
+    i = 0
+    while i < runs:
+        result = iterative_fibonacci(n)
+        i += 1
+
+    return ((monotonic_ns() - start) // runs, result)
+
+# Returns the average duration of `doubling_fibonacci(n)`, in nanoseconds, and its result.
+def time_doubling(n, runs):
+    result = 0
+    start = monotonic_ns()
+    i = 0
+    while i < runs:
+        result = doubling_fibonacci(n)
+        i += 1
+
+    return ((monotonic_ns() - start) // runs, result)
+
+def report(name, ns):
+    show(name + ": " + str(ns) + " ns")
+
+def main():
+    for size in SIZES:
+        n = size[0]
+        runs = size[1]
+
+        iterative = time_iterative(n, runs)
+        doubling = time_doubling(n, runs)
+
+        show("F(" + str(n) + ") (" + str(len(str(iterative[1]))) + " digits)")
+        report("  iteration", iterative[0])
+        report("  fast doubling", doubling[0])
+        show("  results match: " + str(iterative[1] == doubling[1]))
+
+main()
@@ -0,0 +1,142 @@
+# Compares `@` on `matrix` objects against a naive triple loop written in Python, with both
+# running through the transpiler. The naive version multiplies lists of lists, which is what
+# `@` would otherwise have to be written as. Both products are summed in the same order, so
+# the results are expected to be exactly equal. Build and run it with:
+#
+#     pyton build -O -i benchmarks/matmul.py
+#     pyton run -t matmul
+#
+# Only `while` loops are used, as the transpiler does not support `range` yet. As there is no
+# garbage collector yet either, the naive product is kept small - every boxed float it
+# creates stays allocated - and the elements of larger matrices are tiled from an `array`.
+
+from array import array
+from matrix import matrix
+from time import monotonic_ns
+
+NAIVE_SIZE = 24
+LARGE_SIZE = 256
+
+# The minimum duration to repeat each timed product for, in nanoseconds. This is well above
+# the resolution of the clock.
+MIN_DURATION_NS = 200000000
+
+def show(text):
+    print(text)
+
+def lcg(state):
+    return (state * 1103515245 + 12345) % 2147483648
+
+# Returns `n * n` pseudo-random floats in row-major order.
+def random_elements(n, seed):
+    elements = []
+    state = seed
+    i = 0
+    while i < n * n:
+        state = lcg(state)
+        elements.append((state % 2001 - 1000) / 64)
+        i += 1
+
+    return elements
+
+# Returns `n * n` elements that repeat a shorter run of pseudo-random floats.
+def tiled_elements(n, seed):
+    elements = array("d", random_elements(32, seed))
+    while len(elements) < n * n:
+        elements.extend(elements)
+
+    return elements[:n * n]
+
+# Splits `n * n` row-major elements into a list of `n` rows.
+def to_rows(elements, n):
+    rows = []
+    i = 0
+    while i < n:
+        rows.append(elements[i * n:(i + 1) * n])
+        i += 1
+
+    return rows
+
+def naive_matmul(a, b, n):
+    c = []
+    i = 0
+    while i < n:
+        row = []
+        j = 0
+        while j < n:
+            total = 0.0
+            k = 0
+            while k < n:
+                total += a[i][k] * b[k][j]
+                k += 1
+
+            row.append(total)
+            j += 1
+
+        c.append(row)
+        i += 1
+
+    return c
+
+def count_mismatches(expected, actual, n):
+    mismatches = 0
+    i = 0
+    while i < n:
+        j = 0
+        while j < n:
+            if expected[i][j] != actual.get(i, j):
+                mismatches += 1
+
+            j += 1
+
+        i += 1
+
+    return mismatches
+
+# Returns the average duration of `a @ b`, in nanoseconds.
+def time_matmul(a, b):
+    start = monotonic_ns()
+    elapsed = 0
+    runs = 0
+    while elapsed < MIN_DURATION_NS:
+        a @ b
+        runs += 1
+        elapsed = monotonic_ns() - start
+
+    return elapsed // runs
+
+def report(name, ns):
+    show(name + ": " + str(ns) + " ns")
+
+def main():
+    n = NAIVE_SIZE
+    a_elements = random_elements(n, 1)
+    b_elements = random_elements(n, 2)
+
+    a_rows = to_rows(a_elements, n)
+    b_rows = to_rows(b_elements, n)
+    a = matrix("d", n, n, a_elements)
+    b = matrix("d", n, n, b_elements)
+
+    start = monotonic_ns()
+    expected = naive_matmul(a_rows, b_rows, n)
+    naive_ns = monotonic_ns() - start
+
+    native_ns = time_matmul(a, b)
+    mismatches = count_mismatches(expected, a @ b, n)
+
+    show(str(n) + "x" + str(n) + " @ " + str(n) + "x" + str(n))
+    report("  naive Python", naive_ns)
+    report("  matrix", native_ns)
+    show("  speedup: " + str(naive_ns // native_ns) + "x")
+    show("  mismatched elements: " + str(mismatches))
+
+    n = LARGE_SIZE
+    a = matrix("d", n, n, tiled_elements(n, 3))
+    b = matrix("d", n, n, tiled_elements(n, 4))
+
+    show(str(n) + "x" + str(n) + " @ " + str(n) + "x" + str(n))
+    report("  matrix", time_matmul(a, b))
+    report("  matrix, transposed operand", time_matmul(a, b.transpose()))
+
+main()
@@ -0,0 +1,108 @@
+# Compares `pow(a, b, m)` against square-and-multiply written in Python, both running through
+# the transpiler, for moduli of increasing sizes. A modulus that fits in a word is handled
+# without allocating any big ints; larger ones go through arbitrary-precision arithmetic.
+# Every modulus is a prime, so the results can be checked with Fermat's little theorem -
+# `pow(a, m - 1, m)` has to be 1 - and every base has a modular inverse, which is computed
+# via `pow(a, -1, m)` and checked as well. Build and run it with:
+#
+#     pyton build -O -i benchmarks/powmod.py
+#     pyton run -t powmod
+#
+# Only `while` loops are used, as the transpiler does not support `range` yet. As there is no
+# garbage collector yet either, every intermediate value stays allocated - so each modulus is
+# only used a fixed number of times, instead of for a minimum duration.
+
+from time import monotonic_ns
+
+# Pairs of a prime modulus and the number of exponentiations to perform with it.
+MODULI = [
+    (1000000007, 20),
+    (2 ** 61 - 1, 10),
+    (2 ** 127 - 1, 5),
+    (2 ** 521 - 1, 2),
+    (2 ** 1279 - 1, 1)
+]
+
+def show(text):
+    print(text)
+
+def lcg(state):
+    return (state * 1103515245 + 12345) % 2147483648
+
+# Returns `(base ** exp) % mod` via right-to-left binary exponentiation.
+def naive_powmod(base, exp, mod):
+    result = 1
+    base %= mod
+    while exp > 0:
+        if exp % 2 == 1:
+            result = result * base % mod
+
+        base = base * base % mod
+        exp //= 2
+
+    return result
+
+# Returns `count` pseudo-random bases in [2, mod).
+def random_bases(mod, count):
+    bases = []
+    state = mod % 2147483648
+    i = 0
+    while i < count:
+        state = lcg(state)
+        bases.append(state * state * state % (mod - 2) + 2)
+        i += 1
+
+    return bases
+
+# Returns the duration of computing `pow(a, mod - 1, mod)` for all bases, in nanoseconds,
+# and the number of results that aren't 1.
+def time_builtin(bases, mod):
+    failures = 0
+    start = monotonic_ns()
+    for base in bases:
+        if pow(base, mod - 1, mod) != 1:
+            failures += 1
+
+    return (monotonic_ns() - start, failures)
+
+# Equivalent to `time_builtin`, but for `naive_powmod`.
+def time_naive(bases, mod):
+    failures = 0
+    start = monotonic_ns()
+    for base in bases:
+        if naive_powmod(base, mod - 1, mod) != 1:
+            failures += 1
+
+    return (monotonic_ns() - start, failures)
+
+# Returns the duration of computing `pow(a, -1, mod)` for all bases, in nanoseconds, and
+# the number of results that aren't inverses.
+def time_inverse(bases, mod):
+    failures = 0
+    start = monotonic_ns()
+    for base in bases:
+        if base * pow(base, -1, mod) % mod != 1:
+            failures += 1
+
+    return (monotonic_ns() - start, failures)
+
+def report(name, ns, runs):
+    show(name + ": " + str(ns // runs) + " ns")
+
+def main():
+    for modulus in MODULI:
+        mod = modulus[0]
+        runs = modulus[1]
+        bases = random_bases(mod, runs)
+
+        builtin = time_builtin(bases, mod)
+        naive = time_naive(bases, mod)
+        inverse = time_inverse(bases, mod)
+
+        show("mod " + str(len(str(mod))) + " digits")
+        report("  naive Python", naive[0], runs)
+        report("  pow(a, b, m)", builtin[0], runs)
+        report("  pow(a, -1, m)", inverse[0], runs)
+        show("  failed checks: " + str(builtin[1] + naive[1] + inverse[1]))
+
+main()
@@ -17,6 +17,8 @@ def build_command(args: argparse.Namespace):
     assert type(args.input) is str
     assert type(args.artifacts) is str
     assert type(args.optimize) is bool
+    assert type(args.console) is str
+    assert type(args.serial_irq) is bool
 
     entrypoint_source = open(args.input).read()
     compiled = compile(entrypoint_source, args.input, "exec")
@@ -43,17 +45,24 @@ def build_command(args: argparse.Namespace):
 
     tmp_iso_root = os.path.join(args.artifacts, "obj", "iso")
 
+    boot_options = [f"console={args.console}"]
+    if args.serial_irq:
+        boot_options.append("serial=irq")
+
     create_iso(
         kernel_binary,
         os.path.join(package_root, "resource/iso"),
         tmp_iso_root,
         os.path.join(package_root, "lib/limine"),
-        os.path.join(args.artifacts, f"{kernel_name}.iso")
+        os.path.join(args.artifacts, f"{kernel_name}.iso"),
+        " ".join(boot_options)
     )
 
 def run_command(args: argparse.Namespace):
     assert type(args.target) is str
     assert type(args.debug) is bool
+    assert type(args.serial) is bool
+    assert type(args.headless) is bool
 
     if args.target.endswith(".iso"):
         print("(warning) target kernel ends with '.iso' - 'run' expects an extensionless name")
@@ -87,6 +96,12 @@ def run_command(args: argparse.Namespace):
     if args.debug:
         qemu_args.extend(["-S", "-s"])
 
+    if args.headless:
+        qemu_args.extend(["-display", "none"])
+
+    if args.serial or args.headless:
+        qemu_args.extend(["-serial", "stdio"])
+
     subprocess.run(qemu_args)
 
 def debug_command(args: argparse.Namespace):
@@ -117,10 +132,14 @@ def main():
     build_parser.add_argument("-i", "--input", type=str, required=True, help="the main entry-point file")
     build_parser.add_argument("-a", "--artifacts", default="artifacts", help="the directory to write all artifacts to")
     build_parser.add_argument("-O", "--optimize", action="store_true", help="enables GCC optimizations")
+    build_parser.add_argument("-c", "--console", choices=["framebuffer", "serial", "both"], default="framebuffer", help="where the kernel writes its output to")
+    build_parser.add_argument("--serial-irq", action="store_true", help="transmit serial output from an interrupt-driven buffer")
 
     run_parser = subparsers.add_parser("run", help="Run a compiled Pyton kernel in QEMU")
     run_parser.add_argument("-t", "--target", required=True, help="the name of the kernel under ./artifacts, w/o extension")
     run_parser.add_argument("-d", "--debug", action="store_true", help="wait for GDB to attach")
+    run_parser.add_argument("-s", "--serial", action="store_true", help="connect the serial port to stdio")
+    run_parser.add_argument("--headless", action="store_true", help="run without a display, with the serial port connected to stdio")
 
     debug_parser = subparsers.add_parser("debug", help="Launches GDB targetting the given kernel")
     debug_parser.add_argument("-t", "--target", required=True, help="the name of the kernel under ./artifacts, w/o extension")
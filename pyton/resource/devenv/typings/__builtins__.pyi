@@ -8,42 +8,61 @@ def write16(address: int, value: int) -> None: ...
 def write32(address: int, value: int) -> None: ...
 def write64(address: int, value: int) -> None: ...
 
+def read_block(address: int, buffer: bytearray | memoryview) -> None:
+    """
+    Fills the whole writable `buffer` with the bytes of physical memory starting at
+    `address`. To read fewer bytes, pass a slice of a `memoryview` of the buffer.
+    """
+    ...
+
+def write_block(address: int, data: bytes | bytearray | memoryview) -> None:
+    """
+    Copies all bytes of `data` to physical memory, starting at `address`.
+    """
+    ...
+
+def physical_memory(address: int, length: int) -> memoryview:
+    """
+    Returns a writable `memoryview` of unsigned bytes over `length` bytes of physical
+    memory, starting at `address`. Elements are accessed with volatile loads and stores
+    of their exact width, so `physical_memory(base, 16).cast("I")[1]` performs a single
+    32-bit read of the register at `base + 4`.
+    """
+    ...
+
 def extern(fn):
     """
     Specifies that a Python function declaration should be a marshalling stub to
     an imported native method.
     ```
         @extern
-        def terminal_println(text: str) -> None: ...
+        def uart_send(text: str) -> None: ...
     ```
 
     Python objects will be marshalled to their C forms as follows:
-    - `str` -> `const char*`,
-    - `int` -> `int64_t`,
+    - `str` -> `string_t`,
+    - `int` -> `int64_t` (an `OverflowError` is raised for values that don't fit),
     - `float` -> `double`,
-    - `bool` -> `int` (`True` = `1`, `False` = `0`),
-    - `NoneType` -> `uint64_t` of value `NULL`,
-    - everything else -> `pyobj_t*`.
-
-    Functions with this decorator must have their return type and parameters type-hinted.
-    Parameters may be any type, while the return type is constrained to these type hints:
-    - `str`: equivalent to `(const char*)ret_val`,
-    - `bool`: `True` when `ret_val != 0`, `False` otherwise,
-    - `int`: equivalent to `(int64_t)ret_val`,
-    - `float`: equivalent to `(double)ret_val`,
-    - `None`: `ret_val` is discarded, always `py_none`.
-
-    This means that any C functions that return structures are not supported. They
-    must return a value that fits inside a 64-bit register (pointers, integers, or
-    floating-point values up to `double`).
+    - `bool` -> `bool`,
+    - `None` -> `void*` of value `NULL`,
+    - everything else (including parameters without a type hint) -> `pyobj_t*`.
+
+    Arguments of a different type raise a `TypeError`. The return type is marshalled
+    back the same way - a `pyobj_t*` is returned as-is, and a function without a return
+    type hint returns `void`, which becomes `None`.
+
+    Calls to the function that pass all arguments positionally are compiled to direct
+    calls of the symbol, which only box the return value.
     """
     return fn
 
 def c_function(fn):
     '''
     Specifies that a Python function returns a string literal that is intended to be
-    embedded directly into the transpiled source code of the resulting binary.
-    For the parameters, the same marshalling rules apply as with `@extern`.
+    embedded directly into the transpiled source code of the resulting binary, as the
+    body of a `static inline` C function. The parameters are available under their
+    Python names, and the same marshalling rules apply as with `@extern` - including
+    the direct calls, which the C compiler can inline.
     ```
         @c_function
         def outb(port: int, value: int):
@@ -0,0 +1,1439 @@
+#include "arrays.h"
+
+#include <immintrin.h>
+#include "ints.h"
+#include "lists.h"
+#include "dicts.h"
+#include "slices.h"
+#include "buffers.h"
+#include "opcodes.h"
+#include "std/memory.h"
+#include "std/safety.h"
+#include "std/string.h"
+#include "std/strscan.h"
+#include "sys/cpu.h"
+#include "sys/mm.h"
+
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+
+// Returns `true` if the AVX2 variants of the kernels can be used.
+static inline bool use_avx2(void) {
+    return cpu_get_features()->avx2;
+}
+
+// Returns the size of a single element of the given typecode, or 0 if the typecode isn't
+// supported.
+static uint8_t typecode_itemsize(char typecode) {
+    switch (typecode) {
+        case 'b': return 1;
+        case 'h': return 2;
+        case 'i': case 'f': return 4;
+        case 'q': case 'd': return 8;
+        default: return 0;
+    }
+}
+
+// Returns `true` if the given typecode represents floating-point elements.
+static inline bool typecode_is_float(char typecode) {
+    return typecode == 'f' || typecode == 'd';
+}
+
+pyobj_t* py_alloc_array_of(char typecode, size_t length) {
+    uint8_t itemsize = typecode_itemsize(typecode);
+    ASSERT(itemsize != 0);
+
+    // Unlike `bytearray`s, arrays always have storage, even when they're empty.
+    size_t size = length * itemsize;
+    size_t capacity = MAX(size, 64);
+    uint8_t* data = mm_heap_alloc(capacity);
+    memset(data, 0, size);
+
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = &py_type_array_array;
+    obj->as_buffer = (struct buffer_data) {
+        .data = data,
+        .length = size,
+        .capacity = capacity,
+        .format = typecode,
+        .itemsize = itemsize,
+        .readonly = false
+    };
+
+    return obj;
+}
+
+// Ensures that the given `array` has room for at least `capacity` bytes. Like with
+// `bytearray`s, this may move its storage.
+static void array_reserve(pyobj_t* array, size_t capacity) {
+    struct buffer_data* data = &array->as_buffer;
+    if (capacity <= data->capacity)
+        return;
+
+    size_t new_capacity = MAX(MAX(capacity, data->capacity * 2), 64);
+    uint8_t* storage = mm_heap_alloc(new_capacity);
+
+    memcpy(storage, data->data, data->length);
+    mm_heap_free(data->data);
+
+    data->data = storage;
+    data->capacity = new_capacity;
+}
+
+// Converts `value` to an element of the given typecode, storing it at `p`. Returns an
+// exception or NULL.
+static pyobj_t* store_item(char typecode, uint8_t* p, pyobj_t* value) {
+    if (typecode_is_float(typecode)) {
+        double x;
+
+        if (value->type == &py_type_float) {
+            x = value->as_float;
+        }
+        else if (value->type == &py_type_int) {
+            if (!py_int_to_double(value, &x))
+                return NEW_EXCEPTION_INLINE(OverflowError, "int too large to convert to float");
+        }
+        else {
+            return NEW_EXCEPTION_INLINE(TypeError, "must be real number");
+        }
+
+        if (typecode == 'f') {
+            *(float*)p = (float)x;
+        }
+        else {
+            *(double*)p = x;
+        }
+
+        return NULL;
+    }
+
+    if (value->type != &py_type_int)
+        return NEW_EXCEPTION_INLINE(TypeError, "an integer is required");
+
+    int64_t x = value->as_int;
+
+    switch (typecode) {
+        case 'b':
+            if (!PY_INT_IS_SMALL(value) || x > INT8_MAX || x < INT8_MIN) {
+                return PY_INT_IS_SMALL(value) ? x < 0
+                    ? NEW_EXCEPTION_INLINE(OverflowError, "signed char is less than minimum")
+                    : NEW_EXCEPTION_INLINE(OverflowError, "signed char is greater than maximum")
+                    : NEW_EXCEPTION_INLINE(OverflowError, "Python int too large to convert to C long");
+            }
+
+            *(int8_t*)p = (int8_t)x;
+            return NULL;
+        case 'h':
+            if (!PY_INT_IS_SMALL(value) || x > INT16_MAX || x < INT16_MIN) {
+                return PY_INT_IS_SMALL(value) ? x < 0
+                    ? NEW_EXCEPTION_INLINE(OverflowError, "signed short integer is less than minimum")
+                    : NEW_EXCEPTION_INLINE(OverflowError, "signed short integer is greater than maximum")
+                    : NEW_EXCEPTION_INLINE(OverflowError, "Python int too large to convert to C long");
+            }
+
+            *(int16_t*)p = (int16_t)x;
+            return NULL;
+        case 'i':
+            if (!PY_INT_IS_SMALL(value) || x > INT32_MAX || x < INT32_MIN) {
+                return PY_INT_IS_SMALL(value) ? x < 0
+                    ? NEW_EXCEPTION_INLINE(OverflowError, "signed integer is less than minimum")
+                    : NEW_EXCEPTION_INLINE(OverflowError, "signed integer is greater than maximum")
+                    : NEW_EXCEPTION_INLINE(OverflowError, "Python int too large to convert to C long");
+            }
+
+            *(int32_t*)p = (int32_t)x;
+            return NULL;
+        default:
+            if (!PY_INT_IS_SMALL(value))
+                return NEW_EXCEPTION_INLINE(OverflowError, "Python int too large to convert to C long long");
+
+            *(int64_t*)p = x;
+            return NULL;
+    }
+}
+
+pyreturn_t py_alloc_array(pyobj_t* typecode, pyobj_t* initializer) {
+    ENSURE_NOT_NULL(typecode);
+
+    if (typecode->type != &py_type_str || typecode->as_str.length != 1)
+        RAISE(TypeError, "array() argument 1 must be a unicode character");
+
+    char code = typecode->as_str.str[0];
+    if (typecode_itemsize(code) == 0)
+        RAISE(ValueError, "bad typecode (must be b, h, i, q, f or d)");
+
+    pyobj_t* array = py_alloc_array_of(code, 0);
+    if (initializer == NULL)
+        return WITH_RESULT(array);
+
+    if (initializer->type == &py_type_str)
+        RAISE(TypeError, "cannot use a str to initialize an array with a typecode other than 'u'");
+
+    // `bytes` and `bytearray`s are taken as the raw contents of the array.
+    if (initializer->type == &py_type_bytes || initializer->type == &py_type_bytearray) {
+        uint8_t* data;
+        size_t length;
+        ASSERT(py_get_buffer(initializer, &data, &length));
+
+        if (length % array->as_buffer.itemsize != 0)
+            RAISE(ValueError, "bytes length not a multiple of item size");
+
+        array_reserve(array, length);
+        memcpy(array->as_buffer.data, data, length);
+        array->as_buffer.length = length;
+        return WITH_RESULT(array);
+    }
+
+    pyobj_t* exception = py_array_extend(array, initializer);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(array);
+}
+
+pyobj_t* py_alloc_array_iterator(pyobj_t* array) {
+    ENSURE_NOT_NULL(array);
+    ASSERT(PY_IS_ARRAY(array));
+
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = &py_type_array_iterator;
+    obj->as_list_iterator.sequence = array;
+    obj->as_list_iterator.index = 0;
+    return obj;
+}
+
+pyobj_t* py_array_iterator_next(pyobj_t* iterator) {
+    ENSURE_NOT_NULL(iterator);
+    ASSERT(iterator->type == &py_type_array_iterator);
+
+    // We check the length on every step, as the array might change while we iterate.
+    struct list_iterator_data* data = &iterator->as_list_iterator;
+    if (data->index >= py_array_length(data->sequence))
+        return NULL;
+
+    return py_array_item(data->sequence, data->index++);
+}
+
+// Resolves `index` to the position of an element within the given `array`, where negative
+// indices count from the end. Returns an exception or NULL.
+static pyobj_t* resolve_index(pyobj_t* array, pyobj_t* index, size_t* out_index) {
+    *out_index = 0;
+
+    if (index->type != &py_type_int)
+        return NEW_EXCEPTION_INLINE(TypeError, "array indices must be integers");
+
+    int64_t length = (int64_t)py_array_length(array);
+    int64_t i = index->as_int;
+
+    if (PY_INT_IS_SMALL(index) && i < 0) {
+        i += length;
+    }
+
+    if (!PY_INT_IS_SMALL(index) || i < 0 || i >= length)
+        return NEW_EXCEPTION_INLINE(IndexError, "array index out of range");
+
+    *out_index = (size_t)i;
+    return NULL;
+}
+
+pyreturn_t py_array_getitem(pyobj_t* array, pyobj_t* index) {
+    ENSURE_NOT_NULL(array);
+    ENSURE_NOT_NULL(index);
+    ASSERT(PY_IS_ARRAY(array));
+
+    if (index->type == &py_type_slice) {
+        int64_t start, stop, step, count;
+        pyobj_t* exception = py_slice_resolve(index, (int64_t)py_array_length(array), &start, &stop, &step, &count);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        size_t itemsize = array->as_buffer.itemsize;
+        pyobj_t* result = py_alloc_array_of(array->as_buffer.format, (size_t)count);
+        const uint8_t* source = array->as_buffer.data;
+
+        if (step == 1) {
+            memcpy(result->as_buffer.data, source + (size_t)start * itemsize, (size_t)count * itemsize);
+        }
+        else {
+            for (int64_t i = 0; i < count; i++) {
+                memcpy(
+                    result->as_buffer.data + (size_t)i * itemsize,
+                    source + (size_t)(start + i * step) * itemsize,
+                    itemsize
+                );
+            }
+        }
+
+        return WITH_RESULT(result);
+    }
+
+    size_t i;
+    pyobj_t* exception = resolve_index(array, index, &i);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(py_array_item(array, i));
+}
+
+// Implements `array[slice] = value`, where `value` has to be an `array` of the same typecode.
+static pyobj_t* array_setslice(pyobj_t* array, pyobj_t* slice, pyobj_t* value) {
+    if (!PY_IS_ARRAY(value))
+        return NEW_EXCEPTION_INLINE(TypeError, "can only assign array to array slice");
+
+    if (value->as_buffer.format != array->as_buffer.format)
+        return NEW_EXCEPTION_INLINE(TypeError, "bad argument type for built-in operation");
+
+    int64_t start, stop, step, count;
+    pyobj_t* exception = py_slice_resolve(slice, (int64_t)py_array_length(array), &start, &stop, &step, &count);
+    if (exception != NULL)
+        return exception;
+
+    size_t itemsize = array->as_buffer.itemsize;
+    size_t source_length = value->as_buffer.length;
+
+    // Assigning an array to a slice of itself reads the elements we're overwriting.
+    const uint8_t* source = value->as_buffer.data;
+    if (value == array && source_length != 0) {
+        uint8_t* copy = mm_heap_alloc(source_length);
+        memcpy(copy, source, source_length);
+        source = copy;
+    }
+
+    if (step != 1) {
+        if ((size_t)count * itemsize != source_length)
+            return NEW_EXCEPTION_INLINE(ValueError, "attempt to assign array to extended slice of a different size");
+
+        for (int64_t i = 0; i < count; i++) {
+            memcpy(
+                array->as_buffer.data + (size_t)(start + i * step) * itemsize,
+                source + (size_t)i * itemsize,
+                itemsize
+            );
+        }
+
+        return NULL;
+    }
+
+    // A contiguous slice may be replaced by any number of elements, which moves the ones
+    // that follow it.
+    struct buffer_data* data = &array->as_buffer;
+    size_t offset = (size_t)start * itemsize;
+    size_t removed = (size_t)count * itemsize;
+    size_t tail = data->length - offset - removed;
+
+    array_reserve(array, data->length - removed + source_length);
+    memmove(data->data + offset + source_length, data->data + offset + removed, tail);
+    memcpy(data->data + offset, source, source_length);
+    data->length = data->length - removed + source_length;
+    return NULL;
+}
+
+pyobj_t* py_array_setitem(pyobj_t* array, pyobj_t* index, pyobj_t* value) {
+    ENSURE_NOT_NULL(array);
+    ENSURE_NOT_NULL(index);
+    ENSURE_NOT_NULL(value);
+    ASSERT(PY_IS_ARRAY(array));
+
+    if (index->type == &py_type_slice)
+        return array_setslice(array, index, value);
+
+    size_t i;
+    pyobj_t* exception = resolve_index(array, index, &i);
+    if (exception != NULL)
+        return exception;
+
+    return store_item(array->as_buffer.format, array->as_buffer.data + i * array->as_buffer.itemsize, value);
+}
+
+pyobj_t* py_array_append(pyobj_t* array, pyobj_t* item) {
+    ENSURE_NOT_NULL(array);
+    ENSURE_NOT_NULL(item);
+    ASSERT(PY_IS_ARRAY(array));
+
+    struct buffer_data* data = &array->as_buffer;
+    array_reserve(array, data->length + data->itemsize);
+
+    pyobj_t* exception = store_item(data->format, data->data + data->length, item);
+    if (exception != NULL)
+        return exception;
+
+    data->length += data->itemsize;
+    return NULL;
+}
+
+pyobj_t* py_array_extend(pyobj_t* array, pyobj_t* iterable) {
+    ENSURE_NOT_NULL(array);
+    ENSURE_NOT_NULL(iterable);
+    ASSERT(PY_IS_ARRAY(array));
+
+    struct buffer_data* data = &array->as_buffer;
+
+    if (PY_IS_ARRAY(iterable)) {
+        if (iterable->as_buffer.format != data->format)
+            return NEW_EXCEPTION_INLINE(TypeError, "can only extend with array of same kind");
+
+        // We read the length first, as the array might be extended with itself.
+        size_t count = iterable->as_buffer.length;
+        array_reserve(array, data->length + count);
+        memmove(data->data + data->length, iterable->as_buffer.data, count);
+        data->length += count;
+        return NULL;
+    }
+
+    // We go through the same logic `GET_ITER` and `FOR_ITER` use, on a stack of our own.
+    void* stack[2] = { iterable };
+    int stack_current = 0;
+
+    pyreturn_t status = py_opcode_get_iter(stack, &stack_current);
+    if (status.exception != NULL)
+        return status.exception;
+
+    array_reserve(array, data->length + py_length_hint(stack[0]) * data->itemsize);
+
+    while (true) {
+        bool exhausted;
+        status = py_opcode_for_iter(stack, &stack_current, &exhausted);
+
+        if (status.exception != NULL)
+            return status.exception;
+
+        if (exhausted)
+            return NULL;
+
+        pyobj_t* exception = py_array_append(array, (pyobj_t*)stack[stack_current--]);
+        if (exception != NULL)
+            return exception;
+    }
+}
+
+static inline __m128i load16(const void* p) {
+    return _mm_loadu_si128((const __m128i*)p);
+}
+
+AVX2 static inline __m256i load32(const void* p) {
+    return _mm256_loadu_si256((const __m256i*)p);
+}
+
+// Converts a 128-bit integer to an `int` object.
+static pyobj_t* box_int128(__int128 x) {
+    if (x >= INT64_MIN && x <= INT64_MAX)
+        return py_alloc_int((int64_t)x);
+
+    return py_int_from_bytes((const uint8_t*)&x, sizeof(x), true, true);
+}
+
+// Sums `n` signed bytes. Biasing each byte by 128 makes it unsigned, which lets `psadbw`
+// sum eight of them at a time into a 64-bit lane.
+static int64_t sum_i8(const int8_t* x, size_t n) {
+    __m128i bias = _mm_set1_epi8((char)0x80);
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_xor_si128(load16(&x[i]), bias), _mm_setzero_si128()));
+    }
+
+    int64_t total = _mm_cvtsi128_si64(acc) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc)) - 128 * (int64_t)i;
+    for (; i < n; i++) {
+        total += x[i];
+    }
+
+    return total;
+}
+
+AVX2 static int64_t sum_i8_avx2(const int8_t* x, size_t n) {
+    __m256i bias = _mm256_set1_epi8((char)0x80);
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_xor_si256(load32(&x[i]), bias), _mm256_setzero_si256()));
+    }
+
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+
+    int64_t total = lanes[0] + lanes[1] + lanes[2] + lanes[3] - 128 * (int64_t)i;
+    return total + sum_i8(&x[i], n - i);
+}
+
+// Adds the four signed 32-bit lanes of `v` to a 64-bit total.
+static inline int64_t widen_sum_i32(__m128i v) {
+    int32_t lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, v);
+    return (int64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+// Sums `n` 16-bit integers. `pmaddwd` against ones sums adjacent pairs into 32-bit lanes,
+// which are widened to 64 bits before they could overflow.
+static int64_t sum_i16(const int16_t* x, size_t n) {
+    __m128i ones = _mm_set1_epi16(1);
+    int64_t total = 0;
+    size_t i = 0;
+
+    while (i + 8 <= n) {
+        __m128i acc = _mm_setzero_si128();
+
+        // Each step adds at most 2^16 to a lane.
+        for (size_t steps = 0; steps < 16384 && i + 8 <= n; steps++, i += 8) {
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(load16(&x[i]), ones));
+        }
+
+        total += widen_sum_i32(acc);
+    }
+
+    for (; i < n; i++) {
+        total += x[i];
+    }
+
+    return total;
+}
+
+AVX2 static int64_t sum_i16_avx2(const int16_t* x, size_t n) {
+    __m256i ones = _mm256_set1_epi16(1);
+    int64_t total = 0;
+    size_t i = 0;
+
+    while (i + 16 <= n) {
+        __m256i acc = _mm256_setzero_si256();
+
+        for (size_t steps = 0; steps < 16384 && i + 16 <= n; steps++, i += 16) {
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(load32(&x[i]), ones));
+        }
+
+        total += widen_sum_i32(_mm256_castsi256_si128(acc)) + widen_sum_i32(_mm256_extracti128_si256(acc, 1));
+    }
+
+    return total + sum_i16(&x[i], n - i);
+}
+
+// Sums `n` 32-bit integers, sign-extending them to 64-bit lanes.
+static int64_t sum_i32(const int32_t* x, size_t n) {
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = load16(&x[i]);
+        __m128i sign = _mm_srai_epi32(v, 31);
+        acc = _mm_add_epi64(acc, _mm_add_epi64(_mm_unpacklo_epi32(v, sign), _mm_unpackhi_epi32(v, sign)));
+    }
+
+    int64_t total = _mm_cvtsi128_si64(acc) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc));
+    for (; i < n; i++) {
+        total += x[i];
+    }
+
+    return total;
+}
+
+AVX2 static int64_t sum_i32_avx2(const int32_t* x, size_t n) {
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(load16(&x[i])));
+        acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(load16(&x[i + 4])));
+    }
+
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, _mm256_add_epi64(acc0, acc1));
+
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sum_i32(&x[i], n - i);
+}
+
+// Loads two elements of a `f` (if `is_f32` is `true`) or `d` array as doubles.
+static inline __m128d load2_f64(const void* x, size_t i, bool is_f32) {
+    if (is_f32)
+        return _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd((const double*)&((const float*)x)[i])));
+
+    return _mm_loadu_pd(&((const double*)x)[i]);
+}
+
+// Loads four elements of a `f` (if `is_f32` is `true`) or `d` array as doubles.
+AVX2 static inline __m256d load4_f64(const void* x, size_t i, bool is_f32) {
+    if (is_f32)
+        return _mm256_cvtps_pd(_mm_loadu_ps(&((const float*)x)[i]));
+
+    return _mm256_loadu_pd(&((const double*)x)[i]);
+}
+
+// Returns element `i` of a `f` or `d` array as a double.
+static inline double element_f64(const void* x, size_t i, bool is_f32) {
+    return is_f32 ? ((const float*)x)[i] : ((const double*)x)[i];
+}
+
+// Folds the eight lanes of a floating-point reduction into one, in an order that both the
+// SSE2 and the AVX2 variants follow.
+static inline double fold_lanes(__m128d a0, __m128d a1, __m128d a2, __m128d a3) {
+    __m128d s = _mm_add_pd(_mm_add_pd(a0, a2), _mm_add_pd(a1, a3));
+    return _mm_cvtsd_f64(s) + _mm_cvtsd_f64(_mm_unpackhi_pd(s, s));
+}
+
+AVX2 static inline double fold_lanes_avx2(__m256d acc0, __m256d acc1) {
+    __m256d s = _mm256_add_pd(acc0, acc1);
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(s), _mm256_extractf128_pd(s, 1));
+    return _mm_cvtsd_f64(half) + _mm_cvtsd_f64(_mm_unpackhi_pd(half, half));
+}
+
+// Computes the sum of `x[i] * y[i]` over `n` floating-point elements - or the sum of `x[i]`
+// alone, if `y` is `NULL`.
+static double reduce_f64(const void* x, const void* y, size_t n, bool is_f32) {
+    __m128d a0 = _mm_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+    size_t i = 0;
+
+    if (y == NULL) {
+        for (; i + 8 <= n; i += 8) {
+            a0 = _mm_add_pd(a0, load2_f64(x, i, is_f32));
+            a1 = _mm_add_pd(a1, load2_f64(x, i + 2, is_f32));
+            a2 = _mm_add_pd(a2, load2_f64(x, i + 4, is_f32));
+            a3 = _mm_add_pd(a3, load2_f64(x, i + 6, is_f32));
+        }
+    }
+    else {
+        for (; i + 8 <= n; i += 8) {
+            a0 = _mm_add_pd(a0, _mm_mul_pd(load2_f64(x, i, is_f32), load2_f64(y, i, is_f32)));
+            a1 = _mm_add_pd(a1, _mm_mul_pd(load2_f64(x, i + 2, is_f32), load2_f64(y, i + 2, is_f32)));
+            a2 = _mm_add_pd(a2, _mm_mul_pd(load2_f64(x, i + 4, is_f32), load2_f64(y, i + 4, is_f32)));
+            a3 = _mm_add_pd(a3, _mm_mul_pd(load2_f64(x, i + 6, is_f32), load2_f64(y, i + 6, is_f32)));
+        }
+    }
+
+    double total = fold_lanes(a0, a1, a2, a3);
+    for (; i < n; i++) {
+        total += y == NULL ? element_f64(x, i, is_f32) : element_f64(x, i, is_f32) * element_f64(y, i, is_f32);
+    }
+
+    return total;
+}
+
+AVX2 static double reduce_f64_avx2(const void* x, const void* y, size_t n, bool is_f32) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = acc0;
+    size_t i = 0;
+
+    if (y == NULL) {
+        for (; i + 8 <= n; i += 8) {
+            acc0 = _mm256_add_pd(acc0, load4_f64(x, i, is_f32));
+            acc1 = _mm256_add_pd(acc1, load4_f64(x, i + 4, is_f32));
+        }
+    }
+    else {
+        // We don't fuse the multiplications, so that the results match the SSE2 variant.
+        for (; i + 8 <= n; i += 8) {
+            acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(load4_f64(x, i, is_f32), load4_f64(y, i, is_f32)));
+            acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(load4_f64(x, i + 4, is_f32), load4_f64(y, i + 4, is_f32)));
+        }
+    }
+
+    double total = fold_lanes_avx2(acc0, acc1);
+    for (; i < n; i++) {
+        total += y == NULL ? element_f64(x, i, is_f32) : element_f64(x, i, is_f32) * element_f64(y, i, is_f32);
+    }
+
+    return total;
+}
+
+pyobj_t* py_array_sum(pyobj_t* array) {
+    ENSURE_NOT_NULL(array);
+    ASSERT(PY_IS_ARRAY(array));
+
+    const void* x = array->as_buffer.data;
+    size_t n = py_array_length(array);
+    bool avx2 = use_avx2();
+
+    switch (array->as_buffer.format) {
+        case 'b': return py_alloc_int(avx2 ? sum_i8_avx2(x, n) : sum_i8(x, n));
+        case 'h': return py_alloc_int(avx2 ? sum_i16_avx2(x, n) : sum_i16(x, n));
+        case 'i': return py_alloc_int(avx2 ? sum_i32_avx2(x, n) : sum_i32(x, n));
+        case 'q': {
+            // 64-bit elements may overflow a 64-bit total, but not a 128-bit one.
+            __int128 total = 0;
+            for (size_t i = 0; i < n; i++) {
+                total += ((const int64_t*)x)[i];
+            }
+
+            return box_int128(total);
+        }
+        default: {
+            bool is_f32 = array->as_buffer.format == 'f';
+            return py_alloc_float(avx2 ? reduce_f64_avx2(x, NULL, n, is_f32) : reduce_f64(x, NULL, n, is_f32));
+        }
+    }
+}
+
+// Finishes a minimum or maximum search by scanning `x[from..n]` one element at a time.
+#define SCALAR_EXTREME($best, $x, $from, $n, $is_max)                    \
+    for (size_t k = ($from); k < ($n); k++) {                            \
+        if (($is_max) ? ($x)[k] > ($best) : ($x)[k] < ($best)) {         \
+            ($best) = ($x)[k];                                           \
+        }                                                                \
+    }                                                                    \
+
+// Reduces the lanes of a vector of `$count` elements of type `$type` to the minimum or
+// maximum of them and `$best`.
+#define REDUCE_LANES($best, $type, $count, $store, $is_max)              \
+    {                                                                    \
+        $type lanes[$count];                                             \
+        $store;                                                          \
+        SCALAR_EXTREME($best, lanes, 0, $count, $is_max);                \
+    }                                                                    \
+
+static int64_t extreme_i8(const int8_t* x, size_t n, bool is_max) {
+    // SSE2 only compares unsigned bytes, so we bias the elements by 128.
+    int8_t best = x[0];
+    size_t i = 0;
+
+    if (n >= 16) {
+        __m128i bias = _mm_set1_epi8((char)0x80);
+        __m128i acc = _mm_xor_si128(load16(x), bias);
+
+        for (i = 16; i + 16 <= n; i += 16) {
+            __m128i v = _mm_xor_si128(load16(&x[i]), bias);
+            acc = is_max ? _mm_max_epu8(acc, v) : _mm_min_epu8(acc, v);
+        }
+
+        acc = _mm_xor_si128(acc, bias);
+        REDUCE_LANES(best, int8_t, 16, _mm_storeu_si128((__m128i*)lanes, acc), is_max);
+    }
+
+    SCALAR_EXTREME(best, x, i, n, is_max);
+    return best;
+}
+
+AVX2 static int64_t extreme_i8_avx2(const int8_t* x, size_t n, bool is_max) {
+    int8_t best = x[0];
+    size_t i = 0;
+
+    if (n >= 32) {
+        __m256i acc = load32(x);
+
+        for (i = 32; i + 32 <= n; i += 32) {
+            __m256i v = load32(&x[i]);
+            acc = is_max ? _mm256_max_epi8(acc, v) : _mm256_min_epi8(acc, v);
+        }
+
+        REDUCE_LANES(best, int8_t, 32, _mm256_storeu_si256((__m256i*)lanes, acc), is_max);
+    }
+
+    SCALAR_EXTREME(best, x, i, n, is_max);
+    return best;
+}
+
+static int64_t extreme_i16(const int16_t* x, size_t n, bool is_max) {
+    int16_t best = x[0];
+    size_t i = 0;
+
+    if (n >= 8) {
+        __m128i acc = load16(x);
+
+        for (i = 8; i + 8 <= n; i += 8) {
+            __m128i v = load16(&x[i]);
+            acc = is_max ? _mm_max_epi16(acc, v) : _mm_min_epi16(acc, v);
+        }
+
+        REDUCE_LANES(best, int16_t, 8, _mm_storeu_si128((__m128i*)lanes, acc), is_max);
+    }
+
+    SCALAR_EXTREME(best, x, i, n, is_max);
+    return best;
+}
+
+AVX2 static int64_t extreme_i16_avx2(const int16_t* x, size_t n, bool is_max) {
+    int16_t best = x[0];
+    size_t i = 0;
+
+    if (n >= 16) {
+        __m256i acc = load32(x);
+
+        for (i = 16; i + 16 <= n; i += 16) {
+            __m256i v = load32(&x[i]);
+            acc = is_max ? _mm256_max_epi16(acc, v) : _mm256_min_epi16(acc, v);
+        }
+
+        REDUCE_LANES(best, int16_t, 16, _mm256_storeu_si256((__m256i*)lanes, acc), is_max);
+    }
+
+    SCALAR_EXTREME(best, x, i, n, is_max);
+    return best;
+}
+
+static int64_t extreme_i32(const int32_t* x, size_t n, bool is_max) {
+    // SSE2 doesn't have `pminsd`/`pmaxsd`, so we select the lanes with a comparison mask.
+    int32_t best = x[0];
+    size_t i = 0;
+
+    if (n >= 4) {
+        __m128i acc = load16(x);
+
+        for (i = 4; i + 4 <= n; i += 4) {
+            __m128i v = load16(&x[i]);
+            __m128i take = is_max ? _mm_cmpgt_epi32(v, acc) : _mm_cmpgt_epi32(acc, v);
+            acc = _mm_or_si128(_mm_and_si128(take, v), _mm_andnot_si128(take, acc));
+        }
+
+        REDUCE_LANES(best, int32_t, 4, _mm_storeu_si128((__m128i*)lanes, acc), is_max);
+    }
+
+    SCALAR_EXTREME(best, x, i, n, is_max);
+    return best;
+}
+
+AVX2 static int64_t extreme_i32_avx2(const int32_t* x, size_t n, bool is_max) {
+    int32_t best = x[0];
+    size_t i = 0;
+
+    if (n >= 8) {
+        __m256i acc = load32(x);
+
+        for (i = 8; i + 8 <= n; i += 8) {
+            __m256i v = load32(&x[i]);
+            acc = is_max ? _mm256_max_epi32(acc, v) : _mm256_min_epi32(acc, v);
+        }
+
+        REDUCE_LANES(best, int32_t, 8, _mm256_storeu_si256((__m256i*)lanes, acc), is_max);
+    }
+
+    SCALAR_EXTREME(best, x, i, n, is_max);
+    return best;
+}
+
+AVX2 static int64_t extreme_i64_avx2(const int64_t* x, size_t n, bool is_max) {
+    int64_t best = x[0];
+    size_t i = 0;
+
+    if (n >= 4) {
+        __m256i acc = load32(x);
+
+        for (i = 4; i + 4 <= n; i += 4) {
+            __m256i v = load32(&x[i]);
+            __m256i take = is_max ? _mm256_cmpgt_epi64(v, acc) : _mm256_cmpgt_epi64(acc, v);
+            acc = _mm256_blendv_epi8(acc, v, take);
+        }
+
+        REDUCE_LANES(best, int64_t, 4, _mm256_storeu_si256((__m256i*)lanes, acc), is_max);
+    }
+
+    SCALAR_EXTREME(best, x, i, n, is_max);
+    return best;
+}
+
+// Finds the minimum or maximum of `n` doubles, none of which is NaN. `minpd` and `maxpd`
+// return their second operand if either one is NaN, so passing the accumulator second
+// skips over NaNs.
+static double extreme_f64(const double* x, size_t n, bool is_max) {
+    double best = x[0];
+    size_t i = 0;
+
+    if (n >= 2) {
+        __m128d acc = _mm_set1_pd(x[0]);
+
+        for (; i + 2 <= n; i += 2) {
+            __m128d v = _mm_loadu_pd(&x[i]);
+            acc = is_max ? _mm_max_pd(v, acc) : _mm_min_pd(v, acc);
+        }
+
+        REDUCE_LANES(best, double, 2, _mm_storeu_pd(lanes, acc), is_max);
+    }
+
+    SCALAR_EXTREME(best, x, i, n, is_max);
+    return best;
+}
+
+AVX2 static double extreme_f64_avx2(const double* x, size_t n, bool is_max) {
+    double best = x[0];
+    size_t i = 0;
+
+    if (n >= 4) {
+        __m256d acc = _mm256_set1_pd(x[0]);
+
+        for (; i + 4 <= n; i += 4) {
+            __m256d v = _mm256_loadu_pd(&x[i]);
+            acc = is_max ? _mm256_max_pd(v, acc) : _mm256_min_pd(v, acc);
+        }
+
+        REDUCE_LANES(best, double, 4, _mm256_storeu_pd(lanes, acc), is_max);
+    }
+
+    SCALAR_EXTREME(best, x, i, n, is_max);
+    return best;
+}
+
+static float extreme_f32(const float* x, size_t n, bool is_max) {
+    float best = x[0];
+    size_t i = 0;
+
+    if (n >= 4) {
+        __m128 acc = _mm_set1_ps(x[0]);
+
+        for (; i + 4 <= n; i += 4) {
+            __m128 v = _mm_loadu_ps(&x[i]);
+            acc = is_max ? _mm_max_ps(v, acc) : _mm_min_ps(v, acc);
+        }
+
+        REDUCE_LANES(best, float, 4, _mm_storeu_ps(lanes, acc), is_max);
+    }
+
+    SCALAR_EXTREME(best, x, i, n, is_max);
+    return best;
+}
+
+AVX2 static float extreme_f32_avx2(const float* x, size_t n, bool is_max) {
+    float best = x[0];
+    size_t i = 0;
+
+    if (n >= 8) {
+        __m256 acc = _mm256_set1_ps(x[0]);
+
+        for (; i + 8 <= n; i += 8) {
+            __m256 v = _mm256_loadu_ps(&x[i]);
+            acc = is_max ? _mm256_max_ps(v, acc) : _mm256_min_ps(v, acc);
+        }
+
+        REDUCE_LANES(best, float, 8, _mm256_storeu_ps(lanes, acc), is_max);
+    }
+
+    SCALAR_EXTREME(best, x, i, n, is_max);
+    return best;
+}
+
+pyreturn_t py_array_extreme(pyobj_t* array, bool is_max) {
+    ENSURE_NOT_NULL(array);
+    ASSERT(PY_IS_ARRAY(array));
+
+    size_t n = py_array_length(array);
+    if (n == 0) {
+        return is_max
+            ? WITH_EXCEPTION(NEW_EXCEPTION_INLINE(ValueError, "max() arg is an empty sequence"))
+            : WITH_EXCEPTION(NEW_EXCEPTION_INLINE(ValueError, "min() arg is an empty sequence"));
+    }
+
+    const void* x = array->as_buffer.data;
+    bool avx2 = use_avx2();
+
+    switch (array->as_buffer.format) {
+        case 'b': return WITH_RESULT(py_alloc_int(avx2 ? extreme_i8_avx2(x, n, is_max) : extreme_i8(x, n, is_max)));
+        case 'h': return WITH_RESULT(py_alloc_int(avx2 ? extreme_i16_avx2(x, n, is_max) : extreme_i16(x, n, is_max)));
+        case 'i': return WITH_RESULT(py_alloc_int(avx2 ? extreme_i32_avx2(x, n, is_max) : extreme_i32(x, n, is_max)));
+        case 'q': {
+            if (avx2)
+                return WITH_RESULT(py_alloc_int(extreme_i64_avx2(x, n, is_max)));
+
+            // SSE2 can't compare 64-bit lanes.
+            int64_t best = ((const int64_t*)x)[0];
+            SCALAR_EXTREME(best, (const int64_t*)x, 1, n, is_max);
+            return WITH_RESULT(py_alloc_int(best));
+        }
+    }
+
+    // Nothing compares as less or greater than a NaN, so if the first element is one, it
+    // wins. Otherwise, the vector kernels skip NaNs just like the builtins would.
+    bool is_f32 = array->as_buffer.format == 'f';
+    double first = element_f64(x, 0, is_f32);
+    if (first != first)
+        return WITH_RESULT(py_alloc_float(first));
+
+    double best = is_f32
+        ? (avx2 ? extreme_f32_avx2(x, n, is_max) : extreme_f32(x, n, is_max))
+        : (avx2 ? extreme_f64_avx2(x, n, is_max) : extreme_f64(x, n, is_max));
+
+    // The kernels don't tell `-0.0` and `0.0` apart - the first element equal to the result
+    // is the one the builtins would've picked.
+    for (size_t i = 0; i < n; i++) {
+        double element = element_f64(x, i, is_f32);
+        if (element == best)
+            return WITH_RESULT(py_alloc_float(element));
+    }
+
+    return WITH_RESULT(py_alloc_float(best));
+}
+
+// Returns the element at the given index of an `array` of an integer typecode.
+static inline int64_t int_element(pyobj_t* array, size_t index) {
+    const uint8_t* p = array->as_buffer.data + index * array->as_buffer.itemsize;
+
+    switch (array->as_buffer.format) {
+        case 'b': return *(const int8_t*)p;
+        case 'h': return *(const int16_t*)p;
+        case 'i': return *(const int32_t*)p;
+        default: return *(const int64_t*)p;
+    }
+}
+
+// Checks that `a` and `b` are arrays of the same typecode and length, for an operation that
+// combines their elements pairwise. Returns an exception or NULL.
+static pyobj_t* verify_same_shape(pyobj_t* a, pyobj_t* b) {
+    if (!PY_IS_ARRAY(b))
+        return NEW_EXCEPTION_INLINE(TypeError, "expected an array");
+
+    if (a->as_buffer.format != b->as_buffer.format)
+        return NEW_EXCEPTION_INLINE(TypeError, "arrays must have the same typecode");
+
+    if (a->as_buffer.length != b->as_buffer.length)
+        return NEW_EXCEPTION_INLINE(ValueError, "arrays must have the same length");
+
+    return NULL;
+}
+
+pyreturn_t py_array_dot(pyobj_t* a, pyobj_t* b) {
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+    ASSERT(PY_IS_ARRAY(a));
+
+    pyobj_t* exception = verify_same_shape(a, b);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    size_t n = py_array_length(a);
+    const void* x = a->as_buffer.data;
+    const void* y = b->as_buffer.data;
+
+    if (typecode_is_float(a->as_buffer.format)) {
+        bool is_f32 = a->as_buffer.format == 'f';
+        double result = use_avx2() ? reduce_f64_avx2(x, y, n, is_f32) : reduce_f64(x, y, n, is_f32);
+        return WITH_RESULT(py_alloc_float(result));
+    }
+
+    // Integer products are accumulated in 128 bits. Only `q` elements can overflow that, in
+    // which case we continue with arbitrary-precision `int`s.
+    __int128 total = 0;
+    size_t i = 0;
+
+    for (; i < n; i++) {
+        __int128 product = (__int128)int_element(a, i) * int_element(b, i);
+        __int128 next;
+
+        if (__builtin_add_overflow(total, product, &next))
+            break;
+
+        total = next;
+    }
+
+    if (i == n)
+        return WITH_RESULT(box_int128(total));
+
+    pyobj_t* result = box_int128(total);
+    for (; i < n; i++) {
+        pyobj_t* product = UNWRAP(py_int_mul(py_array_item(a, i), py_array_item(b, i)));
+        result = UNWRAP(py_int_add(result, product));
+    }
+
+    return WITH_RESULT(result);
+}
+
+// Returns `true` if the SSE2 (or AVX2, if `avx2` is `true`) elementwise kernel supports
+// `op` for the given typecode. Neither has a multiplication of 8 or 64-bit lanes, and SSE2
+// has none of 32-bit lanes either.
+static inline bool has_vector_op(char typecode, char op, bool avx2) {
+    if (op != '*')
+        return true;
+
+    return typecode == 'h' || typecode_is_float(typecode) || (avx2 && typecode == 'i');
+}
+
+// Applies `a $op b` to each pair of lanes of `a` and `b`, which hold elements of the given
+// typecode. Only called for the operations `has_vector_op` allows.
+static ALWAYS_INLINE __m128i apply_sse2(char typecode, char op, __m128i a, __m128i b) {
+    switch (typecode) {
+        case 'b': return op == '+' ? _mm_add_epi8(a, b) : _mm_sub_epi8(a, b);
+        case 'h':
+            return op == '+' ? _mm_add_epi16(a, b)
+                : op == '-' ? _mm_sub_epi16(a, b)
+                : _mm_mullo_epi16(a, b);
+        case 'i': return op == '+' ? _mm_add_epi32(a, b) : _mm_sub_epi32(a, b);
+        case 'q': return op == '+' ? _mm_add_epi64(a, b) : _mm_sub_epi64(a, b);
+        case 'f': {
+            __m128 x = _mm_castsi128_ps(a), y = _mm_castsi128_ps(b);
+            return _mm_castps_si128(op == '+' ? _mm_add_ps(x, y) : op == '-' ? _mm_sub_ps(x, y) : _mm_mul_ps(x, y));
+        }
+        default: {
+            __m128d x = _mm_castsi128_pd(a), y = _mm_castsi128_pd(b);
+            return _mm_castpd_si128(op == '+' ? _mm_add_pd(x, y) : op == '-' ? _mm_sub_pd(x, y) : _mm_mul_pd(x, y));
+        }
+    }
+}
+
+AVX2 static ALWAYS_INLINE __m256i apply_avx2(char typecode, char op, __m256i a, __m256i b) {
+    switch (typecode) {
+        case 'b': return op == '+' ? _mm256_add_epi8(a, b) : _mm256_sub_epi8(a, b);
+        case 'h':
+            return op == '+' ? _mm256_add_epi16(a, b)
+                : op == '-' ? _mm256_sub_epi16(a, b)
+                : _mm256_mullo_epi16(a, b);
+        case 'i':
+            return op == '+' ? _mm256_add_epi32(a, b)
+                : op == '-' ? _mm256_sub_epi32(a, b)
+                : _mm256_mullo_epi32(a, b);
+        case 'q': return op == '+' ? _mm256_add_epi64(a, b) : _mm256_sub_epi64(a, b);
+        case 'f': {
+            __m256 x = _mm256_castsi256_ps(a), y = _mm256_castsi256_ps(b);
+            return _mm256_castps_si256(op == '+' ? _mm256_add_ps(x, y) : op == '-' ? _mm256_sub_ps(x, y) : _mm256_mul_ps(x, y));
+        }
+        default: {
+            __m256d x = _mm256_castsi256_pd(a), y = _mm256_castsi256_pd(b);
+            return _mm256_castpd_si256(op == '+' ? _mm256_add_pd(x, y) : op == '-' ? _mm256_sub_pd(x, y) : _mm256_mul_pd(x, y));
+        }
+    }
+}
+
+// The operands of an elementwise operation. `b` either points to `length` bytes of elements,
+// or - if `broadcast` is `true` - to 32 bytes filled with copies of a single scalar. If
+// `reflected` is `true`, `b` is the left operand.
+typedef struct elementwise_args {
+    const uint8_t* a;
+    const uint8_t* b;
+    uint8_t* out;
+    size_t length;
+    bool broadcast;
+    bool reflected;
+} elementwise_args_t;
+
+// Applies the operation to the elements in the bytes `from..length`, one at a time. Integer
+// elements are combined as unsigned values, which wrap around.
+#define ELEMENTWISE_SCALAR($type, $wide, $args, $op, $from)                                 \
+    {                                                                                       \
+        const $type* x = (const $type*)($args)->a;                                          \
+        const $type* y = (const $type*)($args)->b;                                          \
+        $type* z = ($type*)($args)->out;                                                    \
+        for (size_t k = ($from) / sizeof($type); k < ($args)->length / sizeof($type); k++) { \
+            $wide l = ($wide)x[k];                                                          \
+            $wide r = ($wide)y[($args)->broadcast ? 0 : k];                                 \
+            if (($args)->reflected) {                                                       \
+                $wide t = l; l = r; r = t;                                                  \
+            }                                                                               \
+            z[k] = ($type)(($op) == '+' ? l + r : ($op) == '-' ? l - r : l * r);            \
+        }                                                                                   \
+    }                                                                                       \
+
+static ALWAYS_INLINE void elementwise_scalar(char typecode, char op, const elementwise_args_t* args, size_t from) {
+    switch (typecode) {
+        case 'b': ELEMENTWISE_SCALAR(int8_t, uint32_t, args, op, from); break;
+        case 'h': ELEMENTWISE_SCALAR(int16_t, uint32_t, args, op, from); break;
+        case 'i': ELEMENTWISE_SCALAR(int32_t, uint32_t, args, op, from); break;
+        case 'q': ELEMENTWISE_SCALAR(int64_t, uint64_t, args, op, from); break;
+        case 'f': ELEMENTWISE_SCALAR(float, float, args, op, from); break;
+        default: ELEMENTWISE_SCALAR(double, double, args, op, from); break;
+    }
+}
+
+static ALWAYS_INLINE void elementwise_sse2(char typecode, char op, const elementwise_args_t* args) {
+    size_t i = 0;
+
+    if (has_vector_op(typecode, op, false)) {
+        __m128i scalar = args->broadcast ? load16(args->b) : _mm_setzero_si128();
+
+        for (; i + 16 <= args->length; i += 16) {
+            __m128i a = load16(&args->a[i]);
+            __m128i b = args->broadcast ? scalar : load16(&args->b[i]);
+            __m128i result = args->reflected ? apply_sse2(typecode, op, b, a) : apply_sse2(typecode, op, a, b);
+            _mm_storeu_si128((__m128i*)&args->out[i], result);
+        }
+    }
+
+    elementwise_scalar(typecode, op, args, i);
+}
+
+AVX2 static ALWAYS_INLINE void elementwise_avx2(char typecode, char op, const elementwise_args_t* args) {
+    size_t i = 0;
+
+    if (has_vector_op(typecode, op, true)) {
+        __m256i scalar = args->broadcast ? load32(args->b) : _mm256_setzero_si256();
+
+        for (; i + 32 <= args->length; i += 32) {
+            __m256i a = load32(&args->a[i]);
+            __m256i b = args->broadcast ? scalar : load32(&args->b[i]);
+            __m256i result = args->reflected ? apply_avx2(typecode, op, b, a) : apply_avx2(typecode, op, a, b);
+            _mm256_storeu_si256((__m256i*)&args->out[i], result);
+        }
+    }
+
+    elementwise_scalar(typecode, op, args, i);
+}
+
+// Expands to a call of `$kernel` with constant operands, for each supported typecode, so that
+// the compiler specializes the kernel for each of them.
+#define ELEMENTWISE_DISPATCH($kernel, $typecode, $op, $args)            \
+    switch ($typecode) {                                                \
+        case 'b': $kernel('b', $op, $args); break;                      \
+        case 'h': $kernel('h', $op, $args); break;                      \
+        case 'i': $kernel('i', $op, $args); break;                      \
+        case 'q': $kernel('q', $op, $args); break;                      \
+        case 'f': $kernel('f', $op, $args); break;                      \
+        default: $kernel('d', $op, $args); break;                       \
+    }                                                                   \
+
+static void elementwise_sse2_any(char typecode, char op, const elementwise_args_t* args) {
+    switch (op) {
+        case '+': ELEMENTWISE_DISPATCH(elementwise_sse2, typecode, '+', args); break;
+        case '-': ELEMENTWISE_DISPATCH(elementwise_sse2, typecode, '-', args); break;
+        default: ELEMENTWISE_DISPATCH(elementwise_sse2, typecode, '*', args); break;
+    }
+}
+
+AVX2 static void elementwise_avx2_any(char typecode, char op, const elementwise_args_t* args) {
+    switch (op) {
+        case '+': ELEMENTWISE_DISPATCH(elementwise_avx2, typecode, '+', args); break;
+        case '-': ELEMENTWISE_DISPATCH(elementwise_avx2, typecode, '-', args); break;
+        default: ELEMENTWISE_DISPATCH(elementwise_avx2, typecode, '*', args); break;
+    }
+}
+
+pyreturn_t py_array_elementwise(pyobj_t* a, pyobj_t* b, char op, bool reflected, bool inplace) {
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+    ASSERT(PY_IS_ARRAY(a));
+    ASSERT(op == '+' || op == '-' || op == '*');
+
+    char typecode = a->as_buffer.format;
+    uint8_t itemsize = a->as_buffer.itemsize;
+    pyobj_t* result = inplace ? a : py_alloc_array_of(typecode, py_array_length(a));
+
+    elementwise_args_t args = {
+        .a = a->as_buffer.data,
+        .out = result->as_buffer.data,
+        .length = a->as_buffer.length,
+        .reflected = reflected
+    };
+
+    // Scalars are converted to an element once, and then repeated across a whole vector.
+    uint8_t pattern[32];
+
+    if (PY_IS_ARRAY(b)) {
+        pyobj_t* exception = verify_same_shape(a, b);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        args.b = b->as_buffer.data;
+    }
+    else {
+        if (b->type != &py_type_int && b->type != &py_type_float)
+            RAISE(TypeError, "unsupported operand type(s) for array arithmetic");
+
+        pyobj_t* exception = store_item(typecode, pattern, b);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        for (size_t i = itemsize; i < sizeof(pattern); i += itemsize) {
+            memcpy(&pattern[i], pattern, itemsize);
+        }
+
+        args.b = pattern;
+        args.broadcast = true;
+    }
+
+    if (use_avx2()) {
+        elementwise_avx2_any(typecode, op, &args);
+    }
+    else {
+        elementwise_sse2_any(typecode, op, &args);
+    }
+
+    return WITH_RESULT(result);
+}
+
+// Maps the element at `p` to an unsigned key that orders like the element does. `-0.0` has
+// the key of `0.0`, and NaNs order by their sign and payload.
+static ALWAYS_INLINE uint64_t sort_key(char typecode, const uint8_t* p) {
+    switch (typecode) {
+        case 'b': return (uint8_t)*(const int8_t*)p ^ 0x80u;
+        case 'h': return (uint16_t)*(const int16_t*)p ^ 0x8000u;
+        case 'i': return (uint32_t)*(const int32_t*)p ^ 0x80000000u;
+        case 'q': return (uint64_t)*(const int64_t*)p ^ 0x8000000000000000u;
+        case 'f': {
+            float x = *(const float*)p;
+            uint32_t bits;
+            __builtin_memcpy(&bits, &x, 4);
+            if (x == 0.0f)
+                bits = 0;
+
+            return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+        }
+        default: {
+            double x = *(const double*)p;
+            uint64_t bits;
+            __builtin_memcpy(&bits, &x, 8);
+            if (x == 0.0)
+                bits = 0;
+
+            return (bits & 0x8000000000000000u) ? ~bits : bits | 0x8000000000000000u;
+        }
+    }
+}
+
+// Arrays shorter than this are sorted by insertion.
+#define RADIX_SORT_THRESHOLD 32
+
+// Sorts `n` elements of the given typecode, which are `size` bytes each, with a stable
+// least-significant-digit radix sort over their keys - one pass per byte of the key. Passes
+// over bytes that are the same in all keys are skipped.
+static ALWAYS_INLINE void radix_sort(char typecode, uint8_t* data, size_t n) {
+    const size_t size = typecode_itemsize(typecode);
+
+    if (n < RADIX_SORT_THRESHOLD) {
+        uint8_t element[8];
+
+        for (size_t i = 1; i < n; i++) {
+            uint64_t key = sort_key(typecode, &data[i * size]);
+            memcpy(element, &data[i * size], size);
+
+            size_t j = i;
+            for (; j > 0 && sort_key(typecode, &data[(j - 1) * size]) > key; j--) {
+                memcpy(&data[j * size], &data[(j - 1) * size], size);
+            }
+
+            memcpy(&data[j * size], element, size);
+        }
+
+        return;
+    }
+
+    // All histograms are built in a single pass.
+    size_t* counts = mm_heap_alloc(size * 256 * sizeof(size_t));
+    memset(counts, 0, size * 256 * sizeof(size_t));
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t key = sort_key(typecode, &data[i * size]);
+        for (size_t digit = 0; digit < size; digit++) {
+            counts[digit * 256 + ((key >> (digit * 8)) & 0xFF)]++;
+        }
+    }
+
+    uint8_t* scratch = mm_heap_alloc(n * size);
+    uint8_t* source = data;
+    uint8_t* target = scratch;
+
+    for (size_t digit = 0; digit < size; digit++) {
+        size_t* histogram = &counts[digit * 256];
+        uint64_t shift = digit * 8;
+
+        // If all keys share this byte, the pass wouldn't move anything.
+        if (histogram[(sort_key(typecode, source) >> shift) & 0xFF] == n)
+            continue;
+
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < 256; bucket++) {
+            size_t count = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += count;
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            const uint8_t* element = &source[i * size];
+            size_t bucket = (sort_key(typecode, element) >> shift) & 0xFF;
+            memcpy(&target[histogram[bucket]++ * size], element, size);
+        }
+
+        uint8_t* swap = source;
+        source = target;
+        target = swap;
+    }
+
+    if (source != data) {
+        memcpy(data, source, n * size);
+    }
+
+    mm_heap_free(scratch);
+    mm_heap_free(counts);
+}
+
+void py_array_sort(pyobj_t* array) {
+    ENSURE_NOT_NULL(array);
+    ASSERT(PY_IS_ARRAY(array));
+
+    uint8_t* data = array->as_buffer.data;
+    size_t n = py_array_length(array);
+
+    switch (array->as_buffer.format) {
+        case 'b': radix_sort('b', data, n); break;
+        case 'h': radix_sort('h', data, n); break;
+        case 'i': radix_sort('i', data, n); break;
+        case 'q': radix_sort('q', data, n); break;
+        case 'f': radix_sort('f', data, n); break;
+        default: radix_sort('d', data, n); break;
+    }
+}
+
+bool py_arrays_equal(pyobj_t* a, pyobj_t* b) {
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+    ASSERT(PY_IS_ARRAY(a) && PY_IS_ARRAY(b));
+
+    size_t n = py_array_length(a);
+    if (n != py_array_length(b))
+        return false;
+
+    char typecode = a->as_buffer.format;
+
+    // Integers are equal exactly when their bytes are. That isn't true for floats, where
+    // NaNs aren't equal to themselves, and `-0.0` is equal to `0.0`.
+    if (typecode == b->as_buffer.format && !typecode_is_float(typecode))
+        return std_memequ(a->as_buffer.data, b->as_buffer.data, a->as_buffer.length);
+
+    if (typecode == b->as_buffer.format) {
+        bool is_f32 = typecode == 'f';
+        for (size_t i = 0; i < n; i++) {
+            if (element_f64(a->as_buffer.data, i, is_f32) != element_f64(b->as_buffer.data, i, is_f32))
+                return false;
+        }
+
+        return true;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        pyobj_t* exception = NULL;
+        if (!py_keys_equal(py_array_item(a, i), py_array_item(b, i), &exception))
+            return false;
+    }
+
+    return true;
+}
+
+pyobj_t* py_array_tolist(pyobj_t* array) {
+    ENSURE_NOT_NULL(array);
+    ASSERT(PY_IS_ARRAY(array));
+
+    size_t n = py_array_length(array);
+    pyobj_t* list = py_alloc_list(n);
+
+    for (size_t i = 0; i < n; i++) {
+        py_list_append(list, py_array_item(array, i));
+    }
+
+    return list;
+}
+
+string_t py_array_to_str(pyobj_t* array) {
+    ENSURE_NOT_NULL(array);
+    ASSERT(PY_IS_ARRAY(array));
+
+    size_t n = py_array_length(array);
+    char* typecode = mm_heap_alloc(1);
+    typecode[0] = array->as_buffer.format;
+
+    // `array('`, the typecode, `'`, and then either `)`, or `, [`, the elements and their
+    // separators, and `])`.
+    string_t* parts = mm_heap_alloc(sizeof(string_t) * (n * 2 + 6));
+    int count = 0;
+
+    parts[count++] = STR("array('");
+    parts[count++] = (string_t) { .str = typecode, .length = 1 };
+    parts[count++] = STR("'");
+
+    if (n != 0) {
+        parts[count++] = STR(", [");
+
+        for (size_t i = 0; i < n; i++) {
+            if (i != 0) {
+                parts[count++] = STR(", ");
+            }
+
+            parts[count++] = py_stringify(py_array_item(array, i));
+        }
+
+        parts[count++] = STR("]");
+    }
+
+    parts[count++] = STR(")");
+
+    string_t result = std_strconcat_array(parts, count);
+    mm_heap_free(parts);
+    return result;
+}
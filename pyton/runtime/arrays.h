@@ -0,0 +1,110 @@
+#pragma once
+
+#include "objects.h"
+#include "exceptions.h"
+
+// Python `array` objects, provided by the native `array` module, store their elements
+// unboxed - as raw C values - in `as_buffer`, where `format` is the typecode of the array.
+// Like the storage of a `bytearray`, the storage of an array grows geometrically as elements
+// are appended. The supported typecodes are `b`, `h`, `i` and `q` (signed 8, 16, 32 and 64-bit
+// integers), and `f` and `d` (single and double precision floating-point numbers).
+//
+// Elements are only boxed when they're read by Python code. Other consumers access the raw
+// storage directly: `memoryview(array)` views it without copying, like it does for a
+// `bytearray`, and `py_get_buffer` exposes it to e.g. `bytes(array)` or `struct.unpack_from`.
+//
+// On top of the interface of CPython's `array`, arrays provide numeric kernels that work over
+// the raw storage - the `sum`, `min`, `max`, `dot` and `sort` methods, and elementwise `+`,
+// `-` and `*` with either another array of the same typecode and length, or a scalar.
+// Elementwise integer arithmetic wraps around at the width of the typecode. The kernels use
+// SSE2, and AVX2 when the processor supports it. Floating-point sums are accumulated in eight
+// interleaved lanes in both variants, so that the results don't depend on the processor.
+
+// The type that represents the `array.array` Python class.
+extern pyobj_t py_type_array_array;
+
+// The type of iterators over `array` objects.
+extern pyobj_t py_type_array_iterator;
+
+// Evaluates to `true` if the given object is an `array`.
+#define PY_IS_ARRAY($x) (($x)->type == &py_type_array_array)
+
+// Implements `array(typecode, initializer)`, where `initializer` may be `NULL`, in which
+// case the array is empty. Returns an exception or the new `array`.
+pyreturn_t py_alloc_array(pyobj_t* typecode, pyobj_t* initializer);
+
+// Allocates an `array` of `length` zeroed elements of the given typecode, which has to be
+// one of the supported typecodes.
+pyobj_t* py_alloc_array_of(char typecode, size_t length);
+
+// Allocates an iterator over the elements of the given `array`.
+pyobj_t* py_alloc_array_iterator(pyobj_t* array);
+
+// Advances the given array iterator, returning the next element, or `NULL` if the iterator
+// is exhausted.
+pyobj_t* py_array_iterator_next(pyobj_t* iterator);
+
+// Returns the number of elements in the given `array`.
+static inline size_t py_array_length(pyobj_t* array) {
+    return array->as_buffer.length / array->as_buffer.itemsize;
+}
+
+// Boxes the element at the given index of the `array`, which has to be within its bounds.
+static inline pyobj_t* py_array_item(pyobj_t* array, size_t index) {
+    const uint8_t* p = array->as_buffer.data + index * array->as_buffer.itemsize;
+
+    switch (array->as_buffer.format) {
+        case 'b': return py_alloc_int(*(const int8_t*)p);
+        case 'h': return py_alloc_int(*(const int16_t*)p);
+        case 'i': return py_alloc_int(*(const int32_t*)p);
+        case 'q': return py_alloc_int(*(const int64_t*)p);
+        case 'f': return py_alloc_float(*(const float*)p);
+        default: return py_alloc_float(*(const double*)p);
+    }
+}
+
+// Implements `array[index]`, where `index` is an `int` or a `slice`. Slices are copies.
+pyreturn_t py_array_getitem(pyobj_t* array, pyobj_t* index);
+
+// Implements `array[index] = value`, where `index` is an `int` or a `slice`. Returns an
+// exception or NULL.
+pyobj_t* py_array_setitem(pyobj_t* array, pyobj_t* index, pyobj_t* value);
+
+// Implements `array.append(item)`. Returns an exception or NULL.
+pyobj_t* py_array_append(pyobj_t* array, pyobj_t* item);
+
+// Implements `array.extend(iterable)`. Returns an exception or NULL.
+pyobj_t* py_array_extend(pyobj_t* array, pyobj_t* iterable);
+
+// Implements `array.sum()`. The result is an `int` for integer typecodes, which never
+// overflows, and a `float` otherwise.
+pyobj_t* py_array_sum(pyobj_t* array);
+
+// Implements `array.min()` and `array.max()`, where `is_max` selects the latter. Like the
+// `min` and `max` builtins, the first of several equal elements wins, and NaNs are skipped
+// unless the first element is one. Returns an exception or the element.
+pyreturn_t py_array_extreme(pyobj_t* array, bool is_max);
+
+// Implements `a.dot(b)`, the sum of the products of the elements of two arrays of the same
+// typecode and length. Returns an exception or the result.
+pyreturn_t py_array_dot(pyobj_t* a, pyobj_t* b);
+
+// Implements the elementwise `a op b`, where `op` is `+`, `-` or `*`, `a` is an `array`,
+// and `b` either an `array` of the same typecode and length, or a scalar. If `reflected` is
+// `true`, the scalar is the left operand instead. If `inplace` is `true`, the result is
+// stored in `a`, like `a op= b` does. Returns an exception or the resulting `array`.
+pyreturn_t py_array_elementwise(pyobj_t* a, pyobj_t* b, char op, bool reflected, bool inplace);
+
+// Implements `array.sort()`. Floating-point elements are ordered by value, with `-0.0` and
+// `0.0` being equal - the sort is stable. NaNs go to the end (or to the start, if negative).
+void py_array_sort(pyobj_t* array);
+
+// Implements `a == b`, where both operands are arrays. Elements are compared by value, so
+// arrays of different typecodes may be equal.
+bool py_arrays_equal(pyobj_t* a, pyobj_t* b);
+
+// Implements `array.tolist()`.
+pyobj_t* py_array_tolist(pyobj_t* array);
+
+// Converts the given `array` to its string representation, e.g. `array('i', [1, 2])`.
+string_t py_array_to_str(pyobj_t* array);
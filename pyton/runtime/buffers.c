@@ -0,0 +1,1048 @@
+#include "buffers.h"
+
+#include "arrays.h"
+#include "ints.h"
+#include "lists.h"
+#include "slices.h"
+#include "strings.h"
+#include "opcodes.h"
+#include "std/memory.h"
+#include "std/safety.h"
+#include "std/string.h"
+#include "std/strscan.h"
+#include "std/utf8.h"
+#include "sys/mm.h"
+
+// Returns a pointer to the first byte the given buffer exposes.
+static inline uint8_t* buffer_bytes(pyobj_t* buffer) {
+    struct buffer_data* data = &buffer->as_buffer;
+    return data->owner != NULL ? data->owner->as_buffer.data + data->offset : data->data;
+}
+
+// Returns the size of a single element of the given `struct` format character, or 0 if
+// the format isn't supported.
+static uint8_t format_itemsize(char format) {
+    switch (format) {
+        case 'B': case 'b': return 1;
+        case 'H': case 'h': return 2;
+        case 'I': case 'i': return 4;
+        case 'L': case 'l': return 8;
+        case 'Q': case 'q': return 8;
+        case 'f': return 4;
+        case 'd': return 8;
+        default: return 0;
+    }
+}
+
+// Returns `true` if the given `struct` format character represents a floating-point number.
+static inline bool format_is_float(char format) {
+    return format == 'f' || format == 'd';
+}
+
+// Returns `true` if the given `struct` format character represents a signed integer.
+static inline bool format_is_signed(char format) {
+    return format >= 'a' && format <= 'z' && !format_is_float(format);
+}
+
+// Returns a copy of the given bytes on the heap, or `NULL` if there are none.
+static uint8_t* copy_bytes(const void* data, size_t length) {
+    if (length == 0)
+        return NULL;
+
+    uint8_t* copy = mm_heap_alloc(length);
+    memcpy(copy, data, length);
+    return copy;
+}
+
+static pyobj_t* alloc_buffer(pyobj_t* type, uint8_t* data, size_t length) {
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = type;
+    obj->as_buffer = (struct buffer_data) {
+        .data = data,
+        .length = length,
+        .capacity = length,
+        .format = 'B',
+        .itemsize = 1,
+        .readonly = type != &py_type_bytearray
+    };
+
+    return obj;
+}
+
+pyobj_t* py_alloc_bytes(const void* data, size_t length) {
+    return alloc_buffer(&py_type_bytes, copy_bytes(data, length), length);
+}
+
+pyobj_t* py_alloc_bytes_view(const void* data, size_t length) {
+    return alloc_buffer(&py_type_bytes, (uint8_t*)data, length);
+}
+
+pyobj_t* py_alloc_bytearray(const void* data, size_t length) {
+    return alloc_buffer(&py_type_bytearray, copy_bytes(data, length), length);
+}
+
+pyobj_t* py_alloc_physical_memoryview(physaddr_t address, size_t length) {
+    pyobj_t* obj = alloc_buffer(&py_type_memoryview, mm_phys_to_virt(address), length);
+    obj->as_buffer.readonly = false;
+    obj->as_buffer.is_physical = true;
+    return obj;
+}
+
+// Allocates a `memoryview` with the given fields, which counts as an export of the object
+// it views, if any.
+static pyobj_t* alloc_view(struct buffer_data data) {
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = &py_type_memoryview;
+    obj->as_buffer = data;
+    obj->as_buffer.exports = 0;
+
+    if (data.owner != NULL) {
+        data.owner->as_buffer.exports++;
+    }
+
+    return obj;
+}
+
+pyreturn_t py_alloc_memoryview(pyobj_t* source) {
+    ENSURE_NOT_NULL(source);
+
+    if (!PY_IS_BUFFER(source) && !PY_IS_ARRAY(source))
+        RAISE(TypeError, "memoryview: a bytes-like object is required");
+
+    struct buffer_data data = source->as_buffer;
+
+    if (source->type == &py_type_bytearray || PY_IS_ARRAY(source)) {
+        // We refer to the `bytearray` or `array` itself, as its storage moves when it grows.
+        // Views of an `array` interpret its elements with its typecode.
+        data.data = NULL;
+        data.capacity = 0;
+        data.owner = source;
+        data.offset = 0;
+    }
+
+    return WITH_RESULT(alloc_view(data));
+}
+
+void py_memoryview_release(pyobj_t* view) {
+    ENSURE_NOT_NULL(view);
+    ASSERT(view->type == &py_type_memoryview);
+
+    struct buffer_data* data = &view->as_buffer;
+    if (data->owner != NULL) {
+        ASSERT(data->owner->as_buffer.exports > 0);
+        data->owner->as_buffer.exports--;
+    }
+
+    // The view no longer refers to the memory it has been viewing.
+    data->data = NULL;
+    data->length = 0;
+    data->owner = NULL;
+    data->offset = 0;
+}
+
+// Returns a `BufferError` if the given `bytearray` cannot be resized, as there are
+// `memoryview`s of it that haven't been released, or NULL.
+static pyobj_t* bytearray_check_resizable(pyobj_t* bytearray) {
+    if (bytearray->as_buffer.exports != 0)
+        return NEW_EXCEPTION_INLINE(BufferError, "Existing exports of data: object cannot be re-sized");
+
+    return NULL;
+}
+
+// Ensures that the given `bytearray` has room for at least `capacity` bytes. This may move
+// its storage - pointers to it that were obtained before have to be obtained again.
+static void bytearray_reserve(pyobj_t* bytearray, size_t capacity) {
+    struct buffer_data* data = &bytearray->as_buffer;
+    if (capacity <= data->capacity)
+        return;
+
+    size_t new_capacity = MAX(MAX(capacity, data->capacity * 2), 16);
+    uint8_t* storage = mm_heap_alloc(new_capacity);
+
+    if (data->data != NULL) {
+        memcpy(storage, data->data, data->length);
+        mm_heap_free(data->data);
+    }
+
+    data->data = storage;
+    data->capacity = new_capacity;
+}
+
+// Checks that `item` is an `int` that fits in a byte. Returns an exception or NULL.
+static pyobj_t* byte_value(pyobj_t* item, uint8_t* out) {
+    *out = 0;
+
+    if (item->type != &py_type_int)
+        return NEW_EXCEPTION_INLINE(TypeError, "an integer is required");
+
+    if (!PY_INT_IS_SMALL(item) || item->as_int < 0 || item->as_int > 255)
+        return NEW_EXCEPTION_INLINE(ValueError, "byte must be in range(0, 256)");
+
+    *out = (uint8_t)item->as_int;
+    return NULL;
+}
+
+// Returns `true` if the given `str` names an encoding we support, setting `out_ascii` to
+// `true` if it's ASCII, and to `false` if it's UTF-8.
+static bool parse_encoding(pyobj_t* encoding, bool* out_ascii) {
+    if (encoding->type != &py_type_str)
+        return false;
+
+    string_t name = encoding->as_str;
+    *out_ascii = std_strequ(name, STR("ascii")) || std_strequ(name, STR("ASCII"));
+
+    return *out_ascii ||
+        std_strequ(name, STR("utf-8")) ||
+        std_strequ(name, STR("utf8")) ||
+        std_strequ(name, STR("UTF-8"));
+}
+
+// Returns `true` if the given bytes are well-formed UTF-8.
+static bool is_valid_utf8(const uint8_t* data, size_t length) {
+    size_t i = 0;
+
+    while (i < length) {
+        uint8_t lead = data[i];
+
+        if (lead < 0x80) {
+            i++;
+            continue;
+        }
+
+        // Continuation bytes can't start a sequence, and 0xC0, 0xC1 and 0xF5..0xFF can't
+        // appear anywhere.
+        if (lead < 0xC2 || lead > 0xF4)
+            return false;
+
+        size_t n = (size_t)std_utf8_sequence_length((char)lead);
+        if (i + n > length)
+            return false;
+
+        for (size_t j = 1; j < n; j++) {
+            if ((data[i + j] & 0xC0) != 0x80)
+                return false;
+        }
+
+        // Overlong 3 and 4 byte sequences, surrogates, and code points above U+10FFFF.
+        uint8_t next = data[i + 1];
+        if ((lead == 0xE0 && next < 0xA0) || (lead == 0xED && next >= 0xA0))
+            return false;
+
+        if ((lead == 0xF0 && next < 0x90) || (lead == 0xF4 && next >= 0x90))
+            return false;
+
+        i += n;
+    }
+
+    return true;
+}
+
+// Appends the elements of an arbitrary iterable of `int`s to the given `bytearray`.
+static pyobj_t* bytearray_extend_iterable(pyobj_t* bytearray, pyobj_t* iterable) {
+    if (iterable->type == &py_type_str)
+        return NEW_EXCEPTION_INLINE(TypeError, "expected iterable of integers; got: 'str'");
+
+    // We go through the same logic `GET_ITER` and `FOR_ITER` use, on a stack of our own.
+    void* stack[2] = { iterable };
+    int stack_current = 0;
+
+    pyreturn_t status = py_opcode_get_iter(stack, &stack_current);
+    if (status.exception != NULL)
+        return status.exception;
+
+    bytearray_reserve(bytearray, bytearray->as_buffer.length + py_length_hint(stack[0]));
+
+    while (true) {
+        bool exhausted;
+        status = py_opcode_for_iter(stack, &stack_current, &exhausted);
+
+        if (status.exception != NULL)
+            return status.exception;
+
+        if (exhausted)
+            return NULL;
+
+        pyobj_t* exception = py_bytearray_append(bytearray, (pyobj_t*)stack[stack_current--]);
+        if (exception != NULL)
+            return exception;
+    }
+}
+
+pyreturn_t py_alloc_buffer_from(pyobj_t* type, pyobj_t* source, pyobj_t* encoding) {
+    ASSERT(type == &py_type_bytes || type == &py_type_bytearray);
+    bool is_bytes = type == &py_type_bytes;
+
+    if (source == NULL)
+        return WITH_RESULT(alloc_buffer(type, NULL, 0));
+
+    if (source->type == &py_type_str) {
+        bool is_ascii;
+
+        if (encoding == NULL)
+            RAISE(TypeError, "string argument without an encoding");
+
+        if (!parse_encoding(encoding, &is_ascii))
+            RAISE(LookupError, "unknown encoding");
+
+        if (is_ascii && !py_str_is_ascii(source))
+            RAISE(ValueError, "'ascii' codec can't encode characters");
+
+        // `str`s are stored as UTF-8, and are immutable - so `bytes` can share their storage.
+        string_t s = source->as_str;
+        return WITH_RESULT(is_bytes
+            ? py_alloc_bytes_view(s.str, (size_t)s.length)
+            : py_alloc_bytearray(s.str, (size_t)s.length)
+        );
+    }
+
+    if (encoding != NULL)
+        RAISE(TypeError, "encoding without a string argument");
+
+    if (source->type == &py_type_int) {
+        int64_t count;
+        pyobj_t* exception = py_int_as_index(source, &count);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        if (count < 0)
+            RAISE(ValueError, "negative count");
+
+        uint8_t* data = count == 0 ? NULL : mm_heap_alloc((size_t)count);
+        memset(data, 0, (size_t)count);
+        return WITH_RESULT(alloc_buffer(type, data, (size_t)count));
+    }
+
+    uint8_t* data;
+    size_t length;
+
+    if (py_get_buffer(source, &data, &length)) {
+        // `bytes` objects are immutable, so there's no need to copy them.
+        if (is_bytes && source->type == &py_type_bytes)
+            return WITH_RESULT(source);
+
+        return WITH_RESULT(alloc_buffer(type, copy_bytes(data, length), length));
+    }
+
+    pyobj_t* result = alloc_buffer(&py_type_bytearray, NULL, 0);
+
+    pyobj_t* exception = bytearray_extend_iterable(result, source);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    result->type = type;
+    result->as_buffer.readonly = is_bytes;
+    return WITH_RESULT(result);
+}
+
+pyobj_t* py_alloc_buffer_iterator(pyobj_t* buffer) {
+    ENSURE_NOT_NULL(buffer);
+    ASSERT(PY_IS_BUFFER(buffer));
+
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = &py_type_bytes_iterator;
+    obj->as_list_iterator.sequence = buffer;
+    obj->as_list_iterator.index = 0;
+    return obj;
+}
+
+// Reads the element at the given index of the buffer, which has to be within its bounds.
+static pyobj_t* read_item(pyobj_t* buffer, size_t index) {
+    struct buffer_data* data = &buffer->as_buffer;
+    uint8_t* p = buffer_bytes(buffer) + index * data->itemsize;
+    uint64_t raw = 0;
+
+    if (data->is_physical) {
+        switch (data->itemsize) {
+            case 1: raw = *(volatile uint8_t*)p; break;
+            case 2: raw = *(volatile uint16_t*)p; break;
+            case 4: raw = *(volatile uint32_t*)p; break;
+            default: raw = *(volatile uint64_t*)p; break;
+        }
+    }
+    else {
+        memcpy(&raw, p, data->itemsize);
+    }
+
+    if (data->format == 'f') {
+        float x;
+        uint32_t bits = (uint32_t)raw;
+        memcpy(&x, &bits, 4);
+        return py_alloc_float(x);
+    }
+
+    if (data->format == 'd') {
+        double x;
+        memcpy(&x, &raw, 8);
+        return py_alloc_float(x);
+    }
+
+    if (format_is_signed(data->format) && data->itemsize < 8) {
+        // Sign-extend the element to 64 bits.
+        int shift = 64 - data->itemsize * 8;
+        return py_alloc_int((int64_t)(raw << shift) >> shift);
+    }
+
+    if (format_is_signed(data->format) || (int64_t)raw >= 0)
+        return py_alloc_int((int64_t)raw);
+
+    return py_int_from_bytes((const uint8_t*)&raw, 8, true, false);
+}
+
+// Creates the exception raised when a value can't be stored as an element of the given
+// `memoryview`, e.g. "memoryview: invalid value for format 'B'".
+static pyobj_t* new_format_error(pyobj_t* type, string_t message, char format) {
+    char* quoted = mm_heap_alloc(3);
+    quoted[0] = '\'';
+    quoted[1] = format;
+    quoted[2] = '\'';
+
+    string_t parts[] = { message, { .str = quoted, .length = 3 } };
+    return NEW_EXCEPTION(type, py_alloc_str(std_strconcat_array(parts, 2)));
+}
+
+// Stores `value` as the element at the given index of the buffer, which has to be within
+// its bounds. Returns an exception or NULL.
+static pyobj_t* write_item(pyobj_t* buffer, size_t index, pyobj_t* value) {
+    struct buffer_data* data = &buffer->as_buffer;
+    uint8_t* p = buffer_bytes(buffer) + index * data->itemsize;
+
+    if (buffer->type != &py_type_memoryview) {
+        pyobj_t* exception = byte_value(value, p);
+        return exception;
+    }
+
+    uint64_t raw = 0;
+
+    if (format_is_float(data->format)) {
+        double x;
+
+        if (value->type == &py_type_float) {
+            x = value->as_float;
+        }
+        else if (value->type != &py_type_int || !py_int_to_double(value, &x)) {
+            return new_format_error(&py_type_TypeError, STR("memoryview: invalid type for format "), data->format);
+        }
+
+        if (data->format == 'f') {
+            float narrowed = (float)x;
+            memcpy(&raw, &narrowed, 4);
+        }
+        else {
+            memcpy(&raw, &x, 8);
+        }
+    }
+    else {
+        if (value->type != &py_type_int)
+            return new_format_error(&py_type_TypeError, STR("memoryview: invalid type for format "), data->format);
+
+        if (py_int_to_bytes(value, (uint8_t*)&raw, data->itemsize, true, format_is_signed(data->format)) != NULL)
+            return new_format_error(&py_type_ValueError, STR("memoryview: invalid value for format "), data->format);
+    }
+
+    if (data->is_physical) {
+        switch (data->itemsize) {
+            case 1: *(volatile uint8_t*)p = (uint8_t)raw; break;
+            case 2: *(volatile uint16_t*)p = (uint16_t)raw; break;
+            case 4: *(volatile uint32_t*)p = (uint32_t)raw; break;
+            default: *(volatile uint64_t*)p = raw; break;
+        }
+    }
+    else {
+        memcpy(p, &raw, data->itemsize);
+    }
+
+    return NULL;
+}
+
+pyobj_t* py_buffer_iterator_next(pyobj_t* iterator) {
+    ENSURE_NOT_NULL(iterator);
+    ASSERT(iterator->type == &py_type_bytes_iterator);
+
+    struct list_iterator_data* data = &iterator->as_list_iterator;
+    if (data->index >= py_buffer_length(data->sequence))
+        return NULL;
+
+    return read_item(data->sequence, data->index++);
+}
+
+bool py_get_buffer(pyobj_t* obj, uint8_t** out_data, size_t* out_length) {
+    ENSURE_NOT_NULL(obj);
+
+    if (!PY_IS_BUFFER(obj) && !PY_IS_ARRAY(obj))
+        return false;
+
+    *out_data = buffer_bytes(obj);
+    *out_length = obj->as_buffer.length;
+    return true;
+}
+
+size_t py_buffer_length(pyobj_t* buffer) {
+    ENSURE_NOT_NULL(buffer);
+    return buffer->as_buffer.length / buffer->as_buffer.itemsize;
+}
+
+// Resolves `index` to the position of an element within the given buffer, where negative
+// indices count from the end. Returns an exception or NULL.
+static pyobj_t* resolve_index(pyobj_t* buffer, pyobj_t* index, size_t* out_index) {
+    *out_index = 0;
+
+    if (index->type != &py_type_int) {
+        if (buffer->type == &py_type_memoryview)
+            return NEW_EXCEPTION_INLINE(TypeError, "memoryview: invalid slice key");
+
+        return buffer->type == &py_type_bytes
+            ? NEW_EXCEPTION_INLINE(TypeError, "byte indices must be integers or slices")
+            : NEW_EXCEPTION_INLINE(TypeError, "bytearray indices must be integers or slices");
+    }
+
+    int64_t length = (int64_t)py_buffer_length(buffer);
+    int64_t i = index->as_int;
+
+    if (PY_INT_IS_SMALL(index) && i < 0) {
+        i += length;
+    }
+
+    if (!PY_INT_IS_SMALL(index) || i < 0 || i >= length) {
+        if (buffer->type == &py_type_memoryview)
+            return NEW_EXCEPTION_INLINE(IndexError, "index out of bounds on dimension 1");
+
+        return buffer->type == &py_type_bytes
+            ? NEW_EXCEPTION_INLINE(IndexError, "index out of range")
+            : NEW_EXCEPTION_INLINE(IndexError, "bytearray index out of range");
+    }
+
+    *out_index = (size_t)i;
+    return NULL;
+}
+
+// Implements `buffer[slice]`.
+static pyreturn_t buffer_getslice(pyobj_t* buffer, pyobj_t* slice) {
+    int64_t start, stop, step, count;
+    pyobj_t* exception = py_slice_resolve(slice, (int64_t)py_buffer_length(buffer), &start, &stop, &step, &count);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    uint8_t* data = buffer_bytes(buffer);
+
+    if (buffer->type == &py_type_memoryview) {
+        if (step != 1)
+            RAISE(NotImplementedError, "memoryview slices with a step other than 1 are not supported");
+
+        // The result views the same memory - we only have to move its bounds.
+        size_t itemsize = buffer->as_buffer.itemsize;
+        struct buffer_data data = buffer->as_buffer;
+        data.length = (size_t)count * itemsize;
+
+        if (data.owner != NULL) {
+            data.offset += (size_t)start * itemsize;
+        }
+        else {
+            data.data += (size_t)start * itemsize;
+        }
+
+        return WITH_RESULT(alloc_view(data));
+    }
+
+    // `bytes` are immutable, so contiguous slices of them can share their storage.
+    if (buffer->type == &py_type_bytes && step == 1)
+        return WITH_RESULT(py_alloc_bytes_view(data + start, (size_t)count));
+
+    uint8_t* result = count == 0 ? NULL : mm_heap_alloc((size_t)count);
+
+    if (step == 1) {
+        memcpy(result, data + start, (size_t)count);
+    }
+    else {
+        for (int64_t i = 0; i < count; i++) {
+            result[i] = data[start + i * step];
+        }
+    }
+
+    return WITH_RESULT(alloc_buffer(buffer->type, result, (size_t)count));
+}
+
+pyreturn_t py_buffer_getitem(pyobj_t* buffer, pyobj_t* index) {
+    ENSURE_NOT_NULL(buffer);
+    ENSURE_NOT_NULL(index);
+    ASSERT(PY_IS_BUFFER(buffer));
+
+    if (index->type == &py_type_slice)
+        return buffer_getslice(buffer, index);
+
+    size_t i;
+    pyobj_t* exception = resolve_index(buffer, index, &i);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(read_item(buffer, i));
+}
+
+// Implements `buffer[slice] = value`, where the buffer is a `bytearray` or a writable
+// `memoryview`.
+static pyobj_t* buffer_setslice(pyobj_t* buffer, pyobj_t* slice, pyobj_t* value) {
+    int64_t start, stop, step, count;
+    pyobj_t* exception = py_slice_resolve(slice, (int64_t)py_buffer_length(buffer), &start, &stop, &step, &count);
+    if (exception != NULL)
+        return exception;
+
+    uint8_t* source;
+    size_t source_length;
+
+    if (buffer->type == &py_type_memoryview) {
+        if (step != 1)
+            return NEW_EXCEPTION_INLINE(NotImplementedError, "memoryview slices with a step other than 1 are not supported");
+
+        size_t itemsize = buffer->as_buffer.itemsize;
+
+        if (!py_get_buffer(value, &source, &source_length))
+            return NEW_EXCEPTION_INLINE(TypeError, "a bytes-like object is required");
+
+        if (source_length != (size_t)count * itemsize)
+            return NEW_EXCEPTION_INLINE(ValueError, "memoryview assignment: lvalue and rvalue have different structures");
+
+        memmove(buffer_bytes(buffer) + (size_t)start * itemsize, source, source_length);
+        return NULL;
+    }
+
+    if (value->type == &py_type_int)
+        return NEW_EXCEPTION_INLINE(TypeError, "can assign only bytes, buffers, or iterables of ints in range(0, 256)");
+
+    // Storing a view of the `bytearray` into itself would read the bytes we're overwriting,
+    // so we make a copy of such values first, as we do with values that aren't buffers.
+    bool aliases = value == buffer || (PY_IS_BUFFER(value) && value->as_buffer.owner == buffer);
+
+    if (aliases || !PY_IS_BUFFER(value)) {
+        pyreturn_t copy = py_alloc_buffer_from(&py_type_bytearray, value, NULL);
+        if (copy.exception != NULL)
+            return copy.exception;
+
+        value = copy.value;
+    }
+
+    ASSERT(py_get_buffer(value, &source, &source_length));
+
+    if (step != 1) {
+        if ((size_t)count != source_length)
+            return NEW_EXCEPTION_INLINE(ValueError, "attempt to assign bytes to extended slice of a different size");
+
+        // An empty buffer might not have any storage at all.
+        if (count == 0 || source == NULL)
+            return NULL;
+
+        uint8_t* data = buffer_bytes(buffer);
+        for (int64_t i = 0; i < count; i++) {
+            data[start + i * step] = source[i];
+        }
+
+        return NULL;
+    }
+
+    // With a step of 1, the replaced range may have a different size than the new bytes,
+    // so we move the tail of the `bytearray` to where the new bytes end.
+    if (source_length != (size_t)count) {
+        exception = bytearray_check_resizable(buffer);
+        if (exception != NULL)
+            return exception;
+    }
+
+    size_t length = buffer->as_buffer.length;
+    size_t tail = (size_t)start + (size_t)count;
+
+    bytearray_reserve(buffer, length - (size_t)count + source_length);
+
+    uint8_t* data = buffer->as_buffer.data;
+    memmove(data + start + source_length, data + tail, length - tail);
+    memcpy(data + start, source, source_length);
+
+    buffer->as_buffer.length = length - (size_t)count + source_length;
+    return NULL;
+}
+
+pyobj_t* py_buffer_setitem(pyobj_t* buffer, pyobj_t* index, pyobj_t* value) {
+    ENSURE_NOT_NULL(buffer);
+    ENSURE_NOT_NULL(index);
+    ENSURE_NOT_NULL(value);
+    ASSERT(PY_IS_BUFFER(buffer));
+
+    if (buffer->type == &py_type_bytes)
+        return NEW_EXCEPTION_INLINE(TypeError, "'bytes' object does not support item assignment");
+
+    if (buffer->as_buffer.readonly)
+        return NEW_EXCEPTION_INLINE(TypeError, "cannot modify read-only memory");
+
+    if (index->type == &py_type_slice)
+        return buffer_setslice(buffer, index, value);
+
+    size_t i;
+    pyobj_t* exception = resolve_index(buffer, index, &i);
+    if (exception != NULL)
+        return exception;
+
+    return write_item(buffer, i, value);
+}
+
+pyobj_t* py_buffer_delitem(pyobj_t* buffer, pyobj_t* index) {
+    ENSURE_NOT_NULL(buffer);
+    ENSURE_NOT_NULL(index);
+    ASSERT(PY_IS_BUFFER(buffer));
+
+    if (buffer->type == &py_type_bytes)
+        return NEW_EXCEPTION_INLINE(TypeError, "'bytes' object doesn't support item deletion");
+
+    if (buffer->type == &py_type_memoryview)
+        return NEW_EXCEPTION_INLINE(TypeError, "cannot delete memory");
+
+    int64_t start, step, count;
+
+    if (index->type == &py_type_slice) {
+        int64_t stop;
+        pyobj_t* exception = py_slice_resolve(index, (int64_t)buffer->as_buffer.length, &start, &stop, &step, &count);
+        if (exception != NULL)
+            return exception;
+
+        if (count == 0)
+            return NULL;
+
+        // We remove the bytes in ascending order, so that we can compact the `bytearray`
+        // in a single pass.
+        if (step < 0) {
+            start += (count - 1) * step;
+            step = -step;
+        }
+    }
+    else {
+        size_t i;
+        pyobj_t* exception = resolve_index(buffer, index, &i);
+        if (exception != NULL)
+            return exception;
+
+        start = (int64_t)i;
+        step = 1;
+        count = 1;
+    }
+
+    pyobj_t* exception = bytearray_check_resizable(buffer);
+    if (exception != NULL)
+        return exception;
+
+    uint8_t* data = buffer->as_buffer.data;
+    size_t length = buffer->as_buffer.length;
+    size_t write = (size_t)start;
+    int64_t removed = 0;
+
+    for (size_t read = (size_t)start; read < length; read++) {
+        bool is_removed = removed < count && read == (size_t)(start + removed * step);
+
+        if (is_removed) {
+            removed++;
+        }
+        else {
+            data[write++] = data[read];
+        }
+    }
+
+    buffer->as_buffer.length = write;
+    return NULL;
+}
+
+pyobj_t* py_buffer_contains(pyobj_t* buffer, pyobj_t* item, bool* out_contains) {
+    ENSURE_NOT_NULL(buffer);
+    ENSURE_NOT_NULL(item);
+    ENSURE_NOT_NULL(out_contains);
+    ASSERT(PY_IS_BUFFER(buffer));
+
+    *out_contains = false;
+
+    if (buffer->type == &py_type_memoryview) {
+        // Views are searched element by element, like any other sequence.
+        size_t length = py_buffer_length(buffer);
+        pyobj_t* exception = NULL;
+
+        for (size_t i = 0; i < length && !*out_contains; i++) {
+            *out_contains = py_keys_equal(read_item(buffer, i), item, &exception);
+            if (exception != NULL)
+                return exception;
+        }
+
+        return NULL;
+    }
+
+    const char* data = (const char*)buffer_bytes(buffer);
+    size_t length = buffer->as_buffer.length;
+
+    if (item->type == &py_type_int) {
+        uint8_t byte;
+        pyobj_t* exception = byte_value(item, &byte);
+        if (exception != NULL)
+            return exception;
+
+        *out_contains = std_memchr(data, (char)byte, length) != NULL;
+        return NULL;
+    }
+
+    uint8_t* needle;
+    size_t needle_length;
+
+    if (!py_get_buffer(item, &needle, &needle_length))
+        return NEW_EXCEPTION_INLINE(TypeError, "a bytes-like object is required");
+
+    string_t haystack_view = { .str = data, .length = (int)length };
+    string_t needle_view = { .str = (const char*)needle, .length = (int)needle_length };
+    *out_contains = std_strfind(haystack_view, needle_view) >= 0;
+    return NULL;
+}
+
+bool py_buffers_equal(pyobj_t* a, pyobj_t* b) {
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+    ASSERT(PY_IS_BUFFER(a) && PY_IS_BUFFER(b));
+
+    size_t length = py_buffer_length(a);
+    if (length != py_buffer_length(b))
+        return false;
+
+    if (a->as_buffer.format == b->as_buffer.format)
+        return std_memequ(buffer_bytes(a), buffer_bytes(b), a->as_buffer.length);
+
+    for (size_t i = 0; i < length; i++) {
+        if (py_int_compare(read_item(a, i), read_item(b, i)) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+pyreturn_t py_buffer_concat(pyobj_t* a, pyobj_t* b) {
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+    ASSERT(a->type == &py_type_bytes || a->type == &py_type_bytearray);
+
+    uint8_t* b_data;
+    size_t b_length;
+
+    if (!py_get_buffer(b, &b_data, &b_length))
+        RAISE(TypeError, "can't concat non-bytes-like object to bytes");
+
+    size_t a_length = a->as_buffer.length;
+    size_t length = a_length + b_length;
+    uint8_t* data = length == 0 ? NULL : mm_heap_alloc(length);
+
+    memcpy(data, buffer_bytes(a), a_length);
+    memcpy(data + a_length, b_data, b_length);
+    return WITH_RESULT(alloc_buffer(a->type, data, length));
+}
+
+pyobj_t* py_bytearray_append(pyobj_t* bytearray, pyobj_t* item) {
+    ENSURE_NOT_NULL(bytearray);
+    ENSURE_NOT_NULL(item);
+    ASSERT(bytearray->type == &py_type_bytearray);
+
+    uint8_t byte;
+    pyobj_t* exception = byte_value(item, &byte);
+    if (exception != NULL)
+        return exception;
+
+    exception = bytearray_check_resizable(bytearray);
+    if (exception != NULL)
+        return exception;
+
+    struct buffer_data* data = &bytearray->as_buffer;
+    bytearray_reserve(bytearray, data->length + 1);
+    data->data[data->length++] = byte;
+    return NULL;
+}
+
+pyobj_t* py_bytearray_extend(pyobj_t* bytearray, pyobj_t* iterable) {
+    ENSURE_NOT_NULL(bytearray);
+    ENSURE_NOT_NULL(iterable);
+    ASSERT(bytearray->type == &py_type_bytearray);
+
+    pyobj_t* exception = bytearray_check_resizable(bytearray);
+    if (exception != NULL)
+        return exception;
+
+    if (!PY_IS_BUFFER(iterable))
+        return bytearray_extend_iterable(bytearray, iterable);
+
+    // We only look at the source bytes after growing, as `iterable` might view the storage
+    // of `bytearray` itself.
+    size_t count = iterable->as_buffer.length;
+    if (count == 0)
+        return NULL;
+
+    struct buffer_data* data = &bytearray->as_buffer;
+    bytearray_reserve(bytearray, data->length + count);
+
+    memmove(data->data + data->length, buffer_bytes(iterable), count);
+    data->length += count;
+    return NULL;
+}
+
+pyreturn_t py_memoryview_cast(pyobj_t* view, pyobj_t* format) {
+    ENSURE_NOT_NULL(view);
+    ENSURE_NOT_NULL(format);
+    ASSERT(view->type == &py_type_memoryview);
+
+    if (format->type != &py_type_str)
+        RAISE(TypeError, "memoryview: format argument must be a string");
+
+    char new_format = format->as_str.length == 1 ? format->as_str.str[0] : '\0';
+    uint8_t itemsize = format_itemsize(new_format);
+
+    if (itemsize == 0)
+        RAISE(ValueError, "memoryview: destination format must be a native single character format prefixed with an optional '@'");
+
+    if (view->as_buffer.itemsize != 1 && itemsize != 1)
+        RAISE(TypeError, "memoryview: cannot cast between two non-byte formats");
+
+    if (view->as_buffer.length % itemsize != 0)
+        RAISE(TypeError, "memoryview: length is not a multiple of itemsize");
+
+    struct buffer_data data = view->as_buffer;
+    data.format = new_format;
+    data.itemsize = itemsize;
+    return WITH_RESULT(alloc_view(data));
+}
+
+int64_t py_bytes_hash(pyobj_t* bytes) {
+    ENSURE_NOT_NULL(bytes);
+    ASSERT(bytes->type == &py_type_bytes);
+
+    // This matches what `py_hash` does for a `str`.
+    string_t view = { .str = (const char*)bytes->as_buffer.data, .length = (int)bytes->as_buffer.length };
+    uint64_t hash = std_strhash(view);
+    return (hash == 0 || hash == (uint64_t)-1) ? 1 : (int64_t)hash;
+}
+
+pyobj_t* py_buffer_hex(pyobj_t* buffer) {
+    ENSURE_NOT_NULL(buffer);
+    ASSERT(PY_IS_BUFFER(buffer));
+
+    static const char digits[] = "0123456789abcdef";
+
+    size_t length = buffer->as_buffer.length;
+    if (length == 0)
+        return py_alloc_str_analyzed(STR(""), 0, true);
+
+    const uint8_t* data = buffer_bytes(buffer);
+    char* result = mm_heap_alloc(length * 2);
+
+    for (size_t i = 0; i < length; i++) {
+        result[i * 2] = digits[data[i] >> 4];
+        result[i * 2 + 1] = digits[data[i] & 0xF];
+    }
+
+    string_t s = { .str = result, .length = (int)(length * 2) };
+    return py_alloc_str_analyzed(s, s.length, true);
+}
+
+pyreturn_t py_buffer_decode(pyobj_t* buffer, pyobj_t* encoding) {
+    ENSURE_NOT_NULL(buffer);
+    ASSERT(PY_IS_BUFFER(buffer));
+
+    bool ascii_only = false;
+    if (encoding != NULL && !parse_encoding(encoding, &ascii_only))
+        RAISE(LookupError, "unknown encoding");
+
+    uint8_t* data = buffer_bytes(buffer);
+    size_t length = buffer->as_buffer.length;
+
+    string_t s = { .str = (const char*)data, .length = (int)length };
+
+    bool is_ascii;
+    int codepoints = std_utf8_analyze(s, &is_ascii);
+
+    if (!is_ascii) {
+        if (ascii_only)
+            RAISE(ValueError, "'ascii' codec can't decode bytes");
+
+        if (!is_valid_utf8(data, length))
+            RAISE(ValueError, "'utf-8' codec can't decode bytes");
+    }
+
+    // `str`s are immutable, as are `bytes` - so they can share their storage. Other
+    // buffers might change later on, so we copy them.
+    if (buffer->type != &py_type_bytes) {
+        s.str = (const char*)copy_bytes(data, length);
+    }
+
+    return WITH_RESULT(py_alloc_str_analyzed(s, codepoints, is_ascii));
+}
+
+// Converts `x` to a hexadecimal number, without leading zeroes.
+static string_t hex_address(uint64_t x) {
+    char* result = mm_heap_alloc(16);
+    int length = 0;
+
+    for (int shift = 60; shift >= 0; shift -= 4) {
+        int digit = (x >> shift) & 0xF;
+
+        if (length != 0 || digit != 0 || shift == 0) {
+            result[length++] = "0123456789abcdef"[digit];
+        }
+    }
+
+    return (string_t) { .str = result, .length = length };
+}
+
+string_t py_buffer_to_str(pyobj_t* buffer) {
+    ENSURE_NOT_NULL(buffer);
+    ASSERT(PY_IS_BUFFER(buffer));
+
+    if (buffer->type == &py_type_memoryview) {
+        string_t parts[] = { STR("<memory at 0x"), hex_address((uint64_t)buffer), STR(">") };
+        return std_strconcat_array(parts, 3);
+    }
+
+    const uint8_t* data = buffer_bytes(buffer);
+    size_t length = buffer->as_buffer.length;
+
+    // Like Python, we only use double quotes if they avoid escaping single quotes.
+    bool has_single = std_memchr((const char*)data, '\'', length) != NULL;
+    bool has_double = std_memchr((const char*)data, '"', length) != NULL;
+    char quote = has_single && !has_double ? '"' : '\'';
+
+    // Each byte takes at most 4 characters, as `\xNN`. Then, we have the `bytearray(`
+    // prefix, the `b` prefix, the quotes and the closing parenthesis.
+    char* result = mm_heap_alloc(length * 4 + 14);
+    int n = 0;
+
+    bool is_bytearray = buffer->type == &py_type_bytearray;
+    if (is_bytearray) {
+        memcpy(result, "bytearray(", 10);
+        n += 10;
+    }
+
+    result[n++] = 'b';
+    result[n++] = quote;
+
+    for (size_t i = 0; i < length; i++) {
+        uint8_t c = data[i];
+
+        if (c == quote || c == '\\') {
+            result[n++] = '\\';
+            result[n++] = (char)c;
+        }
+        else if (c == '\t' || c == '\n' || c == '\r') {
+            result[n++] = '\\';
+            result[n++] = c == '\t' ? 't' : (c == '\n' ? 'n' : 'r');
+        }
+        else if (c < 0x20 || c >= 0x7F) {
+            result[n++] = '\\';
+            result[n++] = 'x';
+            result[n++] = "0123456789abcdef"[c >> 4];
+            result[n++] = "0123456789abcdef"[c & 0xF];
+        }
+        else {
+            result[n++] = (char)c;
+        }
+    }
+
+    result[n++] = quote;
+
+    if (is_bytearray) {
+        result[n++] = ')';
+    }
+
+    return (string_t) { .str = result, .length = n };
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "objects.h"
+#include "exceptions.h"
+#include "sys/mm.h"
+
+// Python `bytes`, `bytearray` and `memoryview` objects describe a run of bytes in
+// `as_buffer`. `bytes` are immutable, and so, like `str`s, slicing them with a step of 1
+// results in a view that shares the storage of the original object. `bytearray`s own
+// their storage, which grows geometrically as bytes are appended.
+//
+// A `memoryview` exposes the storage of another object - or a range of physical memory -
+// without copying it, interpreting it as a sequence of elements of the `struct` format
+// given by `as_buffer.format`. Views into a `bytearray` (or an `array`, see `arrays.h`) refer
+// to it through `owner`, so that they stay valid when it grows and moves its storage. Views into physical
+// memory access it with volatile loads and stores of the element width, which makes them
+// suitable for device registers, framebuffers and DMA regions.
+
+// Evaluates to `true` if the given object is a `bytes`, `bytearray` or `memoryview`.
+#define PY_IS_BUFFER($x) (                    \
+    (($x)->type == &py_type_bytes) ||         \
+    (($x)->type == &py_type_bytearray) ||     \
+    (($x)->type == &py_type_memoryview)       \
+)
+
+// Allocates a `bytes` object that holds a copy of the given bytes.
+pyobj_t* py_alloc_bytes(const void* data, size_t length);
+
+// Allocates a `bytes` object that refers to the given bytes, without copying them. The
+// bytes must never change for as long as the object is alive.
+pyobj_t* py_alloc_bytes_view(const void* data, size_t length);
+
+// Allocates a `bytearray` that holds a copy of the given bytes.
+pyobj_t* py_alloc_bytearray(const void* data, size_t length);
+
+// Allocates a read-write `memoryview` of unsigned bytes over `length` bytes of physical
+// memory, starting at `address`.
+pyobj_t* py_alloc_physical_memoryview(physaddr_t address, size_t length);
+
+// Implements `memoryview(source)`, where `source` is a buffer or an `array`. Returns an exception or the new `memoryview`.
+pyreturn_t py_alloc_memoryview(pyobj_t* source);
+
+// Implements `bytes(source)` and `bytearray(source)`, where `type` is either `py_type_bytes`
+// or `py_type_bytearray`. `source` may be `NULL`, in which case the result is empty.
+// `encoding` is only valid (and required) when `source` is a `str`, and may otherwise be
+// `NULL`. Returns an exception or the new object.
+pyreturn_t py_alloc_buffer_from(pyobj_t* type, pyobj_t* source, pyobj_t* encoding);
+
+// Allocates an iterator over the elements of the given `bytes`, `bytearray` or `memoryview`.
+pyobj_t* py_alloc_buffer_iterator(pyobj_t* buffer);
+
+// Advances the given buffer iterator, returning the next element, or `NULL` if the iterator
+// is exhausted.
+pyobj_t* py_buffer_iterator_next(pyobj_t* iterator);
+
+// If the given object is a `bytes`, `bytearray`, `memoryview` or `array`, sets `out_data`
+// and `out_length` to the bytes it exposes and returns `true`. Otherwise, returns `false`.
+bool py_get_buffer(pyobj_t* obj, uint8_t** out_data, size_t* out_length);
+
+// Returns the number of elements in the given buffer, like Python's `len(buffer)`.
+size_t py_buffer_length(pyobj_t* buffer);
+
+// Implements `buffer[index]`, where `index` is an `int` or a `slice`.
+pyreturn_t py_buffer_getitem(pyobj_t* buffer, pyobj_t* index);
+
+// Implements `buffer[index] = value`, where `index` is an `int` or a `slice`. Returns an
+// exception or NULL.
+pyobj_t* py_buffer_setitem(pyobj_t* buffer, pyobj_t* index, pyobj_t* value);
+
+// Implements `del buffer[index]`, where `index` is an `int` or a `slice`. Only `bytearray`s
+// support this. Returns an exception or NULL.
+pyobj_t* py_buffer_delitem(pyobj_t* buffer, pyobj_t* index);
+
+// Implements `item in buffer`. For `bytes` and `bytearray`s, `item` may either be an `int`
+// or a bytes-like object that is searched for as a subsequence. Returns an exception or NULL.
+pyobj_t* py_buffer_contains(pyobj_t* buffer, pyobj_t* item, bool* out_contains);
+
+// Implements `a == b`, where both operands are buffers. Views that differ in their format
+// are compared element by element.
+bool py_buffers_equal(pyobj_t* a, pyobj_t* b);
+
+// Implements `a + b`, where `a` is a `bytes` or `bytearray`, and `b` is any bytes-like
+// object. The result is of the type of `a`.
+pyreturn_t py_buffer_concat(pyobj_t* a, pyobj_t* b);
+
+// Implements `bytearray.append(item)`. Returns an exception or NULL.
+pyobj_t* py_bytearray_append(pyobj_t* bytearray, pyobj_t* item);
+
+// Implements `bytearray.extend(iterable)`, which also implements `bytearray += iterable`.
+// Returns an exception or NULL.
+pyobj_t* py_bytearray_extend(pyobj_t* bytearray, pyobj_t* iterable);
+
+// Implements `memoryview.cast(format)`. Returns an exception or the new `memoryview`.
+pyreturn_t py_memoryview_cast(pyobj_t* view, pyobj_t* format);
+
+// Implements `memoryview.release()`. The view becomes empty, and no longer prevents the
+// `bytearray` it viewed from being resized.
+void py_memoryview_release(pyobj_t* view);
+
+// Computes the hash of the given `bytes`, which is equal to the hash of a `str` with the
+// same contents.
+int64_t py_bytes_hash(pyobj_t* bytes);
+
+// Implements `buffer.hex()`.
+pyobj_t* py_buffer_hex(pyobj_t* buffer);
+
+// Implements `buffer.decode(encoding)`, where `encoding` may be `NULL` for UTF-8. Returns an
+// exception or the decoded `str`.
+pyreturn_t py_buffer_decode(pyobj_t* buffer, pyobj_t* encoding);
+
+// Converts the given buffer to its string representation, e.g. `b'\x00ab'`.
+string_t py_buffer_to_str(pyobj_t* buffer);
@@ -5,6 +5,18 @@
 #include "std/safety.h"
 #include "classes.h"
 #include "exceptions.h"
+#include "dicts.h"
+#include "sets.h"
+#include "strings.h"
+#include "buffers.h"
+#include "arrays.h"
+#include "matrices.h"
+#include "sorting.h"
+#include "formatting.h"
+#include "lists.h"
+#include "ints.h"
+#include "mmio.h"
+#include "opcodes.h"
 
 DEFINE_FUNCTION_WRAPPER(py_builtin_build_class, __build_class__);
 PY_DEFINE(py_builtin_build_class) {
@@ -56,26 +68,401 @@ PY_DEFINE(py_builtin_build_class) {
 
 DEFINE_FUNCTION_WRAPPER(py_builtin_print, print);
 PY_DEFINE(py_builtin_print) {
-    // Do note, we only expect one string argument - but the actual print() function
-    // should be able to accept any kind of argument
-    // TODO: Fully featured print()
+    string_t sep = STR(" ");
+    string_t end = STR("\n");
+    bool flush = false;
 
-    if (argc == 0) {
-        terminal_newline();
-        return WITH_RESULT(&py_none);
+    for (int i = 0; i < kwargc; i++) {
+        string_t name = kwargv[i].name;
+        pyobj_t* value = NOT_NULL(kwargv[i].value);
+
+        if (std_strequ(name, STR("sep")) || std_strequ(name, STR("end"))) {
+            if (value == &py_none)
+                continue;
+
+            if (value->type != &py_type_str)
+                RAISE(TypeError, "sep and end must be None or a string");
+
+            *(std_strequ(name, STR("sep")) ? &sep : &end) = value->as_str;
+        }
+        else if (std_strequ(name, STR("file"))) {
+            if (value != &py_none)
+                RAISE(TypeError, "print() can only write to the terminal");
+        }
+        else if (std_strequ(name, STR("flush"))) {
+            flush = value != &py_none && value != &py_false;
+        }
+        else {
+            RAISE(TypeError, "print() got an unexpected keyword argument");
+        }
+    }
+
+    // We convert all arguments up-front, so that nothing gets printed if any of the
+    // conversions fail.
+    string_t parts[argc == 0 ? 1 : argc];
+
+    for (int i = 0; i < argc; i++) {
+        pyobj_t* str = UNWRAP(py_str_of(NOT_NULL(argv)[i]));
+        parts[i] = str->as_str;
+    }
+
+    // The terminal buffers its output, so writing the parts one by one doesn't render
+    // anything until the line (or a batch of lines) is complete.
+    for (int i = 0; i < argc; i++) {
+        if (i != 0) {
+            terminal_write(sep.str, (size_t)sep.length);
+        }
+
+        terminal_write(parts[i].str, (size_t)parts[i].length);
+    }
+
+    terminal_write(end.str, (size_t)end.length);
+
+    if (flush) {
+        terminal_flush();
+    }
+
+    return WITH_RESULT(&py_none);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_builtin_format, format);
+PY_DEFINE(py_builtin_format) {
+    if (argc < 1 || argc > 2)
+        RAISE(TypeError, "format() expected 1 or 2 arguments");
+
+    static pyobj_t empty = PY_STR_LITERAL("");
+    return py_format(NOT_NULL(argv)[0], argc == 2 ? argv[1] : &empty);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_builtin_len, len);
+PY_DEFINE(py_builtin_len) {
+    if (argc != 1)
+        RAISE(TypeError, "len() takes exactly one argument");
+
+    pyobj_t* obj = NOT_NULL(NOT_NULL(argv)[0]);
+
+    if (obj->type == &py_type_list || obj->type == &py_type_tuple)
+        return WITH_RESULT(py_alloc_int((int64_t)obj->as_list.length));
+
+    if (obj->type == &py_type_str)
+        return WITH_RESULT(py_alloc_int(py_str_length(obj)));
+
+    if (obj->type == &py_type_dict)
+        return WITH_RESULT(py_alloc_int((int64_t)obj->as_dict->length));
+
+    if (PY_IS_SET(obj))
+        return WITH_RESULT(py_alloc_int((int64_t)py_set_length(obj)));
+
+    if (PY_IS_BUFFER(obj))
+        return WITH_RESULT(py_alloc_int((int64_t)py_buffer_length(obj)));
+
+    if (PY_IS_ARRAY(obj))
+        return WITH_RESULT(py_alloc_int((int64_t)py_array_length(obj)));
+
+    if (PY_IS_MATRIX(obj))
+        return WITH_RESULT(py_alloc_int((int64_t)obj->as_matrix.rows));
+
+    pyobj_t* method_len;
+    bool is_unbound = py_get_method_attribute(obj, STR("__len__"), &method_len);
+    if (method_len == NULL)
+        RAISE(TypeError, "object has no len()");
+
+    pyobj_t* length = UNWRAP(py_call(method_len, 0, NULL, 0, NULL, is_unbound ? obj : NULL));
+    if (length->type != &py_type_int)
+        RAISE(TypeError, "__len__() should return an integer");
+
+    return WITH_RESULT(length);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_builtin_hash, hash);
+PY_DEFINE(py_builtin_hash) {
+    if (argc != 1)
+        RAISE(TypeError, "hash() takes exactly one argument");
+
+    int64_t hash;
+    pyobj_t* exception = py_hash(NOT_NULL(NOT_NULL(argv)[0]), &hash);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(py_alloc_int(hash));
+}
+
+DEFINE_FUNCTION_WRAPPER(py_builtin_pow, pow);
+PY_DEFINE(py_builtin_pow) {
+    if (argc != 2 && argc != 3)
+        RAISE(TypeError, "pow() takes 2 or 3 arguments");
+
+    ENSURE_NOT_NULL(argv);
+
+    pyobj_t* base = NOT_NULL(argv[0]);
+    pyobj_t* exp = NOT_NULL(argv[1]);
+
+    if (argc == 3 && argv[2] != &py_none) {
+        pyobj_t* mod = NOT_NULL(argv[2]);
+
+        if (base->type != &py_type_int || exp->type != &py_type_int || mod->type != &py_type_int)
+            RAISE(TypeError, "pow() 3rd argument not allowed unless all arguments are integers");
+
+        return py_int_powmod(base, exp, mod);
     }
 
-    if (argc != 1) {
-        // TODO: print() can accept any number of arguments.
-        sys_panic("More than one argument is not yet supported for print().");
+    // Without a modulus, this is equivalent to `base ** exp`.
+    void* stack[2] = { base, exp };
+    int stack_current = 1;
+
+    pyobj_t* exception = py_opcode_op_pow(stack, &stack_current);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(stack[stack_current]);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_builtin_physical_memory, physical_memory);
+PY_DEFINE(py_builtin_physical_memory) {
+    if (argc != 2)
+        RAISE(TypeError, "physical_memory() takes exactly two arguments");
+
+    int64_t address, length;
+
+    pyobj_t* exception = py_int_as_index(NOT_NULL(NOT_NULL(argv)[0]), &address);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    exception = py_int_as_index(NOT_NULL(argv[1]), &length);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    if (address < 0 || length < 0)
+        RAISE(ValueError, "physical_memory() address and length must be non-negative");
+
+    return WITH_RESULT(py_alloc_physical_memoryview((physaddr_t)address, (size_t)length));
+}
+
+// Converts the address argument of the MMIO builtins. Returns an exception or NULL.
+static pyobj_t* mmio_address_arg(pyobj_t* x, physaddr_t* out) {
+    *out = 0;
+    int64_t address;
+
+    pyobj_t* exception = py_int_as_index(NOT_NULL(x), &address);
+    if (exception != NULL)
+        return exception;
+
+    if (address < 0)
+        return NEW_EXCEPTION_INLINE(ValueError, "address must be non-negative");
+
+    *out = (physaddr_t)address;
+    return NULL;
+}
+
+// Converts the value argument of the `write*` builtins to an unsigned integer of `width`
+// bits. Returns an exception or NULL.
+static pyobj_t* mmio_value_arg(pyobj_t* x, int width, uint64_t* out) {
+    ENSURE_NOT_NULL(x);
+    *out = 0;
+
+    if (x->type != &py_type_int)
+        return NEW_EXCEPTION_INLINE(TypeError, "expected an integer");
+
+    if (PY_INT_IS_SMALL(x)) {
+        if (x->as_int < 0 || (width < 64 && x->as_int >= (int64_t)(1ull << width)))
+            return NEW_EXCEPTION_INLINE(OverflowError, "value does not fit in the register");
+
+        *out = (uint64_t)x->as_int;
+        return NULL;
     }
 
-    pyobj_t* value = NOT_NULL(argv)[0];
-    if (value->type != &py_type_str) {
-        // TODO: Any kind of object should be accepted here.
-        sys_panic("Expected a 'str' argument for print().");
+    // Big integers are only ever used for values that don't fit in an `int64_t`, and so,
+    // the only ones that fit are the non-negative ones of a single limb, for `write64`.
+    const bigint_t* big = x->as_bigint;
+    if (width < 64 || big->negative || big->length != 1)
+        return NEW_EXCEPTION_INLINE(OverflowError, "value does not fit in the register");
+
+    *out = big->limbs[0];
+    return NULL;
+}
+
+#define DEFINE_MMIO_BUILTINS($width)                                                    \
+    DEFINE_FUNCTION_WRAPPER(py_builtin_read##$width, read##$width);                     \
+    PY_DEFINE(py_builtin_read##$width) {                                                \
+        if (argc != 1)                                                                  \
+            RAISE(TypeError, "read" #$width "() takes exactly one argument");           \
+                                                                                        \
+        physaddr_t address;                                                             \
+        pyobj_t* exception = mmio_address_arg(NOT_NULL(argv)[0], &address);             \
+        if (exception != NULL)                                                          \
+            return WITH_EXCEPTION(exception);                                           \
+                                                                                        \
+        return WITH_RESULT(py_mmio_box(py_mmio_read##$width(address)));                 \
+    }                                                                                   \
+                                                                                        \
+    DEFINE_FUNCTION_WRAPPER(py_builtin_write##$width, write##$width);                   \
+    PY_DEFINE(py_builtin_write##$width) {                                               \
+        if (argc != 2)                                                                  \
+            RAISE(TypeError, "write" #$width "() takes exactly two arguments");         \
+                                                                                        \
+        physaddr_t address;                                                             \
+        pyobj_t* exception = mmio_address_arg(NOT_NULL(argv)[0], &address);             \
+        if (exception != NULL)                                                          \
+            return WITH_EXCEPTION(exception);                                           \
+                                                                                        \
+        uint64_t value;                                                                 \
+        exception = mmio_value_arg(argv[1], $width, &value);                            \
+        if (exception != NULL)                                                          \
+            return WITH_EXCEPTION(exception);                                           \
+                                                                                        \
+        py_mmio_write##$width(address, (uint##$width##_t)value);                        \
+        return WITH_RESULT(&py_none);                                                   \
     }
 
-    terminal_println(value->as_str.str);
+DEFINE_MMIO_BUILTINS(8)
+DEFINE_MMIO_BUILTINS(16)
+DEFINE_MMIO_BUILTINS(32)
+DEFINE_MMIO_BUILTINS(64)
+
+DEFINE_FUNCTION_WRAPPER(py_builtin_read_block, read_block);
+PY_DEFINE(py_builtin_read_block) {
+    if (argc != 2)
+        RAISE(TypeError, "read_block() takes exactly two arguments");
+
+    physaddr_t address;
+    pyobj_t* exception = mmio_address_arg(NOT_NULL(argv)[0], &address);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    // The whole buffer is filled - to read less, pass a slice of a `memoryview` of it.
+    pyobj_t* buffer = NOT_NULL(argv[1]);
+    uint8_t* data;
+    size_t length;
+
+    if (!py_get_buffer(buffer, &data, &length) || (PY_IS_BUFFER(buffer) && buffer->as_buffer.readonly))
+        RAISE(TypeError, "read_block() argument 2 must be a writable bytes-like object");
+
+    py_mmio_copy(data, mm_phys_to_virt(address), length);
     return WITH_RESULT(&py_none);
 }
+
+DEFINE_FUNCTION_WRAPPER(py_builtin_write_block, write_block);
+PY_DEFINE(py_builtin_write_block) {
+    if (argc != 2)
+        RAISE(TypeError, "write_block() takes exactly two arguments");
+
+    physaddr_t address;
+    pyobj_t* exception = mmio_address_arg(NOT_NULL(argv)[0], &address);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    uint8_t* data;
+    size_t length;
+
+    if (!py_get_buffer(NOT_NULL(argv[1]), &data, &length))
+        RAISE(TypeError, "write_block() argument 2 must be a bytes-like object");
+
+    py_mmio_copy(mm_phys_to_virt(address), data, length);
+    return WITH_RESULT(&py_none);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_builtin_sorted, sorted);
+PY_DEFINE(py_builtin_sorted) {
+    if (argc != 1)
+        RAISE(TypeError, "sorted() takes exactly one positional argument");
+
+    pyobj_t* key;
+    bool reverse;
+    pyobj_t* exception = py_sort_parse_kwargs(kwargc, kwargv, &key, &reverse, NULL);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    pyobj_t* iterable = NOT_NULL(NOT_NULL(argv)[0]);
+    pyobj_t* list = py_alloc_list(py_length_hint(iterable));
+
+    exception = py_list_extend(list, iterable);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    exception = py_sort(list->as_list.elements, list->as_list.length, key, reverse);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(list);
+}
+
+// Implements both `min` (if `is_max` is `false`) and `max`.
+static pyreturn_t min_or_max(int argc, pyobj_t** argv, int kwargc, symbol_t* kwargv, bool is_max) {
+    if (argc == 0)
+        RAISE(TypeError, "expected at least 1 argument, got 0");
+
+    pyobj_t* key;
+    pyobj_t* fallback;
+    pyobj_t* exception = py_sort_parse_kwargs(kwargc, kwargv, &key, NULL, &fallback);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    ENSURE_NOT_NULL(argv);
+
+    if (argc > 1) {
+        if (fallback != NULL)
+            RAISE(TypeError, "cannot specify a default with multiple positional arguments");
+
+        return py_sort_extreme(argv, (size_t)argc, key, is_max);
+    }
+
+    pyobj_t* iterable = NOT_NULL(argv[0]);
+    pyobj_t** items;
+    size_t n;
+
+    if (iterable->type == &py_type_list || iterable->type == &py_type_tuple) {
+        items = iterable->as_list.elements;
+        n = iterable->as_list.length;
+    } else {
+        pyobj_t* list = py_alloc_list(py_length_hint(iterable));
+
+        exception = py_list_extend(list, iterable);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        items = list->as_list.elements;
+        n = list->as_list.length;
+    }
+
+    if (n == 0) {
+        if (fallback != NULL)
+            return WITH_RESULT(fallback);
+
+        RAISE(ValueError, "iterable argument is empty");
+    }
+
+    return py_sort_extreme(items, n, key, is_max);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_builtin_min, min);
+PY_DEFINE(py_builtin_min) {
+    return min_or_max(argc, argv, kwargc, kwargv, false);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_builtin_max, max);
+PY_DEFINE(py_builtin_max) {
+    return min_or_max(argc, argv, kwargc, kwargv, true);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_builtin_sort_comparisons, sort_comparisons);
+PY_DEFINE(py_builtin_sort_comparisons) {
+    if (argc != 0)
+        RAISE(TypeError, "sort_comparisons() takes no arguments");
+
+    return WITH_RESULT(py_alloc_int((int64_t)py_sort_comparisons));
+}
+
+DEFINE_FUNCTION_WRAPPER(py_builtin_terminal_stats, terminal_stats);
+PY_DEFINE(py_builtin_terminal_stats) {
+    if (argc != 0)
+        RAISE(TypeError, "terminal_stats() takes no arguments");
+
+    terminal_stats_t stats = terminal_get_stats();
+
+    pyobj_t* tuple = py_alloc_tuple(4);
+    tuple->as_list.elements[0] = py_alloc_int((int64_t)stats.bytes_written);
+    tuple->as_list.elements[1] = py_alloc_int((int64_t)stats.flushes);
+    tuple->as_list.elements[2] = py_alloc_int((int64_t)stats.bytes_per_second);
+    tuple->as_list.elements[3] = py_alloc_int((int64_t)stats.flushes_per_second);
+    return WITH_RESULT(tuple);
+}
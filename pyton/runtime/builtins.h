@@ -12,7 +12,100 @@
 extern pyobj_t* KNOWN_GLOBAL(__build_class__);
 PY_DEFINE(py_builtin_build_class);
 
-// def print(...)
+// def print(*objects, sep = " ", end = "\n", file = None, flush = False)
 #define PY_GLOBAL_print_WELLKNOWN
 extern pyobj_t* KNOWN_GLOBAL(print);
 PY_DEFINE(py_builtin_print);
+
+// def format(value, format_spec = "")
+#define PY_GLOBAL_format_WELLKNOWN
+extern pyobj_t* KNOWN_GLOBAL(format);
+PY_DEFINE(py_builtin_format);
+
+// def len(obj)
+#define PY_GLOBAL_len_WELLKNOWN
+extern pyobj_t* KNOWN_GLOBAL(len);
+PY_DEFINE(py_builtin_len);
+
+// def hash(obj)
+#define PY_GLOBAL_hash_WELLKNOWN
+extern pyobj_t* KNOWN_GLOBAL(hash);
+PY_DEFINE(py_builtin_hash);
+
+// def pow(base, exp, mod = None)
+#define PY_GLOBAL_pow_WELLKNOWN
+extern pyobj_t* KNOWN_GLOBAL(pow);
+PY_DEFINE(py_builtin_pow);
+
+// def physical_memory(address, length)
+#define PY_GLOBAL_physical_memory_WELLKNOWN
+extern pyobj_t* KNOWN_GLOBAL(physical_memory);
+PY_DEFINE(py_builtin_physical_memory);
+
+// def read8(address), read16(address), read32(address), read64(address)
+#define PY_GLOBAL_read8_WELLKNOWN
+#define PY_GLOBAL_read16_WELLKNOWN
+#define PY_GLOBAL_read32_WELLKNOWN
+#define PY_GLOBAL_read64_WELLKNOWN
+extern pyobj_t* KNOWN_GLOBAL(read8);
+extern pyobj_t* KNOWN_GLOBAL(read16);
+extern pyobj_t* KNOWN_GLOBAL(read32);
+extern pyobj_t* KNOWN_GLOBAL(read64);
+PY_DEFINE(py_builtin_read8);
+PY_DEFINE(py_builtin_read16);
+PY_DEFINE(py_builtin_read32);
+PY_DEFINE(py_builtin_read64);
+
+// def write8(address, value), write16(address, value), write32(address, value), write64(address, value)
+#define PY_GLOBAL_write8_WELLKNOWN
+#define PY_GLOBAL_write16_WELLKNOWN
+#define PY_GLOBAL_write32_WELLKNOWN
+#define PY_GLOBAL_write64_WELLKNOWN
+extern pyobj_t* KNOWN_GLOBAL(write8);
+extern pyobj_t* KNOWN_GLOBAL(write16);
+extern pyobj_t* KNOWN_GLOBAL(write32);
+extern pyobj_t* KNOWN_GLOBAL(write64);
+PY_DEFINE(py_builtin_write8);
+PY_DEFINE(py_builtin_write16);
+PY_DEFINE(py_builtin_write32);
+PY_DEFINE(py_builtin_write64);
+
+// def read_block(address, buffer)
+#define PY_GLOBAL_read_block_WELLKNOWN
+extern pyobj_t* KNOWN_GLOBAL(read_block);
+PY_DEFINE(py_builtin_read_block);
+
+// def write_block(address, data)
+#define PY_GLOBAL_write_block_WELLKNOWN
+extern pyobj_t* KNOWN_GLOBAL(write_block);
+PY_DEFINE(py_builtin_write_block);
+
+// def sorted(iterable, *, key = None, reverse = False)
+#define PY_GLOBAL_sorted_WELLKNOWN
+extern pyobj_t* KNOWN_GLOBAL(sorted);
+PY_DEFINE(py_builtin_sorted);
+
+// def min(iterable, *, key = None, default = ...)
+// def min(arg1, arg2, *args, key = None)
+#define PY_GLOBAL_min_WELLKNOWN
+extern pyobj_t* KNOWN_GLOBAL(min);
+PY_DEFINE(py_builtin_min);
+
+// def max(iterable, *, key = None, default = ...)
+// def max(arg1, arg2, *args, key = None)
+#define PY_GLOBAL_max_WELLKNOWN
+extern pyobj_t* KNOWN_GLOBAL(max);
+PY_DEFINE(py_builtin_max);
+
+// def sort_comparisons()
+// Returns the amount of comparisons the sort engine made so far (see `sorting.h`).
+#define PY_GLOBAL_sort_comparisons_WELLKNOWN
+extern pyobj_t* KNOWN_GLOBAL(sort_comparisons);
+PY_DEFINE(py_builtin_sort_comparisons);
+
+// def terminal_stats()
+// Returns a tuple of the total amount of bytes written to the terminal, the amount of times
+// its buffer was rendered, and both of these over the last second (see `sys/terminal.h`).
+#define PY_GLOBAL_terminal_stats_WELLKNOWN
+extern pyobj_t* KNOWN_GLOBAL(terminal_stats);
+PY_DEFINE(py_builtin_terminal_stats);
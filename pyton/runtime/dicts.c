@@ -0,0 +1,610 @@
+#include "dicts.h"
+
+#include "ints.h"
+#include "lists.h"
+#include "sets.h"
+#include "buffers.h"
+#include "opcodes.h"
+#include "std/safety.h"
+#include "std/memory.h"
+#include "sys/mm.h"
+
+// The modulus of the hashes of numbers, the same one CPython uses on 64-bit platforms.
+// Reducing numbers modulo a prime makes `hash(x)` agree across `int` and `float`.
+#define NUMERIC_HASH_BITS 61
+#define NUMERIC_HASH_MODULUS (((uint64_t)1 << NUMERIC_HASH_BITS) - 1)
+
+// The hash of positive infinity.
+#define NUMERIC_HASH_INF 314159
+
+// Constants used to combine the hashes of the elements of a tuple.
+#define XXPRIME_1 11400714785074694791ull
+#define XXPRIME_2 14029467366897019727ull
+#define XXPRIME_5 2870177450012600261ull
+
+// The exception raised by the last call to `py_hashmap_keys_equal`, if any. See
+// `py_take_key_exception`.
+static pyobj_t* key_exception = NULL;
+
+bool py_hashmap_keys_equal(const void* a, const void* b, const void* context) {
+    // Once a comparison fails, we treat all keys as unequal, so that the map operation
+    // completes as soon as possible.
+    if (key_exception != NULL)
+        return false;
+
+    return py_keys_equal((pyobj_t*)a, (pyobj_t*)b, &key_exception);
+}
+
+pyobj_t* py_take_key_exception(void) {
+    pyobj_t* exception = key_exception;
+    key_exception = NULL;
+    return exception;
+}
+
+// Returns `x mod NUMERIC_HASH_MODULUS`.
+static inline uint64_t reduce_numeric_hash(uint64_t x) {
+    x = (x & NUMERIC_HASH_MODULUS) + (x >> NUMERIC_HASH_BITS);
+    return x >= NUMERIC_HASH_MODULUS ? x - NUMERIC_HASH_MODULUS : x;
+}
+
+// Applies the sign to a reduced magnitude. -1 is never a valid hash in CPython, as it
+// signifies an error there - we follow suit, so that our hashes match.
+static inline int64_t finish_numeric_hash(uint64_t magnitude, bool negative) {
+    int64_t hash = negative ? -(int64_t)magnitude : (int64_t)magnitude;
+    return hash == -1 ? -2 : hash;
+}
+
+// Returns a hash based on the address of `x`. The lower bits of the address are always
+// zero, so we rotate them to the top.
+static inline int64_t identity_hash(const pyobj_t* x) {
+    uint64_t address = (uint64_t)(uintptr_t)x;
+    int64_t hash = (int64_t)((address >> 4) | (address << 60));
+    return hash == -1 ? -2 : hash;
+}
+
+static int64_t hash_int(const pyobj_t* x) {
+    if (PY_INT_IS_SMALL(x)) {
+        bool negative = x->as_int < 0;
+        uint64_t magnitude = negative ? (uint64_t)0 - (uint64_t)x->as_int : (uint64_t)x->as_int;
+        return finish_numeric_hash(reduce_numeric_hash(magnitude), negative);
+    }
+
+    // We evaluate the magnitude limb by limb, starting from the most significant one.
+    // 2^64 is congruent to 2^3 modulo 2^61 - 1, so shifting by a limb is a multiplication by 8.
+    const bigint_t* big = x->as_bigint;
+    uint64_t acc = 0;
+
+    for (size_t i = big->length; i-- > 0;) {
+        acc = reduce_numeric_hash(reduce_numeric_hash(acc << 3) + reduce_numeric_hash(big->limbs[i]));
+    }
+
+    return finish_numeric_hash(acc, big->negative);
+}
+
+static int64_t hash_float(const pyobj_t* x) {
+    double value = x->as_float;
+
+    if (value != value)
+        return identity_hash(x);
+
+    if (value == __builtin_inf() || value == -__builtin_inf())
+        return value > 0 ? NUMERIC_HASH_INF : -NUMERIC_HASH_INF;
+
+    bool negative = value < 0;
+    if (negative) {
+        value = -value;
+    }
+
+    // Split the value into a mantissa in [0.5, 1), and a binary exponent.
+    uint64_t bits = 0;
+    __builtin_memcpy(&bits, &value, sizeof(bits));
+
+    int exponent = (int)((bits >> 52) & 0x7FF);
+    if (exponent == 0) {
+        if (value == 0.0)
+            return 0;
+
+        // Subnormal - scale it up into the normal range first.
+        value *= 18446744073709551616.0; // 2^64
+        __builtin_memcpy(&bits, &value, sizeof(bits));
+        exponent = (int)((bits >> 52) & 0x7FF) - 64;
+    }
+
+    exponent -= 1022;
+    bits = (bits & ~((uint64_t)0x7FF << 52)) | ((uint64_t)1022 << 52);
+
+    double mantissa = 0.0;
+    __builtin_memcpy(&mantissa, &bits, sizeof(mantissa));
+
+    // Consume the mantissa 28 bits at a time, treating it as an integer - see
+    // `_Py_HashDouble` in CPython.
+    uint64_t acc = 0;
+    while (mantissa != 0.0) {
+        acc = ((acc << 28) & NUMERIC_HASH_MODULUS) | acc >> (NUMERIC_HASH_BITS - 28);
+        mantissa *= 268435456.0; // 2^28
+        exponent -= 28;
+
+        uint64_t digit = (uint64_t)mantissa;
+        mantissa -= (double)digit;
+        acc += digit;
+
+        if (acc >= NUMERIC_HASH_MODULUS) {
+            acc -= NUMERIC_HASH_MODULUS;
+        }
+    }
+
+    // Multiply by 2^exponent. As 2^61 is congruent to 1, this is a rotation.
+    exponent = exponent >= 0
+        ? exponent % NUMERIC_HASH_BITS
+        : NUMERIC_HASH_BITS - 1 - ((-1 - exponent) % NUMERIC_HASH_BITS);
+
+    acc = ((acc << exponent) & NUMERIC_HASH_MODULUS) | acc >> (NUMERIC_HASH_BITS - exponent);
+    return finish_numeric_hash(acc, negative);
+}
+
+static pyobj_t* hash_tuple(pyobj_t* x, int64_t* out_hash) {
+    uint64_t acc = XXPRIME_5;
+
+    for (size_t i = 0; i < x->as_list.length; i++) {
+        int64_t lane;
+        pyobj_t* exception = py_hash(x->as_list.elements[i], &lane);
+        if (exception != NULL)
+            return exception;
+
+        acc += (uint64_t)lane * XXPRIME_2;
+        acc = (acc << 31) | (acc >> 33);
+        acc *= XXPRIME_1;
+    }
+
+    acc += x->as_list.length ^ (XXPRIME_5 ^ 3527539ull);
+    *out_hash = acc == (uint64_t)-1 ? 1546275796 : (int64_t)acc;
+    return NULL;
+}
+
+pyobj_t* py_hash(pyobj_t* x, int64_t* out_hash) {
+    ENSURE_NOT_NULL(x);
+    ENSURE_NOT_NULL(out_hash);
+
+    if (x->type == &py_type_str) {
+        if (x->str_hash == 0) {
+            uint64_t hash = std_strhash(x->as_str);
+            x->str_hash = (hash == 0 || hash == (uint64_t)-1) ? 1 : hash;
+        }
+
+        *out_hash = (int64_t)x->str_hash;
+        return NULL;
+    }
+
+    if (x->type == &py_type_int) {
+        *out_hash = hash_int(x);
+        return NULL;
+    }
+
+    if (x->type == &py_type_float) {
+        *out_hash = hash_float(x);
+        return NULL;
+    }
+
+    if (x->type == &py_type_bool) {
+        *out_hash = x->as_bool ? 1 : 0;
+        return NULL;
+    }
+
+    if (x->type == &py_type_tuple)
+        return hash_tuple(x, out_hash);
+
+    if (x->type == &py_type_list)
+        return NEW_EXCEPTION_INLINE(TypeError, "unhashable type: 'list'");
+
+    if (x->type == &py_type_dict)
+        return NEW_EXCEPTION_INLINE(TypeError, "unhashable type: 'dict'");
+
+    if (x->type == &py_type_set)
+        return NEW_EXCEPTION_INLINE(TypeError, "unhashable type: 'set'");
+
+    if (x->type == &py_type_frozenset) {
+        *out_hash = py_frozenset_hash(x);
+        return NULL;
+    }
+
+    if (x->type == &py_type_bytes) {
+        *out_hash = py_bytes_hash(x);
+        return NULL;
+    }
+
+    if (x->type == &py_type_bytearray)
+        return NEW_EXCEPTION_INLINE(TypeError, "unhashable type: 'bytearray'");
+
+    if (x->type == &py_type_memoryview)
+        return NEW_EXCEPTION_INLINE(TypeError, "unhashable type: 'memoryview'");
+
+    if (!x->type->as_type->is_intrinsic) {
+        pyobj_t* method;
+        bool is_unbound = py_get_method_attribute(x, STR("__hash__"), &method);
+
+        if (method != NULL) {
+            pyreturn_t result = py_call(method, 0, NULL, 0, NULL, is_unbound ? x : NULL);
+            if (result.exception != NULL)
+                return result.exception;
+
+            if (NOT_NULL(result.value)->type != &py_type_int)
+                return NEW_EXCEPTION_INLINE(TypeError, "__hash__ method should return an integer");
+
+            *out_hash = hash_int(result.value);
+            return NULL;
+        }
+    }
+
+    *out_hash = identity_hash(x);
+    return NULL;
+}
+
+// Returns `true` and sets `out` to the value of `x` as an `int`, if `x` is a `bool`.
+static inline bool bool_as_int(const pyobj_t* x, pyobj_t* out) {
+    if (x->type != &py_type_bool)
+        return false;
+
+    *out = (pyobj_t) PY_INT_CONSTANT(x->as_bool ? 1 : 0);
+    return true;
+}
+
+bool py_keys_equal(pyobj_t* a, pyobj_t* b, pyobj_t** out_exception) {
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+    ENSURE_NOT_NULL(out_exception);
+
+    *out_exception = NULL;
+
+    if (a == b)
+        return true;
+
+    // `True` and `1` are the same key.
+    pyobj_t a_int, b_int;
+    if (bool_as_int(a, &a_int)) {
+        a = &a_int;
+    }
+
+    if (bool_as_int(b, &b_int)) {
+        b = &b_int;
+    }
+
+    if (a->type == &py_type_str && b->type == &py_type_str)
+        return std_strequ(a->as_str, b->as_str);
+
+    if (a->type == &py_type_int && b->type == &py_type_int)
+        return py_int_compare(a, b) == 0;
+
+    if (a->type == &py_type_float && b->type == &py_type_float)
+        return a->as_float == b->as_float;
+
+    if (a->type == &py_type_int && b->type == &py_type_float) {
+        int order;
+        return py_int_compare_float(a, b->as_float, &order) && order == 0;
+    }
+
+    if (a->type == &py_type_float && b->type == &py_type_int) {
+        int order;
+        return py_int_compare_float(b, a->as_float, &order) && order == 0;
+    }
+
+    if (a->type == b->type && (a->type == &py_type_list || a->type == &py_type_tuple)) {
+        bool equal;
+        *out_exception = py_sequences_equal(a, b, &equal);
+        return *out_exception == NULL && equal;
+    }
+
+    if (a->type == &py_type_dict && b->type == &py_type_dict) {
+        bool equal;
+        *out_exception = py_dicts_equal(a, b, &equal);
+        return *out_exception == NULL && equal;
+    }
+
+    if (PY_IS_BUFFER(a) && PY_IS_BUFFER(b))
+        return py_buffers_equal(a, b);
+
+    if (PY_IS_SET(a) && PY_IS_SET(b)) {
+        bool equal;
+        *out_exception = py_set_equal(a, b, &equal);
+        return *out_exception == NULL && equal;
+    }
+
+    // Only user-defined classes can override `__eq__` - instances of all other built-in
+    // types are only equal to themselves.
+    if (a->type->as_type->is_intrinsic && b->type->as_type->is_intrinsic)
+        return false;
+
+    void* stack[2] = { a, b };
+    int stack_current = 1;
+
+    pyobj_t* exception = py_opcode_compare_equ(stack, &stack_current, true);
+    if (exception == NULL) {
+        exception = py_opcode_to_bool(stack, &stack_current);
+    }
+
+    if (exception != NULL) {
+        *out_exception = exception;
+        return false;
+    }
+
+    return stack[0] == &py_true;
+}
+
+pyobj_t* py_alloc_dict(size_t capacity) {
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = &py_type_dict;
+    obj->as_dict = mm_heap_alloc(sizeof(hashmap_t));
+    *obj->as_dict = (hashmap_t) {};
+
+    if (capacity != 0) {
+        std_hashmap_reserve(obj->as_dict, capacity);
+    }
+
+    return obj;
+}
+
+pyobj_t* py_alloc_dict_iterator(pyobj_t* dict) {
+    ENSURE_NOT_NULL(dict);
+    ASSERT(dict->type == &py_type_dict);
+
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = &py_type_dict_iterator;
+    obj->as_dict_iterator.dict = dict;
+    obj->as_dict_iterator.index = 0;
+    return obj;
+}
+
+pyobj_t* py_dict_iterator_next(pyobj_t* iterator) {
+    ENSURE_NOT_NULL(iterator);
+    ASSERT(iterator->type == &py_type_dict_iterator);
+
+    struct dict_iterator_data* data = &iterator->as_dict_iterator;
+    const hashmap_t* map = data->dict->as_dict;
+
+    // Removed entries are skipped over.
+    while (data->index < map->entries.length) {
+        hashmap_entry_t* entry = &map->entries.elements[data->index++];
+        if (entry->key != NULL)
+            return (pyobj_t*)entry->key;
+    }
+
+    return NULL;
+}
+
+// Appends the representation of `x` to `parts`. Strings are quoted.
+static void append_repr(string_t* parts, int* n, pyobj_t* x) {
+    // TODO: Use __repr__ once we support it.
+    if (x->type == &py_type_str) {
+        parts[(*n)++] = STR("'");
+        parts[(*n)++] = x->as_str;
+        parts[(*n)++] = STR("'");
+    }
+    else {
+        parts[(*n)++] = py_stringify(x);
+    }
+}
+
+pyobj_t* py_new_key_error(pyobj_t* key) {
+    string_t parts[3];
+    int n = 0;
+    append_repr(parts, &n, key);
+    return NEW_EXCEPTION(&py_type_KeyError, py_alloc_str(std_strconcat_array(parts, n)));
+}
+
+pyreturn_t py_dict_get(pyobj_t* dict, pyobj_t* key) {
+    ENSURE_NOT_NULL(dict);
+    ENSURE_NOT_NULL(key);
+    ASSERT(dict->type == &py_type_dict);
+
+    int64_t hash;
+    pyobj_t* exception = py_hash(key, &hash);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    hashmap_entry_t* entry = std_hashmap_find(dict->as_dict, (uint64_t)hash, key, py_hashmap_keys_equal, NULL);
+
+    exception = py_take_key_exception();
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(entry == NULL ? NULL : entry->value);
+}
+
+pyreturn_t py_dict_getitem(pyobj_t* dict, pyobj_t* key) {
+    pyreturn_t result = py_dict_get(dict, key);
+    if (result.exception == NULL && result.value == NULL)
+        return WITH_EXCEPTION(py_new_key_error(key));
+
+    return result;
+}
+
+pyobj_t* py_dict_setitem(pyobj_t* dict, pyobj_t* key, pyobj_t* value) {
+    ENSURE_NOT_NULL(dict);
+    ENSURE_NOT_NULL(key);
+    ENSURE_NOT_NULL(value);
+    ASSERT(dict->type == &py_type_dict);
+
+    int64_t hash;
+    pyobj_t* exception = py_hash(key, &hash);
+    if (exception != NULL)
+        return exception;
+
+    hashmap_entry_t* entry = std_hashmap_insert(dict->as_dict, (uint64_t)hash, key, py_hashmap_keys_equal, NULL, NULL);
+
+    exception = py_take_key_exception();
+    if (exception != NULL) {
+        // The entry was inserted, as the comparison that failed counts as unequal. We
+        // remove it, so that the exception doesn't leave a key without a value behind.
+        if (entry->value == NULL) {
+            std_hashmap_remove(dict->as_dict, (uint64_t)hash, key, py_hashmap_keys_equal, NULL, NULL);
+            py_take_key_exception();
+        }
+
+        return exception;
+    }
+
+    entry->value = value;
+    return NULL;
+}
+
+pyobj_t* py_dict_delitem(pyobj_t* dict, pyobj_t* key) {
+    ENSURE_NOT_NULL(dict);
+    ENSURE_NOT_NULL(key);
+    ASSERT(dict->type == &py_type_dict);
+
+    int64_t hash;
+    pyobj_t* exception = py_hash(key, &hash);
+    if (exception != NULL)
+        return exception;
+
+    bool removed = std_hashmap_remove(dict->as_dict, (uint64_t)hash, key, py_hashmap_keys_equal, NULL, NULL);
+
+    exception = py_take_key_exception();
+    if (exception != NULL)
+        return exception;
+
+    return removed ? NULL : py_new_key_error(key);
+}
+
+pyobj_t* py_dict_contains(pyobj_t* dict, pyobj_t* key, bool* out_contains) {
+    ENSURE_NOT_NULL(out_contains);
+
+    pyreturn_t result = py_dict_get(dict, key);
+    if (result.exception != NULL)
+        return result.exception;
+
+    *out_contains = result.value != NULL;
+    return NULL;
+}
+
+pyobj_t* py_dict_update(pyobj_t* dict, pyobj_t* other) {
+    ENSURE_NOT_NULL(dict);
+    ENSURE_NOT_NULL(other);
+    ASSERT(dict->type == &py_type_dict);
+
+    if (other->type == &py_type_dict) {
+        const hashmap_t* source = other->as_dict;
+        std_hashmap_reserve(dict->as_dict, dict->as_dict->length + source->length);
+
+        // `other` might be `dict` itself - in which case it won't grow, as all keys
+        // are already present.
+        for (size_t i = 0; i < source->entries.length; i++) {
+            hashmap_entry_t entry = source->entries.elements[i];
+            if (entry.key == NULL)
+                continue;
+
+            // We already know the hashes of all keys, so we don't need to go through
+            // `py_dict_setitem`.
+            hashmap_entry_t* target = std_hashmap_insert(
+                dict->as_dict, entry.hash, entry.key,
+                py_hashmap_keys_equal, NULL,
+                NULL
+            );
+
+            pyobj_t* exception = py_take_key_exception();
+            if (exception != NULL)
+                return exception;
+
+            target->value = entry.value;
+        }
+
+        return NULL;
+    }
+
+    // Otherwise, we expect an iterable of key-value pairs.
+    void* stack[2] = { other };
+    int stack_current = 0;
+
+    pyreturn_t status = py_opcode_get_iter(stack, &stack_current);
+    if (status.exception != NULL)
+        return status.exception;
+
+    while (true) {
+        bool exhausted;
+        status = py_opcode_for_iter(stack, &stack_current, &exhausted);
+
+        if (status.exception != NULL)
+            return status.exception;
+
+        if (exhausted)
+            return NULL;
+
+        pyobj_t* pair = stack[stack_current--];
+        if (
+            (pair->type != &py_type_tuple && pair->type != &py_type_list) ||
+            pair->as_list.length != 2
+        ) {
+            return NEW_EXCEPTION_INLINE(TypeError, "dictionary update sequence element has the wrong length");
+        }
+
+        pyobj_t* exception = py_dict_setitem(dict, pair->as_list.elements[0], pair->as_list.elements[1]);
+        if (exception != NULL)
+            return exception;
+    }
+}
+
+pyobj_t* py_dicts_equal(pyobj_t* a, pyobj_t* b, bool* out_result) {
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+    ENSURE_NOT_NULL(out_result);
+    ASSERT(a->type == &py_type_dict && b->type == &py_type_dict);
+
+    *out_result = false;
+
+    if (a->as_dict->length != b->as_dict->length)
+        return NULL;
+
+    // The length is checked on every step, as comparing values might change the dicts.
+    for (size_t i = 0; i < a->as_dict->entries.length; i++) {
+        hashmap_entry_t entry = a->as_dict->entries.elements[i];
+        if (entry.key == NULL)
+            continue;
+
+        // We already know the hashes of all keys, so we don't need to go through
+        // `py_dict_get`.
+        hashmap_entry_t* other = std_hashmap_find(b->as_dict, entry.hash, entry.key, py_hashmap_keys_equal, NULL);
+
+        pyobj_t* exception = py_take_key_exception();
+        if (exception != NULL || other == NULL)
+            return exception;
+
+        if (!py_keys_equal(entry.value, other->value, &exception))
+            return exception;
+    }
+
+    *out_result = a->as_dict->length == b->as_dict->length;
+    return NULL;
+}
+
+string_t py_dict_to_str(pyobj_t* dict) {
+    ENSURE_NOT_NULL(dict);
+    ASSERT(dict->type == &py_type_dict);
+
+    const hashmap_t* map = dict->as_dict;
+
+    // Each entry takes up to 8 parts - a separator, and a key and a value, both of which
+    // might be surrounded by quotes, with a colon in-between. Then, we have the braces.
+    string_t* parts = mm_heap_alloc((map->length * 8 + 2) * sizeof(string_t));
+    int n = 0;
+
+    parts[n++] = STR("{");
+
+    for (size_t i = 0; i < map->entries.length; i++) {
+        hashmap_entry_t entry = map->entries.elements[i];
+        if (entry.key == NULL)
+            continue;
+
+        if (n != 1) {
+            parts[n++] = STR(", ");
+        }
+
+        append_repr(parts, &n, (pyobj_t*)entry.key);
+        parts[n++] = STR(": ");
+        append_repr(parts, &n, entry.value);
+    }
+
+    parts[n++] = STR("}");
+
+    string_t result = std_strconcat_array(parts, n);
+    mm_heap_free(parts);
+    return result;
+}
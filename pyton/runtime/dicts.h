@@ -0,0 +1,71 @@
+#pragma once
+
+#include "objects.h"
+#include "exceptions.h"
+#include "std/hashmap.h"
+
+// Python `dict` objects point to a `hashmap_t` in `as_dict`, mapping `pyobj_t*` keys to
+// `pyobj_t*` values. Entries are kept in insertion order, which is also the order in which
+// iterating over a `dict` yields its keys.
+//
+// Keys are hashed with `py_hash`, and compared with `py_keys_equal` - the full hashes of
+// two keys have to match before the latter is called.
+
+// Computes the hash of the given object, like Python's `hash(x)`. Numbers that compare
+// equal have equal hashes, regardless of their type - e.g. `hash(1) == hash(1.0)`. The
+// hashes of `str` objects are cached. Returns an exception or NULL.
+pyobj_t* py_hash(pyobj_t* x, int64_t* out_hash);
+
+// Compares two keys for equality, like Python's `a == b`. If comparing the keys raised
+// an exception, `out_exception` is set to it, and `false` is returned.
+bool py_keys_equal(pyobj_t* a, pyobj_t* b, pyobj_t** out_exception);
+
+// A `hashmap_equals_t` that compares two `pyobj_t*` keys with `py_keys_equal`. Comparing
+// keys may call into Python code - the hash map is not aware of that, so if a comparison
+// raises an exception, it is kept until `py_take_key_exception` is called, and all keys
+// compare as unequal until then.
+bool py_hashmap_keys_equal(const void* a, const void* b, const void* context);
+
+// Returns the exception raised while comparing keys during the last hash map operation
+// that used `py_hashmap_keys_equal`, and resets it.
+pyobj_t* py_take_key_exception(void);
+
+// Creates the `KeyError` raised when `key` is missing from a container.
+pyobj_t* py_new_key_error(pyobj_t* key);
+
+// Allocates an empty `dict`, with room for at least `capacity` entries before it needs
+// to grow.
+pyobj_t* py_alloc_dict(size_t capacity);
+
+// Allocates an iterator over the keys of the given `dict`.
+pyobj_t* py_alloc_dict_iterator(pyobj_t* dict);
+
+// Advances the given `dict` iterator, returning the next key, or `NULL` if the iterator
+// is exhausted.
+pyobj_t* py_dict_iterator_next(pyobj_t* iterator);
+
+// Implements `dict[key]`. Raises a `KeyError` if there is no such key.
+pyreturn_t py_dict_getitem(pyobj_t* dict, pyobj_t* key);
+
+// Implements `dict.get(key)`, returning `NULL` as the value if there is no such key.
+pyreturn_t py_dict_get(pyobj_t* dict, pyobj_t* key);
+
+// Implements `dict[key] = value`. Returns an exception or NULL.
+pyobj_t* py_dict_setitem(pyobj_t* dict, pyobj_t* key, pyobj_t* value);
+
+// Implements `del dict[key]`. Returns an exception or NULL.
+pyobj_t* py_dict_delitem(pyobj_t* dict, pyobj_t* key);
+
+// Implements `key in dict`. Returns an exception or NULL.
+pyobj_t* py_dict_contains(pyobj_t* dict, pyobj_t* key, bool* out_contains);
+
+// Implements `dict.update(other)`, where `other` is either a `dict`, or an iterable of
+// key-value pairs. Returns an exception or NULL.
+pyobj_t* py_dict_update(pyobj_t* dict, pyobj_t* other);
+
+// Implements `a == b`, where both operands are `dict`s - they are equal if they have the
+// same keys, which map to equal values. Returns an exception or NULL.
+pyobj_t* py_dicts_equal(pyobj_t* a, pyobj_t* b, bool* out_result);
+
+// Converts the given `dict` to its string representation, e.g. `{'a': 1}`.
+string_t py_dict_to_str(pyobj_t* dict);
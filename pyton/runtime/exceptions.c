@@ -42,24 +42,42 @@ CLASS(BaseException)
 DEFINE_BUILTIN_TYPE(BaseException, &py_type_object);
 
 DEFINE_EXCEPTION(Exception, BaseException);
-// DEFINE_EXCEPTION(ArithmeticError, Exception);
+DEFINE_EXCEPTION(ArithmeticError, Exception);
 // DEFINE_EXCEPTION(AssertionError, Exception);
 // DEFINE_EXCEPTION(AttributeError, Exception);
-// DEFINE_EXCEPTION(BufferError, Exception);
+DEFINE_EXCEPTION(BufferError, Exception);
 // DEFINE_EXCEPTION(EOFError, Exception);
 // DEFINE_EXCEPTION(ImportError, Exception);
-// DEFINE_EXCEPTION(LookupError, Exception);
+DEFINE_EXCEPTION(IndexError, LookupError);
+DEFINE_EXCEPTION(KeyError, LookupError);
+DEFINE_EXCEPTION(LookupError, Exception);
 // DEFINE_EXCEPTION(MemoryError, Exception);
 DEFINE_EXCEPTION(NameError, Exception);
+DEFINE_EXCEPTION(NotImplementedError, RuntimeError);
 // DEFINE_EXCEPTION(OSError, Exception);
+DEFINE_EXCEPTION(OverflowError, ArithmeticError);
 // DEFINE_EXCEPTION(ReferenceError, Exception);
-// DEFINE_EXCEPTION(RuntimeError, Exception);
+DEFINE_EXCEPTION(RuntimeError, Exception);
 // DEFINE_EXCEPTION(StopAsyncIteration, Exception);
-DEFINE_EXCEPTION(StopIteration, Exception);
+
+CLASS(StopIteration)
+    // def __init__(self, value = None):
+    CLASS_METHOD(StopIteration, __init__) {
+        // The argument of a StopIteration is the return value of the generator or
+        // iterator that raised it, and is exposed as `value`.
+        py_set_attribute(NOT_NULL(self), STR("value"), argc == 1 ? NOT_NULL(argv)[0] : &py_none);
+        return py_type_BaseException_method___init___fn(self, argc, argv, kwargc, kwargv);
+    };
+
+    CLASS_ATTRIBUTES(StopIteration)
+        HAS_CLASS_METHOD(StopIteration, __init__)
+    END_CLASS_ATTRIBUTES;
+DEFINE_BUILTIN_TYPE(StopIteration, &py_type_Exception);
 // DEFINE_EXCEPTION(SyntaxError, Exception);
 // DEFINE_EXCEPTION(SystemError, Exception);
 DEFINE_EXCEPTION(TypeError, Exception);
-// DEFINE_EXCEPTION(ValueError, Exception);
+DEFINE_EXCEPTION(ValueError, Exception);
+DEFINE_EXCEPTION(ZeroDivisionError, ArithmeticError);
 
 pyobj_t* py_coerce_exception(pyobj_t* from) {
     if (from->type == &py_type_type) {
@@ -93,4 +111,4 @@ pyobj_t* py_coerce_exception(pyobj_t* from) {
 
 invalid:
     return NEW_EXCEPTION_INLINE(TypeError, "exceptions must derive from BaseException");
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -68,10 +68,42 @@ extern pyobj_t* KNOWN_GLOBAL(BaseException);
 extern pyobj_t py_type_Exception;
 extern pyobj_t* KNOWN_GLOBAL(Exception);
 
+#define PY_GLOBAL_ArithmeticError_WELLKNOWN
+extern pyobj_t py_type_ArithmeticError;
+extern pyobj_t* KNOWN_GLOBAL(ArithmeticError);
+
+#define PY_GLOBAL_BufferError_WELLKNOWN
+extern pyobj_t py_type_BufferError;
+extern pyobj_t* KNOWN_GLOBAL(BufferError);
+
+#define PY_GLOBAL_IndexError_WELLKNOWN
+extern pyobj_t py_type_IndexError;
+extern pyobj_t* KNOWN_GLOBAL(IndexError);
+
+#define PY_GLOBAL_KeyError_WELLKNOWN
+extern pyobj_t py_type_KeyError;
+extern pyobj_t* KNOWN_GLOBAL(KeyError);
+
+#define PY_GLOBAL_LookupError_WELLKNOWN
+extern pyobj_t py_type_LookupError;
+extern pyobj_t* KNOWN_GLOBAL(LookupError);
+
 #define PY_GLOBAL_NameError_WELLKNOWN
 extern pyobj_t py_type_NameError;
 extern pyobj_t* KNOWN_GLOBAL(NameError);
 
+#define PY_GLOBAL_NotImplementedError_WELLKNOWN
+extern pyobj_t py_type_NotImplementedError;
+extern pyobj_t* KNOWN_GLOBAL(NotImplementedError);
+
+#define PY_GLOBAL_OverflowError_WELLKNOWN
+extern pyobj_t py_type_OverflowError;
+extern pyobj_t* KNOWN_GLOBAL(OverflowError);
+
+#define PY_GLOBAL_RuntimeError_WELLKNOWN
+extern pyobj_t py_type_RuntimeError;
+extern pyobj_t* KNOWN_GLOBAL(RuntimeError);
+
 #define PY_GLOBAL_StopIteration_WELLKNOWN
 extern pyobj_t py_type_StopIteration;
 extern pyobj_t* KNOWN_GLOBAL(StopIteration);
@@ -80,6 +112,14 @@ extern pyobj_t* KNOWN_GLOBAL(StopIteration);
 extern pyobj_t py_type_TypeError;
 extern pyobj_t* KNOWN_GLOBAL(TypeError);
 
+#define PY_GLOBAL_ValueError_WELLKNOWN
+extern pyobj_t py_type_ValueError;
+extern pyobj_t* KNOWN_GLOBAL(ValueError);
+
+#define PY_GLOBAL_ZeroDivisionError_WELLKNOWN
+extern pyobj_t py_type_ZeroDivisionError;
+extern pyobj_t* KNOWN_GLOBAL(ZeroDivisionError);
+
 // Coerces an object to an exception when raising. It accepts objects of the
 // following types:
 //      - any subtype of `BaseException` or `BaseException` itself. In this case,
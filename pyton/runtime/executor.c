@@ -0,0 +1,472 @@
+#include "executor.h"
+
+#include "classes.h"
+#include "functions.h"
+#include "generators.h"
+#include "lists.h"
+#include "std/safety.h"
+#include "sys/core.h"
+#include "sys/mm.h"
+#include "sys/timer.h"
+#include "sys/terminal.h"
+#include "sys/interrupts.h"
+
+// The number of slots in the timer wheel. Timers that expire more than this many ticks
+// in the future simply stay in their slot for more than one rotation.
+#define TIMER_WHEEL_SLOTS 256
+
+struct task {
+    // The coroutine this task drives.
+    pyobj_t* coro;
+
+    // The value to send into the coroutine the next time it's resumed.
+    pyobj_t* send_value;
+
+    // Completed when the coroutine returns or raises.
+    pyobj_t* future;
+
+    // Links the task into the ready queue, or into the waiter list of a future.
+    task_t* next;
+};
+
+static task_t* ready_head;
+static task_t* ready_tail;
+
+// A FIFO list of futures, linked via `future->next`. Futures that complete at the same
+// time are woken up in the order they were added.
+typedef struct future_list {
+    future_data_t* head;
+
+    // Points to the `next` field of the last future, or to `head` if the list is empty.
+    // Only valid while `head` is not `NULL`.
+    future_data_t** tail;
+} future_list_t;
+
+static future_list_t timer_wheel[TIMER_WHEEL_SLOTS];
+static uint64_t timer_wheel_tick;   // the last tick the wheel was advanced to
+static size_t timer_count;
+
+static future_list_t irq_waiters[INT_IRQ_COUNT];
+static size_t irq_waiter_count;
+static volatile uint16_t irq_pending; // bit N = IRQ N fired since the last poll
+
+static bool executor_running = false;
+
+static void ready_push(task_t* task) {
+    task->next = NULL;
+
+    if (ready_tail == NULL) {
+        ready_head = ready_tail = task;
+    }
+    else {
+        ready_tail->next = task;
+        ready_tail = task;
+    }
+}
+
+static task_t* ready_pop(void) {
+    task_t* task = ready_head;
+    if (task == NULL)
+        return NULL;
+
+    ready_head = task->next;
+    if (ready_head == NULL) {
+        ready_tail = NULL;
+    }
+
+    task->next = NULL;
+    return task;
+}
+
+static void future_list_append(future_list_t* list, future_data_t* data) {
+    if (list->head == NULL) {
+        list->tail = &list->head;
+    }
+
+    data->next = NULL;
+    *list->tail = data;
+    list->tail = &data->next;
+}
+
+static void future_complete(future_data_t* data, pyobj_t* result, pyobj_t* exception) {
+    ASSERT(!data->done);
+
+    data->done = true;
+    data->result = result;
+    data->exception = exception;
+
+    // Wake up everyone waiting for us.
+    task_t* waiter = data->waiters;
+    data->waiters = NULL;
+
+    while (waiter != NULL) {
+        task_t* next = waiter->next;
+        ready_push(waiter);
+        waiter = next;
+    }
+
+    if (data->parent == NULL)
+        return;
+
+    // We're a part of a `gather` - the first exception is propagated to the parent right
+    // away, otherwise it completes once all children do.
+    future_data_t* parent = data->parent->as_future;
+    if (parent->done)
+        return;
+
+    if (exception != NULL) {
+        future_complete(parent, NULL, exception);
+        return;
+    }
+
+    parent->result->as_list.elements[data->parent_index] = result;
+    parent->pending_children--;
+
+    if (parent->pending_children == 0) {
+        future_complete(parent, parent->result, NULL);
+    }
+}
+
+void executor_set_result(pyobj_t* future, pyobj_t* result) {
+    future_complete(NOT_NULL(future)->as_future, NOT_NULL(result), NULL);
+}
+
+void executor_set_exception(pyobj_t* future, pyobj_t* exception) {
+    future_complete(NOT_NULL(future)->as_future, NULL, NOT_NULL(exception));
+}
+
+// Implements `__next__` and `send` for futures. A pending future yields itself, which the
+// executor recognizes as a request to suspend the task until the future completes.
+static pyreturn_t future_next(pyobj_t* self) {
+    future_data_t* data = self->as_future;
+
+    if (data->yield_once) {
+        // A bare `yield` makes the executor put the task at the back of the ready queue.
+        data->yield_once = false;
+        return WITH_RESULT(&py_none);
+    }
+
+    if (!data->done)
+        return WITH_RESULT(self);
+
+    if (data->exception != NULL)
+        return WITH_EXCEPTION(data->exception);
+
+    return WITH_EXCEPTION(NEW_EXCEPTION(&py_type_StopIteration, data->result));
+}
+
+CLASS(future)
+    // def __await__(self):
+    CLASS_METHOD(future, __await__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_future);
+        return WITH_RESULT(self);
+    };
+
+    // def __next__(self):
+    CLASS_METHOD(future, __next__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_future);
+        return future_next(self);
+    };
+
+    // def send(self, value):
+    CLASS_METHOD(future, send) {
+        // Values sent into a future are ignored - the task is always resumed with `None`.
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_future);
+        return future_next(self);
+    };
+
+    // def done(self):
+    CLASS_METHOD(future, done) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_future);
+        return WITH_RESULT(AS_PY_BOOL(self->as_future->done));
+    };
+
+    // def result(self):
+    CLASS_METHOD(future, result) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_future);
+
+        future_data_t* data = self->as_future;
+        if (!data->done)
+            RAISE(RuntimeError, "result is not set");
+
+        if (data->exception != NULL)
+            return WITH_EXCEPTION(data->exception);
+
+        return WITH_RESULT(data->result);
+    };
+
+    CLASS_ATTRIBUTES(future)
+        HAS_CLASS_METHOD(future, __await__),
+        HAS_CLASS_METHOD(future, __next__),
+        HAS_CLASS_METHOD(future, send),
+        HAS_CLASS_METHOD(future, done),
+        HAS_CLASS_METHOD(future, result)
+    END_CLASS_ATTRIBUTES;
+DEFINE_INTRINSIC_TYPE(future);
+
+pyobj_t* executor_alloc_future(void) {
+    future_data_t* data = mm_heap_alloc(sizeof(future_data_t));
+    *data = (future_data_t) {};
+
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = &py_type_future;
+    obj->as_future = data;
+    return obj;
+}
+
+pyreturn_t executor_spawn(pyobj_t* coro) {
+    ENSURE_NOT_NULL(coro);
+
+    if (coro->type != &py_type_coroutine)
+        RAISE(TypeError, "a coroutine was expected");
+
+    task_t* task = mm_heap_alloc(sizeof(task_t));
+    task->coro = coro;
+    task->send_value = &py_none;
+    task->future = executor_alloc_future();
+    ready_push(task);
+
+    return WITH_RESULT(task->future);
+}
+
+pyreturn_t executor_gather(int count, pyobj_t** awaitables) {
+    ASSERT(count >= 0);
+
+    pyobj_t* results = py_alloc_list(count);
+    results->as_list.length = count;
+
+    pyobj_t* gathered = executor_alloc_future();
+    gathered->as_future->result = results;
+    gathered->as_future->pending_children = count;
+
+    for (int i = 0; i < count; i++) {
+        pyobj_t* child = NOT_NULL(awaitables[i]);
+        results->as_list.elements[i] = &py_none;
+
+        if (child->type != &py_type_future) {
+            child = UNWRAP(executor_spawn(child));
+        }
+
+        future_data_t* data = child->as_future;
+        if (data->parent != NULL)
+            RAISE(ValueError, "a future can only be gathered once");
+
+        data->parent = gathered;
+        data->parent_index = i;
+
+        if (data->done) {
+            // We won't get notified about this one, so we account for it right away.
+            if (data->exception != NULL) {
+                gathered->as_future->done = true;
+                gathered->as_future->exception = data->exception;
+            }
+            else {
+                results->as_list.elements[i] = data->result;
+                gathered->as_future->pending_children--;
+            }
+        }
+    }
+
+    if (!gathered->as_future->done && gathered->as_future->pending_children == 0) {
+        gathered->as_future->done = true;
+    }
+
+    return WITH_RESULT(gathered);
+}
+
+pyobj_t* executor_sleep_ticks(uint64_t ticks) {
+    pyobj_t* future = executor_alloc_future();
+    future_data_t* data = future->as_future;
+
+    if (ticks == 0) {
+        // This only lets the other ready tasks run first - we don't wait for the timer.
+        data->done = true;
+        data->result = &py_none;
+        data->yield_once = true;
+        return future;
+    }
+
+    // The wheel only looks at slots after the last tick it processed - a timer that has
+    // already expired fires on the next tick.
+    uint64_t now = timer_ticks();
+    uint64_t deadline = now + ticks;
+    if (deadline <= timer_wheel_tick) {
+        deadline = timer_wheel_tick + 1;
+    }
+
+    data->deadline = deadline;
+
+    future_list_append(&timer_wheel[deadline % TIMER_WHEEL_SLOTS], data);
+    timer_count++;
+
+    return future;
+}
+
+static void executor_irq_handler(int irq) {
+    irq_pending |= (1 << irq);
+}
+
+pyobj_t* executor_wait_irq(int irq) {
+    ASSERT(irq >= 0 && irq < INT_IRQ_COUNT);
+
+    pyobj_t* future = executor_alloc_future();
+    future_data_t* data = future->as_future;
+
+    if (irq_waiters[irq].head == NULL) {
+        // This unmasks the line, if it wasn't unmasked already.
+        int_set_irq_handler(irq, &executor_irq_handler);
+    }
+
+    future_list_append(&irq_waiters[irq], data);
+    irq_waiter_count++;
+
+    return future;
+}
+
+// Completes every future in the given `future_list_t` that satisfies `$predicate`, in
+// order, unlinking it from the list and evaluating `$on_complete`. `$entry` is the name of
+// the variable that holds the current entry.
+#define COMPLETE_WHERE($list, $entry, $predicate, $on_complete)             \
+    {                                                                       \
+        future_data_t** link = &($list).head;                               \
+        while (*link != NULL) {                                             \
+            future_data_t* $entry = *link;                                  \
+            if (!($predicate)) {                                            \
+                link = &$entry->next;                                       \
+                continue;                                                   \
+            }                                                               \
+            *link = $entry->next;                                           \
+            $entry->next = NULL;                                            \
+            $on_complete;                                                   \
+            future_complete($entry, &py_none, NULL);                        \
+        }                                                                   \
+        ($list).tail = link;                                                \
+    }
+
+// Moves expired timers and fired IRQs to the ready queue.
+static void executor_poll(void) {
+    uint64_t now = timer_ticks();
+
+    if (now > timer_wheel_tick) {
+        // If we were busy for longer than a full rotation, every slot needs to be looked at.
+        uint64_t elapsed = now - timer_wheel_tick;
+        uint64_t steps = elapsed >= TIMER_WHEEL_SLOTS ? TIMER_WHEEL_SLOTS : elapsed;
+
+        for (uint64_t i = 1; i <= steps; i++) {
+            size_t slot = (timer_wheel_tick + i) % TIMER_WHEEL_SLOTS;
+            COMPLETE_WHERE(timer_wheel[slot], entry, entry->deadline <= now, timer_count--);
+        }
+
+        timer_wheel_tick = now;
+    }
+
+    if (irq_pending == 0)
+        return;
+
+    int_disable();
+    uint16_t fired = irq_pending;
+    irq_pending = 0;
+    int_enable();
+
+    for (int irq = 0; irq < INT_IRQ_COUNT; irq++) {
+        if ((fired & (1 << irq)) == 0)
+            continue;
+
+        COMPLETE_WHERE(irq_waiters[irq], entry, true, irq_waiter_count--);
+    }
+}
+
+// Resumes the given task until it suspends, returns, or raises.
+static void task_step(task_t* task) {
+    pyobj_t* value = task->send_value;
+    task->send_value = &py_none;
+
+    pyobj_t* out;
+    switch (py_send(task->coro, value, &out)) {
+        case PY_SEND_YIELDED:
+            if (out->type == &py_type_future) {
+                future_data_t* awaited = out->as_future;
+
+                if (awaited->done) {
+                    ready_push(task);
+                }
+                else {
+                    task->next = awaited->waiters;
+                    awaited->waiters = task;
+                }
+            }
+            else if (out == &py_none) {
+                // A bare `yield` - we simply let other tasks run.
+                ready_push(task);
+            }
+            else {
+                executor_set_exception(
+                    task->future,
+                    NEW_EXCEPTION_INLINE(RuntimeError, "task yielded an object that is not a future")
+                );
+            }
+            break;
+        case PY_SEND_RETURNED:
+            executor_set_result(task->future, out);
+            break;
+        case PY_SEND_RAISED:
+            executor_set_exception(task->future, out);
+            break;
+    }
+}
+
+// Halts the CPU until there may be something to do.
+static void executor_idle(void) {
+    terminal_poll();
+
+    // Interrupts are disabled while checking, so that one arriving between the check
+    // and the `hlt` doesn't leave us sleeping with work to do.
+    int_disable();
+
+    if (ready_head == NULL && irq_pending == 0 && timer_ticks() <= timer_wheel_tick) {
+        int_wait();
+    }
+    else {
+        int_enable();
+    }
+}
+
+pyreturn_t executor_run(pyobj_t* coro) {
+    if (executor_running)
+        RAISE(RuntimeError, "run() cannot be called from a running event loop");
+
+    pyobj_t* main = UNWRAP(executor_spawn(coro));
+    future_data_t* main_data = main->as_future;
+
+    executor_running = true;
+
+    while (!main_data->done) {
+        executor_poll();
+
+        task_t* task = ready_pop();
+        if (task != NULL) {
+            task_step(task);
+            continue;
+        }
+
+        if (timer_count == 0 && irq_waiter_count == 0) {
+            // Nothing can ever wake up the remaining tasks.
+            executor_running = false;
+            RAISE(RuntimeError, "all tasks are waiting, but nothing can wake them up");
+        }
+
+        executor_idle();
+    }
+
+    executor_running = false;
+
+    if (main_data->exception != NULL)
+        return WITH_EXCEPTION(main_data->exception);
+
+    return WITH_RESULT(main_data->result);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "objects.h"
+#include "exceptions.h"
+
+// A cooperative, single-threaded executor for coroutines. Tasks are scheduled from
+// a FIFO ready queue, and are suspended when they await a pending future. Futures get
+// completed by other tasks finishing, by timers expiring, or by hardware interrupts.
+// When there's nothing to run, the executor halts the CPU until the next interrupt.
+
+typedef struct task task_t;
+
+// Represents a value that will become available at some point - the result of a task,
+// the expiration of a timer, or the arrival of an interrupt.
+typedef struct future_data {
+    // `true` once the future has been completed, either with a result or an exception.
+    bool done;
+
+    // Valid when `done` is `true` and `exception` is `NULL`.
+    pyobj_t* result;
+
+    // The exception the future was completed with, if any.
+    pyobj_t* exception;
+
+    // The tasks suspended until this future completes, linked via `task->next`.
+    task_t* waiters;
+
+    // Links this future into a timer wheel slot, or into an IRQ wait list. A future
+    // can only ever be in one of them.
+    struct future_data* next;
+
+    // The tick at which the future completes, if it's a timer.
+    uint64_t deadline;
+
+    // If not `NULL`, this future is a child of a `gather` future, and its result will be
+    // stored at index `parent_index` of the parent's result list.
+    pyobj_t* parent;
+    size_t parent_index;
+
+    // For `gather` futures, the number of children that haven't completed yet.
+    size_t pending_children;
+
+    // If `true`, the future has already completed, but awaiting it still suspends the
+    // task once, letting other ready tasks run first - see `executor_sleep_ticks`.
+    bool yield_once;
+} future_data_t;
+
+// The type of future objects. Awaiting a pending future suspends the current task.
+extern pyobj_t py_type_future;
+
+// Allocates a new, pending future.
+pyobj_t* executor_alloc_future(void);
+
+// Completes the given future with a result, waking up all tasks waiting on it.
+void executor_set_result(pyobj_t* future, pyobj_t* result);
+
+// Completes the given future with an exception, waking up all tasks waiting on it.
+void executor_set_exception(pyobj_t* future, pyobj_t* exception);
+
+// Schedules the given coroutine to run as a new task. Returns a future that completes
+// with the return value of the coroutine.
+pyreturn_t executor_spawn(pyobj_t* coro);
+
+// Returns a future that completes when all of the given awaitables complete. Coroutines
+// are spawned as new tasks. The result of the future is a list of the results, in the
+// order of the awaitables.
+pyreturn_t executor_gather(int count, pyobj_t** awaitables);
+
+// Returns a future that completes after the given number of timer ticks. Timers with the
+// same deadline complete in the order they were created. A delay of 0 ticks only yields
+// to the other ready tasks, without waiting for the timer.
+pyobj_t* executor_sleep_ticks(uint64_t ticks);
+
+// Returns a future that completes when the given IRQ line fires.
+pyobj_t* executor_wait_irq(int irq);
+
+// Runs the given coroutine to completion, alongside all other tasks spawned while doing so.
+// Returns the result of the coroutine.
+pyreturn_t executor_run(pyobj_t* coro);
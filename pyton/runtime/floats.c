@@ -0,0 +1,122 @@
+#include "floats.h"
+
+#include "std/fmath.h"
+
+pyobj_t* py_float_mod(double a, double b, double* out) {
+    if (b == 0.0)
+        return NEW_EXCEPTION_INLINE(ZeroDivisionError, "float modulo by zero");
+
+    double mod = std_fmod(a, b);
+    if (mod == 0.0) {
+        mod = __builtin_copysign(0.0, b);
+    }
+    else if ((b < 0.0) != (mod < 0.0)) {
+        mod += b;
+    }
+
+    *out = mod;
+    return NULL;
+}
+
+pyobj_t* py_float_floordiv(double a, double b, double* out) {
+    if (b == 0.0)
+        return NEW_EXCEPTION_INLINE(ZeroDivisionError, "float floor division by zero");
+
+    // As in CPython, we derive the quotient from the exact remainder - `a - mod` is then
+    // (nearly) a multiple of `b`, and dividing it doesn't round across an integer.
+    double mod = std_fmod(a, b);
+    double div = (a - mod) / b;
+
+    if (mod != 0.0 && (b < 0.0) != (mod < 0.0)) {
+        div -= 1.0;
+    }
+
+    if (div == 0.0) {
+        *out = __builtin_copysign(0.0, a / b);
+        return NULL;
+    }
+
+    double floor_div = std_floor(div);
+    if (div - floor_div > 0.5) {
+        floor_div += 1.0;
+    }
+
+    *out = floor_div;
+    return NULL;
+}
+
+// Returns `true` if `x` is an odd integer.
+static inline bool is_odd_integer(double x) {
+    return std_fmod(__builtin_fabs(x), 2.0) == 1.0;
+}
+
+pyobj_t* py_float_pow(double a, double b, double* out) {
+    // The special cases follow CPython, which in turn follows C99 (Annex F).
+    if (b == 0.0) {
+        *out = 1.0;
+        return NULL;
+    }
+
+    if (__builtin_isnan(a)) {
+        *out = a;
+        return NULL;
+    }
+
+    if (__builtin_isnan(b)) {
+        *out = a == 1.0 ? 1.0 : b;
+        return NULL;
+    }
+
+    if (__builtin_isinf(b)) {
+        double magnitude = __builtin_fabs(a);
+        if (magnitude == 1.0) {
+            *out = 1.0;
+        }
+        else {
+            *out = (b > 0.0) == (magnitude > 1.0) ? __builtin_fabs(b) : 0.0;
+        }
+
+        return NULL;
+    }
+
+    if (__builtin_isinf(a)) {
+        if (b > 0.0) {
+            *out = is_odd_integer(b) ? a : __builtin_fabs(a);
+        }
+        else {
+            *out = is_odd_integer(b) ? __builtin_copysign(0.0, a) : 0.0;
+        }
+
+        return NULL;
+    }
+
+    if (a == 0.0) {
+        if (b < 0.0)
+            return NEW_EXCEPTION_INLINE(ZeroDivisionError, "0.0 cannot be raised to a negative power");
+
+        *out = is_odd_integer(b) ? a : 0.0;
+        return NULL;
+    }
+
+    bool negate = false;
+    if (a < 0.0) {
+        // CPython returns a complex number here, which we don't have.
+        if (b != std_floor(b))
+            return NEW_EXCEPTION_INLINE(ValueError, "negative number cannot be raised to a fractional power");
+
+        a = -a;
+        negate = is_odd_integer(b);
+    }
+
+    if (a == 1.0) {
+        *out = negate ? -1.0 : 1.0;
+        return NULL;
+    }
+
+    double result = std_pow(a, b);
+    if (__builtin_isinf(result))
+        return NEW_EXCEPTION_INLINE(OverflowError, "(34, 'Numerical result out of range')");
+
+    *out = negate ? -result : result;
+    return NULL;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "objects.h"
+#include "exceptions.h"
+
+// Python `float` objects hold their value in `as_float`. The following implement the
+// binary operators over two `float` values that can fail, with the same semantics as
+// Python - the rest map directly to C operators. Each one sets `out` to the result, and
+// returns an exception or NULL.
+
+// Implements `a % b`. The result has the same sign as `b`.
+pyobj_t* py_float_mod(double a, double b, double* out);
+
+// Implements `a // b`, rounding towards negative infinity.
+pyobj_t* py_float_floordiv(double a, double b, double* out);
+
+// Implements `a ** b`. As there is no `complex` type, a negative `a` raised to a
+// fractional power results in a `ValueError`.
+pyobj_t* py_float_pow(double a, double b, double* out);
@@ -0,0 +1,819 @@
+#include "formatting.h"
+
+#include "ints.h"
+#include "strings.h"
+#include "std/bigint.h"
+#include "std/memory.h"
+#include "std/numfmt.h"
+#include "std/strbuilder.h"
+#include "std/utf8.h"
+#include "sys/mm.h"
+
+// Creates a `ValueError` with a message made up of the given strings.
+#define FORMAT_ERROR(...) NEW_EXCEPTION(&py_type_ValueError, py_alloc_str(std_strconcat(__VA_ARGS__)))
+
+// A parsed format specification, which has the following form:
+//      [[fill]align][sign]["z"]["#"]["0"][width][grouping]["." precision][type]
+typedef struct format_spec {
+    // The character the value is padded with. This is a single code point, which may be
+    // encoded with more than one byte.
+    string_t fill;
+
+    // One of '<', '>', '^' or '=', or '\0' if the type's default alignment should be used.
+    char align;
+
+    // One of '+', '-' or ' ', or '\0' if not given, which behaves like '-'.
+    char sign;
+
+    // `true` if negative zero should be coerced to positive zero (the "z" option).
+    bool coerce_zero;
+
+    // `true` if the alternate form should be used (the "#" option).
+    bool alternate;
+
+    // The minimum number of code points of the result, or -1 if not given.
+    int width;
+
+    // ',' or '_' if groups of digits should be separated, or '\0' otherwise.
+    char grouping;
+
+    // The number of digits after the decimal point (or significant digits, depending on
+    // the type), or -1 if not given.
+    int precision;
+
+    // The presentation type, e.g. 'x' or 'f', or '\0' if not given.
+    char type;
+} format_spec_t;
+
+static bool is_align(char c) {
+    return c == '<' || c == '>' || c == '^' || c == '=';
+}
+
+static bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Parses the decimal number at `*pos` in `spec`, if there is one, advancing `*pos` past it.
+// Returns an exception or NULL.
+static pyobj_t* parse_spec_number(string_t spec, int* pos, int* out) {
+    if (*pos >= spec.length || !is_digit(spec.str[*pos]))
+        return NULL;
+
+    int value = 0;
+    for (; *pos < spec.length && is_digit(spec.str[*pos]); (*pos)++) {
+        if (value > (INT32_MAX - 9) / 10)
+            return NEW_EXCEPTION_INLINE(ValueError, "Too many decimal digits in format string");
+
+        value = value * 10 + (spec.str[*pos] - '0');
+    }
+
+    *out = value;
+    return NULL;
+}
+
+// Parses the given format specification. `default_align` is the alignment the type uses
+// when none is given, and `type_name` is the name of the type for error messages. Returns
+// an exception or NULL.
+static pyobj_t* parse_spec(string_t spec, char default_align, string_t type_name, format_spec_t* out) {
+    *out = (format_spec_t) {
+        .fill = STR(" "),
+        .align = '\0',
+        .sign = '\0',
+        .coerce_zero = false,
+        .alternate = false,
+        .width = -1,
+        .grouping = '\0',
+        .precision = -1,
+        .type = '\0'
+    };
+
+    const char* s = spec.str;
+    int n = spec.length;
+    int i = 0;
+
+    // The fill character may only be given along with an alignment.
+    bool fill_given = false;
+    int fill_length = n == 0 ? 0 : std_utf8_sequence_length(s[0]);
+    if (fill_length < n && is_align(s[fill_length])) {
+        out->fill = (string_t) { .str = s, .length = fill_length };
+        out->align = s[fill_length];
+        fill_given = true;
+        i = fill_length + 1;
+    }
+    else if (n != 0 && is_align(s[0])) {
+        out->align = s[0];
+        i = 1;
+    }
+
+    if (i < n && (s[i] == '+' || s[i] == '-' || s[i] == ' ')) {
+        out->sign = s[i++];
+    }
+
+    if (i < n && s[i] == 'z') {
+        out->coerce_zero = true;
+        i++;
+    }
+
+    if (i < n && s[i] == '#') {
+        out->alternate = true;
+        i++;
+    }
+
+    // A leading zero pads numbers with zeros between their sign and their digits.
+    if (i < n && s[i] == '0' && !fill_given) {
+        out->fill = STR("0");
+        if (out->align == '\0' && default_align == '>') {
+            out->align = '=';
+        }
+
+        i++;
+    }
+
+    pyobj_t* exception = parse_spec_number(spec, &i, &out->width);
+    if (exception != NULL)
+        return exception;
+
+    if (i < n && (s[i] == ',' || s[i] == '_')) {
+        out->grouping = s[i++];
+
+        if (i < n && (s[i] == ',' || s[i] == '_'))
+            return NEW_EXCEPTION_INLINE(ValueError, "Cannot specify both ',' and '_'.");
+    }
+
+    if (i < n && s[i] == '.') {
+        i++;
+
+        if (i >= n || !is_digit(s[i]))
+            return NEW_EXCEPTION_INLINE(ValueError, "Format specifier missing precision");
+
+        exception = parse_spec_number(spec, &i, &out->precision);
+        if (exception != NULL)
+            return exception;
+    }
+
+    if (n - i > 1)
+        return FORMAT_ERROR(STR("Invalid format specifier '"), spec, STR("' for object of type '"), type_name, STR("'"));
+
+    if (i < n) {
+        out->type = s[i];
+    }
+
+    return NULL;
+}
+
+// Creates the error raised for presentation types the given type doesn't support.
+static pyobj_t* unknown_format_code(char type, string_t type_name) {
+    return FORMAT_ERROR(
+        STR("Unknown format code '"), ((string_t) { .str = &type, .length = 1 }),
+        STR("' for object of type '"), type_name, STR("'")
+    );
+}
+
+static void append_char(strbuilder_t* builder, char c) {
+    std_strbuilder_append(builder, (string_t) { .str = &c, .length = 1 });
+}
+
+static void append_repeated(strbuilder_t* builder, string_t s, int count) {
+    for (int i = 0; i < count; i++) {
+        std_strbuilder_append(builder, s);
+    }
+}
+
+// Pads `head` and `body` to the width of the given spec, and allocates the result. For
+// '=' alignment, the padding goes between them - `head` holds the sign and base prefix of
+// numbers. `codepoints` is the number of code points in `head` and `body` combined.
+static pyobj_t* pad(
+    const format_spec_t* spec,
+    char default_align,
+    string_t head,
+    string_t body,
+    int codepoints,
+    bool is_ascii
+) {
+    int padding = spec->width > codepoints ? spec->width - codepoints : 0;
+    int before = 0, middle = 0, after = 0;
+
+    switch (spec->align == '\0' ? default_align : spec->align) {
+        case '<': after = padding; break;
+        case '^': before = padding / 2; after = padding - before; break;
+        case '=': middle = padding; break;
+        default: before = padding; break;
+    }
+
+    strbuilder_t* builder = std_strbuilder_alloc(
+        (size_t)head.length + (size_t)body.length + (size_t)padding * (size_t)spec->fill.length
+    );
+
+    append_repeated(builder, spec->fill, before);
+    std_strbuilder_append(builder, head);
+    append_repeated(builder, spec->fill, middle);
+    std_strbuilder_append(builder, body);
+    append_repeated(builder, spec->fill, after);
+
+    return py_alloc_str_analyzed(
+        std_strbuilder_view(builder),
+        codepoints + padding,
+        is_ascii && (padding == 0 || spec->fill.length == 1)
+    );
+}
+
+// Returns the length of `count` digits, once a separator is inserted between every group
+// of `group` of them.
+static int grouped_length(int count, int group) {
+    return count == 0 ? 0 : count + (count - 1) / group;
+}
+
+// Assembles a formatted number, which consists of the `sign`, the base `prefix`, the
+// `integer` part and the `rest` (the fractional part, exponent and suffix), and pads it to
+// the width of the spec. Digits of the integer part are separated into groups of `group`
+// if the spec asks for it - when numbers are padded with zeros, the zeros are grouped too.
+static pyobj_t* finish_number(
+    const format_spec_t* spec,
+    string_t sign,
+    string_t prefix,
+    string_t integer,
+    string_t rest,
+    int group
+) {
+    char head_buffer[4];
+    memcpy(head_buffer, sign.str, (size_t)sign.length);
+    memcpy(head_buffer + sign.length, prefix.str, (size_t)prefix.length);
+    string_t head = { .str = head_buffer, .length = sign.length + prefix.length };
+
+    if (spec->grouping == '\0' || group == 0) {
+        string_t body = std_strconcat(integer, rest);
+        return pad(spec, '>', head, body, head.length + body.length, true);
+    }
+
+    int digits = integer.length;
+    bool zero_padded = spec->align == '=' && std_strequ(spec->fill, STR("0"));
+    if (zero_padded) {
+        int min_length = spec->width - head.length - rest.length;
+        while (grouped_length(digits, group) < min_length) {
+            digits++;
+        }
+    }
+
+    strbuilder_t* builder = std_strbuilder_alloc((size_t)grouped_length(digits, group) + (size_t)rest.length);
+    for (int i = 0; i < digits; i++) {
+        if (i != 0 && (digits - i) % group == 0) {
+            append_char(builder, spec->grouping);
+        }
+
+        int index = i - (digits - integer.length);
+        append_char(builder, index < 0 ? '0' : integer.str[index]);
+    }
+
+    std_strbuilder_append(builder, rest);
+
+    string_t body = std_strbuilder_view(builder);
+    return pad(spec, '>', head, body, head.length + body.length, true);
+}
+
+// Returns the sign to display for a number, according to the spec.
+static string_t sign_of(bool negative, char sign) {
+    if (negative)
+        return STR("-");
+
+    if (sign == '+')
+        return STR("+");
+
+    return sign == ' ' ? STR(" ") : STR("");
+}
+
+// Returns the digits of the magnitude of the given `int` in base 2^`bits`, where `bits`
+// is 1, 3 or 4.
+static string_t int_digits_pow2(pyobj_t* x, int bits, bool upper) {
+    const char* alphabet = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+
+    uint64_t small;
+    const uint64_t* limbs;
+    size_t limb_count;
+
+    if (PY_INT_IS_SMALL(x)) {
+        small = x->as_int < 0 ? -(uint64_t)x->as_int : (uint64_t)x->as_int;
+        limbs = &small;
+        limb_count = small == 0 ? 0 : 1;
+    } else {
+        limbs = x->as_bigint->limbs;
+        limb_count = x->as_bigint->length;
+    }
+
+    if (limb_count == 0)
+        return STR("0");
+
+    size_t bit_length = limb_count * 64 - (size_t)__builtin_clzll(limbs[limb_count - 1]);
+    size_t count = (bit_length + (size_t)bits - 1) / (size_t)bits;
+    char* digits = mm_heap_alloc(count);
+
+    for (size_t i = 0; i < count; i++) {
+        size_t bit = i * (size_t)bits;
+        size_t limb = bit / 64;
+        size_t shift = bit % 64;
+
+        // Octal digits may span two limbs.
+        uint64_t value = limbs[limb] >> shift;
+        if (shift + (size_t)bits > 64 && limb + 1 < limb_count) {
+            value |= limbs[limb + 1] << (64 - shift);
+        }
+
+        digits[count - 1 - i] = alphabet[value & ((1u << bits) - 1)];
+    }
+
+    return (string_t) { .str = digits, .length = (int)count };
+}
+
+static pyreturn_t format_float(double x, const format_spec_t* spec);
+
+// Formats an `int` (or a `bool`) according to the given spec.
+static pyreturn_t format_int(pyobj_t* value, const format_spec_t* spec) {
+    switch (spec->type) {
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case '%': {
+            double x;
+            if (!py_int_to_double(value, &x))
+                RAISE(OverflowError, "int too large to convert to float");
+
+            return format_float(x, spec);
+        }
+    }
+
+    if (spec->precision >= 0)
+        RAISE(ValueError, "Precision not allowed in integer format specifier");
+
+    if (spec->coerce_zero)
+        RAISE(ValueError, "Negative zero coercion (z) not allowed in integer format specifier");
+
+    bool negative = PY_INT_IS_SMALL(value) ? value->as_int < 0 : value->as_bigint->negative;
+
+    if (spec->type == 'c') {
+        if (spec->sign != '\0')
+            RAISE(ValueError, "Sign not allowed with integer format specifier 'c'");
+
+        if (spec->alternate)
+            RAISE(ValueError, "Alternate form (#) not allowed with integer format specifier 'c'");
+
+        if (spec->grouping != '\0')
+            return WITH_EXCEPTION(FORMAT_ERROR(STR("Cannot specify '"), ((string_t) { .str = &spec->grouping, .length = 1 }), STR("' with 'c'.")));
+
+        if (!PY_INT_IS_SMALL(value) || value->as_int < 0 || value->as_int > 0x10FFFF)
+            RAISE(OverflowError, "%c arg not in range(0x110000)");
+
+        uint32_t c = (uint32_t)value->as_int;
+        char* encoded = mm_heap_alloc(4);
+        int length;
+
+        if (c < 0x80) {
+            encoded[0] = (char)c;
+            length = 1;
+        } else if (c < 0x800) {
+            encoded[0] = (char)(0xC0 | (c >> 6));
+            encoded[1] = (char)(0x80 | (c & 0x3F));
+            length = 2;
+        } else if (c < 0x10000) {
+            encoded[0] = (char)(0xE0 | (c >> 12));
+            encoded[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+            encoded[2] = (char)(0x80 | (c & 0x3F));
+            length = 3;
+        } else {
+            encoded[0] = (char)(0xF0 | (c >> 18));
+            encoded[1] = (char)(0x80 | ((c >> 12) & 0x3F));
+            encoded[2] = (char)(0x80 | ((c >> 6) & 0x3F));
+            encoded[3] = (char)(0x80 | (c & 0x3F));
+            length = 4;
+        }
+
+        string_t body = { .str = encoded, .length = length };
+        return WITH_RESULT(pad(spec, '>', STR(""), body, 1, c < 0x80));
+    }
+
+    int bits = 0;
+    string_t prefix = STR("");
+
+    switch (spec->type) {
+        case '\0':
+        case 'd':
+            break;
+        case 'n':
+            if (spec->grouping != '\0')
+                return WITH_EXCEPTION(FORMAT_ERROR(STR("Cannot specify '"), ((string_t) { .str = &spec->grouping, .length = 1 }), STR("' with 'n'.")));
+
+            break;
+        case 'b': bits = 1; prefix = STR("0b"); break;
+        case 'o': bits = 3; prefix = STR("0o"); break;
+        case 'x': bits = 4; prefix = STR("0x"); break;
+        case 'X': bits = 4; prefix = STR("0X"); break;
+        default:
+            return WITH_EXCEPTION(unknown_format_code(spec->type, STR("int")));
+    }
+
+    string_t digits;
+    int group = 3;
+
+    if (bits == 0) {
+        digits = py_int_to_decimal(value);
+        if (negative) {
+            digits.str++;
+            digits.length--;
+        }
+    } else {
+        if (spec->grouping == ',') {
+            return WITH_EXCEPTION(FORMAT_ERROR(
+                STR("Cannot specify ',' with '"), ((string_t) { .str = &spec->type, .length = 1 }), STR("'.")
+            ));
+        }
+
+        digits = int_digits_pow2(value, bits, spec->type == 'X');
+        group = 4;
+    }
+
+    return WITH_RESULT(finish_number(
+        spec,
+        sign_of(negative, spec->sign),
+        spec->alternate ? prefix : STR(""),
+        digits,
+        STR(""),
+        group
+    ));
+}
+
+// Writes `count` significant digits of the magnitude of `x` (which must be finite) into
+// `out_digits`, rounded half to even, and sets `out_decpt` so that the value is equal to
+// `0.digits * 10^decpt`.
+static void significant_digits(double x, int count, char** out_digits, int* out_decpt) {
+    if (x == 0) {
+        char* zeros = mm_heap_alloc((size_t)count);
+        memset(zeros, '0', (size_t)count);
+
+        *out_digits = zeros;
+        *out_decpt = 1;
+        return;
+    }
+
+    // The shortest representation is in the same decade as `x`, unless `x` lies right
+    // below a power of 10 - in which case we only need to try the next lower decade.
+    char shortest[STD_DOUBLE_MAX_DIGITS];
+    int exponent;
+    std_double_shortest(x, shortest, &exponent);
+    exponent--;
+
+    string_t digits;
+    while (true) {
+        digits = std_double_scaled_digits(x, count - 1 - exponent);
+
+        if (digits.length > count) {
+            exponent++;
+        } else if (digits.length < count) {
+            exponent--;
+        } else {
+            break;
+        }
+    }
+
+    *out_digits = (char*)digits.str;
+    *out_decpt = exponent + 1;
+}
+
+// Appends an exponent, e.g. "e+05" or "E-300".
+static void append_exponent(strbuilder_t* builder, int exponent, bool upper) {
+    append_char(builder, upper ? 'E' : 'e');
+    append_char(builder, exponent < 0 ? '-' : '+');
+
+    char buffer[STD_U64_MAX_DIGITS];
+    char* end = buffer + STD_U64_MAX_DIGITS;
+    char* start = std_u64_to_decimal((uint64_t)(exponent < 0 ? -exponent : exponent), end);
+
+    // Exponents have at least two digits.
+    if (end - start < 2) {
+        *--start = '0';
+    }
+
+    std_strbuilder_append(builder, (string_t) { .str = start, .length = (int)(end - start) });
+}
+
+// Splits the magnitude of a finite `float` into the integer part and the rest, for the
+// presentation types 'e', 'f', 'g' and 'r' (the one `repr` uses). The rest is appended
+// to `rest`. Returns `true` if all digits are zeros.
+static bool float_parts(
+    double x,
+    char type,
+    int precision,
+    bool alternate,
+    bool add_dot_0,
+    bool upper,
+    string_t* out_integer,
+    strbuilder_t* rest
+) {
+    if (type == 'f') {
+        string_t scaled = std_double_scaled_digits(x, precision);
+        int integer_length = scaled.length - precision;
+
+        if (precision > 0 || alternate) {
+            append_char(rest, '.');
+        }
+
+        if (integer_length <= 0) {
+            *out_integer = STR("0");
+            append_repeated(rest, STR("0"), -integer_length);
+            std_strbuilder_append(rest, scaled);
+        } else {
+            *out_integer = (string_t) { .str = scaled.str, .length = integer_length };
+            std_strbuilder_append(rest, (string_t) { .str = scaled.str + integer_length, .length = precision });
+        }
+
+        return scaled.length == 1 && scaled.str[0] == '0';
+    }
+
+    char shortest[STD_DOUBLE_MAX_DIGITS];
+    char* digits;
+    int count, decpt;
+    bool use_exponent;
+
+    if (type == 'r') {
+        digits = shortest;
+        count = std_double_shortest(x, shortest, &decpt);
+        use_exponent = decpt <= -4 || decpt > 16;
+    }
+    else if (type == 'e') {
+        count = precision + 1;
+        significant_digits(x, count, &digits, &decpt);
+        use_exponent = true;
+    }
+    else {
+        int significant = precision == 0 ? 1 : precision;
+        significant_digits(x, significant, &digits, &decpt);
+
+        count = significant;
+        if (!alternate) {
+            while (count > 1 && digits[count - 1] == '0') {
+                count--;
+            }
+        }
+
+        // Without a presentation type, numbers that would be displayed as an integer
+        // switch to the exponent notation one digit earlier, as we add a ".0" to them.
+        use_exponent = decpt <= -4 || decpt > (add_dot_0 ? significant - 1 : significant);
+    }
+
+    if (use_exponent) {
+        *out_integer = (string_t) { .str = digits, .length = 1 };
+
+        if (count > 1 || alternate) {
+            append_char(rest, '.');
+            std_strbuilder_append(rest, (string_t) { .str = digits + 1, .length = count - 1 });
+        }
+
+        append_exponent(rest, decpt - 1, upper);
+    }
+    else if (decpt <= 0) {
+        *out_integer = STR("0");
+        append_char(rest, '.');
+        append_repeated(rest, STR("0"), -decpt);
+        std_strbuilder_append(rest, (string_t) { .str = digits, .length = count });
+    }
+    else if (decpt >= count) {
+        strbuilder_t* integer = std_strbuilder_alloc((size_t)decpt);
+        std_strbuilder_append(integer, (string_t) { .str = digits, .length = count });
+        append_repeated(integer, STR("0"), decpt - count);
+        *out_integer = std_strbuilder_view(integer);
+
+        if (add_dot_0) {
+            std_strbuilder_append(rest, STR(".0"));
+        } else if (alternate) {
+            append_char(rest, '.');
+        }
+    }
+    else {
+        *out_integer = (string_t) { .str = digits, .length = decpt };
+        append_char(rest, '.');
+        std_strbuilder_append(rest, (string_t) { .str = digits + decpt, .length = count - decpt });
+    }
+
+    // `out_integer` might point to `shortest`, which lives on our stack.
+    if (digits == shortest) {
+        char* copy = mm_heap_alloc((size_t)out_integer->length);
+        memcpy(copy, out_integer->str, (size_t)out_integer->length);
+        out_integer->str = copy;
+    }
+
+    return x == 0;
+}
+
+// Formats a `float` according to the given spec.
+static pyreturn_t format_float(double x, const format_spec_t* spec) {
+    char type = spec->type;
+    int precision = spec->precision;
+    bool add_dot_0 = false;
+    bool percent = false;
+
+    switch (type) {
+        case '\0':
+            // Without a type, floats are formatted like `repr(x)`, or like 'g' (but always
+            // with a decimal point) if a precision is given.
+            add_dot_0 = true;
+            type = precision < 0 ? 'r' : 'g';
+            break;
+        case 'n':
+            if (spec->grouping != '\0')
+                return WITH_EXCEPTION(FORMAT_ERROR(STR("Cannot specify '"), ((string_t) { .str = &spec->grouping, .length = 1 }), STR("' with 'n'.")));
+
+            type = 'g';
+            break;
+        case '%':
+            type = 'f';
+            x *= 100;
+            percent = true;
+            break;
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G':
+            break;
+        default:
+            return WITH_EXCEPTION(unknown_format_code(type, STR("float")));
+    }
+
+    if (precision < 0) {
+        precision = 6;
+    }
+
+    bool upper = type == 'E' || type == 'F' || type == 'G';
+    type = upper ? (char)(type - 'A' + 'a') : type;
+
+    // The sign of NaNs is never displayed.
+    bool negative = __builtin_signbit(x) && !__builtin_isnan(x);
+    x = __builtin_fabs(x);
+
+    string_t integer;
+    strbuilder_t* rest = std_strbuilder_alloc(32);
+    int group = 3;
+
+    if (__builtin_isnan(x) || __builtin_isinf(x)) {
+        if (__builtin_isnan(x)) {
+            integer = upper ? STR("NAN") : STR("nan");
+        } else {
+            integer = upper ? STR("INF") : STR("inf");
+        }
+
+        group = 0;
+    }
+    else {
+        bool is_zero = float_parts(x, type, precision, spec->alternate, add_dot_0, upper, &integer, rest);
+
+        // The "z" option applies after rounding, e.g. `format(-0.001, "z.1f")` is "0.0".
+        if (is_zero && spec->coerce_zero) {
+            negative = false;
+        }
+    }
+
+    if (percent) {
+        append_char(rest, '%');
+    }
+
+    return WITH_RESULT(finish_number(
+        spec,
+        sign_of(negative, spec->sign),
+        STR(""),
+        integer,
+        std_strbuilder_view(rest),
+        group
+    ));
+}
+
+// Formats a `str` according to the given spec.
+static pyreturn_t format_str(pyobj_t* value, const format_spec_t* spec) {
+    if (spec->type != '\0' && spec->type != 's')
+        return WITH_EXCEPTION(unknown_format_code(spec->type, STR("str")));
+
+    if (spec->sign != '\0')
+        RAISE(ValueError, "Sign not allowed in string format specifier");
+
+    if (spec->coerce_zero)
+        RAISE(ValueError, "Negative zero coercion (z) not allowed in string format specifier");
+
+    if (spec->alternate)
+        RAISE(ValueError, "Alternate form (#) not allowed in string format specifier");
+
+    if (spec->align == '=')
+        RAISE(ValueError, "'=' alignment not allowed in string format specifier");
+
+    if (spec->grouping != '\0')
+        return WITH_EXCEPTION(FORMAT_ERROR(STR("Cannot specify '"), ((string_t) { .str = &spec->grouping, .length = 1 }), STR("' with 's'.")));
+
+    string_t body = value->as_str;
+    int codepoints = py_str_length(value);
+
+    // The precision truncates strings to that many code points.
+    if (spec->precision >= 0 && spec->precision < codepoints) {
+        body.length = py_str_offset(value, spec->precision);
+        codepoints = spec->precision;
+    }
+
+    if (spec->width <= codepoints && body.length == value->as_str.length)
+        return WITH_RESULT(value);
+
+    return WITH_RESULT(pad(spec, '<', STR(""), body, codepoints, py_str_is_ascii(value)));
+}
+
+string_t py_float_to_decimal(double x) {
+    if (__builtin_isnan(x))
+        return STR("nan");
+
+    if (__builtin_isinf(x))
+        return x < 0 ? STR("-inf") : STR("inf");
+
+    string_t integer;
+    strbuilder_t* rest = std_strbuilder_alloc(24);
+    float_parts(__builtin_fabs(x), 'r', 0, false, true, false, &integer, rest);
+
+    string_t sign = __builtin_signbit(x) ? STR("-") : STR("");
+    return std_strconcat(sign, integer, std_strbuilder_view(rest));
+}
+
+pyreturn_t py_format_builtin(pyobj_t* value, string_t spec) {
+    ENSURE_NOT_NULL(value);
+
+    format_spec_t parsed;
+    pyobj_t* exception;
+
+    if (value->type == &py_type_str) {
+        if (spec.length == 0)
+            return WITH_RESULT(value);
+
+        exception = parse_spec(spec, '<', STR("str"), &parsed);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return format_str(value, &parsed);
+    }
+
+    if (value->type == &py_type_float) {
+        if (spec.length == 0) {
+            string_t decimal = py_float_to_decimal(value->as_float);
+            return WITH_RESULT(py_alloc_str_analyzed(decimal, decimal.length, true));
+        }
+
+        exception = parse_spec(spec, '>', STR("float"), &parsed);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return format_float(value->as_float, &parsed);
+    }
+
+    // `bool`s are formatted as `int`s, unless the spec is empty.
+    if (value->type == &py_type_bool) {
+        if (spec.length == 0)
+            return WITH_RESULT(value->as_bool ? PY_STR("True") : PY_STR("False"));
+
+        value = py_alloc_int(value->as_bool ? 1 : 0);
+    }
+
+    ASSERT(value->type == &py_type_int);
+
+    if (spec.length == 0) {
+        string_t decimal = py_int_to_decimal(value);
+        return WITH_RESULT(py_alloc_str_analyzed(decimal, decimal.length, true));
+    }
+
+    exception = parse_spec(spec, '>', STR("int"), &parsed);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return format_int(value, &parsed);
+}
+
+pyreturn_t py_format(pyobj_t* value, pyobj_t* spec) {
+    ENSURE_NOT_NULL(value);
+    ENSURE_NOT_NULL(spec);
+
+    if (spec->type != &py_type_str)
+        RAISE(TypeError, "format() argument 2 must be str");
+
+    if (
+        value->type == &py_type_str || value->type == &py_type_int ||
+        value->type == &py_type_float || value->type == &py_type_bool
+    ) {
+        return py_format_builtin(value, spec->as_str);
+    }
+
+    pyobj_t* method_format;
+    bool is_unbound = py_get_method_attribute(value, STR("__format__"), &method_format);
+
+    if (method_format == NULL) {
+        if (spec->as_str.length != 0)
+            RAISE(TypeError, "unsupported format string passed to object.__format__");
+
+        return py_str_of(value);
+    }
+
+    pyobj_t* args[] = { spec };
+    pyobj_t* result = UNWRAP(py_call(method_format, 1, args, 0, NULL, is_unbound ? value : NULL));
+    if (NOT_NULL(result)->type != &py_type_str)
+        RAISE(TypeError, "__format__ must return a str");
+
+    return WITH_RESULT(result);
+}
+
+pyreturn_t py_format_simple(pyobj_t* value) {
+    if (NOT_NULL(value)->type == &py_type_str)
+        return WITH_RESULT(value);
+
+    static pyobj_t empty = PY_STR_LITERAL("");
+    return py_format(value, &empty);
+}
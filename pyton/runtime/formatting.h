@@ -0,0 +1,30 @@
+#pragma once
+
+#include "objects.h"
+#include "exceptions.h"
+
+// Conversions of numbers to text, and the format specification mini-language, i.e.
+// `format(value, spec)` and f-string replacement fields like `f"{x:>10,.2f}"`.
+//
+// `int`s, `bool`s, `float`s and `str`s are formatted natively, without going through their
+// `__format__` methods. `float`s are converted to the shortest string of digits that round
+// trips (like `repr(x)`) unless a precision is given, in which case they're rounded exactly,
+// like in CPython - see `std/numfmt.h`.
+
+// Converts the given `float` value to its shortest representation, like `repr(x)`, e.g.
+// `0.1`, `1e+16` or `-inf`.
+string_t py_float_to_decimal(double x);
+
+// Implements `value.__format__(spec)` for `int`s, `bool`s, `float`s and `str`s. Returns an
+// exception or the formatted `str`.
+pyreturn_t py_format_builtin(pyobj_t* value, string_t spec);
+
+// Implements `format(value, spec)`, where `spec` is expected to be a `str`. Objects other
+// than the ones `py_format_builtin` supports are formatted via their `__format__` method,
+// or with `str(value)` if they don't have one and `spec` is empty. Returns an exception or
+// the formatted `str`.
+pyreturn_t py_format(pyobj_t* value, pyobj_t* spec);
+
+// Implements `format(value)`, i.e. `format(value, "")`, which is what f-string replacement
+// fields without a format specification evaluate to. `str`s are returned as-is.
+pyreturn_t py_format_simple(pyobj_t* value);
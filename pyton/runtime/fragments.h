@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ints.h"
 #include "exceptions.h"
 
 // This header file specifies fragments used from transpiled code.
@@ -28,8 +29,35 @@
         return WITH_RESULT(&py_none);                                   \
     MODULE_INIT_STATE($name) = true;
 
-#define MARSHALLED_BOOL($x)   WITH_RESULT(($x) ? &py_true : &py_false)
-#define MARSHALLED_INT($x)    WITH_RESULT(py_alloc_int((int64_t)ret))
-#define MARSHALLED_FLOAT($x)  WITH_RESULT(py_alloc_float((double)ret))
-#define MARSHALLED_STR($x)    WITH_RESULT(py_alloc_str(ret))
+// The following marshal values between Python objects and the C types of the parameters
+// and return values of `@extern` functions. `IS_MARSHALLABLE_*` checks if an object can be
+// passed as a parameter of the given type, `UNMARSHAL_*` extracts the C value out of such
+// an object, and `MARSHAL_*` boxes a C return value. Only `int`s that fit in 64 bits are
+// marshallable as `int64_t`.
+
+#define IS_MARSHALLABLE_BOOL($x)   (($x)->type == &py_type_bool)
+#define IS_MARSHALLABLE_INT($x)    (($x)->type == &py_type_int && PY_INT_IS_SMALL($x))
+#define IS_MARSHALLABLE_FLOAT($x)  (($x)->type == &py_type_float)
+#define IS_MARSHALLABLE_STR($x)    (($x)->type == &py_type_str)
+#define IS_MARSHALLABLE_NONE($x)   (($x) == &py_none)
+#define IS_MARSHALLABLE_OBJ($x)    true
+
+#define UNMARSHAL_BOOL($x)   (($x)->as_bool)
+#define UNMARSHAL_INT($x)    (($x)->as_int)
+#define UNMARSHAL_FLOAT($x)  (($x)->as_float)
+#define UNMARSHAL_STR($x)    (($x)->as_str)
+#define UNMARSHAL_NONE($x)   ((void*)NULL)
+#define UNMARSHAL_OBJ($x)    ($x)
+
+#define MARSHAL_BOOL($x)   (($x) ? &py_true : &py_false)
+#define MARSHAL_INT($x)    py_alloc_int((int64_t)($x))
+#define MARSHAL_FLOAT($x)  py_alloc_float((double)($x))
+#define MARSHAL_STR($x)    py_alloc_str($x)
+#define MARSHAL_OBJ($x)    NOT_NULL($x)
+
+#define MARSHALLED_BOOL($x)   WITH_RESULT(MARSHAL_BOOL($x))
+#define MARSHALLED_INT($x)    WITH_RESULT(MARSHAL_INT($x))
+#define MARSHALLED_FLOAT($x)  WITH_RESULT(MARSHAL_FLOAT($x))
+#define MARSHALLED_STR($x)    WITH_RESULT(MARSHAL_STR($x))
+#define MARSHALLED_OBJ($x)    WITH_RESULT(MARSHAL_OBJ($x))
 
@@ -61,3 +61,25 @@
     if (argc_all < ($min_args)) {                                    \
         RAISE(TypeError, "not enough positional arguments");        \
     }
+
+// Raises an exception if any keyword arguments were provided (specified by variable
+// `kwargc`). Transpiled functions only accept positional arguments.
+#define PY_NO_KW_ARGS()                                             \
+    if (kwargc != 0) {                                              \
+        RAISE(TypeError, "keyword arguments are not yet supported"); \
+    }
+
+// Starts the definition of a variant of a transpiled function that always returns a
+// tuple of the same length. Instead of allocating the tuple, the variant stores its items
+// in `values`, returning `NULL` as its result. Callers that unpack the tuple right away
+// call the variant directly, while the regular function wraps over it (see
+// `PY_RETURN_VALUES_AS_TUPLE` in `opcodes.h`).
+#define PY_DEFINE_VALUES($name)           \
+    pyreturn_t $name (                    \
+        pyobj_t* self,                    \
+        int argc,                         \
+        pyobj_t** argv,                   \
+        int kwargc,                       \
+        symbol_t* kwargv,                 \
+        pyobj_t** values                  \
+    )
@@ -0,0 +1,185 @@
+#include "generators.h"
+
+#include "classes.h"
+#include "functions.h"
+#include "exceptions.h"
+#include "std/safety.h"
+#include "sys/mm.h"
+
+// Resumes the given generator or coroutine, sending `value` into it.
+static py_send_status_t generator_resume(pyobj_t* gen, pyobj_t* value, pyobj_t** out) {
+    py_frame_t* frame = gen->as_generator->frame;
+
+    switch (frame->state) {
+        case PY_FRAME_FINISHED:
+            // Resuming an exhausted generator behaves as if it returned `None` again.
+            *out = &py_none;
+            return PY_SEND_RETURNED;
+        case PY_FRAME_RUNNING:
+            *out = NEW_EXCEPTION_INLINE(ValueError, "generator already executing");
+            return PY_SEND_RAISED;
+        case PY_FRAME_CREATED:
+            if (value != &py_none) {
+                *out = NEW_EXCEPTION_INLINE(TypeError, "can't send non-None value to a just-started generator");
+                return PY_SEND_RAISED;
+            }
+            break;
+        case PY_FRAME_SUSPENDED:
+            break;
+    }
+
+    frame->state = PY_FRAME_RUNNING;
+    pyreturn_t result = gen->as_generator->body(frame, value);
+
+    if (result.exception != NULL) {
+        frame->state = PY_FRAME_FINISHED;
+        *out = result.exception;
+        return PY_SEND_RAISED;
+    }
+
+    *out = result.value;
+
+    // The body marks the frame as suspended when it yields, and as finished
+    // when it returns.
+    return frame->state == PY_FRAME_FINISHED ? PY_SEND_RETURNED : PY_SEND_YIELDED;
+}
+
+// Implements `__next__` and `send` for both generators and coroutines.
+static pyreturn_t generator_next(pyobj_t* self, pyobj_t* value) {
+    pyobj_t* out;
+    switch (generator_resume(self, value, &out)) {
+        case PY_SEND_YIELDED:
+            return WITH_RESULT(out);
+        case PY_SEND_RETURNED:
+            return WITH_EXCEPTION(NEW_EXCEPTION(&py_type_StopIteration, out));
+        case PY_SEND_RAISED:
+            return WITH_EXCEPTION(out);
+    }
+
+    sys_panic("Invalid send status.");
+}
+
+CLASS(generator)
+    // def __iter__(self):
+    CLASS_METHOD(generator, __iter__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_generator);
+        return WITH_RESULT(self);
+    };
+
+    // def __next__(self):
+    CLASS_METHOD(generator, __next__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_generator);
+        return generator_next(self, &py_none);
+    };
+
+    // def send(self, value):
+    CLASS_METHOD(generator, send) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_generator);
+
+        if (argc != 1)
+            RAISE(TypeError, "generator.send() takes exactly one argument");
+
+        return generator_next(self, NOT_NULL(argv)[0]);
+    };
+
+    CLASS_ATTRIBUTES(generator)
+        HAS_CLASS_METHOD(generator, __iter__),
+        HAS_CLASS_METHOD(generator, __next__),
+        HAS_CLASS_METHOD(generator, send)
+    END_CLASS_ATTRIBUTES;
+DEFINE_INTRINSIC_TYPE(generator);
+
+CLASS(coroutine)
+    // def __await__(self):
+    CLASS_METHOD(coroutine, __await__) {
+        // Coroutines are resumed directly by `SEND`, so they act as their own iterators.
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_coroutine);
+        return WITH_RESULT(self);
+    };
+
+    // def send(self, value):
+    CLASS_METHOD(coroutine, send) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_coroutine);
+
+        if (argc != 1)
+            RAISE(TypeError, "coroutine.send() takes exactly one argument");
+
+        return generator_next(self, NOT_NULL(argv)[0]);
+    };
+
+    CLASS_ATTRIBUTES(coroutine)
+        HAS_CLASS_METHOD(coroutine, __await__),
+        HAS_CLASS_METHOD(coroutine, send)
+    END_CLASS_ATTRIBUTES;
+DEFINE_INTRINSIC_TYPE(coroutine);
+
+py_frame_t* py_alloc_frame(int stack_size, int locals_count) {
+    ASSERT(stack_size > 0);
+    ASSERT(locals_count >= 0);
+
+    py_frame_t* frame = mm_heap_alloc(sizeof(py_frame_t));
+    frame->stack = mm_heap_alloc(stack_size * sizeof(void*));
+    frame->stack_current = -1;
+    frame->locals = locals_count == 0 ? NULL : mm_heap_alloc(locals_count * sizeof(pyobj_t*));
+    frame->caught_exception = NULL;
+    frame->resume_point = NULL;
+    frame->state = PY_FRAME_CREATED;
+
+    for (int i = 0; i < locals_count; i++) {
+        frame->locals[i] = NULL;
+    }
+
+    return frame;
+}
+
+pyobj_t* py_alloc_generator(py_frame_t* frame, py_fnptr_resumable_t body, bool is_coroutine) {
+    generator_data_t* data = mm_heap_alloc(sizeof(generator_data_t));
+    data->frame = NOT_NULL(frame);
+    data->body = NOT_NULL(body);
+
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = is_coroutine ? &py_type_coroutine : &py_type_generator;
+    obj->as_generator = data;
+    return obj;
+}
+
+py_send_status_t py_send(pyobj_t* receiver, pyobj_t* value, pyobj_t** out) {
+    ENSURE_NOT_NULL(receiver);
+    ENSURE_NOT_NULL(value);
+    ENSURE_NOT_NULL(out);
+
+    if (receiver->type == &py_type_generator || receiver->type == &py_type_coroutine)
+        return generator_resume(receiver, value, out);
+
+    // An arbitrary iterator - we go through its methods, and translate StopIteration
+    // into a return.
+    pyobj_t* method;
+    string_t name = value == &py_none ? STR("__next__") : STR("send");
+
+    if (!py_get_method_attribute(receiver, name, &method) || method == NULL) {
+        *out = NEW_EXCEPTION_INLINE(TypeError, "object cannot be resumed (no __next__ or send method)");
+        return PY_SEND_RAISED;
+    }
+
+    pyreturn_t result = value == &py_none
+        ? py_call(method, 0, NULL, 0, NULL, receiver)
+        : py_call(method, 1, &value, 0, NULL, receiver);
+
+    if (result.exception == NULL) {
+        *out = result.value;
+        return PY_SEND_YIELDED;
+    }
+
+    if (py_isinstance(result.exception, &py_type_StopIteration)) {
+        *out = COALESCE_2(py_get_attribute(result.exception, STR("value")), &py_none);
+        return PY_SEND_RETURNED;
+    }
+
+    *out = result.exception;
+    return PY_SEND_RAISED;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "objects.h"
+#include "symbols.h"
+#include "exceptions.h"
+
+// Generators and coroutines are both implemented via resumable frames. A resumable function
+// is transpiled into two C functions:
+//      - a regular `PY_DEFINE` function, which binds the arguments to a freshly allocated
+//        frame, and returns a `generator` or `coroutine` object that owns it,
+//      - a `PY_DEFINE_RESUMABLE` function, which holds the actual body. Its value stack and
+//        locals live in the frame instead of the C stack, and every `yield` records the
+//        address of a label to jump to when the frame is resumed.
+
+// Represents the lifecycle of a resumable frame.
+typedef enum py_frame_state {
+    PY_FRAME_CREATED,       // the body hasn't started executing yet
+    PY_FRAME_SUSPENDED,     // the body yielded a value, and is waiting to be resumed
+    PY_FRAME_RUNNING,       // the body is currently executing
+    PY_FRAME_FINISHED       // the body returned or raised an exception
+} py_frame_state_t;
+
+// Represents the execution state of a resumable function.
+typedef struct py_frame {
+    // The value stack of the function.
+    void** stack;
+
+    // The index of the stack slot that will be popped next.
+    int stack_current;
+
+    // The local variables of the function, indexed by their position in `co_varnames`.
+    pyobj_t** locals;
+
+    // The exception currently being handled.
+    pyobj_t* caught_exception;
+
+    // The address of the label to jump to when the frame is resumed. `NULL` when
+    // the function hasn't been started yet.
+    void* resume_point;
+
+    py_frame_state_t state;
+} py_frame_t;
+
+// Represents a pointer to the body of a resumable function. `sent` is the value that
+// the `yield` expression the frame was suspended on evaluates to.
+typedef pyreturn_t (*py_fnptr_resumable_t)(py_frame_t* frame, pyobj_t* sent);
+
+// The data held by `generator` and `coroutine` objects.
+typedef struct generator_data {
+    py_frame_t* frame;
+    py_fnptr_resumable_t body;
+} generator_data_t;
+
+// The outcome of sending a value into a generator, coroutine, or an arbitrary iterator.
+typedef enum py_send_status {
+    PY_SEND_YIELDED,        // the receiver yielded a value
+    PY_SEND_RETURNED,       // the receiver finished, returning a value
+    PY_SEND_RAISED          // the receiver raised an exception
+} py_send_status_t;
+
+// Starts the definition of the body of a resumable function. See the top of this file
+// for more details.
+#define PY_DEFINE_RESUMABLE($name)      \
+    pyreturn_t $name (                  \
+        py_frame_t* frame,              \
+        pyobj_t* sent                   \
+    )
+
+// The type that represents generator objects, created by calling a function that
+// contains a `yield` expression.
+extern pyobj_t py_type_generator;
+
+// The type that represents coroutine objects, created by calling an `async def` function.
+extern pyobj_t py_type_coroutine;
+
+// Allocates a frame for a resumable function, with the given stack and locals capacity.
+// All locals start out as `NULL` (unbound).
+py_frame_t* py_alloc_frame(int stack_size, int locals_count);
+
+// Creates a `generator` (or, if `is_coroutine` is `true`, a `coroutine`) object that will
+// execute `body` over `frame`.
+pyobj_t* py_alloc_generator(py_frame_t* frame, py_fnptr_resumable_t body, bool is_coroutine);
+
+// Sends `value` into `receiver`, resuming it. Generators and coroutines are resumed
+// directly; other objects have their `send` method called, or `__next__` if `value` is
+// `None`. Depending on the returned status, `out` will be set to the yielded value,
+// the returned value, or the raised exception.
+py_send_status_t py_send(pyobj_t* receiver, pyobj_t* value, pyobj_t** out);
@@ -1,16 +1,56 @@
 #include "init.h"
 
 #include "sys/mm.h"
+#include "sys/cpu.h"
+#include "sys/core.h"
+#include "sys/clock.h"
+#include "sys/timer.h"
 #include "sys/terminal.h"
+#include "sys/interrupts.h"
+#include "std/numfmt.h"
 
 static pyobj_t py_str_main_name = PY_STR_LITERAL("__name__");
 pyobj_t* KNOWN_GLOBAL(__name__) = &py_str_main_name;
 
+// Prints the source of the monotonic clock, along with the calibrated frequency of the
+// time-stamp counter, in MHz with three decimal places.
+static void print_clock_info(void) {
+    clock_info_t clock = clock_get_info();
+
+    char mhz_buffer[STD_U64_MAX_DIGITS];
+    char* mhz_end = mhz_buffer + STD_U64_MAX_DIGITS;
+    char* mhz = std_u64_to_decimal(clock.tsc_frequency / 1000000, mhz_end);
+
+    uint64_t khz = clock.tsc_frequency / 1000 % 1000;
+    char khz_digits[3] = { (char)('0' + khz / 100), (char)('0' + khz / 10 % 10), (char)('0' + khz % 10) };
+
+    string_t line = clock.source == CLOCK_SOURCE_TSC
+        ? std_strconcat(
+            STR("Clock: TSC at "),
+            (string_t) { .str = mhz, .length = (int)(mhz_end - mhz) },
+            STR("."),
+            (string_t) { .str = khz_digits, .length = 3 },
+            STR(" MHz, calibrated against the PIT"),
+            clock.invariant ? STR("") : STR(" (not invariant)")
+        )
+        : STR("Clock: PIT, no time-stamp counter available");
+
+    terminal_write(line.str, (size_t)line.length);
+    terminal_newline();
+}
+
 void sys_init(void) {
+    cpu_init();
     mm_init();
     terminal_init();
+    int_init();
+    clock_init();
+    timer_init();
+    terminal_enable_interrupts();
+    int_enable();
 
     terminal_println("Pyton 0.0.1 on bare metal");
+    print_clock_info();
     terminal_println("All systems nominal");
 }
 
@@ -18,11 +58,13 @@ void sys_handle_main_return(pyreturn_t result) {
     if (result.exception != NULL) {
         // Oops, the script finished running with an exception...
         terminal_println("An uncaught exception was encountered.");
-        terminal_println(py_stringify(result.exception).str);
+        string_t message = py_stringify(result.exception);
+        terminal_write(message.str, (size_t)message.length);
+        terminal_newline();
     }
     else {
         terminal_println("(script finished running, hanging)");
     }
 
-    while (true) {}
+    sys_halt();
 }
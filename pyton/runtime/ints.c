@@ -0,0 +1,626 @@
+#include "ints.h"
+
+#include "floats.h"
+#include "std/numfmt.h"
+#include "std/safety.h"
+#include "sys/mm.h"
+
+// Returns the value of the `int` object `$x` as a big integer.
+#define BIG($x) py_int_to_bigint($x)
+
+// Evaluates to `true` if both `int` objects hold their values inline.
+#define BOTH_SMALL($a, $b) (PY_INT_IS_SMALL($a) && PY_INT_IS_SMALL($b))
+
+// Evaluates to `true` if the given `int` object is equal to zero. Big integers are
+// never zero, as zero fits in `as_int`.
+#define IS_ZERO($x) (PY_INT_IS_SMALL($x) && ($x)->as_int == 0)
+
+pyobj_t* py_alloc_bigint(bigint_t* x) {
+    ENSURE_NOT_NULL(x);
+
+    int64_t small;
+    if (std_bigint_to_i64(x, &small))
+        return py_alloc_int(small);
+
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = &py_type_int;
+    obj->as_int = 0;
+    obj->as_bigint = x;
+    return obj;
+}
+
+bigint_t* py_int_to_bigint(const pyobj_t* x) {
+    ENSURE_NOT_NULL(x);
+    ASSERT(x->type == &py_type_int);
+
+    return x->as_bigint != NULL ? x->as_bigint : std_bigint_from_i64(x->as_int);
+}
+
+pyreturn_t py_int_add(pyobj_t* a, pyobj_t* b) {
+    int64_t result;
+    if (BOTH_SMALL(a, b) && !__builtin_add_overflow(a->as_int, b->as_int, &result))
+        return WITH_RESULT(py_alloc_int(result));
+
+    return WITH_RESULT(py_alloc_bigint(std_bigint_add(BIG(a), BIG(b))));
+}
+
+pyreturn_t py_int_sub(pyobj_t* a, pyobj_t* b) {
+    int64_t result;
+    if (BOTH_SMALL(a, b) && !__builtin_sub_overflow(a->as_int, b->as_int, &result))
+        return WITH_RESULT(py_alloc_int(result));
+
+    return WITH_RESULT(py_alloc_bigint(std_bigint_sub(BIG(a), BIG(b))));
+}
+
+pyreturn_t py_int_mul(pyobj_t* a, pyobj_t* b) {
+    int64_t result;
+    if (BOTH_SMALL(a, b) && !__builtin_mul_overflow(a->as_int, b->as_int, &result))
+        return WITH_RESULT(py_alloc_int(result));
+
+    return WITH_RESULT(py_alloc_bigint(std_bigint_mul(BIG(a), BIG(b))));
+}
+
+pyreturn_t py_int_floordiv(pyobj_t* a, pyobj_t* b) {
+    if (IS_ZERO(b))
+        RAISE(ZeroDivisionError, "integer division or modulo by zero");
+
+    // INT64_MIN // -1 is the only quotient of two 64-bit values that overflows.
+    if (BOTH_SMALL(a, b) && !(a->as_int == INT64_MIN && b->as_int == -1)) {
+        int64_t q = a->as_int / b->as_int;
+
+        // C division truncates, while Python's rounds towards negative infinity.
+        if ((a->as_int % b->as_int != 0) && ((a->as_int < 0) != (b->as_int < 0))) {
+            q--;
+        }
+
+        return WITH_RESULT(py_alloc_int(q));
+    }
+
+    bigint_t* q;
+    std_bigint_divmod(BIG(a), BIG(b), &q, NULL);
+    return WITH_RESULT(py_alloc_bigint(q));
+}
+
+pyreturn_t py_int_mod(pyobj_t* a, pyobj_t* b) {
+    if (IS_ZERO(b))
+        RAISE(ZeroDivisionError, "integer division or modulo by zero");
+
+    if (BOTH_SMALL(a, b)) {
+        if (b->as_int == -1)
+            return WITH_RESULT(py_alloc_int(0)); // avoids INT64_MIN % -1
+
+        int64_t r = a->as_int % b->as_int;
+        if (r != 0 && ((r < 0) != (b->as_int < 0))) {
+            r += b->as_int;
+        }
+
+        return WITH_RESULT(py_alloc_int(r));
+    }
+
+    bigint_t* r;
+    std_bigint_divmod(BIG(a), BIG(b), NULL, &r);
+    return WITH_RESULT(py_alloc_bigint(r));
+}
+
+// Reinterprets the bits of a `double` as an integer, and vice versa.
+typedef union double_bits {
+    double value;
+    uint64_t bits;
+} double_bits_t;
+
+// Returns x * 2^n, for -1130 < n < 1024. The scaling is done in two steps, so that neither
+// of the factors overflows or underflows - only the final product can be rounded.
+static double scale_by_power_of_two(double x, int n) {
+    int half = n / 2;
+    double_bits_t first = { .bits = (uint64_t)(half + 1023) << 52 };
+    double_bits_t second = { .bits = (uint64_t)(n - half + 1023) << 52 };
+    return x * first.value * second.value;
+}
+
+pyreturn_t py_int_truediv(pyobj_t* a, pyobj_t* b) {
+    if (IS_ZERO(b))
+        RAISE(ZeroDivisionError, "division by zero");
+
+    // Integers of up to 53 bits convert to doubles exactly, and the division then rounds
+    // the quotient only once.
+    const int64_t exact_limit = 1ll << 53;
+    if (
+        BOTH_SMALL(a, b) &&
+        a->as_int >= -exact_limit && a->as_int <= exact_limit &&
+        b->as_int >= -exact_limit && b->as_int <= exact_limit
+    ) {
+        return WITH_RESULT(py_alloc_float((double)a->as_int / (double)b->as_int));
+    }
+
+    bigint_t* x = BIG(a);
+    bigint_t* y = BIG(b);
+    bool negative = x->negative != y->negative;
+    double zero = negative ? -0.0 : 0.0;
+
+    if (IS_ZERO(a))
+        return WITH_RESULT(py_alloc_float(zero));
+
+    if (x->negative) {
+        x = std_bigint_neg(x);
+    }
+
+    if (y->negative) {
+        y = std_bigint_neg(y);
+    }
+
+    // Like CPython, we scale x by a power of two so that the integer quotient has two or
+    // three bits more than the precision of the result (53 bits, or less for subnormals),
+    // round those away once, and then scale back.
+    int64_t diff = (int64_t)std_bigint_bit_length(x) - (int64_t)std_bigint_bit_length(y);
+    if (diff > 1024)
+        RAISE(OverflowError, "integer division result too large for a float");
+
+    if (diff < -1021 - 53 - 1)
+        return WITH_RESULT(py_alloc_float(zero));
+
+    int64_t shift = (diff > -1021 ? diff : -1021) - 53 - 2;
+    bool inexact = false;
+
+    if (shift <= 0) {
+        x = std_bigint_lshift(x, (size_t)-shift);
+    }
+    else {
+        bigint_t* truncated = std_bigint_rshift(x, (size_t)shift);
+        inexact = std_bigint_compare(std_bigint_lshift(truncated, (size_t)shift), x) != 0;
+        x = truncated;
+    }
+
+    bigint_t* q;
+    bigint_t* r;
+    std_bigint_divmod(x, y, &q, &r);
+    inexact |= r->length != 0;
+
+    // The quotient has at most 57 bits, which is a single limb.
+    uint64_t quotient = q->length == 0 ? 0 : q->limbs[0];
+    int64_t bits = quotient == 0 ? 0 : 64 - __builtin_clzll(quotient);
+    int64_t extra_bits = (bits > -1021 - shift ? bits : -1021 - shift) - 53;
+
+    // Round half to even, where any bits lost above count towards the lower half.
+    uint64_t half = 1ull << (extra_bits - 1);
+    quotient |= inexact;
+    if ((quotient & half) && (quotient & (3 * half - 1))) {
+        quotient += half;
+    }
+
+    quotient &= ~(2 * half - 1);
+
+    double result = scale_by_power_of_two((double)quotient, (int)shift);
+    if (__builtin_isinf(result))
+        RAISE(OverflowError, "integer division result too large for a float");
+
+    return WITH_RESULT(py_alloc_float(negative ? -result : result));
+}
+
+pyreturn_t py_int_pow(pyobj_t* a, pyobj_t* b) {
+    if (!PY_INT_IS_SMALL(b) ? b->as_bigint->negative : b->as_int < 0) {
+        // Negative exponents result in a `float`, exactly like `float(a) ** float(b)`.
+        double x, y;
+        if (!py_int_to_double(a, &x) || !py_int_to_double(b, &y))
+            RAISE(OverflowError, "int too large to convert to float");
+
+        double result;
+        pyobj_t* exception = py_float_pow(x, y, &result);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(py_alloc_float(result));
+    }
+
+    if (!PY_INT_IS_SMALL(b)) {
+        // We can only ever compute this if the result stays small.
+        if (PY_INT_IS_SMALL(a) && (a->as_int == 0 || a->as_int == 1))
+            return WITH_RESULT(a);
+
+        if (PY_INT_IS_SMALL(a) && a->as_int == -1)
+            return WITH_RESULT(py_alloc_int((b->as_bigint->limbs[0] & 1) ? -1 : 1));
+
+        RAISE(OverflowError, "exponent too large");
+    }
+
+    uint64_t exp = (uint64_t)b->as_int;
+
+    if (PY_INT_IS_SMALL(a)) {
+        // Exponentiation by squaring, as long as nothing overflows.
+        int64_t result = 1;
+        int64_t square = a->as_int;
+        uint64_t e = exp;
+        bool overflow = false;
+
+        while (e != 0 && !overflow) {
+            if (e & 1) {
+                overflow |= __builtin_mul_overflow(result, square, &result);
+            }
+
+            e >>= 1;
+            if (e != 0) {
+                overflow |= __builtin_mul_overflow(square, square, &square);
+            }
+        }
+
+        if (!overflow)
+            return WITH_RESULT(py_alloc_int(result));
+    }
+
+    return WITH_RESULT(py_alloc_bigint(std_bigint_pow(BIG(a), exp)));
+}
+
+// The word-sized counterpart of `std_bigint_invmod`, for a positive `m`. Returns -1 if `x`
+// has no inverse modulo `m`. The coefficients of the extended Euclidean algorithm never
+// exceed `m` in magnitude, so nothing here overflows.
+static int64_t invmod_i64(int64_t x, int64_t m) {
+    int64_t old_r = x % m;
+    if (old_r < 0) {
+        old_r += m;
+    }
+
+    int64_t r = m;
+    int64_t old_s = 1;
+    int64_t s = 0;
+
+    while (r != 0) {
+        int64_t q = old_r / r;
+        int64_t next_r = old_r - q * r;
+        int64_t next_s = old_s - q * s;
+        old_r = r;
+        r = next_r;
+        old_s = s;
+        s = next_s;
+    }
+
+    if (old_r != 1)
+        return -1;
+
+    return old_s < 0 ? old_s + m : old_s % m;
+}
+
+pyreturn_t py_int_powmod(pyobj_t* base, pyobj_t* exp, pyobj_t* mod) {
+    if (IS_ZERO(mod))
+        RAISE(ValueError, "pow() 3rd argument cannot be 0");
+
+    if (!PY_INT_IS_SMALL(exp) ? exp->as_bigint->negative : exp->as_int < 0) {
+        // pow(base, -exp, mod) == pow(inverse of base, exp, mod)
+        if (BOTH_SMALL(base, mod) && mod->as_int != INT64_MIN) {
+            int64_t inverse = invmod_i64(base->as_int, mod->as_int < 0 ? -mod->as_int : mod->as_int);
+            if (inverse < 0)
+                RAISE(ValueError, "base is not invertible for the given modulus");
+
+            base = py_alloc_int(inverse);
+        }
+        else {
+            bigint_t* m = BIG(mod);
+            if (m->negative) {
+                m = std_bigint_neg(m);
+            }
+
+            bigint_t* inverse = std_bigint_invmod(BIG(base), m);
+            if (inverse == NULL)
+                RAISE(ValueError, "base is not invertible for the given modulus");
+
+            base = py_alloc_bigint(inverse);
+        }
+
+        exp = py_int_neg(exp);
+    }
+
+    if (PY_INT_IS_SMALL(base) && PY_INT_IS_SMALL(exp) && PY_INT_IS_SMALL(mod)) {
+        // Everything fits in a word - we can keep all intermediate values below the
+        // modulus, and multiply them without overflowing via a 128-bit product.
+        uint64_t m = mod->as_int < 0 ? -(uint64_t)mod->as_int : (uint64_t)mod->as_int;
+        uint64_t b = base->as_int < 0
+            ? (m - (-(uint64_t)base->as_int % m)) % m
+            : (uint64_t)base->as_int % m;
+
+        uint64_t result = 1 % m;
+        for (uint64_t e = (uint64_t)exp->as_int; e != 0; e >>= 1) {
+            if (e & 1) {
+                result = std_mulmod_u64(result, b, m);
+            }
+
+            b = std_mulmod_u64(b, b, m);
+        }
+
+        // The result needs to have the same sign as the modulus.
+        if (mod->as_int < 0 && result != 0)
+            return WITH_RESULT(py_alloc_int((int64_t)(result - m)));
+
+        return WITH_RESULT(py_alloc_int((int64_t)result));
+    }
+
+    return WITH_RESULT(py_alloc_bigint(std_bigint_powmod(BIG(base), BIG(exp), BIG(mod))));
+}
+
+pyreturn_t py_int_lshift(pyobj_t* a, pyobj_t* b) {
+    if (!PY_INT_IS_SMALL(b) ? b->as_bigint->negative : b->as_int < 0)
+        RAISE(ValueError, "negative shift count");
+
+    if (IS_ZERO(a))
+        return WITH_RESULT(a);
+
+    if (!PY_INT_IS_SMALL(b))
+        RAISE(OverflowError, "too many digits in integer");
+
+    int64_t shift = b->as_int;
+
+    if (PY_INT_IS_SMALL(a) && shift < 63) {
+        int64_t result = (int64_t)((uint64_t)a->as_int << shift);
+
+        // If shifting back yields the same value, no bits were lost.
+        if ((result >> shift) == a->as_int)
+            return WITH_RESULT(py_alloc_int(result));
+    }
+
+    return WITH_RESULT(py_alloc_bigint(std_bigint_lshift(BIG(a), (size_t)shift)));
+}
+
+pyreturn_t py_int_rshift(pyobj_t* a, pyobj_t* b) {
+    if (!PY_INT_IS_SMALL(b) ? b->as_bigint->negative : b->as_int < 0)
+        RAISE(ValueError, "negative shift count");
+
+    bool negative = PY_INT_IS_SMALL(a) ? a->as_int < 0 : a->as_bigint->negative;
+
+    if (!PY_INT_IS_SMALL(b))
+        return WITH_RESULT(py_alloc_int(negative ? -1 : 0));
+
+    int64_t shift = b->as_int;
+
+    if (PY_INT_IS_SMALL(a)) {
+        // Arithmetic shifts of signed values round towards negative infinity, just
+        // like Python does.
+        return WITH_RESULT(py_alloc_int(shift >= 64 ? (negative ? -1 : 0) : a->as_int >> shift));
+    }
+
+    return WITH_RESULT(py_alloc_bigint(std_bigint_rshift(a->as_bigint, (size_t)shift)));
+}
+
+pyreturn_t py_int_and(pyobj_t* a, pyobj_t* b) {
+    if (BOTH_SMALL(a, b))
+        return WITH_RESULT(py_alloc_int(a->as_int & b->as_int));
+
+    return WITH_RESULT(py_alloc_bigint(std_bigint_and(BIG(a), BIG(b))));
+}
+
+pyreturn_t py_int_or(pyobj_t* a, pyobj_t* b) {
+    if (BOTH_SMALL(a, b))
+        return WITH_RESULT(py_alloc_int(a->as_int | b->as_int));
+
+    return WITH_RESULT(py_alloc_bigint(std_bigint_or(BIG(a), BIG(b))));
+}
+
+pyreturn_t py_int_xor(pyobj_t* a, pyobj_t* b) {
+    if (BOTH_SMALL(a, b))
+        return WITH_RESULT(py_alloc_int(a->as_int ^ b->as_int));
+
+    return WITH_RESULT(py_alloc_bigint(std_bigint_xor(BIG(a), BIG(b))));
+}
+
+pyobj_t* py_int_neg(pyobj_t* x) {
+    if (PY_INT_IS_SMALL(x) && x->as_int != INT64_MIN)
+        return py_alloc_int(-x->as_int);
+
+    return py_alloc_bigint(std_bigint_neg(BIG(x)));
+}
+
+int py_int_compare(pyobj_t* a, pyobj_t* b) {
+    if (BOTH_SMALL(a, b))
+        return (a->as_int > b->as_int) - (a->as_int < b->as_int);
+
+    return std_bigint_compare(BIG(a), BIG(b));
+}
+
+bool py_int_compare_float(pyobj_t* a, double b, int* out) {
+    if (b != b)
+        return false; // NaN
+
+    // Every integer up to 2^53 is exactly representable as a `double`.
+    if (PY_INT_IS_SMALL(a) && a->as_int >= -(1ll << 53) && a->as_int <= (1ll << 53)) {
+        double converted = (double)a->as_int;
+        *out = (converted > b) - (converted < b);
+        return true;
+    }
+
+    if (b > __DBL_MAX__ || b < -__DBL_MAX__) {
+        *out = b > 0 ? -1 : 1;
+        return true;
+    }
+
+    if (b > -0x1p63 && b < 0x1p63) {
+        // Compare against the integral part of `b` first - only if they're equal does
+        // the fractional part matter.
+        int64_t integral = (int64_t)b;
+        pyobj_t integral_obj = { .type = &py_type_int, .as_int = integral };
+
+        int result = py_int_compare(a, &integral_obj);
+        if (result == 0) {
+            double fraction = b - (double)integral;
+            result = (fraction < 0) - (fraction > 0);
+        }
+
+        *out = result;
+        return true;
+    }
+
+    // Values this large are always integral.
+    *out = std_bigint_compare(BIG(a), std_bigint_from_double(b));
+    return true;
+}
+
+bool py_int_to_double(const pyobj_t* x, double* out) {
+    ENSURE_NOT_NULL(x);
+
+    if (PY_INT_IS_SMALL(x)) {
+        *out = (double)x->as_int;
+        return true;
+    }
+
+    return std_bigint_to_double(x->as_bigint, out);
+}
+
+pyobj_t* py_int_from_double(double x) {
+    // -2^63 and everything between it and 2^63 converts exactly.
+    if (x >= -9223372036854775808.0 && x < 9223372036854775808.0)
+        return py_alloc_int((int64_t)x);
+
+    return py_alloc_bigint(std_bigint_from_double(x));
+}
+
+pyobj_t* py_int_as_index(pyobj_t* x, int64_t* out) {
+    ENSURE_NOT_NULL(x);
+
+    if (x->type != &py_type_int)
+        return NEW_EXCEPTION_INLINE(TypeError, "expected an integer");
+
+    if (!PY_INT_IS_SMALL(x))
+        return NEW_EXCEPTION_INLINE(OverflowError, "Python int too large to convert to C ssize_t");
+
+    *out = x->as_int;
+    return NULL;
+}
+
+string_t py_int_to_decimal(pyobj_t* x) {
+    ENSURE_NOT_NULL(x);
+
+    if (!PY_INT_IS_SMALL(x))
+        return std_bigint_to_decimal(x->as_bigint);
+
+    // 19 digits, a sign, and a null terminator.
+    char* buffer = mm_heap_alloc(21);
+    char* end = buffer + 20;
+    *end = '\0';
+
+    // We operate on the magnitude in the unsigned domain, so that INT64_MIN works.
+    uint64_t mag = x->as_int < 0 ? -(uint64_t)x->as_int : (uint64_t)x->as_int;
+    char* start = std_u64_to_decimal(mag, end);
+
+    if (x->as_int < 0) {
+        *--start = '-';
+    }
+
+    return (string_t) { .str = start, .length = (int)(end - start) };
+}
+
+pyobj_t* py_int_from_bytes(const uint8_t* data, size_t length, bool little_endian, bool is_signed) {
+    ENSURE_NOT_NULL(data);
+
+    // Byte `i` of the result, counting from the least significant one.
+    #define BYTE_AT($i) data[little_endian ? ($i) : length - 1 - ($i)]
+
+    bool negative = is_signed && length != 0 && (BYTE_AT(length - 1) & 0x80) != 0;
+
+    if (length <= 8) {
+        uint64_t value = 0;
+        for (size_t i = length; i-- > 0;) {
+            value = (value << 8) | BYTE_AT(i);
+        }
+
+        if (negative && length < 8) {
+            value |= ~(uint64_t)0 << (length * 8);
+        }
+
+        // Only unsigned values with the top bit set don't fit in an `int64_t`.
+        if (negative || (int64_t)value >= 0)
+            return py_alloc_int((int64_t)value);
+    }
+
+    size_t limb_count = (length + 7) / 8;
+    bigint_limb_t* limbs = mm_heap_alloc(limb_count * sizeof(bigint_limb_t));
+
+    for (size_t limb = 0; limb < limb_count; limb++) {
+        bigint_limb_t value = 0;
+
+        for (size_t i = MIN(limb * 8 + 8, length); i-- > limb * 8;) {
+            value = (value << 8) | BYTE_AT(i);
+        }
+
+        limbs[limb] = value;
+    }
+
+    #undef BYTE_AT
+
+    while (limb_count != 0 && limbs[limb_count - 1] == 0) {
+        limb_count--;
+    }
+
+    bigint_t* magnitude = mm_heap_alloc(sizeof(bigint_t));
+    *magnitude = (bigint_t) { .limbs = limbs, .length = limb_count, .negative = false };
+
+    // A negative two's complement number is its unsigned value, minus 2^(8 * length).
+    if (negative) {
+        bigint_t* modulus = std_bigint_lshift(std_bigint_from_i64(1), length * 8);
+        return py_alloc_bigint(std_bigint_sub(magnitude, modulus));
+    }
+
+    return py_alloc_bigint(magnitude);
+}
+
+pyobj_t* py_int_to_bytes(pyobj_t* x, uint8_t* out, size_t length, bool little_endian, bool is_signed) {
+    ENSURE_NOT_NULL(x);
+    ASSERT(x->type == &py_type_int);
+
+    bool negative = PY_INT_IS_SMALL(x) ? x->as_int < 0 : x->as_bigint->negative;
+    if (negative && !is_signed)
+        return NEW_EXCEPTION_INLINE(OverflowError, "can't convert negative int to unsigned");
+
+    // Byte `i` of the output, counting from the least significant one.
+    #define BYTE_AT($i) out[little_endian ? ($i) : length - 1 - ($i)]
+
+    if (PY_INT_IS_SMALL(x)) {
+        int64_t value = x->as_int;
+
+        if (length == 0 && value != 0)
+            return NEW_EXCEPTION_INLINE(OverflowError, "int too big to convert");
+
+        if (length != 0 && length < 8) {
+            // The range of values that fit in `length` bytes.
+            int bits = (int)length * 8;
+            int64_t min = is_signed ? -((int64_t)1 << (bits - 1)) : 0;
+            int64_t max = is_signed ? ((int64_t)1 << (bits - 1)) - 1 : ((int64_t)1 << bits) - 1;
+
+            if (value < min || value > max)
+                return NEW_EXCEPTION_INLINE(OverflowError, "int too big to convert");
+        }
+        else if (length == 8 && !is_signed && value < 0) {
+            return NEW_EXCEPTION_INLINE(OverflowError, "int too big to convert");
+        }
+
+        // Bytes past the 8th one are the sign extension of the value.
+        for (size_t i = 0; i < length; i++) {
+            BYTE_AT(i) = i < 8 ? (uint8_t)((uint64_t)value >> (i * 8)) : (value < 0 ? 0xFF : 0);
+        }
+
+        return NULL;
+    }
+
+    // The value doesn't fit in 64 bits. Signed values need an extra bit for the sign,
+    // except for -2^(8 * length - 1), which has a magnitude of exactly that many bits.
+    const bigint_t* value = x->as_bigint;
+    size_t bits = std_bigint_bit_length(value);
+    size_t available = length * 8 - (is_signed ? 1 : 0);
+
+    if (length == 0 || bits > available + (negative ? 1 : 0))
+        return NEW_EXCEPTION_INLINE(OverflowError, "int too big to convert");
+
+    if (negative && bits == available + 1) {
+        // Only exactly -2^available fits.
+        bigint_t* limit = std_bigint_neg(std_bigint_lshift(std_bigint_from_i64(1), available));
+        if (std_bigint_compare(value, limit) != 0)
+            return NEW_EXCEPTION_INLINE(OverflowError, "int too big to convert");
+    }
+
+    // Negative values are written as 2^(8 * length) + value.
+    if (negative) {
+        value = std_bigint_add(value, std_bigint_lshift(std_bigint_from_i64(1), length * 8));
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        size_t limb = i / 8;
+        BYTE_AT(i) = limb < value->length ? (uint8_t)(value->limbs[limb] >> ((i % 8) * 8)) : 0;
+    }
+
+    #undef BYTE_AT
+    return NULL;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "objects.h"
+#include "exceptions.h"
+#include "std/bigint.h"
+
+// Python `int` objects hold their value inline, in `as_int`, as long as it fits in 64 bits.
+// Otherwise, `as_bigint` points to an arbitrary-precision representation. Values are always
+// kept in the smallest representation - a `bigint_t` never holds a value that fits in `as_int`.
+//
+// Operations on two inline values detect overflow via `__builtin_*_overflow`, and only then
+// fall back to big integer arithmetic.
+
+// Evaluates to `true` if the given `int` object holds its value inline, in `as_int`.
+#define PY_INT_IS_SMALL($x) (($x)->as_bigint == NULL)
+
+// Creates an `int` object from the given big integer, demoting it to an inline value
+// if it fits in 64 bits.
+pyobj_t* py_alloc_bigint(bigint_t* x);
+
+// Returns the value of the given `int` object as a big integer.
+bigint_t* py_int_to_bigint(const pyobj_t* x);
+
+// The following implement binary operators over two `int` objects, with the same
+// semantics as Python.
+
+// Implements `a + b`.
+pyreturn_t py_int_add(pyobj_t* a, pyobj_t* b);
+
+// Implements `a - b`.
+pyreturn_t py_int_sub(pyobj_t* a, pyobj_t* b);
+
+// Implements `a * b`.
+pyreturn_t py_int_mul(pyobj_t* a, pyobj_t* b);
+
+// Implements `a // b`, rounding towards negative infinity.
+pyreturn_t py_int_floordiv(pyobj_t* a, pyobj_t* b);
+
+// Implements `a % b`. The result has the same sign as `b`.
+pyreturn_t py_int_mod(pyobj_t* a, pyobj_t* b);
+
+// Implements `a / b`. The quotient is computed exactly, and then rounded to the nearest
+// `float` once - so that e.g. `10**400 / 10**399` doesn't overflow.
+pyreturn_t py_int_truediv(pyobj_t* a, pyobj_t* b);
+
+// Implements `a ** b`.
+pyreturn_t py_int_pow(pyobj_t* a, pyobj_t* b);
+
+// Implements `a << b`.
+pyreturn_t py_int_lshift(pyobj_t* a, pyobj_t* b);
+
+// Implements `a >> b`.
+pyreturn_t py_int_rshift(pyobj_t* a, pyobj_t* b);
+
+// Implements `a & b`.
+pyreturn_t py_int_and(pyobj_t* a, pyobj_t* b);
+
+// Implements `a | b`.
+pyreturn_t py_int_or(pyobj_t* a, pyobj_t* b);
+
+// Implements `a ^ b`.
+pyreturn_t py_int_xor(pyobj_t* a, pyobj_t* b);
+
+// Implements `pow(base, exp, mod)`.
+pyreturn_t py_int_powmod(pyobj_t* base, pyobj_t* exp, pyobj_t* mod);
+
+// Implements `-x`.
+pyobj_t* py_int_neg(pyobj_t* x);
+
+// Compares two `int` objects. Returns a negative value if `a < b`, zero if `a == b`,
+// and a positive value if `a > b`.
+int py_int_compare(pyobj_t* a, pyobj_t* b);
+
+// Compares an `int` object with a `float` value exactly, without rounding `a`. Returns
+// `false` if `b` is NaN, in which case the values are unordered. Otherwise, sets `out`
+// to a negative value if `a < b`, zero if `a == b`, and a positive value if `a > b`.
+bool py_int_compare_float(pyobj_t* a, double b, int* out);
+
+// Converts the given `int` object to the nearest `float` value. Returns `false` if the
+// value is too large to be represented as a finite `float`.
+bool py_int_to_double(const pyobj_t* x, double* out);
+
+// Creates an `int` object from a finite `float` value, truncating it towards zero.
+pyobj_t* py_int_from_double(double x);
+
+// Converts an argument that is used as an index or a count to a 64-bit integer. Raises a
+// `TypeError` if the argument is not an `int`, and an `OverflowError` if it doesn't fit.
+// Returns an exception or NULL.
+pyobj_t* py_int_as_index(pyobj_t* x, int64_t* out);
+
+// Converts `length` bytes to an `int`, like `int.from_bytes` does. The bytes are read in
+// little-endian order if `little_endian` is `true`, and as a two's complement number if
+// `is_signed` is `true`.
+pyobj_t* py_int_from_bytes(const uint8_t* data, size_t length, bool little_endian, bool is_signed);
+
+// Writes the value of the given `int` object to `length` bytes at `out`, like `int.to_bytes`
+// does. Raises an `OverflowError` if the value can't be represented in that many bytes.
+// Returns an exception or NULL.
+pyobj_t* py_int_to_bytes(pyobj_t* x, uint8_t* out, size_t length, bool little_endian, bool is_signed);
+
+// Converts the given `int` object to its decimal representation.
+string_t py_int_to_decimal(pyobj_t* x);
@@ -0,0 +1,310 @@
+#include "lists.h"
+
+#include "ints.h"
+#include "dicts.h"
+#include "opcodes.h"
+#include "std/safety.h"
+#include "std/memory.h"
+#include "sys/mm.h"
+
+// Resolves `index` to a position within the given `list` or `tuple`, where negative
+// indices count from the end. Returns an exception or NULL.
+static pyobj_t* resolve_index(pyobj_t* sequence, pyobj_t* index, size_t* out_index) {
+    bool is_tuple = sequence->type == &py_type_tuple;
+    *out_index = 0; // also written on errors, so that callers never see an indeterminate value
+
+    if (index->type != &py_type_int) {
+        return is_tuple
+            ? NEW_EXCEPTION_INLINE(TypeError, "tuple indices must be integers")
+            : NEW_EXCEPTION_INLINE(TypeError, "list indices must be integers");
+    }
+
+    int64_t length = (int64_t)sequence->as_list.length;
+    int64_t i = index->as_int;
+
+    if (PY_INT_IS_SMALL(index) && i < 0) {
+        i += length;
+    }
+
+    if (!PY_INT_IS_SMALL(index) || i < 0 || i >= length) {
+        return is_tuple
+            ? NEW_EXCEPTION_INLINE(IndexError, "tuple index out of range")
+            : NEW_EXCEPTION_INLINE(IndexError, "list index out of range");
+    }
+
+    *out_index = (size_t)i;
+    return NULL;
+}
+
+pyobj_t* py_alloc_list(size_t capacity) {
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = &py_type_list;
+    obj->as_list = (vector_t(pyobj_ptr_t)) {};
+
+    if (capacity != 0) {
+        std_vector_reserve(&obj->as_list, capacity);
+    }
+
+    return obj;
+}
+
+pyobj_t* py_alloc_tuple(size_t length) {
+    pyobj_t* obj = py_alloc_list(length);
+    obj->type = &py_type_tuple;
+    obj->as_list.length = length;
+    return obj;
+}
+
+pyobj_t* py_alloc_list_iterator(pyobj_t* sequence) {
+    ENSURE_NOT_NULL(sequence);
+    ASSERT(sequence->type == &py_type_list || sequence->type == &py_type_tuple);
+
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = &py_type_list_iterator;
+    obj->as_list_iterator.sequence = sequence;
+    obj->as_list_iterator.index = 0;
+    return obj;
+}
+
+void py_list_append(pyobj_t* list, pyobj_t* item) {
+    ENSURE_NOT_NULL(list);
+    ENSURE_NOT_NULL(item);
+    ASSERT(list->type == &py_type_list);
+
+    std_vector_append(&list->as_list, item);
+}
+
+pyobj_t* py_list_extend(pyobj_t* list, pyobj_t* iterable) {
+    ENSURE_NOT_NULL(list);
+    ENSURE_NOT_NULL(iterable);
+    ASSERT(list->type == &py_type_list);
+
+    if (iterable->type == &py_type_list || iterable->type == &py_type_tuple) {
+        // We know the exact amount of elements, so we can grow the list once, and copy all
+        // element pointers at once. We read the elements after growing, as `iterable` might
+        // be `list` itself.
+        size_t count = iterable->as_list.length;
+        if (count == 0)
+            return NULL;
+
+        std_vector_reserve(&list->as_list, list->as_list.length + count);
+        memcpy(
+            &list->as_list.elements[list->as_list.length],
+            iterable->as_list.elements,
+            count * sizeof(pyobj_t*)
+        );
+
+        list->as_list.length += count;
+        return NULL;
+    }
+
+    // Otherwise, we go through the same logic `GET_ITER` and `FOR_ITER` use, on a stack
+    // of our own.
+    void* stack[2] = { iterable };
+    int stack_current = 0;
+
+    pyreturn_t status = py_opcode_get_iter(stack, &stack_current);
+    if (status.exception != NULL)
+        return status.exception;
+
+    std_vector_reserve(&list->as_list, list->as_list.length + py_length_hint(stack[0]));
+
+    while (true) {
+        bool exhausted;
+        status = py_opcode_for_iter(stack, &stack_current, &exhausted);
+
+        if (status.exception != NULL)
+            return status.exception;
+
+        if (exhausted)
+            return NULL;
+
+        std_vector_append(&list->as_list, (pyobj_t*)stack[stack_current--]);
+    }
+}
+
+pyobj_t* py_list_insert(pyobj_t* list, pyobj_t* index, pyobj_t* item) {
+    ENSURE_NOT_NULL(list);
+    ENSURE_NOT_NULL(index);
+    ENSURE_NOT_NULL(item);
+    ASSERT(list->type == &py_type_list);
+
+    if (index->type != &py_type_int)
+        return NEW_EXCEPTION_INLINE(TypeError, "list indices must be integers");
+
+    int64_t length = (int64_t)list->as_list.length;
+    int64_t i;
+
+    if (!PY_INT_IS_SMALL(index)) {
+        i = index->as_bigint->negative ? 0 : length;
+    }
+    else {
+        i = index->as_int;
+
+        if (i < 0) {
+            i = MAX(i + length, 0);
+        }
+
+        i = MIN(i, length);
+    }
+
+    std_vector_insert(&list->as_list, (size_t)i, item);
+    return NULL;
+}
+
+pyreturn_t py_list_pop(pyobj_t* list, pyobj_t* index) {
+    ENSURE_NOT_NULL(list);
+    ASSERT(list->type == &py_type_list);
+
+    if (list->as_list.length == 0)
+        RAISE(IndexError, "pop from empty list");
+
+    size_t i = list->as_list.length - 1;
+
+    if (index != NULL) {
+        pyobj_t* exception = resolve_index(list, index, &i);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+    }
+
+    pyobj_t* item = list->as_list.elements[i];
+    std_vector_remove(&list->as_list, (int)i);
+    return WITH_RESULT(item);
+}
+
+pyreturn_t py_list_getitem(pyobj_t* sequence, pyobj_t* index) {
+    ENSURE_NOT_NULL(sequence);
+    ENSURE_NOT_NULL(index);
+
+    size_t i;
+    pyobj_t* exception = resolve_index(sequence, index, &i);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(sequence->as_list.elements[i]);
+}
+
+pyobj_t* py_list_setitem(pyobj_t* list, pyobj_t* index, pyobj_t* value) {
+    ENSURE_NOT_NULL(list);
+    ENSURE_NOT_NULL(index);
+    ENSURE_NOT_NULL(value);
+    ASSERT(list->type == &py_type_list);
+
+    size_t i;
+    pyobj_t* exception = resolve_index(list, index, &i);
+    if (exception != NULL)
+        return exception;
+
+    list->as_list.elements[i] = value;
+    return NULL;
+}
+
+pyobj_t* py_list_delitem(pyobj_t* list, pyobj_t* index) {
+    ENSURE_NOT_NULL(list);
+    ENSURE_NOT_NULL(index);
+    ASSERT(list->type == &py_type_list);
+
+    size_t i;
+    pyobj_t* exception = resolve_index(list, index, &i);
+    if (exception != NULL)
+        return exception;
+
+    std_vector_remove(&list->as_list, (int)i);
+    return NULL;
+}
+
+size_t py_length_hint(pyobj_t* iterable) {
+    ENSURE_NOT_NULL(iterable);
+
+    if (iterable->type == &py_type_list || iterable->type == &py_type_tuple)
+        return iterable->as_list.length;
+
+    if (iterable->type == &py_type_list_iterator) {
+        size_t length = iterable->as_list_iterator.sequence->as_list.length;
+        size_t index = iterable->as_list_iterator.index;
+        return index < length ? length - index : 0;
+    }
+
+    return 0;
+}
+
+string_t py_list_to_str(pyobj_t* sequence) {
+    ENSURE_NOT_NULL(sequence);
+
+    size_t length = sequence->as_list.length;
+    bool is_tuple = sequence->type == &py_type_tuple;
+
+    // Each element takes up to 4 parts - a separator, and an element which might be
+    // surrounded by quotes. Then, we have the brackets, and the trailing comma of
+    // single-element tuples.
+    string_t* parts = mm_heap_alloc((length * 4 + 3) * sizeof(string_t));
+    int n = 0;
+
+    parts[n++] = is_tuple ? STR("(") : STR("[");
+
+    for (size_t i = 0; i < length; i++) {
+        pyobj_t* element = sequence->as_list.elements[i];
+
+        if (i != 0) {
+            parts[n++] = STR(", ");
+        }
+
+        // TODO: Use __repr__ for elements once we support it.
+        if (element->type == &py_type_str) {
+            parts[n++] = STR("'");
+            parts[n++] = element->as_str;
+            parts[n++] = STR("'");
+        }
+        else {
+            parts[n++] = py_stringify(element);
+        }
+    }
+
+    if (is_tuple && length == 1) {
+        parts[n++] = STR(",");
+    }
+
+    parts[n++] = is_tuple ? STR(")") : STR("]");
+
+    string_t result = std_strconcat_array(parts, n);
+    mm_heap_free(parts);
+    return result;
+}
+
+pyobj_t* py_sequences_mismatch(pyobj_t* a, pyobj_t* b, size_t* out_index) {
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+    ENSURE_NOT_NULL(out_index);
+
+    // The lengths are checked on every step, as comparing elements might change the lists.
+    size_t i = 0;
+    for (; i < a->as_list.length && i < b->as_list.length; i++) {
+        pyobj_t* exception;
+        if (!py_keys_equal(a->as_list.elements[i], b->as_list.elements[i], &exception)) {
+            *out_index = i;
+            return exception;
+        }
+    }
+
+    *out_index = i;
+    return NULL;
+}
+
+pyobj_t* py_sequences_equal(pyobj_t* a, pyobj_t* b, bool* out_result) {
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+    ENSURE_NOT_NULL(out_result);
+
+    *out_result = false;
+
+    if (a->as_list.length != b->as_list.length)
+        return NULL;
+
+    size_t index;
+    pyobj_t* exception = py_sequences_mismatch(a, b, &index);
+    if (exception != NULL)
+        return exception;
+
+    *out_result = index == a->as_list.length && index == b->as_list.length;
+    return NULL;
+}
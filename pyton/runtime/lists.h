@@ -0,0 +1,61 @@
+#pragma once
+
+#include "objects.h"
+#include "exceptions.h"
+
+// Python `list` objects hold their elements in a `vector_t(pyobj_ptr_t)`, in `as_list`.
+// Tuples share the same representation, but never change after being created - all
+// functions here that only read from a sequence accept both.
+//
+// Iterating over either a `list` or a `tuple` yields a `list_iterator` object, which
+// `FOR_ITER` advances directly, without going through `__next__`.
+
+// Allocates an empty `list`, with room for at least `capacity` elements before it needs
+// to grow.
+pyobj_t* py_alloc_list(size_t capacity);
+
+// Allocates a `tuple` of the given length. Its elements are left uninitialized, and have
+// to be set by the caller before the tuple is used.
+pyobj_t* py_alloc_tuple(size_t length);
+
+// Allocates an iterator over the given `list` or `tuple`.
+pyobj_t* py_alloc_list_iterator(pyobj_t* sequence);
+
+// Appends `item` to the end of `list`.
+void py_list_append(pyobj_t* list, pyobj_t* item);
+
+// Implements `list.extend(iterable)`. Returns an exception or NULL.
+pyobj_t* py_list_extend(pyobj_t* list, pyobj_t* iterable);
+
+// Implements `list.insert(index, item)`. Like in Python, indices past either end of the
+// list are clamped. Returns an exception or NULL.
+pyobj_t* py_list_insert(pyobj_t* list, pyobj_t* index, pyobj_t* item);
+
+// Implements `list.pop(index)`. Returns the removed element.
+pyreturn_t py_list_pop(pyobj_t* list, pyobj_t* index);
+
+// Implements `sequence[index]`, where `sequence` is a `list` or a `tuple` and `index`
+// is an `int`.
+pyreturn_t py_list_getitem(pyobj_t* sequence, pyobj_t* index);
+
+// Implements `list[index] = value`, where `index` is an `int`. Returns an exception or NULL.
+pyobj_t* py_list_setitem(pyobj_t* list, pyobj_t* index, pyobj_t* value);
+
+// Implements `del list[index]`, where `index` is an `int`. Returns an exception or NULL.
+pyobj_t* py_list_delitem(pyobj_t* list, pyobj_t* index);
+
+// Returns the number of elements that iterating over `iterable` will most likely yield,
+// or 0 if it's not known. This is only used to pre-size lists, and may be inaccurate.
+size_t py_length_hint(pyobj_t* iterable);
+
+// Converts the given `list` or `tuple` to its string representation, e.g. `[1, 'a']`.
+string_t py_list_to_str(pyobj_t* sequence);
+
+// Finds the first index at which the elements of the given `list`s or `tuple`s are not
+// equal, as determined by `py_keys_equal`. If there is none, the index is the length of
+// the shorter one. Returns an exception or NULL.
+pyobj_t* py_sequences_mismatch(pyobj_t* a, pyobj_t* b, size_t* out_index);
+
+// Implements `a == b`, where both operands are `list`s or both are `tuple`s. The elements
+// are compared pairwise with `py_keys_equal`, which uses this for `tuple` keys as well. Returns an exception or NULL.
+pyobj_t* py_sequences_equal(pyobj_t* a, pyobj_t* b, bool* out_result);
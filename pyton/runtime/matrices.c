@@ -0,0 +1,648 @@
+#include "matrices.h"
+
+#include <immintrin.h>
+#include "ints.h"
+#include "lists.h"
+#include "dicts.h"
+#include "arrays.h"
+#include "std/memory.h"
+#include "std/safety.h"
+#include "std/string.h"
+#include "sys/cpu.h"
+#include "sys/mm.h"
+
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+
+// The shape of the tile of the result the micro-kernels keep in registers. Both variants
+// compute `MR` rows at a time - the SSE2 one `NR_SSE2` columns, and the AVX2 one `NR_AVX2`.
+#define MR 4
+#define NR_SSE2 4
+#define NR_AVX2 8
+
+// The block sizes of the GEMM. A packed `KC`-by-`NC` block of the right operand is reused for
+// every `MC`-by-`KC` block of the left operand, which is sized to stay in the L2 cache, while
+// a single `KC`-by-`NR` panel of the right operand stays in the L1 cache.
+#define MC 128
+#define KC 256
+#define NC 1024
+
+// Returns `true` if the AVX2 variant of the micro-kernel can be used.
+static inline bool use_avx2(void) {
+    return cpu_get_features()->avx2;
+}
+
+pyobj_t* py_alloc_matrix_of(char typecode, size_t rows, size_t cols) {
+    ASSERT(typecode == 'd' || typecode == 'q');
+
+    // Even empty matrices have storage, which lets the kernels skip checking for `NULL`.
+    size_t size = rows * cols * sizeof(uint64_t);
+    void* data = mm_heap_alloc(MAX(size, sizeof(uint64_t)));
+    memset(data, 0, size);
+
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = &py_type_matrix_matrix;
+    obj->as_matrix = (struct matrix_data) {
+        .data = data,
+        .rows = rows,
+        .cols = cols,
+        .row_stride = cols,
+        .col_stride = 1,
+        .typecode = typecode
+    };
+
+    return obj;
+}
+
+// Converts `x` to a matrix dimension. Returns an exception or NULL.
+static pyobj_t* to_dimension(pyobj_t* x, size_t* out) {
+    *out = 0;
+
+    if (x->type != &py_type_int)
+        return NEW_EXCEPTION_INLINE(TypeError, "matrix dimensions must be integers");
+
+    if (!PY_INT_IS_SMALL(x) || x->as_int < 0 || x->as_int > UINT32_MAX)
+        return NEW_EXCEPTION_INLINE(ValueError, "matrix dimensions must be between 0 and 2**32 - 1");
+
+    *out = (size_t)x->as_int;
+    return NULL;
+}
+
+pyreturn_t py_alloc_matrix(pyobj_t* typecode, pyobj_t* rows, pyobj_t* cols, pyobj_t* initializer) {
+    ENSURE_NOT_NULL(typecode);
+    ENSURE_NOT_NULL(rows);
+    ENSURE_NOT_NULL(cols);
+
+    if (typecode->type != &py_type_str || typecode->as_str.length != 1)
+        RAISE(TypeError, "matrix() argument 1 must be a unicode character");
+
+    char code = typecode->as_str.str[0];
+    if (code != 'd' && code != 'q')
+        RAISE(ValueError, "bad typecode (must be d or q)");
+
+    size_t n_rows, n_cols;
+    pyobj_t* exception = to_dimension(rows, &n_rows);
+    if (exception == NULL) {
+        exception = to_dimension(cols, &n_cols);
+    }
+
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    if (initializer == NULL)
+        return WITH_RESULT(py_alloc_matrix_of(code, n_rows, n_cols));
+
+    // An `array` of the same typecode already has the exact layout of a row-major matrix,
+    // so we let it convert the elements, and then take its storage.
+    pyobj_t* elements = UNWRAP(py_alloc_array(typecode, initializer));
+    if (py_array_length(elements) != n_rows * n_cols)
+        RAISE(ValueError, "matrix initializer must have exactly rows * cols elements");
+
+    pyobj_t* matrix = py_alloc_matrix_of(code, 0, 0);
+    matrix->as_matrix.data = elements->as_buffer.data;
+    matrix->as_matrix.rows = n_rows;
+    matrix->as_matrix.cols = n_cols;
+    matrix->as_matrix.row_stride = n_cols;
+    return WITH_RESULT(matrix);
+}
+
+pyobj_t* py_matrix_transpose(pyobj_t* matrix) {
+    ENSURE_NOT_NULL(matrix);
+    ASSERT(PY_IS_MATRIX(matrix));
+
+    const struct matrix_data* m = &matrix->as_matrix;
+
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = &py_type_matrix_matrix;
+    obj->as_matrix = (struct matrix_data) {
+        .data = m->data,
+        .rows = m->cols,
+        .cols = m->rows,
+        .row_stride = m->col_stride,
+        .col_stride = m->row_stride,
+        .typecode = m->typecode
+    };
+
+    return obj;
+}
+
+// Returns a pointer to the raw bits of the element at row `i` and column `j`.
+static inline uint64_t* element_at(const struct matrix_data* m, size_t i, size_t j) {
+    return &((uint64_t*)m->data)[i * m->row_stride + j * m->col_stride];
+}
+
+// Boxes the raw bits of an element of the given typecode.
+static inline pyobj_t* box_element(char typecode, uint64_t bits) {
+    if (typecode == 'q')
+        return py_alloc_int((int64_t)bits);
+
+    double x;
+    memcpy(&x, &bits, sizeof(x));
+    return py_alloc_float(x);
+}
+
+// Resolves `index` to a position below `length`, where negative indices count from the end.
+// Returns an exception or NULL.
+static pyobj_t* resolve_index(pyobj_t* index, size_t length, size_t* out_index) {
+    *out_index = 0;
+
+    if (index->type != &py_type_int)
+        return NEW_EXCEPTION_INLINE(TypeError, "matrix indices must be integers");
+
+    int64_t i = index->as_int;
+    if (PY_INT_IS_SMALL(index) && i < 0) {
+        i += (int64_t)length;
+    }
+
+    if (!PY_INT_IS_SMALL(index) || i < 0 || i >= (int64_t)length)
+        return NEW_EXCEPTION_INLINE(IndexError, "matrix index out of range");
+
+    *out_index = (size_t)i;
+    return NULL;
+}
+
+pyreturn_t py_matrix_row(pyobj_t* matrix, pyobj_t* index) {
+    ENSURE_NOT_NULL(matrix);
+    ENSURE_NOT_NULL(index);
+    ASSERT(PY_IS_MATRIX(matrix));
+
+    const struct matrix_data* m = &matrix->as_matrix;
+
+    size_t i;
+    pyobj_t* exception = resolve_index(index, m->rows, &i);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    pyobj_t* row = py_alloc_array_of(m->typecode, m->cols);
+    uint64_t* out = (uint64_t*)row->as_buffer.data;
+
+    for (size_t j = 0; j < m->cols; j++) {
+        out[j] = *element_at(m, i, j);
+    }
+
+    return WITH_RESULT(row);
+}
+
+pyreturn_t py_matrix_get(pyobj_t* matrix, pyobj_t* i, pyobj_t* j) {
+    ENSURE_NOT_NULL(matrix);
+    ENSURE_NOT_NULL(i);
+    ENSURE_NOT_NULL(j);
+    ASSERT(PY_IS_MATRIX(matrix));
+
+    const struct matrix_data* m = &matrix->as_matrix;
+
+    size_t row, col;
+    pyobj_t* exception = resolve_index(i, m->rows, &row);
+    if (exception == NULL) {
+        exception = resolve_index(j, m->cols, &col);
+    }
+
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(box_element(m->typecode, *element_at(m, row, col)));
+}
+
+pyobj_t* py_matrix_set(pyobj_t* matrix, pyobj_t* i, pyobj_t* j, pyobj_t* value) {
+    ENSURE_NOT_NULL(matrix);
+    ENSURE_NOT_NULL(i);
+    ENSURE_NOT_NULL(j);
+    ENSURE_NOT_NULL(value);
+    ASSERT(PY_IS_MATRIX(matrix));
+
+    const struct matrix_data* m = &matrix->as_matrix;
+
+    size_t row, col;
+    pyobj_t* exception = resolve_index(i, m->rows, &row);
+    if (exception == NULL) {
+        exception = resolve_index(j, m->cols, &col);
+    }
+
+    if (exception != NULL)
+        return exception;
+
+    uint64_t* p = element_at(m, row, col);
+
+    if (m->typecode == 'q') {
+        if (value->type != &py_type_int)
+            return NEW_EXCEPTION_INLINE(TypeError, "an integer is required");
+
+        if (!PY_INT_IS_SMALL(value))
+            return NEW_EXCEPTION_INLINE(OverflowError, "Python int too large to convert to C long long");
+
+        *p = (uint64_t)value->as_int;
+        return NULL;
+    }
+
+    double x;
+    if (value->type == &py_type_float) {
+        x = value->as_float;
+    }
+    else if (value->type == &py_type_int) {
+        if (!py_int_to_double(value, &x))
+            return NEW_EXCEPTION_INLINE(OverflowError, "int too large to convert to float");
+    }
+    else {
+        return NEW_EXCEPTION_INLINE(TypeError, "must be real number");
+    }
+
+    memcpy(p, &x, sizeof(x));
+    return NULL;
+}
+
+// Packs the `mc`-by-`kc` block of the left operand that starts at `a` into panels of `MR`
+// rows, each storing the `MR` elements of a column next to each other. Rows past `mc` are
+// zero. The block is read along whichever of its dimensions is contiguous, which is what
+// makes multiplying transposed views as fast as multiplying the matrices they view.
+static void pack_a(
+    const uint64_t* a,
+    size_t row_stride,
+    size_t col_stride,
+    size_t mc,
+    size_t kc,
+    uint64_t* out
+) {
+    for (size_t p = 0; p < mc; p += MR, out += kc * MR) {
+        size_t rows = MIN(MR, mc - p);
+        const uint64_t* from = a + p * row_stride;
+
+        if (rows < MR) {
+            memset(out, 0, kc * MR * sizeof(uint64_t));
+        }
+
+        if (col_stride <= row_stride) {
+            for (size_t r = 0; r < rows; r++) {
+                for (size_t k = 0; k < kc; k++) {
+                    out[k * MR + r] = from[r * row_stride + k * col_stride];
+                }
+            }
+        }
+        else {
+            for (size_t k = 0; k < kc; k++) {
+                for (size_t r = 0; r < rows; r++) {
+                    out[k * MR + r] = from[r * row_stride + k * col_stride];
+                }
+            }
+        }
+    }
+}
+
+// Packs the `kc`-by-`nc` block of the right operand that starts at `b` into panels of `nr`
+// columns, each storing the `nr` elements of a row next to each other. Columns past `nc` are
+// zero. Like `pack_a`, this reads the block along its contiguous dimension.
+static void pack_b(
+    const uint64_t* b,
+    size_t row_stride,
+    size_t col_stride,
+    size_t kc,
+    size_t nc,
+    size_t nr,
+    uint64_t* out
+) {
+    for (size_t p = 0; p < nc; p += nr, out += kc * nr) {
+        size_t cols = MIN(nr, nc - p);
+        const uint64_t* from = b + p * col_stride;
+
+        if (cols < nr) {
+            memset(out, 0, kc * nr * sizeof(uint64_t));
+        }
+
+        if (col_stride <= row_stride) {
+            for (size_t k = 0; k < kc; k++) {
+                for (size_t c = 0; c < cols; c++) {
+                    out[k * nr + c] = from[k * row_stride + c * col_stride];
+                }
+            }
+        }
+        else {
+            for (size_t c = 0; c < cols; c++) {
+                for (size_t k = 0; k < kc; k++) {
+                    out[k * nr + c] = from[k * row_stride + c * col_stride];
+                }
+            }
+        }
+    }
+}
+
+// Multiplies the lanes of two vectors of 64-bit integers, keeping the low 64 bits of each
+// product. Neither SSE2 nor AVX2 have such an instruction, so the product is assembled from
+// three 32-by-32-bit multiplications - the product of the high halves only affects the bits
+// that get discarded.
+static ALWAYS_INLINE __m128i mullo_i64(__m128i a, __m128i b) {
+    __m128i low = _mm_mul_epu32(a, b);
+    __m128i cross = _mm_add_epi64(
+        _mm_mul_epu32(_mm_srli_epi64(a, 32), b),
+        _mm_mul_epu32(a, _mm_srli_epi64(b, 32))
+    );
+
+    return _mm_add_epi64(low, _mm_slli_epi64(cross, 32));
+}
+
+AVX2 static ALWAYS_INLINE __m256i mullo_i64_avx2(__m256i a, __m256i b) {
+    __m256i low = _mm256_mul_epu32(a, b);
+    __m256i cross = _mm256_add_epi64(
+        _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+        _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32))
+    );
+
+    return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+}
+
+// Computes `acc + a * b` on the lanes of two vectors, holding either doubles or 64-bit
+// integers. The multiplication is never fused with the addition.
+static ALWAYS_INLINE __m128i multiply_add(__m128i acc, __m128i a, __m128i b, bool is_int) {
+    if (is_int)
+        return _mm_add_epi64(acc, mullo_i64(a, b));
+
+    __m128d product = _mm_mul_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b));
+    return _mm_castpd_si128(_mm_add_pd(_mm_castsi128_pd(acc), product));
+}
+
+AVX2 static ALWAYS_INLINE __m256i multiply_add_avx2(__m256i acc, __m256i a, __m256i b, bool is_int) {
+    if (is_int)
+        return _mm256_add_epi64(acc, mullo_i64_avx2(a, b));
+
+    __m256d product = _mm256_mul_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b));
+    return _mm256_castpd_si256(_mm256_add_pd(_mm256_castsi256_pd(acc), product));
+}
+
+// Represents a micro-kernel, which adds the product of a packed `MR`-by-`kc` panel of the left
+// operand and a packed `kc`-by-`NR` panel of the right operand to the `MR`-by-`NR` tile of
+// the result at `c`, whose rows are `ldc` elements apart.
+typedef void (*micro_kernel_t)(size_t kc, const uint64_t* a, const uint64_t* b, uint64_t* c, size_t ldc);
+
+// The tile of the result is loaded into the accumulators before the panels are multiplied,
+// rather than being added to them afterwards - this way, every element is summed in order of
+// `k`, even across `KC` blocks.
+static ALWAYS_INLINE void micro_kernel_sse2(
+    size_t kc,
+    const uint64_t* a,
+    const uint64_t* b,
+    uint64_t* c,
+    size_t ldc,
+    bool is_int
+) {
+    __m128i acc[MR][2];
+    for (int r = 0; r < MR; r++) {
+        acc[r][0] = _mm_loadu_si128((const __m128i*)&c[r * ldc]);
+        acc[r][1] = _mm_loadu_si128((const __m128i*)&c[r * ldc + 2]);
+    }
+
+    for (size_t k = 0; k < kc; k++, a += MR, b += NR_SSE2) {
+        __m128i b0 = _mm_loadu_si128((const __m128i*)b);
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(b + 2));
+
+        for (int r = 0; r < MR; r++) {
+            __m128i x = _mm_set1_epi64x((int64_t)a[r]);
+            acc[r][0] = multiply_add(acc[r][0], x, b0, is_int);
+            acc[r][1] = multiply_add(acc[r][1], x, b1, is_int);
+        }
+    }
+
+    for (int r = 0; r < MR; r++) {
+        _mm_storeu_si128((__m128i*)&c[r * ldc], acc[r][0]);
+        _mm_storeu_si128((__m128i*)&c[r * ldc + 2], acc[r][1]);
+    }
+}
+
+AVX2 static ALWAYS_INLINE void micro_kernel_avx2(
+    size_t kc,
+    const uint64_t* a,
+    const uint64_t* b,
+    uint64_t* c,
+    size_t ldc,
+    bool is_int
+) {
+    __m256i acc[MR][2];
+    for (int r = 0; r < MR; r++) {
+        acc[r][0] = _mm256_loadu_si256((const __m256i*)&c[r * ldc]);
+        acc[r][1] = _mm256_loadu_si256((const __m256i*)&c[r * ldc + 4]);
+    }
+
+    for (size_t k = 0; k < kc; k++, a += MR, b += NR_AVX2) {
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)b);
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(b + 4));
+
+        for (int r = 0; r < MR; r++) {
+            __m256i x = _mm256_set1_epi64x((int64_t)a[r]);
+            acc[r][0] = multiply_add_avx2(acc[r][0], x, b0, is_int);
+            acc[r][1] = multiply_add_avx2(acc[r][1], x, b1, is_int);
+        }
+    }
+
+    for (int r = 0; r < MR; r++) {
+        _mm256_storeu_si256((__m256i*)&c[r * ldc], acc[r][0]);
+        _mm256_storeu_si256((__m256i*)&c[r * ldc + 4], acc[r][1]);
+    }
+}
+
+static void micro_kernel_f64_sse2(size_t kc, const uint64_t* a, const uint64_t* b, uint64_t* c, size_t ldc) {
+    micro_kernel_sse2(kc, a, b, c, ldc, false);
+}
+
+static void micro_kernel_i64_sse2(size_t kc, const uint64_t* a, const uint64_t* b, uint64_t* c, size_t ldc) {
+    micro_kernel_sse2(kc, a, b, c, ldc, true);
+}
+
+AVX2 static void micro_kernel_f64_avx2(size_t kc, const uint64_t* a, const uint64_t* b, uint64_t* c, size_t ldc) {
+    micro_kernel_avx2(kc, a, b, c, ldc, false);
+}
+
+AVX2 static void micro_kernel_i64_avx2(size_t kc, const uint64_t* a, const uint64_t* b, uint64_t* c, size_t ldc) {
+    micro_kernel_avx2(kc, a, b, c, ldc, true);
+}
+
+// Computes `c += a * b`, where `a` is `m`-by-`k`, `b` is `k`-by-`n`, and `c` is a row-major
+// `m`-by-`n` matrix.
+static void gemm(const struct matrix_data* a, const struct matrix_data* b, uint64_t* c) {
+    size_t m = a->rows, n = b->cols, k = a->cols;
+    bool is_int = a->typecode == 'q';
+
+    micro_kernel_t kernel;
+    size_t nr;
+
+    if (use_avx2()) {
+        kernel = is_int ? &micro_kernel_i64_avx2 : &micro_kernel_f64_avx2;
+        nr = NR_AVX2;
+    }
+    else {
+        kernel = is_int ? &micro_kernel_i64_sse2 : &micro_kernel_f64_sse2;
+        nr = NR_SSE2;
+    }
+
+    // Blocks are never larger than the operands, which keeps small products cheap.
+    size_t mc_max = MIN(MC, (m + MR - 1) / MR * MR);
+    size_t kc_max = MIN(KC, k);
+    size_t nc_max = MIN(NC, (n + nr - 1) / nr * nr);
+
+    uint64_t* packed_a = mm_heap_alloc(mc_max * kc_max * sizeof(uint64_t));
+    uint64_t* packed_b = mm_heap_alloc(kc_max * nc_max * sizeof(uint64_t));
+
+    // Tiles at the bottom and right edges of the result are computed in here, and then
+    // copied to the result.
+    uint64_t edge[MR * NR_AVX2];
+
+    for (size_t jc = 0; jc < n; jc += NC) {
+        size_t nc = MIN(NC, n - jc);
+
+        for (size_t pc = 0; pc < k; pc += KC) {
+            size_t kc = MIN(KC, k - pc);
+            pack_b(element_at(b, pc, jc), b->row_stride, b->col_stride, kc, nc, nr, packed_b);
+
+            for (size_t ic = 0; ic < m; ic += MC) {
+                size_t mc = MIN(MC, m - ic);
+                pack_a(element_at(a, ic, pc), a->row_stride, a->col_stride, mc, kc, packed_a);
+
+                for (size_t jr = 0; jr < nc; jr += nr) {
+                    size_t cols = MIN(nr, nc - jr);
+
+                    for (size_t ir = 0; ir < mc; ir += MR) {
+                        size_t rows = MIN(MR, mc - ir);
+                        uint64_t* tile = &c[(ic + ir) * n + jc + jr];
+                        const uint64_t* panel_a = &packed_a[ir * kc];
+                        const uint64_t* panel_b = &packed_b[jr * kc];
+
+                        if (rows == MR && cols == nr) {
+                            kernel(kc, panel_a, panel_b, tile, n);
+                            continue;
+                        }
+
+                        memset(edge, 0, sizeof(edge));
+                        for (size_t r = 0; r < rows; r++) {
+                            memcpy(&edge[r * nr], &tile[r * n], cols * sizeof(uint64_t));
+                        }
+
+                        kernel(kc, panel_a, panel_b, edge, nr);
+
+                        for (size_t r = 0; r < rows; r++) {
+                            memcpy(&tile[r * n], &edge[r * nr], cols * sizeof(uint64_t));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    mm_heap_free(packed_a);
+    mm_heap_free(packed_b);
+}
+
+pyreturn_t py_matrix_matmul(pyobj_t* a, pyobj_t* b) {
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+
+    if (!PY_IS_MATRIX(a) || !PY_IS_MATRIX(b))
+        RAISE(TypeError, "unsupported operand type(s) for @");
+
+    const struct matrix_data* x = &a->as_matrix;
+    const struct matrix_data* y = &b->as_matrix;
+
+    if (x->typecode != y->typecode)
+        RAISE(TypeError, "matrices multiplied with @ must have the same typecode");
+
+    if (x->cols != y->rows)
+        RAISE(ValueError, "matrices multiplied with @ must have matching inner dimensions");
+
+    pyobj_t* result = py_alloc_matrix_of(x->typecode, x->rows, y->cols);
+    if (x->rows != 0 && y->cols != 0 && x->cols != 0) {
+        gemm(x, y, result->as_matrix.data);
+    }
+
+    return WITH_RESULT(result);
+}
+
+bool py_matrices_equal(pyobj_t* a, pyobj_t* b) {
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+    ASSERT(PY_IS_MATRIX(a) && PY_IS_MATRIX(b));
+
+    const struct matrix_data* x = &a->as_matrix;
+    const struct matrix_data* y = &b->as_matrix;
+
+    if (x->rows != y->rows || x->cols != y->cols)
+        return false;
+
+    for (size_t i = 0; i < x->rows; i++) {
+        for (size_t j = 0; j < x->cols; j++) {
+            uint64_t p = *element_at(x, i, j);
+            uint64_t q = *element_at(y, i, j);
+
+            if (x->typecode == 'q' && y->typecode == 'q') {
+                if (p != q)
+                    return false;
+
+                continue;
+            }
+
+            pyobj_t* exception = NULL;
+            if (!py_keys_equal(box_element(x->typecode, p), box_element(y->typecode, q), &exception))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+pyobj_t* py_matrix_tolist(pyobj_t* matrix) {
+    ENSURE_NOT_NULL(matrix);
+    ASSERT(PY_IS_MATRIX(matrix));
+
+    const struct matrix_data* m = &matrix->as_matrix;
+    pyobj_t* list = py_alloc_list(m->rows);
+
+    for (size_t i = 0; i < m->rows; i++) {
+        pyobj_t* row = py_alloc_list(m->cols);
+
+        for (size_t j = 0; j < m->cols; j++) {
+            py_list_append(row, box_element(m->typecode, *element_at(m, i, j)));
+        }
+
+        py_list_append(list, row);
+    }
+
+    return list;
+}
+
+string_t py_matrix_to_str(pyobj_t* matrix) {
+    ENSURE_NOT_NULL(matrix);
+    ASSERT(PY_IS_MATRIX(matrix));
+
+    const struct matrix_data* m = &matrix->as_matrix;
+    size_t n = m->rows * m->cols;
+
+    char* typecode = mm_heap_alloc(1);
+    typecode[0] = m->typecode;
+
+    // `matrix('`, the typecode, `', `, the shape and its separator, and then either `)`,
+    // or `, [`, the elements and their separators, and `])`.
+    string_t* parts = mm_heap_alloc(sizeof(string_t) * (n * 2 + 10));
+    int count = 0;
+
+    parts[count++] = STR("matrix('");
+    parts[count++] = (string_t) { .str = typecode, .length = 1 };
+    parts[count++] = STR("', ");
+    parts[count++] = py_stringify(py_alloc_int((int64_t)m->rows));
+    parts[count++] = STR(", ");
+    parts[count++] = py_stringify(py_alloc_int((int64_t)m->cols));
+
+    if (n != 0) {
+        parts[count++] = STR(", [");
+
+        for (size_t i = 0; i < m->rows; i++) {
+            for (size_t j = 0; j < m->cols; j++) {
+                if (i != 0 || j != 0) {
+                    parts[count++] = STR(", ");
+                }
+
+                parts[count++] = py_stringify(box_element(m->typecode, *element_at(m, i, j)));
+            }
+        }
+
+        parts[count++] = STR("]");
+    }
+
+    parts[count++] = STR(")");
+
+    string_t result = std_strconcat_array(parts, count);
+    mm_heap_free(parts);
+    return result;
+}
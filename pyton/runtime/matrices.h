@@ -0,0 +1,61 @@
+#pragma once
+
+#include "objects.h"
+#include "exceptions.h"
+
+// Python `matrix` objects, provided by the native `matrix` module, are two-dimensional
+// matrices of unboxed `d` (double precision floating-point) or `q` (signed 64-bit integer)
+// elements. The element at row `i` and column `j` is found at `i * row_stride + j * col_stride`
+// within `data` - matrices created from Python are stored in row-major order, while
+// `matrix.transpose()` returns a view that shares the storage, and swaps the strides.
+//
+// `a @ b` multiplies two matrices of the same typecode with a blocked GEMM kernel. Blocks of
+// both operands are first packed into contiguous panels that fit into the caches, and are
+// then multiplied with a register-tiled micro-kernel that uses SSE2, or AVX2 when the
+// processor supports it. Every element of the result is accumulated in order of `k`,
+// without fused multiply-adds, so that the results are the same in both variants, and match
+// the naive `sum(a[i][k] * b[k][j] for k in ...)`. Integer products wrap around at 64 bits,
+// like elementwise `array` arithmetic does. Transposed views are never copied into row-major
+// order - packing reads every block along whichever of its dimensions is contiguous, so e.g.
+// `a @ b.transpose()` is as fast as `a @ b`.
+
+// The type that represents the `matrix.matrix` Python class.
+extern pyobj_t py_type_matrix_matrix;
+
+// Evaluates to `true` if the given object is a `matrix`.
+#define PY_IS_MATRIX($x) (($x)->type == &py_type_matrix_matrix)
+
+// Implements `matrix(typecode, rows, cols, initializer)`, where `initializer` is an
+// iterable of the `rows * cols` elements in row-major order, or `NULL`, in which case
+// the matrix is zeroed. Returns an exception or the new `matrix`.
+pyreturn_t py_alloc_matrix(pyobj_t* typecode, pyobj_t* rows, pyobj_t* cols, pyobj_t* initializer);
+
+// Allocates a zeroed, row-major `matrix` of the given typecode and shape.
+pyobj_t* py_alloc_matrix_of(char typecode, size_t rows, size_t cols);
+
+// Returns a view of the given `matrix` with its rows and columns swapped. The view shares
+// the storage of the matrix.
+pyobj_t* py_matrix_transpose(pyobj_t* matrix);
+
+// Implements `matrix[i]`, returning a copy of row `i` as an `array`. Returns an exception
+// or the row.
+pyreturn_t py_matrix_row(pyobj_t* matrix, pyobj_t* index);
+
+// Implements `matrix.get(i, j)`. Returns an exception or the element.
+pyreturn_t py_matrix_get(pyobj_t* matrix, pyobj_t* i, pyobj_t* j);
+
+// Implements `matrix.set(i, j, value)`. Returns an exception or NULL.
+pyobj_t* py_matrix_set(pyobj_t* matrix, pyobj_t* i, pyobj_t* j, pyobj_t* value);
+
+// Implements `a @ b`. Returns an exception or the product.
+pyreturn_t py_matrix_matmul(pyobj_t* a, pyobj_t* b);
+
+// Implements `a == b`, where both operands are matrices.
+bool py_matrices_equal(pyobj_t* a, pyobj_t* b);
+
+// Implements `matrix.tolist()`, which returns a list of the rows, each being a list.
+pyobj_t* py_matrix_tolist(pyobj_t* matrix);
+
+// Converts the given `matrix` to its string representation, e.g.
+// `matrix('d', 2, 2, [1.0, 2.0, 3.0, 4.0])`.
+string_t py_matrix_to_str(pyobj_t* matrix);
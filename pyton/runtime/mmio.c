@@ -0,0 +1,19 @@
+#include "mmio.h"
+
+static pyobj_t small_values[PY_MMIO_SMALL_VALUES];
+
+pyobj_t* py_mmio_box(uint64_t value) {
+    if (value < PY_MMIO_SMALL_VALUES) {
+        // Python `int` objects are immutable, so the same one can be handed out for
+        // every read of the value.
+        pyobj_t* obj = &small_values[value];
+        obj->type = &py_type_int;
+        obj->as_int = (int64_t)value;
+        return obj;
+    }
+
+    if ((int64_t)value >= 0)
+        return py_alloc_int((int64_t)value);
+
+    return py_int_from_bytes((const uint8_t*)&value, 8, true, false);
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "objects.h"
+#include "ints.h"
+#include "fragments.h"
+#include "sys/mm.h"
+
+// Memory-mapped I/O. The `read8` to `read64` and `write8` to `write64` builtins access a
+// device register at a physical address with a single volatile load or store of the given
+// width, and `read_block` / `write_block` move whole ranges between physical memory and
+// buffers.
+//
+// Calls to the single-register builtins are compiled to inline accesses (see
+// `PY_MMIO_TRY_READ`), which take the address and value unboxed. Reads return the values
+// below `PY_MMIO_SMALL_VALUES` as preallocated objects, so that polling a register for a
+// flag doesn't allocate. Reads that are immediately masked or compared with a constant,
+// like `read32(STATUS) & READY`, apply the operation before boxing anything, so that they
+// don't allocate no matter the value of the register.
+
+// The number of values that reads return without allocating an `int` object.
+#define PY_MMIO_SMALL_VALUES 256
+
+// Returns an `int` object of the given value, read from a register. Values below
+// `PY_MMIO_SMALL_VALUES` are returned as preallocated objects.
+pyobj_t* py_mmio_box(uint64_t value);
+
+// Copies `length` bytes from `source` to `destination` with `rep movsb`.
+static inline void py_mmio_copy(void* destination, const void* source, size_t length) {
+    __asm__ volatile (
+        "rep movsb"
+        : "+D"(destination), "+S"(source), "+c"(length)
+        :
+        : "memory"
+    );
+}
+
+#define PY_MMIO_DEFINE_ACCESSORS($width)                                                    \
+    static inline uint##$width##_t py_mmio_read##$width(physaddr_t address) {               \
+        return *(volatile uint##$width##_t*)mm_phys_to_virt(address);                       \
+    }                                                                                       \
+                                                                                            \
+    static inline void py_mmio_write##$width(physaddr_t address, uint##$width##_t value) {  \
+        *(volatile uint##$width##_t*)mm_phys_to_virt(address) = value;                      \
+    }
+
+PY_MMIO_DEFINE_ACCESSORS(8)
+PY_MMIO_DEFINE_ACCESSORS(16)
+PY_MMIO_DEFINE_ACCESSORS(32)
+PY_MMIO_DEFINE_ACCESSORS(64)
+
+// Evaluates to `true` if `$x` is an `int` object that is a valid physical address. If
+// `$checked` is `false`, this is known at compile-time, and isn't checked.
+#define PY_MMIO_IS_ADDRESS($x, $checked) \
+    (!($checked) || (IS_MARSHALLABLE_INT($x) && ($x)->as_int >= 0))
+
+// Evaluates to `true` if `$x` is an `int` object that fits in an unsigned integer of
+// `$width` bits. If `$checked` is `false`, this is known at compile-time, and isn't checked.
+#define PY_MMIO_IS_VALUE($x, $width, $checked)                                  \
+    (                                                                           \
+        !($checked) || (                                                        \
+            IS_MARSHALLABLE_INT($x) && ($x)->as_int >= 0 &&                     \
+            (($width) == 64 || ($x)->as_int < (int64_t)(1ull << (($width) & 63))) \
+        )                                                                       \
+    )
+
+// Attempts to execute a `CALL 1` of the `read$width` builtin by loading the register
+// directly, and pushing the result. Evaluates to `false` if the call has to be made
+// regularly instead - which is the case when the called object is something else, or
+// the address isn't an `int` that can be passed as-is.
+#define PY_MMIO_TRY_READ($width, $checked) \
+    PY_MMIO_TRY_READ_THEN($width, $checked, py_mmio_box(mmio_value))
+
+// Equivalent to `PY_MMIO_TRY_READ`, followed by `& $mask`, where `$mask` is a non-negative
+// `int` constant. Only the result of the `&` is boxed.
+#define PY_MMIO_TRY_READ_AND($width, $checked, $mask) \
+    PY_MMIO_TRY_READ_THEN($width, $checked, py_mmio_box(mmio_value & (uint64_t)($mask)))
+
+// Equivalent to `PY_MMIO_TRY_READ`, followed by a comparison with `$constant`, which is a
+// non-negative `int` constant. `$op` is the C comparison operator.
+#define PY_MMIO_TRY_READ_COMPARE($width, $checked, $op, $constant)    \
+    PY_MMIO_TRY_READ_THEN(                                            \
+        $width, $checked,                                             \
+        (mmio_value $op (uint64_t)($constant)) ? &py_true : &py_false \
+    )
+
+// Implements `PY_MMIO_TRY_READ` and its variants. `$result` is the object that is pushed
+// in place of the call, computed from the register value in `mmio_value`.
+#define PY_MMIO_TRY_READ_THEN($width, $checked, $result)                            \
+    ({                                                                              \
+        bool mmio_done = false;                                                     \
+        pyobj_t* mmio_address = STACK_ITEM(1);                                      \
+        if (                                                                        \
+            PY_IS_FUNCTION_CALL(py_builtin_read##$width, 1) &&                      \
+            PY_MMIO_IS_ADDRESS(mmio_address, $checked)                              \
+        ) {                                                                         \
+            uint64_t mmio_value = py_mmio_read##$width((physaddr_t)mmio_address->as_int); \
+            stack_current -= 3;                                                     \
+            STACK_PUSH() = $result;                                                 \
+            mmio_done = true;                                                       \
+        }                                                                           \
+        mmio_done;                                                                  \
+    })
+
+// Equivalent to `PY_MMIO_TRY_READ`, but for a `CALL 2` of the `write$width` builtin.
+// `$checked_address` and `$checked_value` apply to the first and second argument.
+#define PY_MMIO_TRY_WRITE($width, $checked_address, $checked_value)                 \
+    ({                                                                              \
+        bool mmio_done = false;                                                     \
+        pyobj_t* mmio_address = STACK_ITEM(2);                                      \
+        pyobj_t* mmio_value = STACK_ITEM(1);                                        \
+        if (                                                                        \
+            PY_IS_FUNCTION_CALL(py_builtin_write##$width, 2) &&                     \
+            PY_MMIO_IS_ADDRESS(mmio_address, $checked_address) &&                   \
+            PY_MMIO_IS_VALUE(mmio_value, $width, $checked_value)                    \
+        ) {                                                                         \
+            py_mmio_write##$width(                                                  \
+                (physaddr_t)mmio_address->as_int,                                   \
+                (uint##$width##_t)mmio_value->as_int                                \
+            );                                                                      \
+            stack_current -= 4;                                                     \
+            STACK_PUSH() = &py_none;                                                \
+            mmio_done = true;                                                       \
+        }                                                                           \
+        mmio_done;                                                                  \
+    })
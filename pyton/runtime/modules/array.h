@@ -0,0 +1,12 @@
+#pragma once
+
+#include "../symbols.h"
+#include "../objects.h"
+#include "../arrays.h"
+
+// The native `array` module. Its only member, the `array` type, is imported via
+// `from array import array`, which the transpiler resolves to the `array_`-prefixed global
+// below. See `arrays.h` for the implementation of the type.
+
+// class array
+extern pyobj_t* KNOWN_GLOBAL(array_array);
@@ -0,0 +1,82 @@
+#include "asyncio.h"
+
+#include "../executor.h"
+#include "../exceptions.h"
+#include "../std/safety.h"
+#include "../sys/timer.h"
+#include "../sys/interrupts.h"
+
+// Converts a delay in seconds (an `int` or a `float`) to timer ticks, rounding up.
+static bool seconds_to_ticks(pyobj_t* delay, uint64_t* out_ticks) {
+    if (delay->type == &py_type_int) {
+        *out_ticks = delay->as_int <= 0 ? 0 : (uint64_t)delay->as_int * TIMER_HZ;
+        return true;
+    }
+
+    if (delay->type != &py_type_float)
+        return false;
+
+    double ticks = delay->as_float * TIMER_HZ;
+
+    if (!(ticks > 0)) {
+        *out_ticks = 0; // negative, zero, or NaN
+    }
+    else if (ticks >= 0x1p62) {
+        *out_ticks = UINT64_MAX / 2; // "forever", while leaving room for `now + ticks`
+    }
+    else {
+        uint64_t whole = (uint64_t)ticks;
+        *out_ticks = whole + ((double)whole < ticks);
+    }
+
+    return true;
+}
+
+DEFINE_FUNCTION_WRAPPER(py_asyncio_run, asyncio_run);
+PY_DEFINE(py_asyncio_run) {
+    if (argc != 1)
+        RAISE(TypeError, "run() takes exactly one argument");
+
+    return executor_run(NOT_NULL(argv)[0]);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_asyncio_sleep, asyncio_sleep);
+PY_DEFINE(py_asyncio_sleep) {
+    if (argc != 1)
+        RAISE(TypeError, "sleep() takes exactly one argument");
+
+    uint64_t ticks;
+    if (!seconds_to_ticks(NOT_NULL(argv)[0], &ticks))
+        RAISE(TypeError, "sleep() expects an int or a float");
+
+    return WITH_RESULT(executor_sleep_ticks(ticks));
+}
+
+DEFINE_FUNCTION_WRAPPER(py_asyncio_gather, asyncio_gather);
+PY_DEFINE(py_asyncio_gather) {
+    return executor_gather(argc, argv);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_asyncio_create_task, asyncio_create_task);
+PY_DEFINE(py_asyncio_create_task) {
+    if (argc != 1)
+        RAISE(TypeError, "create_task() takes exactly one argument");
+
+    return executor_spawn(NOT_NULL(argv)[0]);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_asyncio_wait_irq, asyncio_wait_irq);
+PY_DEFINE(py_asyncio_wait_irq) {
+    if (argc != 1)
+        RAISE(TypeError, "wait_irq() takes exactly one argument");
+
+    pyobj_t* irq = NOT_NULL(argv)[0];
+    if (irq->type != &py_type_int)
+        RAISE(TypeError, "wait_irq() expects an int");
+
+    // IRQ 0 is the system timer, and IRQ 2 is the cascade line of the secondary PIC.
+    if (irq->as_int < 0 || irq->as_int >= INT_IRQ_COUNT || irq->as_int == 0 || irq->as_int == 2)
+        RAISE(ValueError, "invalid IRQ line");
+
+    return WITH_RESULT(executor_wait_irq((int)irq->as_int));
+}
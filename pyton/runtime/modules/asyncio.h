@@ -0,0 +1,29 @@
+#pragma once
+
+#include "../functions.h"
+#include "../symbols.h"
+#include "../objects.h"
+
+// The native `asyncio` module. Its members are imported via `from asyncio import ...`,
+// which the transpiler resolves to the `asyncio_`-prefixed globals below. See `executor.h`
+// for the underlying implementation.
+
+// def run(coro)
+extern pyobj_t* KNOWN_GLOBAL(asyncio_run);
+PY_DEFINE(py_asyncio_run);
+
+// def sleep(delay)
+extern pyobj_t* KNOWN_GLOBAL(asyncio_sleep);
+PY_DEFINE(py_asyncio_sleep);
+
+// def gather(*aws)
+extern pyobj_t* KNOWN_GLOBAL(asyncio_gather);
+PY_DEFINE(py_asyncio_gather);
+
+// def create_task(coro)
+extern pyobj_t* KNOWN_GLOBAL(asyncio_create_task);
+PY_DEFINE(py_asyncio_create_task);
+
+// def wait_irq(irq)
+extern pyobj_t* KNOWN_GLOBAL(asyncio_wait_irq);
+PY_DEFINE(py_asyncio_wait_irq);
@@ -0,0 +1,249 @@
+#include "heapq.h"
+
+#include "../ints.h"
+#include "../lists.h"
+#include "../sorting.h"
+#include "../exceptions.h"
+#include "../std/string.h"
+#include "../std/safety.h"
+
+// Moves the item at `pos` towards the root, until its parent is not greater than it. Only
+// the items after `start` are considered. Returns an exception or NULL.
+static pyobj_t* sift_down(pyobj_t** heap, size_t start, size_t pos) {
+    pyobj_t* item = heap[pos];
+
+    while (pos > start) {
+        size_t parent_pos = (pos - 1) >> 1;
+        pyobj_t* parent = heap[parent_pos];
+
+        bool less;
+        pyobj_t* exception = py_sort_less_than(item, parent, &less);
+        if (exception != NULL) {
+            heap[pos] = item;
+            return exception;
+        }
+
+        if (!less)
+            break;
+
+        heap[pos] = parent;
+        pos = parent_pos;
+    }
+
+    heap[pos] = item;
+    return NULL;
+}
+
+// Moves the item at `pos` down to a leaf, by always promoting the smaller child, and then
+// back up to its place with `sift_down`. Returns an exception or NULL.
+static pyobj_t* sift_up(pyobj_t** heap, size_t n, size_t pos) {
+    size_t start = pos;
+    pyobj_t* item = heap[pos];
+    size_t child_pos = 2 * pos + 1;
+
+    while (child_pos < n) {
+        size_t right_pos = child_pos + 1;
+
+        if (right_pos < n) {
+            bool less;
+            pyobj_t* exception = py_sort_less_than(heap[child_pos], heap[right_pos], &less);
+            if (exception != NULL) {
+                heap[pos] = item;
+                return exception;
+            }
+
+            if (!less) {
+                child_pos = right_pos;
+            }
+        }
+
+        heap[pos] = heap[child_pos];
+        pos = child_pos;
+        child_pos = 2 * pos + 1;
+    }
+
+    heap[pos] = item;
+    return sift_down(heap, start, pos);
+}
+
+// Verifies that the first argument is a `list`.
+#define ENSURE_HEAP_ARG()                                   \
+    if (argv[0]->type != &py_type_list)                     \
+        RAISE(TypeError, "heap argument must be a list");
+
+DEFINE_FUNCTION_WRAPPER(py_heapq_heappush, heapq_heappush);
+PY_DEFINE(py_heapq_heappush) {
+    if (argc != 2)
+        RAISE(TypeError, "heappush() takes exactly two arguments");
+
+    ENSURE_NOT_NULL(argv);
+    ENSURE_HEAP_ARG();
+
+    pyobj_t* heap = argv[0];
+    py_list_append(heap, NOT_NULL(argv[1]));
+
+    pyobj_t* exception = sift_down(heap->as_list.elements, 0, heap->as_list.length - 1);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(&py_none);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_heapq_heappop, heapq_heappop);
+PY_DEFINE(py_heapq_heappop) {
+    if (argc != 1)
+        RAISE(TypeError, "heappop() takes exactly one argument");
+
+    ENSURE_NOT_NULL(argv);
+    ENSURE_HEAP_ARG();
+
+    pyobj_t* heap = argv[0];
+    if (heap->as_list.length == 0)
+        RAISE(IndexError, "index out of range");
+
+    pyobj_t** elements = heap->as_list.elements;
+    pyobj_t* last = elements[--heap->as_list.length];
+    if (heap->as_list.length == 0)
+        return WITH_RESULT(last);
+
+    pyobj_t* result = elements[0];
+    elements[0] = last;
+
+    pyobj_t* exception = sift_up(elements, heap->as_list.length, 0);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(result);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_heapq_heapify, heapq_heapify);
+PY_DEFINE(py_heapq_heapify) {
+    if (argc != 1)
+        RAISE(TypeError, "heapify() takes exactly one argument");
+
+    ENSURE_NOT_NULL(argv);
+    ENSURE_HEAP_ARG();
+
+    pyobj_t* heap = argv[0];
+    size_t n = heap->as_list.length;
+
+    for (size_t i = n / 2; i-- > 0;) {
+        pyobj_t* exception = sift_up(heap->as_list.elements, n, i);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+    }
+
+    return WITH_RESULT(&py_none);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_heapq_heapreplace, heapq_heapreplace);
+PY_DEFINE(py_heapq_heapreplace) {
+    if (argc != 2)
+        RAISE(TypeError, "heapreplace() takes exactly two arguments");
+
+    ENSURE_NOT_NULL(argv);
+    ENSURE_HEAP_ARG();
+
+    pyobj_t* heap = argv[0];
+    if (heap->as_list.length == 0)
+        RAISE(IndexError, "index out of range");
+
+    pyobj_t* result = heap->as_list.elements[0];
+    heap->as_list.elements[0] = NOT_NULL(argv[1]);
+
+    pyobj_t* exception = sift_up(heap->as_list.elements, heap->as_list.length, 0);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(result);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_heapq_heappushpop, heapq_heappushpop);
+PY_DEFINE(py_heapq_heappushpop) {
+    if (argc != 2)
+        RAISE(TypeError, "heappushpop() takes exactly two arguments");
+
+    ENSURE_NOT_NULL(argv);
+    ENSURE_HEAP_ARG();
+
+    pyobj_t* heap = argv[0];
+    pyobj_t* item = NOT_NULL(argv[1]);
+
+    if (heap->as_list.length == 0)
+        return WITH_RESULT(item);
+
+    // If the item is not greater than the smallest one, pushing it would pop it right away.
+    bool less;
+    pyobj_t* exception = py_sort_less_than(heap->as_list.elements[0], item, &less);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    if (!less)
+        return WITH_RESULT(item);
+
+    pyobj_t* result = heap->as_list.elements[0];
+    heap->as_list.elements[0] = item;
+
+    exception = sift_up(heap->as_list.elements, heap->as_list.length, 0);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(result);
+}
+
+// Implements both `nsmallest` (if `largest` is `false`) and `nlargest`, which return the
+// same items as `sorted(iterable, key = key, reverse = largest)[:n]`.
+static pyreturn_t n_extremes(int argc, pyobj_t** argv, int kwargc, symbol_t* kwargv, bool largest) {
+    if (argc != 2 && argc != 3)
+        RAISE(TypeError, "expected 2 or 3 arguments");
+
+    ENSURE_NOT_NULL(argv);
+
+    pyobj_t* key = argc == 3 ? NOT_NULL(argv[2]) : NULL;
+    if (kwargc == 1 && std_strequ(kwargv[0].name, STR("key"))) {
+        key = NOT_NULL(kwargv[0].value);
+    } else if (kwargc != 0) {
+        RAISE(TypeError, "unexpected keyword argument");
+    }
+
+    if (key == &py_none) {
+        key = NULL;
+    }
+
+    int64_t n;
+    pyobj_t* exception = py_int_as_index(NOT_NULL(argv[0]), &n);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    pyobj_t* iterable = NOT_NULL(argv[1]);
+    pyobj_t* list = py_alloc_list(py_length_hint(iterable));
+
+    exception = py_list_extend(list, iterable);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    if (n <= 0) {
+        list->as_list.length = 0;
+        return WITH_RESULT(list);
+    }
+
+    exception = py_sort(list->as_list.elements, list->as_list.length, key, largest);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    if ((size_t)n < list->as_list.length) {
+        list->as_list.length = (size_t)n;
+    }
+
+    return WITH_RESULT(list);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_heapq_nsmallest, heapq_nsmallest);
+PY_DEFINE(py_heapq_nsmallest) {
+    return n_extremes(argc, argv, kwargc, kwargv, false);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_heapq_nlargest, heapq_nlargest);
+PY_DEFINE(py_heapq_nlargest) {
+    return n_extremes(argc, argv, kwargc, kwargv, true);
+}
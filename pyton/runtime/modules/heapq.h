@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../functions.h"
+#include "../symbols.h"
+#include "../objects.h"
+
+// The native `heapq` module. Its members are imported via `from heapq import ...`, which
+// the transpiler resolves to the `heapq_`-prefixed globals below. Heaps are plain lists,
+// and the functions move items around exactly like CPython's do - so the same operations
+// yield the same lists. Items are compared with the sort engine (see `sorting.h`), and
+// `nsmallest` and `nlargest` sort the whole iterable with it.
+
+// def heappush(heap, item)
+extern pyobj_t* KNOWN_GLOBAL(heapq_heappush);
+PY_DEFINE(py_heapq_heappush);
+
+// def heappop(heap)
+extern pyobj_t* KNOWN_GLOBAL(heapq_heappop);
+PY_DEFINE(py_heapq_heappop);
+
+// def heapify(x)
+extern pyobj_t* KNOWN_GLOBAL(heapq_heapify);
+PY_DEFINE(py_heapq_heapify);
+
+// def heapreplace(heap, item)
+extern pyobj_t* KNOWN_GLOBAL(heapq_heapreplace);
+PY_DEFINE(py_heapq_heapreplace);
+
+// def heappushpop(heap, item)
+extern pyobj_t* KNOWN_GLOBAL(heapq_heappushpop);
+PY_DEFINE(py_heapq_heappushpop);
+
+// def nsmallest(n, iterable, key = None)
+extern pyobj_t* KNOWN_GLOBAL(heapq_nsmallest);
+PY_DEFINE(py_heapq_nsmallest);
+
+// def nlargest(n, iterable, key = None)
+extern pyobj_t* KNOWN_GLOBAL(heapq_nlargest);
+PY_DEFINE(py_heapq_nlargest);
@@ -0,0 +1,458 @@
+#include "math.h"
+
+#include "../ints.h"
+#include "../lists.h"
+#include "../exceptions.h"
+#include "../std/bigint.h"
+#include "../std/memory.h"
+#include "../std/safety.h"
+#include "../sys/mm.h"
+
+static pyobj_t math_pi_value = { .type = &py_type_float, .as_float = 3.141592653589793 };
+static pyobj_t math_e_value = { .type = &py_type_float, .as_float = 2.718281828459045 };
+static pyobj_t math_tau_value = { .type = &py_type_float, .as_float = 6.283185307179586 };
+static pyobj_t math_inf_value = { .type = &py_type_float, .as_float = __builtin_inf() };
+static pyobj_t math_nan_value = { .type = &py_type_float, .as_float = __builtin_nan("") };
+
+pyobj_t* KNOWN_GLOBAL(math_pi) = &math_pi_value;
+pyobj_t* KNOWN_GLOBAL(math_e) = &math_e_value;
+pyobj_t* KNOWN_GLOBAL(math_tau) = &math_tau_value;
+pyobj_t* KNOWN_GLOBAL(math_inf) = &math_inf_value;
+pyobj_t* KNOWN_GLOBAL(math_nan) = &math_nan_value;
+
+// Converts an `int`, `bool` or `float` argument to a `double`. Returns an exception or NULL.
+static pyobj_t* to_double(pyobj_t* x, double* out) {
+    if (x->type == &py_type_float) {
+        *out = x->as_float;
+        return NULL;
+    }
+
+    if (x->type == &py_type_bool) {
+        *out = x->as_bool ? 1.0 : 0.0;
+        return NULL;
+    }
+
+    if (x->type != &py_type_int)
+        return NEW_EXCEPTION_INLINE(TypeError, "must be real number");
+
+    if (!py_int_to_double(x, out))
+        return NEW_EXCEPTION_INLINE(OverflowError, "int too large to convert to float");
+
+    return NULL;
+}
+
+// Calls a kernel that takes a single argument. Raises a `ValueError` for arguments outside
+// of its domain, and, if `can_overflow` is `true`, an `OverflowError` for results that are
+// too large to be represented.
+static pyreturn_t call_kernel1(pyobj_t* arg, double (*kernel)(double), bool can_overflow) {
+    double x;
+    pyobj_t* exception = to_double(NOT_NULL(arg), &x);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    double result = kernel(x);
+    if (!py_math_is_regular(result, x, x)) {
+        if (can_overflow && __builtin_isinf(result))
+            RAISE(OverflowError, "math range error");
+
+        RAISE(ValueError, "math domain error");
+    }
+
+    return WITH_RESULT(py_alloc_float(result));
+}
+
+DEFINE_FUNCTION_WRAPPER(py_math_sqrt, math_sqrt);
+PY_DEFINE(py_math_sqrt) {
+    if (argc != 1)
+        RAISE(TypeError, "sqrt() takes exactly one argument");
+
+    ENSURE_NOT_NULL(argv);
+    return call_kernel1(argv[0], &std_sqrt, false);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_math_fabs, math_fabs);
+PY_DEFINE(py_math_fabs) {
+    if (argc != 1)
+        RAISE(TypeError, "fabs() takes exactly one argument");
+
+    ENSURE_NOT_NULL(argv);
+    return call_kernel1(argv[0], &std_fabs, false);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_math_exp, math_exp);
+PY_DEFINE(py_math_exp) {
+    if (argc != 1)
+        RAISE(TypeError, "exp() takes exactly one argument");
+
+    ENSURE_NOT_NULL(argv);
+    return call_kernel1(argv[0], &std_exp, true);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_math_sin, math_sin);
+PY_DEFINE(py_math_sin) {
+    if (argc != 1)
+        RAISE(TypeError, "sin() takes exactly one argument");
+
+    ENSURE_NOT_NULL(argv);
+    return call_kernel1(argv[0], &std_sin, false);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_math_cos, math_cos);
+PY_DEFINE(py_math_cos) {
+    if (argc != 1)
+        RAISE(TypeError, "cos() takes exactly one argument");
+
+    ENSURE_NOT_NULL(argv);
+    return call_kernel1(argv[0], &std_cos, false);
+}
+
+// Implements `floor` (where `kernel` is `std_floor`) and `ceil` (`std_ceil`), which return
+// an `int`.
+static pyreturn_t round_to_int(pyobj_t* x, double (*kernel)(double)) {
+    if (x->type == &py_type_int)
+        return WITH_RESULT(x);
+
+    if (x->type == &py_type_bool)
+        return WITH_RESULT(py_alloc_int(x->as_bool ? 1 : 0));
+
+    if (x->type != &py_type_float)
+        RAISE(TypeError, "must be real number");
+
+    double value = x->as_float;
+
+    if (__builtin_isnan(value))
+        RAISE(ValueError, "cannot convert float NaN to integer");
+
+    if (__builtin_isinf(value))
+        RAISE(OverflowError, "cannot convert float infinity to integer");
+
+    return WITH_RESULT(py_int_from_double(kernel(value)));
+}
+
+DEFINE_FUNCTION_WRAPPER(py_math_floor, math_floor);
+PY_DEFINE(py_math_floor) {
+    if (argc != 1)
+        RAISE(TypeError, "floor() takes exactly one argument");
+
+    ENSURE_NOT_NULL(argv);
+    return round_to_int(NOT_NULL(argv[0]), &std_floor);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_math_ceil, math_ceil);
+PY_DEFINE(py_math_ceil) {
+    if (argc != 1)
+        RAISE(TypeError, "ceil() takes exactly one argument");
+
+    ENSURE_NOT_NULL(argv);
+    return round_to_int(NOT_NULL(argv[0]), &std_ceil);
+}
+
+// The value CPython uses for ln(2) when computing the logarithms of large integers.
+#define LOG_2 0.6931471805599453
+
+// Computes the natural logarithm of `x`. Unlike with other functions, `int`s too large to
+// be converted to a `float` are accepted. Returns an exception or NULL.
+static pyobj_t* natural_log(pyobj_t* x, double* out) {
+    if (x->type == &py_type_int && !PY_INT_IS_SMALL(x)) {
+        const bigint_t* big = x->as_bigint;
+        if (big->negative)
+            return NEW_EXCEPTION_INLINE(ValueError, "math domain error");
+
+        double value;
+        if (!py_int_to_double(x, &value)) {
+            // x = m * 2^bits, where 0.5 <= m < 1 - and we take the top 64 bits of x as m.
+            size_t bits = std_bigint_bit_length(big);
+            bigint_t* top = std_bigint_rshift(big, bits - 64);
+            double m = (double)top->limbs[0] * 0x1p-64;
+
+            *out = std_log(m) + LOG_2 * (double)bits;
+            return NULL;
+        }
+    }
+
+    double value;
+    pyobj_t* exception = to_double(x, &value);
+    if (exception != NULL)
+        return exception;
+
+    *out = std_log(value);
+    if (!py_math_is_regular(*out, value, value))
+        return NEW_EXCEPTION_INLINE(ValueError, "math domain error");
+
+    return NULL;
+}
+
+DEFINE_FUNCTION_WRAPPER(py_math_log, math_log);
+PY_DEFINE(py_math_log) {
+    if (argc != 1 && argc != 2)
+        RAISE(TypeError, "log() takes 1 or 2 arguments");
+
+    ENSURE_NOT_NULL(argv);
+
+    double num = 0.0;
+    pyobj_t* exception = natural_log(NOT_NULL(argv[0]), &num);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    if (argc == 1)
+        return WITH_RESULT(py_alloc_float(num));
+
+    double den = 0.0;
+    exception = natural_log(NOT_NULL(argv[1]), &den);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    if (den == 0.0)
+        RAISE(ZeroDivisionError, "float division by zero");
+
+    return WITH_RESULT(py_alloc_float(num / den));
+}
+
+DEFINE_FUNCTION_WRAPPER(py_math_atan2, math_atan2);
+PY_DEFINE(py_math_atan2) {
+    if (argc != 2)
+        RAISE(TypeError, "atan2() takes exactly two arguments");
+
+    ENSURE_NOT_NULL(argv);
+
+    double y, x;
+    pyobj_t* exception = to_double(NOT_NULL(argv[0]), &y);
+    if (exception == NULL) {
+        exception = to_double(NOT_NULL(argv[1]), &x);
+    }
+
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(py_alloc_float(std_atan2(y, x)));
+}
+
+DEFINE_FUNCTION_WRAPPER(py_math_pow, math_pow);
+PY_DEFINE(py_math_pow) {
+    if (argc != 2)
+        RAISE(TypeError, "pow() takes exactly two arguments");
+
+    ENSURE_NOT_NULL(argv);
+
+    double x, y;
+    pyobj_t* exception = to_double(NOT_NULL(argv[0]), &x);
+    if (exception == NULL) {
+        exception = to_double(NOT_NULL(argv[1]), &y);
+    }
+
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    double result = std_pow(x, y);
+    if (!py_math_is_regular(result, x, y)) {
+        // 0 to a negative power is a division by zero, which is reported as a domain error.
+        if (__builtin_isinf(result) && x != 0.0)
+            RAISE(OverflowError, "math range error");
+
+        RAISE(ValueError, "math domain error");
+    }
+
+    return WITH_RESULT(py_alloc_float(result));
+}
+
+// Returns the integer square root of a non-negative big integer, via Newton's method.
+static bigint_t* bigint_isqrt(const bigint_t* n) {
+    // We start from a power of two that is not less than the root, from which the
+    // iterations decrease monotonically towards it.
+    size_t bits = std_bigint_bit_length(n);
+    bigint_t* x = std_bigint_lshift(std_bigint_from_i64(1), (bits + 1) / 2);
+
+    while (true) {
+        bigint_t* quotient;
+        std_bigint_divmod(n, x, &quotient, NULL);
+
+        bigint_t* y = std_bigint_rshift(std_bigint_add(x, quotient), 1);
+        if (std_bigint_compare(y, x) >= 0)
+            return x;
+
+        x = y;
+    }
+}
+
+DEFINE_FUNCTION_WRAPPER(py_math_isqrt, math_isqrt);
+PY_DEFINE(py_math_isqrt) {
+    if (argc != 1)
+        RAISE(TypeError, "isqrt() takes exactly one argument");
+
+    ENSURE_NOT_NULL(argv);
+    pyobj_t* n = NOT_NULL(argv[0]);
+
+    if (n->type == &py_type_bool)
+        return WITH_RESULT(py_alloc_int(n->as_bool ? 1 : 0));
+
+    if (n->type != &py_type_int)
+        RAISE(TypeError, "isqrt() argument must be an integer");
+
+    if (!PY_INT_IS_SMALL(n)) {
+        if (n->as_bigint->negative)
+            RAISE(ValueError, "isqrt() argument must be nonnegative");
+
+        return WITH_RESULT(py_alloc_bigint(bigint_isqrt(n->as_bigint)));
+    }
+
+    if (n->as_int < 0)
+        RAISE(ValueError, "isqrt() argument must be nonnegative");
+
+    // The square root of the nearest `double` is at most one off from the integer square
+    // root, and neither of the squares below can overflow, as the root is below 2^32.
+    uint64_t value = (uint64_t)n->as_int;
+    uint64_t root = (uint64_t)std_sqrt((double)value);
+
+    while (root * root > value) {
+        root--;
+    }
+
+    while ((root + 1) * (root + 1) <= value) {
+        root++;
+    }
+
+    return WITH_RESULT(py_alloc_int((int64_t)root));
+}
+
+// The number of partial sums `fsum` keeps on the stack. As the partials never overlap,
+// there can only be as many of them as there are 53-bit ranges of exponents - which means
+// that this is almost always enough.
+#define FSUM_PARTIALS 32
+
+DEFINE_FUNCTION_WRAPPER(py_math_fsum, math_fsum);
+PY_DEFINE(py_math_fsum) {
+    if (argc != 1)
+        RAISE(TypeError, "fsum() takes exactly one argument");
+
+    ENSURE_NOT_NULL(argv);
+
+    pyobj_t* iterable = NOT_NULL(argv[0]);
+    if (iterable->type != &py_type_list && iterable->type != &py_type_tuple) {
+        pyobj_t* list = py_alloc_list(py_length_hint(iterable));
+
+        pyobj_t* exception = py_list_extend(list, iterable);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        iterable = list;
+    }
+
+    // This is Shewchuk's algorithm, exactly like CPython implements it. The sum of all items
+    // so far is represented exactly by the non-overlapping partial sums in `partials`, in
+    // increasing order of magnitude.
+    double stack_partials[FSUM_PARTIALS];
+    double* partials = stack_partials;
+    size_t capacity = FSUM_PARTIALS;
+    size_t n = 0;
+
+    // The sum of all infinities, and the sum of all infinities and NaNs.
+    double inf_sum = 0.0;
+    double special_sum = 0.0;
+
+    double lo = 0.0;
+
+    for (size_t k = 0; k < iterable->as_list.length; k++) {
+        double x;
+        pyobj_t* exception = to_double(NOT_NULL(iterable->as_list.elements[k]), &x);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        double original = x;
+        size_t i = 0;
+
+        for (size_t j = 0; j < n; j++) {
+            double y = partials[j];
+
+            if (std_fabs(x) < std_fabs(y)) {
+                double t = x;
+                x = y;
+                y = t;
+            }
+
+            double hi = x + y;
+            lo = y - (hi - x);
+
+            if (lo != 0.0) {
+                partials[i++] = lo;
+            }
+
+            x = hi;
+        }
+
+        n = i;
+
+        if (x == 0.0)
+            continue;
+
+        if (__builtin_isinf(x) || __builtin_isnan(x)) {
+            // A non-finite sum either comes from a non-finite item, or is an overflow.
+            if (!__builtin_isinf(original) && !__builtin_isnan(original))
+                RAISE(OverflowError, "intermediate overflow in fsum");
+
+            if (__builtin_isinf(original)) {
+                inf_sum += original;
+            }
+
+            special_sum += original;
+            n = 0;
+            continue;
+        }
+
+        if (n == capacity) {
+            double* grown = mm_heap_alloc(capacity * 2 * sizeof(double));
+            memcpy(grown, partials, n * sizeof(double));
+
+            if (partials != stack_partials) {
+                mm_heap_free(partials);
+            }
+
+            partials = grown;
+            capacity *= 2;
+        }
+
+        partials[n++] = x;
+    }
+
+    if (special_sum != 0.0) {
+        if (__builtin_isnan(inf_sum))
+            RAISE(ValueError, "-inf + inf in fsum");
+
+        return WITH_RESULT(py_alloc_float(special_sum));
+    }
+
+    double hi = 0.0;
+
+    if (n > 0) {
+        // We sum the partials from the top, and stop as soon as the sum becomes inexact.
+        hi = partials[--n];
+
+        while (n > 0) {
+            double x = hi;
+            double y = partials[--n];
+
+            hi = x + y;
+            lo = y - (hi - x);
+
+            if (lo != 0.0)
+                break;
+        }
+
+        // When `hi + lo` is exactly halfway between two `double`s, `hi` has been rounded to
+        // even - but if the remaining partials push the sum further in the direction of
+        // `lo`, it has to be rounded the other way.
+        if (n > 0 && ((lo < 0.0 && partials[n - 1] < 0.0) || (lo > 0.0 && partials[n - 1] > 0.0))) {
+            double y = lo * 2.0;
+            double x = hi + y;
+
+            if (y == x - hi) {
+                hi = x;
+            }
+        }
+    }
+
+    if (partials != stack_partials) {
+        mm_heap_free(partials);
+    }
+
+    return WITH_RESULT(py_alloc_float(hi));
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "../functions.h"
+#include "../symbols.h"
+#include "../objects.h"
+#include "../std/fmath.h"
+
+// The native `math` module. Its members are imported via `from math import ...`, which
+// the transpiler resolves to the `math_`-prefixed globals below. The functions are thin
+// wrappers over the kernels in `std/fmath.h`, which raise the same exceptions CPython does
+// for arguments outside of their domain, and for results that overflow.
+//
+// Calls to the functions that take and return `float`s are also compiled to direct calls
+// of the kernels (see `PY_MATH_TRY_CALL1`), which skip the argument parsing, and only box
+// the result.
+
+// pi = 3.141592653589793
+extern pyobj_t* KNOWN_GLOBAL(math_pi);
+
+// e = 2.718281828459045
+extern pyobj_t* KNOWN_GLOBAL(math_e);
+
+// tau = 6.283185307179586
+extern pyobj_t* KNOWN_GLOBAL(math_tau);
+
+// inf = float("inf")
+extern pyobj_t* KNOWN_GLOBAL(math_inf);
+
+// nan = float("nan")
+extern pyobj_t* KNOWN_GLOBAL(math_nan);
+
+// def sqrt(x)
+extern pyobj_t* KNOWN_GLOBAL(math_sqrt);
+PY_DEFINE(py_math_sqrt);
+
+// def floor(x)
+extern pyobj_t* KNOWN_GLOBAL(math_floor);
+PY_DEFINE(py_math_floor);
+
+// def ceil(x)
+extern pyobj_t* KNOWN_GLOBAL(math_ceil);
+PY_DEFINE(py_math_ceil);
+
+// def fabs(x)
+extern pyobj_t* KNOWN_GLOBAL(math_fabs);
+PY_DEFINE(py_math_fabs);
+
+// def exp(x)
+extern pyobj_t* KNOWN_GLOBAL(math_exp);
+PY_DEFINE(py_math_exp);
+
+// def log(x, base = e)
+extern pyobj_t* KNOWN_GLOBAL(math_log);
+PY_DEFINE(py_math_log);
+
+// def sin(x)
+extern pyobj_t* KNOWN_GLOBAL(math_sin);
+PY_DEFINE(py_math_sin);
+
+// def cos(x)
+extern pyobj_t* KNOWN_GLOBAL(math_cos);
+PY_DEFINE(py_math_cos);
+
+// def atan2(y, x)
+extern pyobj_t* KNOWN_GLOBAL(math_atan2);
+PY_DEFINE(py_math_atan2);
+
+// def pow(x, y)
+extern pyobj_t* KNOWN_GLOBAL(math_pow);
+PY_DEFINE(py_math_pow);
+
+// def isqrt(n)
+extern pyobj_t* KNOWN_GLOBAL(math_isqrt);
+PY_DEFINE(py_math_isqrt);
+
+// def fsum(iterable)
+extern pyobj_t* KNOWN_GLOBAL(math_fsum);
+PY_DEFINE(py_math_fsum);
+
+// Returns `true` if `result`, computed by a kernel from the arguments `x` and `y`, is the
+// result of the corresponding Python function. That's not the case when a NaN or an
+// infinity arises from regular arguments, for which an exception has to be raised instead.
+static inline bool py_math_is_regular(double result, double x, double y) {
+    if (__builtin_isnan(result))
+        return __builtin_isnan(x) || __builtin_isnan(y);
+
+    if (__builtin_isinf(result))
+        return __builtin_isinf(x) || __builtin_isinf(y);
+
+    return true;
+}
+
+// Evaluates to `true` if the object called by a `CALL $argc` that is about to be executed
+// is the given function of this module.
+#define PY_MATH_IS_CALL($function, $argc) \
+    (STACK_ITEM(($argc) + 2) == KNOWN_GLOBAL(math_##$function))
+
+// Evaluates to `true` if `$x` is a `float` object. If `$checked` is `false`, the argument
+// is known to be a `float` at compile-time, and isn't checked.
+#define PY_MATH_IS_FLOAT($x, $checked) (!($checked) || ($x)->type == &py_type_float)
+
+// Attempts to execute a `CALL 1` of the function `$function` of this module by passing
+// its `float` argument to the kernel `$kernel` directly, and pushing the boxed result.
+// Evaluates to `false` if the call has to be made regularly instead - which is the case
+// when the called object is something else, the argument isn't a `float`, or the result
+// is an error.
+#define PY_MATH_TRY_CALL1($function, $kernel, $checked)                                   \
+    ({                                                                                  \
+        bool math_done = false;                                                         \
+        pyobj_t* math_x = STACK_ITEM(1);                                                \
+        if (PY_MATH_IS_CALL($function, 1) && PY_MATH_IS_FLOAT(math_x, $checked)) {      \
+            double math_result = $kernel(math_x->as_float);                             \
+            if (py_math_is_regular(math_result, math_x->as_float, math_x->as_float)) {  \
+                stack_current -= 3;                                                     \
+                STACK_PUSH() = py_alloc_float(math_result);                             \
+                math_done = true;                                                       \
+            }                                                                           \
+        }                                                                               \
+        math_done;                                                                      \
+    })
+
+// Equivalent to `PY_MATH_TRY_CALL1`, but for a `CALL 2` of a function that takes two
+// `float` arguments. `$checked_x` and `$checked_y` apply to the first and second one.
+#define PY_MATH_TRY_CALL2($function, $kernel, $checked_x, $checked_y)                     \
+    ({                                                                                  \
+        bool math_done = false;                                                         \
+        pyobj_t* math_x = STACK_ITEM(2);                                                \
+        pyobj_t* math_y = STACK_ITEM(1);                                                \
+        if (                                                                            \
+            PY_MATH_IS_CALL($function, 2) &&                                            \
+            PY_MATH_IS_FLOAT(math_x, $checked_x) &&                                     \
+            PY_MATH_IS_FLOAT(math_y, $checked_y)                                        \
+        ) {                                                                             \
+            double math_result = $kernel(math_x->as_float, math_y->as_float);           \
+            if (py_math_is_regular(math_result, math_x->as_float, math_y->as_float)) {  \
+                stack_current -= 4;                                                     \
+                STACK_PUSH() = py_alloc_float(math_result);                             \
+                math_done = true;                                                       \
+            }                                                                           \
+        }                                                                               \
+        math_done;                                                                      \
+    })
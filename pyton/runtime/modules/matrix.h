@@ -0,0 +1,12 @@
+#pragma once
+
+#include "../symbols.h"
+#include "../objects.h"
+#include "../matrices.h"
+
+// The native `matrix` module. Its only member, the `matrix` type, is imported via
+// `from matrix import matrix`, which the transpiler resolves to the `matrix_`-prefixed
+// global below. See `matrices.h` for the implementation of the type.
+
+// class matrix
+extern pyobj_t* KNOWN_GLOBAL(matrix_matrix);
@@ -0,0 +1,747 @@
+#include "struct.h"
+
+#include "../classes.h"
+#include "../lists.h"
+#include "../opcodes.h"
+#include "../std/memory.h"
+#include "../std/safety.h"
+#include "../std/string.h"
+#include "../sys/mm.h"
+
+CLASS(struct_error)
+    CLASS_ATTRIBUTES_E(_struct_error, "error")
+    END_CLASS_ATTRIBUTES;
+DEFINE_BUILTIN_TYPE_E(_struct_error, &py_type_Exception)
+
+// A single field of a parsed format, which produces or consumes one value. Padding bytes
+// (`x`) do not have fields.
+typedef struct struct_field {
+    // The format character of the field.
+    char code;
+
+    // The offset of the field, in bytes.
+    uint32_t offset;
+
+    // The size of the field, in bytes. For `s` and `p`, this is the length of the string.
+    uint32_t size;
+} struct_field_t;
+
+// A parsed format string.
+typedef struct struct_layout {
+    // The total size of the format, in bytes, as returned by `calcsize`.
+    size_t size;
+
+    // The number of values the format packs or unpacks.
+    size_t count;
+
+    // `true` if multi-byte values are stored in little-endian order.
+    bool little_endian;
+
+    // The fields of the format, in order. There are `count` of them.
+    struct_field_t* fields;
+} struct_layout_t;
+
+// The number of parsed formats kept in `format_cache`. Formats are placed in the cache by
+// the hash of their contents.
+#define FORMAT_CACHE_SIZE 32
+
+typedef struct format_cache_entry {
+    uint64_t hash;
+    string_t format;
+    struct_layout_t* layout;
+} format_cache_entry_t;
+
+static format_cache_entry_t format_cache[FORMAT_CACHE_SIZE];
+
+// Returns the size of a value of the given format character, or 0 if the character isn't
+// valid. `native` is `true` when the format uses native sizes and alignment (`@`).
+static size_t field_width(char code, bool native) {
+    switch (code) {
+        case 'x': case 'c': case 'b': case 'B': case '?': case 's': case 'p': return 1;
+        case 'h': case 'H': case 'e': return 2;
+        case 'i': case 'I': case 'f': return 4;
+        case 'l': case 'L': return native ? 8 : 4;
+        case 'q': case 'Q': case 'd': return 8;
+        case 'n': case 'N': case 'P': return native ? 8 : 0;
+        default: return 0;
+    }
+}
+
+// Scans the given format string, setting the size, count and byte order of `layout`. If
+// `fields` is not `NULL`, also fills it with the fields of the format. Returns `false` if
+// the format is not valid.
+static bool scan_format(string_t format, struct_layout_t* layout, struct_field_t* fields) {
+    int i = 0;
+    bool native = true;
+    bool little_endian = true;
+
+    if (format.length > 0) {
+        switch (format.str[0]) {
+            case '@': i = 1; break;
+            case '=': case '<': native = false; i = 1; break;
+            case '>': case '!': native = false; little_endian = false; i = 1; break;
+        }
+    }
+
+    size_t size = 0;
+    size_t count = 0;
+
+    while (i < format.length) {
+        char code = format.str[i];
+
+        if (code == ' ' || code == '\t' || code == '\n' || code == '\r') {
+            i++;
+            continue;
+        }
+
+        size_t repeat = 1;
+        if (code >= '0' && code <= '9') {
+            repeat = 0;
+
+            while (i < format.length && format.str[i] >= '0' && format.str[i] <= '9') {
+                repeat = repeat * 10 + (format.str[i] - '0');
+                if (repeat > UINT32_MAX / 16)
+                    return false;
+
+                i++;
+            }
+
+            if (i == format.length)
+                return false; // a repeat count without a format character
+
+            code = format.str[i];
+        }
+
+        i++;
+
+        size_t width = field_width(code, native);
+        if (width == 0)
+            return false;
+
+        if (native) {
+            size = (size + width - 1) / width * width;
+        }
+
+        if (code == 's' || code == 'p') {
+            if (fields != NULL) {
+                fields[count] = (struct_field_t) { .code = code, .offset = size, .size = repeat };
+            }
+
+            count++;
+            size += repeat;
+        }
+        else if (code == 'x') {
+            size += repeat;
+        }
+        else {
+            for (size_t j = 0; j < repeat; j++) {
+                if (fields != NULL) {
+                    fields[count] = (struct_field_t) { .code = code, .offset = size, .size = width };
+                }
+
+                count++;
+                size += width;
+            }
+        }
+
+        if (size > UINT32_MAX)
+            return false;
+    }
+
+    layout->size = size;
+    layout->count = count;
+    layout->little_endian = little_endian;
+    return true;
+}
+
+// Resolves the given format string (a `str` or a `bytes` object) to its layout, parsing it
+// if it isn't in `format_cache` yet. Returns an exception or NULL.
+static pyobj_t* get_layout(pyobj_t* format, struct_layout_t** out_layout) {
+    string_t text;
+
+    if (format->type == &py_type_str) {
+        text = format->as_str;
+    }
+    else if (format->type == &py_type_bytes) {
+        uint8_t* data;
+        size_t length;
+        py_get_buffer(format, &data, &length);
+        text = (string_t) { .str = (const char*)data, .length = (int)length };
+    }
+    else {
+        return NEW_EXCEPTION_INLINE(TypeError, "the format must be a str or a bytes object");
+    }
+
+    uint64_t hash = std_strhash(text);
+    format_cache_entry_t* entry = &format_cache[hash % FORMAT_CACHE_SIZE];
+
+    if (entry->layout != NULL && entry->hash == hash && std_strequ(entry->format, text)) {
+        *out_layout = entry->layout;
+        return NULL;
+    }
+
+    struct_layout_t* layout = mm_heap_alloc(sizeof(struct_layout_t));
+    if (!scan_format(text, layout, NULL)) {
+        mm_heap_free(layout);
+        return NEW_EXCEPTION_INLINE(struct_error, "bad char in struct format");
+    }
+
+    layout->fields = layout->count == 0 ? NULL : mm_heap_alloc(layout->count * sizeof(struct_field_t));
+    scan_format(text, layout, layout->fields);
+
+    // The format string might be a `str` that is appended to in-place later on, so the
+    // cache keeps its own copy of it.
+    char* copy = text.length == 0 ? NULL : mm_heap_alloc(text.length);
+    if (copy != NULL) {
+        memcpy(copy, text.str, text.length);
+    }
+
+    if (entry->layout != NULL) {
+        if (entry->layout->fields != NULL) {
+            mm_heap_free(entry->layout->fields);
+        }
+
+        if (entry->format.str != NULL) {
+            mm_heap_free((void*)entry->format.str);
+        }
+
+        mm_heap_free(entry->layout);
+    }
+
+    *entry = (format_cache_entry_t) {
+        .hash = hash,
+        .format = { .str = copy, .length = text.length },
+        .layout = layout
+    };
+
+    *out_layout = layout;
+    return NULL;
+}
+
+// Returns the decimal representation of the given integer.
+static string_t decimal(int64_t x) {
+    return py_int_to_decimal(py_alloc_int(x));
+}
+
+// Creates a `struct.error` with a message made up of the given parts.
+static pyobj_t* new_struct_error(const string_t* parts, int count) {
+    return NEW_EXCEPTION(&py_type_struct_error, py_alloc_str(std_strconcat_array(parts, count)));
+}
+
+// Converts an IEEE 754 half-precision value to a `double`.
+static double half_to_double(uint16_t half) {
+    uint64_t sign = (uint64_t)(half >> 15) << 63;
+    uint32_t exponent = (half >> 10) & 0x1F;
+    uint64_t mantissa = half & 0x3FF;
+
+    if (exponent == 0) {
+        double x = (double)mantissa * 0x1p-24;
+        return sign != 0 ? -x : x;
+    }
+
+    uint64_t bits = sign | (mantissa << 42);
+    bits |= (exponent == 0x1F ? 0x7FFull : (uint64_t)(exponent - 15 + 1023)) << 52;
+
+    double x;
+    memcpy(&x, &bits, 8);
+    return x;
+}
+
+// Converts a `double` to an IEEE 754 half-precision value, rounding to the nearest value,
+// and ties to even. Returns `false` if the value is finite, but too large to be represented.
+static bool double_to_half(double x, uint16_t* out) {
+    uint64_t bits;
+    memcpy(&bits, &x, 8);
+
+    uint16_t sign = (bits >> 48) & 0x8000;
+    int exponent = (int)((bits >> 52) & 0x7FF);
+    uint64_t mantissa = bits & ((1ull << 52) - 1);
+
+    if (exponent == 0x7FF) {
+        *out = sign | (mantissa != 0 ? 0x7E00 : 0x7C00);
+        return true;
+    }
+
+    if (exponent == 0) {
+        *out = sign; // zero, or a double subnormal, which is far below the half-precision range
+        return true;
+    }
+
+    exponent -= 1023;
+    mantissa |= 1ull << 52;
+
+    // Normal values keep 11 significant bits, while subnormal ones are multiples of 2^-24.
+    int shift = exponent >= -14 ? 42 : 28 - exponent;
+    if (shift >= 64) {
+        *out = sign;
+        return true;
+    }
+
+    uint64_t result = mantissa >> shift;
+    uint64_t remainder = mantissa & ((1ull << shift) - 1);
+    uint64_t halfway = 1ull << (shift - 1);
+
+    if (remainder > halfway || (remainder == halfway && (result & 1) != 0)) {
+        result++;
+    }
+
+    if (exponent < -14) {
+        *out = sign | (uint16_t)result; // rounding up to 0x400 results in the smallest normal
+        return true;
+    }
+
+    if (result == (1ull << 11)) {
+        result >>= 1;
+        exponent++;
+    }
+
+    if (exponent > 15)
+        return false;
+
+    *out = sign | (uint16_t)((exponent + 15) << 10) | (uint16_t)(result & 0x3FF);
+    return true;
+}
+
+// Converts the given `int` or `float` object to a `double`, for the `e`, `f` and `d` format
+// characters. Returns an exception or NULL.
+static pyobj_t* float_value(pyobj_t* x, double* out) {
+    if (x->type == &py_type_float) {
+        *out = x->as_float;
+        return NULL;
+    }
+
+    if (x->type == &py_type_int) {
+        if (!py_int_to_double(x, out))
+            return NEW_EXCEPTION_INLINE(OverflowError, "int too large to convert to float");
+
+        return NULL;
+    }
+
+    return NEW_EXCEPTION_INLINE(struct_error, "required argument is not a float");
+}
+
+pyobj_t* py_struct_store_int_slow(
+    uint8_t* data,
+    size_t size,
+    bool is_signed,
+    bool little_endian,
+    char code,
+    pyobj_t* x
+) {
+    if (x->type == &py_type_bool) {
+        py_struct_store(data, size, little_endian, x->as_bool);
+        return NULL;
+    }
+
+    if (x->type != &py_type_int)
+        return NEW_EXCEPTION_INLINE(struct_error, "required argument is not an integer");
+
+    if (py_int_to_bytes(x, data, size, little_endian, is_signed) == NULL)
+        return NULL;
+
+    string_t min, max;
+    if (!is_signed) {
+        min = STR("0");
+        max = size == 8 ? STR("18446744073709551615") : decimal(((int64_t)1 << (size * 8)) - 1);
+    }
+    else if (size == 8) {
+        min = STR("-9223372036854775808");
+        max = STR("9223372036854775807");
+    }
+    else {
+        min = decimal(-((int64_t)1 << (size * 8 - 1)));
+        max = decimal(((int64_t)1 << (size * 8 - 1)) - 1);
+    }
+
+    char* quoted = mm_heap_alloc(3);
+    quoted[0] = '\'';
+    quoted[1] = code;
+    quoted[2] = '\'';
+
+    string_t parts[] = {
+        { .str = quoted, .length = 3 }, STR(" format requires "),
+        min, STR(" <= number <= "), max
+    };
+
+    return new_struct_error(parts, 5);
+}
+
+pyobj_t* py_struct_store_float(uint8_t* data, size_t size, bool little_endian, pyobj_t* x) {
+    double value;
+    pyobj_t* exception = float_value(x, &value);
+    if (exception != NULL)
+        return exception;
+
+    if (size == 4) {
+        float narrowed = (float)value;
+        if (__builtin_isinf(narrowed) && !__builtin_isinf(value))
+            return NEW_EXCEPTION_INLINE(OverflowError, "float too large to pack with f format");
+
+        uint32_t bits;
+        memcpy(&bits, &narrowed, 4);
+        py_struct_store(data, 4, little_endian, bits);
+    }
+    else {
+        uint64_t bits;
+        memcpy(&bits, &value, 8);
+        py_struct_store(data, 8, little_endian, bits);
+    }
+
+    return NULL;
+}
+
+pyobj_t* py_struct_store_bool(uint8_t* data, pyobj_t* x) {
+    void* local[1] = { x };
+    int local_current = 0;
+
+    pyobj_t* exception = py_opcode_to_bool(local, &local_current);
+    if (exception != NULL)
+        return exception;
+
+    data[0] = ((pyobj_t*)local[0])->as_bool;
+    return NULL;
+}
+
+pyobj_t* py_struct_store_bytes(uint8_t* data, size_t size, bool is_char, pyobj_t* x) {
+    uint8_t* bytes;
+    size_t length;
+
+    bool valid = (x->type == &py_type_bytes || x->type == &py_type_bytearray) &&
+        py_get_buffer(x, &bytes, &length) &&
+        (!is_char || length == 1);
+
+    if (!valid) {
+        if (is_char)
+            return NEW_EXCEPTION_INLINE(struct_error, "char format requires a bytes object of length 1");
+
+        return NEW_EXCEPTION_INLINE(struct_error, "argument for 's' must be a bytes object");
+    }
+
+    size_t copied = length < size ? length : size;
+    memcpy(data, bytes, copied);
+    memset(data + copied, 0, size - copied);
+    return NULL;
+}
+
+// Stores the bytes-like object `x` as a Pascal string in the `size` bytes at `data`, like
+// the `p` format character. Returns an exception or NULL.
+static pyobj_t* store_pascal(uint8_t* data, size_t size, pyobj_t* x) {
+    uint8_t* bytes;
+    size_t length;
+
+    if ((x->type != &py_type_bytes && x->type != &py_type_bytearray) || !py_get_buffer(x, &bytes, &length))
+        return NEW_EXCEPTION_INLINE(struct_error, "argument for 'p' must be a bytes object");
+
+    if (size == 0)
+        return NULL;
+
+    size_t copied = length < size - 1 ? length : size - 1;
+    data[0] = copied < 255 ? (uint8_t)copied : 255;
+    memcpy(data + 1, bytes, copied);
+    memset(data + 1 + copied, 0, size - 1 - copied);
+    return NULL;
+}
+
+pyobj_t* py_struct_locate(
+    pyobj_t* buffer,
+    pyobj_t* offset,
+    size_t size,
+    bool exact,
+    bool writable,
+    uint8_t** out_data
+) {
+    uint8_t* data;
+    size_t length;
+
+    if (!py_get_buffer(buffer, &data, &length))
+        return NEW_EXCEPTION_INLINE(TypeError, "a bytes-like object is required");
+
+    if (writable && buffer->as_buffer.readonly)
+        return NEW_EXCEPTION_INLINE(TypeError, "argument must be read-write bytes-like object");
+
+    if (exact) {
+        if (length != size) {
+            string_t parts[] = { STR("unpack requires a buffer of "), decimal(size), STR(" bytes") };
+            return new_struct_error(parts, 3);
+        }
+
+        *out_data = data;
+        return NULL;
+    }
+
+    int64_t start = 0;
+    if (offset != NULL) {
+        pyobj_t* exception = py_int_as_index(offset, &start);
+        if (exception != NULL)
+            return exception;
+
+        if (start < 0) {
+            if (start + (int64_t)length < 0)
+                return NEW_EXCEPTION_INLINE(struct_error, "offset out of range");
+
+            start += length;
+        }
+    }
+
+    if ((size_t)start > length || length - (size_t)start < size) {
+        string_t parts[] = {
+            writable ? STR("pack_into requires a buffer of at least ") : STR("unpack_from requires a buffer of at least "),
+            decimal(size + start),
+            STR(" bytes")
+        };
+
+        return new_struct_error(parts, 3);
+    }
+
+    *out_data = data + start;
+    return NULL;
+}
+
+pyobj_t* py_struct_alloc_packed(size_t size, uint8_t** out_data) {
+    uint8_t* data = size == 0 ? NULL : mm_heap_alloc(size);
+    if (data != NULL) {
+        memset(data, 0, size);
+    }
+
+    *out_data = data;
+    return py_alloc_bytes_view(data, size);
+}
+
+// Converts the field of the given layout, stored in a run of bytes starting at `data`, to
+// a Python object.
+static pyobj_t* unpack_field(const struct_layout_t* layout, const struct_field_t* field, const uint8_t* data) {
+    const uint8_t* at = data + field->offset;
+
+    switch (field->code) {
+        case 'c':
+        case 's':
+            return py_alloc_bytes(at, field->size);
+        case 'p': {
+            if (field->size == 0)
+                return py_alloc_bytes(NULL, 0);
+
+            size_t length = at[0] < field->size ? at[0] : field->size - 1;
+            return py_alloc_bytes(at + 1, length);
+        }
+        case '?':
+            return AS_PY_BOOL(at[0] != 0);
+        case 'e':
+            return py_alloc_float(half_to_double((uint16_t)py_struct_load(at, 2, layout->little_endian)));
+        case 'f':
+        case 'd':
+            return py_struct_box_float(py_struct_load(at, field->size, layout->little_endian), field->size);
+        default: {
+            bool is_signed = field->code >= 'a' && field->code <= 'z';
+            return py_struct_box_int(py_struct_load(at, field->size, layout->little_endian), field->size, is_signed);
+        }
+    }
+}
+
+// Stores `x` as the field of the given layout, in a run of bytes starting at `data`. Returns
+// an exception or NULL.
+static pyobj_t* pack_field(const struct_layout_t* layout, const struct_field_t* field, uint8_t* data, pyobj_t* x) {
+    uint8_t* at = data + field->offset;
+
+    switch (field->code) {
+        case 'c':
+            return py_struct_store_bytes(at, 1, true, x);
+        case 's':
+            return py_struct_store_bytes(at, field->size, false, x);
+        case 'p':
+            return store_pascal(at, field->size, x);
+        case '?':
+            return py_struct_store_bool(at, x);
+        case 'e': {
+            double value;
+            uint16_t half;
+
+            pyobj_t* exception = float_value(x, &value);
+            if (exception != NULL)
+                return exception;
+
+            if (!double_to_half(value, &half))
+                return NEW_EXCEPTION_INLINE(OverflowError, "float too large to pack with e format");
+
+            py_struct_store(at, 2, layout->little_endian, half);
+            return NULL;
+        }
+        case 'f':
+        case 'd':
+            return py_struct_store_float(at, field->size, layout->little_endian, x);
+        default: {
+            bool is_signed = field->code >= 'a' && field->code <= 'z';
+            return py_struct_store_int(at, field->size, is_signed, layout->little_endian, field->code, x);
+        }
+    }
+}
+
+// Packs `values` according to the given layout into a run of bytes starting at `data`. Returns
+// an exception or NULL.
+static pyobj_t* pack_values(const struct_layout_t* layout, uint8_t* data, pyobj_t** values) {
+    for (size_t i = 0; i < layout->count; i++) {
+        pyobj_t* exception = pack_field(layout, &layout->fields[i], data, values[i]);
+        if (exception != NULL)
+            return exception;
+    }
+
+    return NULL;
+}
+
+// Unpacks a tuple of values according to the given layout from the bytes at `data`.
+static pyobj_t* unpack_values(const struct_layout_t* layout, const uint8_t* data) {
+    pyobj_t* tuple = py_alloc_tuple(layout->count);
+
+    for (size_t i = 0; i < layout->count; i++) {
+        tuple->as_list.elements[i] = unpack_field(layout, &layout->fields[i], data);
+    }
+
+    return tuple;
+}
+
+// Creates the `struct.error` raised when a function that packs values is given the wrong
+// number of them.
+static pyobj_t* new_count_error(string_t function, size_t expected, size_t given) {
+    string_t parts[] = {
+        function, STR(" expected "), decimal(expected),
+        STR(" items for packing (got "), decimal(given), STR(")")
+    };
+
+    return new_struct_error(parts, 6);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_struct_calcsize, struct_calcsize);
+PY_DEFINE(py_struct_calcsize) {
+    if (argc != 1)
+        RAISE(TypeError, "calcsize() takes exactly one argument");
+
+    struct_layout_t* layout;
+    pyobj_t* exception = get_layout(NOT_NULL(argv)[0], &layout);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(py_alloc_int((int64_t)layout->size));
+}
+
+DEFINE_FUNCTION_WRAPPER(py_struct_pack, struct_pack);
+PY_DEFINE(py_struct_pack) {
+    if (argc < 1)
+        RAISE(TypeError, "pack() missing required argument 'format'");
+
+    struct_layout_t* layout;
+    pyobj_t* exception = get_layout(NOT_NULL(argv)[0], &layout);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    if ((size_t)argc - 1 != layout->count)
+        return WITH_EXCEPTION(new_count_error(STR("pack"), layout->count, argc - 1));
+
+    uint8_t* data;
+    pyobj_t* bytes = py_struct_alloc_packed(layout->size, &data);
+
+    exception = pack_values(layout, data, argv + 1);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(bytes);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_struct_pack_into, struct_pack_into);
+PY_DEFINE(py_struct_pack_into) {
+    if (argc < 3)
+        RAISE(TypeError, "pack_into() expects a format, a buffer and an offset");
+
+    struct_layout_t* layout;
+    pyobj_t* exception = get_layout(NOT_NULL(argv)[0], &layout);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    if ((size_t)argc - 3 != layout->count)
+        return WITH_EXCEPTION(new_count_error(STR("pack_into"), layout->count, argc - 3));
+
+    uint8_t* data;
+    exception = py_struct_locate(argv[1], argv[2], layout->size, false, true, &data);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    memset(data, 0, layout->size);
+
+    exception = pack_values(layout, data, argv + 3);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(&py_none);
+}
+
+DEFINE_FUNCTION_WRAPPER(py_struct_unpack, struct_unpack);
+PY_DEFINE(py_struct_unpack) {
+    if (argc != 2)
+        RAISE(TypeError, "unpack() takes exactly two arguments");
+
+    struct_layout_t* layout;
+    pyobj_t* exception = get_layout(NOT_NULL(argv)[0], &layout);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    uint8_t* data;
+    exception = py_struct_locate(argv[1], NULL, layout->size, true, false, &data);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(unpack_values(layout, data));
+}
+
+DEFINE_FUNCTION_WRAPPER(py_struct_unpack_from, struct_unpack_from);
+PY_DEFINE(py_struct_unpack_from) {
+    if (argc != 2 && argc != 3)
+        RAISE(TypeError, "unpack_from() takes two or three arguments");
+
+    struct_layout_t* layout;
+    pyobj_t* exception = get_layout(NOT_NULL(argv)[0], &layout);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    uint8_t* data;
+    exception = py_struct_locate(argv[1], argc == 3 ? argv[2] : NULL, layout->size, false, false, &data);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(unpack_values(layout, data));
+}
+
+DEFINE_FUNCTION_WRAPPER(py_struct_iter_unpack, struct_iter_unpack);
+PY_DEFINE(py_struct_iter_unpack) {
+    if (argc != 2)
+        RAISE(TypeError, "iter_unpack() takes exactly two arguments");
+
+    struct_layout_t* layout;
+    pyobj_t* exception = get_layout(NOT_NULL(argv)[0], &layout);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    uint8_t* data;
+    size_t length;
+    if (!py_get_buffer(argv[1], &data, &length))
+        RAISE(TypeError, "a bytes-like object is required");
+
+    if (layout->size == 0)
+        RAISE(struct_error, "cannot iteratively unpack with a struct of length 0");
+
+    if (length % layout->size != 0) {
+        string_t parts[] = {
+            STR("iterative unpacking requires a buffer of a multiple of "),
+            decimal(layout->size), STR(" bytes")
+        };
+
+        return WITH_EXCEPTION(new_struct_error(parts, 3));
+    }
+
+    // Unlike in CPython, all records are unpacked up-front.
+    size_t records = length / layout->size;
+    pyobj_t* list = py_alloc_list(records);
+
+    for (size_t i = 0; i < records; i++) {
+        py_list_append(list, unpack_values(layout, data + i * layout->size));
+    }
+
+    return WITH_RESULT(py_alloc_list_iterator(list));
+}
@@ -0,0 +1,282 @@
+#pragma once
+
+#include "../functions.h"
+#include "../symbols.h"
+#include "../objects.h"
+#include "../exceptions.h"
+#include "../ints.h"
+#include "../buffers.h"
+
+// The native `struct` module. Its members are imported via `from struct import ...`, which
+// the transpiler resolves to the `struct_`-prefixed globals below.
+//
+// When a function of this module is called with a format string that is a constant at
+// the call site, the transpiler compiles the format into a pair of kernels - straight-line
+// C functions that access each field at a fixed offset, using the helpers defined below.
+// The call is then replaced by one of the `PY_STRUCT_*_CONST` macros, guarded by a check
+// that the called object still is the function of this module. When the result of an
+// `unpack` is immediately destructured, the values are pushed directly onto the stack,
+// without allocating a tuple.
+//
+// All other calls go through the functions below, which interpret the format at run-time.
+// Parsed formats are kept in a small cache, keyed by the contents of the format string.
+
+// class error(Exception)
+extern pyobj_t py_type_struct_error;
+extern pyobj_t* KNOWN_GLOBAL(struct_error);
+
+// def calcsize(format)
+extern pyobj_t* KNOWN_GLOBAL(struct_calcsize);
+PY_DEFINE(py_struct_calcsize);
+
+// def pack(format, *values)
+extern pyobj_t* KNOWN_GLOBAL(struct_pack);
+PY_DEFINE(py_struct_pack);
+
+// def pack_into(format, buffer, offset, *values)
+extern pyobj_t* KNOWN_GLOBAL(struct_pack_into);
+PY_DEFINE(py_struct_pack_into);
+
+// def unpack(format, buffer)
+extern pyobj_t* KNOWN_GLOBAL(struct_unpack);
+PY_DEFINE(py_struct_unpack);
+
+// def unpack_from(format, buffer, offset = 0)
+extern pyobj_t* KNOWN_GLOBAL(struct_unpack_from);
+PY_DEFINE(py_struct_unpack_from);
+
+// def iter_unpack(format, buffer)
+extern pyobj_t* KNOWN_GLOBAL(struct_iter_unpack);
+PY_DEFINE(py_struct_iter_unpack);
+
+// Resolves the `size` bytes a format accesses within the given buffer, starting at `offset`,
+// which may be negative to count from the end of the buffer, or `NULL` for 0. If `exact` is
+// `true`, the buffer has to be exactly `size` bytes long, like `unpack` requires. If `writable`
+// is `true`, the buffer has to be writable. Returns an exception or NULL.
+pyobj_t* py_struct_locate(
+    pyobj_t* buffer,
+    pyobj_t* offset,
+    size_t size,
+    bool exact,
+    bool writable,
+    uint8_t** out_data
+);
+
+// Allocates a `bytes` object of `size` zero bytes, to be filled in by a pack kernel.
+pyobj_t* py_struct_alloc_packed(size_t size, uint8_t** out_data);
+
+// Reads a `size`-byte unsigned integer at `data`, in the given byte order.
+static inline uint64_t py_struct_load(const uint8_t* data, size_t size, bool little_endian) {
+    switch (size) {
+        case 1: return data[0];
+        case 2: {
+            uint16_t x;
+            __builtin_memcpy(&x, data, 2);
+            return little_endian ? x : __builtin_bswap16(x);
+        }
+        case 4: {
+            uint32_t x;
+            __builtin_memcpy(&x, data, 4);
+            return little_endian ? x : __builtin_bswap32(x);
+        }
+        default: {
+            uint64_t x;
+            __builtin_memcpy(&x, data, 8);
+            return little_endian ? x : __builtin_bswap64(x);
+        }
+    }
+}
+
+// Writes the low `size` bytes of `x` to `data`, in the given byte order.
+static inline void py_struct_store(uint8_t* data, size_t size, bool little_endian, uint64_t x) {
+    switch (size) {
+        case 1: data[0] = (uint8_t)x; break;
+        case 2: {
+            uint16_t y = little_endian ? (uint16_t)x : __builtin_bswap16((uint16_t)x);
+            __builtin_memcpy(data, &y, 2);
+            break;
+        }
+        case 4: {
+            uint32_t y = little_endian ? (uint32_t)x : __builtin_bswap32((uint32_t)x);
+            __builtin_memcpy(data, &y, 4);
+            break;
+        }
+        default: {
+            uint64_t y = little_endian ? x : __builtin_bswap64(x);
+            __builtin_memcpy(data, &y, 8);
+            break;
+        }
+    }
+}
+
+// Converts a `size`-byte integer, as read by `py_struct_load`, to an `int` object.
+static inline pyobj_t* py_struct_box_int(uint64_t raw, size_t size, bool is_signed) {
+    if (is_signed) {
+        int shift = 64 - (int)size * 8;
+        return py_alloc_int((int64_t)(raw << shift) >> shift);
+    }
+
+    if (size < 8 || raw <= INT64_MAX)
+        return py_alloc_int((int64_t)raw);
+
+    return py_int_from_bytes((const uint8_t*)&raw, 8, true, false);
+}
+
+// Converts a 4-byte (`f`) or 8-byte (`d`) floating-point value, as read by `py_struct_load`,
+// to a `float` object.
+static inline pyobj_t* py_struct_box_float(uint64_t raw, size_t size) {
+    if (size == 4) {
+        uint32_t bits = (uint32_t)raw;
+        float x;
+        __builtin_memcpy(&x, &bits, 4);
+        return py_alloc_float(x);
+    }
+
+    double x;
+    __builtin_memcpy(&x, &raw, 8);
+    return py_alloc_float(x);
+}
+
+// Compliments `py_struct_store_int` for the values it does not handle inline.
+pyobj_t* py_struct_store_int_slow(
+    uint8_t* data,
+    size_t size,
+    bool is_signed,
+    bool little_endian,
+    char code,
+    pyobj_t* x
+);
+
+// Stores the `int` object `x` as a `size`-byte integer of format character `code` at `data`.
+// Raises a `struct.error` if `x` is not an `int`, or is out of the range of the format.
+// Returns an exception or NULL.
+static inline pyobj_t* py_struct_store_int(
+    uint8_t* data,
+    size_t size,
+    bool is_signed,
+    bool little_endian,
+    char code,
+    pyobj_t* x
+) {
+    if (x->type == &py_type_int && PY_INT_IS_SMALL(x)) {
+        int64_t value = x->as_int;
+        bool in_range;
+
+        if (size == 8) {
+            in_range = is_signed || value >= 0;
+        }
+        else if (is_signed) {
+            int64_t limit = (int64_t)1 << (size * 8 - 1);
+            in_range = value >= -limit && value < limit;
+        }
+        else {
+            in_range = value >= 0 && value < ((int64_t)1 << (size * 8));
+        }
+
+        if (in_range) {
+            py_struct_store(data, size, little_endian, (uint64_t)value);
+            return NULL;
+        }
+    }
+
+    return py_struct_store_int_slow(data, size, is_signed, little_endian, code, x);
+}
+
+// Stores the `int` or `float` object `x` as a 4-byte (`f`) or 8-byte (`d`) floating-point
+// value at `data`. Returns an exception or NULL.
+pyobj_t* py_struct_store_float(uint8_t* data, size_t size, bool little_endian, pyobj_t* x);
+
+// Stores the truth value of `x` as a single byte at `data`, like the `?` format character.
+// Returns an exception or NULL.
+pyobj_t* py_struct_store_bool(uint8_t* data, pyobj_t* x);
+
+// Stores the bytes-like object `x` in the `size` bytes at `data`, truncating or padding it
+// with zeroes, like the `s` format character. If `is_char` is `true`, `x` has to be exactly
+// one byte long, like the `c` format character requires. Returns an exception or NULL.
+pyobj_t* py_struct_store_bytes(uint8_t* data, size_t size, bool is_char, pyobj_t* x);
+
+// Evaluates to `true` if the object called by a `CALL $argc` that is about to be executed
+// is the given function of this module.
+#define PY_STRUCT_IS_CALL($function, $argc) \
+    (STACK_ITEM(($argc) + 2) == KNOWN_GLOBAL(struct_##$function))
+
+// Implements `unpack(format, buffer)` (where `$exact` is `true`) or `unpack_from(format,
+// buffer[, offset])`, where `format` is a constant compiled to the unpack kernel `$kernel`,
+// which reads `$size` bytes and produces `$count` values. Pushes a tuple of the values.
+#define PY_STRUCT_UNPACK_CONST($kernel, $size, $count, $argc, $exact, $exc_depth, $lasti) \
+    {                                                                                   \
+        uint8_t* data;                                                                  \
+        pyobj_t* exc = py_struct_locate(                                                \
+            STACK_ITEM(($argc) - 1), ($argc) == 3 ? STACK_PEEK() : NULL,                \
+            ($size), ($exact), false, &data                                             \
+        );                                                                              \
+        if (exc != NULL) {                                                              \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                                   \
+        }                                                                               \
+        pyobj_t* tuple = py_alloc_tuple($count);                                        \
+        $kernel(data, tuple->as_list.elements);                                         \
+        stack_current -= ($argc) + 2;                                                   \
+        STACK_PUSH() = tuple;                                                           \
+    }
+
+// Equivalent to `PY_STRUCT_UNPACK_CONST`, followed by `UNPACK_SEQUENCE $count`. The values
+// are pushed onto the stack directly, with the first one on top.
+#define PY_STRUCT_UNPACK_CONST_DESTRUCTURED($kernel, $size, $count, $argc, $exact, $exc_depth, $lasti) \
+    {                                                                                   \
+        uint8_t* data;                                                                  \
+        pyobj_t* exc = py_struct_locate(                                                \
+            STACK_ITEM(($argc) - 1), ($argc) == 3 ? STACK_PEEK() : NULL,                \
+            ($size), ($exact), false, &data                                             \
+        );                                                                              \
+        if (exc != NULL) {                                                              \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                                   \
+        }                                                                               \
+        pyobj_t* values[$count];                                                        \
+        $kernel(data, values);                                                          \
+        stack_current -= ($argc) + 2;                                                   \
+        for (int i = ($count) - 1; i >= 0; i--) {                                       \
+            STACK_PUSH() = values[i];                                                   \
+        }                                                                               \
+    }
+
+// Implements `pack(format, *values)`, where `format` is a constant compiled to the pack
+// kernel `$kernel`, which writes `$size` bytes. Pushes the resulting `bytes`.
+#define PY_STRUCT_PACK_CONST($kernel, $size, $argc, $exc_depth, $lasti)                \
+    {                                                                                   \
+        uint8_t* data;                                                                  \
+        pyobj_t* bytes = py_struct_alloc_packed($size, &data);                          \
+        pyobj_t* exc = $kernel(data, (pyobj_t**)&STACK_ITEM(($argc) - 1));              \
+        if (exc != NULL) {                                                              \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                                   \
+        }                                                                               \
+        stack_current -= ($argc) + 2;                                                   \
+        STACK_PUSH() = bytes;                                                           \
+    }
+
+// Implements `pack_into(format, buffer, offset, *values)`, where `format` is a constant
+// compiled to the pack kernel `$kernel`, which writes `$size` bytes. Pushes `None`.
+#define PY_STRUCT_PACK_INTO_CONST($kernel, $size, $argc, $exc_depth, $lasti)           \
+    {                                                                                   \
+        uint8_t* data;                                                                  \
+        pyobj_t* exc = py_struct_locate(                                                \
+            STACK_ITEM(($argc) - 1), STACK_ITEM(($argc) - 2),                           \
+            ($size), false, true, &data                                                 \
+        );                                                                              \
+        if (exc == NULL) {                                                              \
+            __builtin_memset(data, 0, ($size));                                         \
+            exc = $kernel(data, (pyobj_t**)&STACK_ITEM(($argc) - 3));                   \
+        }                                                                               \
+        if (exc != NULL) {                                                              \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                                   \
+        }                                                                               \
+        stack_current -= ($argc) + 2;                                                   \
+        STACK_PUSH() = &py_none;                                                        \
+    }
+
+// Used by pack kernels to return early if storing a value raised an exception.
+#define PY_STRUCT_TRY($x)                       \
+    {                                           \
+        pyobj_t* exc = ($x);                    \
+        if (exc != NULL)                        \
+            return exc;                         \
+    }
@@ -0,0 +1,78 @@
+#include "time.h"
+
+#include "../ints.h"
+#include "../exceptions.h"
+#include "../sys/core.h"
+#include "../sys/clock.h"
+
+// The longest possible sleep, in seconds - past this, the length doesn't fit in 64 bits
+// worth of nanoseconds.
+#define MAX_SLEEP_SECONDS 18446744073.0
+
+DEFINE_FUNCTION_WRAPPER(py_time_monotonic_ns, time_monotonic_ns);
+PY_DEFINE(py_time_monotonic_ns) {
+    if (argc != 0)
+        RAISE(TypeError, "monotonic_ns() takes no arguments");
+
+    return WITH_RESULT(py_alloc_int((int64_t)sys_now_ns()));
+}
+
+DEFINE_FUNCTION_WRAPPER(py_time_monotonic, time_monotonic);
+PY_DEFINE(py_time_monotonic) {
+    if (argc != 0)
+        RAISE(TypeError, "monotonic() takes no arguments");
+
+    return WITH_RESULT(py_alloc_float((double)sys_now_ns() / 1e9));
+}
+
+DEFINE_FUNCTION_WRAPPER(py_time_perf_counter_ns, time_perf_counter_ns);
+PY_DEFINE(py_time_perf_counter_ns) {
+    if (argc != 0)
+        RAISE(TypeError, "perf_counter_ns() takes no arguments");
+
+    return WITH_RESULT(py_alloc_int((int64_t)sys_now_ns()));
+}
+
+DEFINE_FUNCTION_WRAPPER(py_time_perf_counter, time_perf_counter);
+PY_DEFINE(py_time_perf_counter) {
+    if (argc != 0)
+        RAISE(TypeError, "perf_counter() takes no arguments");
+
+    return WITH_RESULT(py_alloc_float((double)sys_now_ns() / 1e9));
+}
+
+DEFINE_FUNCTION_WRAPPER(py_time_sleep, time_sleep);
+PY_DEFINE(py_time_sleep) {
+    if (argc != 1)
+        RAISE(TypeError, "sleep() takes exactly one argument");
+
+    ENSURE_NOT_NULL(argv);
+    pyobj_t* secs = NOT_NULL(argv[0]);
+
+    double seconds;
+    if (secs->type == &py_type_float) {
+        seconds = secs->as_float;
+    }
+    else if (secs->type == &py_type_bool) {
+        seconds = secs->as_bool ? 1.0 : 0.0;
+    }
+    else if (secs->type == &py_type_int) {
+        if (!py_int_to_double(secs, &seconds))
+            RAISE(OverflowError, "timestamp too large to convert to C _PyTime_t");
+    }
+    else {
+        RAISE(TypeError, "sleep() argument must be int or float");
+    }
+
+    if (__builtin_isnan(seconds))
+        RAISE(ValueError, "Invalid value NaN (not a number)");
+
+    if (seconds < 0)
+        RAISE(ValueError, "sleep length must be non-negative");
+
+    if (seconds >= MAX_SLEEP_SECONDS)
+        RAISE(OverflowError, "timestamp too large to convert to C _PyTime_t");
+
+    clock_sleep_ns((uint64_t)(seconds * 1e9));
+    return WITH_RESULT(&py_none);
+}
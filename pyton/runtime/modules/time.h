@@ -0,0 +1,30 @@
+#pragma once
+
+#include "../functions.h"
+#include "../symbols.h"
+#include "../objects.h"
+
+// The native `time` module. Its members are imported via `from time import ...`, which
+// the transpiler resolves to the `time_`-prefixed globals below. All clocks are backed by
+// the monotonic clock of the system (see `sys/clock.h`), which starts at boot - and so,
+// the performance counter and the monotonic clock are one and the same.
+
+// def monotonic_ns()
+extern pyobj_t* KNOWN_GLOBAL(time_monotonic_ns);
+PY_DEFINE(py_time_monotonic_ns);
+
+// def monotonic()
+extern pyobj_t* KNOWN_GLOBAL(time_monotonic);
+PY_DEFINE(py_time_monotonic);
+
+// def perf_counter_ns()
+extern pyobj_t* KNOWN_GLOBAL(time_perf_counter_ns);
+PY_DEFINE(py_time_perf_counter_ns);
+
+// def perf_counter()
+extern pyobj_t* KNOWN_GLOBAL(time_perf_counter);
+PY_DEFINE(py_time_perf_counter);
+
+// def sleep(secs)
+extern pyobj_t* KNOWN_GLOBAL(time_sleep);
+PY_DEFINE(py_time_sleep);
@@ -2,6 +2,18 @@
 
 #include "functions.h"
 #include "classes.h"
+#include "ints.h"
+#include "lists.h"
+#include "dicts.h"
+#include "sets.h"
+#include "strings.h"
+#include "slices.h"
+#include "buffers.h"
+#include "arrays.h"
+#include "matrices.h"
+#include "sorting.h"
+#include "formatting.h"
+#include "opcodes.h"
 #include "std/string.h"
 #include "std/stringop.h"
 #include "std/safety.h"
@@ -42,87 +54,1883 @@ CLASS(object)
         if (name == NULL || name->type != &py_type_str)
             return WITH_RESULT(PY_STR("<unknown object>"));
         
-        pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
-        obj->type = &py_type_str;
-        obj->as_str = std_strconcat(STR("<"), name->as_str, STR(" object>"));
-        return WITH_RESULT(obj);
+        return WITH_RESULT(py_alloc_str(std_strconcat(STR("<"), name->as_str, STR(" object>"))));
+    }
+
+    CLASS_ATTRIBUTES(object)
+        HAS_CLASS_METHOD(object, __new__),
+        HAS_CLASS_METHOD(object, __init__),
+        HAS_CLASS_METHOD(object, __str__)
+    END_CLASS_ATTRIBUTES;
+DEFINE_ROOT_TYPE(object);
+
+CLASS(bool)
+    // def __str__(self):
+    CLASS_METHOD_E(_bool, __str__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_bool);
+        return WITH_RESULT(self->as_bool ? PY_STR("True") : PY_STR("False"));
+    };
+
+    CLASS_ATTRIBUTES_E(_bool, "bool")
+        // TODO: methods for bool
+        HAS_CLASS_METHOD_E(_bool, __str__)
+    END_CLASS_ATTRIBUTES;
+DEFINE_INTRINSIC_TYPE_E(_bool);
+
+CLASS(float)
+    // def __str__(self):
+    CLASS_METHOD_E(_float, __str__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_float);
+
+        string_t decimal = py_float_to_decimal(self->as_float);
+        return WITH_RESULT(py_alloc_str_analyzed(decimal, decimal.length, true));
+    };
+
+    // def __format__(self, format_spec):
+    CLASS_METHOD_E(_float, __format__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_float);
+
+        if (argc != 1)
+            RAISE(TypeError, "__format__ expects exactly one argument");
+
+        return py_format(self, NOT_NULL(argv)[0]);
+    };
+
+    CLASS_ATTRIBUTES_E(_float, "float")
+        HAS_CLASS_METHOD_E(_float, __str__),
+        HAS_CLASS_METHOD_E(_float, __format__)
+    END_CLASS_ATTRIBUTES;
+DEFINE_INTRINSIC_TYPE_E(_float);
+
+// Parses the `byteorder` and `signed` arguments of `int.from_bytes` and `int.to_bytes`.
+// `byteorder` is `NULL` if it wasn't passed positionally - it then defaults to "big". Returns
+// an exception or NULL.
+static pyobj_t* parse_int_bytes_options(
+    pyobj_t* byteorder,
+    int kwargc,
+    symbol_t* kwargv,
+    bool* out_little_endian,
+    bool* out_signed
+) {
+    *out_little_endian = false;
+    *out_signed = false;
+
+    for (int i = 0; i < kwargc; i++) {
+        if (std_strequ(kwargv[i].name, STR("byteorder"))) {
+            byteorder = kwargv[i].value;
+        }
+        else if (std_strequ(kwargv[i].name, STR("signed"))) {
+            void* local[1] = { kwargv[i].value };
+            int local_current = 0;
+
+            pyobj_t* exception = py_opcode_to_bool(local, &local_current);
+            if (exception != NULL)
+                return exception;
+
+            *out_signed = ((pyobj_t*)local[0])->as_bool;
+        }
+        else {
+            return NEW_EXCEPTION_INLINE(TypeError, "unexpected keyword argument");
+        }
+    }
+
+    if (byteorder == NULL)
+        return NULL;
+
+    if (byteorder->type != &py_type_str)
+        return NEW_EXCEPTION_INLINE(TypeError, "byteorder must be str");
+
+    if (std_strequ(byteorder->as_str, STR("little"))) {
+        *out_little_endian = true;
+    }
+    else if (!std_strequ(byteorder->as_str, STR("big"))) {
+        return NEW_EXCEPTION_INLINE(ValueError, "byteorder must be either 'little' or 'big'");
+    }
+
+    return NULL;
+}
+
+CLASS(int)
+    // def __str__(self):
+    CLASS_METHOD_E(_int, __str__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_int);
+
+        string_t decimal = py_int_to_decimal(self);
+        return WITH_RESULT(py_alloc_str_analyzed(decimal, decimal.length, true));
+    };
+
+    // def __format__(self, format_spec):
+    CLASS_METHOD_E(_int, __format__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_int);
+
+        if (argc != 1)
+            RAISE(TypeError, "__format__ expects exactly one argument");
+
+        return py_format(self, NOT_NULL(argv)[0]);
+    };
+
+    // @classmethod
+    // def from_bytes(cls, bytes, byteorder = "big", *, signed = False):
+    CLASS_METHOD_E(_int, from_bytes) {
+        if (argc < 1 || argc > 2)
+            RAISE(TypeError, "from_bytes expected 1 or 2 arguments");
+
+        bool little_endian, is_signed;
+        pyobj_t* exception = parse_int_bytes_options(
+            argc == 2 ? NOT_NULL(argv)[1] : NULL,
+            kwargc, kwargv,
+            &little_endian, &is_signed
+        );
+
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        // Other iterables of `int`s are converted to `bytes` first.
+        pyobj_t* source = NOT_NULL(argv)[0];
+        if (!PY_IS_BUFFER(source)) {
+            source = UNWRAP(py_alloc_buffer_from(&py_type_bytes, source, NULL));
+        }
+
+        uint8_t* data;
+        size_t length;
+        ASSERT(py_get_buffer(source, &data, &length));
+
+        return WITH_RESULT(py_int_from_bytes(data, length, little_endian, is_signed));
+    };
+
+    // def to_bytes(self, length = 1, byteorder = "big", *, signed = False):
+    CLASS_METHOD_E(_int, to_bytes) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_int);
+
+        if (argc > 2)
+            RAISE(TypeError, "to_bytes expected at most 2 arguments");
+
+        int64_t length = 1;
+        if (argc >= 1) {
+            pyobj_t* exception = py_int_as_index(NOT_NULL(argv)[0], &length);
+            if (exception != NULL)
+                return WITH_EXCEPTION(exception);
+
+            if (length < 0)
+                RAISE(ValueError, "length argument must be non-negative");
+        }
+
+        bool little_endian, is_signed;
+        pyobj_t* exception = parse_int_bytes_options(
+            argc == 2 ? argv[1] : NULL,
+            kwargc, kwargv,
+            &little_endian, &is_signed
+        );
+
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        uint8_t* data = length == 0 ? NULL : mm_heap_alloc((size_t)length);
+
+        exception = py_int_to_bytes(self, data, (size_t)length, little_endian, is_signed);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(py_alloc_bytes_view(data, (size_t)length));
+    };
+
+    CLASS_ATTRIBUTES_E(_int, "int")
+        HAS_CLASS_METHOD_E(_int, __str__),
+        HAS_CLASS_METHOD_E(_int, __format__),
+        HAS_CLASS_METHOD_E(_int, from_bytes),
+        HAS_CLASS_METHOD_E(_int, to_bytes)
+    END_CLASS_ATTRIBUTES;
+DEFINE_INTRINSIC_TYPE_E(_int);
+
+CLASS(str)
+    // def __str__(self):
+    CLASS_METHOD(str, __str__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_str);
+        return WITH_RESULT(self);
+    };
+
+    // def __format__(self, format_spec):
+    CLASS_METHOD(str, __format__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_str);
+
+        if (argc != 1)
+            RAISE(TypeError, "__format__ expects exactly one argument");
+
+        return py_format(self, NOT_NULL(argv)[0]);
+    };
+
+    // def __new__(cls, value):
+    CLASS_METHOD(str, __new__) {
+        // pyobj_t* cls = NOT_NULL(self);
+    
+        if (argc != 1)
+            sys_panic("Expected exactly one argument to str(...).");
+
+        return py_str_of(NOT_NULL(argv)[0]);
+    };
+
+    // def join(self, iterable):
+    CLASS_METHOD(str, join) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_str);
+
+        if (argc != 1)
+            RAISE(TypeError, "join expects exactly one argument");
+
+        return py_str_join(self, NOT_NULL(argv)[0]);
+    };
+
+    // def find(self, sub, start = None, end = None):
+    CLASS_METHOD(str, find) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_str);
+
+        if (argc < 1 || argc > 3)
+            RAISE(TypeError, "find expected between 1 and 3 arguments");
+
+        return py_str_find(self, NOT_NULL(argv)[0], argc - 1, &argv[1], false);
+    };
+
+    // def rfind(self, sub, start = None, end = None):
+    CLASS_METHOD(str, rfind) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_str);
+
+        if (argc < 1 || argc > 3)
+            RAISE(TypeError, "rfind expected between 1 and 3 arguments");
+
+        return py_str_find(self, NOT_NULL(argv)[0], argc - 1, &argv[1], true);
+    };
+
+    // def count(self, sub, start = None, end = None):
+    CLASS_METHOD(str, count) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_str);
+
+        if (argc < 1 || argc > 3)
+            RAISE(TypeError, "count expected between 1 and 3 arguments");
+
+        return py_str_count(self, NOT_NULL(argv)[0], argc - 1, &argv[1]);
+    };
+
+    // def startswith(self, prefix, start = None, end = None):
+    CLASS_METHOD(str, startswith) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_str);
+
+        if (argc < 1 || argc > 3)
+            RAISE(TypeError, "startswith expected between 1 and 3 arguments");
+
+        return py_str_startswith(self, NOT_NULL(argv)[0], argc - 1, &argv[1], false);
+    };
+
+    // def endswith(self, suffix, start = None, end = None):
+    CLASS_METHOD(str, endswith) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_str);
+
+        if (argc < 1 || argc > 3)
+            RAISE(TypeError, "endswith expected between 1 and 3 arguments");
+
+        return py_str_startswith(self, NOT_NULL(argv)[0], argc - 1, &argv[1], true);
+    };
+
+    // def split(self, sep = None, maxsplit = -1):
+    CLASS_METHOD(str, split) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_str);
+
+        if (argc > 2)
+            RAISE(TypeError, "split expected at most 2 arguments");
+
+        int64_t maxsplit = -1;
+        if (argc == 2) {
+            pyobj_t* exception = py_int_as_index(argv[1], &maxsplit);
+            if (exception != NULL)
+                return WITH_EXCEPTION(exception);
+        }
+
+        return py_str_split(self, argc >= 1 ? NOT_NULL(argv)[0] : NULL, maxsplit);
+    };
+
+    // def replace(self, old, new, count = -1):
+    CLASS_METHOD(str, replace) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_str);
+
+        if (argc < 2 || argc > 3)
+            RAISE(TypeError, "replace expected 2 or 3 arguments");
+
+        int64_t count = -1;
+        if (argc == 3) {
+            pyobj_t* exception = py_int_as_index(argv[2], &count);
+            if (exception != NULL)
+                return WITH_EXCEPTION(exception);
+        }
+
+        return py_str_replace(self, NOT_NULL(argv)[0], argv[1], count);
+    };
+
+    // def strip(self, chars = None):
+    CLASS_METHOD(str, strip) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_str);
+
+        if (argc > 1)
+            RAISE(TypeError, "strip expected at most 1 argument");
+
+        return py_str_strip(self, argc == 1 ? NOT_NULL(argv)[0] : NULL, true, true);
+    };
+
+    // def lstrip(self, chars = None):
+    CLASS_METHOD(str, lstrip) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_str);
+
+        if (argc > 1)
+            RAISE(TypeError, "lstrip expected at most 1 argument");
+
+        return py_str_strip(self, argc == 1 ? NOT_NULL(argv)[0] : NULL, true, false);
+    };
+
+    // def rstrip(self, chars = None):
+    CLASS_METHOD(str, rstrip) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_str);
+
+        if (argc > 1)
+            RAISE(TypeError, "rstrip expected at most 1 argument");
+
+        return py_str_strip(self, argc == 1 ? NOT_NULL(argv)[0] : NULL, false, true);
+    };
+
+    // def encode(self, encoding = "utf-8"):
+    CLASS_METHOD(str, encode) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_str);
+
+        if (argc > 1)
+            RAISE(TypeError, "encode expected at most 1 argument");
+
+        static pyobj_t utf8 = PY_STR_LITERAL("utf-8");
+        return py_alloc_buffer_from(&py_type_bytes, self, argc == 1 ? NOT_NULL(argv)[0] : &utf8);
+    };
+
+    CLASS_ATTRIBUTES(str)
+        HAS_CLASS_METHOD(str, __str__),
+        HAS_CLASS_METHOD(str, __format__),
+        HAS_CLASS_METHOD(str, __new__),
+        HAS_CLASS_METHOD(str, join),
+        HAS_CLASS_METHOD(str, find),
+        HAS_CLASS_METHOD(str, rfind),
+        HAS_CLASS_METHOD(str, count),
+        HAS_CLASS_METHOD(str, startswith),
+        HAS_CLASS_METHOD(str, endswith),
+        HAS_CLASS_METHOD(str, split),
+        HAS_CLASS_METHOD(str, replace),
+        HAS_CLASS_METHOD(str, strip),
+        HAS_CLASS_METHOD(str, lstrip),
+        HAS_CLASS_METHOD(str, rstrip),
+        HAS_CLASS_METHOD(str, encode)
+    END_CLASS_ATTRIBUTES;
+DEFINE_INTRINSIC_TYPE(str);
+
+CLASS(tuple)
+    // def __len__(self):
+    CLASS_METHOD(tuple, __len__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_tuple);
+        return WITH_RESULT(py_alloc_int((int64_t)self->as_list.length));
+    };
+
+    // def __getitem__(self, index):
+    CLASS_METHOD(tuple, __getitem__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_tuple);
+
+        if (argc != 1)
+            RAISE(TypeError, "__getitem__ expects exactly one argument");
+
+        return py_list_getitem(self, NOT_NULL(argv)[0]);
+    };
+
+    // def __iter__(self):
+    CLASS_METHOD(tuple, __iter__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_tuple);
+        return WITH_RESULT(py_alloc_list_iterator(self));
+    };
+
+    // def __str__(self):
+    CLASS_METHOD(tuple, __str__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_tuple);
+        return WITH_RESULT(py_alloc_str(py_list_to_str(self)));
+    };
+
+    CLASS_ATTRIBUTES(tuple)
+        // TODO: methods for tuple
+        HAS_CLASS_METHOD(tuple, __len__),
+        HAS_CLASS_METHOD(tuple, __getitem__),
+        HAS_CLASS_METHOD(tuple, __iter__),
+        HAS_CLASS_METHOD(tuple, __str__)
+    END_CLASS_ATTRIBUTES;
+DEFINE_INTRINSIC_TYPE(tuple);
+
+CLASS(list)
+    // def __new__(cls, iterable = ()):
+    CLASS_METHOD(list, __new__) {
+        if (argc > 1)
+            RAISE(TypeError, "list expected at most 1 argument");
+
+        pyobj_t* list = py_alloc_list(0);
+
+        if (argc == 1) {
+            pyobj_t* exception = py_list_extend(list, NOT_NULL(argv)[0]);
+            if (exception != NULL)
+                return WITH_EXCEPTION(exception);
+        }
+
+        return WITH_RESULT(list);
+    };
+
+    // def append(self, item):
+    CLASS_METHOD(list, append) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_list);
+
+        if (argc != 1)
+            RAISE(TypeError, "list.append() takes exactly one argument");
+
+        py_list_append(self, NOT_NULL(argv)[0]);
+        return WITH_RESULT(&py_none);
+    };
+
+    // def extend(self, iterable):
+    CLASS_METHOD(list, extend) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_list);
+
+        if (argc != 1)
+            RAISE(TypeError, "list.extend() takes exactly one argument");
+
+        pyobj_t* exception = py_list_extend(self, NOT_NULL(argv)[0]);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(&py_none);
+    };
+
+    // def insert(self, index, item):
+    CLASS_METHOD(list, insert) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_list);
+
+        if (argc != 2)
+            RAISE(TypeError, "insert expected 2 arguments");
+
+        pyobj_t* exception = py_list_insert(self, NOT_NULL(argv)[0], argv[1]);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(&py_none);
+    };
+
+    // def pop(self, index = -1):
+    CLASS_METHOD(list, pop) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_list);
+
+        if (argc > 1)
+            RAISE(TypeError, "pop expected at most 1 argument");
+
+        return py_list_pop(self, argc == 1 ? NOT_NULL(argv)[0] : NULL);
+    };
+
+    // def sort(self, *, key = None, reverse = False):
+    CLASS_METHOD(list, sort) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_list);
+
+        if (argc != 0)
+            RAISE(TypeError, "sort() takes no positional arguments");
+
+        pyobj_t* key;
+        bool reverse;
+        pyobj_t* exception = py_sort_parse_kwargs(kwargc, kwargv, &key, &reverse, NULL);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        exception = py_sort(self->as_list.elements, self->as_list.length, key, reverse);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(&py_none);
+    };
+
+    // def __len__(self):
+    CLASS_METHOD(list, __len__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_list);
+        return WITH_RESULT(py_alloc_int((int64_t)self->as_list.length));
+    };
+
+    // def __getitem__(self, index):
+    CLASS_METHOD(list, __getitem__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_list);
+
+        if (argc != 1)
+            RAISE(TypeError, "__getitem__ expects exactly one argument");
+
+        return py_list_getitem(self, NOT_NULL(argv)[0]);
+    };
+
+    // def __setitem__(self, index, value):
+    CLASS_METHOD(list, __setitem__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_list);
+
+        if (argc != 2)
+            RAISE(TypeError, "__setitem__ expects exactly two arguments");
+
+        pyobj_t* exception = py_list_setitem(self, NOT_NULL(argv)[0], argv[1]);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(&py_none);
+    };
+
+    // def __delitem__(self, index):
+    CLASS_METHOD(list, __delitem__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_list);
+
+        if (argc != 1)
+            RAISE(TypeError, "__delitem__ expects exactly one argument");
+
+        pyobj_t* exception = py_list_delitem(self, NOT_NULL(argv)[0]);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(&py_none);
+    };
+
+    // def __iter__(self):
+    CLASS_METHOD(list, __iter__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_list);
+        return WITH_RESULT(py_alloc_list_iterator(self));
+    };
+
+    // def __str__(self):
+    CLASS_METHOD(list, __str__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_list);
+        return WITH_RESULT(py_alloc_str(py_list_to_str(self)));
+    };
+
+    CLASS_ATTRIBUTES(list)
+        HAS_CLASS_METHOD(list, __new__),
+        HAS_CLASS_METHOD(list, append),
+        HAS_CLASS_METHOD(list, extend),
+        HAS_CLASS_METHOD(list, insert),
+        HAS_CLASS_METHOD(list, pop),
+        HAS_CLASS_METHOD(list, sort),
+        HAS_CLASS_METHOD(list, __len__),
+        HAS_CLASS_METHOD(list, __getitem__),
+        HAS_CLASS_METHOD(list, __setitem__),
+        HAS_CLASS_METHOD(list, __delitem__),
+        HAS_CLASS_METHOD(list, __iter__),
+        HAS_CLASS_METHOD(list, __str__)
+    END_CLASS_ATTRIBUTES;
+DEFINE_INTRINSIC_TYPE(list);
+
+CLASS(list_iterator)
+    // def __iter__(self):
+    CLASS_METHOD(list_iterator, __iter__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_list_iterator);
+        return WITH_RESULT(self);
+    };
+
+    // def __next__(self):
+    CLASS_METHOD(list_iterator, __next__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_list_iterator);
+
+        // `FOR_ITER` handles list iterators by itself - this is only called when
+        // `__next__` is invoked explicitly.
+        struct list_iterator_data* data = &self->as_list_iterator;
+        if (data->index >= data->sequence->as_list.length)
+            return WITH_EXCEPTION(py_call(&py_type_StopIteration, 0, NULL, 0, NULL, NULL).value);
+
+        return WITH_RESULT(data->sequence->as_list.elements[data->index++]);
+    };
+
+    CLASS_ATTRIBUTES(list_iterator)
+        HAS_CLASS_METHOD(list_iterator, __iter__),
+        HAS_CLASS_METHOD(list_iterator, __next__)
+    END_CLASS_ATTRIBUTES;
+DEFINE_INTRINSIC_TYPE(list_iterator);
+
+CLASS(dict)
+    // def __new__(cls, iterable = (), **kwargs):
+    CLASS_METHOD(dict, __new__) {
+        if (argc > 1)
+            RAISE(TypeError, "dict expected at most 1 argument");
+
+        pyobj_t* dict = py_alloc_dict((size_t)kwargc);
+
+        if (argc == 1) {
+            pyobj_t* exception = py_dict_update(dict, NOT_NULL(argv)[0]);
+            if (exception != NULL)
+                return WITH_EXCEPTION(exception);
+        }
+
+        for (int i = 0; i < kwargc; i++) {
+            pyobj_t* exception = py_dict_setitem(dict, py_alloc_str(kwargv[i].name), kwargv[i].value);
+            if (exception != NULL)
+                return WITH_EXCEPTION(exception);
+        }
+
+        return WITH_RESULT(dict);
+    };
+
+    // def __len__(self):
+    CLASS_METHOD(dict, __len__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict);
+        return WITH_RESULT(py_alloc_int((int64_t)self->as_dict->length));
+    };
+
+    // def __getitem__(self, key):
+    CLASS_METHOD(dict, __getitem__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict);
+
+        if (argc != 1)
+            RAISE(TypeError, "__getitem__ expects exactly one argument");
+
+        return py_dict_getitem(self, NOT_NULL(argv)[0]);
+    };
+
+    // def __setitem__(self, key, value):
+    CLASS_METHOD(dict, __setitem__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict);
+
+        if (argc != 2)
+            RAISE(TypeError, "__setitem__ expects exactly two arguments");
+
+        pyobj_t* exception = py_dict_setitem(self, NOT_NULL(argv)[0], argv[1]);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(&py_none);
+    };
+
+    // def __delitem__(self, key):
+    CLASS_METHOD(dict, __delitem__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict);
+
+        if (argc != 1)
+            RAISE(TypeError, "__delitem__ expects exactly one argument");
+
+        pyobj_t* exception = py_dict_delitem(self, NOT_NULL(argv)[0]);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(&py_none);
+    };
+
+    // def __contains__(self, key):
+    CLASS_METHOD(dict, __contains__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict);
+
+        if (argc != 1)
+            RAISE(TypeError, "__contains__ expects exactly one argument");
+
+        bool contains;
+        pyobj_t* exception = py_dict_contains(self, NOT_NULL(argv)[0], &contains);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(AS_PY_BOOL(contains));
+    };
+
+    // def get(self, key, default = None):
+    CLASS_METHOD(dict, get) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict);
+
+        if (argc != 1 && argc != 2)
+            RAISE(TypeError, "get expected 1 or 2 arguments");
+
+        pyobj_t* value = UNWRAP(py_dict_get(self, NOT_NULL(argv)[0]));
+        return WITH_RESULT(value != NULL ? value : argc == 2 ? argv[1] : &py_none);
+    };
+
+    // def setdefault(self, key, default = None):
+    CLASS_METHOD(dict, setdefault) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict);
+
+        if (argc != 1 && argc != 2)
+            RAISE(TypeError, "setdefault expected 1 or 2 arguments");
+
+        pyobj_t* value = UNWRAP(py_dict_get(self, NOT_NULL(argv)[0]));
+        if (value != NULL)
+            return WITH_RESULT(value);
+
+        value = argc == 2 ? argv[1] : &py_none;
+
+        pyobj_t* exception = py_dict_setitem(self, argv[0], value);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(value);
+    };
+
+    // def pop(self, key, default = <missing>):
+    CLASS_METHOD(dict, pop) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict);
+
+        if (argc != 1 && argc != 2)
+            RAISE(TypeError, "pop expected 1 or 2 arguments");
+
+        pyobj_t* value = UNWRAP(argc == 2 ? py_dict_get(self, NOT_NULL(argv)[0]) : py_dict_getitem(self, NOT_NULL(argv)[0]));
+        if (value == NULL)
+            return WITH_RESULT(argv[1]);
+
+        pyobj_t* exception = py_dict_delitem(self, argv[0]);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(value);
+    };
+
+    // def update(self, other):
+    CLASS_METHOD(dict, update) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict);
+
+        if (argc > 1)
+            RAISE(TypeError, "update expected at most 1 argument");
+
+        if (argc == 1) {
+            pyobj_t* exception = py_dict_update(self, NOT_NULL(argv)[0]);
+            if (exception != NULL)
+                return WITH_EXCEPTION(exception);
+        }
+
+        for (int i = 0; i < kwargc; i++) {
+            pyobj_t* exception = py_dict_setitem(self, py_alloc_str(kwargv[i].name), kwargv[i].value);
+            if (exception != NULL)
+                return WITH_EXCEPTION(exception);
+        }
+
+        return WITH_RESULT(&py_none);
+    };
+
+    // def clear(self):
+    CLASS_METHOD(dict, clear) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict);
+        std_hashmap_clear(self->as_dict);
+        return WITH_RESULT(&py_none);
+    };
+
+    // def copy(self):
+    CLASS_METHOD(dict, copy) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict);
+
+        pyobj_t* copy = py_alloc_dict(self->as_dict->length);
+
+        pyobj_t* exception = py_dict_update(copy, self);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(copy);
+    };
+
+    // The following return lists instead of views over the dictionary.
+
+    // def keys(self):
+    CLASS_METHOD(dict, keys) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict);
+
+        const hashmap_t* map = self->as_dict;
+        pyobj_t* keys = py_alloc_list(map->length);
+
+        for (size_t i = 0; i < map->entries.length; i++) {
+            if (map->entries.elements[i].key != NULL) {
+                py_list_append(keys, (pyobj_t*)map->entries.elements[i].key);
+            }
+        }
+
+        return WITH_RESULT(keys);
+    };
+
+    // def values(self):
+    CLASS_METHOD(dict, values) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict);
+
+        const hashmap_t* map = self->as_dict;
+        pyobj_t* values = py_alloc_list(map->length);
+
+        for (size_t i = 0; i < map->entries.length; i++) {
+            if (map->entries.elements[i].key != NULL) {
+                py_list_append(values, map->entries.elements[i].value);
+            }
+        }
+
+        return WITH_RESULT(values);
+    };
+
+    // def items(self):
+    CLASS_METHOD(dict, items) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict);
+
+        const hashmap_t* map = self->as_dict;
+        pyobj_t* items = py_alloc_list(map->length);
+
+        for (size_t i = 0; i < map->entries.length; i++) {
+            hashmap_entry_t entry = map->entries.elements[i];
+            if (entry.key == NULL)
+                continue;
+
+            pyobj_t* pair = py_alloc_tuple(2);
+            pair->as_list.elements[0] = (pyobj_t*)entry.key;
+            pair->as_list.elements[1] = entry.value;
+            py_list_append(items, pair);
+        }
+
+        return WITH_RESULT(items);
+    };
+
+    // def __iter__(self):
+    CLASS_METHOD(dict, __iter__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict);
+        return WITH_RESULT(py_alloc_dict_iterator(self));
+    };
+
+    // def __str__(self):
+    CLASS_METHOD(dict, __str__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict);
+        return WITH_RESULT(py_alloc_str(py_dict_to_str(self)));
+    };
+
+    CLASS_ATTRIBUTES(dict)
+        HAS_CLASS_METHOD(dict, __new__),
+        HAS_CLASS_METHOD(dict, __len__),
+        HAS_CLASS_METHOD(dict, __getitem__),
+        HAS_CLASS_METHOD(dict, __setitem__),
+        HAS_CLASS_METHOD(dict, __delitem__),
+        HAS_CLASS_METHOD(dict, __contains__),
+        HAS_CLASS_METHOD(dict, get),
+        HAS_CLASS_METHOD(dict, setdefault),
+        HAS_CLASS_METHOD(dict, pop),
+        HAS_CLASS_METHOD(dict, update),
+        HAS_CLASS_METHOD(dict, clear),
+        HAS_CLASS_METHOD(dict, copy),
+        HAS_CLASS_METHOD(dict, keys),
+        HAS_CLASS_METHOD(dict, values),
+        HAS_CLASS_METHOD(dict, items),
+        HAS_CLASS_METHOD(dict, __iter__),
+        HAS_CLASS_METHOD(dict, __str__)
+    END_CLASS_ATTRIBUTES;
+DEFINE_INTRINSIC_TYPE(dict);
+
+CLASS(dict_iterator)
+    // def __iter__(self):
+    CLASS_METHOD(dict_iterator, __iter__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict_iterator);
+        return WITH_RESULT(self);
+    };
+
+    // def __next__(self):
+    CLASS_METHOD(dict_iterator, __next__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_dict_iterator);
+
+        // `FOR_ITER` handles dict iterators by itself - this is only called when
+        // `__next__` is invoked explicitly.
+        pyobj_t* key = py_dict_iterator_next(self);
+        if (key == NULL)
+            return WITH_EXCEPTION(py_call(&py_type_StopIteration, 0, NULL, 0, NULL, NULL).value);
+
+        return WITH_RESULT(key);
+    };
+
+    CLASS_ATTRIBUTES(dict_iterator)
+        HAS_CLASS_METHOD(dict_iterator, __iter__),
+        HAS_CLASS_METHOD(dict_iterator, __next__)
+    END_CLASS_ATTRIBUTES;
+DEFINE_INTRINSIC_TYPE(dict_iterator);
+
+// Verifies that `self` is either a `set` or a `frozenset`. Most methods are shared between
+// the two types.
+static void verify_set_self(pyobj_t* self) {
+    ENSURE_NOT_NULL(self);
+
+    if (!PY_IS_SET(self)) {
+        sys_panic("The 'self' argument was of an invalid type.");
+    }
+}
+
+// Converts `x` to a set, unless it already is one. Methods like `set.union` accept
+// any iterable.
+static pyreturn_t as_set_operand(pyobj_t* x) {
+    if (PY_IS_SET(NOT_NULL(x)))
+        return WITH_RESULT(x);
+
+    return py_alloc_set_from(&py_type_set, x);
+}
+
+// Applies `op` to `self` and each of the given iterables in turn, like `set.union(*others)`.
+static pyreturn_t fold_set_operation(
+    pyobj_t* self,
+    int argc,
+    pyobj_t** argv,
+    pyreturn_t (*op)(pyobj_t* a, pyobj_t* b)
+) {
+    pyobj_t* result = self;
+
+    if (argc == 0)
+        return py_alloc_set_from(self->type, self);
+
+    for (int i = 0; i < argc; i++) {
+        pyobj_t* other = UNWRAP(as_set_operand(argv[i]));
+        result = UNWRAP(op(result, other));
+    }
+
+    return WITH_RESULT(result);
+}
+
+CLASS(set)
+    // def __new__(cls, iterable = ()):
+    CLASS_METHOD(set, __new__) {
+        if (argc > 1)
+            RAISE(TypeError, "set expected at most 1 argument");
+
+        if (argc == 0)
+            return WITH_RESULT(py_alloc_set(&py_type_set));
+
+        return py_alloc_set_from(&py_type_set, NOT_NULL(argv)[0]);
+    };
+
+    // def __len__(self):
+    CLASS_METHOD(set, __len__) {
+        verify_set_self(self);
+        return WITH_RESULT(py_alloc_int((int64_t)py_set_length(self)));
+    };
+
+    // def __contains__(self, item):
+    CLASS_METHOD(set, __contains__) {
+        verify_set_self(self);
+
+        if (argc != 1)
+            RAISE(TypeError, "__contains__ expects exactly one argument");
+
+        bool contains;
+        pyobj_t* exception = py_set_contains(self, NOT_NULL(argv)[0], &contains);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(AS_PY_BOOL(contains));
+    };
+
+    // def __iter__(self):
+    CLASS_METHOD(set, __iter__) {
+        verify_set_self(self);
+        return WITH_RESULT(py_alloc_set_iterator(self));
+    };
+
+    // def __str__(self):
+    CLASS_METHOD(set, __str__) {
+        verify_set_self(self);
+        return WITH_RESULT(py_alloc_str(py_set_to_str(self)));
+    };
+
+    // def add(self, item):
+    CLASS_METHOD(set, add) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_set);
+
+        if (argc != 1)
+            RAISE(TypeError, "add expects exactly one argument");
+
+        pyobj_t* exception = py_set_add(self, NOT_NULL(argv)[0]);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(&py_none);
+    };
+
+    // def remove(self, item):
+    CLASS_METHOD(set, remove) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_set);
+
+        if (argc != 1)
+            RAISE(TypeError, "remove expects exactly one argument");
+
+        bool removed;
+        pyobj_t* exception = py_set_discard(self, NOT_NULL(argv)[0], &removed);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        if (!removed)
+            return WITH_EXCEPTION(py_new_key_error(argv[0]));
+
+        return WITH_RESULT(&py_none);
+    };
+
+    // def discard(self, item):
+    CLASS_METHOD(set, discard) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_set);
+
+        if (argc != 1)
+            RAISE(TypeError, "discard expects exactly one argument");
+
+        pyobj_t* exception = py_set_discard(self, NOT_NULL(argv)[0], NULL);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(&py_none);
+    };
+
+    // def pop(self):
+    CLASS_METHOD(set, pop) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_set);
+        return py_set_pop(self);
+    };
+
+    // def clear(self):
+    CLASS_METHOD(set, clear) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_set);
+        py_set_clear(self);
+        return WITH_RESULT(&py_none);
+    };
+
+    // def update(self, *others):
+    CLASS_METHOD(set, update) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_set);
+
+        for (int i = 0; i < argc; i++) {
+            pyobj_t* exception = py_set_update(self, argv[i]);
+            if (exception != NULL)
+                return WITH_EXCEPTION(exception);
+        }
+
+        return WITH_RESULT(&py_none);
+    };
+
+    // def copy(self):
+    CLASS_METHOD(set, copy) {
+        verify_set_self(self);
+
+        // Frozen sets are immutable, so they can be shared.
+        if (self->type == &py_type_frozenset)
+            return WITH_RESULT(self);
+
+        return py_alloc_set_from(self->type, self);
+    };
+
+    // def union(self, *others):
+    CLASS_METHOD(set, union) {
+        verify_set_self(self);
+        return fold_set_operation(self, argc, argv, py_set_union);
+    };
+
+    // def intersection(self, *others):
+    CLASS_METHOD(set, intersection) {
+        verify_set_self(self);
+        return fold_set_operation(self, argc, argv, py_set_intersection);
+    };
+
+    // def difference(self, *others):
+    CLASS_METHOD(set, difference) {
+        verify_set_self(self);
+        return fold_set_operation(self, argc, argv, py_set_difference);
+    };
+
+    // def symmetric_difference(self, other):
+    CLASS_METHOD(set, symmetric_difference) {
+        verify_set_self(self);
+
+        if (argc != 1)
+            RAISE(TypeError, "symmetric_difference expects exactly one argument");
+
+        return fold_set_operation(self, argc, argv, py_set_symmetric_difference);
+    };
+
+    // def issubset(self, other):
+    CLASS_METHOD(set, issubset) {
+        verify_set_self(self);
+
+        if (argc != 1)
+            RAISE(TypeError, "issubset expects exactly one argument");
+
+        bool result;
+        pyobj_t* exception = py_set_is_subset(self, UNWRAP(as_set_operand(argv[0])), &result);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(AS_PY_BOOL(result));
+    };
+
+    // def issuperset(self, other):
+    CLASS_METHOD(set, issuperset) {
+        verify_set_self(self);
+
+        if (argc != 1)
+            RAISE(TypeError, "issuperset expects exactly one argument");
+
+        bool result;
+        pyobj_t* exception = py_set_is_subset(UNWRAP(as_set_operand(argv[0])), self, &result);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(AS_PY_BOOL(result));
+    };
+
+    // def isdisjoint(self, other):
+    CLASS_METHOD(set, isdisjoint) {
+        verify_set_self(self);
+
+        if (argc != 1)
+            RAISE(TypeError, "isdisjoint expects exactly one argument");
+
+        pyobj_t* common = UNWRAP(py_set_intersection(self, UNWRAP(as_set_operand(argv[0]))));
+        return WITH_RESULT(AS_PY_BOOL(py_set_length(common) == 0));
+    };
+
+    CLASS_ATTRIBUTES(set)
+        HAS_CLASS_METHOD(set, __new__),
+        HAS_CLASS_METHOD(set, __len__),
+        HAS_CLASS_METHOD(set, __contains__),
+        HAS_CLASS_METHOD(set, __iter__),
+        HAS_CLASS_METHOD(set, __str__),
+        HAS_CLASS_METHOD(set, add),
+        HAS_CLASS_METHOD(set, remove),
+        HAS_CLASS_METHOD(set, discard),
+        HAS_CLASS_METHOD(set, pop),
+        HAS_CLASS_METHOD(set, clear),
+        HAS_CLASS_METHOD(set, update),
+        HAS_CLASS_METHOD(set, copy),
+        HAS_CLASS_METHOD(set, union),
+        HAS_CLASS_METHOD(set, intersection),
+        HAS_CLASS_METHOD(set, difference),
+        HAS_CLASS_METHOD(set, symmetric_difference),
+        HAS_CLASS_METHOD(set, issubset),
+        HAS_CLASS_METHOD(set, issuperset),
+        HAS_CLASS_METHOD(set, isdisjoint)
+    END_CLASS_ATTRIBUTES;
+DEFINE_INTRINSIC_TYPE(set);
+
+CLASS(frozenset)
+    // def __new__(cls, iterable = ()):
+    CLASS_METHOD(frozenset, __new__) {
+        if (argc > 1)
+            RAISE(TypeError, "frozenset expected at most 1 argument");
+
+        if (argc == 0)
+            return WITH_RESULT(py_alloc_set(&py_type_frozenset));
+
+        if (NOT_NULL(argv)[0]->type == &py_type_frozenset)
+            return WITH_RESULT(argv[0]);
+
+        return py_alloc_set_from(&py_type_frozenset, argv[0]);
+    };
+
+    // All other methods are shared with `set`.
+    CLASS_ATTRIBUTES(frozenset)
+        HAS_CLASS_METHOD(frozenset, __new__),
+        HAS_CLASS_METHOD(set, __len__),
+        HAS_CLASS_METHOD(set, __contains__),
+        HAS_CLASS_METHOD(set, __iter__),
+        HAS_CLASS_METHOD(set, __str__),
+        HAS_CLASS_METHOD(set, copy),
+        HAS_CLASS_METHOD(set, union),
+        HAS_CLASS_METHOD(set, intersection),
+        HAS_CLASS_METHOD(set, difference),
+        HAS_CLASS_METHOD(set, symmetric_difference),
+        HAS_CLASS_METHOD(set, issubset),
+        HAS_CLASS_METHOD(set, issuperset),
+        HAS_CLASS_METHOD(set, isdisjoint)
+    END_CLASS_ATTRIBUTES;
+DEFINE_INTRINSIC_TYPE(frozenset);
+
+CLASS(set_iterator)
+    // def __iter__(self):
+    CLASS_METHOD(set_iterator, __iter__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_set_iterator);
+        return WITH_RESULT(self);
+    };
+
+    // def __next__(self):
+    CLASS_METHOD(set_iterator, __next__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_set_iterator);
+
+        // `FOR_ITER` handles set iterators by itself - this is only called when
+        // `__next__` is invoked explicitly.
+        pyobj_t* element = py_set_iterator_next(self);
+        if (element == NULL)
+            return WITH_EXCEPTION(py_call(&py_type_StopIteration, 0, NULL, 0, NULL, NULL).value);
+
+        return WITH_RESULT(element);
+    };
+
+    CLASS_ATTRIBUTES(set_iterator)
+        HAS_CLASS_METHOD(set_iterator, __iter__),
+        HAS_CLASS_METHOD(set_iterator, __next__)
+    END_CLASS_ATTRIBUTES;
+DEFINE_INTRINSIC_TYPE(set_iterator);
+
+CLASS(slice)
+    // def __new__(cls, *args):
+    CLASS_METHOD(slice, __new__) {
+        if (argc < 1 || argc > 3)
+            RAISE(TypeError, "slice expected between 1 and 3 arguments");
+
+        // `slice(stop)` or `slice(start, stop[, step])`.
+        if (argc == 1)
+            return WITH_RESULT(py_alloc_slice(&py_none, NOT_NULL(argv)[0], &py_none));
+
+        return WITH_RESULT(py_alloc_slice(argv[0], argv[1], argc == 3 ? argv[2] : &py_none));
+    };
+
+    // def indices(self, length):
+    CLASS_METHOD(slice, indices) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_slice);
+
+        if (argc != 1)
+            RAISE(TypeError, "indices expects exactly one argument");
+
+        int64_t length;
+        pyobj_t* exception = py_int_as_index(NOT_NULL(argv)[0], &length);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        if (length < 0)
+            RAISE(ValueError, "length should not be negative");
+
+        int64_t start, stop, step, count;
+        exception = py_slice_resolve(self, length, &start, &stop, &step, &count);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        pyobj_t* result = py_alloc_tuple(3);
+        result->as_list.elements[0] = py_alloc_int(start);
+        result->as_list.elements[1] = py_alloc_int(stop);
+        result->as_list.elements[2] = py_alloc_int(step);
+        return WITH_RESULT(result);
+    };
+
+    CLASS_ATTRIBUTES(slice)
+        HAS_CLASS_METHOD(slice, __new__),
+        HAS_CLASS_METHOD(slice, indices)
+    END_CLASS_ATTRIBUTES;
+DEFINE_INTRINSIC_TYPE(slice);
+
+// Verifies that `self` is a `bytes`, `bytearray` or `memoryview`. Most methods are shared
+// between the three types.
+static void verify_buffer_self(pyobj_t* self) {
+    ENSURE_NOT_NULL(self);
+
+    if (!PY_IS_BUFFER(self)) {
+        sys_panic("The 'self' argument was of an invalid type.");
     }
+}
+
+CLASS(bytes)
+    // def __new__(cls, source = None, encoding = None):
+    CLASS_METHOD(bytes, __new__) {
+        if (argc > 2)
+            RAISE(TypeError, "bytes expected at most 2 arguments");
+
+        return py_alloc_buffer_from(
+            &py_type_bytes,
+            argc >= 1 ? NOT_NULL(argv)[0] : NULL,
+            argc == 2 ? argv[1] : NULL
+        );
+    };
+
+    // def __len__(self):
+    CLASS_METHOD(bytes, __len__) {
+        verify_buffer_self(self);
+        return WITH_RESULT(py_alloc_int((int64_t)py_buffer_length(self)));
+    };
+
+    // def __getitem__(self, index):
+    CLASS_METHOD(bytes, __getitem__) {
+        verify_buffer_self(self);
+
+        if (argc != 1)
+            RAISE(TypeError, "__getitem__ expects exactly one argument");
+
+        return py_buffer_getitem(self, NOT_NULL(argv)[0]);
+    };
+
+    // def __setitem__(self, index, value):
+    CLASS_METHOD(bytes, __setitem__) {
+        verify_buffer_self(self);
+
+        if (argc != 2)
+            RAISE(TypeError, "__setitem__ expects exactly two arguments");
+
+        pyobj_t* exception = py_buffer_setitem(self, NOT_NULL(argv)[0], argv[1]);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(&py_none);
+    };
 
-    CLASS_ATTRIBUTES(object)
-        HAS_CLASS_METHOD(object, __new__),
-        HAS_CLASS_METHOD(object, __init__),
-        HAS_CLASS_METHOD(object, __str__)
-    END_CLASS_ATTRIBUTES;
-DEFINE_ROOT_TYPE(object);
+    // def __contains__(self, item):
+    CLASS_METHOD(bytes, __contains__) {
+        verify_buffer_self(self);
+
+        if (argc != 1)
+            RAISE(TypeError, "__contains__ expects exactly one argument");
+
+        bool contains;
+        pyobj_t* exception = py_buffer_contains(self, NOT_NULL(argv)[0], &contains);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(AS_PY_BOOL(contains));
+    };
+
+    // def __iter__(self):
+    CLASS_METHOD(bytes, __iter__) {
+        verify_buffer_self(self);
+        return WITH_RESULT(py_alloc_buffer_iterator(self));
+    };
 
-CLASS(bool)
     // def __str__(self):
-    CLASS_METHOD_E(_bool, __str__) {
+    CLASS_METHOD(bytes, __str__) {
+        verify_buffer_self(self);
+        return WITH_RESULT(py_alloc_str(py_buffer_to_str(self)));
+    };
+
+    // def hex(self):
+    CLASS_METHOD(bytes, hex) {
+        verify_buffer_self(self);
+        return WITH_RESULT(py_buffer_hex(self));
+    };
+
+    // def decode(self, encoding = "utf-8"):
+    CLASS_METHOD(bytes, decode) {
+        verify_buffer_self(self);
+
+        if (argc > 1)
+            RAISE(TypeError, "decode expected at most 1 argument");
+
+        return py_buffer_decode(self, argc == 1 ? NOT_NULL(argv)[0] : NULL);
+    };
+
+    CLASS_ATTRIBUTES(bytes)
+        HAS_CLASS_METHOD(bytes, __new__),
+        HAS_CLASS_METHOD(bytes, __len__),
+        HAS_CLASS_METHOD(bytes, __getitem__),
+        HAS_CLASS_METHOD(bytes, __contains__),
+        HAS_CLASS_METHOD(bytes, __iter__),
+        HAS_CLASS_METHOD(bytes, __str__),
+        HAS_CLASS_METHOD(bytes, hex),
+        HAS_CLASS_METHOD(bytes, decode)
+    END_CLASS_ATTRIBUTES;
+DEFINE_INTRINSIC_TYPE(bytes);
+
+CLASS(bytearray)
+    // def __new__(cls, source = None, encoding = None):
+    CLASS_METHOD(bytearray, __new__) {
+        if (argc > 2)
+            RAISE(TypeError, "bytearray expected at most 2 arguments");
+
+        return py_alloc_buffer_from(
+            &py_type_bytearray,
+            argc >= 1 ? NOT_NULL(argv)[0] : NULL,
+            argc == 2 ? argv[1] : NULL
+        );
+    };
+
+    // def append(self, item):
+    CLASS_METHOD(bytearray, append) {
         ENSURE_NOT_NULL(self);
-        py_verify_self_arg(self, &py_type_bool);
-        return WITH_RESULT(self->as_bool ? PY_STR("True") : PY_STR("False"));
+        py_verify_self_arg(self, &py_type_bytearray);
+
+        if (argc != 1)
+            RAISE(TypeError, "append expects exactly one argument");
+
+        pyobj_t* exception = py_bytearray_append(self, NOT_NULL(argv)[0]);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(&py_none);
     };
 
-    CLASS_ATTRIBUTES_E(_bool, "bool")
-        // TODO: methods for bool
-        HAS_CLASS_METHOD_E(_bool, __str__)
+    // def extend(self, iterable):
+    CLASS_METHOD(bytearray, extend) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_bytearray);
+
+        if (argc != 1)
+            RAISE(TypeError, "extend expects exactly one argument");
+
+        pyobj_t* exception = py_bytearray_extend(self, NOT_NULL(argv)[0]);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(&py_none);
+    };
+
+    // def __delitem__(self, index):
+    CLASS_METHOD(bytearray, __delitem__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_bytearray);
+
+        if (argc != 1)
+            RAISE(TypeError, "__delitem__ expects exactly one argument");
+
+        pyobj_t* exception = py_buffer_delitem(self, NOT_NULL(argv)[0]);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(&py_none);
+    };
+
+    CLASS_ATTRIBUTES(bytearray)
+        HAS_CLASS_METHOD(bytearray, __new__),
+        HAS_CLASS_METHOD(bytearray, append),
+        HAS_CLASS_METHOD(bytearray, extend),
+        HAS_CLASS_METHOD(bytearray, __delitem__),
+        HAS_CLASS_METHOD(bytes, __len__),
+        HAS_CLASS_METHOD(bytes, __getitem__),
+        HAS_CLASS_METHOD(bytes, __setitem__),
+        HAS_CLASS_METHOD(bytes, __contains__),
+        HAS_CLASS_METHOD(bytes, __iter__),
+        HAS_CLASS_METHOD(bytes, __str__),
+        HAS_CLASS_METHOD(bytes, hex),
+        HAS_CLASS_METHOD(bytes, decode)
     END_CLASS_ATTRIBUTES;
-DEFINE_INTRINSIC_TYPE_E(_bool);
+DEFINE_INTRINSIC_TYPE(bytearray);
 
-CLASS(float)
-    CLASS_ATTRIBUTES_E(_float, "float")
-        // TODO: methods for float
+CLASS(memoryview)
+    // def __new__(cls, source):
+    CLASS_METHOD(memoryview, __new__) {
+        if (argc != 1)
+            RAISE(TypeError, "memoryview expects exactly one argument");
+
+        return py_alloc_memoryview(NOT_NULL(argv)[0]);
+    };
+
+    // def cast(self, format):
+    CLASS_METHOD(memoryview, cast) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_memoryview);
+
+        if (argc != 1)
+            RAISE(TypeError, "cast expects exactly one argument");
+
+        return py_memoryview_cast(self, NOT_NULL(argv)[0]);
+    };
+
+    // def tobytes(self):
+    CLASS_METHOD(memoryview, tobytes) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_memoryview);
+
+        uint8_t* data;
+        size_t length;
+        ASSERT(py_get_buffer(self, &data, &length));
+
+        return WITH_RESULT(py_alloc_bytes(data, length));
+    };
+
+    // def release(self):
+    CLASS_METHOD(memoryview, release) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_memoryview);
+
+        py_memoryview_release(self);
+        return WITH_RESULT(&py_none);
+    };
+
+    // def tolist(self):
+    CLASS_METHOD(memoryview, tolist) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_memoryview);
+
+        pyobj_t* iterator = py_alloc_buffer_iterator(self);
+        pyobj_t* list = py_alloc_list(py_buffer_length(self));
+
+        pyobj_t* item;
+        while ((item = py_buffer_iterator_next(iterator)) != NULL) {
+            py_list_append(list, item);
+        }
+
+        return WITH_RESULT(list);
+    };
+
+    CLASS_ATTRIBUTES(memoryview)
+        HAS_CLASS_METHOD(memoryview, __new__),
+        HAS_CLASS_METHOD(memoryview, cast),
+        HAS_CLASS_METHOD(memoryview, tobytes),
+        HAS_CLASS_METHOD(memoryview, release),
+        HAS_CLASS_METHOD(memoryview, tolist),
+        HAS_CLASS_METHOD(bytes, __len__),
+        HAS_CLASS_METHOD(bytes, __getitem__),
+        HAS_CLASS_METHOD(bytes, __setitem__),
+        HAS_CLASS_METHOD(bytes, __contains__),
+        HAS_CLASS_METHOD(bytes, __iter__),
+        HAS_CLASS_METHOD(bytes, __str__),
+        HAS_CLASS_METHOD(bytes, hex)
     END_CLASS_ATTRIBUTES;
-DEFINE_INTRINSIC_TYPE_E(_float);
+DEFINE_INTRINSIC_TYPE(memoryview);
 
-CLASS(int)
-    CLASS_ATTRIBUTES_E(_int, "int")
-        // TODO: methods for int
+CLASS(bytes_iterator)
+    // def __iter__(self):
+    CLASS_METHOD(bytes_iterator, __iter__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_bytes_iterator);
+        return WITH_RESULT(self);
+    };
+
+    // def __next__(self):
+    CLASS_METHOD(bytes_iterator, __next__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_bytes_iterator);
+
+        // `FOR_ITER` handles buffer iterators by itself - this is only called when
+        // `__next__` is invoked explicitly.
+        pyobj_t* element = py_buffer_iterator_next(self);
+        if (element == NULL)
+            return WITH_EXCEPTION(py_call(&py_type_StopIteration, 0, NULL, 0, NULL, NULL).value);
+
+        return WITH_RESULT(element);
+    };
+
+    CLASS_ATTRIBUTES(bytes_iterator)
+        HAS_CLASS_METHOD(bytes_iterator, __iter__),
+        HAS_CLASS_METHOD(bytes_iterator, __next__)
     END_CLASS_ATTRIBUTES;
-DEFINE_INTRINSIC_TYPE_E(_int);
+DEFINE_INTRINSIC_TYPE(bytes_iterator);
+
+CLASS(array_array)
+    // def __new__(cls, typecode, initializer = None):
+    CLASS_METHOD(array_array, __new__) {
+        if (argc < 1 || argc > 2)
+            RAISE(TypeError, "array() takes at most 2 arguments");
+
+        return py_alloc_array(NOT_NULL(argv)[0], argc == 2 ? argv[1] : NULL);
+    };
+
+    // def __len__(self):
+    CLASS_METHOD(array_array, __len__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_array_array);
+        return WITH_RESULT(py_alloc_int((int64_t)py_array_length(self)));
+    };
+
+    // def __getitem__(self, index):
+    CLASS_METHOD(array_array, __getitem__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_array_array);
+
+        if (argc != 1)
+            RAISE(TypeError, "__getitem__ expects exactly one argument");
+
+        return py_array_getitem(self, NOT_NULL(argv)[0]);
+    };
+
+    // def __setitem__(self, index, value):
+    CLASS_METHOD(array_array, __setitem__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_array_array);
+
+        if (argc != 2)
+            RAISE(TypeError, "__setitem__ expects exactly two arguments");
+
+        pyobj_t* exception = py_array_setitem(self, NOT_NULL(argv)[0], argv[1]);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(&py_none);
+    };
+
+    // def __iter__(self):
+    CLASS_METHOD(array_array, __iter__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_array_array);
+        return WITH_RESULT(py_alloc_array_iterator(self));
+    };
 
-CLASS(str)
     // def __str__(self):
-    CLASS_METHOD(str, __str__) {
+    CLASS_METHOD(array_array, __str__) {
         ENSURE_NOT_NULL(self);
-        py_verify_self_arg(self, &py_type_str);
-        return WITH_RESULT(self);
+        py_verify_self_arg(self, &py_type_array_array);
+        return WITH_RESULT(py_alloc_str(py_array_to_str(self)));
     };
 
-    // def __new__(cls, value):
-    CLASS_METHOD(str, __new__) {
-        // pyobj_t* cls = NOT_NULL(self);
-    
+    // def append(self, item):
+    CLASS_METHOD(array_array, append) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_array_array);
+
         if (argc != 1)
-            sys_panic("Expected exactly one argument to str(...).");
+            RAISE(TypeError, "append expects exactly one argument");
+
+        pyobj_t* exception = py_array_append(self, NOT_NULL(argv)[0]);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(&py_none);
+    };
 
-        pyobj_t* value = NOT_NULL(argv)[0];
-        pyobj_t* method_str;
-        py_get_method_attribute(value, STR("__str__"), &method_str);
+    // def extend(self, iterable):
+    CLASS_METHOD(array_array, extend) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_array_array);
+
+        if (argc != 1)
+            RAISE(TypeError, "extend expects exactly one argument");
 
-        if (method_str == NULL || method_str->type != &py_type_function)
-            return WITH_RESULT(PY_STR("<object>"));
+        pyobj_t* exception = py_array_extend(self, NOT_NULL(argv)[0]);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
 
-        return py_call(method_str, 0, NULL, 0, NULL, value);
+        return WITH_RESULT(&py_none);
     };
 
-    CLASS_ATTRIBUTES(str)
-        HAS_CLASS_METHOD(str, __str__),
-        HAS_CLASS_METHOD(str, __new__)
+    // def sum(self):
+    CLASS_METHOD(array_array, sum) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_array_array);
+        return WITH_RESULT(py_array_sum(self));
+    };
+
+    // def min(self):
+    CLASS_METHOD(array_array, min) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_array_array);
+        return py_array_extreme(self, false);
+    };
+
+    // def max(self):
+    CLASS_METHOD(array_array, max) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_array_array);
+        return py_array_extreme(self, true);
+    };
+
+    // def dot(self, other):
+    CLASS_METHOD(array_array, dot) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_array_array);
+
+        if (argc != 1)
+            RAISE(TypeError, "dot expects exactly one argument");
+
+        return py_array_dot(self, NOT_NULL(argv)[0]);
+    };
+
+    // def sort(self):
+    CLASS_METHOD(array_array, sort) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_array_array);
+        py_array_sort(self);
+        return WITH_RESULT(&py_none);
+    };
+
+    // def tolist(self):
+    CLASS_METHOD(array_array, tolist) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_array_array);
+        return WITH_RESULT(py_array_tolist(self));
+    };
+
+    // def tobytes(self):
+    CLASS_METHOD(array_array, tobytes) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_array_array);
+        return WITH_RESULT(py_alloc_bytes(self->as_buffer.data, self->as_buffer.length));
+    };
+
+    CLASS_ATTRIBUTES_E(_array_array, "array")
+        HAS_CLASS_METHOD(array_array, __new__),
+        HAS_CLASS_METHOD(array_array, __len__),
+        HAS_CLASS_METHOD(array_array, __getitem__),
+        HAS_CLASS_METHOD(array_array, __setitem__),
+        HAS_CLASS_METHOD(array_array, __iter__),
+        HAS_CLASS_METHOD(array_array, __str__),
+        HAS_CLASS_METHOD(array_array, append),
+        HAS_CLASS_METHOD(array_array, extend),
+        HAS_CLASS_METHOD(array_array, sum),
+        HAS_CLASS_METHOD(array_array, min),
+        HAS_CLASS_METHOD(array_array, max),
+        HAS_CLASS_METHOD(array_array, dot),
+        HAS_CLASS_METHOD(array_array, sort),
+        HAS_CLASS_METHOD(array_array, tolist),
+        HAS_CLASS_METHOD(array_array, tobytes)
     END_CLASS_ATTRIBUTES;
-DEFINE_INTRINSIC_TYPE(str);
+DEFINE_INTRINSIC_TYPE(array_array);
 
-CLASS(tuple)
-    CLASS_ATTRIBUTES(tuple)
-        // TODO: methods for tuple
+CLASS(array_iterator)
+    // def __iter__(self):
+    CLASS_METHOD(array_iterator, __iter__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_array_iterator);
+        return WITH_RESULT(self);
+    };
+
+    // def __next__(self):
+    CLASS_METHOD(array_iterator, __next__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_array_iterator);
+
+        // `FOR_ITER` handles array iterators by itself - this is only called when
+        // `__next__` is invoked explicitly.
+        pyobj_t* element = py_array_iterator_next(self);
+        if (element == NULL)
+            return WITH_EXCEPTION(py_call(&py_type_StopIteration, 0, NULL, 0, NULL, NULL).value);
+
+        return WITH_RESULT(element);
+    };
+
+    CLASS_ATTRIBUTES(array_iterator)
+        HAS_CLASS_METHOD(array_iterator, __iter__),
+        HAS_CLASS_METHOD(array_iterator, __next__)
     END_CLASS_ATTRIBUTES;
-DEFINE_INTRINSIC_TYPE(tuple);
+DEFINE_INTRINSIC_TYPE(array_iterator);
 
-CLASS(list)
-    CLASS_ATTRIBUTES(list)
-        // TODO: methods for list
+CLASS(matrix_matrix)
+    // def __new__(cls, typecode, rows, cols, initializer = None):
+    CLASS_METHOD(matrix_matrix, __new__) {
+        if (argc < 3 || argc > 4)
+            RAISE(TypeError, "matrix() takes 3 or 4 arguments");
+
+        return py_alloc_matrix(NOT_NULL(argv)[0], argv[1], argv[2], argc == 4 ? argv[3] : NULL);
+    };
+
+    // def __len__(self):
+    CLASS_METHOD(matrix_matrix, __len__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_matrix_matrix);
+        return WITH_RESULT(py_alloc_int((int64_t)self->as_matrix.rows));
+    };
+
+    // def __getitem__(self, index):
+    CLASS_METHOD(matrix_matrix, __getitem__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_matrix_matrix);
+
+        if (argc != 1)
+            RAISE(TypeError, "__getitem__ expects exactly one argument");
+
+        return py_matrix_row(self, NOT_NULL(argv)[0]);
+    };
+
+    // def __str__(self):
+    CLASS_METHOD(matrix_matrix, __str__) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_matrix_matrix);
+        return WITH_RESULT(py_alloc_str(py_matrix_to_str(self)));
+    };
+
+    // def get(self, i, j):
+    CLASS_METHOD(matrix_matrix, get) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_matrix_matrix);
+
+        if (argc != 2)
+            RAISE(TypeError, "get expects exactly two arguments");
+
+        return py_matrix_get(self, NOT_NULL(argv)[0], argv[1]);
+    };
+
+    // def set(self, i, j, value):
+    CLASS_METHOD(matrix_matrix, set) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_matrix_matrix);
+
+        if (argc != 3)
+            RAISE(TypeError, "set expects exactly three arguments");
+
+        pyobj_t* exception = py_matrix_set(self, NOT_NULL(argv)[0], argv[1], argv[2]);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        return WITH_RESULT(&py_none);
+    };
+
+    // def rows(self):
+    CLASS_METHOD(matrix_matrix, rows) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_matrix_matrix);
+        return WITH_RESULT(py_alloc_int((int64_t)self->as_matrix.rows));
+    };
+
+    // def cols(self):
+    CLASS_METHOD(matrix_matrix, cols) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_matrix_matrix);
+        return WITH_RESULT(py_alloc_int((int64_t)self->as_matrix.cols));
+    };
+
+    // def transpose(self):
+    CLASS_METHOD(matrix_matrix, transpose) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_matrix_matrix);
+        return WITH_RESULT(py_matrix_transpose(self));
+    };
+
+    // def tolist(self):
+    CLASS_METHOD(matrix_matrix, tolist) {
+        ENSURE_NOT_NULL(self);
+        py_verify_self_arg(self, &py_type_matrix_matrix);
+        return WITH_RESULT(py_matrix_tolist(self));
+    };
+
+    CLASS_ATTRIBUTES_E(_matrix_matrix, "matrix")
+        HAS_CLASS_METHOD(matrix_matrix, __new__),
+        HAS_CLASS_METHOD(matrix_matrix, __len__),
+        HAS_CLASS_METHOD(matrix_matrix, __getitem__),
+        HAS_CLASS_METHOD(matrix_matrix, __str__),
+        HAS_CLASS_METHOD(matrix_matrix, get),
+        HAS_CLASS_METHOD(matrix_matrix, set),
+        HAS_CLASS_METHOD(matrix_matrix, rows),
+        HAS_CLASS_METHOD(matrix_matrix, cols),
+        HAS_CLASS_METHOD(matrix_matrix, transpose),
+        HAS_CLASS_METHOD(matrix_matrix, tolist)
     END_CLASS_ATTRIBUTES;
-DEFINE_INTRINSIC_TYPE(list);
+DEFINE_INTRINSIC_TYPE(matrix_matrix);
 
 CLASS(type)
     CLASS_METHOD(type, __call__) {
@@ -199,25 +2007,75 @@ pyobj_t py_none = { .type = &py_type_NoneType };
 pyobj_t py_true = { .type = &py_type_bool, .as_bool = true };
 pyobj_t py_false = { .type = &py_type_bool, .as_bool = false };
 
+// Keys of a class attribute index are 1-based indices into the class attribute table,
+// which is passed as the context. Lookups use a pointer to the name as the key.
+static bool attribute_index_equals(const void* a, const void* b, const void* context) {
+    const vector_t(symbol_t)* attributes = context;
+    return std_strequ(attributes->elements[(uintptr_t)a - 1].name, *(const string_t*)b);
+}
+
+// Used when adding attributes to an index - the names in an attribute table are unique.
+static bool attribute_index_never_equal(const void* a, const void* b, const void* context) {
+    return false;
+}
+
+// Returns the index of the attribute `name` in the class attribute table of `type`, or -1
+// if there is no such attribute. `name_hash` caches the hash of `name` across calls, and
+// should point to 0 if it hasn't been computed yet.
+static ptrdiff_t py_find_class_attribute(type_data_t* type, string_t name, uint64_t* name_hash) {
+    vector_t(symbol_t)* attributes = &type->class_attributes;
+
+    if (attributes->length <= PY_CLASS_ATTRIBUTE_INDEX_THRESHOLD) {
+        for (size_t i = 0; i < attributes->length; i++) {
+            if (std_strequ(attributes->elements[i].name, name))
+                return (ptrdiff_t)i;
+        }
+
+        return -1;
+    }
+
+    if (type->class_attribute_index == NULL) {
+        type->class_attribute_index = mm_heap_alloc(sizeof(hashmap_t));
+        *type->class_attribute_index = (hashmap_t) {};
+    }
+
+    // Attributes are only ever appended to the table, so we only need to index the ones
+    // that were added since the last lookup.
+    hashmap_t* index = type->class_attribute_index;
+    for (size_t i = index->length; i < attributes->length; i++) {
+        std_hashmap_insert(
+            index,
+            std_strhash(attributes->elements[i].name),
+            (const void*)(uintptr_t)(i + 1),
+            attribute_index_never_equal, NULL,
+            NULL
+        );
+    }
+
+    if (*name_hash == 0) {
+        *name_hash = std_strhash(name);
+    }
+
+    hashmap_entry_t* entry = std_hashmap_find(index, *name_hash, &name, attribute_index_equals, attributes);
+    return entry == NULL ? -1 : (ptrdiff_t)((uintptr_t)entry->key - 1);
+}
+
 // Looks up `name` in the class attribute table of `type`, going only one level deep
-// (i.e. not checking the base type). `target` should be assignable to `type`.
+// (i.e. not checking the base type). `target` should be assignable to `type`. See
+// `py_find_class_attribute` for `name_hash`.
 static pyobj_t* py_get_class_attribute(
     pyobj_t* target,
     pyobj_t* type,
     string_t name,
+    uint64_t* name_hash,
     bool unbound_methods,
     bool* out_is_unbound
 ) {
     ASSERT(type->type == &py_type_type);
 
-    const vector_t(symbol_t)* attributes = &type->as_type->class_attributes;
-    for (size_t i = 0; i < attributes->length; i++) {
-        symbol_t attribute = attributes->elements[i];
-
-        if (!std_strequ(attribute.name, name))
-            continue;
-
-        pyobj_t* attr = attribute.value;
+    ptrdiff_t index = py_find_class_attribute(type->as_type, name, name_hash);
+    if (index >= 0) {
+        pyobj_t* attr = type->as_type->class_attributes.elements[index].value;
         pyobj_t* val = attr; // this is the value we'll actually return
 
         // If 'attr' has a '__get__' method, we invoke it. This implements
@@ -323,9 +2181,10 @@ static pyobj_t* py_get_attribute_arbitrary(
     //      A <-- B <-- C                      (where <-- means "inherits from")
     // ...and only C had the class attribute "abc", A.abc would still resolve to C.abc.
     pyobj_t* current_base = target->type == &py_type_type ? target : target->type;
+    uint64_t name_hash = 0;
 
     while (current_base != NULL) {
-        pyobj_t* attr = py_get_class_attribute(target, current_base, name, unbound_methods, out_is_unbound);
+        pyobj_t* attr = py_get_class_attribute(target, current_base, name, &name_hash, unbound_methods, out_is_unbound);
         if (attr != NULL)
             return attr;
         
@@ -357,6 +2216,8 @@ void py_set_attribute(pyobj_t* target, string_t name, pyobj_t* value) {
         sys_panic("The given object is of an immutable type, and cannot be assigned to.");
 
     vector_t(symbol_t)* attributes;
+    ptrdiff_t index = -1;
+
     if (target->type == &py_type_type) {
         // Special case for 'type' - we can do something like this:
         //      class C:
@@ -366,20 +2227,26 @@ void py_set_attribute(pyobj_t* target, string_t name, pyobj_t* value) {
         // ...thus assigning to a 'type' object is equivalent to assigning to
         // its class attribute table.
         attributes = &target->as_type->class_attributes;
+
+        uint64_t name_hash = 0;
+        index = py_find_class_attribute(target->as_type, name, &name_hash);
     }
     else {
         attributes = &target->as_any;
-    }
-
-    for (size_t i = 0; i < attributes->length; i++) {
-        symbol_t* attribute = &attributes->elements[i];
 
-        if (std_strequ(attribute->name, name)) {
-            attribute->value = value;
-            return;
+        for (size_t i = 0; i < attributes->length; i++) {
+            if (std_strequ(attributes->elements[i].name, name)) {
+                index = (ptrdiff_t)i;
+                break;
+            }
         }
     }
 
+    if (index >= 0) {
+        attributes->elements[index].value = value;
+        return;
+    }
+
     // No such attribute was defined before, so we add one.
     std_vector_append(attributes, ((symbol_t){ .name = name, .value = value }));
 } 
@@ -388,6 +2255,7 @@ pyobj_t* py_alloc_int(int64_t x) {
     pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
     obj->type = &py_type_int;
     obj->as_int = x;
+    obj->as_bigint = NULL;
     return obj;
 }
 
@@ -402,6 +2270,11 @@ pyobj_t* py_alloc_str(string_t x) {
     pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
     obj->type = &py_type_str;
     obj->as_str = x;
+    obj->str_hash = 0;
+    obj->str_builder = NULL;
+    obj->str_flags = 0;
+    obj->str_index = NULL;
+    py_str_analyze(obj);
     return obj;
 }
 
@@ -426,6 +2299,7 @@ pyobj_t* py_alloc_type(pyobj_t* base) {
     obj->as_type = mm_heap_alloc(sizeof(type_data_t));
     obj->as_type->base = NOT_NULL(base);
     obj->as_type->is_intrinsic = false;
+    obj->as_type->class_attribute_index = NULL;
     obj->as_type->class_attributes = (vector_t(symbol_t)) {};
     return obj;
 }
@@ -508,6 +2382,12 @@ string_t py_stringify(pyobj_t* target) {
     if (target == &py_none)
         return STR("None");
 
+    if (target->type == &py_type_int)
+        return py_int_to_decimal(target);
+
+    if (target->type == &py_type_float)
+        return py_float_to_decimal(target->as_float);
+
     pyobj_t* method_str;
     if (!py_get_method_attribute(target, STR("__str__"), &method_str))
         return STR("(unknown object)");
@@ -539,4 +2419,4 @@ bool py_isinstance(const pyobj_t* target, const pyobj_t* type) {
     }
 
     return false;
-}
\ No newline at end of file
+}
\ No newline at end of file
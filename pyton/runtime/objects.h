@@ -5,6 +5,7 @@
 #include "symbols.h"
 #include "std/vector.h"
 #include "std/string.h"
+#include "std/hashmap.h"
 #include "sys/mm.h"
 
 // Represents a symbol - an object associated with a name. Symbols may represent attributes,
@@ -43,8 +44,16 @@ typedef struct type_data {
     // that they do not hold an attribute table that would usually be accessed
     // via `as_any`.
     bool is_intrinsic;
+
+    // Maps attribute names to their indices in `class_attributes`. This is only built
+    // once the class has more than `PY_CLASS_ATTRIBUTE_INDEX_THRESHOLD` attributes -
+    // until then, `NULL`, as scanning a few attributes is faster than hashing the name.
+    hashmap_t* class_attribute_index;
 } type_data_t;
 
+// The number of class attributes past which lookups go through `class_attribute_index`.
+#define PY_CLASS_ATTRIBUTE_INDEX_THRESHOLD 8
+
 struct pyobj {
     // Represents the type of the object.
     pyobj_t* type;
@@ -58,10 +67,37 @@ struct pyobj {
         bool as_bool;
         
         // Valid when `type` points to `py_type_str`.
-        string_t as_str;
+        struct {
+            // The contents of the string.
+            string_t as_str;
+
+            // The hash of the string, or 0 if it hasn't been computed yet. See `py_hash`.
+            uint64_t str_hash;
+
+            // If not `NULL`, the builder that holds the contents of the string, which can
+            // be appended to in-place. See `strings.h`.
+            struct strbuilder* str_builder;
+
+            // A combination of the `PY_STR_*` flags defined in `strings.h`.
+            uint32_t str_flags;
 
-        // Valid when `type` points to `py_type_int`.
-        int64_t as_int;
+            // The number of code points in the string. Only valid if `str_flags` has
+            // `PY_STR_ANALYZED` set.
+            int str_codepoints;
+
+            // If not `NULL`, the byte offsets of every `PY_STR_INDEX_STRIDE`-th code point.
+            // Only built for non-ASCII strings, once they're first indexed.
+            const int* str_index;
+        };
+
+        // Valid when `type` points to `py_type_int`. See `ints.h`.
+        struct {
+            // The value of the integer, if `as_bigint` is `NULL`.
+            int64_t as_int;
+
+            // If not `NULL`, holds the value of an integer that does not fit in `as_int`.
+            struct bigint* as_bigint;
+        };
 
         // Valid when `type` points to `py_type_float`.
         double as_float;
@@ -81,8 +117,113 @@ struct pyobj {
             py_fnptr_callable_t body;
         } as_method;
 
-        // Valid when `type` points to `py_type_list` *or* `py_type_tuple`.
+        // Valid when `type` points to `py_type_list` *or* `py_type_tuple`. See `lists.h`.
         vector_t(pyobj_ptr_t) as_list;
+
+        // Valid when `type` points to `py_type_list_iterator`.
+        struct list_iterator_data {
+            // The `list` or `tuple` being iterated over.
+            pyobj_t* sequence;
+
+            // The index of the element that will be returned next.
+            size_t index;
+        } as_list_iterator;
+
+        // Valid when `type` points to `py_type_dict`. See `dicts.h`.
+        hashmap_t* as_dict;
+
+        // Valid when `type` points to `py_type_dict_iterator`.
+        struct dict_iterator_data {
+            // The `dict` being iterated over.
+            pyobj_t* dict;
+
+            // The index of the entry in the `dict` that will be looked at next.
+            size_t index;
+        } as_dict_iterator;
+
+        // Valid when `type` points to `py_type_set` *or* `py_type_frozenset`. See `sets.h`.
+        struct set_data* as_set;
+
+        // Valid when `type` points to `py_type_set_iterator`.
+        struct set_iterator_data {
+            // The `set` or `frozenset` being iterated over.
+            pyobj_t* set;
+
+            // The position in the set that will be looked at next.
+            size_t index;
+        } as_set_iterator;
+
+        // Valid when `type` points to `py_type_slice`. See `slices.h`.
+        struct slice_data {
+            // The bounds of the slice, each of which is either an `int` or `None`.
+            pyobj_t* start;
+            pyobj_t* stop;
+            pyobj_t* step;
+        } as_slice;
+
+        // Valid when `type` points to `py_type_bytes`, `py_type_bytearray`,
+        // `py_type_memoryview` or `py_type_array_array`. See `buffers.h` and `arrays.h`.
+        struct buffer_data {
+            // The first byte of the buffer. For views into a `bytearray`, this is `NULL`,
+            // and the bytes are found at `offset` within the storage of `owner` instead.
+            uint8_t* data;
+
+            // The number of bytes in the buffer.
+            size_t length;
+
+            // The number of bytes `data` has room for. Only used by `bytearray`s and `array`s.
+            size_t capacity;
+
+            // For `memoryview`s of a `bytearray` or `array`, the object being viewed.
+            pyobj_t* owner;
+
+            // The position of the view within the storage of `owner`.
+            size_t offset;
+
+            // For `bytearray`s and `array`s, the number of `memoryview`s of the object that
+            // haven't been released. A `bytearray` cannot be resized while there are any.
+            size_t exports;
+
+            // The `struct` format character the elements are interpreted as, and the size
+            // of a single element, in bytes. Always 'B' and 1 for `bytes` and `bytearray`,
+            // and the typecode of the elements for `array`s.
+            char format;
+            uint8_t itemsize;
+
+            // If `true`, the buffer cannot be modified through this object.
+            bool readonly;
+
+            // If `true`, the buffer is a window into physical memory, which might be mapped
+            // to a device - elements are then accessed with volatile loads and stores of
+            // their exact width.
+            bool is_physical;
+        } as_buffer;
+
+        // Valid when `type` points to `py_type_matrix_matrix`. See `matrices.h`.
+        struct matrix_data {
+            // The storage of the elements, which transposed views share with the matrix
+            // they were created from.
+            void* data;
+
+            // The shape of the matrix.
+            size_t rows;
+            size_t cols;
+
+            // The distance between two consecutive rows, and two consecutive columns,
+            // in elements.
+            size_t row_stride;
+            size_t col_stride;
+
+            // The typecode of the elements - either 'd' or 'q'.
+            char typecode;
+        } as_matrix;
+
+        // Valid when `type` points to `py_type_generator` *or* `py_type_coroutine`.
+        // See `generators.h`.
+        struct generator_data* as_generator;
+
+        // Valid when `type` points to `py_type_future`. See `executor.h`.
+        struct future_data* as_future;
     };
 };
 
@@ -126,6 +267,53 @@ extern pyobj_t py_type_list;
 extern pyobj_t* KNOWN_GLOBAL(list);
 #define PY_GLOBAL_list_WELLKNOWN
 
+// The type of iterators over `list` and `tuple` objects.
+extern pyobj_t py_type_list_iterator;
+
+// The type that represents the `dict` Python class.
+extern pyobj_t py_type_dict;
+extern pyobj_t* KNOWN_GLOBAL(dict);
+#define PY_GLOBAL_dict_WELLKNOWN
+
+// The type of iterators over the keys of `dict` objects.
+extern pyobj_t py_type_dict_iterator;
+
+// The type that represents the `set` Python class.
+extern pyobj_t py_type_set;
+extern pyobj_t* KNOWN_GLOBAL(set);
+#define PY_GLOBAL_set_WELLKNOWN
+
+// The type that represents the `frozenset` Python class.
+extern pyobj_t py_type_frozenset;
+extern pyobj_t* KNOWN_GLOBAL(frozenset);
+#define PY_GLOBAL_frozenset_WELLKNOWN
+
+// The type of iterators over `set` and `frozenset` objects.
+extern pyobj_t py_type_set_iterator;
+
+// The type that represents the `slice` Python class.
+extern pyobj_t py_type_slice;
+extern pyobj_t* KNOWN_GLOBAL(slice);
+#define PY_GLOBAL_slice_WELLKNOWN
+
+// The type that represents the `bytes` Python class.
+extern pyobj_t py_type_bytes;
+extern pyobj_t* KNOWN_GLOBAL(bytes);
+#define PY_GLOBAL_bytes_WELLKNOWN
+
+// The type that represents the `bytearray` Python class.
+extern pyobj_t py_type_bytearray;
+extern pyobj_t* KNOWN_GLOBAL(bytearray);
+#define PY_GLOBAL_bytearray_WELLKNOWN
+
+// The type that represents the `memoryview` Python class.
+extern pyobj_t py_type_memoryview;
+extern pyobj_t* KNOWN_GLOBAL(memoryview);
+#define PY_GLOBAL_memoryview_WELLKNOWN
+
+// The type of iterators over `bytes`, `bytearray` and `memoryview` objects.
+extern pyobj_t py_type_bytes_iterator;
+
 // The type that represents the `type` Python class.
 extern pyobj_t py_type_type;
 extern pyobj_t* KNOWN_GLOBAL(type);
@@ -1,9 +1,38 @@
 #include "opcodes.h"
 
+#include "ints.h"
+#include "std/strscan.h"
+#include "sys/mm.h"
+
 pyreturn_t py_opcode_get_iter(void** stack, int* stack_current) {
     pyobj_t* obj = (pyobj_t*)STACK_POP_INDIRECT();
     pyobj_t* iter_method;
 
+    if (obj->type == &py_type_list || obj->type == &py_type_tuple) {
+        STACK_PUSH_INDIRECT(py_alloc_list_iterator(obj));
+        return WITH_RESULT(NULL);
+    }
+
+    if (obj->type == &py_type_dict) {
+        STACK_PUSH_INDIRECT(py_alloc_dict_iterator(obj));
+        return WITH_RESULT(NULL);
+    }
+
+    if (PY_IS_SET(obj)) {
+        STACK_PUSH_INDIRECT(py_alloc_set_iterator(obj));
+        return WITH_RESULT(NULL);
+    }
+
+    if (PY_IS_BUFFER(obj)) {
+        STACK_PUSH_INDIRECT(py_alloc_buffer_iterator(obj));
+        return WITH_RESULT(NULL);
+    }
+
+    if (PY_IS_ARRAY(obj)) {
+        STACK_PUSH_INDIRECT(py_alloc_array_iterator(obj));
+        return WITH_RESULT(NULL);
+    }
+
     if (!py_get_method_attribute(obj, STR("__iter__"), &iter_method) || iter_method == NULL)
         RAISE(TypeError, "type is not iterable");
 
@@ -14,6 +43,81 @@ pyreturn_t py_opcode_get_iter(void** stack, int* stack_current) {
 
 pyreturn_t py_opcode_for_iter(void** stack, int* stack_current, bool* out_exhausted) {
     pyobj_t* iter = (pyobj_t*)stack[*stack_current];
+
+    if (iter->type == &py_type_list_iterator) {
+        // We check the length on every step, as the list might change while we iterate.
+        struct list_iterator_data* data = &iter->as_list_iterator;
+        *out_exhausted = data->index >= data->sequence->as_list.length;
+
+        if (!*out_exhausted) {
+            STACK_PUSH_INDIRECT(data->sequence->as_list.elements[data->index++]);
+        }
+
+        return WITH_RESULT(NULL);
+    }
+
+    if (iter->type == &py_type_dict_iterator) {
+        pyobj_t* key = py_dict_iterator_next(iter);
+        *out_exhausted = key == NULL;
+
+        if (key != NULL) {
+            STACK_PUSH_INDIRECT(key);
+        }
+
+        return WITH_RESULT(NULL);
+    }
+
+    if (iter->type == &py_type_set_iterator) {
+        pyobj_t* element = py_set_iterator_next(iter);
+        *out_exhausted = element == NULL;
+
+        if (element != NULL) {
+            STACK_PUSH_INDIRECT(element);
+        }
+
+        return WITH_RESULT(NULL);
+    }
+
+    if (iter->type == &py_type_bytes_iterator) {
+        pyobj_t* element = py_buffer_iterator_next(iter);
+        *out_exhausted = element == NULL;
+
+        if (element != NULL) {
+            STACK_PUSH_INDIRECT(element);
+        }
+
+        return WITH_RESULT(NULL);
+    }
+
+    if (iter->type == &py_type_array_iterator) {
+        // Elements are boxed straight from the storage of the array.
+        struct list_iterator_data* data = &iter->as_list_iterator;
+        *out_exhausted = data->index >= py_array_length(data->sequence);
+
+        if (!*out_exhausted) {
+            STACK_PUSH_INDIRECT(py_array_item(data->sequence, data->index++));
+        }
+
+        return WITH_RESULT(NULL);
+    }
+
+    if (iter->type == &py_type_generator) {
+        // Generators are resumed directly - this avoids both the method lookup, and
+        // allocating a StopIteration when they're exhausted.
+        pyobj_t* value;
+        switch (py_send(iter, &py_none, &value)) {
+            case PY_SEND_YIELDED:
+                *out_exhausted = false;
+                STACK_PUSH_INDIRECT(value);
+                return WITH_RESULT(NULL);
+            case PY_SEND_RETURNED:
+                *out_exhausted = true;
+                return WITH_RESULT(NULL);
+            case PY_SEND_RAISED:
+                return WITH_EXCEPTION(value);
+        }
+    }
+
     pyobj_t* next;
 
     if (!py_get_method_attribute(iter, STR("__next__"), &next) || next == NULL)
@@ -32,4 +136,400 @@ pyreturn_t py_opcode_for_iter(void** stack, int* stack_current, bool* out_exhaus
     *out_exhausted = false;
     STACK_PUSH_INDIRECT(status.value);
     return WITH_RESULT(NULL);
-}
\ No newline at end of file
+}
+
+pyreturn_t py_opcode_get_awaitable(void** stack, int* stack_current) {
+    pyobj_t* obj = (pyobj_t*)STACK_POP_INDIRECT();
+
+    if (obj->type == &py_type_coroutine) {
+        STACK_PUSH_INDIRECT(obj);
+        return WITH_RESULT(NULL);
+    }
+
+    pyobj_t* await_method;
+    if (!py_get_method_attribute(obj, STR("__await__"), &await_method) || await_method == NULL)
+        RAISE(TypeError, "object can't be used in 'await' expression");
+
+    pyobj_t* iter = UNWRAP(py_call(await_method, 0, NULL, 0, NULL, obj));
+    STACK_PUSH_INDIRECT(iter);
+    return WITH_RESULT(NULL);
+}
+
+pyreturn_t py_opcode_get_yield_from_iter(void** stack, int* stack_current) {
+    pyobj_t* obj = (pyobj_t*)stack[*stack_current];
+
+    // Generators are delegated to as-is, so that `SEND` can pass values into them. As
+    // `yield from` can't appear in an `async def`, we're always in a regular generator,
+    // where coroutines have to be awaited instead.
+    if (obj->type == &py_type_generator)
+        return WITH_RESULT(NULL);
+
+    if (obj->type == &py_type_coroutine)
+        RAISE(TypeError, "cannot 'yield from' a coroutine object in a non-coroutine generator");
+
+    return py_opcode_get_iter(stack, stack_current);
+}
+
+pyobj_t* py_opcode_store_subscr(void** stack, int* stack_current) {
+    pyobj_t* key = NOT_NULL(STACK_POP_INDIRECT());
+    pyobj_t* container = NOT_NULL(STACK_POP_INDIRECT());
+    pyobj_t* value = NOT_NULL(STACK_POP_INDIRECT());
+
+    if (container->type == &py_type_list && key->type == &py_type_int) {
+        size_t length = container->as_list.length;
+
+        if (PY_INT_IS_SMALL(key) && key->as_int >= 0 && (uint64_t)key->as_int < length) {
+            container->as_list.elements[key->as_int] = value;
+            return NULL;
+        }
+
+        // Negative or out-of-range indices.
+        return py_list_setitem(container, key, value);
+    }
+
+    if (container->type == &py_type_list && key->type == &py_type_slice)
+        return py_list_setslice(container, key, value);
+
+    if (container->type == &py_type_dict)
+        return py_dict_setitem(container, key, value);
+
+    if (PY_IS_BUFFER(container))
+        return py_buffer_setitem(container, key, value);
+
+    if (PY_IS_ARRAY(container))
+        return py_array_setitem(container, key, value);
+
+    pyobj_t* method;
+    bool is_unbound = py_get_method_attribute(container, STR("__setitem__"), &method);
+    if (method == NULL)
+        return NEW_EXCEPTION_INLINE(TypeError, "object does not support item assignment");
+
+    pyobj_t* args[] = { key, value };
+    return py_call(method, 2, args, 0, NULL, is_unbound ? container : NULL).exception;
+}
+
+pyobj_t* py_opcode_delete_subscr(void** stack, int* stack_current) {
+    pyobj_t* key = NOT_NULL(STACK_POP_INDIRECT());
+    pyobj_t* container = NOT_NULL(STACK_POP_INDIRECT());
+
+    if (container->type == &py_type_list && key->type == &py_type_int)
+        return py_list_delitem(container, key);
+
+    if (container->type == &py_type_list && key->type == &py_type_slice)
+        return py_list_delslice(container, key);
+
+    if (container->type == &py_type_dict)
+        return py_dict_delitem(container, key);
+
+    if (PY_IS_BUFFER(container))
+        return py_buffer_delitem(container, key);
+
+    pyobj_t* method;
+    bool is_unbound = py_get_method_attribute(container, STR("__delitem__"), &method);
+    if (method == NULL)
+        return NEW_EXCEPTION_INLINE(TypeError, "object does not support item deletion");
+
+    pyobj_t* args[] = { key };
+    return py_call(method, 1, args, 0, NULL, is_unbound ? container : NULL).exception;
+}
+
+// Returns `true` if slicing the given object is handled by `py_sequence_getslice`.
+static inline bool is_sliceable_sequence(pyobj_t* obj) {
+    return obj->type == &py_type_list || obj->type == &py_type_tuple || obj->type == &py_type_str;
+}
+
+pyobj_t* py_opcode_binary_slice(void** stack, int* stack_current) {
+    pyobj_t* stop = NOT_NULL(STACK_POP_INDIRECT());
+    pyobj_t* start = NOT_NULL(STACK_POP_INDIRECT());
+    pyobj_t* container = NOT_NULL(STACK_POP_INDIRECT());
+
+    if (is_sliceable_sequence(container) || PY_IS_BUFFER(container) || PY_IS_ARRAY(container)) {
+        // The slice doesn't outlive this call, so it doesn't need to be on the heap.
+        pyobj_t slice = {
+            .type = &py_type_slice,
+            .as_slice = { .start = start, .stop = stop, .step = &py_none }
+        };
+
+        pyreturn_t result = PY_IS_BUFFER(container) ? py_buffer_getitem(container, &slice)
+            : PY_IS_ARRAY(container) ? py_array_getitem(container, &slice)
+            : py_sequence_getslice(container, &slice);
+
+        if (result.exception != NULL)
+            return result.exception;
+
+        STACK_PUSH_INDIRECT(result.value);
+        return NULL;
+    }
+
+    // Other objects get a `slice` passed to `__getitem__`.
+    STACK_PUSH_INDIRECT(container);
+    STACK_PUSH_INDIRECT(py_alloc_slice(start, stop, &py_none));
+    return py_opcode_op_subscr(stack, stack_current);
+}
+
+pyobj_t* py_opcode_store_slice(void** stack, int* stack_current) {
+    pyobj_t* stop = NOT_NULL(STACK_POP_INDIRECT());
+    pyobj_t* start = NOT_NULL(STACK_POP_INDIRECT());
+    pyobj_t* container = NOT_NULL(STACK_POP_INDIRECT());
+    pyobj_t* value = NOT_NULL(STACK_POP_INDIRECT());
+
+    if (container->type == &py_type_list || PY_IS_BUFFER(container) || PY_IS_ARRAY(container)) {
+        pyobj_t slice = {
+            .type = &py_type_slice,
+            .as_slice = { .start = start, .stop = stop, .step = &py_none }
+        };
+
+        return container->type == &py_type_list ? py_list_setslice(container, &slice, value)
+            : PY_IS_ARRAY(container) ? py_array_setitem(container, &slice, value)
+            : py_buffer_setitem(container, &slice, value);
+    }
+
+    STACK_PUSH_INDIRECT(value);
+    STACK_PUSH_INDIRECT(container);
+    STACK_PUSH_INDIRECT(py_alloc_slice(start, stop, &py_none));
+    return py_opcode_store_subscr(stack, stack_current);
+}
+
+pyobj_t* py_opcode_to_bool(void** stack, int* stack_current) {
+    pyobj_t* value = NOT_NULL((pyobj_t*)stack[*stack_current]);
+    bool result;
+
+    if (value->type == &py_type_bool)
+        return NULL;
+
+    if (value == &py_none) {
+        result = false;
+    }
+    else if (value->type == &py_type_int) {
+        result = !PY_INT_IS_SMALL(value) || value->as_int != 0;
+    }
+    else if (value->type == &py_type_float) {
+        result = value->as_float != 0.0;
+    }
+    else if (value->type == &py_type_str) {
+        result = value->as_str.length != 0;
+    }
+    else if (value->type == &py_type_list || value->type == &py_type_tuple) {
+        result = value->as_list.length != 0;
+    }
+    else if (value->type == &py_type_dict) {
+        result = value->as_dict->length != 0;
+    }
+    else if (PY_IS_SET(value)) {
+        result = py_set_length(value) != 0;
+    }
+    else if (PY_IS_BUFFER(value) || PY_IS_ARRAY(value)) {
+        result = value->as_buffer.length != 0;
+    }
+    else {
+        // For other objects, we defer to `__bool__`, and then `__len__`. Objects that
+        // define neither are always true.
+        pyobj_t* method;
+        bool is_unbound = py_get_method_attribute(value, STR("__bool__"), &method);
+
+        if (method == NULL) {
+            is_unbound = py_get_method_attribute(value, STR("__len__"), &method);
+        }
+
+        if (method == NULL) {
+            result = true;
+        }
+        else {
+            pyreturn_t converted = py_call(method, 0, NULL, 0, NULL, is_unbound ? value : NULL);
+            if (converted.exception != NULL)
+                return converted.exception;
+
+            pyobj_t* x = NOT_NULL(converted.value);
+            if (x->type == &py_type_bool) {
+                result = x->as_bool;
+            }
+            else if (x->type == &py_type_int) {
+                result = !PY_INT_IS_SMALL(x) || x->as_int != 0;
+            }
+            else {
+                return NEW_EXCEPTION_INLINE(TypeError, "__bool__ should return bool");
+            }
+        }
+    }
+
+    stack[*stack_current] = AS_PY_BOOL(result);
+    return NULL;
+}
+pyobj_t* py_opcode_contains(void** stack, int* stack_current, bool invert) {
+    pyobj_t* container = NOT_NULL(STACK_POP_INDIRECT());
+    pyobj_t* item = NOT_NULL(STACK_POP_INDIRECT());
+    pyobj_t* exception = NULL;
+    bool result = false;
+
+    if (PY_IS_SET(container)) {
+        exception = py_set_contains(container, item, &result);
+        if (exception != NULL)
+            return exception;
+    }
+    else if (container->type == &py_type_dict) {
+        exception = py_dict_contains(container, item, &result);
+        if (exception != NULL)
+            return exception;
+    }
+    else if (container->type == &py_type_list || container->type == &py_type_tuple) {
+        for (size_t i = 0; i < container->as_list.length && !result; i++) {
+            result = py_keys_equal(container->as_list.elements[i], item, &exception);
+            if (exception != NULL)
+                return exception;
+        }
+    }
+    else if (container->type == &py_type_str) {
+        if (item->type != &py_type_str)
+            return NEW_EXCEPTION_INLINE(TypeError, "'in <string>' requires string as left operand");
+
+        result = std_strfind(container->as_str, item->as_str) >= 0;
+    }
+    else if (PY_IS_BUFFER(container)) {
+        exception = py_buffer_contains(container, item, &result);
+        if (exception != NULL)
+            return exception;
+    }
+    else {
+        pyobj_t* method;
+        bool is_unbound = py_get_method_attribute(container, STR("__contains__"), &method);
+
+        if (method != NULL) {
+            pyreturn_t status = py_call(method, 1, &item, 0, NULL, is_unbound ? container : NULL);
+            if (status.exception != NULL)
+                return status.exception;
+
+            void* local[1] = { status.value };
+            int local_current = 0;
+
+            exception = py_opcode_to_bool(local, &local_current);
+            if (exception != NULL)
+                return exception;
+
+            result = ((pyobj_t*)local[0])->as_bool;
+        }
+        else {
+            // Without `__contains__`, we look for the item by iterating over the container.
+            void* local[2] = { container };
+            int local_current = 0;
+
+            pyreturn_t status = py_opcode_get_iter(local, &local_current);
+            if (status.exception != NULL)
+                return status.exception;
+
+            while (!result) {
+                bool exhausted = false;
+                status = py_opcode_for_iter(local, &local_current, &exhausted);
+                if (status.exception != NULL)
+                    return status.exception;
+
+                if (exhausted)
+                    break;
+
+                result = py_keys_equal((pyobj_t*)local[local_current--], item, &exception);
+                if (exception != NULL)
+                    return exception;
+            }
+        }
+    }
+
+    STACK_PUSH_INDIRECT(AS_PY_BOOL(result != invert));
+    return NULL;
+}
+
+pyobj_t* py_opcode_unpack_sequence(void** stack, int* stack_current, int count) {
+    pyobj_t* sequence = NOT_NULL(STACK_POP_INDIRECT());
+
+    if (sequence->type == &py_type_tuple || sequence->type == &py_type_list) {
+        if (sequence->as_list.length < (size_t)count)
+            return NEW_EXCEPTION_INLINE(ValueError, "not enough values to unpack");
+
+        if (sequence->as_list.length > (size_t)count)
+            return NEW_EXCEPTION_INLINE(ValueError, "too many values to unpack");
+
+        for (int i = count - 1; i >= 0; i--) {
+            STACK_PUSH_INDIRECT(sequence->as_list.elements[i]);
+        }
+
+        return NULL;
+    }
+
+    // Other iterables are consumed into a temporary list - we need to know whether there
+    // are exactly `count` items before pushing any of them.
+    void* local[2] = { sequence };
+    int local_current = 0;
+
+    pyreturn_t status = py_opcode_get_iter(local, &local_current);
+    if (status.exception != NULL)
+        return status.exception;
+
+    pyobj_t* items = py_alloc_list(count);
+
+    while (true) {
+        bool exhausted = false;
+        status = py_opcode_for_iter(local, &local_current, &exhausted);
+        if (status.exception != NULL)
+            return status.exception;
+
+        if (exhausted)
+            break;
+
+        if (items->as_list.length == (size_t)count)
+            return NEW_EXCEPTION_INLINE(ValueError, "too many values to unpack");
+
+        py_list_append(items, (pyobj_t*)local[local_current--]);
+    }
+
+    if (items->as_list.length < (size_t)count)
+        return NEW_EXCEPTION_INLINE(ValueError, "not enough values to unpack");
+
+    for (int i = count - 1; i >= 0; i--) {
+        STACK_PUSH_INDIRECT(items->as_list.elements[i]);
+    }
+
+    return NULL;
+}
+
+pyreturn_t py_opcode_call_function_ex(void** stack, int* stack_current, bool has_kwargs) {
+    pyobj_t* kwargs = has_kwargs ? NOT_NULL((pyobj_t*)STACK_POP_INDIRECT()) : NULL;
+    pyobj_t* args = NOT_NULL((pyobj_t*)STACK_POP_INDIRECT());
+    pyobj_t* self = (pyobj_t*)STACK_POP_INDIRECT();
+    pyobj_t* callable = (pyobj_t*)STACK_POP_INDIRECT();
+
+    if (args->type != &py_type_tuple && args->type != &py_type_list) {
+        pyobj_t* list = py_alloc_list(0);
+
+        pyobj_t* exception = py_list_extend(list, args);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        args = list;
+    }
+
+    int kwargc = 0;
+    symbol_t* kwargv = NULL;
+
+    if (kwargs != NULL) {
+        if (kwargs->type != &py_type_dict)
+            RAISE(TypeError, "argument after ** must be a dict");
+
+        kwargv = mm_heap_alloc((kwargs->as_dict->length + 1) * sizeof(symbol_t));
+
+        pyobj_t* iterator = py_alloc_dict_iterator(kwargs);
+        pyobj_t* key;
+        while ((key = py_dict_iterator_next(iterator)) != NULL) {
+            if (key->type != &py_type_str)
+                RAISE(TypeError, "keywords must be strings");
+
+            kwargv[kwargc].name = key->as_str;
+            kwargv[kwargc].value = UNWRAP(py_dict_getitem(kwargs, key));
+            kwargc++;
+        }
+    }
+
+    return py_call(
+        callable,
+        (int)args->as_list.length, args->as_list.elements,
+        kwargc, kwargv,
+        self
+    );
+}
@@ -4,6 +4,16 @@
 #include "symbols.h"
 #include "fragments.h"
 #include "exceptions.h"
+#include "generators.h"
+#include "lists.h"
+#include "dicts.h"
+#include "sets.h"
+#include "strings.h"
+#include "formatting.h"
+#include "slices.h"
+#include "buffers.h"
+#include "arrays.h"
+#include "matrices.h"
 #include "std/safety.h"
 
 // Performs a `CALL` on the given stack, reading the parameters and callable from the stack,
@@ -29,6 +39,66 @@
         STACK_PUSH() = result.value;                                                    \
     }
 
+// Performs a `CALL_KW`, which is like `CALL`, but with a tuple of the names of the keyword
+// arguments on top of the stack. The last `len(names)` of the `$argc` arguments are the values
+// of the keyword arguments, in the order of the names.
+#define PY_OPCODE_CALL_KW($argc, $exc_depth, $lasti)                                    \
+    {                                                                                   \
+        pyobj_t* kwnames = STACK_POP();                                                 \
+        int call_kwargc = (int)kwnames->as_list.length;                                 \
+        int call_argc = ($argc) - call_kwargc;                                          \
+        symbol_t call_kwargv[$argc];                                                    \
+        for (int i = call_kwargc - 1; i >= 0; i--) {                                    \
+            call_kwargv[i].name = kwnames->as_list.elements[i]->as_str;                 \
+            call_kwargv[i].value = STACK_POP();                                         \
+        }                                                                               \
+        pyobj_t* call_argv[$argc];                                                      \
+        for (int i = call_argc - 1; i >= 0; i--) {                                      \
+            call_argv[i] = STACK_POP();                                                 \
+        }                                                                               \
+        pyobj_t* self = STACK_POP();                                                    \
+        pyobj_t* callable = STACK_POP();                                                \
+        pyreturn_t result = py_call(                                                    \
+            callable, call_argc, call_argv, call_kwargc, call_kwargv, self              \
+        );                                                                              \
+        if (result.exception != NULL) {                                                 \
+            RAISE_CATCHABLE(result.exception, $exc_depth, $lasti);                      \
+        }                                                                               \
+        STACK_PUSH() = result.value;                                                    \
+    }
+
+// Performs a `CALL_FUNCTION_EX`, i.e. `f(*args)`, or `f(*args, **kwargs)` if the lowest bit
+// of `$flags` is set.
+//
+// On the stack are (in ascending order):
+//     - The callable
+//     - `NULL`
+//     - An iterable of the positional arguments
+//     - A `dict` of the keyword arguments, if the lowest bit of `$flags` is set
+//
+#define PY_OPCODE_CALL_FUNCTION_EX($flags, $exc_depth, $lasti)                          \
+    {                                                                                   \
+        pyreturn_t result = py_opcode_call_function_ex(                                 \
+            (void**)stack, &stack_current, (($flags) & 1) != 0                          \
+        );                                                                              \
+        if (result.exception != NULL) {                                                 \
+            RAISE_CATCHABLE(result.exception, $exc_depth, $lasti);                      \
+        }                                                                               \
+        STACK_PUSH() = result.value;                                                    \
+    }
+
+// Implements `INTRINSIC_LIST_TO_TUPLE`, which converts the `list` on top of the stack to
+// a `tuple`.
+#define PY_OPCODE_INTRINSIC_LIST_TO_TUPLE()                                             \
+    {                                                                                   \
+        pyobj_t* list = (pyobj_t*)STACK_PEEK();                                         \
+        pyobj_t* tuple = py_alloc_tuple(list->as_list.length);                          \
+        for (size_t i = 0; i < list->as_list.length; i++) {                             \
+            tuple->as_list.elements[i] = list->as_list.elements[i];                     \
+        }                                                                               \
+        STACK_PEEK() = tuple;                                                           \
+    }
+
 // Pops a value from the stack, and jumps to `$label` if the popped object has a boolean
 // value of `false`. Assumes that the object on the stack is an exact `bool` operand.
 // If the object is not of type `py_type_bool`, then the behavior is undefined.
@@ -89,6 +159,15 @@
         }                                                             \
     }
 
+// Performs `STACK[-1] = -STACK[-1]`.
+#define PY_OPCODE_UNARY_NEGATIVE($exc_depth, $lasti)                  \
+    {                                                                 \
+        pyobj_t* exc = py_opcode_unary_negative(stack, &stack_current); \
+        if (exc != NULL) {                                            \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                 \
+        }                                                             \
+    }
+
 // Performs the following:
 // ```
 //      obj = STACK.pop()
@@ -123,8 +202,8 @@
         pyobj_t* owner = (pyobj_t*)(STACK_POP());                                   \
         pyobj_t* attr;                                                              \
         bool is_unbound = py_get_method_attribute(owner, STR($name), &attr);        \
-        STACK_PUSH() = is_unbound ? owner : NULL;                                   \
         STACK_PUSH() = attr;                                                        \
+        STACK_PUSH() = is_unbound ? owner : NULL;                                   \
     }                     
 
 // Swap the top of the stack with the i-th element:
@@ -150,7 +229,7 @@
 // Implements `STACK[-1] = iter(STACK[-1])`.
 #define PY_OPCODE_GET_ITER($exc_depth, $lasti)                                      \
     {                                                                               \
-        pyreturn_t status = py_opcode_get_iter((void**)&stack, &stack_current);     \
+        pyreturn_t status = py_opcode_get_iter((void**)stack, &stack_current);     \
         if (status.exception != NULL) {                                             \
             RAISE_CATCHABLE(status.exception, $exc_depth, $lasti);                  \
         }                                                                           \
@@ -162,7 +241,7 @@
 #define PY_OPCODE_FOR_ITER($label, $exc_depth, $lasti)                                      \
     {                                                                                       \
         bool exhausted;                                                                     \
-        pyreturn_t status = py_opcode_for_iter((void**)&stack, &stack_current, &exhausted); \
+        pyreturn_t status = py_opcode_for_iter((void**)stack, &stack_current, &exhausted); \
         if (status.exception != NULL) {                                                     \
             RAISE_CATCHABLE(status.exception, $exc_depth, $lasti);                          \
         }                                                                                   \
@@ -170,6 +249,383 @@
             goto $label;                                                                    \
     }
 
+// Pops `$count` items from the stack, and pushes a `list` that holds them, in order.
+#define PY_OPCODE_BUILD_LIST($count)                                \
+    {                                                               \
+        pyobj_t* list = py_alloc_list($count);                      \
+        for (int i = 0; i < ($count); i++) {                        \
+            list->as_list.elements[i] = STACK_ITEM(($count) - i);   \
+        }                                                           \
+        list->as_list.length = ($count);                            \
+        stack_current -= ($count);                                  \
+        STACK_PUSH() = list;                                        \
+    }
+
+// Pops `$count` items from the stack, and pushes a `tuple` that holds them, in order.
+#define PY_OPCODE_BUILD_TUPLE($count)                               \
+    {                                                               \
+        pyobj_t* tuple = py_alloc_tuple($count);                    \
+        for (int i = 0; i < ($count); i++) {                        \
+            tuple->as_list.elements[i] = STACK_ITEM(($count) - i);  \
+        }                                                           \
+        stack_current -= ($count);                                  \
+        STACK_PUSH() = tuple;                                       \
+    }
+
+// Equivalent to `BUILD_TUPLE $count`, followed by `UNPACK_SEQUENCE $count` (e.g. in
+// `a, b, c, d = d, c, b, a`). Instead of allocating the tuple, the top `$count` items of
+// the stack are reversed in place.
+#define PY_OPCODE_BUILD_TUPLE_UNPACKED($count)                      \
+    {                                                               \
+        for (int i = 1; i <= ($count) / 2; i++) {                   \
+            void* tmp = STACK_ITEM(i);                              \
+            STACK_ITEM(i) = STACK_ITEM(($count) + 1 - i);           \
+            STACK_ITEM(($count) + 1 - i) = tmp;                     \
+        }                                                           \
+    }
+
+// Equivalent to `BUILD_LIST 0`, where the list is the accumulator of a list comprehension
+// that iterates over `STACK[-1]`. The list is pre-sized to fit the amount of elements the
+// iterator will most likely yield, so that `LIST_APPEND` doesn't have to grow it.
+#define PY_OPCODE_BUILD_LIST_PRESIZED()                                     \
+    {                                                                       \
+        pyobj_t* list = py_alloc_list(py_length_hint((pyobj_t*)STACK_PEEK())); \
+        STACK_PUSH() = list;                                                \
+    }
+
+// Performs the following:
+// ```
+//      item = STACK.pop()
+//      list.append(STACK[-i], item)
+// ```
+#define PY_OPCODE_LIST_APPEND($i)                                   \
+    {                                                               \
+        pyobj_t* item = (pyobj_t*)STACK_POP();                      \
+        py_list_append((pyobj_t*)STACK_ITEM($i), item);             \
+    }
+
+// Performs the following:
+// ```
+//      seq = STACK.pop()
+//      list.extend(STACK[-i], seq)
+// ```
+#define PY_OPCODE_LIST_EXTEND($i, $exc_depth, $lasti)                               \
+    {                                                                               \
+        pyobj_t* seq = (pyobj_t*)STACK_POP();                                       \
+        pyobj_t* exc = py_list_extend((pyobj_t*)STACK_ITEM($i), seq);               \
+        if (exc != NULL) {                                                          \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                               \
+        }                                                                           \
+    }
+
+// Implements `STACK[-2][STACK[-1]] = STACK[-3]`, popping all three values.
+#define PY_OPCODE_STORE_SUBSCR($exc_depth, $lasti)                                  \
+    {                                                                               \
+        pyobj_t* exc = py_opcode_store_subscr(stack, &stack_current);               \
+        if (exc != NULL) {                                                          \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                               \
+        }                                                                           \
+    }
+
+// Implements `del STACK[-2][STACK[-1]]`, popping both values.
+#define PY_OPCODE_DELETE_SUBSCR($exc_depth, $lasti)                                 \
+    {                                                                               \
+        pyobj_t* exc = py_opcode_delete_subscr(stack, &stack_current);              \
+        if (exc != NULL) {                                                          \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                               \
+        }                                                                           \
+    }
+
+// Performs the following:
+// ```
+//      end = STACK.pop()
+//      start = STACK.pop()
+//      container = STACK.pop()
+//      STACK.append(container[start:end])
+// ```
+#define PY_OPCODE_BINARY_SLICE($exc_depth, $lasti)                                  \
+    {                                                                               \
+        pyobj_t* exc = py_opcode_binary_slice(stack, &stack_current);               \
+        if (exc != NULL) {                                                          \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                               \
+        }                                                                           \
+    }
+
+// Performs the following:
+// ```
+//      end = STACK.pop()
+//      start = STACK.pop()
+//      container = STACK.pop()
+//      value = STACK.pop()
+//      container[start:end] = value
+// ```
+#define PY_OPCODE_STORE_SLICE($exc_depth, $lasti)                                   \
+    {                                                                               \
+        pyobj_t* exc = py_opcode_store_slice(stack, &stack_current);                \
+        if (exc != NULL) {                                                          \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                               \
+        }                                                                           \
+    }
+
+// Pops `$count` (either 2 or 3) items from the stack, and pushes a `slice` with them as
+// its `start`, `stop` and `step`.
+#define PY_OPCODE_BUILD_SLICE($count)                                               \
+    {                                                                               \
+        pyobj_t* step = ($count) == 3 ? (pyobj_t*)STACK_POP() : &py_none;           \
+        pyobj_t* stop = (pyobj_t*)STACK_POP();                                      \
+        pyobj_t* start = (pyobj_t*)STACK_POP();                                     \
+        STACK_PUSH() = py_alloc_slice(start, stop, step);                           \
+    }
+
+// Pops `2 * $count` items from the stack, and pushes a `dict` that maps each even-indexed
+// item to the item above it.
+#define PY_OPCODE_BUILD_MAP($count, $exc_depth, $lasti)                             \
+    {                                                                               \
+        pyobj_t* dict = py_alloc_dict($count);                                      \
+        for (int i = 0; i < ($count); i++) {                                        \
+            pyobj_t* exc = py_dict_setitem(                                         \
+                dict,                                                               \
+                STACK_ITEM(2 * ($count) - 2 * i),                                   \
+                STACK_ITEM(2 * ($count) - 2 * i - 1)                                \
+            );                                                                      \
+            if (exc != NULL) {                                                      \
+                RAISE_CATCHABLE(exc, $exc_depth, $lasti);                           \
+            }                                                                       \
+        }                                                                           \
+        stack_current -= 2 * ($count);                                              \
+        STACK_PUSH() = dict;                                                        \
+    }
+
+// Pops a tuple of `$count` keys, and `$count` values below it, and pushes a `dict` that
+// maps the keys to the values, in order.
+#define PY_OPCODE_BUILD_CONST_KEY_MAP($count, $exc_depth, $lasti)                   \
+    {                                                                               \
+        pyobj_t* keys = (pyobj_t*)STACK_POP();                                      \
+        pyobj_t* dict = py_alloc_dict($count);                                      \
+        for (int i = 0; i < ($count); i++) {                                        \
+            pyobj_t* exc = py_dict_setitem(                                         \
+                dict,                                                               \
+                keys->as_list.elements[i],                                          \
+                STACK_ITEM(($count) - i)                                            \
+            );                                                                      \
+            if (exc != NULL) {                                                      \
+                RAISE_CATCHABLE(exc, $exc_depth, $lasti);                           \
+            }                                                                       \
+        }                                                                           \
+        stack_current -= ($count);                                                  \
+        STACK_PUSH() = dict;                                                        \
+    }
+
+// Performs the following:
+// ```
+//      value = STACK.pop()
+//      key = STACK.pop()
+//      dict.__setitem__(STACK[-i], key, value)
+// ```
+#define PY_OPCODE_MAP_ADD($i, $exc_depth, $lasti)                                   \
+    {                                                                               \
+        pyobj_t* value = (pyobj_t*)STACK_POP();                                     \
+        pyobj_t* key = (pyobj_t*)STACK_POP();                                       \
+        pyobj_t* exc = py_dict_setitem((pyobj_t*)STACK_ITEM($i), key, value);       \
+        if (exc != NULL) {                                                          \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                               \
+        }                                                                           \
+    }
+
+// Performs the following:
+// ```
+//      map = STACK.pop()
+//      dict.update(STACK[-i], map)
+// ```
+#define PY_OPCODE_DICT_UPDATE($i, $exc_depth, $lasti)                               \
+    {                                                                               \
+        pyobj_t* map = (pyobj_t*)STACK_POP();                                       \
+        pyobj_t* exc = py_dict_update((pyobj_t*)STACK_ITEM($i), map);               \
+        if (exc != NULL) {                                                          \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                               \
+        }                                                                           \
+    }
+
+// Pops `$count` items from the stack, and pushes a `set` that contains them.
+#define PY_OPCODE_BUILD_SET($count, $exc_depth, $lasti)                             \
+    {                                                                               \
+        pyobj_t* set = py_alloc_set(&py_type_set);                                  \
+        for (int i = ($count); i > 0; i--) {                                        \
+            pyobj_t* exc = py_set_add(set, STACK_ITEM(i));                          \
+            if (exc != NULL) {                                                      \
+                RAISE_CATCHABLE(exc, $exc_depth, $lasti);                           \
+            }                                                                       \
+        }                                                                           \
+        stack_current -= ($count);                                                  \
+        STACK_PUSH() = set;                                                         \
+    }
+
+// Performs the following:
+// ```
+//      item = STACK.pop()
+//      set.add(STACK[-i], item)
+// ```
+#define PY_OPCODE_SET_ADD($i, $exc_depth, $lasti)                                   \
+    {                                                                               \
+        pyobj_t* item = (pyobj_t*)STACK_POP();                                      \
+        pyobj_t* exc = py_set_add((pyobj_t*)STACK_ITEM($i), item);                  \
+        if (exc != NULL) {                                                          \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                               \
+        }                                                                           \
+    }
+
+// Performs the following:
+// ```
+//      seq = STACK.pop()
+//      set.update(STACK[-i], seq)
+// ```
+#define PY_OPCODE_SET_UPDATE($i, $exc_depth, $lasti)                                \
+    {                                                                               \
+        pyobj_t* seq = (pyobj_t*)STACK_POP();                                       \
+        pyobj_t* exc = py_set_update((pyobj_t*)STACK_ITEM($i), seq);                \
+        if (exc != NULL) {                                                          \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                               \
+        }                                                                           \
+    }
+
+// Concatenates the `$count` strings on top of the stack into a single `str`, which is
+// pushed instead.
+#define PY_OPCODE_BUILD_STRING($count)                                              \
+    {                                                                               \
+        pyobj_t* str = py_str_build((pyobj_t**)&STACK_ITEM($count), ($count));      \
+        stack_current -= ($count);                                                  \
+        STACK_PUSH() = str;                                                         \
+    }
+
+// Replaces the value on top of the stack with the result of `format(value)`.
+#define PY_OPCODE_FORMAT_SIMPLE($exc_depth, $lasti)                                 \
+    {                                                                               \
+        pyreturn_t result = py_format_simple((pyobj_t*)STACK_ITEM(1));              \
+        if (result.exception != NULL) {                                             \
+            RAISE_CATCHABLE(result.exception, $exc_depth, $lasti);                  \
+        }                                                                           \
+        STACK_ITEM(1) = result.value;                                               \
+    }
+
+// Pops a format specification, and replaces the value below it with the result of
+// `format(value, spec)`.
+#define PY_OPCODE_FORMAT_WITH_SPEC($exc_depth, $lasti)                              \
+    {                                                                               \
+        pyobj_t* spec = (pyobj_t*)STACK_POP();                                      \
+        pyreturn_t result = py_format((pyobj_t*)STACK_ITEM(1), spec);               \
+        if (result.exception != NULL) {                                             \
+            RAISE_CATCHABLE(result.exception, $exc_depth, $lasti);                  \
+        }                                                                           \
+        STACK_ITEM(1) = result.value;                                               \
+    }
+
+// Applies the conversion of an f-string replacement field (`!s`, `!r` or `!a`) to the
+// value on top of the stack. See `py_str_convert`.
+#define PY_OPCODE_CONVERT_VALUE($conversion, $exc_depth, $lasti)                    \
+    {                                                                               \
+        pyreturn_t result = py_str_convert((pyobj_t*)STACK_ITEM(1), ($conversion)); \
+        if (result.exception != NULL) {                                             \
+            RAISE_CATCHABLE(result.exception, $exc_depth, $lasti);                  \
+        }                                                                           \
+        STACK_ITEM(1) = result.value;                                               \
+    }
+
+// Implements `STACK[-2] in STACK[-1]`, or `STACK[-2] not in STACK[-1]` if `$invert` is
+// `true`, popping both values and pushing the result.
+#define PY_OPCODE_CONTAINS_OP($invert, $exc_depth, $lasti)                          \
+    {                                                                               \
+        pyobj_t* exc = py_opcode_contains(stack, &stack_current, ($invert));        \
+        if (exc != NULL) {                                                          \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                               \
+        }                                                                           \
+    }
+
+// Pops an iterable from the stack, and pushes its `$count` items in reverse order, so that
+// the first one ends up on top. Raises a `ValueError` if the iterable does not have
+// exactly `$count` items.
+#define PY_OPCODE_UNPACK_SEQUENCE($count, $exc_depth, $lasti)                       \
+    {                                                                               \
+        pyobj_t* exc = py_opcode_unpack_sequence(stack, &stack_current, ($count));  \
+        if (exc != NULL) {                                                          \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                               \
+        }                                                                           \
+    }
+
+// Evaluates to `true` if the callable of a `CALL` with `$argc` arguments is the transpiled
+// function `$fn`.
+#define PY_IS_FUNCTION_CALL($fn, $argc)                                              \
+    (                                                                               \
+        STACK_ITEM(($argc) + 2) != NULL &&                                          \
+        ((pyobj_t*)STACK_ITEM(($argc) + 2))->type == &py_type_function &&           \
+        ((pyobj_t*)STACK_ITEM(($argc) + 2))->as_function == &($fn)                  \
+    )
+
+// Equivalent to a `CALL` with `$argc` arguments, followed by `UNPACK_SEQUENCE $count`,
+// where the callable is the function that wraps over `$values_fn`, defined with
+// `PY_DEFINE_VALUES`. The arguments are passed straight from the stack, and the returned
+// values are pushed without allocating a tuple.
+#define PY_CALL_VALUES($values_fn, $argc, $count, $exc_depth, $lasti)               \
+    {                                                                               \
+        pyobj_t* call_values[$count];                                               \
+        pyreturn_t result = $values_fn(                                             \
+            STACK_ITEM(($argc) + 1), ($argc), (pyobj_t**)&STACK_ITEM($argc),        \
+            0, NULL, call_values                                                    \
+        );                                                                          \
+        if (result.exception != NULL) {                                             \
+            RAISE_CATCHABLE(result.exception, $exc_depth, $lasti);                  \
+        }                                                                           \
+        stack_current -= ($argc) + 2;                                               \
+        for (int i = ($count) - 1; i >= 0; i--) {                                   \
+            STACK_PUSH() = call_values[i];                                          \
+        }                                                                           \
+    }
+
+// Returns the tuple of `$count` items on top of the stack from a `PY_DEFINE_VALUES`
+// function - this replaces `BUILD_TUPLE $count`, followed by `RETURN_VALUE`.
+#define PY_RETURN_VALUES($count)                                    \
+    {                                                               \
+        for (int i = 0; i < ($count); i++) {                        \
+            values[i] = STACK_ITEM(($count) - i);                   \
+        }                                                           \
+        return WITH_RESULT(NULL);                                   \
+    }
+
+// Returns the items of the constant tuple `$const` from a `PY_DEFINE_VALUES` function.
+#define PY_RETURN_CONST_VALUES($const, $count)                      \
+    {                                                               \
+        for (int i = 0; i < ($count); i++) {                        \
+            values[i] = ($const).as_list.elements[i];               \
+        }                                                           \
+        return WITH_RESULT(NULL);                                   \
+    }
+
+// Serves as the body of a transpiled function that wraps over `$values_fn`, defined with
+// `PY_DEFINE_VALUES`, packing the `$count` values it returns into a tuple.
+#define PY_RETURN_VALUES_AS_TUPLE($values_fn, $count)               \
+    {                                                               \
+        pyobj_t* values[$count] = {};                               \
+        pyreturn_t result = $values_fn(                             \
+            self, argc, argv, kwargc, kwargv, values                \
+        );                                                          \
+        if (result.exception != NULL)                               \
+            return result;                                          \
+                                                                    \
+        pyobj_t* tuple = py_alloc_tuple($count);                    \
+        for (int i = 0; i < ($count); i++) {                        \
+            tuple->as_list.elements[i] = values[i];                 \
+        }                                                           \
+        return WITH_RESULT(tuple);                                  \
+    }
+
+// Implements `STACK[-1] = bool(STACK[-1])`.
+#define PY_OPCODE_TO_BOOL($exc_depth, $lasti)                                       \
+    {                                                                               \
+        pyobj_t* exc = py_opcode_to_bool(stack, &stack_current);                    \
+        if (exc != NULL) {                                                          \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                               \
+        }                                                                           \
+    }
+
 // Special case for the `LOAD_NAME` op-code, where the op-code is present within
 // a class initialization function (passed into `builtins.__build_class__`).
 // Locals are equivalent to `self` attributes in class bodies.
@@ -179,8 +635,110 @@
         KNOWN_GLOBAL($name)                                  \
     );
 
+// Present at the top of the bodies of resumable functions (see `generators.h`). If the
+// frame was suspended before, jumps to the point where it left off.
+#define PY_RESUMABLE_PROLOGUE()                             \
+    if (frame->resume_point != NULL)                        \
+        goto *frame->resume_point;
+
+// Returns from a resumable function, marking its frame as finished.
+#define PY_RESUMABLE_RETURN($value)                         \
+    {                                                       \
+        frame->state = PY_FRAME_FINISHED;                   \
+        return WITH_RESULT($value);                         \
+    }
+
+// In resumable functions, the frame (and thus, the generator or coroutine) is created
+// before the body starts executing. We only push a placeholder for the `POP_TOP` that
+// always follows this op-code.
+#define PY_OPCODE_RETURN_GENERATOR()                        \
+    STACK_PUSH() = &py_none;
+
+// Suspends the frame, yielding `STACK[-1]` to the caller. When the frame gets resumed,
+// execution continues from `$resume_label`, with the sent value pushed to the stack.
+#define PY_OPCODE_YIELD_VALUE($resume_label)                \
+    frame->resume_point = &&$resume_label;                  \
+    frame->state = PY_FRAME_SUSPENDED;                      \
+    return WITH_RESULT((pyobj_t*)STACK_POP());              \
+    $resume_label:                                          \
+    STACK_PUSH() = sent;
+
+// Implements `STACK[-1] = get_awaitable(STACK[-1])`.
+#define PY_OPCODE_GET_AWAITABLE($exc_depth, $lasti)                                 \
+    {                                                                               \
+        pyreturn_t status = py_opcode_get_awaitable((void**)stack, &stack_current); \
+        if (status.exception != NULL) {                                             \
+            RAISE_CATCHABLE(status.exception, $exc_depth, $lasti);                  \
+        }                                                                           \
+    }
+
+// Implements `STACK[-1] = get_yield_from_iter(STACK[-1])`, for `yield from`.
+#define PY_OPCODE_GET_YIELD_FROM_ITER($exc_depth, $lasti)                               \
+    {                                                                                   \
+        pyreturn_t status = py_opcode_get_yield_from_iter((void**)stack, &stack_current); \
+        if (status.exception != NULL) {                                                 \
+            RAISE_CATCHABLE(status.exception, $exc_depth, $lasti);                      \
+        }                                                                               \
+    }
+
+// Sends `STACK[-1]` into the receiver at `STACK[-2]`, replacing `STACK[-1]` with the
+// yielded value. If the receiver finishes instead, `STACK[-1]` is replaced with its return
+// value, and execution continues at `$label`.
+#define PY_OPCODE_SEND($label, $exc_depth, $lasti)                                  \
+    {                                                                               \
+        pyobj_t* send_result;                                                       \
+        py_send_status_t send_status = py_send(                                     \
+            (pyobj_t*)STACK_ITEM(2),                                                \
+            (pyobj_t*)STACK_PEEK(),                                                 \
+            &send_result                                                            \
+        );                                                                          \
+        if (send_status == PY_SEND_RAISED) {                                        \
+            RAISE_CATCHABLE(send_result, $exc_depth, $lasti);                       \
+        }                                                                           \
+        STACK_PEEK() = send_result;                                                 \
+        if (send_status == PY_SEND_RETURNED)                                        \
+            goto $label;                                                            \
+    }
+
+// Removes the second-to-top item from the stack (the receiver used by `SEND`).
+#define PY_OPCODE_END_SEND()                                \
+    {                                                       \
+        pyobj_t* tmp = (pyobj_t*)(STACK_POP());             \
+        STACK_PEEK() = tmp;                                 \
+    }
+
+// Handles an exception raised while delegating to a sub-iterator. If `STACK[-1]` is a
+// `StopIteration`, three values are popped, and its value is pushed. Otherwise, `STACK[-1]`
+// is re-raised.
+#define PY_OPCODE_CLEANUP_THROW($exc_depth, $lasti)                                 \
+    {                                                                               \
+        pyobj_t* exc = (pyobj_t*)STACK_PEEK();                                      \
+        if (!py_isinstance(exc, &py_type_StopIteration)) {                          \
+            RAISE_CATCHABLE(exc, $exc_depth, $lasti);                               \
+        }                                                                           \
+        stack_current -= 3;                                                         \
+        STACK_PUSH() = COALESCE_2(py_get_attribute(exc, STR("value")), &py_none);   \
+    }
+
+// Implements `INTRINSIC_STOPITERATION_ERROR`, which is invoked when a `StopIteration`
+// escapes the body of a generator. Such an exception is replaced with a `RuntimeError`.
+#define PY_OPCODE_INTRINSIC_STOPITERATION_ERROR()                                           \
+    if (py_isinstance((pyobj_t*)STACK_PEEK(), &py_type_StopIteration)) {                    \
+        STACK_PEEK() = NEW_EXCEPTION_INLINE(RuntimeError, "generator raised StopIteration"); \
+    }
+
 // The following functions are implemented in 'opcodes.c'.
 
+// Compliments `PY_OPCODE_GET_AWAITABLE`.
+pyreturn_t py_opcode_get_awaitable(void** stack, int* stack_current);
+
+// Compliments `PY_OPCODE_GET_YIELD_FROM_ITER`.
+pyreturn_t py_opcode_get_yield_from_iter(void** stack, int* stack_current);
+
+// Compliments `PY_OPCODE_CALL_FUNCTION_EX`. Returns an exception or the return value of
+// the call.
+pyreturn_t py_opcode_call_function_ex(void** stack, int* stack_current, bool has_kwargs);
+
 // Compliments `PY_OPCODE_FOR_ITER`. `out_exhausted` is set to `true` if the iterator
 // was exhausted and the byte code counter should be incremented by delta. If the
 // return value has an associated exception, it should be raised.
@@ -189,6 +747,27 @@ pyreturn_t py_opcode_for_iter(void** stack, int* stack_current, bool* out_exhaus
 // Compliments `PY_OPCODE_GET_ITER`.
 pyreturn_t py_opcode_get_iter(void** stack, int* stack_current);
 
+// Compliments `PY_OPCODE_STORE_SUBSCR`. Returns an exception or NULL.
+pyobj_t* py_opcode_store_subscr(void** stack, int* stack_current);
+
+// Compliments `PY_OPCODE_DELETE_SUBSCR`. Returns an exception or NULL.
+pyobj_t* py_opcode_delete_subscr(void** stack, int* stack_current);
+
+// Compliments `PY_OPCODE_BINARY_SLICE`. Returns an exception or NULL.
+pyobj_t* py_opcode_binary_slice(void** stack, int* stack_current);
+
+// Compliments `PY_OPCODE_STORE_SLICE`. Returns an exception or NULL.
+pyobj_t* py_opcode_store_slice(void** stack, int* stack_current);
+
+// Compliments `PY_OPCODE_TO_BOOL`. Returns an exception or NULL.
+pyobj_t* py_opcode_to_bool(void** stack, int* stack_current);
+
+// Compliments `PY_OPCODE_CONTAINS_OP`. Returns an exception or NULL.
+pyobj_t* py_opcode_contains(void** stack, int* stack_current, bool invert);
+
+// Compliments `PY_OPCODE_UNPACK_SEQUENCE`. Returns an exception or NULL.
+pyobj_t* py_opcode_unpack_sequence(void** stack, int* stack_current, int count);
+
 // The following functions are implemented in 'opcodes_cmp.c'.
 
 // Equivalent to `right < left`, where `right` and `left` are placed on the stack. Returns an exception or NULL.
@@ -244,6 +823,9 @@ pyobj_t* py_opcode_op_rsh(void** stack, int* stack_current);
 // Equivalent to `right - left`, where `right` and `left` are placed on the stack. Returns an exception or NULL.
 pyobj_t* py_opcode_op_sub(void** stack, int* stack_current);
 
+// Equivalent to `right / left`, where `right` and `left` are placed on the stack. Returns an exception or NULL.
+pyobj_t* py_opcode_op_truediv(void** stack, int* stack_current);
+
 // Equivalent to `right ^ left`, where `right` and `left` are placed on the stack. Returns an exception or NULL.
 pyobj_t* py_opcode_op_xor(void** stack, int* stack_current);
 
@@ -280,8 +862,14 @@ pyobj_t* py_opcode_op_irsh(void** stack, int* stack_current);
 // Equivalent to `right -= left`, where `right` and `left` are placed on the stack. Returns an exception or NULL.
 pyobj_t* py_opcode_op_isub(void** stack, int* stack_current);
 
+// Equivalent to `right /= left`, where `right` and `left` are placed on the stack. Returns an exception or NULL.
+pyobj_t* py_opcode_op_itruediv(void** stack, int* stack_current);
+
 // Equivalent to `right ^= left`, where `right` and `left` are placed on the stack. Returns an exception or NULL.
 pyobj_t* py_opcode_op_ixor(void** stack, int* stack_current);
 
 // Equivalent to `right[left]`, where `right` and `left` are placed on the stack. Returns an exception or NULL.
 pyobj_t* py_opcode_op_subscr(void** stack, int* stack_current);
+
+// Equivalent to `-value`, where `value` is placed on the stack. Returns an exception or NULL.
+pyobj_t* py_opcode_unary_negative(void** stack, int* stack_current);
@@ -1,5 +1,6 @@
 #include "opcodes.h"
 
+#include "ints.h"
 #include "sys/core.h"
 #include "std/string.h"
 #include "std/safety.h"
@@ -11,17 +12,144 @@
 
 #define BOTH_OF_TYPE($type) (right->type == ($type) && left->type == ($type))
 
+// Handles comparisons between two sets, where ordering means inclusion - `a <= b` if `a`
+// is a subset of `b`. `$a` and `$b` are the operands of the subset test, and if `$strict`
+// is `true`, they also have to differ in length.
+#define SET_COMPARISON($a, $b, $strict)                                  \
+    if (PY_IS_SET(right) && PY_IS_SET(left)) {                           \
+        bool result;                                                     \
+        pyobj_t* exception = py_set_is_subset($a, $b, &result);          \
+        if (exception != NULL)                                           \
+            return exception;                                            \
+        if ($strict) {                                                   \
+            result = result && py_set_length($a) != py_set_length($b);   \
+        }                                                                \
+        STACK_PUSH_INDIRECT(AS_PY_BOOL(result));                         \
+        return NULL;                                                     \
+    }                                                                    \
+
+// Handles equality comparisons between two sets, pushing `$equal` if they're equal, and
+// its negation otherwise.
+#define SET_EQUALITY($equal)                                             \
+    if (PY_IS_SET(right) && PY_IS_SET(left)) {                           \
+        bool result;                                                     \
+        pyobj_t* exception = py_set_equal(right, left, &result);         \
+        if (exception != NULL)                                           \
+            return exception;                                            \
+        STACK_PUSH_INDIRECT(AS_PY_BOOL(result == ($equal)));             \
+        return NULL;                                                     \
+    }                                                                    \
+
+// Handles equality comparisons between two `list`s or two `tuple`s, pushing `$equal` if
+// they're equal, and its negation otherwise.
+#define SEQUENCE_EQUALITY($equal)                                        \
+    if (BOTH_OF_TYPE(&py_type_list) || BOTH_OF_TYPE(&py_type_tuple)) {   \
+        bool result;                                                     \
+        pyobj_t* exception = py_sequences_equal(right, left, &result);   \
+        if (exception != NULL)                                           \
+            return exception;                                            \
+        STACK_PUSH_INDIRECT(AS_PY_BOOL(result == ($equal)));             \
+        return NULL;                                                     \
+    }                                                                    \
+
+// Handles equality comparisons between two `dict`s, pushing `$equal` if they're equal, and
+// its negation otherwise.
+#define DICT_EQUALITY($equal)                                            \
+    if (BOTH_OF_TYPE(&py_type_dict)) {                                   \
+        bool result;                                                     \
+        pyobj_t* exception = py_dicts_equal(right, left, &result);       \
+        if (exception != NULL)                                           \
+            return exception;                                            \
+        STACK_PUSH_INDIRECT(AS_PY_BOOL(result == ($equal)));             \
+        return NULL;                                                     \
+    }                                                                    \
+
+// Handles equality comparisons between two `bytes`, `bytearray` or `memoryview` objects,
+// pushing `$equal` if they're equal, and its negation otherwise.
+#define BUFFER_EQUALITY($equal)                                          \
+    if (PY_IS_BUFFER(right) && PY_IS_BUFFER(left)) {                     \
+        bool result = py_buffers_equal(right, left);                     \
+        STACK_PUSH_INDIRECT(AS_PY_BOOL(result == ($equal)));             \
+        return NULL;                                                     \
+    }                                                                    \
+
+// Handles equality comparisons between two `array`s, pushing `$equal` if they're equal, and
+// its negation otherwise.
+#define ARRAY_EQUALITY($equal)                                           \
+    if (PY_IS_ARRAY(right) && PY_IS_ARRAY(left)) {                       \
+        bool result = py_arrays_equal(right, left);                      \
+        STACK_PUSH_INDIRECT(AS_PY_BOOL(result == ($equal)));             \
+        return NULL;                                                     \
+    }                                                                    \
+
+// Handles equality comparisons between two `matrix` objects, pushing `$equal` if they're
+// equal, and its negation otherwise.
+#define MATRIX_EQUALITY($equal)                                          \
+    if (PY_IS_MATRIX(right) && PY_IS_MATRIX(left)) {                     \
+        bool result = py_matrices_equal(right, left);                    \
+        STACK_PUSH_INDIRECT(AS_PY_BOOL(result == ($equal)));             \
+        return NULL;                                                     \
+    }                                                                    \
+
+// Handles comparisons between two `list`s or two `tuple`s, which are ordered
+// lexicographically. The first elements that differ are compared with `$compare_fn`,
+// and if there are none, the lengths are compared instead.
+#define SEQUENCE_COMPARISON($op, $compare_fn)                                    \
+    if (BOTH_OF_TYPE(&py_type_list) || BOTH_OF_TYPE(&py_type_tuple)) {           \
+        size_t index;                                                            \
+        pyobj_t* exception = py_sequences_mismatch(right, left, &index);         \
+        if (exception != NULL)                                                   \
+            return exception;                                                    \
+        if (index >= right->as_list.length || index >= left->as_list.length) {   \
+            STACK_PUSH_INDIRECT(AS_PY_BOOL(right->as_list.length $op left->as_list.length)); \
+            return NULL;                                                         \
+        }                                                                        \
+        STACK_PUSH_INDIRECT(right->as_list.elements[index]);                     \
+        STACK_PUSH_INDIRECT(left->as_list.elements[index]);                      \
+        return $compare_fn(stack, stack_current, coerce_to_bool);                \
+    }                                                                            \
+
+// Handles comparisons between two `str`s, which are ordered lexicographically.
+#define STR_COMPARISON($op)                                              \
+    if (BOTH_OF_TYPE(&py_type_str)) {                                    \
+        int order = std_strcompare(right->as_str, left->as_str);         \
+        STACK_PUSH_INDIRECT(AS_PY_BOOL(order $op 0));                    \
+        return NULL;                                                     \
+    }                                                                    \
+
 #define INT_COMPARISON($op)                                              \
     if (BOTH_OF_TYPE(&py_type_int)) {                                    \
-        STACK_PUSH_INDIRECT(AS_PY_BOOL(right->as_int $op left->as_int)); \
+        bool result = PY_INT_IS_SMALL(right) && PY_INT_IS_SMALL(left)    \
+            ? right->as_int $op left->as_int                             \
+            : py_int_compare(right, left) $op 0;                         \
+        STACK_PUSH_INDIRECT(AS_PY_BOOL(result));                         \
         return NULL;                                                     \
     }                                                                    \
 
+// Handles comparisons between two `float`s, as well as mixed `int` and `float` comparisons.
+// The latter are exact - the `int` is never rounded. If the `float` is NaN, we compare it
+// with zero instead, which yields the unordered result of IEEE-754 for `$op`.
 #define FLOAT_COMPARISON($op)                                            \
     if (BOTH_OF_TYPE(&py_type_float)) {                                  \
         STACK_PUSH_INDIRECT(AS_PY_BOOL(right->as_float $op left->as_float));      \
         return NULL;                                                     \
     }                                                                    \
+    if (right->type == &py_type_int && left->type == &py_type_float) {   \
+        int order;                                                       \
+        bool result = py_int_compare_float(right, left->as_float, &order)  \
+            ? order $op 0                                                \
+            : 0.0 $op left->as_float;                                    \
+        STACK_PUSH_INDIRECT(AS_PY_BOOL(result));                         \
+        return NULL;                                                     \
+    }                                                                    \
+    if (right->type == &py_type_float && left->type == &py_type_int) {   \
+        int order;                                                       \
+        bool result = py_int_compare_float(left, right->as_float, &order)  \
+            ? 0 $op order                                                \
+            : right->as_float $op 0.0;                                   \
+        STACK_PUSH_INDIRECT(AS_PY_BOOL(result));                         \
+        return NULL;                                                     \
+    }                                                                    \
 
 static bool arbitrary_compare_side(
     pyobj_t* side1,
@@ -32,18 +160,14 @@ static bool arbitrary_compare_side(
     int* stack_current
 ) {
     pyobj_t* compare_fn;
+    bool is_unbound = py_get_method_attribute(side1, attr_name, &compare_fn);
 
-    if (
-        !py_get_method_attribute(side1, attr_name, &compare_fn) ||
-        compare_fn == NULL ||
-        compare_fn->type != &py_type_method
-    ) {
+    if (compare_fn == NULL)
         return false;
-    }
 
     pyobj_t* args[] = { side2 };
 
-    pyreturn_t result = py_call(compare_fn, 1, args, 0, NULL, side1);
+    pyreturn_t result = py_call(compare_fn, 1, args, 0, NULL, is_unbound ? side1 : NULL);
     if (result.exception != NULL) {
         *out_exception = result.exception;
     }
@@ -74,15 +198,19 @@ static bool arbitrary_compare(
 pyobj_t* py_opcode_compare_equ(void** stack, int* stack_current, bool coerce_to_bool) {
     COMPARE_PROLOG;
     INT_COMPARISON(==);
-    // FLOAT_COMPARISON(==);
+    FLOAT_COMPARISON(==);
+    SET_EQUALITY(true);
+    SEQUENCE_EQUALITY(true);
+    DICT_EQUALITY(true);
+    BUFFER_EQUALITY(true);
+    ARRAY_EQUALITY(true);
+    MATRIX_EQUALITY(true);
 
     if (BOTH_OF_TYPE(&py_type_str)) {
         STACK_PUSH_INDIRECT(AS_PY_BOOL(std_strequ(right->as_str, left->as_str)));
         return NULL;
     }
 
-    // TODO: comparison between float and int
-
     pyobj_t* exception = NULL;
     if (arbitrary_compare(stack, stack_current, STR("__eq__"), right, left, &exception))
         return exception;
@@ -95,15 +223,19 @@ pyobj_t* py_opcode_compare_equ(void** stack, int* stack_current, bool coerce_to_
 pyobj_t* py_opcode_compare_neq(void** stack, int* stack_current, bool coerce_to_bool) {
     COMPARE_PROLOG;
     INT_COMPARISON(!=);
-    // FLOAT_COMPARISON(!=);
+    FLOAT_COMPARISON(!=);
+    SET_EQUALITY(false);
+    SEQUENCE_EQUALITY(false);
+    DICT_EQUALITY(false);
+    BUFFER_EQUALITY(false);
+    ARRAY_EQUALITY(false);
+    MATRIX_EQUALITY(false);
 
     if (BOTH_OF_TYPE(&py_type_str)) {
         STACK_PUSH_INDIRECT(AS_PY_BOOL(!std_strequ(right->as_str, left->as_str)));
         return NULL;
     }
 
-    // TODO: comparison between float and int
-
     pyobj_t* exception = NULL;
     if (arbitrary_compare(stack, stack_current, STR("__ne__"), right, left, &exception))
         return exception;
@@ -116,9 +248,10 @@ pyobj_t* py_opcode_compare_neq(void** stack, int* stack_current, bool coerce_to_
 pyobj_t* py_opcode_compare_lt(void** stack, int* stack_current, bool coerce_to_bool) {
     COMPARE_PROLOG;
     INT_COMPARISON(<);
-    // FLOAT_COMPARISON(<);
-
-    // TODO: comparison between float and int
+    FLOAT_COMPARISON(<);
+    STR_COMPARISON(<);
+    SEQUENCE_COMPARISON(<, py_opcode_compare_lt);
+    SET_COMPARISON(right, left, true);
 
     pyobj_t* exception = NULL;
     if (arbitrary_compare(stack, stack_current, STR("__lt__"), right, left, &exception))
@@ -130,9 +263,10 @@ pyobj_t* py_opcode_compare_lt(void** stack, int* stack_current, bool coerce_to_b
 pyobj_t* py_opcode_compare_lte(void** stack, int* stack_current, bool coerce_to_bool) {
     COMPARE_PROLOG;
     INT_COMPARISON(<=);
-    // FLOAT_COMPARISON(<=);
-
-    // TODO: comparison between float and int
+    FLOAT_COMPARISON(<=);
+    STR_COMPARISON(<=);
+    SEQUENCE_COMPARISON(<=, py_opcode_compare_lte);
+    SET_COMPARISON(right, left, false);
 
     pyobj_t* exception = NULL;
     if (arbitrary_compare(stack, stack_current, STR("__le__"), right, left, &exception))
@@ -144,9 +278,10 @@ pyobj_t* py_opcode_compare_lte(void** stack, int* stack_current, bool coerce_to_
 pyobj_t* py_opcode_compare_gt(void** stack, int* stack_current, bool coerce_to_bool) {
     COMPARE_PROLOG;
     INT_COMPARISON(>);
-    // FLOAT_COMPARISON(>);
-
-    // TODO: comparison between float and int
+    FLOAT_COMPARISON(>);
+    STR_COMPARISON(>);
+    SEQUENCE_COMPARISON(>, py_opcode_compare_gt);
+    SET_COMPARISON(left, right, true);
 
     pyobj_t* exception = NULL;
     if (arbitrary_compare(stack, stack_current, STR("__gt__"), right, left, &exception))
@@ -158,9 +293,10 @@ pyobj_t* py_opcode_compare_gt(void** stack, int* stack_current, bool coerce_to_b
 pyobj_t* py_opcode_compare_gte(void** stack, int* stack_current, bool coerce_to_bool) {
     COMPARE_PROLOG;
     INT_COMPARISON(>=);
-    // FLOAT_COMPARISON(>=);
-
-    // TODO: comparison between float and int
+    FLOAT_COMPARISON(>=);
+    STR_COMPARISON(>=);
+    SEQUENCE_COMPARISON(>=, py_opcode_compare_gte);
+    SET_COMPARISON(left, right, false);
 
     pyobj_t* exception = NULL;
     if (arbitrary_compare(stack, stack_current, STR("__ge__"), right, left, &exception))
@@ -1,5 +1,15 @@
 #include "opcodes.h"
 
+#include "ints.h"
+#include "floats.h"
+#include "lists.h"
+#include "dicts.h"
+#include "sets.h"
+#include "strings.h"
+#include "slices.h"
+#include "buffers.h"
+#include "arrays.h"
+#include "matrices.h"
 #include "sys/core.h"
 #include "std/safety.h"
 #include "std/stringop.h"
@@ -10,18 +20,197 @@
 
 #define OPERATION_EPILOG($method, $op)                                                  \
     pyobj_t* exception = NULL;                                                          \
-    arbitrary_op(stack, stack_current, STR($method), right, left, &exception);          \
-    if (exception != NULL)                                                              \
+    if (arbitrary_op(stack, stack_current, STR($method), right, left, &exception))      \
         return exception;                                                               \
     return NEW_EXCEPTION_INLINE(TypeError, "unsupported operand type(s) for " $op);     \
 
 #define BOTH_OF_TYPE($type) (right->type == ($type) && left->type == ($type))
 
-#define INT_OPERATION($op)                                                       \
+// Pushes the result of `$fn(a, b)` if both operands are sets, where `$fn` is one of the
+// `py_set_*` functions declared in `sets.h`.
+#define SET_OPERATION($fn)                                                       \
+    if (PY_IS_SET(right) && PY_IS_SET(left)) {                                   \
+        pyreturn_t result = $fn(right, left);                                    \
+        if (result.exception != NULL)                                            \
+            return result.exception;                                             \
+        STACK_PUSH_INDIRECT(result.value);                                       \
+        return NULL;                                                             \
+    }                                                                            \
+
+// Pushes the concatenation of both operands if they're `str`s. `str`s are immutable, so
+// this also implements `+=`.
+#define STR_CONCATENATION                                                        \
+    if (BOTH_OF_TYPE(&py_type_str)) {                                            \
+        STACK_PUSH_INDIRECT(py_str_concat(right, left));                         \
+        return NULL;                                                             \
+    }                                                                            \
+
+// Pushes the concatenation of both operands if the left one is a `bytes` or `bytearray`,
+// and the right one is any bytes-like object. If `$inplace` is `true`, `bytearray`s are
+// extended in-place, like `a += b` does.
+#define BUFFER_CONCATENATION($inplace)                                           \
+    if ((right->type == &py_type_bytes || right->type == &py_type_bytearray) &&  \
+        PY_IS_BUFFER(left)) {                                                    \
+        if (($inplace) && right->type == &py_type_bytearray) {                   \
+            pyobj_t* exception = py_bytearray_extend(right, left);               \
+            if (exception != NULL)                                               \
+                return exception;                                                \
+            STACK_PUSH_INDIRECT(right);                                          \
+            return NULL;                                                         \
+        }                                                                        \
+        pyreturn_t result = py_buffer_concat(right, left);                       \
+        if (result.exception != NULL)                                            \
+            return result.exception;                                             \
+        STACK_PUSH_INDIRECT(result.value);                                       \
+        return NULL;                                                             \
+    }                                                                            \
+
+// Pushes the elementwise result of `a $op b` if either operand is an `array`. The other
+// operand has to be an `array` of the same typecode and length, or a scalar. If `$inplace`
+// is `true` and the left operand is an `array`, the result is stored in it, like `a $op= b`
+// does.
+#define ARRAY_OPERATION($op, $inplace)                                           \
+    if (PY_IS_ARRAY(right) || PY_IS_ARRAY(left)) {                               \
+        bool reflected = !PY_IS_ARRAY(right);                                    \
+        pyreturn_t result = reflected                                            \
+            ? py_array_elementwise(left, right, $op, true, false)                \
+            : py_array_elementwise(right, left, $op, false, $inplace);           \
+        if (result.exception != NULL)                                            \
+            return result.exception;                                             \
+        STACK_PUSH_INDIRECT(result.value);                                       \
+        return NULL;                                                             \
+    }                                                                            \
+
+// Pushes the product of both operands if they're `matrix` objects. Products never fit in
+// the left operand, so this also implements `@=`.
+#define MATRIX_MULTIPLICATION                                                    \
+    if (PY_IS_MATRIX(right) && PY_IS_MATRIX(left)) {                             \
+        pyreturn_t result = py_matrix_matmul(right, left);                       \
+        if (result.exception != NULL)                                            \
+            return result.exception;                                             \
+        STACK_PUSH_INDIRECT(result.value);                                       \
+        return NULL;                                                             \
+    }                                                                            \
+
+// Similar to `SET_OPERATION`, but updates the left operand in-place if it's a mutable
+// `set`, like `a |= b` does.
+#define SET_INPLACE_OPERATION($fn)                                               \
+    if (right->type == &py_type_set && PY_IS_SET(left)) {                        \
+        pyreturn_t result = $fn(right, left);                                    \
+        if (result.exception != NULL)                                            \
+            return result.exception;                                             \
+        right->as_set = result.value->as_set;                                    \
+        STACK_PUSH_INDIRECT(right);                                              \
+        return NULL;                                                             \
+    }                                                                            \
+    SET_OPERATION($fn)                                                           \
+
+// Pushes the result of `$fn(a, b)` if both operands are `int`s, where `$fn` is one of
+// the `py_int_*` functions declared in `ints.h`.
+#define INT_OPERATION($fn)                                                       \
     if (BOTH_OF_TYPE(&py_type_int)) {                                            \
+        pyreturn_t result = $fn(right, left);                                    \
+        if (result.exception != NULL)                                            \
+            return result.exception;                                             \
+        STACK_PUSH_INDIRECT(result.value);                                       \
+        return NULL;                                                             \
+    }                                                                            \
+
+// Similar to `INT_OPERATION`, but handles two inline operands directly. `$builtin` is one
+// of the `__builtin_*_overflow` functions - only on an overflow do we go through `$fn`.
+#define INT_OPERATION_CHECKED($builtin, $fn)                                     \
+    if (BOTH_OF_TYPE(&py_type_int) && PY_INT_IS_SMALL(right) && PY_INT_IS_SMALL(left)) {  \
+        int64_t result;                                                          \
+        if (!$builtin(right->as_int, left->as_int, &result)) {                   \
+            STACK_PUSH_INDIRECT(py_alloc_int(result));                           \
+            return NULL;                                                         \
+        }                                                                        \
+    }                                                                            \
+    INT_OPERATION($fn)                                                           \
+
+// Similar to `INT_OPERATION`, but handles two inline operands directly, for operations
+// that can never overflow.
+#define INT_OPERATION_EXACT($op, $fn)                                            \
+    if (BOTH_OF_TYPE(&py_type_int) && PY_INT_IS_SMALL(right) && PY_INT_IS_SMALL(left)) {  \
         STACK_PUSH_INDIRECT(py_alloc_int(right->as_int $op left->as_int));       \
         return NULL;                                                             \
     }                                                                            \
+    INT_OPERATION($fn)                                                           \
+
+// Evaluates to `true` if one of the operands is a `float`, and the other one is an `int`.
+#define FLOAT_AND_INT ( \
+    (right->type == &py_type_float && left->type == &py_type_int) ||  \
+    (right->type == &py_type_int && left->type == &py_type_float)     \
+)
+
+// Pushes the result of `a $op b` as a `float` if both operands are `float`s, or if one of
+// them is a `float` and the other one an `int`.
+#define FLOAT_OPERATION($op)                                                        \
+    if (BOTH_OF_TYPE(&py_type_float)) {                                             \
+        STACK_PUSH_INDIRECT(py_alloc_float(right->as_float $op left->as_float));    \
+        return NULL;                                                                \
+    }                                                                               \
+    if (FLOAT_AND_INT) {                                                            \
+        double a, b;                                                                \
+        pyobj_t* exception = real_operands(right, left, &a, &b);                    \
+        if (exception != NULL)                                                      \
+            return exception;                                                       \
+        STACK_PUSH_INDIRECT(py_alloc_float(a $op b));                               \
+        return NULL;                                                                \
+    }                                                                               \
+
+// Similar to `FLOAT_OPERATION`, but for operators that can fail. `$fn` is one of the
+// `py_float_*` functions declared in `floats.h`.
+#define FLOAT_OPERATION_FN($fn)                                                     \
+    if (BOTH_OF_TYPE(&py_type_float) || FLOAT_AND_INT) {                            \
+        double a, b, result = 0.0;                                                  \
+        pyobj_t* exception = real_operands(right, left, &a, &b);                    \
+        if (exception == NULL) {                                                    \
+            exception = $fn(a, b, &result);                                         \
+        }                                                                           \
+        if (exception != NULL)                                                      \
+            return exception;                                                       \
+        STACK_PUSH_INDIRECT(py_alloc_float(result));                                \
+        return NULL;                                                                \
+    }                                                                               \
+
+// Pushes the result of `a / b` if both operands are `int`s or `float`s. Unlike the other
+// operators, `int / int` also results in a `float`.
+#define TRUEDIV_OPERATION                                                           \
+    INT_OPERATION(py_int_truediv)                                                   \
+    if (BOTH_OF_TYPE(&py_type_float) || FLOAT_AND_INT) {                            \
+        double a, b;                                                                \
+        pyobj_t* exception = real_operands(right, left, &a, &b);                    \
+        if (exception != NULL)                                                      \
+            return exception;                                                       \
+        if (b == 0.0)                                                               \
+            return NEW_EXCEPTION_INLINE(ZeroDivisionError, "float division by zero");   \
+        STACK_PUSH_INDIRECT(py_alloc_float(a / b));                                 \
+        return NULL;                                                                \
+    }                                                                               \
+
+// Converts an `int` or a `float` object to a `double`. Returns an exception or NULL.
+static pyobj_t* real_to_double(pyobj_t* x, double* out) {
+    if (x->type == &py_type_float) {
+        *out = x->as_float;
+        return NULL;
+    }
+
+    if (!py_int_to_double(x, out))
+        return NEW_EXCEPTION_INLINE(OverflowError, "int too large to convert to float");
+
+    return NULL;
+}
+
+// Converts both operands of a binary operation over `int`s and `float`s to `double`s.
+// Returns an exception or NULL.
+static pyobj_t* real_operands(pyobj_t* right, pyobj_t* left, double* out_a, double* out_b) {
+    pyobj_t* exception = real_to_double(right, out_a);
+    if (exception != NULL)
+        return exception;
+
+    return real_to_double(left, out_b);
+}
 
 static bool arbitrary_op(
     void** stack,
@@ -32,14 +221,11 @@ static bool arbitrary_op(
     pyobj_t** exception
 ) {
     pyobj_t* op_fn;
+    bool is_unbound = py_get_method_attribute(right, attr_name, &op_fn);
 
-    if (
-        py_get_method_attribute(right, attr_name, &op_fn) &&
-        op_fn != NULL &&
-        op_fn->type == &py_type_method
-    ) {
+    if (op_fn != NULL) {
         pyobj_t* args[] = { left };
-        pyreturn_t result = py_call(op_fn, 1, args, 0, NULL, NULL);
+        pyreturn_t result = py_call(op_fn, 1, args, 0, NULL, is_unbound ? right : NULL);
 
         if (result.exception != NULL) {
             *exception = result.exception;
@@ -54,155 +240,306 @@ static bool arbitrary_op(
     return false;
 }
 
-// TODO: string concat
-// TODO: float operations
-
 pyobj_t* py_opcode_op_add(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(+);
+    INT_OPERATION_CHECKED(__builtin_add_overflow, py_int_add);
+    FLOAT_OPERATION(+);
+    STR_CONCATENATION;
+    BUFFER_CONCATENATION(false);
+    ARRAY_OPERATION('+', false);
     OPERATION_EPILOG("__add__", "+");
 }
 
 pyobj_t* py_opcode_op_and(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(&);
+    SET_OPERATION(py_set_intersection);
+    INT_OPERATION_EXACT(&, py_int_and);
     OPERATION_EPILOG("__and__", "&");
 }
 
 pyobj_t* py_opcode_op_floordiv(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(/);
+    INT_OPERATION(py_int_floordiv);
+    FLOAT_OPERATION_FN(py_float_floordiv);
     OPERATION_EPILOG("__floordiv__", "//");
 }
 
 pyobj_t* py_opcode_op_lsh(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(<<);
+    INT_OPERATION(py_int_lshift);
     OPERATION_EPILOG("__lshift__", "<<");
 }
 
 pyobj_t* py_opcode_op_matmul(void** stack, int* stack_current) {
     OPERATION_PROLOG;
+    MATRIX_MULTIPLICATION;
     OPERATION_EPILOG("__matmul__", "@");
 }
 
 pyobj_t* py_opcode_op_mul(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(*);
+    INT_OPERATION_CHECKED(__builtin_mul_overflow, py_int_mul);
+    FLOAT_OPERATION(*);
+    ARRAY_OPERATION('*', false);
     OPERATION_EPILOG("__mul__", "*");
 }
 
 pyobj_t* py_opcode_op_rem(void** stack, int* stack_current) {
-    // TODO: Verify the correctness of using a regular modulo as an int remainder
     OPERATION_PROLOG;
-    INT_OPERATION(%);
+    INT_OPERATION(py_int_mod);
+    FLOAT_OPERATION_FN(py_float_mod);
     OPERATION_EPILOG("__mod__", "%");
 }
 
 pyobj_t* py_opcode_op_or(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(|);
+    SET_OPERATION(py_set_union);
+    INT_OPERATION_EXACT(|, py_int_or);
     OPERATION_EPILOG("__or__", "|");
 }
 
 pyobj_t* py_opcode_op_pow(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    // TODO: int power
+    INT_OPERATION(py_int_pow);
+    FLOAT_OPERATION_FN(py_float_pow);
     OPERATION_EPILOG("__pow__", "**");
 }
 
 pyobj_t* py_opcode_op_rsh(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(>>);
+    INT_OPERATION(py_int_rshift);
     OPERATION_EPILOG("__rshift__", ">>");
 }
 
 pyobj_t* py_opcode_op_sub(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(-);
+    SET_OPERATION(py_set_difference);
+    INT_OPERATION_CHECKED(__builtin_sub_overflow, py_int_sub);
+    FLOAT_OPERATION(-);
+    ARRAY_OPERATION('-', false);
     OPERATION_EPILOG("__sub__", "-");
 }
 
+pyobj_t* py_opcode_op_truediv(void** stack, int* stack_current) {
+    OPERATION_PROLOG;
+    TRUEDIV_OPERATION;
+    OPERATION_EPILOG("__truediv__", "/");
+}
+
 pyobj_t* py_opcode_op_xor(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(^);
+    SET_OPERATION(py_set_symmetric_difference);
+    INT_OPERATION_EXACT(^, py_int_xor);
     OPERATION_EPILOG("__xor__", "^");
 }
 
 pyobj_t* py_opcode_op_iadd(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(+);
+    INT_OPERATION_CHECKED(__builtin_add_overflow, py_int_add);
+    FLOAT_OPERATION(+);
+    STR_CONCATENATION;
+    BUFFER_CONCATENATION(true);
+    ARRAY_OPERATION('+', true);
     OPERATION_EPILOG("__iadd__", "+=");
 }
 
 pyobj_t* py_opcode_op_iand(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(&);
+    SET_INPLACE_OPERATION(py_set_intersection);
+    INT_OPERATION_EXACT(&, py_int_and);
     OPERATION_EPILOG("__iand__", "&=");
 }
 
 pyobj_t* py_opcode_op_ifloordiv(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(/);
+    INT_OPERATION(py_int_floordiv);
+    FLOAT_OPERATION_FN(py_float_floordiv);
     OPERATION_EPILOG("__ifloordiv__", "//=");
 }
 
 pyobj_t* py_opcode_op_ilsh(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(<<);
+    INT_OPERATION(py_int_lshift);
     OPERATION_EPILOG("__ilshift__", "<<=");
 }
 
 pyobj_t* py_opcode_op_imatmul(void** stack, int* stack_current) {
     OPERATION_PROLOG;
+    MATRIX_MULTIPLICATION;
     OPERATION_EPILOG("__imatmul__", "@=");
 }
 
 pyobj_t* py_opcode_op_imul(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(*);
+    INT_OPERATION_CHECKED(__builtin_mul_overflow, py_int_mul);
+    FLOAT_OPERATION(*);
+    ARRAY_OPERATION('*', true);
     OPERATION_EPILOG("__imul__", "*=");
 }
 
 pyobj_t* py_opcode_op_irem(void** stack, int* stack_current) {
-    // TODO: Verify the correctness of using a regular modulo as an int remainder
     OPERATION_PROLOG;
-    INT_OPERATION(%);
+    INT_OPERATION(py_int_mod);
+    FLOAT_OPERATION_FN(py_float_mod);
     OPERATION_EPILOG("__imod__", "%=");
 }
 
 pyobj_t* py_opcode_op_ior(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(|);
+    SET_INPLACE_OPERATION(py_set_union);
+    INT_OPERATION_EXACT(|, py_int_or);
     OPERATION_EPILOG("__ior__", "|=");
 }
 
 pyobj_t* py_opcode_op_ipow(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    // TODO: int power
+    INT_OPERATION(py_int_pow);
+    FLOAT_OPERATION_FN(py_float_pow);
     OPERATION_EPILOG("__ipow__", "**=");
 }
 
 pyobj_t* py_opcode_op_irsh(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(>>);
+    INT_OPERATION(py_int_rshift);
     OPERATION_EPILOG("__irshift__", ">>=");
 }
 
 pyobj_t* py_opcode_op_isub(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(-);
+    SET_INPLACE_OPERATION(py_set_difference);
+    INT_OPERATION_CHECKED(__builtin_sub_overflow, py_int_sub);
+    FLOAT_OPERATION(-);
+    ARRAY_OPERATION('-', true);
     OPERATION_EPILOG("__isub__", "-=");
 }
 
+pyobj_t* py_opcode_op_itruediv(void** stack, int* stack_current) {
+    OPERATION_PROLOG;
+    TRUEDIV_OPERATION;
+    OPERATION_EPILOG("__itruediv__", "/=");
+}
+
 pyobj_t* py_opcode_op_ixor(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    INT_OPERATION(^);
+    SET_INPLACE_OPERATION(py_set_symmetric_difference);
+    INT_OPERATION_EXACT(^, py_int_xor);
     OPERATION_EPILOG("__ixor__", "^=");
 }
 
 pyobj_t* py_opcode_op_subscr(void** stack, int* stack_current) {
     OPERATION_PROLOG;
-    // this one's kinda a guess
+
+    // Here, `right` is the container, and `left` is the index.
+    if (left->type == &py_type_slice && (
+        right->type == &py_type_list ||
+        right->type == &py_type_tuple ||
+        right->type == &py_type_str
+    )) {
+        pyreturn_t result = py_sequence_getslice(right, left);
+        if (result.exception != NULL)
+            return result.exception;
+
+        STACK_PUSH_INDIRECT(result.value);
+        return NULL;
+    }
+
+    if ((right->type == &py_type_list || right->type == &py_type_tuple) && left->type == &py_type_int) {
+        int64_t length = (int64_t)right->as_list.length;
+        int64_t i = left->as_int;
+
+        if (PY_INT_IS_SMALL(left) && i < 0) {
+            i += length;
+        }
+
+        if (PY_INT_IS_SMALL(left) && i >= 0 && i < length) {
+            STACK_PUSH_INDIRECT(right->as_list.elements[i]);
+            return NULL;
+        }
+
+        // Out-of-range indices.
+        pyreturn_t result = py_list_getitem(right, left);
+        if (result.exception != NULL)
+            return result.exception;
+
+        STACK_PUSH_INDIRECT(result.value);
+        return NULL;
+    }
+
+    if (right->type == &py_type_str) {
+        pyreturn_t result = py_str_getitem(right, left);
+        if (result.exception != NULL)
+            return result.exception;
+
+        STACK_PUSH_INDIRECT(result.value);
+        return NULL;
+    }
+
+    if (PY_IS_ARRAY(right) && left->type == &py_type_int) {
+        int64_t length = (int64_t)py_array_length(right);
+        int64_t i = left->as_int;
+
+        if (PY_INT_IS_SMALL(left) && i < 0) {
+            i += length;
+        }
+
+        if (PY_INT_IS_SMALL(left) && i >= 0 && i < length) {
+            STACK_PUSH_INDIRECT(py_array_item(right, (size_t)i));
+            return NULL;
+        }
+    }
+
+    if (PY_IS_ARRAY(right)) {
+        pyreturn_t result = py_array_getitem(right, left);
+        if (result.exception != NULL)
+            return result.exception;
+
+        STACK_PUSH_INDIRECT(result.value);
+        return NULL;
+    }
+
+    if (PY_IS_BUFFER(right)) {
+        pyreturn_t result = py_buffer_getitem(right, left);
+        if (result.exception != NULL)
+            return result.exception;
+
+        STACK_PUSH_INDIRECT(result.value);
+        return NULL;
+    }
+
+    if (right->type == &py_type_dict) {
+        pyreturn_t result = py_dict_getitem(right, left);
+        if (result.exception != NULL)
+            return result.exception;
+
+        STACK_PUSH_INDIRECT(result.value);
+        return NULL;
+    }
+
     OPERATION_EPILOG("__getitem__", "[]");
-}
\ No newline at end of file
+}
+
+pyobj_t* py_opcode_unary_negative(void** stack, int* stack_current) {
+    pyobj_t* value = NOT_NULL(STACK_POP_INDIRECT());
+
+    if (value->type == &py_type_int) {
+        STACK_PUSH_INDIRECT(py_int_neg(value));
+        return NULL;
+    }
+
+    if (value->type == &py_type_float) {
+        STACK_PUSH_INDIRECT(py_alloc_float(-value->as_float));
+        return NULL;
+    }
+
+    pyobj_t* method;
+    bool is_unbound = py_get_method_attribute(value, STR("__neg__"), &method);
+    if (method == NULL)
+        return NEW_EXCEPTION_INLINE(TypeError, "bad operand type for unary -");
+
+    pyreturn_t result = py_call(method, 0, NULL, 0, NULL, is_unbound ? value : NULL);
+    if (result.exception != NULL)
+        return result.exception;
+
+    STACK_PUSH_INDIRECT(result.value);
+    return NULL;
+}
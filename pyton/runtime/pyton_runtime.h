@@ -9,4 +9,26 @@
 #include "opcodes.h"
 #include "fragments.h"
 #include "exceptions.h"
+#include "ints.h"
+#include "floats.h"
+#include "lists.h"
+#include "dicts.h"
+#include "sets.h"
+#include "strings.h"
+#include "formatting.h"
+#include "slices.h"
+#include "buffers.h"
+#include "mmio.h"
+#include "arrays.h"
+#include "matrices.h"
+#include "sorting.h"
+#include "generators.h"
+#include "executor.h"
+#include "modules/asyncio.h"
+#include "modules/array.h"
+#include "modules/matrix.h"
+#include "modules/heapq.h"
+#include "modules/math.h"
+#include "modules/struct.h"
+#include "modules/time.h"
 #include "std/safety.h"
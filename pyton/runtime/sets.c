@@ -0,0 +1,748 @@
+#include "sets.h"
+
+#include "dicts.h"
+#include "ints.h"
+#include "lists.h"
+#include "opcodes.h"
+#include "std/safety.h"
+#include "std/memory.h"
+#include "std/util.h"
+#include "sys/mm.h"
+
+#define WORD_BITS 64
+
+// The largest number of words a bitset can have.
+#define MAX_WORDS (PY_SET_BITSET_LIMIT / WORD_BITS)
+
+// Counts the set bits in `x`. We can't use `__builtin_popcountll` - unless the target is
+// known to support POPCNT, it compiles to a call into libgcc, which we don't link against.
+static inline size_t popcount(uint64_t x) {
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return (size_t)((x * 0x0101010101010101ull) >> 56);
+}
+
+// Returns the data of the given set, first adding the elements that are still pending.
+static set_data_t* data_of(pyobj_t* set) {
+    ENSURE_NOT_NULL(set);
+    ASSERT(PY_IS_SET(set));
+
+    set_data_t* data = set->as_set;
+    if (data->pending != NULL) {
+        pyobj_t* pending = data->pending;
+        data->pending = NULL;
+
+        // Pending elements come from constants, which can be hashed and compared without
+        // calling into Python code.
+        for (size_t i = 0; i < pending->as_list.length; i++) {
+            pyobj_t* exception = py_set_add(set, pending->as_list.elements[i]);
+            ASSERT(exception == NULL);
+        }
+    }
+
+    return data;
+}
+
+// Returns `true` and sets `out_bit` if `x` can be stored in a set in its bitset
+// representation.
+static inline bool as_bit(const pyobj_t* x, size_t* out_bit) {
+    if (x->type != &py_type_int || !PY_INT_IS_SMALL(x))
+        return false;
+
+    if (x->as_int < 0 || x->as_int >= PY_SET_BITSET_LIMIT)
+        return false;
+
+    *out_bit = (size_t)x->as_int;
+    return true;
+}
+
+static inline bool has_bit(const set_data_t* data, size_t bit) {
+    size_t word = bit / WORD_BITS;
+    return word < data->words && (data->bits[word] >> (bit % WORD_BITS)) & 1;
+}
+
+// Ensures that the bitset of the given set has at least `words` words.
+static void reserve_words(set_data_t* data, size_t words) {
+    ASSERT(data->is_bitset);
+    ASSERT(words <= MAX_WORDS);
+
+    if (words <= data->words)
+        return;
+
+    size_t capacity = MIN(MAX(data->words * 2, words), MAX_WORDS);
+    uint64_t* bits = mm_heap_alloc(capacity * sizeof(uint64_t));
+    memset(bits, 0, capacity * sizeof(uint64_t));
+
+    if (data->bits != NULL) {
+        memcpy(bits, data->bits, data->words * sizeof(uint64_t));
+        mm_heap_free(data->bits);
+    }
+
+    data->bits = bits;
+    data->words = capacity;
+}
+
+// Recounts the elements of the given set in its bitset representation.
+static void recount_bits(set_data_t* data) {
+    size_t length = 0;
+    for (size_t i = 0; i < data->words; i++) {
+        length += popcount(data->bits[i]);
+    }
+
+    data->length = length;
+}
+
+// Looks up `item` in the given set in its bitset representation, setting `out_bit` to the
+// element that is equal to it, or -1 if there is none. Returns an exception or NULL.
+static pyobj_t* bitset_find(const set_data_t* data, pyobj_t* item, ptrdiff_t* out_bit) {
+    *out_bit = -1;
+
+    size_t bit;
+    if (as_bit(item, &bit)) {
+        if (has_bit(data, bit)) {
+            *out_bit = (ptrdiff_t)bit;
+        }
+
+        return NULL;
+    }
+
+    // Other objects (e.g. `True` or `1.0`) can still be equal to an element. As equal
+    // objects have equal hashes, and each element `i` hashes to `i`, the only element
+    // `item` could be equal to is its own hash.
+    int64_t hash;
+    pyobj_t* exception = py_hash(item, &hash);
+    if (exception != NULL)
+        return exception;
+
+    if (hash < 0 || hash >= PY_SET_BITSET_LIMIT || !has_bit(data, (size_t)hash))
+        return NULL;
+
+    bool equal = py_keys_equal(py_alloc_int(hash), item, &exception);
+    if (exception != NULL)
+        return exception;
+
+    if (equal) {
+        *out_bit = (ptrdiff_t)hash;
+    }
+
+    return NULL;
+}
+
+// Switches the given set over from its bitset representation to a hash table.
+static void convert_to_table(set_data_t* data) {
+    ASSERT(data->is_bitset);
+
+    hashmap_t table = {};
+    std_hashmap_reserve(&table, data->length + 1);
+
+    for (size_t i = 0; i < data->words; i++) {
+        uint64_t word = data->bits[i];
+        while (word != 0) {
+            size_t bit = i * WORD_BITS + __builtin_ctzll(word);
+            word &= word - 1;
+
+            // Elements are distinct and only equal to themselves, so we never compare them.
+            std_hashmap_insert(&table, bit, py_alloc_int((int64_t)bit), py_hashmap_keys_equal, NULL, NULL);
+        }
+    }
+
+    if (data->bits != NULL) {
+        mm_heap_free(data->bits);
+    }
+
+    data->bits = NULL;
+    data->words = 0;
+    data->table = table;
+    data->is_bitset = false;
+}
+
+// Adds `item`, with the given hash, to the given set in its hash table representation.
+// Returns an exception or NULL.
+static pyobj_t* table_add(set_data_t* data, uint64_t hash, pyobj_t* item) {
+    bool inserted;
+    std_hashmap_insert(&data->table, hash, item, py_hashmap_keys_equal, NULL, &inserted);
+
+    pyobj_t* exception = py_take_key_exception();
+    if (exception != NULL) {
+        // The comparison that failed counts as unequal, so the item might have been
+        // inserted anyway.
+        if (inserted) {
+            std_hashmap_remove(&data->table, hash, item, py_hashmap_keys_equal, NULL, NULL);
+            py_take_key_exception();
+        }
+
+        return exception;
+    }
+
+    data->length = data->table.length;
+    return NULL;
+}
+
+// Returns the element at or after position `*index` in the given set, advancing `index`
+// past it, or `NULL` if there are no more elements. Positions are bit indices for bitsets,
+// and entry indices for hash tables.
+static pyobj_t* next_element(const set_data_t* data, size_t* index, uint64_t* out_hash) {
+    if (data->is_bitset) {
+        size_t word_index = *index / WORD_BITS;
+        if (word_index >= data->words)
+            return NULL;
+
+        // Mask off the bits we've already visited in the first word.
+        uint64_t word = data->bits[word_index] & (~0ull << (*index % WORD_BITS));
+
+        while (word == 0) {
+            if (++word_index >= data->words) {
+                *index = word_index * WORD_BITS;
+                return NULL;
+            }
+
+            word = data->bits[word_index];
+        }
+
+        size_t bit = word_index * WORD_BITS + __builtin_ctzll(word);
+        *index = bit + 1;
+
+        if (out_hash != NULL) {
+            *out_hash = bit;
+        }
+
+        return py_alloc_int((int64_t)bit);
+    }
+
+    while (*index < data->table.entries.length) {
+        hashmap_entry_t* entry = &data->table.entries.elements[(*index)++];
+        if (entry->key != NULL) {
+            if (out_hash != NULL) {
+                *out_hash = entry->hash;
+            }
+
+            return (pyobj_t*)entry->key;
+        }
+    }
+
+    return NULL;
+}
+
+// Allocates a set of the given type in its bitset representation, with `words` zeroed
+// words.
+static pyobj_t* alloc_bitset(pyobj_t* type, size_t words) {
+    pyobj_t* set = py_alloc_set(type);
+    reserve_words(set->as_set, words);
+    return set;
+}
+
+pyobj_t* py_alloc_set(pyobj_t* type) {
+    ASSERT(type == &py_type_set || type == &py_type_frozenset);
+
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = type;
+    obj->as_set = mm_heap_alloc(sizeof(set_data_t));
+    *obj->as_set = (set_data_t) { .is_bitset = true };
+    return obj;
+}
+
+pyreturn_t py_alloc_set_from(pyobj_t* type, pyobj_t* iterable) {
+    pyobj_t* set = py_alloc_set(type);
+
+    pyobj_t* exception = py_set_update(set, iterable);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(set);
+}
+
+pyobj_t* py_alloc_set_iterator(pyobj_t* set) {
+    ENSURE_NOT_NULL(set);
+    ASSERT(PY_IS_SET(set));
+
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = &py_type_set_iterator;
+    obj->as_set_iterator.set = set;
+    obj->as_set_iterator.index = 0;
+    return obj;
+}
+
+pyobj_t* py_set_iterator_next(pyobj_t* iterator) {
+    ENSURE_NOT_NULL(iterator);
+    ASSERT(iterator->type == &py_type_set_iterator);
+
+    struct set_iterator_data* data = &iterator->as_set_iterator;
+    return next_element(data_of(data->set), &data->index, NULL);
+}
+
+size_t py_set_length(pyobj_t* set) {
+    return data_of(set)->length;
+}
+
+pyobj_t* py_set_add(pyobj_t* set, pyobj_t* item) {
+    ENSURE_NOT_NULL(item);
+
+    set_data_t* data = data_of(set);
+    pyobj_t* exception;
+
+    if (data->is_bitset) {
+        size_t bit;
+        if (as_bit(item, &bit)) {
+            reserve_words(data, bit / WORD_BITS + 1);
+
+            uint64_t mask = 1ull << (bit % WORD_BITS);
+            if ((data->bits[bit / WORD_BITS] & mask) == 0) {
+                data->bits[bit / WORD_BITS] |= mask;
+                data->length++;
+            }
+
+            return NULL;
+        }
+
+        // The item doesn't fit in the bitset - but if it's equal to an element, the set
+        // stays as-is.
+        ptrdiff_t existing;
+        exception = bitset_find(data, item, &existing);
+        if (exception != NULL)
+            return exception;
+
+        if (existing >= 0)
+            return NULL;
+
+        convert_to_table(data);
+    }
+
+    int64_t hash;
+    exception = py_hash(item, &hash);
+    if (exception != NULL)
+        return exception;
+
+    return table_add(data, (uint64_t)hash, item);
+}
+
+pyobj_t* py_set_discard(pyobj_t* set, pyobj_t* item, bool* out_removed) {
+    ENSURE_NOT_NULL(item);
+
+    set_data_t* data = data_of(set);
+    bool removed;
+
+    if (data->is_bitset) {
+        ptrdiff_t bit;
+        pyobj_t* exception = bitset_find(data, item, &bit);
+        if (exception != NULL)
+            return exception;
+
+        removed = bit >= 0;
+        if (removed) {
+            data->bits[bit / WORD_BITS] &= ~(1ull << (bit % WORD_BITS));
+            data->length--;
+        }
+    }
+    else {
+        int64_t hash;
+        pyobj_t* exception = py_hash(item, &hash);
+        if (exception != NULL)
+            return exception;
+
+        removed = std_hashmap_remove(&data->table, (uint64_t)hash, item, py_hashmap_keys_equal, NULL, NULL);
+
+        exception = py_take_key_exception();
+        if (exception != NULL)
+            return exception;
+
+        data->length = data->table.length;
+    }
+
+    if (out_removed != NULL) {
+        *out_removed = removed;
+    }
+
+    return NULL;
+}
+
+pyobj_t* py_set_contains(pyobj_t* set, pyobj_t* item, bool* out_contains) {
+    ENSURE_NOT_NULL(item);
+    ENSURE_NOT_NULL(out_contains);
+
+    set_data_t* data = data_of(set);
+
+    if (data->is_bitset) {
+        ptrdiff_t bit;
+        pyobj_t* exception = bitset_find(data, item, &bit);
+        if (exception != NULL)
+            return exception;
+
+        *out_contains = bit >= 0;
+        return NULL;
+    }
+
+    int64_t hash;
+    pyobj_t* exception = py_hash(item, &hash);
+    if (exception != NULL)
+        return exception;
+
+    hashmap_entry_t* entry = std_hashmap_find(&data->table, (uint64_t)hash, item, py_hashmap_keys_equal, NULL);
+
+    exception = py_take_key_exception();
+    if (exception != NULL)
+        return exception;
+
+    *out_contains = entry != NULL;
+    return NULL;
+}
+
+pyobj_t* py_set_update(pyobj_t* set, pyobj_t* iterable) {
+    ENSURE_NOT_NULL(iterable);
+
+    set_data_t* data = data_of(set);
+
+    if (PY_IS_SET(iterable)) {
+        set_data_t* other = data_of(iterable);
+
+        if (data->is_bitset && other->is_bitset) {
+            reserve_words(data, other->words);
+
+            for (size_t i = 0; i < other->words; i++) {
+                data->bits[i] |= other->bits[i];
+            }
+
+            recount_bits(data);
+            return NULL;
+        }
+
+        if (!data->is_bitset && !other->is_bitset) {
+            // We already know the hashes of all elements.
+            std_hashmap_reserve(&data->table, data->length + other->length);
+
+            for (size_t i = 0; i < other->table.entries.length; i++) {
+                hashmap_entry_t entry = other->table.entries.elements[i];
+                if (entry.key == NULL)
+                    continue;
+
+                pyobj_t* exception = table_add(data, entry.hash, (pyobj_t*)entry.key);
+                if (exception != NULL)
+                    return exception;
+            }
+
+            return NULL;
+        }
+
+        size_t index = 0;
+        pyobj_t* element;
+        while ((element = next_element(other, &index, NULL)) != NULL) {
+            pyobj_t* exception = py_set_add(set, element);
+            if (exception != NULL)
+                return exception;
+        }
+
+        return NULL;
+    }
+
+    if (iterable->type == &py_type_list || iterable->type == &py_type_tuple) {
+        for (size_t i = 0; i < iterable->as_list.length; i++) {
+            pyobj_t* exception = py_set_add(set, iterable->as_list.elements[i]);
+            if (exception != NULL)
+                return exception;
+        }
+
+        return NULL;
+    }
+
+    void* stack[2] = { iterable };
+    int stack_current = 0;
+
+    pyreturn_t status = py_opcode_get_iter(stack, &stack_current);
+    if (status.exception != NULL)
+        return status.exception;
+
+    while (true) {
+        bool exhausted;
+        status = py_opcode_for_iter(stack, &stack_current, &exhausted);
+
+        if (status.exception != NULL)
+            return status.exception;
+
+        if (exhausted)
+            return NULL;
+
+        pyobj_t* exception = py_set_add(set, (pyobj_t*)stack[stack_current--]);
+        if (exception != NULL)
+            return exception;
+    }
+}
+
+void py_set_clear(pyobj_t* set) {
+    set_data_t* data = data_of(set);
+
+    if (!data->is_bitset) {
+        // A cleared set can go back to being a bitset.
+        data->table = (hashmap_t) {};
+        data->is_bitset = true;
+    }
+    else if (data->bits != NULL) {
+        memset(data->bits, 0, data->words * sizeof(uint64_t));
+    }
+
+    data->length = 0;
+}
+
+pyreturn_t py_set_pop(pyobj_t* set) {
+    set_data_t* data = data_of(set);
+
+    if (data->length == 0)
+        RAISE(KeyError, "pop from an empty set");
+
+    size_t index = 0;
+    pyobj_t* element = NOT_NULL(next_element(data, &index, NULL));
+
+    pyobj_t* exception = py_set_discard(set, element, NULL);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(element);
+}
+
+pyreturn_t py_set_union(pyobj_t* a, pyobj_t* b) {
+    pyobj_t* result = py_alloc_set(a->type);
+
+    pyobj_t* exception = py_set_update(result, a);
+    if (exception == NULL) {
+        exception = py_set_update(result, b);
+    }
+
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    return WITH_RESULT(result);
+}
+
+pyreturn_t py_set_intersection(pyobj_t* a, pyobj_t* b) {
+    set_data_t* a_data = data_of(a);
+    set_data_t* b_data = data_of(b);
+
+    if (a_data->is_bitset && b_data->is_bitset) {
+        size_t words = MIN(a_data->words, b_data->words);
+        pyobj_t* result = alloc_bitset(a->type, words);
+
+        for (size_t i = 0; i < words; i++) {
+            result->as_set->bits[i] = a_data->bits[i] & b_data->bits[i];
+        }
+
+        recount_bits(result->as_set);
+        return WITH_RESULT(result);
+    }
+
+    // Otherwise, we go through the smaller set, and look its elements up in the larger one.
+    pyobj_t* result = py_alloc_set(a->type);
+    pyobj_t* smaller = a_data->length <= b_data->length ? a : b;
+    pyobj_t* larger = smaller == a ? b : a;
+
+    size_t index = 0;
+    pyobj_t* element;
+    while ((element = next_element(smaller->as_set, &index, NULL)) != NULL) {
+        bool contains;
+        pyobj_t* exception = py_set_contains(larger, element, &contains);
+        if (exception == NULL && contains) {
+            exception = py_set_add(result, element);
+        }
+
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+    }
+
+    return WITH_RESULT(result);
+}
+
+pyreturn_t py_set_difference(pyobj_t* a, pyobj_t* b) {
+    set_data_t* a_data = data_of(a);
+    set_data_t* b_data = data_of(b);
+
+    if (a_data->is_bitset && b_data->is_bitset) {
+        pyobj_t* result = alloc_bitset(a->type, a_data->words);
+
+        for (size_t i = 0; i < a_data->words; i++) {
+            uint64_t removed = i < b_data->words ? b_data->bits[i] : 0;
+            result->as_set->bits[i] = a_data->bits[i] & ~removed;
+        }
+
+        recount_bits(result->as_set);
+        return WITH_RESULT(result);
+    }
+
+    pyobj_t* result = py_alloc_set(a->type);
+
+    size_t index = 0;
+    pyobj_t* element;
+    while ((element = next_element(a_data, &index, NULL)) != NULL) {
+        bool contains;
+        pyobj_t* exception = py_set_contains(b, element, &contains);
+        if (exception == NULL && !contains) {
+            exception = py_set_add(result, element);
+        }
+
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+    }
+
+    return WITH_RESULT(result);
+}
+
+pyreturn_t py_set_symmetric_difference(pyobj_t* a, pyobj_t* b) {
+    set_data_t* a_data = data_of(a);
+    set_data_t* b_data = data_of(b);
+
+    if (a_data->is_bitset && b_data->is_bitset) {
+        size_t words = MAX(a_data->words, b_data->words);
+        pyobj_t* result = alloc_bitset(a->type, words);
+
+        for (size_t i = 0; i < words; i++) {
+            uint64_t a_word = i < a_data->words ? a_data->bits[i] : 0;
+            uint64_t b_word = i < b_data->words ? b_data->bits[i] : 0;
+            result->as_set->bits[i] = a_word ^ b_word;
+        }
+
+        recount_bits(result->as_set);
+        return WITH_RESULT(result);
+    }
+
+    pyobj_t* result = UNWRAP(py_set_difference(a, b));
+
+    size_t index = 0;
+    pyobj_t* element;
+    while ((element = next_element(b_data, &index, NULL)) != NULL) {
+        bool contains;
+        pyobj_t* exception = py_set_contains(a, element, &contains);
+        if (exception == NULL && !contains) {
+            exception = py_set_add(result, element);
+        }
+
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+    }
+
+    return WITH_RESULT(result);
+}
+
+pyobj_t* py_set_is_subset(pyobj_t* a, pyobj_t* b, bool* out_result) {
+    ENSURE_NOT_NULL(out_result);
+
+    set_data_t* a_data = data_of(a);
+    set_data_t* b_data = data_of(b);
+
+    if (a_data->length > b_data->length) {
+        *out_result = false;
+        return NULL;
+    }
+
+    if (a_data->is_bitset && b_data->is_bitset) {
+        bool result = true;
+        for (size_t i = 0; i < a_data->words && result; i++) {
+            uint64_t allowed = i < b_data->words ? b_data->bits[i] : 0;
+            result = (a_data->bits[i] & ~allowed) == 0;
+        }
+
+        *out_result = result;
+        return NULL;
+    }
+
+    size_t index = 0;
+    pyobj_t* element;
+    while ((element = next_element(a_data, &index, NULL)) != NULL) {
+        bool contains;
+        pyobj_t* exception = py_set_contains(b, element, &contains);
+        if (exception != NULL)
+            return exception;
+
+        if (!contains) {
+            *out_result = false;
+            return NULL;
+        }
+    }
+
+    *out_result = true;
+    return NULL;
+}
+
+pyobj_t* py_set_equal(pyobj_t* a, pyobj_t* b, bool* out_result) {
+    ENSURE_NOT_NULL(out_result);
+
+    if (data_of(a)->length != data_of(b)->length) {
+        *out_result = false;
+        return NULL;
+    }
+
+    return py_set_is_subset(a, b, out_result);
+}
+
+// Scatters the bits of the hash of an element of a `frozenset`, so that hashes which only
+// differ in a few bits don't cancel each other out when combined.
+static inline uint64_t shuffle_bits(uint64_t hash) {
+    return ((hash ^ 89869747ull) ^ (hash << 16)) * 3644798167ull;
+}
+
+int64_t py_frozenset_hash(pyobj_t* set) {
+    set_data_t* data = data_of(set);
+
+    // The hash has to be independent of the order of the elements, so we combine their
+    // hashes with XOR.
+    uint64_t hash = 0;
+    uint64_t element_hash;
+    size_t index = 0;
+
+    if (data->is_bitset) {
+        // No need to allocate `int`s for the elements here - their hashes are their values.
+        for (size_t i = 0; i < data->words; i++) {
+            uint64_t word = data->bits[i];
+            while (word != 0) {
+                hash ^= shuffle_bits(i * WORD_BITS + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+    }
+    else {
+        while (next_element(data, &index, &element_hash) != NULL) {
+            hash ^= shuffle_bits(element_hash);
+        }
+    }
+
+    hash ^= ((uint64_t)data->length + 1) * 1927868237ull;
+    hash ^= (hash >> 11) ^ (hash >> 25);
+    hash = hash * 69069ull + 907133923ull;
+
+    return hash == (uint64_t)-1 ? 590923713 : (int64_t)hash;
+}
+
+string_t py_set_to_str(pyobj_t* set) {
+    set_data_t* data = data_of(set);
+    bool is_frozen = set->type == &py_type_frozenset;
+
+    if (data->length == 0)
+        return is_frozen ? STR("frozenset()") : STR("set()");
+
+    // Each element takes up to 4 parts - a separator, and an element which might be
+    // surrounded by quotes. Then, we have the braces, and the `frozenset(...)` around them.
+    string_t* parts = mm_heap_alloc((data->length * 4 + 4) * sizeof(string_t));
+    int n = 0;
+
+    parts[n++] = is_frozen ? STR("frozenset({") : STR("{");
+
+    size_t index = 0;
+    pyobj_t* element;
+    while ((element = next_element(data, &index, NULL)) != NULL) {
+        if (n != 1) {
+            parts[n++] = STR(", ");
+        }
+
+        // TODO: Use __repr__ for elements once we support it.
+        if (element->type == &py_type_str) {
+            parts[n++] = STR("'");
+            parts[n++] = element->as_str;
+            parts[n++] = STR("'");
+        }
+        else {
+            parts[n++] = py_stringify(element);
+        }
+    }
+
+    parts[n++] = is_frozen ? STR("})") : STR("}");
+
+    string_t result = std_strconcat_array(parts, n);
+    mm_heap_free(parts);
+    return result;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "objects.h"
+#include "exceptions.h"
+#include "std/hashmap.h"
+
+// Python `set` and `frozenset` objects point to a `set_data_t` in `as_set`. Sets have
+// two representations:
+//      - a bitset, used while all elements are `int`s in the range of
+//        0..PY_SET_BITSET_LIMIT - bit `i` is set if `i` is an element,
+//      - a hash table, that maps each element to nothing, hashed in the same way as the
+//        keys of a `dict`.
+//
+// Empty sets start out as bitsets, and switch over to a hash table once an element that
+// can't be represented as a bit is added. Operations on two bitsets work on whole words
+// at once.
+
+// The exclusive upper bound of the elements of a set in its bitset representation.
+#define PY_SET_BITSET_LIMIT 4096
+
+typedef struct set_data {
+    // The number of elements in the set.
+    size_t length;
+
+    // If `true`, the elements are stored in `bits`. Otherwise, they are the keys of `table`.
+    bool is_bitset;
+
+    // The words of the bitset. Only valid when `is_bitset` is `true`.
+    uint64_t* bits;
+
+    // The number of words in `bits`.
+    size_t words;
+
+    // The hash table that holds the elements. Only valid when `is_bitset` is `false`.
+    hashmap_t table;
+
+    // If not `NULL`, a `tuple` of elements that still have to be added to the set. This is
+    // used for `frozenset` constants that can't be represented as bitsets, as the
+    // transpiler can't compute the hashes of their elements.
+    pyobj_t* pending;
+} set_data_t;
+
+// Evaluates to `true` if the given object is a `set` or a `frozenset`.
+#define PY_IS_SET($x) ((($x)->type == &py_type_set) || (($x)->type == &py_type_frozenset))
+
+// Allocates an empty set. `type` has to be either `py_type_set` or `py_type_frozenset`.
+pyobj_t* py_alloc_set(pyobj_t* type);
+
+// Allocates a set of the given type, with all elements of the given iterable. Returns
+// an exception or the new set.
+pyreturn_t py_alloc_set_from(pyobj_t* type, pyobj_t* iterable);
+
+// Allocates an iterator over the elements of the given set.
+pyobj_t* py_alloc_set_iterator(pyobj_t* set);
+
+// Advances the given set iterator, returning the next element, or `NULL` if the iterator
+// is exhausted.
+pyobj_t* py_set_iterator_next(pyobj_t* iterator);
+
+// Returns the number of elements in the given set.
+size_t py_set_length(pyobj_t* set);
+
+// Implements `set.add(item)`. Returns an exception or NULL.
+pyobj_t* py_set_add(pyobj_t* set, pyobj_t* item);
+
+// Implements `set.discard(item)`, setting `out_removed` (if not `NULL`) to `true` if the
+// item was an element of the set. Returns an exception or NULL.
+pyobj_t* py_set_discard(pyobj_t* set, pyobj_t* item, bool* out_removed);
+
+// Implements `item in set`. Returns an exception or NULL.
+pyobj_t* py_set_contains(pyobj_t* set, pyobj_t* item, bool* out_contains);
+
+// Implements `set.update(iterable)`. Returns an exception or NULL.
+pyobj_t* py_set_update(pyobj_t* set, pyobj_t* iterable);
+
+// Removes all elements from the given set.
+void py_set_clear(pyobj_t* set);
+
+// Implements `set.pop()`. Raises a `KeyError` if the set is empty.
+pyreturn_t py_set_pop(pyobj_t* set);
+
+// Implements `a | b`, where both operands are sets. The result is of the type of `a`.
+pyreturn_t py_set_union(pyobj_t* a, pyobj_t* b);
+
+// Implements `a & b`, where both operands are sets. The result is of the type of `a`.
+pyreturn_t py_set_intersection(pyobj_t* a, pyobj_t* b);
+
+// Implements `a - b`, where both operands are sets. The result is of the type of `a`.
+pyreturn_t py_set_difference(pyobj_t* a, pyobj_t* b);
+
+// Implements `a ^ b`, where both operands are sets. The result is of the type of `a`.
+pyreturn_t py_set_symmetric_difference(pyobj_t* a, pyobj_t* b);
+
+// Implements `a <= b`, where both operands are sets. Returns an exception or NULL.
+pyobj_t* py_set_is_subset(pyobj_t* a, pyobj_t* b, bool* out_result);
+
+// Implements `a == b`, where both operands are sets. Returns an exception or NULL.
+pyobj_t* py_set_equal(pyobj_t* a, pyobj_t* b, bool* out_result);
+
+// Computes the hash of the given `frozenset`, in the same way as CPython does.
+int64_t py_frozenset_hash(pyobj_t* set);
+
+// Converts the given set to its string representation, e.g. `{1, 2}`.
+string_t py_set_to_str(pyobj_t* set);
@@ -0,0 +1,300 @@
+#include "slices.h"
+
+#include "ints.h"
+#include "lists.h"
+#include "strings.h"
+#include "std/memory.h"
+#include "std/safety.h"
+#include "std/strbuilder.h"
+#include "std/utf8.h"
+#include "sys/mm.h"
+
+pyobj_t* py_alloc_slice(pyobj_t* start, pyobj_t* stop, pyobj_t* step) {
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = &py_type_slice;
+    obj->as_slice.start = NOT_NULL(start);
+    obj->as_slice.stop = NOT_NULL(stop);
+    obj->as_slice.step = NOT_NULL(step);
+    return obj;
+}
+
+// Converts a bound of a slice to an `int64_t`. `int`s that don't fit are clamped - the
+// result is only used after being clamped to the length of the sequence anyway.
+static pyobj_t* bound_value(pyobj_t* bound, int64_t* out) {
+    if (bound->type != &py_type_int)
+        return NEW_EXCEPTION_INLINE(TypeError, "slice indices must be integers or None");
+
+    if (!PY_INT_IS_SMALL(bound)) {
+        *out = bound->as_bigint->negative ? -INT64_MAX : INT64_MAX;
+        return NULL;
+    }
+
+    *out = bound->as_int;
+    return NULL;
+}
+
+// Resolves the `start` or `stop` bound of a slice, which is not `None`.
+static int64_t clamp_bound(int64_t bound, int64_t length, int64_t step) {
+    if (bound < 0) {
+        bound += length;
+
+        if (bound < 0)
+            return step < 0 ? -1 : 0;
+
+        return bound;
+    }
+
+    if (bound >= length)
+        return step < 0 ? length - 1 : length;
+
+    return bound;
+}
+
+pyobj_t* py_slice_resolve(
+    pyobj_t* slice,
+    int64_t length,
+    int64_t* out_start,
+    int64_t* out_stop,
+    int64_t* out_step,
+    int64_t* out_count
+) {
+    ENSURE_NOT_NULL(slice);
+    ASSERT(slice->type == &py_type_slice);
+
+    // The results describe an empty slice until they're known.
+    *out_start = *out_stop = *out_count = 0;
+    *out_step = 1;
+
+    int64_t start = 0, stop = 0, step = 1;
+    pyobj_t* exception;
+
+    if (slice->as_slice.step != &py_none) {
+        if ((exception = bound_value(slice->as_slice.step, &step)) != NULL)
+            return exception;
+
+        if (step == 0)
+            return NEW_EXCEPTION_INLINE(ValueError, "slice step cannot be zero");
+    }
+
+    if (slice->as_slice.start == &py_none) {
+        start = step < 0 ? length - 1 : 0;
+    }
+    else {
+        if ((exception = bound_value(slice->as_slice.start, &start)) != NULL)
+            return exception;
+
+        start = clamp_bound(start, length, step);
+    }
+
+    if (slice->as_slice.stop == &py_none) {
+        stop = step < 0 ? -1 : length;
+    }
+    else {
+        if ((exception = bound_value(slice->as_slice.stop, &stop)) != NULL)
+            return exception;
+
+        stop = clamp_bound(stop, length, step);
+    }
+
+    int64_t count = 0;
+    if (step < 0 && stop < start) {
+        count = (start - stop - 1) / -step + 1;
+    }
+    else if (step > 0 && start < stop) {
+        count = (stop - start - 1) / step + 1;
+    }
+
+    *out_start = start;
+    *out_stop = stop;
+    *out_step = step;
+    *out_count = count;
+    return NULL;
+}
+
+// Slices the given `str`. With a step of 1, the result refers to the contents of `str`.
+static pyobj_t* str_getslice(pyobj_t* str, int64_t start, int64_t step, int64_t count) {
+    if (count == 0)
+        return PY_STR("");
+
+    if (count == py_str_length(str) && step == 1)
+        return str;
+
+    if (step == 1) {
+        int from = py_str_offset(str, (int)start);
+        int to = py_str_offset(str, (int)(start + count));
+        string_t part = { .str = str->as_str.str + from, .length = to - from };
+
+        // Parts of ASCII strings are ASCII strings as well - otherwise, we have to check.
+        if (py_str_is_ascii(str))
+            return py_alloc_str_analyzed(part, part.length, true);
+
+        return py_alloc_str(part);
+    }
+
+    // Otherwise, we gather the code points into a new string.
+    strbuilder_t* builder = std_strbuilder_alloc((size_t)count);
+    bool is_ascii = true;
+
+    for (int64_t i = 0; i < count; i++) {
+        int offset = py_str_offset(str, (int)(start + i * step));
+        string_t character = {
+            .str = str->as_str.str + offset,
+            .length = std_utf8_sequence_length(str->as_str.str[offset])
+        };
+
+        is_ascii = is_ascii && character.length == 1;
+        std_strbuilder_append(builder, character);
+    }
+
+    return py_alloc_str_analyzed(std_strbuilder_view(builder), (int)count, is_ascii);
+}
+
+// Slices the given `list` or `tuple`. `tuple`s sliced with a step of 1 refer to the
+// elements of the original tuple.
+static pyobj_t* sequence_getslice(pyobj_t* sequence, int64_t start, int64_t step, int64_t count) {
+    bool is_tuple = sequence->type == &py_type_tuple;
+
+    if (is_tuple && step == 1) {
+        if ((size_t)count == sequence->as_list.length)
+            return sequence;
+
+        // The capacity of the view is equal to its length, and tuples never grow, so its
+        // elements will never be reallocated.
+        pyobj_t* view = mm_heap_alloc(sizeof(pyobj_t));
+        view->type = &py_type_tuple;
+        view->as_list.elements = sequence->as_list.elements + start;
+        view->as_list.length = (size_t)count;
+        view->as_list.capacity = (size_t)count;
+        return view;
+    }
+
+    pyobj_t* result = is_tuple ? py_alloc_tuple((size_t)count) : py_alloc_list((size_t)count);
+    result->as_list.length = (size_t)count;
+
+    // Empty results might not have any storage at all.
+    if (count == 0)
+        return result;
+
+    if (step == 1) {
+        memcpy(result->as_list.elements, &sequence->as_list.elements[start], (size_t)count * sizeof(pyobj_t*));
+        return result;
+    }
+
+    for (int64_t i = 0; i < count; i++) {
+        result->as_list.elements[i] = sequence->as_list.elements[start + i * step];
+    }
+
+    return result;
+}
+
+pyreturn_t py_sequence_getslice(pyobj_t* sequence, pyobj_t* slice) {
+    ENSURE_NOT_NULL(sequence);
+
+    bool is_str = sequence->type == &py_type_str;
+    int64_t length = is_str ? py_str_length(sequence) : (int64_t)sequence->as_list.length;
+
+    int64_t start, stop, step, count;
+    pyobj_t* exception = py_slice_resolve(slice, length, &start, &stop, &step, &count);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    if (is_str)
+        return WITH_RESULT(str_getslice(sequence, start, step, count));
+
+    ASSERT(sequence->type == &py_type_list || sequence->type == &py_type_tuple);
+    return WITH_RESULT(sequence_getslice(sequence, start, step, count));
+}
+
+pyobj_t* py_list_setslice(pyobj_t* list, pyobj_t* slice, pyobj_t* iterable) {
+    ENSURE_NOT_NULL(list);
+    ENSURE_NOT_NULL(iterable);
+    ASSERT(list->type == &py_type_list);
+
+    int64_t start, stop, step, count;
+    pyobj_t* exception = py_slice_resolve(slice, (int64_t)list->as_list.length, &start, &stop, &step, &count);
+    if (exception != NULL)
+        return exception;
+
+    // We need to know the amount of items up-front. We also copy the list being assigned
+    // to itself, as we'd otherwise overwrite the items we're reading.
+    pyobj_t* items = iterable;
+    if (iterable == list || (iterable->type != &py_type_list && iterable->type != &py_type_tuple)) {
+        items = py_alloc_list(0);
+
+        if ((exception = py_list_extend(items, iterable)) != NULL)
+            return exception;
+    }
+
+    size_t item_count = items->as_list.length;
+
+    if (step != 1) {
+        if ((size_t)count != item_count)
+            return NEW_EXCEPTION_INLINE(ValueError, "attempt to assign sequence to extended slice of a different size");
+
+        for (int64_t i = 0; i < count; i++) {
+            list->as_list.elements[start + i * step] = items->as_list.elements[i];
+        }
+
+        return NULL;
+    }
+
+    // With a step of 1, the replaced range may have a different size than the new items,
+    // so we move the tail of the list to where the new items end.
+    size_t length = list->as_list.length;
+    size_t tail = (size_t)start + (size_t)count;
+
+    std_vector_reserve(&list->as_list, length - (size_t)count + item_count);
+
+    memmove(
+        &list->as_list.elements[start + item_count],
+        &list->as_list.elements[tail],
+        (length - tail) * sizeof(pyobj_t*)
+    );
+
+    // An empty list or tuple might not have any storage at all.
+    if (item_count != 0) {
+        memcpy(&list->as_list.elements[start], items->as_list.elements, item_count * sizeof(pyobj_t*));
+    }
+
+    list->as_list.length = length - (size_t)count + item_count;
+    return NULL;
+}
+
+pyobj_t* py_list_delslice(pyobj_t* list, pyobj_t* slice) {
+    ENSURE_NOT_NULL(list);
+    ASSERT(list->type == &py_type_list);
+
+    int64_t start, stop, step, count;
+    pyobj_t* exception = py_slice_resolve(slice, (int64_t)list->as_list.length, &start, &stop, &step, &count);
+    if (exception != NULL)
+        return exception;
+
+    if (count == 0)
+        return NULL;
+
+    // We remove the elements in ascending order, so that we can compact the list in a
+    // single pass.
+    if (step < 0) {
+        start += (count - 1) * step;
+        step = -step;
+    }
+
+    pyobj_t** elements = list->as_list.elements;
+    size_t length = list->as_list.length;
+    size_t write = (size_t)start;
+    int64_t removed = 0;
+
+    for (size_t read = (size_t)start; read < length; read++) {
+        bool is_removed = removed < count && read == (size_t)(start + removed * step);
+
+        if (is_removed) {
+            removed++;
+        }
+        else {
+            elements[write++] = elements[read];
+        }
+    }
+
+    list->as_list.length = write;
+    return NULL;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "objects.h"
+#include "exceptions.h"
+
+// Python `slice` objects hold the `start`, `stop` and `step` they were created with in
+// `as_slice` - each of them is either an `int` or `None`.
+//
+// Slicing an immutable sequence (a `str` or a `tuple`) with a step of 1 doesn't copy its
+// contents - the result is a view that refers to the storage of the original sequence,
+// starting at an offset. As neither of them can be modified, views are indistinguishable
+// from copies. Slicing a `list` always copies, as the result has to be independent of the
+// original list.
+
+// Allocates a `slice` with the given bounds.
+pyobj_t* py_alloc_slice(pyobj_t* start, pyobj_t* stop, pyobj_t* step);
+
+// Resolves the bounds of the given `slice` for a sequence of `length` elements, like
+// `slice.indices(length)` does. `out_count` is set to the number of elements the slice
+// selects. Returns an exception or NULL.
+pyobj_t* py_slice_resolve(
+    pyobj_t* slice,
+    int64_t length,
+    int64_t* out_start,
+    int64_t* out_stop,
+    int64_t* out_step,
+    int64_t* out_count
+);
+
+// Implements `sequence[slice]`, where `sequence` is a `str`, `tuple` or `list`.
+pyreturn_t py_sequence_getslice(pyobj_t* sequence, pyobj_t* slice);
+
+// Implements `list[slice] = iterable`. Returns an exception or NULL.
+pyobj_t* py_list_setslice(pyobj_t* list, pyobj_t* slice, pyobj_t* iterable);
+
+// Implements `del list[slice]`. Returns an exception or NULL.
+pyobj_t* py_list_delslice(pyobj_t* list, pyobj_t* slice);
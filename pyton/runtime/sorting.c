@@ -0,0 +1,892 @@
+#include "sorting.h"
+
+#include "ints.h"
+#include "opcodes.h"
+#include "std/memory.h"
+#include "std/safety.h"
+#include "std/string.h"
+#include "sys/mm.h"
+
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+
+uint64_t py_sort_comparisons = 0;
+
+pyobj_t* py_sort_less_than(pyobj_t* a, pyobj_t* b, bool* out_result) {
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+
+    py_sort_comparisons++;
+
+    if (a->type == &py_type_int && b->type == &py_type_int && PY_INT_IS_SMALL(a) && PY_INT_IS_SMALL(b)) {
+        *out_result = a->as_int < b->as_int;
+        return NULL;
+    }
+
+    if (a->type == &py_type_float && b->type == &py_type_float) {
+        *out_result = a->as_float < b->as_float;
+        return NULL;
+    }
+
+    if (a->type == &py_type_str && b->type == &py_type_str) {
+        *out_result = std_strcompare(a->as_str, b->as_str) < 0;
+        return NULL;
+    }
+
+    // Everything else goes through `<`, which may call `__lt__`. Its result doesn't have
+    // to be a `bool`.
+    void* stack[2] = { a, b };
+    int stack_current = 1;
+
+    pyobj_t* exception = py_opcode_compare_lt(stack, &stack_current, true);
+    if (exception != NULL)
+        return exception;
+
+    exception = py_opcode_to_bool(stack, &stack_current);
+    if (exception != NULL)
+        return exception;
+
+    *out_result = ((pyobj_t*)stack[stack_current])->as_bool;
+    return NULL;
+}
+
+// Calls `key` for every one of the `n` objects in `items`, storing the results in `keys`.
+// Returns an exception or NULL.
+static pyobj_t* compute_keys(pyobj_t** items, size_t n, pyobj_t* key, pyobj_t** keys) {
+    for (size_t i = 0; i < n; i++) {
+        pyobj_t* args[] = { items[i] };
+
+        pyreturn_t result = py_call(key, 1, args, 0, NULL, NULL);
+        if (result.exception != NULL)
+            return result.exception;
+
+        keys[i] = NOT_NULL(result.value);
+    }
+
+    return NULL;
+}
+
+// The strategies the engine can use, depending on the types of the keys.
+typedef enum sort_strategy {
+    SORT_RADIX_INT,
+    SORT_RADIX_FLOAT,
+    SORT_STR,
+    SORT_GENERAL
+} sort_strategy_t;
+
+static sort_strategy_t pick_strategy(pyobj_t** keys, size_t n) {
+    pyobj_t* first_type = keys[0]->type;
+
+    for (size_t i = 0; i < n; i++) {
+        pyobj_t* x = keys[i];
+        if (x->type != first_type)
+            return SORT_GENERAL;
+
+        if (x->type == &py_type_int && !PY_INT_IS_SMALL(x))
+            return SORT_GENERAL;
+
+        // NaNs don't order against anything, so there's no key we could map them to.
+        if (x->type == &py_type_float && x->as_float != x->as_float)
+            return SORT_GENERAL;
+    }
+
+    if (first_type == &py_type_int)
+        return SORT_RADIX_INT;
+
+    if (first_type == &py_type_float)
+        return SORT_RADIX_FLOAT;
+
+    if (first_type == &py_type_str)
+        return SORT_STR;
+
+    return SORT_GENERAL;
+}
+
+// Radix sort
+
+typedef struct radix_entry {
+    uint64_t key;
+    pyobj_t* item;
+} radix_entry_t;
+
+// Maps an `int` to an unsigned key that orders like it does.
+static inline uint64_t int_radix_key(const pyobj_t* x) {
+    return (uint64_t)x->as_int ^ 0x8000000000000000u;
+}
+
+// Maps a `float` that is not NaN to an unsigned key that orders like it does. `-0.0` has
+// the key of `0.0`.
+static inline uint64_t float_radix_key(const pyobj_t* x) {
+    double value = x->as_float;
+    uint64_t bits;
+    __builtin_memcpy(&bits, &value, 8);
+    if (value == 0.0)
+        bits = 0;
+
+    return (bits & 0x8000000000000000u) ? ~bits : bits | 0x8000000000000000u;
+}
+
+// Entries shorter than this are sorted by insertion.
+#define RADIX_SORT_THRESHOLD 32
+
+// Sorts the `n` entries by their keys with a stable least-significant-digit radix sort,
+// one pass per byte of the key. Passes over bytes that are the same in all keys are skipped.
+static void radix_sort(radix_entry_t* entries, size_t n) {
+    if (n < RADIX_SORT_THRESHOLD) {
+        for (size_t i = 1; i < n; i++) {
+            radix_entry_t entry = entries[i];
+
+            size_t j = i;
+            for (; j > 0 && entries[j - 1].key > entry.key; j--) {
+                entries[j] = entries[j - 1];
+            }
+
+            entries[j] = entry;
+        }
+
+        return;
+    }
+
+    // All histograms are built in a single pass.
+    size_t* counts = mm_heap_alloc(8 * 256 * sizeof(size_t));
+    memset(counts, 0, 8 * 256 * sizeof(size_t));
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t key = entries[i].key;
+        for (size_t digit = 0; digit < 8; digit++) {
+            counts[digit * 256 + ((key >> (digit * 8)) & 0xFF)]++;
+        }
+    }
+
+    radix_entry_t* scratch = mm_heap_alloc(n * sizeof(radix_entry_t));
+    radix_entry_t* source = entries;
+    radix_entry_t* target = scratch;
+
+    for (size_t digit = 0; digit < 8; digit++) {
+        size_t* histogram = &counts[digit * 256];
+        uint64_t shift = digit * 8;
+
+        // If all keys share this byte, the pass wouldn't move anything.
+        if (histogram[(source[0].key >> shift) & 0xFF] == n)
+            continue;
+
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < 256; bucket++) {
+            size_t count = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += count;
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            target[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+        }
+
+        radix_entry_t* swap = source;
+        source = target;
+        target = swap;
+    }
+
+    if (source != entries) {
+        memcpy(entries, source, n * sizeof(radix_entry_t));
+    }
+
+    mm_heap_free(scratch);
+    mm_heap_free(counts);
+}
+
+static void sort_by_radix(pyobj_t** items, pyobj_t** keys, size_t n, bool is_float, bool reverse) {
+    radix_entry_t* entries = mm_heap_alloc(n * sizeof(radix_entry_t));
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t key = is_float ? float_radix_key(keys[i]) : int_radix_key(keys[i]);
+
+        // Inverting the keys reverses their order, while the sort stays stable.
+        entries[i].key = reverse ? ~key : key;
+        entries[i].item = items[i];
+    }
+
+    radix_sort(entries, n);
+
+    for (size_t i = 0; i < n; i++) {
+        items[i] = entries[i].item;
+    }
+
+    mm_heap_free(entries);
+}
+
+// Pattern-defeating quicksort, for `str` keys
+
+typedef struct str_entry {
+    // The first 8 bytes of the key, where the first one is the most significant. Shorter
+    // keys are padded with zeroes.
+    uint64_t prefix;
+    pyobj_t* key;
+    pyobj_t* item;
+    size_t index;
+} str_entry_t;
+
+// Sub-arrays shorter than this are sorted by insertion.
+#define PDQ_INSERTION_THRESHOLD 24
+
+// Sub-arrays longer than this use the median of 3 medians of 3 as the pivot.
+#define PDQ_NINTHER_THRESHOLD 128
+
+// The amount of elements `partial_insertion_sort` may move before it gives up.
+#define PDQ_PARTIAL_INSERTION_LIMIT 8
+
+static inline uint64_t str_prefix(string_t s) {
+    uint64_t prefix = 0;
+    for (int i = 0; i < 8; i++) {
+        prefix = (prefix << 8) | (i < s.length ? (uint8_t)s.str[i] : 0);
+    }
+
+    return prefix;
+}
+
+// Orders two entries by their keys, and then by their original positions - no two entries
+// are ever equal, which makes the sort stable.
+static ALWAYS_INLINE bool str_less(const str_entry_t* a, const str_entry_t* b, bool reverse) {
+    py_sort_comparisons++;
+
+    int order;
+    if (a->prefix != b->prefix) {
+        order = a->prefix < b->prefix ? -1 : 1;
+    } else {
+        order = std_strcompare(a->key->as_str, b->key->as_str);
+    }
+
+    if (order == 0)
+        return a->index < b->index;
+
+    return reverse ? order > 0 : order < 0;
+}
+
+static ALWAYS_INLINE void str_swap(str_entry_t* a, str_entry_t* b) {
+    str_entry_t tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+static void str_insertion_sort(str_entry_t* begin, str_entry_t* end, bool reverse) {
+    for (str_entry_t* cur = begin + 1; cur < end; cur++) {
+        str_entry_t entry = *cur;
+
+        str_entry_t* sift = cur;
+        for (; sift != begin && str_less(&entry, sift - 1, reverse); sift--) {
+            *sift = *(sift - 1);
+        }
+
+        *sift = entry;
+    }
+}
+
+// Like `str_insertion_sort`, but gives up once more than `PDQ_PARTIAL_INSERTION_LIMIT`
+// elements were moved. Returns `true` if the range got sorted.
+static bool str_partial_insertion_sort(str_entry_t* begin, str_entry_t* end, bool reverse) {
+    size_t moved = 0;
+
+    for (str_entry_t* cur = begin + 1; cur < end; cur++) {
+        if (!str_less(cur, cur - 1, reverse))
+            continue;
+
+        str_entry_t entry = *cur;
+
+        str_entry_t* sift = cur;
+        for (; sift != begin && str_less(&entry, sift - 1, reverse); sift--) {
+            *sift = *(sift - 1);
+        }
+
+        *sift = entry;
+        moved += (size_t)(cur - sift);
+
+        if (moved > PDQ_PARTIAL_INSERTION_LIMIT)
+            return false;
+    }
+
+    return true;
+}
+
+// Sorts the three given entries.
+static ALWAYS_INLINE void str_sort3(str_entry_t* a, str_entry_t* b, str_entry_t* c, bool reverse) {
+    if (str_less(b, a, reverse)) str_swap(a, b);
+    if (str_less(c, b, reverse)) str_swap(b, c);
+    if (str_less(b, a, reverse)) str_swap(a, b);
+}
+
+static void str_sift_down(str_entry_t* heap, size_t n, size_t root, bool reverse) {
+    while (2 * root + 1 < n) {
+        size_t child = 2 * root + 1;
+        if (child + 1 < n && str_less(&heap[child], &heap[child + 1], reverse))
+            child++;
+
+        if (!str_less(&heap[root], &heap[child], reverse))
+            return;
+
+        str_swap(&heap[root], &heap[child]);
+        root = child;
+    }
+}
+
+// The fallback for inputs that make the quicksort keep picking bad pivots.
+static void str_heapsort(str_entry_t* begin, str_entry_t* end, bool reverse) {
+    size_t n = (size_t)(end - begin);
+
+    for (size_t i = n / 2; i-- > 0;) {
+        str_sift_down(begin, n, i, reverse);
+    }
+
+    for (size_t i = n; i-- > 1;) {
+        str_swap(&begin[0], &begin[i]);
+        str_sift_down(begin, i, 0, reverse);
+    }
+}
+
+// Partitions the range around `*begin`, returning the final position of the pivot. The
+// pivot has to be a median, so that there's an element that is not less than it before
+// `end`. Sets `out_already_partitioned` if no elements had to be swapped.
+static str_entry_t* str_partition(str_entry_t* begin, str_entry_t* end, bool reverse, bool* out_already_partitioned) {
+    str_entry_t pivot = *begin;
+    str_entry_t* first = begin;
+    str_entry_t* last = end;
+
+    while (str_less(++first, &pivot, reverse));
+
+    if (first - 1 == begin) {
+        while (first < last && !str_less(--last, &pivot, reverse));
+    } else {
+        while (!str_less(--last, &pivot, reverse));
+    }
+
+    *out_already_partitioned = first >= last;
+
+    while (first < last) {
+        str_swap(first, last);
+        while (str_less(++first, &pivot, reverse));
+        while (!str_less(--last, &pivot, reverse));
+    }
+
+    str_entry_t* pivot_pos = first - 1;
+    *begin = *pivot_pos;
+    *pivot_pos = pivot;
+    return pivot_pos;
+}
+
+static void str_pdqsort(str_entry_t* begin, str_entry_t* end, int bad_allowed, bool reverse) {
+    while (true) {
+        size_t size = (size_t)(end - begin);
+
+        if (size < PDQ_INSERTION_THRESHOLD) {
+            str_insertion_sort(begin, end, reverse);
+            return;
+        }
+
+        size_t s2 = size / 2;
+        if (size > PDQ_NINTHER_THRESHOLD) {
+            str_sort3(begin, begin + s2, end - 1, reverse);
+            str_sort3(begin + 1, begin + (s2 - 1), end - 2, reverse);
+            str_sort3(begin + 2, begin + (s2 + 1), end - 3, reverse);
+            str_sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), reverse);
+            str_swap(begin, begin + s2);
+        } else {
+            str_sort3(begin + s2, begin, end - 1, reverse);
+        }
+
+        bool already_partitioned;
+        str_entry_t* pivot_pos = str_partition(begin, end, reverse, &already_partitioned);
+
+        size_t l_size = (size_t)(pivot_pos - begin);
+        size_t r_size = (size_t)(end - (pivot_pos + 1));
+
+        if (l_size < size / 8 || r_size < size / 8) {
+            // The partition is highly unbalanced - after too many of these, we switch to
+            // heapsort. Until then, we shuffle some elements around, to break patterns that
+            // might be causing this.
+            if (--bad_allowed == 0) {
+                str_heapsort(begin, end, reverse);
+                return;
+            }
+
+            if (l_size >= PDQ_INSERTION_THRESHOLD) {
+                str_swap(begin, begin + l_size / 4);
+                str_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+
+                if (l_size > PDQ_NINTHER_THRESHOLD) {
+                    str_swap(begin + 1, begin + (l_size / 4 + 1));
+                    str_swap(begin + 2, begin + (l_size / 4 + 2));
+                    str_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                    str_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                }
+            }
+
+            if (r_size >= PDQ_INSERTION_THRESHOLD) {
+                str_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                str_swap(end - 1, end - r_size / 4);
+
+                if (r_size > PDQ_NINTHER_THRESHOLD) {
+                    str_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                    str_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                    str_swap(end - 2, end - (1 + r_size / 4));
+                    str_swap(end - 3, end - (2 + r_size / 4));
+                }
+            }
+        } else if (
+            already_partitioned &&
+            str_partial_insertion_sort(begin, pivot_pos, reverse) &&
+            str_partial_insertion_sort(pivot_pos + 1, end, reverse)
+        ) {
+            // The input was (close to being) sorted already.
+            return;
+        }
+
+        // We recurse into the left side, and loop over the right one.
+        str_pdqsort(begin, pivot_pos, bad_allowed, reverse);
+        begin = pivot_pos + 1;
+    }
+}
+
+static void sort_by_str(pyobj_t** items, pyobj_t** keys, size_t n, bool reverse) {
+    str_entry_t* entries = mm_heap_alloc(n * sizeof(str_entry_t));
+
+    for (size_t i = 0; i < n; i++) {
+        entries[i].prefix = str_prefix(keys[i]->as_str);
+        entries[i].key = keys[i];
+        entries[i].item = items[i];
+        entries[i].index = i;
+    }
+
+    // The heapsort fallback kicks in after log2(n) bad partitions.
+    int bad_allowed = 64 - __builtin_clzll((unsigned long long)n);
+    str_pdqsort(entries, entries + n, bad_allowed, reverse);
+
+    for (size_t i = 0; i < n; i++) {
+        items[i] = entries[i].item;
+    }
+
+    mm_heap_free(entries);
+}
+
+// Timsort, with the powersort merge policy
+
+typedef struct sort_entry {
+    pyobj_t* key;
+    pyobj_t* item;
+} sort_entry_t;
+
+typedef struct sort_run {
+    size_t base;
+    size_t length;
+
+    // The power of the boundary between this run and the next one.
+    int power;
+} sort_run_t;
+
+// The powers of the boundaries between the runs on the stack strictly increase, and are
+// between 1 and 64 - so there's at most one more run than there are powers.
+#define MAX_PENDING_RUNS 65
+
+// Evaluates `$a < $b` into `$result`, returning the exception if one is raised.
+#define LESS($a, $b, $result)                                               \
+    {                                                                       \
+        pyobj_t* exception = py_sort_less_than(($a).key, ($b).key, &($result)); \
+        if (exception != NULL)                                              \
+            return exception;                                               \
+    }
+
+static void reverse_entries(sort_entry_t* entries, size_t n) {
+    for (size_t i = 0, j = n - 1; i < j; i++, j--) {
+        sort_entry_t tmp = entries[i];
+        entries[i] = entries[j];
+        entries[j] = tmp;
+    }
+}
+
+// Returns the minimum length of a run, such that `n / min_run` is (close to) a power of 2.
+static size_t compute_min_run(size_t n) {
+    size_t r = 0;
+    while (n >= 64) {
+        r |= n & 1;
+        n >>= 1;
+    }
+
+    return n + r;
+}
+
+// Finds the run that starts at `entries[0]` - either non-descending, or strictly descending,
+// in which case it's reversed. Stores its length in `out_length`. Returns an exception or NULL.
+static pyobj_t* count_run(sort_entry_t* entries, size_t n, size_t* out_length) {
+    if (n == 1) {
+        *out_length = 1;
+        return NULL;
+    }
+
+    bool descending;
+    LESS(entries[1], entries[0], descending);
+
+    size_t length = 2;
+    for (; length < n; length++) {
+        bool less;
+        LESS(entries[length], entries[length - 1], less);
+
+        if (less != descending)
+            break;
+    }
+
+    // Only strictly descending runs may be reversed, since that keeps the sort stable.
+    if (descending) {
+        reverse_entries(entries, length);
+    }
+
+    *out_length = length;
+    return NULL;
+}
+
+// Sorts `entries[0..n]` by inserting each of `entries[sorted..n]` into the sorted prefix,
+// where its position is found with a binary search. Returns an exception or NULL.
+static pyobj_t* binary_insertion_sort(sort_entry_t* entries, size_t sorted, size_t n) {
+    for (size_t i = sorted; i < n; i++) {
+        sort_entry_t entry = entries[i];
+
+        // Equal entries stay after the ones that are already there.
+        size_t lo = 0, hi = i;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+
+            bool less;
+            LESS(entry, entries[mid], less);
+
+            if (less) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+
+        memmove(&entries[lo + 1], &entries[lo], (i - lo) * sizeof(sort_entry_t));
+        entries[lo] = entry;
+    }
+
+    return NULL;
+}
+
+// Finds the amount of entries in the sorted `run` that are not greater than `entry` (if
+// `after_equal` is set), or that are less than `entry`. Returns an exception or NULL.
+static pyobj_t* bisect_run(sort_entry_t entry, sort_entry_t* run, size_t n, bool after_equal, size_t* out_index) {
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        bool goes_before;
+        if (after_equal) {
+            LESS(entry, run[mid], goes_before);
+        } else {
+            bool less;
+            LESS(run[mid], entry, less);
+            goes_before = !less;
+        }
+
+        if (goes_before) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+
+    *out_index = lo;
+    return NULL;
+}
+
+// Merges the adjacent sorted runs `entries[0..n1]` and `entries[n1..n1 + n2]`, using `temp`
+// to hold a copy of the shorter one. Returns an exception or NULL.
+static pyobj_t* merge_runs(sort_entry_t* entries, size_t n1, size_t n2, sort_entry_t* temp) {
+    // Entries of the first run that are not greater than the first entry of the second run
+    // are already in place...
+    size_t skipped;
+    pyobj_t* exception = bisect_run(entries[n1], entries, n1, true, &skipped);
+    if (exception != NULL)
+        return exception;
+
+    entries += skipped;
+    n1 -= skipped;
+    if (n1 == 0)
+        return NULL;
+
+    // ...and so are the entries of the second run that are not less than the last entry of
+    // the first one.
+    exception = bisect_run(entries[n1 - 1], &entries[n1], n2, false, &n2);
+    if (exception != NULL)
+        return exception;
+
+    if (n2 == 0)
+        return NULL;
+
+    sort_entry_t* second = &entries[n1];
+
+    if (n1 <= n2) {
+        memcpy(temp, entries, n1 * sizeof(sort_entry_t));
+
+        size_t i = 0, j = 0, dest = 0;
+        while (i < n1 && j < n2) {
+            bool less;
+            LESS(second[j], temp[i], less);
+            entries[dest++] = less ? second[j++] : temp[i++];
+        }
+
+        // Whatever is left of the second run is in place already.
+        memcpy(&entries[dest], &temp[i], (n1 - i) * sizeof(sort_entry_t));
+    } else {
+        memcpy(temp, second, n2 * sizeof(sort_entry_t));
+
+        size_t i = n1, j = n2, dest = n1 + n2;
+        while (i > 0 && j > 0) {
+            bool less;
+            LESS(temp[j - 1], entries[i - 1], less);
+            entries[--dest] = less ? entries[--i] : temp[--j];
+        }
+
+        // Whatever is left of the first run is in place already.
+        memcpy(entries, temp, j * sizeof(sort_entry_t));
+    }
+
+    return NULL;
+}
+
+// Computes the power of the boundary between the adjacent runs `[s1, s1 + n1)` and
+// `[s1 + n1, s1 + n1 + n2)`, within `n` entries - the first bit in which the midpoints of
+// the runs, as fractions of `n`, differ.
+static int node_power(size_t s1, size_t n1, size_t n2, size_t n) {
+    // The doubled midpoints - their bits are compared against `n`, and not `2 * n`.
+    size_t a = 2 * s1 + n1;
+    size_t b = a + n1 + n2;
+
+    int power = 0;
+    while (true) {
+        power++;
+
+        if (a >= n) {
+            a -= n;
+            b -= n;
+        } else if (b >= n) {
+            break;
+        }
+
+        a <<= 1;
+        b <<= 1;
+    }
+
+    return power;
+}
+
+static pyobj_t* timsort(sort_entry_t* entries, size_t n) {
+    if (n < 2)
+        return NULL;
+
+    sort_entry_t* temp = mm_heap_alloc((n / 2 + 1) * sizeof(sort_entry_t));
+    sort_run_t runs[MAX_PENDING_RUNS];
+    size_t pending = 0;
+    size_t min_run = compute_min_run(n);
+    pyobj_t* exception = NULL;
+
+    for (size_t lo = 0; lo < n;) {
+        size_t length;
+        exception = count_run(&entries[lo], n - lo, &length);
+        if (exception != NULL)
+            goto done;
+
+        // Short runs are extended to `min_run` entries.
+        if (length < min_run) {
+            size_t forced = MIN(min_run, n - lo);
+
+            exception = binary_insertion_sort(&entries[lo], length, forced);
+            if (exception != NULL)
+                goto done;
+
+            length = forced;
+        }
+
+        if (pending != 0) {
+            sort_run_t* top = &runs[pending - 1];
+            int power = node_power(top->base, top->length, length, n);
+
+            // Runs that are separated by boundaries with higher powers are merged first.
+            while (pending > 1 && runs[pending - 2].power > power) {
+                sort_run_t* left = &runs[pending - 2];
+                sort_run_t* right = &runs[pending - 1];
+
+                exception = merge_runs(&entries[left->base], left->length, right->length, temp);
+                if (exception != NULL)
+                    goto done;
+
+                left->length += right->length;
+                pending--;
+            }
+
+            runs[pending - 1].power = power;
+        }
+
+        ASSERT(pending < MAX_PENDING_RUNS);
+        runs[pending++] = (sort_run_t) { .base = lo, .length = length, .power = 0 };
+        lo += length;
+    }
+
+    while (pending > 1) {
+        sort_run_t* left = &runs[pending - 2];
+        sort_run_t* right = &runs[pending - 1];
+
+        exception = merge_runs(&entries[left->base], left->length, right->length, temp);
+        if (exception != NULL)
+            goto done;
+
+        left->length += right->length;
+        pending--;
+    }
+
+done:
+    mm_heap_free(temp);
+    return exception;
+}
+
+static pyobj_t* sort_general(pyobj_t** items, pyobj_t** keys, size_t n, bool reverse) {
+    sort_entry_t* entries = mm_heap_alloc(n * sizeof(sort_entry_t));
+
+    for (size_t i = 0; i < n; i++) {
+        entries[i].key = keys[i];
+        entries[i].item = items[i];
+    }
+
+    // Like CPython, we reverse the entries before and after sorting them, so that entries
+    // with equal keys stay in their original order.
+    if (reverse) {
+        reverse_entries(entries, n);
+    }
+
+    pyobj_t* exception = timsort(entries, n);
+
+    if (exception == NULL) {
+        if (reverse) {
+            reverse_entries(entries, n);
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            items[i] = entries[i].item;
+        }
+    }
+
+    mm_heap_free(entries);
+    return exception;
+}
+
+pyobj_t* py_sort(pyobj_t** items, size_t n, pyobj_t* key, bool reverse) {
+    if (n == 0)
+        return NULL;
+
+    ENSURE_NOT_NULL(items);
+
+    pyobj_t** keys = items;
+    if (key != NULL) {
+        keys = mm_heap_alloc(n * sizeof(pyobj_t*));
+
+        pyobj_t* exception = compute_keys(items, n, key, keys);
+        if (exception != NULL) {
+            mm_heap_free(keys);
+            return exception;
+        }
+    }
+
+    pyobj_t* exception = NULL;
+
+    if (n > 1) {
+        switch (pick_strategy(keys, n)) {
+            case SORT_RADIX_INT: sort_by_radix(items, keys, n, false, reverse); break;
+            case SORT_RADIX_FLOAT: sort_by_radix(items, keys, n, true, reverse); break;
+            case SORT_STR: sort_by_str(items, keys, n, reverse); break;
+            default: exception = sort_general(items, keys, n, reverse); break;
+        }
+    }
+
+    if (keys != items) {
+        mm_heap_free(keys);
+    }
+
+    return exception;
+}
+
+pyobj_t* py_sort_parse_kwargs(
+    int kwargc,
+    symbol_t* kwargv,
+    pyobj_t** out_key,
+    bool* out_reverse,
+    pyobj_t** out_default
+) {
+    *out_key = NULL;
+
+    if (out_reverse != NULL) {
+        *out_reverse = false;
+    }
+
+    if (out_default != NULL) {
+        *out_default = NULL;
+    }
+
+    for (int i = 0; i < kwargc; i++) {
+        pyobj_t* value = NOT_NULL(kwargv[i].value);
+
+        if (std_strequ(kwargv[i].name, STR("key"))) {
+            *out_key = value != &py_none ? value : NULL;
+        }
+        else if (out_reverse != NULL && std_strequ(kwargv[i].name, STR("reverse"))) {
+            void* local[1] = { value };
+            int local_current = 0;
+
+            pyobj_t* exception = py_opcode_to_bool(local, &local_current);
+            if (exception != NULL)
+                return exception;
+
+            *out_reverse = ((pyobj_t*)local[0])->as_bool;
+        }
+        else if (out_default != NULL && std_strequ(kwargv[i].name, STR("default"))) {
+            *out_default = value;
+        }
+        else {
+            return NEW_EXCEPTION_INLINE(TypeError, "unexpected keyword argument");
+        }
+    }
+
+    return NULL;
+}
+
+pyreturn_t py_sort_extreme(pyobj_t** items, size_t n, pyobj_t* key, bool is_max) {
+    ENSURE_NOT_NULL(items);
+    ASSERT(n != 0);
+
+    pyobj_t* best = items[0];
+    pyobj_t* best_key = best;
+
+    for (size_t i = 0; i < n; i++) {
+        pyobj_t* item_key = items[i];
+        if (key != NULL) {
+            pyobj_t* args[] = { items[i] };
+            item_key = UNWRAP(py_call(key, 1, args, 0, NULL, NULL));
+        }
+
+        if (i == 0) {
+            best_key = item_key;
+            continue;
+        }
+
+        // Only strictly smaller (or larger) items replace the best one, which means that
+        // the first one wins out of equal items.
+        bool replaces;
+        pyobj_t* exception = is_max
+            ? py_sort_less_than(best_key, item_key, &replaces)
+            : py_sort_less_than(item_key, best_key, &replaces);
+
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+
+        if (replaces) {
+            best = items[i];
+            best_key = item_key;
+        }
+    }
+
+    return WITH_RESULT(best);
+}
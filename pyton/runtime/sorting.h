@@ -0,0 +1,53 @@
+#pragma once
+
+#include "objects.h"
+#include "exceptions.h"
+
+// The sort engine, shared by `sorted`, `list.sort`, `min`, `max` and the `heapq` module.
+// If a `key` function is given, it is called exactly once per item, before any comparisons
+// are made. The engine then picks a strategy based on the keys:
+//
+//      - if every key is an exact, 64-bit `int`, or every key is an exact `float` that is
+//        not NaN, the keys are mapped to unsigned integers that order like they do, and the
+//        items are sorted with a least-significant-digit radix sort,
+//      - if every key is an exact `str`, the items are sorted with a pattern-defeating
+//        quicksort, which compares the first 8 bytes of the keys as a single integer before
+//        falling back to comparing them in full. Strings are UTF-8, where byte order matches
+//        code point order, so this holds for all strings - not just ASCII ones. Keys that
+//        compare equal are ordered by their original position, which keeps the sort stable,
+//      - otherwise, the items are sorted with Timsort, which merges natural runs in the
+//        order given by the powersort merge policy. Keys are compared with `<`, like in
+//        CPython.
+//
+// Like in CPython, sorting with `reverse` set keeps items with equal keys in their original
+// order. If a comparison (or a call to `key`) raises an exception, the items are left in
+// their original order.
+
+// The amount of comparisons between two keys the engine made so far. Radix sorts don't
+// compare keys at all. Exposed to Python via the `sort_comparisons()` builtin.
+extern uint64_t py_sort_comparisons;
+
+// Sorts the `n` objects in `items` in place, ordering them by `key(item)` if `key` is not
+// `NULL`, or by the items themselves otherwise. Returns an exception or NULL.
+pyobj_t* py_sort(pyobj_t** items, size_t n, pyobj_t* key, bool reverse);
+
+// Implements `a < b` as the sort engine does - the result is always converted to a `bool`.
+// Returns an exception or NULL.
+pyobj_t* py_sort_less_than(pyobj_t* a, pyobj_t* b, bool* out_result);
+
+// Parses the keyword arguments accepted by `sorted` and `list.sort` - `key` and `reverse` -
+// or, if `out_default` is not `NULL`, by `min` and `max` - `key` and `default`. `key` is set
+// to `NULL` if it was not given or is `None`, and `default` is set to `NULL` if it was not
+// given. Returns an exception or NULL.
+pyobj_t* py_sort_parse_kwargs(
+    int kwargc,
+    symbol_t* kwargv,
+    pyobj_t** out_key,
+    bool* out_reverse,
+    pyobj_t** out_default
+);
+
+// Finds the first smallest (or, if `is_max` is `true`, the first largest) of the `n` objects
+// in `items`, comparing `key(item)` if `key` is not `NULL`. `n` must not be 0. Returns an
+// exception or the found object.
+pyreturn_t py_sort_extreme(pyobj_t** items, size_t n, pyobj_t* key, bool is_max);
@@ -0,0 +1,825 @@
+#include "bigint.h"
+
+#include "safety.h"
+#include "memory.h"
+#include "numfmt.h"
+#include "../sys/mm.h"
+
+typedef unsigned __int128 bigint_dlimb_t;
+
+#define LIMB_BITS 64
+
+// Divides the 128-bit value `hi:lo` by `d`. The quotient must fit in 64 bits, i.e.
+// `hi` must be lower than `d`. We can't divide `unsigned __int128`s directly, as
+// that would require `__udivti3` from libgcc, which we do not link against.
+static inline bigint_limb_t udiv128(
+    bigint_limb_t hi,
+    bigint_limb_t lo,
+    bigint_limb_t d,
+    bigint_limb_t* out_rem
+) {
+    bigint_limb_t quotient, rem;
+    __asm__ ("{divq %4|div %4}" : "=a"(quotient), "=d"(rem) : "a"(lo), "d"(hi), "r"(d));
+    *out_rem = rem;
+    return quotient;
+}
+
+// Allocates `n` limbs. The contents are undefined.
+static bigint_limb_t* limbs_alloc(size_t n) {
+    return mm_heap_alloc((n == 0 ? 1 : n) * sizeof(bigint_limb_t));
+}
+
+// Allocates `n` limbs, set to zero.
+static bigint_limb_t* limbs_alloc_zero(size_t n) {
+    bigint_limb_t* limbs = limbs_alloc(n);
+    memset(limbs, 0, n * sizeof(bigint_limb_t));
+    return limbs;
+}
+
+// Returns the length of the given magnitude, without its leading zero limbs.
+static size_t mag_normalize(const bigint_limb_t* x, size_t n) {
+    while (n > 0 && x[n - 1] == 0) {
+        n--;
+    }
+
+    return n;
+}
+
+// Wraps a magnitude of `n` limbs (which may include leading zero limbs) in a `bigint_t`.
+// The limbs become owned by the returned value.
+static bigint_t* bigint_wrap(bigint_limb_t* limbs, size_t n, bool negative) {
+    n = mag_normalize(limbs, n);
+
+    bigint_t* x = mm_heap_alloc(sizeof(bigint_t));
+    x->limbs = limbs;
+    x->length = n;
+    x->negative = n != 0 && negative;
+    return x;
+}
+
+// Compares two normalized magnitudes.
+static int mag_compare(const bigint_limb_t* a, size_t an, const bigint_limb_t* b, size_t bn) {
+    if (an != bn)
+        return an < bn ? -1 : 1;
+
+    for (size_t i = an; i-- > 0;) {
+        if (a[i] != b[i])
+            return a[i] < b[i] ? -1 : 1;
+    }
+
+    return 0;
+}
+
+// Adds `y` to `x` in-place, where `xn >= yn`. Returns the carry out of the most
+// significant limb of `x`.
+static bigint_limb_t mag_add_inplace(bigint_limb_t* x, size_t xn, const bigint_limb_t* y, size_t yn) {
+    bigint_limb_t carry = 0;
+    size_t i = 0;
+
+    for (; i < yn; i++) {
+        bigint_limb_t sum = x[i] + carry;
+        carry = sum < carry;
+        sum += y[i];
+        carry += sum < y[i];
+        x[i] = sum;
+    }
+
+    for (; carry != 0 && i < xn; i++) {
+        x[i] += 1;
+        carry = x[i] == 0;
+    }
+
+    return carry;
+}
+
+// Subtracts `y` from `x` in-place, where `x >= y` and `xn >= yn`.
+static void mag_sub_inplace(bigint_limb_t* x, size_t xn, const bigint_limb_t* y, size_t yn) {
+    bigint_limb_t borrow = 0;
+    size_t i = 0;
+
+    for (; i < yn; i++) {
+        bigint_limb_t yi = y[i] + borrow;
+        borrow = (yi < borrow) | (x[i] < yi);
+        x[i] -= yi;
+    }
+
+    for (; borrow != 0 && i < xn; i++) {
+        borrow = x[i] == 0;
+        x[i] -= 1;
+    }
+
+    ASSERT(borrow == 0);
+}
+
+// Computes `r = a * b` via the schoolbook method. `r` must have room for `an + bn` limbs,
+// and may not alias `a` or `b`.
+static void mag_mul_schoolbook(
+    bigint_limb_t* r,
+    const bigint_limb_t* a, size_t an,
+    const bigint_limb_t* b, size_t bn
+) {
+    memset(r, 0, (an + bn) * sizeof(bigint_limb_t));
+
+    for (size_t i = 0; i < an; i++) {
+        bigint_limb_t carry = 0;
+        bigint_limb_t ai = a[i];
+
+        if (ai == 0)
+            continue;
+
+        for (size_t j = 0; j < bn; j++) {
+            bigint_dlimb_t t = (bigint_dlimb_t)ai * b[j] + r[i + j] + carry;
+            r[i + j] = (bigint_limb_t)t;
+            carry = (bigint_limb_t)(t >> LIMB_BITS);
+        }
+
+        r[i + bn] = carry;
+    }
+}
+
+// Computes `r = a * b`. `r` must have room for `an + bn` limbs, and may not alias `a` or `b`.
+// Operands may contain leading zero limbs.
+static void mag_mul(
+    bigint_limb_t* r,
+    const bigint_limb_t* a, size_t an,
+    const bigint_limb_t* b, size_t bn
+) {
+    if (an < bn) {
+        const bigint_limb_t* tmp = a; a = b; b = tmp;
+        size_t tmp_n = an; an = bn; bn = tmp_n;
+    }
+
+    if (bn < BIGINT_KARATSUBA_THRESHOLD) {
+        mag_mul_schoolbook(r, a, an, b, bn);
+        return;
+    }
+
+    if (2 * bn <= an) {
+        // The operands are very unbalanced - Karatsuba works best when they have similar
+        // lengths. We split `a` into chunks of `bn` limbs, and accumulate their products.
+        memset(r, 0, (an + bn) * sizeof(bigint_limb_t));
+        bigint_limb_t* product = limbs_alloc(2 * bn);
+
+        for (size_t i = 0; i < an; i += bn) {
+            size_t chunk = MIN(bn, an - i);
+            mag_mul(product, a + i, chunk, b, bn);
+            mag_add_inplace(r + i, an + bn - i, product, chunk + bn);
+        }
+
+        mm_heap_free(product);
+        return;
+    }
+
+    // We split both operands at `m` limbs:
+    //      a = a1 * B^m + a0,      b = b1 * B^m + b0
+    // ...and compute:
+    //      a * b = z2 * B^2m + z1 * B^m + z0
+    // ...where:
+    //      z0 = a0 * b0,   z2 = a1 * b1,   z1 = (a0 + a1)(b0 + b1) - z0 - z2
+    // This takes three half-sized multiplications instead of four.
+    size_t m = an / 2;
+    size_t a1n = an - m;
+    size_t b1n = bn - m;
+
+    mag_mul(r, a, m, b, m);                     // z0 -> r[0, 2m)
+    mag_mul(r + 2 * m, a + m, a1n, b + m, b1n); // z2 -> r[2m, an + bn)
+
+    size_t sa_n = a1n + 1;
+    bigint_limb_t* sa = limbs_alloc_zero(sa_n);
+    memcpy(sa, a + m, a1n * sizeof(bigint_limb_t));
+    mag_add_inplace(sa, sa_n, a, m);
+
+    size_t sb_n = MAX(m, b1n) + 1;
+    bigint_limb_t* sb = limbs_alloc_zero(sb_n);
+    memcpy(sb, b, m * sizeof(bigint_limb_t));
+    mag_add_inplace(sb, sb_n, b + m, b1n);
+
+    size_t z1_n = sa_n + sb_n;
+    bigint_limb_t* z1 = limbs_alloc(z1_n);
+    mag_mul(z1, sa, sa_n, sb, sb_n);
+    mag_sub_inplace(z1, z1_n, r, 2 * m);
+    mag_sub_inplace(z1, z1_n, r + 2 * m, a1n + b1n);
+
+    // The operand sums may have had a carry limb, but z1 itself always fits.
+    z1_n = mag_normalize(z1, z1_n);
+    ASSERT(z1_n <= an + bn - m);
+    ASSERT(mag_add_inplace(r + m, an + bn - m, z1, z1_n) == 0);
+
+    mm_heap_free(sa);
+    mm_heap_free(sb);
+    mm_heap_free(z1);
+}
+
+// Divides the normalized magnitude `u` by the normalized magnitude `v`, where `un >= vn`
+// and `vn > 0`. `q` must have room for `un - vn + 1` limbs, and `r` for `vn` limbs.
+// This is Knuth's Algorithm D (TAOCP vol. 2, 4.3.1).
+static void mag_divmod(
+    const bigint_limb_t* u, size_t un,
+    const bigint_limb_t* v, size_t vn,
+    bigint_limb_t* q,
+    bigint_limb_t* r
+) {
+    ASSERT(vn > 0 && un >= vn && v[vn - 1] != 0);
+
+    if (vn == 1) {
+        bigint_limb_t rem = 0;
+        for (size_t i = un; i-- > 0;) {
+            q[i] = udiv128(rem, u[i], v[0], &rem);
+        }
+
+        r[0] = rem;
+        return;
+    }
+
+    // Normalize, so that the most significant bit of the divisor is set. This makes
+    // the quotient digit estimates off by at most 2.
+    int s = __builtin_clzll(v[vn - 1]);
+
+    bigint_limb_t* vs = limbs_alloc(vn);
+    for (size_t i = vn - 1; i > 0; i--) {
+        vs[i] = (v[i] << s) | (s == 0 ? 0 : v[i - 1] >> (LIMB_BITS - s));
+    }
+    vs[0] = v[0] << s;
+
+    bigint_limb_t* us = limbs_alloc(un + 1);
+    us[un] = s == 0 ? 0 : u[un - 1] >> (LIMB_BITS - s);
+    for (size_t i = un - 1; i > 0; i--) {
+        us[i] = (u[i] << s) | (s == 0 ? 0 : u[i - 1] >> (LIMB_BITS - s));
+    }
+    us[0] = u[0] << s;
+
+    bigint_limb_t v_top = vs[vn - 1];
+    bigint_limb_t v_next = vs[vn - 2];
+
+    for (size_t j = un - vn + 1; j-- > 0;) {
+        // Estimate the quotient digit from the top two limbs of the dividend.
+        bigint_limb_t qhat, rhat;
+        bool rhat_overflow = false;
+
+        if (us[j + vn] >= v_top) {
+            qhat = ~(bigint_limb_t)0;
+            rhat = us[j + vn - 1] + v_top;
+            rhat_overflow = rhat < v_top;
+        }
+        else {
+            qhat = udiv128(us[j + vn], us[j + vn - 1], v_top, &rhat);
+        }
+
+        while (
+            !rhat_overflow &&
+            (bigint_dlimb_t)qhat * v_next > (((bigint_dlimb_t)rhat << LIMB_BITS) | us[j + vn - 2])
+        ) {
+            qhat--;
+            rhat += v_top;
+            rhat_overflow = rhat < v_top;
+        }
+
+        // Multiply and subtract.
+        bigint_limb_t carry = 0, borrow = 0;
+        for (size_t i = 0; i < vn; i++) {
+            bigint_dlimb_t p = (bigint_dlimb_t)qhat * vs[i] + carry;
+            carry = (bigint_limb_t)(p >> LIMB_BITS);
+
+            bigint_limb_t sub = (bigint_limb_t)p + borrow;
+            borrow = (sub < borrow) | (us[i + j] < sub);
+            us[i + j] -= sub;
+        }
+
+        bigint_limb_t sub = carry + borrow;
+        bool negative = (sub < borrow) | (us[j + vn] < sub);
+        us[j + vn] -= sub;
+
+        if (negative) {
+            // The estimate was one too large - add the divisor back.
+            qhat--;
+            us[j + vn] += mag_add_inplace(us + j, vn, vs, vn);
+        }
+
+        q[j] = qhat;
+    }
+
+    // Un-normalize the remainder.
+    for (size_t i = 0; i < vn; i++) {
+        r[i] = (us[i] >> s) | (s == 0 ? 0 : us[i + 1] << (LIMB_BITS - s));
+    }
+
+    mm_heap_free(vs);
+    mm_heap_free(us);
+}
+
+bigint_t* std_bigint_from_i64(int64_t x) {
+    bigint_limb_t* limbs = limbs_alloc(1);
+
+    // Negating INT64_MIN overflows, so we negate in the unsigned domain instead.
+    limbs[0] = x < 0 ? -(uint64_t)x : (uint64_t)x;
+    return bigint_wrap(limbs, 1, x < 0);
+}
+
+bool std_bigint_to_i64(const bigint_t* x, int64_t* out) {
+    ENSURE_NOT_NULL(x);
+
+    if (x->length == 0) {
+        *out = 0;
+        return true;
+    }
+
+    if (x->length != 1)
+        return false;
+
+    bigint_limb_t mag = x->limbs[0];
+    if (!x->negative) {
+        if (mag > INT64_MAX)
+            return false;
+
+        *out = (int64_t)mag;
+        return true;
+    }
+
+    if (mag > (uint64_t)INT64_MAX + 1)
+        return false;
+
+    *out = (int64_t)(-mag);
+    return true;
+}
+
+int std_bigint_compare(const bigint_t* a, const bigint_t* b) {
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+
+    if (a->negative != b->negative)
+        return a->negative ? -1 : 1;
+
+    int mag = mag_compare(a->limbs, a->length, b->limbs, b->length);
+    return a->negative ? -mag : mag;
+}
+
+bigint_t* std_bigint_neg(const bigint_t* x) {
+    ENSURE_NOT_NULL(x);
+
+    // Limbs are never mutated, so they can be shared.
+    bigint_t* result = mm_heap_alloc(sizeof(bigint_t));
+    result->limbs = x->limbs;
+    result->length = x->length;
+    result->negative = x->length != 0 && !x->negative;
+    return result;
+}
+
+// Computes `a + b` if `negate_b` is `false`, and `a - b` otherwise.
+static bigint_t* bigint_add_signed(const bigint_t* a, const bigint_t* b, bool negate_b) {
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+
+    bool b_negative = b->negative != negate_b;
+
+    if (a->negative == b_negative) {
+        // Same signs - add the magnitudes.
+        const bigint_t* longer = a->length >= b->length ? a : b;
+        const bigint_t* shorter = longer == a ? b : a;
+
+        bigint_limb_t* limbs = limbs_alloc(longer->length + 1);
+        memcpy(limbs, longer->limbs, longer->length * sizeof(bigint_limb_t));
+        limbs[longer->length] = mag_add_inplace(limbs, longer->length, shorter->limbs, shorter->length);
+        return bigint_wrap(limbs, longer->length + 1, a->negative);
+    }
+
+    // Different signs - subtract the smaller magnitude from the larger one.
+    int cmp = mag_compare(a->limbs, a->length, b->limbs, b->length);
+    if (cmp == 0)
+        return bigint_wrap(limbs_alloc(0), 0, false);
+
+    const bigint_t* larger = cmp > 0 ? a : b;
+    const bigint_t* smaller = cmp > 0 ? b : a;
+
+    bigint_limb_t* limbs = limbs_alloc(larger->length);
+    memcpy(limbs, larger->limbs, larger->length * sizeof(bigint_limb_t));
+    mag_sub_inplace(limbs, larger->length, smaller->limbs, smaller->length);
+    return bigint_wrap(limbs, larger->length, cmp > 0 ? a->negative : b_negative);
+}
+
+bigint_t* std_bigint_add(const bigint_t* a, const bigint_t* b) {
+    return bigint_add_signed(a, b, false);
+}
+
+bigint_t* std_bigint_sub(const bigint_t* a, const bigint_t* b) {
+    return bigint_add_signed(a, b, true);
+}
+
+bigint_t* std_bigint_mul(const bigint_t* a, const bigint_t* b) {
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+
+    if (a->length == 0 || b->length == 0)
+        return bigint_wrap(limbs_alloc(0), 0, false);
+
+    size_t n = a->length + b->length;
+    bigint_limb_t* limbs = limbs_alloc(n);
+    mag_mul(limbs, a->limbs, a->length, b->limbs, b->length);
+    return bigint_wrap(limbs, n, a->negative != b->negative);
+}
+
+void std_bigint_divmod(
+    const bigint_t* a,
+    const bigint_t* b,
+    bigint_t** out_quotient,
+    bigint_t** out_remainder
+) {
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+    ASSERT(b->length != 0);
+
+    bigint_limb_t* q;
+    bigint_limb_t* r;
+    size_t qn, rn;
+
+    if (mag_compare(a->limbs, a->length, b->limbs, b->length) < 0) {
+        // |a| < |b| - the (truncated) quotient is zero.
+        q = limbs_alloc(0);
+        qn = 0;
+        r = limbs_alloc(a->length);
+        rn = a->length;
+        memcpy(r, a->limbs, a->length * sizeof(bigint_limb_t));
+    }
+    else {
+        qn = a->length - b->length + 1;
+        rn = b->length;
+        q = limbs_alloc(qn);
+        r = limbs_alloc(rn);
+        mag_divmod(a->limbs, a->length, b->limbs, b->length, q, r);
+    }
+
+    bool signs_differ = a->negative != b->negative;
+    bool has_remainder = mag_normalize(r, rn) != 0;
+
+    if (signs_differ && has_remainder) {
+        // Truncated division rounds towards zero - Python rounds towards negative
+        // infinity, so we need to adjust both results:
+        //      q = -(|q| + 1),     r = |b| - |r|   (with the sign of b)
+        bigint_limb_t* q_adj = limbs_alloc(qn + 1);
+        memcpy(q_adj, q, qn * sizeof(bigint_limb_t));
+        q_adj[qn] = 0;
+        bigint_limb_t one = 1;
+        mag_add_inplace(q_adj, qn + 1, &one, 1);
+        mm_heap_free(q);
+        q = q_adj;
+        qn++;
+
+        bigint_limb_t* r_adj = limbs_alloc(b->length);
+        memcpy(r_adj, b->limbs, b->length * sizeof(bigint_limb_t));
+        mag_sub_inplace(r_adj, b->length, r, mag_normalize(r, rn));
+        mm_heap_free(r);
+        r = r_adj;
+        rn = b->length;
+    }
+
+    if (out_quotient != NULL) {
+        *out_quotient = bigint_wrap(q, qn, signs_differ);
+    }
+    else {
+        mm_heap_free(q);
+    }
+
+    if (out_remainder != NULL) {
+        *out_remainder = bigint_wrap(r, rn, b->negative);
+    }
+    else {
+        mm_heap_free(r);
+    }
+}
+
+bigint_t* std_bigint_pow(const bigint_t* base, uint64_t exp) {
+    ENSURE_NOT_NULL(base);
+
+    bigint_t* result = std_bigint_from_i64(1);
+    const bigint_t* square = base;
+
+    while (exp != 0) {
+        if (exp & 1) {
+            result = std_bigint_mul(result, square);
+        }
+
+        exp >>= 1;
+        if (exp != 0) {
+            square = std_bigint_mul(square, square);
+        }
+    }
+
+    return result;
+}
+
+bigint_t* std_bigint_powmod(const bigint_t* base, const bigint_t* exp, const bigint_t* mod) {
+    ENSURE_NOT_NULL(base);
+    ENSURE_NOT_NULL(exp);
+    ENSURE_NOT_NULL(mod);
+    ASSERT(!exp->negative);
+    ASSERT(mod->length != 0);
+
+    bigint_t* result;
+    bigint_t* b;
+    std_bigint_divmod(std_bigint_from_i64(1), mod, NULL, &result);
+    std_bigint_divmod(base, mod, NULL, &b);
+
+    // Left-to-right binary exponentiation, reducing after every multiplication.
+    for (size_t i = std_bigint_bit_length(exp); i-- > 0;) {
+        std_bigint_divmod(std_bigint_mul(result, result), mod, NULL, &result);
+
+        if ((exp->limbs[i / LIMB_BITS] >> (i % LIMB_BITS)) & 1) {
+            std_bigint_divmod(std_bigint_mul(result, b), mod, NULL, &result);
+        }
+    }
+
+    return result;
+}
+
+bigint_t* std_bigint_invmod(const bigint_t* x, const bigint_t* mod) {
+    ENSURE_NOT_NULL(x);
+    ENSURE_NOT_NULL(mod);
+    ASSERT(!mod->negative && mod->length != 0);
+
+    // The extended Euclidean algorithm - throughout, `r = s * x (mod mod)` holds for both
+    // pairs, and the last non-zero remainder is gcd(x, mod).
+    bigint_t* reduced;
+    std_bigint_divmod(x, mod, NULL, &reduced);
+
+    const bigint_t* old_r = reduced;
+    const bigint_t* r = mod;
+    const bigint_t* old_s = std_bigint_from_i64(1);
+    const bigint_t* s = std_bigint_from_i64(0);
+
+    while (r->length != 0) {
+        bigint_t* q;
+        bigint_t* next_r;
+        std_bigint_divmod(old_r, r, &q, &next_r);
+
+        bigint_t* next_s = std_bigint_sub(old_s, std_bigint_mul(q, s));
+        old_r = r;
+        r = next_r;
+        old_s = s;
+        s = next_s;
+    }
+
+    if (old_r->length != 1 || old_r->limbs[0] != 1)
+        return NULL;
+
+    bigint_t* result;
+    std_bigint_divmod(old_s, mod, NULL, &result);
+    return result;
+}
+
+// Shifts the magnitude `x` left by `shift` bits into a new limb array of `*out_n` limbs.
+static bigint_limb_t* mag_lshift(const bigint_limb_t* x, size_t n, size_t shift, size_t* out_n) {
+    size_t limb_shift = shift / LIMB_BITS;
+    int bit_shift = shift % LIMB_BITS;
+
+    size_t rn = n + limb_shift + 1;
+    bigint_limb_t* r = limbs_alloc_zero(rn);
+
+    for (size_t i = 0; i < n; i++) {
+        r[i + limb_shift] |= x[i] << bit_shift;
+        if (bit_shift != 0) {
+            r[i + limb_shift + 1] = x[i] >> (LIMB_BITS - bit_shift);
+        }
+    }
+
+    *out_n = rn;
+    return r;
+}
+
+bigint_t* std_bigint_lshift(const bigint_t* x, size_t shift) {
+    ENSURE_NOT_NULL(x);
+
+    size_t n;
+    bigint_limb_t* limbs = mag_lshift(x->limbs, x->length, shift, &n);
+    return bigint_wrap(limbs, n, x->negative);
+}
+
+bigint_t* std_bigint_rshift(const bigint_t* x, size_t shift) {
+    ENSURE_NOT_NULL(x);
+
+    size_t limb_shift = shift / LIMB_BITS;
+    int bit_shift = shift % LIMB_BITS;
+
+    if (limb_shift >= x->length) {
+        // Everything gets shifted out.
+        return std_bigint_from_i64(x->negative ? -1 : 0);
+    }
+
+    size_t rn = x->length - limb_shift;
+    bigint_limb_t* r = limbs_alloc(rn);
+
+    for (size_t i = 0; i < rn; i++) {
+        bigint_limb_t hi = i + limb_shift + 1 < x->length ? x->limbs[i + limb_shift + 1] : 0;
+        r[i] = (x->limbs[i + limb_shift] >> bit_shift) | (bit_shift == 0 ? 0 : hi << (LIMB_BITS - bit_shift));
+    }
+
+    bigint_t* result = bigint_wrap(r, rn, x->negative);
+
+    if (x->negative) {
+        // For negative values, `>>` rounds towards negative infinity - so if we've
+        // shifted out any set bits, the magnitude needs to be incremented.
+        bool lost_bits = bit_shift != 0 && (x->limbs[limb_shift] & ((1ull << bit_shift) - 1)) != 0;
+        for (size_t i = 0; !lost_bits && i < limb_shift; i++) {
+            lost_bits = x->limbs[i] != 0;
+        }
+
+        if (lost_bits) {
+            result = std_bigint_sub(result, std_bigint_from_i64(1));
+        }
+    }
+
+    return result;
+}
+
+// Converts `x` to a two's complement representation that is `n` limbs wide.
+static bigint_limb_t* to_twos_complement(const bigint_t* x, size_t n) {
+    bigint_limb_t* r = limbs_alloc_zero(n);
+    memcpy(r, x->limbs, x->length * sizeof(bigint_limb_t));
+
+    if (x->negative) {
+        for (size_t i = 0; i < n; i++) {
+            r[i] = ~r[i];
+        }
+
+        bigint_limb_t one = 1;
+        mag_add_inplace(r, n, &one, 1);
+    }
+
+    return r;
+}
+
+// Converts a two's complement value that is `n` limbs wide back to a `bigint_t`.
+// Takes ownership of `x`.
+static bigint_t* from_twos_complement(bigint_limb_t* x, size_t n) {
+    bool negative = n != 0 && (x[n - 1] >> (LIMB_BITS - 1)) != 0;
+
+    if (negative) {
+        for (size_t i = 0; i < n; i++) {
+            x[i] = ~x[i];
+        }
+
+        bigint_limb_t one = 1;
+        mag_add_inplace(x, n, &one, 1);
+    }
+
+    return bigint_wrap(x, n, negative);
+}
+
+// Implements a bitwise operation over the two's complement representations of `a` and `b`.
+#define BITWISE_OPERATION($a, $b, $op)                                          \
+    {                                                                           \
+        ENSURE_NOT_NULL($a);                                                    \
+        ENSURE_NOT_NULL($b);                                                    \
+        /* the extra limb holds the sign */                                     \
+        size_t n = MAX(($a)->length, ($b)->length) + 1;                         \
+        bigint_limb_t* ta = to_twos_complement($a, n);                          \
+        bigint_limb_t* tb = to_twos_complement($b, n);                          \
+        for (size_t i = 0; i < n; i++) {                                        \
+            ta[i] = ta[i] $op tb[i];                                            \
+        }                                                                       \
+        mm_heap_free(tb);                                                       \
+        return from_twos_complement(ta, n);                                     \
+    }
+
+bigint_t* std_bigint_and(const bigint_t* a, const bigint_t* b) BITWISE_OPERATION(a, b, &)
+bigint_t* std_bigint_or(const bigint_t* a, const bigint_t* b) BITWISE_OPERATION(a, b, |)
+bigint_t* std_bigint_xor(const bigint_t* a, const bigint_t* b) BITWISE_OPERATION(a, b, ^)
+
+uint64_t std_mulmod_u64(uint64_t a, uint64_t b, uint64_t m) {
+    ASSERT(a < m && b < m);
+
+    bigint_dlimb_t product = (bigint_dlimb_t)a * b;
+
+    // As both factors are lower than `m`, the high half of the product is too.
+    bigint_limb_t rem;
+    udiv128((bigint_limb_t)(product >> LIMB_BITS), (bigint_limb_t)product, m, &rem);
+    return rem;
+}
+
+// Reinterprets the bits of a `double` as an integer, and vice versa.
+typedef union double_bits {
+    double value;
+    uint64_t bits;
+} double_bits_t;
+
+bool std_bigint_to_double(const bigint_t* x, double* out) {
+    ENSURE_NOT_NULL(x);
+
+    size_t bits = std_bigint_bit_length(x);
+    if (bits > 1024)
+        return false;
+
+    uint64_t top;
+    size_t shift = 0;
+    bool sticky = false;
+
+    if (bits <= LIMB_BITS) {
+        top = x->length == 0 ? 0 : x->limbs[0];
+    }
+    else {
+        // We take the 64 most significant bits, and fold everything below them into
+        // a single "sticky" bit. As that bit sits far below the 53 bits that make up
+        // the mantissa, converting `top` rounds exactly as if all bits were present.
+        shift = bits - LIMB_BITS;
+        size_t limb = shift / LIMB_BITS;
+        size_t offset = shift % LIMB_BITS;
+
+        top = x->limbs[limb] >> offset;
+        if (offset != 0) {
+            top |= x->limbs[limb + 1] << (LIMB_BITS - offset);
+            sticky = (x->limbs[limb] & ((1ull << offset) - 1)) != 0;
+        }
+
+        for (size_t i = 0; i < limb && !sticky; i++) {
+            sticky = x->limbs[i] != 0;
+        }
+    }
+
+    double result = (double)(top | sticky);
+
+    if (shift != 0) {
+        // `shift` is at most 960, so 2^shift is always a normal `double`.
+        double_bits_t scale = { .bits = (uint64_t)(shift + 1023) << 52 };
+        result *= scale.value;
+
+        if (result > __DBL_MAX__)
+            return false; // rounded up to infinity
+    }
+
+    *out = x->negative ? -result : result;
+    return true;
+}
+
+bigint_t* std_bigint_from_double(double x) {
+    double_bits_t repr = { .value = x };
+
+    int biased_exponent = (repr.bits >> 52) & 0x7FF;
+    ASSERT(biased_exponent != 0x7FF);
+
+    // The value is `mantissa * 2^exponent`, where the mantissa has 53 significant bits.
+    uint64_t mantissa = (repr.bits & ((1ull << 52) - 1)) | (1ull << 52);
+    int exponent = biased_exponent - 1075;
+
+    if (exponent <= -53)
+        return std_bigint_from_i64(0); // |x| < 1
+
+    bigint_t* result = exponent >= 0
+        ? std_bigint_lshift(std_bigint_from_i64((int64_t)mantissa), (size_t)exponent)
+        : std_bigint_from_i64((int64_t)(mantissa >> -exponent));
+
+    return (repr.bits >> 63) != 0 ? std_bigint_neg(result) : result;
+}
+
+size_t std_bigint_bit_length(const bigint_t* x) {
+    ENSURE_NOT_NULL(x);
+
+    if (x->length == 0)
+        return 0;
+
+    return x->length * LIMB_BITS - __builtin_clzll(x->limbs[x->length - 1]);
+}
+
+// The largest power of 10 that fits in a limb.
+#define DECIMAL_CHUNK 10000000000000000000ull
+#define DECIMAL_CHUNK_DIGITS 19
+
+string_t std_bigint_to_decimal(const bigint_t* x) {
+    ENSURE_NOT_NULL(x);
+
+    if (x->length == 0)
+        return STR("0");
+
+    // Every limb holds at most 20 decimal digits. We write the digits from the end of
+    // the buffer, by repeatedly dividing the magnitude by 10^19.
+    size_t capacity = x->length * 20 + 2; // sign + null terminator
+    char* buffer = mm_heap_alloc(capacity);
+    size_t pos = capacity - 1;
+    buffer[pos] = '\0';
+
+    bigint_limb_t* mag = limbs_alloc(x->length);
+    memcpy(mag, x->limbs, x->length * sizeof(bigint_limb_t));
+    size_t n = x->length;
+
+    while (n != 0) {
+        bigint_limb_t rem = 0;
+        for (size_t i = n; i-- > 0;) {
+            mag[i] = udiv128(rem, mag[i], DECIMAL_CHUNK, &rem);
+        }
+
+        n = mag_normalize(mag, n);
+
+        char* start = std_u64_to_decimal(rem, buffer + pos);
+
+        // All chunks except the most significant one are zero-padded.
+        while (n != 0 && (buffer + pos) - start < DECIMAL_CHUNK_DIGITS) {
+            *--start = '0';
+        }
+
+        pos = (size_t)(start - buffer);
+    }
+
+    if (x->negative) {
+        buffer[--pos] = '-';
+    }
+
+    mm_heap_free(mag);
+    return (string_t) { .str = buffer + pos, .length = (int)(capacity - 1 - pos) };
+}
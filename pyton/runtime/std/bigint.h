@@ -0,0 +1,103 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "string.h"
+
+// Arbitrary-precision integers. These back Python `int` objects whose values do not fit
+// in 64 bits - see `ints.h`. All operations allocate their results on the heap, and
+// never modify their operands.
+
+// A single "digit" of a big integer, in base 2^64.
+typedef uint64_t bigint_limb_t;
+
+// Represents an arbitrary-precision integer as a sign and a magnitude.
+typedef struct bigint {
+    // The magnitude, least significant limb first. The most significant limb is
+    // never zero.
+    const bigint_limb_t* limbs;
+
+    // The number of limbs in `limbs`. Zero is represented with a length of 0.
+    size_t length;
+
+    // `true` if the integer is negative. Zero is never negative.
+    bool negative;
+} bigint_t;
+
+// Operands (in limbs) at or above this size are multiplied via Karatsuba's algorithm
+// instead of the schoolbook method.
+#define BIGINT_KARATSUBA_THRESHOLD 32
+
+// Creates a big integer from a 64-bit one.
+bigint_t* std_bigint_from_i64(int64_t x);
+
+// Returns `true` and sets `out` to the value of `x` if it can be represented as an `int64_t`.
+bool std_bigint_to_i64(const bigint_t* x, int64_t* out);
+
+// Compares two big integers. Returns a negative value if `a < b`, zero if `a == b`,
+// and a positive value if `a > b`.
+int std_bigint_compare(const bigint_t* a, const bigint_t* b);
+
+// Returns `-x`.
+bigint_t* std_bigint_neg(const bigint_t* x);
+
+// Returns `a + b`.
+bigint_t* std_bigint_add(const bigint_t* a, const bigint_t* b);
+
+// Returns `a - b`.
+bigint_t* std_bigint_sub(const bigint_t* a, const bigint_t* b);
+
+// Returns `a * b`.
+bigint_t* std_bigint_mul(const bigint_t* a, const bigint_t* b);
+
+// Divides `a` by `b`, rounding towards negative infinity, as Python's `//` and `%` do.
+// The remainder always has the same sign as `b`. `b` must not be zero. Either of
+// `out_quotient` and `out_remainder` may be `NULL`.
+void std_bigint_divmod(
+    const bigint_t* a,
+    const bigint_t* b,
+    bigint_t** out_quotient,
+    bigint_t** out_remainder
+);
+
+// Returns `base ** exp`, using exponentiation by squaring.
+bigint_t* std_bigint_pow(const bigint_t* base, uint64_t exp);
+
+// Returns `(base ** exp) % mod`, where `exp` is non-negative and `mod` is not zero.
+bigint_t* std_bigint_powmod(const bigint_t* base, const bigint_t* exp, const bigint_t* mod);
+
+// Returns the inverse of `x` modulo `mod`, in the range [0, mod), where `mod` is positive.
+// Returns `NULL` if `x` and `mod` aren't coprime, in which case there is no inverse.
+bigint_t* std_bigint_invmod(const bigint_t* x, const bigint_t* mod);
+
+// Returns `x << shift`.
+bigint_t* std_bigint_lshift(const bigint_t* x, size_t shift);
+
+// Returns `x >> shift`, rounding towards negative infinity.
+bigint_t* std_bigint_rshift(const bigint_t* x, size_t shift);
+
+// Returns `a & b`, treating negative values as infinitely sign-extended two's complement.
+bigint_t* std_bigint_and(const bigint_t* a, const bigint_t* b);
+
+// Returns `a | b`, treating negative values as infinitely sign-extended two's complement.
+bigint_t* std_bigint_or(const bigint_t* a, const bigint_t* b);
+
+// Returns `a ^ b`, treating negative values as infinitely sign-extended two's complement.
+bigint_t* std_bigint_xor(const bigint_t* a, const bigint_t* b);
+
+// Returns `(a * b) % m` for `a, b < m`, without overflowing.
+uint64_t std_mulmod_u64(uint64_t a, uint64_t b, uint64_t m);
+
+// Returns the number of bits needed to represent the magnitude of `x`.
+size_t std_bigint_bit_length(const bigint_t* x);
+
+// Converts `x` to the nearest `double`, rounding half to even. Returns `false` if the
+// magnitude of `x` is too large to be represented as a finite `double`.
+bool std_bigint_to_double(const bigint_t* x, double* out);
+
+// Creates a big integer from a finite `double`, truncating it towards zero.
+bigint_t* std_bigint_from_double(double x);
+
+// Converts the given big integer to its decimal representation.
+string_t std_bigint_to_decimal(const bigint_t* x);
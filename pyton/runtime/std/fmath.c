@@ -0,0 +1,919 @@
+#include "fmath.h"
+
+#include <smmintrin.h>
+#include "../sys/cpu.h"
+
+typedef union double_bits {
+    double value;
+    uint64_t bits;
+} double_bits_t;
+
+static inline uint64_t to_bits(double x) {
+    double_bits_t repr = { .value = x };
+    return repr.bits;
+}
+
+static inline double from_bits(uint64_t bits) {
+    double_bits_t repr = { .bits = bits };
+    return repr.value;
+}
+
+// Returns the upper 32 bits of `x`, which hold its sign, exponent and the top 20 bits of
+// its mantissa. Most thresholds below are expressed in terms of these.
+static inline uint32_t high_word(double x) {
+    return (uint32_t)(to_bits(x) >> 32);
+}
+
+// Returns 2^n, where -1022 <= n <= 1023.
+static inline double pow2i(int n) {
+    return from_bits((uint64_t)(n + 1023) << 52);
+}
+
+// Returns x * 2^n, without overflowing or underflowing in intermediate steps.
+static double scale(double x, int n) {
+    if (n > 1023) {
+        x *= 0x1p1023;
+        n -= 1023;
+
+        if (n > 1023) {
+            x *= 0x1p1023;
+            n = n - 1023 > 1023 ? 1023 : n - 1023;
+        }
+    }
+    else if (n < -1022) {
+        // We scale to just above the subnormal range first, so that the result is only
+        // rounded once.
+        x *= 0x1p-1022 * 0x1p53;
+        n += 1022 - 53;
+
+        if (n < -1022) {
+            x *= 0x1p-1022 * 0x1p53;
+            n = n + 1022 - 53 < -1022 ? -1022 : n + 1022 - 53;
+        }
+    }
+
+    return x * pow2i(n);
+}
+
+// Adding 1.5 * 2^52 to a value of a smaller magnitude rounds it to an integer, as there
+// are no fractional bits left.
+#define TO_INT 6755399441055744.0
+
+// Rounds `x` to the nearest integer, where |x| < 2^51.
+static inline double round_to_int(double x) {
+    return (x + TO_INT) - TO_INT;
+}
+
+// Double-double arithmetic. A value is represented as the unevaluated sum `hi + lo`, where
+// `lo` is at most half an ulp of `hi`, which yields about 106 bits of precision.
+typedef struct dd {
+    double hi;
+    double lo;
+} dd_t;
+
+// Returns `a + b` exactly.
+static inline dd_t two_sum(double a, double b) {
+    double s = a + b;
+    double b_virtual = s - a;
+    return (dd_t) { s, (a - (s - b_virtual)) + (b - b_virtual) };
+}
+
+// Returns `a + b` exactly, where |a| >= |b|.
+static inline dd_t fast_two_sum(double a, double b) {
+    double s = a + b;
+    return (dd_t) { s, b - (s - a) };
+}
+
+// Returns `a * b` exactly, by splitting both factors into halves of 26 bits (Dekker).
+static inline dd_t two_prod(double a, double b) {
+    double p = a * b;
+
+    double ca = 134217729.0 * a;
+    double a_hi = ca - (ca - a);
+    double a_lo = a - a_hi;
+
+    double cb = 134217729.0 * b;
+    double b_hi = cb - (cb - b);
+    double b_lo = b - b_hi;
+
+    return (dd_t) { p, ((a_hi * b_hi - p) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo };
+}
+
+// ----- floor and ceil -----
+
+SSE41 static double floor_sse41(double x) {
+    __m128d v = _mm_set_sd(x);
+    return _mm_cvtsd_f64(_mm_round_sd(v, v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+}
+
+SSE41 static double ceil_sse41(double x) {
+    __m128d v = _mm_set_sd(x);
+    return _mm_cvtsd_f64(_mm_round_sd(v, v, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC));
+}
+
+double std_floor(double x) {
+    if (cpu_get_features()->sse41)
+        return floor_sse41(x);
+
+    // Values of this magnitude have no fractional bits (this also covers infinities and
+    // NaNs), and smaller ones can be truncated by converting them to an integer.
+    if (!(__builtin_fabs(x) < 0x1p52))
+        return x;
+
+    double truncated = (double)(int64_t)x;
+    double result = truncated > x ? truncated - 1.0 : truncated;
+    return result == 0.0 ? __builtin_copysign(0.0, x) : result;
+}
+
+double std_ceil(double x) {
+    if (cpu_get_features()->sse41)
+        return ceil_sse41(x);
+
+    if (!(__builtin_fabs(x) < 0x1p52))
+        return x;
+
+    double truncated = (double)(int64_t)x;
+    double result = truncated < x ? truncated + 1.0 : truncated;
+    return result == 0.0 ? __builtin_copysign(0.0, x) : result;
+}
+
+// ----- fmod -----
+
+// Returns the mantissa of a finite, non-zero `x`, with the implicit bit made explicit, and
+// sets `exponent` so that |x| = mantissa * 2^(exponent - 1075). Subnormals are normalized,
+// which makes their exponent zero or negative.
+static uint64_t unpack_mantissa(uint64_t bits, int* exponent) {
+    int e = (int)((bits >> 52) & 0x7FF);
+    uint64_t mantissa = bits & ((1ull << 52) - 1);
+
+    if (e == 0) {
+        int shift = __builtin_clzll(mantissa) - 11;
+        *exponent = 1 - shift;
+        return mantissa << shift;
+    }
+
+    *exponent = e;
+    return mantissa | (1ull << 52);
+}
+
+double std_fmod(double x, double y) {
+    uint64_t x_bits = to_bits(x);
+    uint64_t y_bits = to_bits(y);
+
+    if (y == 0.0 || __builtin_isnan(y) || !__builtin_isfinite(x))
+        return (x * y) / (x * y);
+
+    // |x| < |y| leaves x as-is, and |x| == |y| divides evenly.
+    if ((x_bits << 1) <= (y_bits << 1))
+        return (x_bits << 1) == (y_bits << 1) ? 0.0 * x : x;
+
+    int x_exponent, y_exponent;
+    uint64_t x_mantissa = unpack_mantissa(x_bits, &x_exponent);
+    uint64_t y_mantissa = unpack_mantissa(y_bits, &y_exponent);
+
+    // Long division, one bit at a time - we only keep the remainder, which never needs
+    // more than 53 bits.
+    for (; x_exponent > y_exponent; x_exponent--) {
+        if (x_mantissa >= y_mantissa) {
+            x_mantissa -= y_mantissa;
+            if (x_mantissa == 0)
+                return 0.0 * x;
+        }
+
+        x_mantissa <<= 1;
+    }
+
+    if (x_mantissa >= y_mantissa) {
+        x_mantissa -= y_mantissa;
+        if (x_mantissa == 0)
+            return 0.0 * x;
+    }
+
+    // Normalize the remainder back into a double, which might now be a subnormal.
+    int shift = __builtin_clzll(x_mantissa) - 11;
+    x_mantissa <<= shift;
+    x_exponent -= shift;
+
+    if (x_exponent > 0) {
+        x_bits = (x_mantissa & ((1ull << 52) - 1)) | ((uint64_t)x_exponent << 52);
+    }
+    else {
+        x_bits = x_mantissa >> (1 - x_exponent);
+    }
+
+    return from_bits(x_bits | (to_bits(x) & (1ull << 63)));
+}
+
+// ----- exp and log -----
+
+// ln(2), split into three parts of 36 bits, so that `k * LN2_A` and `k * LN2_B` are
+// exact for |k| < 2^17.
+static const double LN2_A = 6.931471805582987e-01;
+static const double LN2_B = 1.6465949582866463e-12;
+static const double LN2_C = 3.061840736018652e-24;
+
+// log(j / 128) for 96 <= j <= 192, as double-doubles.
+static const dd_t LOG_TABLE[] = {
+    { -0x1.269621134db92p-2, -0x1.e0efadd9db02bp-56 }, // log(96/128)
+    { -0x1.1bf99635a6b95p-2, 0x1.12aeb84249223p-57 }, // log(97/128)
+    { -0x1.1178e8227e47cp-2, 0x1.0e63a5f01c691p-57 }, // log(98/128)
+    { -0x1.07138604d5862p-2, -0x1.cdb16ed4e9138p-56 }, // log(99/128)
+    { -0x1.f991c6cb3b379p-3, -0x1.f665066f980a2p-57 }, // log(100/128)
+    { -0x1.e530effe71012p-3, -0x1.2276041f43042p-59 }, // log(101/128)
+    { -0x1.d1037f2655e7bp-3, -0x1.60629242471a2p-57 }, // log(102/128)
+    { -0x1.bd087383bd8adp-3, -0x1.dd355f6a516d7p-60 }, // log(103/128)
+    { -0x1.a93ed3c8ad9e3p-3, -0x1.bcafa9de97203p-57 }, // log(104/128)
+    { -0x1.95a5adcf7017fp-3, -0x1.142c507fb7a3dp-58 }, // log(105/128)
+    { -0x1.823c16551a3c2p-3, 0x1.1232ce70be781p-57 }, // log(106/128)
+    { -0x1.6f0128b756abcp-3, 0x1.8de59c21e166cp-57 }, // log(107/128)
+    { -0x1.5bf406b543db2p-3, 0x1.1f5b44c0df7e7p-61 }, // log(108/128)
+    { -0x1.4913d8333b561p-3, 0x1.0d5604930f135p-58 }, // log(109/128)
+    { -0x1.365fcb0159016p-3, -0x1.7d411a5b944adp-58 }, // log(110/128)
+    { -0x1.23d712a49c202p-3, 0x1.6e38161051d69p-57 }, // log(111/128)
+    { -0x1.1178e8227e47cp-3, 0x1.0e63a5f01c691p-58 }, // log(112/128)
+    { -0x1.fe89139dbd566p-4, 0x1.ac9f4215f9393p-58 }, // log(113/128)
+    { -0x1.da727638446a2p-4, -0x1.401fa71733019p-58 }, // log(114/128)
+    { -0x1.b6ac88dad5b1cp-4, 0x1.0057eed1ca59fp-59 }, // log(115/128)
+    { -0x1.9335e5d594989p-4, 0x1.478a85704ccb7p-58 }, // log(116/128)
+    { -0x1.700d30aeac0e1p-4, 0x1.72566212cdd05p-61 }, // log(117/128)
+    { -0x1.4d3115d207eacp-4, -0x1.769f42c7842ccp-58 }, // log(118/128)
+    { -0x1.2aa04a44717a5p-4, 0x1.d15d38d2fa3f7p-58 }, // log(119/128)
+    { -0x1.08598b59e3a07p-4, 0x1.dd7009902bf32p-58 }, // log(120/128)
+    { -0x1.ccb73cdddb2ccp-5, 0x1.e48fb0500efd4p-59 }, // log(121/128)
+    { -0x1.894aa149fb343p-5, -0x1.a8be97660a23dp-60 }, // log(122/128)
+    { -0x1.466aed42de3eap-5, 0x1.cdd6f7f4a137ep-59 }, // log(123/128)
+    { -0x1.0415d89e74444p-5, -0x1.c05cf1d753622p-59 }, // log(124/128)
+    { -0x1.8492528c8cabfp-6, 0x1.d192d0619fa67p-60 }, // log(125/128)
+    { -0x1.0205658935847p-6, -0x1.27c8e8416e71fp-60 }, // log(126/128)
+    { -0x1.010157588de71p-7, -0x1.46662d417ced0p-62 }, // log(127/128)
+    { 0x0.0p+0, 0x0.0p+0 }, // log(128/128)
+    { 0x1.fe02a6b106789p-8, -0x1.e44b7e3711ebfp-67 }, // log(129/128)
+    { 0x1.fc0a8b0fc03e4p-7, -0x1.83092c59642a1p-62 }, // log(130/128)
+    { 0x1.7b91b07d5b11bp-6, -0x1.5b602ace3a510p-60 }, // log(131/128)
+    { 0x1.f829b0e783300p-6, 0x1.33e3f04f1ef23p-60 }, // log(132/128)
+    { 0x1.39e87b9febd60p-5, -0x1.5bfa937f551bbp-59 }, // log(133/128)
+    { 0x1.77458f632dcfcp-5, 0x1.18d3ca87b9296p-59 }, // log(134/128)
+    { 0x1.b42dd711971bfp-5, -0x1.eb9759c130499p-60 }, // log(135/128)
+    { 0x1.f0a30c01162a6p-5, 0x1.85f325c5bbacdp-59 }, // log(136/128)
+    { 0x1.16536eea37ae1p-4, -0x1.79da3e8c22cdap-60 }, // log(137/128)
+    { 0x1.341d7961bd1d1p-4, -0x1.b599f227becbbp-58 }, // log(138/128)
+    { 0x1.51b073f06183fp-4, 0x1.a49e39a1a8be4p-58 }, // log(139/128)
+    { 0x1.6f0d28ae56b4cp-4, -0x1.906d99184b992p-58 }, // log(140/128)
+    { 0x1.8c345d6319b21p-4, -0x1.4a697ab3424a9p-61 }, // log(141/128)
+    { 0x1.a926d3a4ad563p-4, 0x1.942f48aa70ea9p-58 }, // log(142/128)
+    { 0x1.c5e548f5bc743p-4, 0x1.5d617ef8161b1p-60 }, // log(143/128)
+    { 0x1.e27076e2af2e6p-4, -0x1.61578001e0162p-60 }, // log(144/128)
+    { 0x1.fec9131dbeabbp-4, -0x1.5746b9981b36cp-58 }, // log(145/128)
+    { 0x1.0d77e7cd08e59p-3, 0x1.9a5dc5e9030acp-57 }, // log(146/128)
+    { 0x1.1b72ad52f67a0p-3, 0x1.483023472cd74p-58 }, // log(147/128)
+    { 0x1.29552f81ff523p-3, 0x1.301771c407dbfp-57 }, // log(148/128)
+    { 0x1.371fc201e8f74p-3, 0x1.de6cb62af18a0p-58 }, // log(149/128)
+    { 0x1.44d2b6ccb7d1ep-3, 0x1.9f4f6543e1f88p-57 }, // log(150/128)
+    { 0x1.526e5e3a1b438p-3, -0x1.746ff8a470d3ap-57 }, // log(151/128)
+    { 0x1.5ff3070a793d4p-3, -0x1.bc60efafc6f6ep-58 }, // log(152/128)
+    { 0x1.6d60fe719d21dp-3, -0x1.caae268ecd179p-57 }, // log(153/128)
+    { 0x1.7ab890210d909p-3, 0x1.be36b2d6a0608p-59 }, // log(154/128)
+    { 0x1.87fa06520c911p-3, -0x1.bf7fdbfa08d9ap-57 }, // log(155/128)
+    { 0x1.9525a9cf456b4p-3, 0x1.d904c1d4e2e26p-57 }, // log(156/128)
+    { 0x1.a23bc1fe2b563p-3, 0x1.93711b07a998cp-59 }, // log(157/128)
+    { 0x1.af3c94e80bff3p-3, -0x1.398cff3641985p-58 }, // log(158/128)
+    { 0x1.bc286742d8cd6p-3, 0x1.4fce744870f55p-58 }, // log(159/128)
+    { 0x1.c8ff7c79a9a22p-3, -0x1.4f689f8434012p-57 }, // log(160/128)
+    { 0x1.d5c216b4fbb91p-3, 0x1.6e443597e4d40p-57 }, // log(161/128)
+    { 0x1.e27076e2af2e6p-3, -0x1.61578001e0162p-59 }, // log(162/128)
+    { 0x1.ef0adcbdc5936p-3, 0x1.48637950dc20dp-57 }, // log(163/128)
+    { 0x1.fb9186d5e3e2bp-3, -0x1.caaae64f21acbp-57 }, // log(164/128)
+    { 0x1.0402594b4d041p-2, -0x1.28ec217a5022dp-57 }, // log(165/128)
+    { 0x1.0a324e27390e3p-2, 0x1.7dcfde8061c03p-56 }, // log(166/128)
+    { 0x1.1058bf9ae4ad5p-2, 0x1.89fa0ab4cb31dp-58 }, // log(167/128)
+    { 0x1.1675cababa60ep-2, 0x1.ce63eab883717p-61 }, // log(168/128)
+    { 0x1.1c898c16999fbp-2, -0x1.0e5c62aff1c44p-60 }, // log(169/128)
+    { 0x1.22941fbcf7966p-2, -0x1.76f5eb09628afp-56 }, // log(170/128)
+    { 0x1.2895a13de86a3p-2, 0x1.7ad24c13f040ep-56 }, // log(171/128)
+    { 0x1.2e8e2bae11d31p-2, -0x1.8f4cdb95ebdf9p-56 }, // log(172/128)
+    { 0x1.347dd9a987d55p-2, -0x1.4dd4c580919f8p-57 }, // log(173/128)
+    { 0x1.3a64c556945eap-2, -0x1.c68651945f97cp-57 }, // log(174/128)
+    { 0x1.404308686a7e4p-2, -0x1.0bcfb6082ce6dp-56 }, // log(175/128)
+    { 0x1.4618bc21c5ec2p-2, 0x1.f42decdeccf1dp-56 }, // log(176/128)
+    { 0x1.4be5f957778a1p-2, -0x1.259b35b04813dp-57 }, // log(177/128)
+    { 0x1.51aad872df82dp-2, 0x1.3927ac19f55e3p-59 }, // log(178/128)
+    { 0x1.5767717455a6cp-2, 0x1.526adb283660cp-56 }, // log(179/128)
+    { 0x1.5d1bdbf5809cap-2, 0x1.4236383dc7fe1p-56 }, // log(180/128)
+    { 0x1.62c82f2b9c795p-2, 0x1.7b7af915300e5p-57 }, // log(181/128)
+    { 0x1.686c81e9b14afp-2, -0x1.ddea0f7f58e3dp-57 }, // log(182/128)
+    { 0x1.6e08eaa2ba1e4p-2, -0x1.cfb1b39ca3a0fp-56 }, // log(183/128)
+    { 0x1.739d7f6bbd007p-2, -0x1.8c76ceb014b04p-56 }, // log(184/128)
+    { 0x1.792a55fdd47a2p-2, 0x1.f057691fe9ed7p-56 }, // log(185/128)
+    { 0x1.7eaf83b82afc3p-2, 0x1.92ce979ed2950p-56 }, // log(186/128)
+    { 0x1.842d1da1e8b17p-2, 0x1.24ec519784676p-56 }, // log(187/128)
+    { 0x1.89a3386c1425bp-2, -0x1.29639dfbbf0fbp-56 }, // log(188/128)
+    { 0x1.8f11e873662c7p-2, 0x1.f85da755a61a3p-56 }, // log(189/128)
+    { 0x1.947941c2116fbp-2, -0x1.16cc8bae0bbe4p-56 }, // log(190/128)
+    { 0x1.99d958117e08bp-2, -0x1.a2b6889dc3e72p-57 }, // log(191/128)
+    { 0x1.9f323ecbf984cp-2, -0x1.a92e513217f5cp-59 }  // log(192/128)
+};
+
+// Returns log(x) as a double-double, where x is positive and finite.
+static dd_t log_dd(double x) {
+    int k = 0;
+
+    if (x < 0x1p-1022) { // subnormal
+        x *= 0x1p54;
+        k = -54;
+    }
+
+    // We reduce x to 2^k * m, where 0.75 <= m < 1.5, and then m to c + d, where c = j / 128
+    // is the multiple of 1/128 closest to m. log(m) = log(c) + 2 * atanh(u), where
+    // u = d / (m + c), and |u| < 1/384.
+    uint64_t bits = to_bits(x);
+    k += (int)(bits >> 52) - 1023;
+    double m = from_bits((bits & ((1ull << 52) - 1)) | (1023ull << 52));
+
+    if (m >= 1.5) {
+        m *= 0.5;
+        k++;
+    }
+
+    int j = (int)(m * 128.0 + 0.5);
+    double c = j * (1.0 / 128);
+    double d = m - c; // exact, by Sterbenz's lemma
+
+    // u = d / (m + c), in double-double precision.
+    dd_t sum = two_sum(m, c);
+    double u = d / sum.hi;
+    dd_t product = two_prod(u, sum.hi);
+    double u_lo = (((d - product.hi) - product.lo) - u * sum.lo) / sum.hi;
+
+    // 2 * atanh(u) = 2u + 2u^3/3 + 2u^5/5 + 2u^7/7 + ...
+    double u2 = u * u;
+    double series = u * u2 * (2.0 / 3 + u2 * (2.0 / 5 + u2 * (2.0 / 7)));
+
+    dd_t table = LOG_TABLE[j - 96];
+    dd_t high = two_sum(k * LN2_A, table.hi);
+    dd_t mid = two_sum(high.hi, 2.0 * u);
+    double low = high.lo + mid.lo + k * LN2_B + table.lo + (k * LN2_C + 2.0 * u_lo + series);
+
+    return fast_two_sum(mid.hi, low);
+}
+
+// ln(2) / 64, split into three parts of 36 bits.
+static const double LN2_64_A = 1.0830424696223417e-02;
+static const double LN2_64_B = 2.5728046223228848e-14;
+static const double LN2_64_C = 4.784126150029144e-26;
+static const double INV_LN2_64 = 9.2332482616893658e+01;
+
+// 2^(j / 64) for 0 <= j < 64, as double-doubles.
+static const dd_t EXP2_TABLE[] = {
+    { 0x1.0000000000000p+0, 0x0.0p+0 },
+    { 0x1.02c9a3e778061p+0, -0x1.19083535b085dp-56 },
+    { 0x1.059b0d3158574p+0, 0x1.d73e2a475b465p-55 },
+    { 0x1.0874518759bc8p+0, 0x1.186be4bb284ffp-57 },
+    { 0x1.0b5586cf9890fp+0, 0x1.8a62e4adc610bp-54 },
+    { 0x1.0e3ec32d3d1a2p+0, 0x1.03a1727c57b53p-59 },
+    { 0x1.11301d0125b51p+0, -0x1.6c51039449b3ap-54 },
+    { 0x1.1429aaea92de0p+0, -0x1.32fbf9af1369ep-54 },
+    { 0x1.172b83c7d517bp+0, -0x1.19041b9d78a76p-55 },
+    { 0x1.1a35beb6fcb75p+0, 0x1.e5b4c7b4968e4p-55 },
+    { 0x1.1d4873168b9aap+0, 0x1.e016e00a2643cp-54 },
+    { 0x1.2063b88628cd6p+0, 0x1.dc775814a8495p-55 },
+    { 0x1.2387a6e756238p+0, 0x1.9b07eb6c70573p-54 },
+    { 0x1.26b4565e27cddp+0, 0x1.2bd339940e9d9p-55 },
+    { 0x1.29e9df51fdee1p+0, 0x1.612e8afad1255p-55 },
+    { 0x1.2d285a6e4030bp+0, 0x1.0024754db41d5p-54 },
+    { 0x1.306fe0a31b715p+0, 0x1.6f46ad23182e4p-55 },
+    { 0x1.33c08b26416ffp+0, 0x1.32721843659a6p-54 },
+    { 0x1.371a7373aa9cbp+0, -0x1.63aeabf42eae2p-54 },
+    { 0x1.3a7db34e59ff7p+0, -0x1.5e436d661f5e3p-56 },
+    { 0x1.3dea64c123422p+0, 0x1.ada0911f09ebcp-55 },
+    { 0x1.4160a21f72e2ap+0, -0x1.ef3691c309278p-58 },
+    { 0x1.44e086061892dp+0, 0x1.89b7a04ef80d0p-59 },
+    { 0x1.486a2b5c13cd0p+0, 0x1.3c1a3b69062f0p-56 },
+    { 0x1.4bfdad5362a27p+0, 0x1.d4397afec42e2p-56 },
+    { 0x1.4f9b2769d2ca7p+0, -0x1.4b309d25957e3p-54 },
+    { 0x1.5342b569d4f82p+0, -0x1.07abe1db13cadp-55 },
+    { 0x1.56f4736b527dap+0, 0x1.9bb2c011d93adp-54 },
+    { 0x1.5ab07dd485429p+0, 0x1.6324c054647adp-54 },
+    { 0x1.5e76f15ad2148p+0, 0x1.ba6f93080e65ep-54 },
+    { 0x1.6247eb03a5585p+0, -0x1.383c17e40b497p-54 },
+    { 0x1.6623882552225p+0, -0x1.bb60987591c34p-54 },
+    { 0x1.6a09e667f3bcdp+0, -0x1.bdd3413b26456p-54 },
+    { 0x1.6dfb23c651a2fp+0, -0x1.bbe3a683c88abp-57 },
+    { 0x1.71f75e8ec5f74p+0, -0x1.16e4786887a99p-55 },
+    { 0x1.75feb564267c9p+0, -0x1.0245957316dd3p-54 },
+    { 0x1.7a11473eb0187p+0, -0x1.41577ee04992fp-55 },
+    { 0x1.7e2f336cf4e62p+0, 0x1.05d02ba15797ep-56 },
+    { 0x1.82589994cce13p+0, -0x1.d4c1dd41532d8p-54 },
+    { 0x1.868d99b4492edp+0, -0x1.fc6f89bd4f6bap-54 },
+    { 0x1.8ace5422aa0dbp+0, 0x1.6e9f156864b27p-54 },
+    { 0x1.8f1ae99157736p+0, 0x1.5cc13a2e3976cp-55 },
+    { 0x1.93737b0cdc5e5p+0, -0x1.75fc781b57ebcp-57 },
+    { 0x1.97d829fde4e50p+0, -0x1.d185b7c1b85d1p-54 },
+    { 0x1.9c49182a3f090p+0, 0x1.c7c46b071f2bep-56 },
+    { 0x1.a0c667b5de565p+0, -0x1.359495d1cd533p-54 },
+    { 0x1.a5503b23e255dp+0, -0x1.d2f6edb8d41e1p-54 },
+    { 0x1.a9e6b5579fdbfp+0, 0x1.0fac90ef7fd31p-54 },
+    { 0x1.ae89f995ad3adp+0, 0x1.7a1cd345dcc81p-54 },
+    { 0x1.b33a2b84f15fbp+0, -0x1.2805e3084d708p-57 },
+    { 0x1.b7f76f2fb5e47p+0, -0x1.5584f7e54ac3bp-56 },
+    { 0x1.bcc1e904bc1d2p+0, 0x1.23dd07a2d9e84p-55 },
+    { 0x1.c199bdd85529cp+0, 0x1.11065895048ddp-55 },
+    { 0x1.c67f12e57d14bp+0, 0x1.2884dff483cadp-54 },
+    { 0x1.cb720dcef9069p+0, 0x1.503cbd1e949dbp-56 },
+    { 0x1.d072d4a07897cp+0, -0x1.cbc3743797a9cp-54 },
+    { 0x1.d5818dcfba487p+0, 0x1.2ed02d75b3707p-55 },
+    { 0x1.da9e603db3285p+0, 0x1.c2300696db532p-54 },
+    { 0x1.dfc97337b9b5fp+0, -0x1.1a5cd4f184b5cp-54 },
+    { 0x1.e502ee78b3ff6p+0, 0x1.39e8980a9cc8fp-55 },
+    { 0x1.ea4afa2a490dap+0, -0x1.e9c23179c2893p-54 },
+    { 0x1.efa1bee615a27p+0, 0x1.dc7f486a4b6b0p-54 },
+    { 0x1.f50765b6e4540p+0, 0x1.9d3e12dd8a18bp-54 },
+    { 0x1.fa7c1819e90d8p+0, 0x1.74853f3a5931ep-55 }
+};
+
+// Returns exp(hi + lo), where hi + lo is a double-double.
+static double exp_dd(double hi, double lo) {
+    if (hi > 710.0)
+        return __builtin_inf();
+
+    if (hi < -746.0)
+        return 0.0;
+
+    // We reduce the argument to r = hi + lo - k * ln(2)/64, where |r| <= ln(2)/128, so that
+    // exp(hi + lo) = 2^(k / 64) * exp(r).
+    double kd = round_to_int(hi * INV_LN2_64);
+    int k = (int)kd;
+
+    dd_t r = two_sum(hi - kd * LN2_64_A, -(kd * LN2_64_B));
+    double r_lo = r.lo + (lo - kd * LN2_64_C);
+
+    // exp(r) - 1 = r + r^2/2 + r^3/6 + ..., where the first two terms are summed exactly.
+    dd_t square = two_prod(r.hi, r.hi);
+    dd_t head = two_sum(r.hi, 0.5 * square.hi);
+    double tail = head.lo + r_lo + 0.5 * square.lo + r.hi * r_lo +
+        square.hi * r.hi * (1.0 / 6 + r.hi * (1.0 / 24 + r.hi * (1.0 / 120 + r.hi * (1.0 / 720 + r.hi * (1.0 / 5040)))));
+
+    // 2^(j / 64) * (1 + head + tail)
+    dd_t t = EXP2_TABLE[k & 63];
+    dd_t scaled_head = two_prod(t.hi, head.hi);
+    dd_t result = two_sum(t.hi, scaled_head.hi);
+    double result_lo = result.lo + scaled_head.lo + t.hi * tail + t.lo + t.lo * head.hi;
+
+    return scale(result.hi + result_lo, k >> 6);
+}
+
+double std_exp(double x) {
+    if (__builtin_isnan(x))
+        return x;
+
+    return exp_dd(x, 0.0);
+}
+
+double std_log(double x) {
+    if (__builtin_isnan(x) || x == __builtin_inf())
+        return x;
+
+    if (x == 0.0)
+        return -__builtin_inf();
+
+    if (x < 0.0)
+        return __builtin_nan("");
+
+    return log_dd(x).hi;
+}
+
+// ----- sin and cos -----
+
+// The coefficients of the minimax approximations of sin(x) and cos(x) over [-pi/4, pi/4].
+static const double SIN_S1 = -1.66666666666666324348e-01;
+static const double SIN_S2 =  8.33333333332248946124e-03;
+static const double SIN_S3 = -1.98412698298579493134e-04;
+static const double SIN_S4 =  2.75573137070700676789e-06;
+static const double SIN_S5 = -2.50507602534068634195e-08;
+static const double SIN_S6 =  1.58969099521155010221e-10;
+
+static const double COS_C1 =  4.16666666666666019037e-02;
+static const double COS_C2 = -1.38888888888741095749e-03;
+static const double COS_C3 =  2.48015872894767294178e-05;
+static const double COS_C4 = -2.75573143513906633035e-07;
+static const double COS_C5 =  2.08757232129817482790e-09;
+static const double COS_C6 = -1.13596475577881948265e-11;
+
+// Returns sin(x + y), where |x| <= pi/4 and y is the tail of x. `y` is ignored if `has_tail`
+// is `false`.
+static double kernel_sin(double x, double y, bool has_tail) {
+    double z = x * x;
+    double w = z * z;
+    double r = SIN_S2 + z * (SIN_S3 + z * SIN_S4) + z * w * (SIN_S5 + z * SIN_S6);
+    double v = z * x;
+
+    if (!has_tail)
+        return x + v * (SIN_S1 + z * r);
+
+    return x - ((z * (0.5 * y - v * r) - y) - v * SIN_S1);
+}
+
+// Returns cos(x + y), where |x| <= pi/4 and y is the tail of x.
+static double kernel_cos(double x, double y) {
+    double z = x * x;
+    double w = z * z;
+    double r = z * (COS_C1 + z * (COS_C2 + z * COS_C3)) + w * w * (COS_C4 + z * (COS_C5 + z * COS_C6));
+    double hz = 0.5 * z;
+    w = 1.0 - hz;
+
+    return w + (((1.0 - w) - hz) + (z * r - x * y));
+}
+
+static const double INV_PIO2 = 6.36619772367581382433e-01;
+
+// pi/2, split into three parts of 33 bits each (PIO2_n), with the remainder after each
+// part (PIO2_nT). `n * PIO2_n` is exact for |n| < 2^20.
+static const double PIO2_1  = 1.57079632673412561417e+00;
+static const double PIO2_1T = 6.07710050650619224932e-11;
+static const double PIO2_2  = 6.07710050630396597660e-11;
+static const double PIO2_2T = 2.02226624879595063154e-21;
+static const double PIO2_3  = 2.02226624871116645580e-21;
+static const double PIO2_3T = 8.47842766036889956997e-32;
+
+// pi/2 as a double-double.
+static const double PIO2_HI = 1.5707963267948966e+00;
+static const double PIO2_LO = 6.123233995736766e-17;
+
+// The first 1216 fractional bits of 2/pi, most significant first.
+#define TWO_OVER_PI_BITS 1216
+static const uint64_t TWO_OVER_PI[TWO_OVER_PI_BITS / 64] = {
+    0xA2F9836E4E441529ull, 0xFC2757D1F534DDC0ull, 0xDB6295993C439041ull, 0xFE5163ABDEBBC561ull,
+    0xB7246E3A424DD2E0ull, 0x06492EEA09D1921Cull, 0xFE1DEB1CB129A73Eull, 0xE88235F52EBB4484ull,
+    0xE99C7026B45F7E41ull, 0x3991D639835339F4ull, 0x9C845F8BBDF9283Bull, 0x1FF897FFDE05980Full,
+    0xEF2F118B5A0A6D1Full, 0x6D367ECF27CB09B7ull, 0x4F463F669E5FEA2Dull, 0x7527BAC7EBE5F17Bull,
+    0x3D0739F78A5292EAull, 0x6BFB5FB11F8D5D08ull, 0x56033046FC7B6BABull
+};
+
+// Returns bits `index` to `index + 63` of floor(2/pi * 2^TWO_OVER_PI_BITS), where bit `n`
+// has the value 2^n. Bits outside of the table are zero.
+static uint64_t two_over_pi_window(int index) {
+    int word = index >> 6;
+    int shift = index & 63;
+
+    #define WORD($n) \
+        (($n) >= 0 && ($n) < TWO_OVER_PI_BITS / 64 ? TWO_OVER_PI[TWO_OVER_PI_BITS / 64 - 1 - ($n)] : 0)
+
+    uint64_t result = WORD(word) >> shift;
+    if (shift != 0) {
+        result |= WORD(word + 1) << (64 - shift);
+    }
+
+    #undef WORD
+    return result;
+}
+
+// Reduces a huge |x| (at least 2^20 * pi/2) to y[0] + y[1] = x - n * pi/2, and returns n.
+// We multiply the mantissa of x by the bits of 2/pi which determine the product modulo 4,
+// as the terms that involve the more significant bits are all multiples of 4 (Payne-Hanek).
+static int rem_pio2_large(double x, double* y) {
+    uint64_t bits = to_bits(x);
+    int exponent = (int)((bits >> 52) & 0x7FF) - 1075;
+    uint64_t mantissa = (bits & ((1ull << 52) - 1)) | (1ull << 52);
+
+    // x * 2/pi = mantissa * 2^exponent * F * 2^-TWO_OVER_PI_BITS. The bits of F at and above
+    // `TWO_OVER_PI_BITS + 2 - exponent` only contribute multiples of 4, and we take the
+    // 192 bits below that, so that the product holds 2 integral and 190 fractional bits.
+    int window = TWO_OVER_PI_BITS + 2 - exponent - 192;
+    uint64_t g0 = two_over_pi_window(window);
+    uint64_t g1 = two_over_pi_window(window + 64);
+    uint64_t g2 = two_over_pi_window(window + 128);
+
+    unsigned __int128 p0 = (unsigned __int128)mantissa * g0;
+    unsigned __int128 p1 = (unsigned __int128)mantissa * g1 + (uint64_t)(p0 >> 64);
+    uint64_t q2 = mantissa * g2 + (uint64_t)(p1 >> 64);
+    uint64_t q1 = (uint64_t)p1;
+    uint64_t q0 = (uint64_t)p0;
+
+    int n = (int)(q2 >> 62);
+    unsigned __int128 fraction =
+        ((unsigned __int128)((q2 << 2) | (q1 >> 62)) << 64) | ((q1 << 2) | (q0 >> 62));
+
+    // We want the remainder closest to zero - so for fractions of at least one half, we
+    // round n up, and negate the remainder.
+    bool negate = (fraction >> 127) != 0;
+    if (negate) {
+        n++;
+        fraction = -fraction;
+    }
+
+    if (fraction == 0) {
+        y[0] = y[1] = 0.0;
+    }
+    else {
+        uint64_t top = (uint64_t)(fraction >> 64);
+        int leading = top != 0 ? __builtin_clzll(top) : 64 + __builtin_clzll((uint64_t)fraction);
+        fraction <<= leading;
+
+        double f_hi = (double)(uint64_t)(fraction >> 75) * pow2i(-53 - leading);
+        double f_lo = (double)(uint64_t)((fraction & (((unsigned __int128)1 << 75) - 1)) >> 11) * pow2i(-117 - leading);
+
+        // r = f * pi/2, in double-double precision.
+        dd_t p = two_prod(f_hi, PIO2_HI);
+        double tail = p.lo + (f_hi * PIO2_LO + f_lo * PIO2_HI);
+        y[0] = p.hi + tail;
+        y[1] = tail - (y[0] - p.hi);
+    }
+
+    if (negate != (x < 0)) {
+        y[0] = -y[0];
+        y[1] = -y[1];
+    }
+
+    return x < 0 ? -n : n;
+}
+
+// Reduces x to y[0] + y[1] = x - n * pi/2, where |y[0] + y[1]| <= pi/4, and returns n.
+static int rem_pio2(double x, double* y) {
+    uint32_t ix = high_word(x) & 0x7FFFFFFF;
+
+    if (ix >= 0x413921FB) // |x| >= 2^20 * pi/2
+        return rem_pio2_large(x, y);
+
+    // Cody-Waite reduction, with as many parts of pi/2 as there are cancelled bits.
+    double fn = round_to_int(x * INV_PIO2);
+    int n = (int)fn;
+    double r = x - fn * PIO2_1;
+    double w = fn * PIO2_1T;
+    y[0] = r - w;
+
+    int ex = (int)(ix >> 20);
+    int ey = (int)((high_word(y[0]) >> 20) & 0x7FF);
+
+    if (ex - ey > 16) {
+        double t = r;
+        w = fn * PIO2_2;
+        r = t - w;
+        w = fn * PIO2_2T - ((t - r) - w);
+        y[0] = r - w;
+
+        ey = (int)((high_word(y[0]) >> 20) & 0x7FF);
+        if (ex - ey > 49) {
+            t = r;
+            w = fn * PIO2_3;
+            r = t - w;
+            w = fn * PIO2_3T - ((t - r) - w);
+            y[0] = r - w;
+        }
+    }
+
+    y[1] = (r - y[0]) - w;
+    return n;
+}
+
+double std_sin(double x) {
+    uint32_t ix = high_word(x) & 0x7FFFFFFF;
+
+    if (ix <= 0x3FE921FB) { // |x| <= pi/4
+        if (ix < 0x3E500000) // |x| < 2^-26
+            return x;
+
+        return kernel_sin(x, 0.0, false);
+    }
+
+    if (ix >= 0x7FF00000)
+        return x - x; // inf or NaN
+
+    double y[2];
+    switch (rem_pio2(x, y) & 3) {
+        case 0:  return  kernel_sin(y[0], y[1], true);
+        case 1:  return  kernel_cos(y[0], y[1]);
+        case 2:  return -kernel_sin(y[0], y[1], true);
+        default: return -kernel_cos(y[0], y[1]);
+    }
+}
+
+double std_cos(double x) {
+    uint32_t ix = high_word(x) & 0x7FFFFFFF;
+
+    if (ix <= 0x3FE921FB) { // |x| <= pi/4
+        if (ix < 0x3E46A09E) // |x| < 2^-27 * sqrt(2)
+            return 1.0;
+
+        return kernel_cos(x, 0.0);
+    }
+
+    if (ix >= 0x7FF00000)
+        return x - x; // inf or NaN
+
+    double y[2];
+    switch (rem_pio2(x, y) & 3) {
+        case 0:  return  kernel_cos(y[0], y[1]);
+        case 1:  return -kernel_sin(y[0], y[1], true);
+        case 2:  return -kernel_cos(y[0], y[1]);
+        default: return  kernel_sin(y[0], y[1], true);
+    }
+}
+
+// ----- atan2 -----
+
+// atan(0.5), atan(1), atan(1.5) and atan(inf), as double-doubles.
+static const double ATAN_HI[] = {
+    4.63647609000806093515e-01, 7.85398163397448278999e-01,
+    9.82793723247329054082e-01, 1.57079632679489655800e+00
+};
+
+static const double ATAN_LO[] = {
+    2.26987774529616870924e-17, 3.06161699786838301793e-17,
+    1.39033110312309984516e-17, 6.12323399573676603587e-17
+};
+
+// The coefficients of the minimax approximation of atan(x) over [-7/16, 7/16].
+static const double ATAN_T[] = {
+     3.33333333333329318027e-01, -1.99999999998764832476e-01,
+     1.42857142725034663711e-01, -1.11111104054623557880e-01,
+     9.09088713343650656196e-02, -7.69187620504482999495e-02,
+     6.66107313738753120669e-02, -5.83357013379057348645e-02,
+     4.97687799461593236017e-02, -3.65315727442169155270e-02,
+     1.62858201153657823623e-02
+};
+
+static double kernel_atan(double x) {
+    uint32_t hx = high_word(x);
+    uint32_t ix = hx & 0x7FFFFFFF;
+    int id;
+
+    if (ix >= 0x44100000) { // |x| >= 2^66
+        if (__builtin_isnan(x))
+            return x;
+
+        double z = ATAN_HI[3] + ATAN_LO[3];
+        return (hx >> 31) != 0 ? -z : z;
+    }
+
+    // We reduce x to [-7/16, 7/16] with atan(x) = atan(c) + atan((x - c) / (1 + x * c)),
+    // for c = 0.5, 1, 1.5 or infinity.
+    if (ix < 0x3FDC0000) { // |x| < 7/16
+        if (ix < 0x3E400000) // |x| < 2^-27
+            return x;
+
+        id = -1;
+    }
+    else {
+        x = __builtin_fabs(x);
+
+        if (ix < 0x3FF30000) { // |x| < 19/16
+            if (ix < 0x3FE60000) { // |x| < 11/16
+                id = 0;
+                x = (2.0 * x - 1.0) / (2.0 + x);
+            }
+            else {
+                id = 1;
+                x = (x - 1.0) / (x + 1.0);
+            }
+        }
+        else {
+            if (ix < 0x40038000) { // |x| < 39/16
+                id = 2;
+                x = (x - 1.5) / (1.0 + 1.5 * x);
+            }
+            else {
+                id = 3;
+                x = -1.0 / x;
+            }
+        }
+    }
+
+    double z = x * x;
+    double w = z * z;
+    double s1 = z * (ATAN_T[0] + w * (ATAN_T[2] + w * (ATAN_T[4] + w * (ATAN_T[6] + w * (ATAN_T[8] + w * ATAN_T[10])))));
+    double s2 = w * (ATAN_T[1] + w * (ATAN_T[3] + w * (ATAN_T[5] + w * (ATAN_T[7] + w * ATAN_T[9]))));
+
+    if (id < 0)
+        return x - x * (s1 + s2);
+
+    z = ATAN_HI[id] - ((x * (s1 + s2) - ATAN_LO[id]) - x);
+    return (hx >> 31) != 0 ? -z : z;
+}
+
+static const double PI    = 3.1415926535897931160e+00;
+static const double PI_LO = 1.2246467991473531772e-16;
+
+double std_atan2(double y, double x) {
+    if (__builtin_isnan(x) || __builtin_isnan(y))
+        return x + y;
+
+    if (x == 1.0)
+        return kernel_atan(y);
+
+    // Bit 0 is the sign of y, and bit 1 the sign of x.
+    int m = (__builtin_signbit(y) ? 1 : 0) | (__builtin_signbit(x) ? 2 : 0);
+
+    if (y == 0.0) {
+        switch (m) {
+            case 0:
+            case 1:  return y;   // atan(+-0, +anything) = +-0
+            case 2:  return PI;  // atan(+0, -anything) = pi
+            default: return -PI; // atan(-0, -anything) = -pi
+        }
+    }
+
+    if (x == 0.0)
+        return m & 1 ? -PI / 2 : PI / 2;
+
+    if (__builtin_isinf(x)) {
+        if (__builtin_isinf(y)) {
+            switch (m) {
+                case 0:  return PI / 4;
+                case 1:  return -PI / 4;
+                case 2:  return 3 * PI / 4;
+                default: return -3 * PI / 4;
+            }
+        }
+
+        switch (m) {
+            case 0:  return 0.0;
+            case 1:  return -0.0;
+            case 2:  return PI;
+            default: return -PI;
+        }
+    }
+
+    if (__builtin_isinf(y))
+        return m & 1 ? -PI / 2 : PI / 2;
+
+    // The quotient may over- or underflow, in which case we know the result anyway.
+    int exponent_difference = (int)((high_word(y) >> 20) & 0x7FF) - (int)((high_word(x) >> 20) & 0x7FF);
+    double z;
+
+    if (exponent_difference > 60) { // |y / x| > 2^60
+        z = PI / 2 + 0.5 * PI_LO;
+        m &= 1;
+    }
+    else if ((m & 2) != 0 && exponent_difference < -60) { // |y / x| < 2^-60, x < 0
+        z = 0.0;
+    }
+    else {
+        z = kernel_atan(__builtin_fabs(y / x));
+    }
+
+    switch (m) {
+        case 0:  return z;
+        case 1:  return -z;
+        case 2:  return PI - (z - PI_LO);
+        default: return (z - PI_LO) - PI;
+    }
+}
+
+// ----- pow -----
+
+// Returns `true` if the finite value y is an odd integer.
+static bool is_odd_integer(double y) {
+    // Every double at or above 2^53 is even.
+    return __builtin_fabs(y) < 0x1p53 && (double)(int64_t)y == y && ((int64_t)y & 1) != 0;
+}
+
+double std_pow(double x, double y) {
+    if (y == 0.0 || x == 1.0)
+        return 1.0;
+
+    if (__builtin_isnan(x) || __builtin_isnan(y))
+        return x + y;
+
+    if (__builtin_isinf(y)) {
+        double ax = __builtin_fabs(x);
+
+        if (ax == 1.0)
+            return 1.0;
+
+        return (ax > 1.0) == (y > 0) ? __builtin_inf() : 0.0;
+    }
+
+    bool odd = is_odd_integer(y);
+
+    if (__builtin_isinf(x) || x == 0.0) {
+        // inf^y and 0^y are 0 or infinity, and negative for odd integers y if x is.
+        bool large = __builtin_isinf(x) == (y > 0);
+        double result = large ? __builtin_inf() : 0.0;
+        return odd && __builtin_signbit(x) ? -result : result;
+    }
+
+    bool negate = false;
+    if (x < 0) {
+        if (std_floor(y) != y)
+            return __builtin_nan(""); // a negative number to a non-integral power
+
+        negate = odd;
+        x = -x;
+
+        if (x == 1.0)
+            return negate ? -1.0 : 1.0;
+    }
+
+    // For |y| >= 2^64, |y * log(x)| is at least 2^64 * 2^-53, as x isn't 1 - so the result
+    // over- or underflows. Such large values would also overflow when split.
+    if (__builtin_fabs(y) >= 0x1p64)
+        return (x > 1.0) == (y > 0) ? __builtin_inf() : 0.0;
+
+    // x^y = exp(y * log(x)), where both are computed with about 70 bits of precision, so
+    // that rounding the result once gives the correctly rounded power nearly always.
+    dd_t log_x = log_dd(x);
+    dd_t product = two_prod(y, log_x.hi);
+    dd_t exponent = fast_two_sum(product.hi, product.lo + y * log_x.lo);
+
+    double result = exp_dd(exponent.hi, exponent.lo);
+    return negate ? -result : result;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Floating-point math kernels. The runtime doesn't link against a C library, so these take
+// the place of `libm`. Square roots are computed by the `sqrtsd` instruction, and `floor`
+// and `ceil` use `roundsd` when SSE4.1 is available. The trigonometric functions use the
+// classic fdlibm argument reductions and minimax polynomials, which are accurate to less
+// than one unit in the last place. `exp`, `log` and `pow` are evaluated in double-double
+// precision with small tables, so that they're correctly rounded in all but rare cases.
+//
+// None of the kernels raise errors - special values are handled like C99 (Annex F) does,
+// and it's up to the callers to turn e.g. `log(-1)` into an exception.
+
+// Returns the square root of `x`, correctly rounded.
+static inline double std_sqrt(double x) {
+    // This header is also included by the kernel, which is compiled with `-nostdinc` and
+    // without `-masm=intel` - so, no intrinsics, and the template is given in both dialects.
+    double result;
+    __asm__ ("sqrtsd {%1, %0|%0, %1}" : "=x"(result) : "x"(x));
+    return result;
+}
+
+// Returns the absolute value of `x`.
+static inline double std_fabs(double x) {
+    return __builtin_fabs(x);
+}
+
+// Returns the largest integral value that is not greater than `x`.
+double std_floor(double x);
+
+// Returns the smallest integral value that is not less than `x`.
+double std_ceil(double x);
+
+// Returns the remainder of `x / y`, which has the sign of `x` - like C's `fmod`, and
+// unlike Python's `%`. The result is always exact.
+double std_fmod(double x, double y);
+
+// Returns `e` raised to the power of `x`.
+double std_exp(double x);
+
+// Returns the natural logarithm of `x`.
+double std_log(double x);
+
+// Returns the sine of `x`, measured in radians.
+double std_sin(double x);
+
+// Returns the cosine of `x`, measured in radians.
+double std_cos(double x);
+
+// Returns the arc tangent of `y / x`, in the range [-pi, pi], using the signs of both
+// arguments to determine the quadrant.
+double std_atan2(double y, double x);
+
+// Returns `x` raised to the power of `y`.
+double std_pow(double x, double y);
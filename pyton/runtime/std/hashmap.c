@@ -0,0 +1,279 @@
+#include "hashmap.h"
+
+#include <emmintrin.h>
+#include "util.h"
+#include "memory.h"
+#include "safety.h"
+#include "../sys/mm.h"
+
+// Control byte values. Full slots hold a value in the range of 0..127 instead.
+#define CONTROL_EMPTY   ((int8_t)-128)
+#define CONTROL_DELETED ((int8_t)-2)
+
+// The table is rebuilt once 7/8 of the slots are used.
+#define MAX_LOAD($capacity) (($capacity) - ($capacity) / 8)
+
+// Spreads the bits of a hash across the whole word. Callers might give us hashes that
+// only use their lower bits (e.g. Python `int`s hash to themselves), while we take
+// the slot position from the lower bits, and the control byte from the upper ones.
+static inline uint64_t mix(uint64_t hash) {
+    uint64_t h = hash * 0x9e3779b97f4a7c15ull;
+    return h ^ (h >> 32);
+}
+
+// Returns the 7 bits of a mixed hash that are stored in the control byte of its slot.
+static inline int8_t h2(uint64_t mixed) {
+    return (int8_t)(mixed >> 57);
+}
+
+// Returns a bit mask of the slots in the group starting at `control` whose control
+// byte is equal to `value`.
+static inline uint32_t group_match(const int8_t* control, int8_t value) {
+    __m128i group = _mm_loadu_si128((const __m128i*)control);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(value)));
+}
+
+// Returns a bit mask of the slots in the group starting at `control` that are either
+// empty or deleted. These are exactly the control bytes that have their sign bit set.
+static inline uint32_t group_match_empty_or_deleted(const int8_t* control) {
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)control));
+}
+
+// Sets the control byte of the given slot, including its copy past the end of the table.
+static inline void set_control(hashmap_t* map, size_t slot, int8_t value) {
+    map->control[slot] = value;
+
+    if (slot < HASHMAP_GROUP_WIDTH) {
+        map->control[map->capacity + slot] = value;
+    }
+}
+
+// Returns the first slot in the probe sequence of `mixed` that is either empty or deleted.
+// The table must have at least one such slot.
+static size_t find_free_slot(const hashmap_t* map, uint64_t mixed) {
+    size_t mask = map->capacity - 1;
+    size_t position = mixed & mask;
+
+    // We probe group-by-group, with the stride increasing by a group each time. As the
+    // capacity is a power of two, this visits every group exactly once.
+    for (size_t stride = HASHMAP_GROUP_WIDTH; ; stride += HASHMAP_GROUP_WIDTH) {
+        uint32_t candidates = group_match_empty_or_deleted(&map->control[position]);
+        if (candidates != 0)
+            return (position + __builtin_ctz(candidates)) & mask;
+
+        position = (position + stride) & mask;
+    }
+}
+
+// Returns the slot that refers to the entry with the given key, or `-1` if there is none.
+static ptrdiff_t find_slot(
+    const hashmap_t* map,
+    uint64_t hash,
+    const void* key,
+    hashmap_equals_t equals,
+    const void* context
+) {
+    if (map->length == 0)
+        return -1;
+
+    uint64_t mixed = mix(hash);
+    int8_t tag = h2(mixed);
+    size_t mask = map->capacity - 1;
+    size_t position = mixed & mask;
+
+    for (size_t stride = HASHMAP_GROUP_WIDTH; ; stride += HASHMAP_GROUP_WIDTH) {
+        const int8_t* group = &map->control[position];
+
+        uint32_t candidates = group_match(group, tag);
+        while (candidates != 0) {
+            size_t slot = (position + __builtin_ctz(candidates)) & mask;
+            candidates &= candidates - 1;
+
+            const hashmap_entry_t* entry = &map->entries.elements[map->slots[slot]];
+            if (entry->hash == hash && (entry->key == key || equals(entry->key, key, context)))
+                return (ptrdiff_t)slot;
+        }
+
+        // An empty slot means that the key was never inserted past this point - if it was,
+        // it would've taken that slot.
+        if (group_match(group, CONTROL_EMPTY) != 0)
+            return -1;
+
+        position = (position + stride) & mask;
+    }
+}
+
+// Rebuilds the table with the given number of slots, dropping removed entries.
+static void rebuild(hashmap_t* map, size_t capacity) {
+    ASSERT(capacity >= HASHMAP_GROUP_WIDTH && (capacity & (capacity - 1)) == 0);
+    ASSERT(MAX_LOAD(capacity) >= map->length);
+
+    // Compact the entries first, so that the slots can refer to their final positions.
+    if (map->entries.length != map->length) {
+        size_t kept = 0;
+        for (size_t i = 0; i < map->entries.length; i++) {
+            if (map->entries.elements[i].key != NULL) {
+                map->entries.elements[kept++] = map->entries.elements[i];
+            }
+        }
+
+        ASSERT(kept == map->length);
+        map->entries.length = kept;
+    }
+
+    if (capacity != map->capacity) {
+        if (map->control != NULL) {
+            mm_heap_free(map->control);
+            mm_heap_free(map->slots);
+        }
+
+        map->control = mm_heap_alloc(capacity + HASHMAP_GROUP_WIDTH);
+        map->slots = mm_heap_alloc(capacity * sizeof(uint32_t));
+        map->capacity = capacity;
+    }
+
+    memset(map->control, (uint8_t)CONTROL_EMPTY, capacity + HASHMAP_GROUP_WIDTH);
+
+    for (size_t i = 0; i < map->entries.length; i++) {
+        uint64_t mixed = mix(map->entries.elements[i].hash);
+        size_t slot = find_free_slot(map, mixed);
+
+        set_control(map, slot, h2(mixed));
+        map->slots[slot] = (uint32_t)i;
+    }
+
+    map->growth_left = MAX_LOAD(capacity) - map->length;
+}
+
+void std_hashmap_reserve(hashmap_t* map, size_t count) {
+    ENSURE_NOT_NULL(map);
+
+    std_vector_reserve(&map->entries, count);
+
+    if (count <= map->length + map->growth_left)
+        return;
+
+    size_t capacity = MAX(map->capacity, HASHMAP_GROUP_WIDTH);
+    while (MAX_LOAD(capacity) < count) {
+        capacity *= 2;
+    }
+
+    rebuild(map, capacity);
+}
+
+hashmap_entry_t* std_hashmap_find(
+    const hashmap_t* map,
+    uint64_t hash,
+    const void* key,
+    hashmap_equals_t equals,
+    const void* context
+) {
+    ENSURE_NOT_NULL(map);
+    ENSURE_NOT_NULL(key);
+
+    ptrdiff_t slot = find_slot(map, hash, key, equals, context);
+    return slot < 0 ? NULL : &map->entries.elements[map->slots[slot]];
+}
+
+hashmap_entry_t* std_hashmap_insert(
+    hashmap_t* map,
+    uint64_t hash,
+    const void* key,
+    hashmap_equals_t equals,
+    const void* context,
+    bool* out_inserted
+) {
+    ENSURE_NOT_NULL(map);
+    ENSURE_NOT_NULL(key);
+
+    ptrdiff_t existing = find_slot(map, hash, key, equals, context);
+    if (existing >= 0) {
+        if (out_inserted != NULL) {
+            *out_inserted = false;
+        }
+
+        return &map->entries.elements[map->slots[existing]];
+    }
+
+    uint64_t mixed = mix(hash);
+    size_t slot = map->capacity == 0 ? 0 : find_free_slot(map, mixed);
+
+    // Reusing a deleted slot doesn't make the probe sequences any longer, so we only
+    // need to rebuild the table when we're about to use up an empty one.
+    if (map->capacity == 0 || (map->growth_left == 0 && map->control[slot] == CONTROL_EMPTY)) {
+        // If most of the slots are taken up by deleted entries, rebuilding the table at
+        // the same size is enough to make room. Otherwise, we double its size.
+        size_t capacity = MAX(map->capacity, HASHMAP_GROUP_WIDTH);
+        if (map->length + 1 > MAX_LOAD(capacity) / 2) {
+            capacity *= 2;
+        }
+
+        rebuild(map, capacity);
+        slot = find_free_slot(map, mixed);
+    }
+
+    if (map->control[slot] == CONTROL_EMPTY) {
+        map->growth_left--;
+    }
+
+    size_t index = map->entries.length;
+    std_vector_append(&map->entries, ((hashmap_entry_t) { .hash = hash, .key = key, .value = NULL }));
+
+    set_control(map, slot, h2(mixed));
+    map->slots[slot] = (uint32_t)index;
+    map->length++;
+
+    if (out_inserted != NULL) {
+        *out_inserted = true;
+    }
+
+    return &map->entries.elements[index];
+}
+
+bool std_hashmap_remove(
+    hashmap_t* map,
+    uint64_t hash,
+    const void* key,
+    hashmap_equals_t equals,
+    const void* context,
+    hashmap_entry_t* out_removed
+) {
+    ENSURE_NOT_NULL(map);
+    ENSURE_NOT_NULL(key);
+
+    ptrdiff_t slot = find_slot(map, hash, key, equals, context);
+    if (slot < 0)
+        return false;
+
+    hashmap_entry_t* entry = &map->entries.elements[map->slots[slot]];
+    if (out_removed != NULL) {
+        *out_removed = *entry;
+    }
+
+    // The slot might be in the middle of the probe sequence of another key, so it has to
+    // be marked as deleted, rather than empty. The entry itself stays in place, so that
+    // the insertion order of all other entries is preserved.
+    set_control(map, (size_t)slot, CONTROL_DELETED);
+    entry->key = NULL;
+    entry->value = NULL;
+    map->length--;
+
+    // If we've removed the most recently inserted entry, we can drop it right away.
+    while (map->entries.length != 0 && map->entries.elements[map->entries.length - 1].key == NULL) {
+        map->entries.length--;
+    }
+
+    return true;
+}
+
+void std_hashmap_clear(hashmap_t* map) {
+    ENSURE_NOT_NULL(map);
+
+    map->entries.length = 0;
+    map->length = 0;
+
+    if (map->capacity != 0) {
+        memset(map->control, (uint8_t)CONTROL_EMPTY, map->capacity + HASHMAP_GROUP_WIDTH);
+        map->growth_left = MAX_LOAD(map->capacity);
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "vector.h"
+
+// An open-addressing hash map, modelled after Abseil's "Swiss tables". Every slot of the
+// table has a one-byte control word, which either marks the slot as empty or deleted, or
+// holds 7 bits of the hash of the key that occupies it. Lookups compare a whole group of
+// 16 control bytes against those 7 bits at once via SSE2, and only then look at the keys.
+//
+// The slots themselves do not hold the keys - they refer to `entries`, which are kept in
+// insertion order, like in a Python `dict`. Entries also cache the full hash of their key,
+// so the table never needs to hash a key twice, even when it grows.
+//
+// The map does not know how to hash or compare keys - callers provide the hash, as well
+// as an equality function, which is only called when two full hashes match.
+
+// The number of control bytes probed at once.
+#define HASHMAP_GROUP_WIDTH 16
+
+// Represents a single key-value pair of a `hashmap_t`.
+typedef struct hashmap_entry {
+    // The hash of `key`, as provided when it was inserted.
+    uint64_t hash;
+
+    // The key. If `NULL`, the entry was removed, and should be skipped over.
+    const void* key;
+
+    // The value associated with `key`.
+    void* value;
+} hashmap_entry_t;
+
+USES_VECTOR_FOR(hashmap_entry_t);
+
+// Returns `true` if the keys `a` and `b` are equal. `context` is passed through from the
+// function that was called on the map.
+typedef bool (*hashmap_equals_t)(const void* a, const void* b, const void* context);
+
+// Represents a hash map. A zero-initialized `hashmap_t` is a valid, empty map.
+typedef struct hashmap {
+    // All entries, in insertion order. Removed entries stay in the vector with their
+    // `key` set to `NULL`, until the table is rebuilt.
+    vector_t(hashmap_entry_t) entries;
+
+    // The number of entries that were not removed.
+    size_t length;
+
+    // The control bytes - one per slot, followed by a copy of the first
+    // `HASHMAP_GROUP_WIDTH` ones, so that a group can be loaded from any slot.
+    int8_t* control;
+
+    // For each full slot, the index of its entry in `entries`.
+    uint32_t* slots;
+
+    // The number of slots. This is either 0, or a power of two that is at least
+    // `HASHMAP_GROUP_WIDTH`.
+    size_t capacity;
+
+    // The number of empty slots that can be filled before the table has to be rebuilt.
+    size_t growth_left;
+} hashmap_t;
+
+// Ensures that the map can hold at least `count` entries without being rebuilt.
+void std_hashmap_reserve(hashmap_t* map, size_t count);
+
+// Finds the entry with the given key, returning `NULL` if there is no such entry. The
+// returned pointer is only valid until the next insertion.
+hashmap_entry_t* std_hashmap_find(
+    const hashmap_t* map,
+    uint64_t hash,
+    const void* key,
+    hashmap_equals_t equals,
+    const void* context
+);
+
+// Finds the entry with the given key, creating it if it does not exist yet. New entries
+// are appended to the end of `entries`, with their value set to `NULL`, in which case
+// `out_inserted` (if not `NULL`) is set to `true`. The returned pointer is only valid
+// until the next insertion.
+hashmap_entry_t* std_hashmap_insert(
+    hashmap_t* map,
+    uint64_t hash,
+    const void* key,
+    hashmap_equals_t equals,
+    const void* context,
+    bool* out_inserted
+);
+
+// Removes the entry with the given key. Returns `false` if there is no such entry.
+// Otherwise, the removed entry is copied to `out_removed`, if it is not `NULL`.
+bool std_hashmap_remove(
+    hashmap_t* map,
+    uint64_t hash,
+    const void* key,
+    hashmap_equals_t equals,
+    const void* context,
+    hashmap_entry_t* out_removed
+);
+
+// Removes all entries from the map, keeping the memory it has allocated.
+void std_hashmap_clear(hashmap_t* map);
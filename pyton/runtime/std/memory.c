@@ -17,6 +17,26 @@ void* memcpy(void* restrict dest, const void* restrict src, size_t n) {
     return dest;
 }
 
+void* memmove(void* dest, const void* src, size_t n) {
+    uint8_t* pdest = (uint8_t*)dest;
+    const uint8_t* psrc = (const uint8_t*)src;
+
+    if (pdest < psrc) {
+        for (size_t i = 0; i < n; i++) {
+            pdest[i] = psrc[i];
+        }
+    }
+    else if (pdest > psrc) {
+        // The destination is after the source - copy from the end, so that we don't
+        // overwrite bytes we have yet to read.
+        for (size_t i = n; i > 0; i--) {
+            pdest[i - 1] = psrc[i - 1];
+        }
+    }
+
+    return dest;
+}
+
 void* memset(void* dest, int val, size_t len) {
     ENSURE_NOT_NULL(dest);
 
@@ -0,0 +1,461 @@
+#include "numfmt.h"
+
+#include "bigint.h"
+#include "memory.h"
+#include "safety.h"
+#include "../sys/mm.h"
+
+typedef unsigned __int128 uint128_t;
+
+// All pairs of decimal digits, from "00" to "99".
+static const char DIGIT_PAIRS[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+char* std_u64_to_decimal(uint64_t x, char* end) {
+    ENSURE_NOT_NULL(end);
+
+    char* pos = end;
+    while (x >= 100) {
+        const char* pair = &DIGIT_PAIRS[(x % 100) * 2];
+        x /= 100;
+
+        *--pos = pair[1];
+        *--pos = pair[0];
+    }
+
+    if (x >= 10) {
+        *--pos = DIGIT_PAIRS[x * 2 + 1];
+        *--pos = DIGIT_PAIRS[x * 2];
+    } else {
+        *--pos = (char)('0' + x);
+    }
+
+    return pos;
+}
+
+// Returns the amount of decimal digits of `x`, which must have at most 17 of them.
+static int decimal_length17(uint64_t x) {
+    int length = 1;
+    for (uint64_t bound = 10; length < 17 && x >= bound; bound *= 10) {
+        length++;
+    }
+
+    return length;
+}
+
+// Splits the given double into its raw mantissa and biased exponent bits.
+static void decompose(double x, uint64_t* out_mantissa, uint32_t* out_exponent) {
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+
+    *out_mantissa = bits & ((1ull << 52) - 1);
+    *out_exponent = (uint32_t)((bits >> 52) & 0x7FF);
+}
+
+//
+// Ryu (Ulf Adams, "Ryū: Fast Float-to-String Conversion", PLDI 2018).
+//
+// The value is first scaled by a power of 5 (and 2) into a 64-bit integer together with
+// the bounds of the interval of values that round to it, and digits are then removed from
+// all three until the bounds meet. The 128-bit multipliers for all powers of 5 are
+// derived from every 26th one, which saves us from the ~10 KiB table the reference
+// implementation uses by default.
+//
+
+#define POW5_INV_BITCOUNT 125
+#define POW5_BITCOUNT 125
+#define POW5_TABLE_SIZE 26
+
+static const uint64_t POW5_TABLE[POW5_TABLE_SIZE] = {
+    1u, 5u, 25u, 125u,
+    625u, 3125u, 15625u, 78125u,
+    390625u, 1953125u, 9765625u, 48828125u,
+    244140625u, 1220703125u, 6103515625u, 30517578125u,
+    152587890625u, 762939453125u, 3814697265625u, 19073486328125u,
+    95367431640625u, 476837158203125u, 2384185791015625u, 11920928955078125u,
+    59604644775390625u, 298023223876953125u
+};
+
+// The top 125 bits of 5^(26i), least significant half first.
+static const uint64_t POW5_SPLIT2[13][2] = {
+    { 0u, 1152921504606846976u },
+    { 0u, 1490116119384765625u },
+    { 1032610780636961552u, 1925929944387235853u },
+    { 7910200175544436838u, 1244603055572228341u },
+    { 16941905809032713930u, 1608611746708759036u },
+    { 13024893955298202172u, 2079081953128979843u },
+    { 6607496772837067824u, 1343575221513417750u },
+    { 17332926989895652603u, 1736530273035216783u },
+    { 13037379183483547984u, 2244412773384604712u },
+    { 1605989338741628675u, 1450417759929778918u },
+    { 9630225068416591280u, 1874621017369538693u },
+    { 665883850346957067u, 1211445438634777304u },
+    { 14931890668723713708u, 1565756531257009982u }
+};
+
+// The corrections (0 to 3) that make the derived multipliers for 5^i exact, 2 bits each.
+static const uint32_t POW5_OFFSETS[21] = {
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x40000000, 0x59695995,
+    0x55545555, 0x56555515, 0x41150504, 0x40555410, 0x44555145, 0x44504540,
+    0x45555550, 0x40004000, 0x96440440, 0x55565565, 0x54454045, 0x40154151,
+    0x55559155, 0x51405555, 0x00000105
+};
+
+// 2^k / 5^(26i), rounded up, where k makes the result 125 bits long.
+static const uint64_t POW5_INV_SPLIT2[15][2] = {
+    { 1u, 2305843009213693952u },
+    { 5955668970331000884u, 1784059615882449851u },
+    { 8982663654677661702u, 1380349269358112757u },
+    { 7286864317269821294u, 2135987035920910082u },
+    { 7005857020398200553u, 1652639921975621497u },
+    { 17965325103354776697u, 1278668206209430417u },
+    { 8928596168509315048u, 1978643211784836272u },
+    { 10075671573058298858u, 1530901034580419511u },
+    { 597001226353042382u, 1184477304306571148u },
+    { 1527430471115325346u, 1832889850782397517u },
+    { 12533209867169019542u, 1418129833677084982u },
+    { 5577825024675947042u, 2194449627517475473u },
+    { 11006974540203867551u, 1697873161311732311u },
+    { 10313493231639821582u, 1313665730009899186u },
+    { 12701016819766672773u, 2032799256770390445u }
+};
+
+// The corrections for the derived inverse multipliers, like `POW5_OFFSETS`.
+static const uint32_t POW5_INV_OFFSETS[22] = {
+    0x54544554, 0x04055545, 0x10041000, 0x00400414, 0x40010000, 0x41155555,
+    0x00000454, 0x00010044, 0x40000000, 0x44000041, 0x50454450, 0x55550054,
+    0x51655554, 0x40004000, 0x01000001, 0x00010500, 0x51515411, 0x05555554,
+    0x50411500, 0x40040000, 0x05040110, 0x00000000
+};
+
+// Returns `ceil(log2(5^e))`, or 1 if `e` is 0.
+static inline int32_t pow5bits(int32_t e) {
+    return (int32_t)(((uint32_t)e * 1217359) >> 19) + 1;
+}
+
+// Returns `floor(log10(2^e))`.
+static inline uint32_t log10_pow2(int32_t e) {
+    return ((uint32_t)e * 78913) >> 18;
+}
+
+// Returns `floor(log10(5^e))`.
+static inline uint32_t log10_pow5(int32_t e) {
+    return ((uint32_t)e * 732923) >> 20;
+}
+
+static inline bool multiple_of_pow5(uint64_t x, uint32_t p) {
+    uint32_t count = 0;
+    while (x % 5 == 0) {
+        x /= 5;
+        count++;
+    }
+
+    return count >= p;
+}
+
+static inline bool multiple_of_pow2(uint64_t x, uint32_t p) {
+    return (x & ((1ull << p) - 1)) == 0;
+}
+
+static void compute_pow5(uint32_t i, uint64_t* result) {
+    uint32_t base = i / POW5_TABLE_SIZE;
+    uint32_t base2 = base * POW5_TABLE_SIZE;
+    const uint64_t* mul = POW5_SPLIT2[base];
+
+    if (i == base2) {
+        result[0] = mul[0];
+        result[1] = mul[1];
+        return;
+    }
+
+    uint64_t m = POW5_TABLE[i - base2];
+    uint128_t b0 = (uint128_t)m * mul[0];
+    uint128_t b2 = (uint128_t)m * mul[1];
+    uint32_t delta = (uint32_t)(pow5bits((int32_t)i) - pow5bits((int32_t)base2));
+    uint128_t sum = (b0 >> delta) + (b2 << (64 - delta)) + ((POW5_OFFSETS[i / 16] >> ((i % 16) << 1)) & 3);
+
+    result[0] = (uint64_t)sum;
+    result[1] = (uint64_t)(sum >> 64);
+}
+
+static void compute_inv_pow5(uint32_t i, uint64_t* result) {
+    uint32_t base = (i + POW5_TABLE_SIZE - 1) / POW5_TABLE_SIZE;
+    uint32_t base2 = base * POW5_TABLE_SIZE;
+    const uint64_t* mul = POW5_INV_SPLIT2[base];
+
+    if (i == base2) {
+        result[0] = mul[0];
+        result[1] = mul[1];
+        return;
+    }
+
+    uint64_t m = POW5_TABLE[base2 - i];
+    uint128_t b0 = (uint128_t)m * (mul[0] - 1);
+    uint128_t b2 = (uint128_t)m * mul[1];
+    uint32_t delta = (uint32_t)(pow5bits((int32_t)base2) - pow5bits((int32_t)i));
+    uint128_t sum = (b0 >> delta) + (b2 << (64 - delta)) + 1 + ((POW5_INV_OFFSETS[i / 16] >> ((i % 16) << 1)) & 3);
+
+    result[0] = (uint64_t)sum;
+    result[1] = (uint64_t)(sum >> 64);
+}
+
+static inline uint64_t mul_shift64(uint64_t m, const uint64_t* mul, int32_t j) {
+    uint128_t b0 = (uint128_t)m * mul[0];
+    uint128_t b2 = (uint128_t)m * mul[1];
+    return (uint64_t)(((b0 >> 64) + b2) >> (j - 64));
+}
+
+// Ryu's `d2d` - converts the given (raw) double to `output * 10^exponent`, where `output`
+// has the fewest digits possible.
+static void shortest_decimal(uint64_t ieee_mantissa, uint32_t ieee_exponent, uint64_t* out_output, int32_t* out_exponent) {
+    int32_t e2;
+    uint64_t m2;
+    if (ieee_exponent == 0) {
+        e2 = 1 - 1023 - 52 - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = (int32_t)ieee_exponent - 1023 - 52 - 2;
+        m2 = (1ull << 52) | ieee_mantissa;
+    }
+
+    // Values that are exactly in the middle between two candidates round to the even one,
+    // so the bounds of the interval are inclusive if the mantissa is even.
+    bool accept_bounds = (m2 & 1) == 0;
+
+    // The lower bound is closer if the mantissa is a power of 2 (i.e. the exponent was
+    // just incremented).
+    uint64_t mv = 4 * m2;
+    uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+    uint64_t vr, vp, vm;
+    int32_t e10;
+    bool vm_is_trailing_zeros = false;
+    bool vr_is_trailing_zeros = false;
+    uint64_t pow5[2];
+
+    if (e2 >= 0) {
+        uint32_t q = log10_pow2(e2) - (e2 > 3);
+        int32_t k = POW5_INV_BITCOUNT + pow5bits((int32_t)q) - 1;
+        int32_t i = -e2 + (int32_t)q + k;
+        e10 = (int32_t)q;
+
+        compute_inv_pow5(q, pow5);
+        vr = mul_shift64(4 * m2, pow5, i);
+        vp = mul_shift64(4 * m2 + 2, pow5, i);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, pow5, i);
+
+        if (q <= 21) {
+            // Only one of mp, mv and mm can be a multiple of 5, if any.
+            if (mv % 5 == 0) {
+                vr_is_trailing_zeros = multiple_of_pow5(mv, q);
+            } else if (accept_bounds) {
+                vm_is_trailing_zeros = multiple_of_pow5(mv - 1 - mm_shift, q);
+            } else {
+                vp -= multiple_of_pow5(mv + 2, q);
+            }
+        }
+    } else {
+        uint32_t q = log10_pow5(-e2) - (-e2 > 1);
+        int32_t i = -e2 - (int32_t)q;
+        int32_t k = pow5bits(i) - POW5_BITCOUNT;
+        int32_t j = (int32_t)q - k;
+        e10 = (int32_t)q + e2;
+
+        compute_pow5((uint32_t)i, pow5);
+        vr = mul_shift64(4 * m2, pow5, j);
+        vp = mul_shift64(4 * m2 + 2, pow5, j);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, pow5, j);
+
+        if (q <= 1) {
+            // mv has at least q trailing zero bits, as it's a multiple of 4.
+            vr_is_trailing_zeros = true;
+            if (accept_bounds) {
+                vm_is_trailing_zeros = mm_shift == 1;
+            } else {
+                vp--;
+            }
+        } else if (q < 63) {
+            vr_is_trailing_zeros = multiple_of_pow2(mv, q);
+        }
+    }
+
+    // Remove digits while the bounds are still apart.
+    int32_t removed = 0;
+    uint8_t last_removed_digit = 0;
+    uint64_t output;
+
+    if (vm_is_trailing_zeros || vr_is_trailing_zeros) {
+        // The rare case, in which we have to track whether the removed digits were all
+        // zeros, to round exact halves to even.
+        while (vp / 10 > vm / 10) {
+            vm_is_trailing_zeros &= vm % 10 == 0;
+            vr_is_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = (uint8_t)(vr % 10);
+
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+
+        if (vm_is_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_is_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = (uint8_t)(vr % 10);
+
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+
+        if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0) {
+            last_removed_digit = 4;
+        }
+
+        output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) || last_removed_digit >= 5);
+    } else {
+        bool round_up = false;
+
+        // Most of the time, we can remove two digits at once.
+        if (vp / 100 > vm / 100) {
+            round_up = vr % 100 >= 50;
+
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+
+        while (vp / 10 > vm / 10) {
+            round_up = vr % 10 >= 5;
+
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+
+        output = vr + (vr == vm || round_up);
+    }
+
+    *out_output = output;
+    *out_exponent = e10 + removed;
+}
+
+int std_double_shortest(double x, char* out_digits, int* out_decpt) {
+    ENSURE_NOT_NULL(out_digits);
+    ENSURE_NOT_NULL(out_decpt);
+
+    uint64_t ieee_mantissa;
+    uint32_t ieee_exponent;
+    decompose(x, &ieee_mantissa, &ieee_exponent);
+    ASSERT(ieee_exponent != 0x7FF);
+
+    if (ieee_mantissa == 0 && ieee_exponent == 0) {
+        out_digits[0] = '0';
+        *out_decpt = 1;
+        return 1;
+    }
+
+    uint64_t output;
+    int32_t exponent;
+    shortest_decimal(ieee_mantissa, ieee_exponent, &output, &exponent);
+
+    int length = decimal_length17(output);
+    std_u64_to_decimal(output, out_digits + length);
+
+    *out_decpt = length + exponent;
+    return length;
+}
+
+// Powers of 10 that fit in a `uint64_t`.
+static const uint64_t POW10_TABLE[20] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+    100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull,
+    10000000000000ull, 100000000000000ull, 1000000000000000ull, 10000000000000000ull,
+    100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull
+};
+
+// Copies the decimal digits of `x` onto the heap.
+static string_t u64_to_heap_decimal(uint64_t x) {
+    char buffer[STD_U64_MAX_DIGITS];
+    char* end = buffer + STD_U64_MAX_DIGITS;
+    char* start = std_u64_to_decimal(x, end);
+
+    char* digits = mm_heap_alloc((size_t)(end - start));
+    memcpy(digits, start, (size_t)(end - start));
+    return (string_t) { .str = digits, .length = (int)(end - start) };
+}
+
+string_t std_double_scaled_digits(double x, int scale) {
+    uint64_t ieee_mantissa;
+    uint32_t ieee_exponent;
+    decompose(x, &ieee_mantissa, &ieee_exponent);
+    ASSERT(ieee_exponent != 0x7FF);
+
+    // The magnitude of `x` is exactly `m * 2^e`.
+    uint64_t m = ieee_exponent == 0 ? ieee_mantissa : ((1ull << 52) | ieee_mantissa);
+    int e = (ieee_exponent == 0 ? 1 : (int)ieee_exponent) - 1023 - 52;
+
+    if (m == 0)
+        return STR("0");
+
+    // Fractional values scaled by at most 10^19 (e.g. `format(x, ".2f")`) fit in 128 bits,
+    // as `m` is at most 53 bits long.
+    if (e < 0 && e > -120 && scale >= 0 && scale < 20) {
+        uint128_t product = (uint128_t)m * POW10_TABLE[scale];
+        int shift = -e;
+
+        uint128_t quotient = product >> shift;
+        uint128_t remainder = product & (((uint128_t)1 << shift) - 1);
+        uint128_t half = (uint128_t)1 << (shift - 1);
+
+        if (remainder > half || (remainder == half && (quotient & 1) != 0)) {
+            quotient++;
+        }
+
+        if ((quotient >> 64) == 0)
+            return u64_to_heap_decimal((uint64_t)quotient);
+    }
+
+    // Otherwise, we divide `m * 10^scale * 2^e` with big integers.
+    const bigint_t* ten = std_bigint_from_i64(10);
+    const bigint_t* numerator = std_bigint_from_i64((int64_t)m);
+    const bigint_t* denominator = std_bigint_from_i64(1);
+
+    if (scale > 0) {
+        numerator = std_bigint_mul(numerator, std_bigint_pow(ten, (uint64_t)scale));
+    } else if (scale < 0) {
+        denominator = std_bigint_pow(ten, (uint64_t)-scale);
+    }
+
+    if (e > 0) {
+        numerator = std_bigint_lshift(numerator, (size_t)e);
+    } else if (e < 0) {
+        denominator = std_bigint_lshift(denominator, (size_t)-e);
+    }
+
+    bigint_t* quotient;
+    bigint_t* remainder;
+    std_bigint_divmod(numerator, denominator, &quotient, &remainder);
+
+    int half_compare = std_bigint_compare(std_bigint_lshift(remainder, 1), denominator);
+    bool is_odd = quotient->length != 0 && (quotient->limbs[0] & 1) != 0;
+
+    if (half_compare > 0 || (half_compare == 0 && is_odd)) {
+        quotient = std_bigint_add(quotient, std_bigint_from_i64(1));
+    }
+
+    return std_bigint_to_decimal(quotient);
+}
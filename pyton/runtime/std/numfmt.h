@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "string.h"
+
+// Conversions of numbers to their decimal digits. Integers are written two digits at a
+// time, from a table of all pairs of digits. Floating-point values are converted to the
+// shortest string of digits that rounds back to the same value with the Ryu algorithm, or,
+// when a fixed amount of digits is requested, rounded exactly (half to even) - like
+// Python's `repr(float)` and `format(float, spec)` do, respectively.
+
+// The maximum amount of digits of a `uint64_t`.
+#define STD_U64_MAX_DIGITS 20
+
+// The maximum amount of digits `std_double_shortest` produces.
+#define STD_DOUBLE_MAX_DIGITS 17
+
+// Writes the decimal digits of `x` right before `end`, and returns a pointer to the first
+// one. At most `STD_U64_MAX_DIGITS` characters are written.
+char* std_u64_to_decimal(uint64_t x, char* end);
+
+// Writes the shortest string of decimal digits `d` for which `0.d * 10^decpt` rounds to
+// the magnitude of `x` into `out_digits`, and sets `out_decpt` to `decpt`. Returns the
+// amount of digits written, which is at most `STD_DOUBLE_MAX_DIGITS`. The sign of `x` is
+// ignored, and `x` must be finite. Zero is written as a single "0", with a `decpt` of 1.
+int std_double_shortest(double x, char* out_digits, int* out_decpt);
+
+// Returns the decimal digits of the magnitude of `x * 10^scale`, rounded to an integer
+// half to even, without any leading zeros (zero is returned as "0"). The product is
+// computed exactly, and so `scale` may be negative. `x` must be finite.
+string_t std_double_scaled_digits(double x, int scale);
@@ -0,0 +1,54 @@
+#include "strbuilder.h"
+
+#include "util.h"
+#include "memory.h"
+#include "safety.h"
+#include "../sys/mm.h"
+
+// The smallest capacity of a builder.
+#define MIN_CAPACITY 32
+
+// Replaces the buffer of the builder with one that can hold `capacity` characters.
+static void grow(strbuilder_t* builder, size_t capacity) {
+    char* data = mm_heap_alloc(capacity + 1);
+
+    if (builder->length != 0) {
+        memcpy(data, builder->data, builder->length);
+    }
+
+    data[builder->length] = '\0';
+    builder->data = data;
+    builder->capacity = capacity;
+}
+
+strbuilder_t* std_strbuilder_alloc(size_t capacity) {
+    strbuilder_t* builder = mm_heap_alloc(sizeof(strbuilder_t));
+    *builder = (strbuilder_t) {};
+    grow(builder, MAX(capacity, MIN_CAPACITY));
+    return builder;
+}
+
+void std_strbuilder_reserve(strbuilder_t* builder, size_t count) {
+    ENSURE_NOT_NULL(builder);
+
+    if (builder->length + count <= builder->capacity)
+        return;
+
+    grow(builder, MAX(builder->capacity * 2, builder->length + count));
+}
+
+void std_strbuilder_append(strbuilder_t* builder, string_t s) {
+    ENSURE_NOT_NULL(builder);
+    ENSURE_STR_VALID(s);
+
+    std_strbuilder_reserve(builder, s.length);
+
+    memcpy(&builder->data[builder->length], s.str, s.length);
+    builder->length += s.length;
+    builder->data[builder->length] = '\0';
+}
+
+string_t std_strbuilder_view(const strbuilder_t* builder) {
+    ENSURE_NOT_NULL(builder);
+    return (string_t) { .str = builder->data, .length = (int)builder->length };
+}
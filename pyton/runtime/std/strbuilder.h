@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stddef.h>
+#include "string.h"
+
+// A growable buffer of characters, used to build strings piece-by-piece without copying
+// the whole string on every append. The contents are always followed by a null terminator.
+//
+// When the buffer has to grow, the old one is not freed, as strings returned by
+// `std_strbuilder_view` might still refer to it.
+typedef struct strbuilder {
+    // The contents of the builder.
+    char* data;
+
+    // The number of characters in `data`, not including the null terminator.
+    size_t length;
+
+    // The number of characters `data` can hold, not including the null terminator.
+    size_t capacity;
+} strbuilder_t;
+
+// Allocates an empty builder, with room for at least `capacity` characters.
+strbuilder_t* std_strbuilder_alloc(size_t capacity);
+
+// Ensures that at least `count` more characters can be appended to the builder without
+// it having to grow. The capacity at least doubles each time it grows.
+void std_strbuilder_reserve(strbuilder_t* builder, size_t count);
+
+// Appends the given string to the builder.
+void std_strbuilder_append(strbuilder_t* builder, string_t s);
+
+// Returns a string that refers to the current contents of the builder. Appending to the
+// builder never modifies the characters the returned string refers to.
+string_t std_strbuilder_view(const strbuilder_t* builder);
@@ -1,7 +1,11 @@
 #include "string.h"
 
+#include <immintrin.h>
 #include "safety.h"
 #include "memory.h"
+#include "strscan.h"
+#include "util.h"
+#include "../sys/cpu.h"
 #include "../sys/mm.h"
 
 bool std_strequ(string_t s1, string_t s2) {
@@ -11,13 +15,137 @@ bool std_strequ(string_t s1, string_t s2) {
     if (s1.length != s2.length)
         return false;
 
-    for (int i = 0; i < s1.length; i++) {
-        if (s1.str[i] != s2.str[i]) {
-            return false;
+    return std_memequ(s1.str, s2.str, (size_t)s1.length);
+}
+
+int std_strcompare(string_t s1, string_t s2) {
+    ENSURE_STR_VALID(s1);
+    ENSURE_STR_VALID(s2);
+
+    int result = std_memcmp(s1.str, s2.str, (size_t)MIN(s1.length, s2.length));
+    if (result != 0)
+        return result;
+
+    return s1.length - s2.length;
+}
+
+// Multiplies `a` and `b` into a 128-bit product, and folds it back into 64 bits.
+static inline uint64_t fold_mul(uint64_t a, uint64_t b) {
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+#define HASH_K0 0xa0761d6478bd642full
+#define HASH_K1 0xe7037ed1a0b428dbull
+
+// The size of the blocks the vectorized part of `std_strhash` consumes at once.
+#define HASH_STRIPE 32
+
+// The keys that are mixed into each stripe. They are advanced by `HASH_KEY_STEP` after
+// each stripe, so that swapping two stripes changes the hash.
+static const uint64_t hash_keys[4] = {
+    0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull,
+    0x4d5a2da51de1aa47ull, 0xa0761d6478bd642full
+};
+
+#define HASH_KEY_STEP 0x9e3779b97f4a7c15ull
+
+// Mixes a single 16-byte block into a pair of 64-bit accumulators. The 32x32->64
+// multiplication of the two halves of each word is the widest SSE2 has.
+static inline __m128i hash_accumulate(__m128i acc, __m128i data, __m128i key) {
+    __m128i mixed = _mm_xor_si128(data, key);
+    __m128i product = _mm_mul_epu32(mixed, _mm_srli_epi64(mixed, 32));
+    __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+    return _mm_add_epi64(acc, _mm_add_epi64(product, swapped));
+}
+
+// Consumes `stripes` stripes of 32 bytes into four 64-bit lanes.
+static void hash_stripes_sse2(const unsigned char* p, size_t stripes, uint64_t lanes[4]) {
+    __m128i acc_lo = _mm_loadu_si128((const __m128i*)&lanes[0]);
+    __m128i acc_hi = _mm_loadu_si128((const __m128i*)&lanes[2]);
+    __m128i key_lo = _mm_loadu_si128((const __m128i*)&hash_keys[0]);
+    __m128i key_hi = _mm_loadu_si128((const __m128i*)&hash_keys[2]);
+    __m128i step = _mm_set1_epi64x((long long)HASH_KEY_STEP);
+
+    for (size_t i = 0; i < stripes; i++, p += HASH_STRIPE) {
+        acc_lo = hash_accumulate(acc_lo, _mm_loadu_si128((const __m128i*)p), key_lo);
+        acc_hi = hash_accumulate(acc_hi, _mm_loadu_si128((const __m128i*)(p + 16)), key_hi);
+        key_lo = _mm_add_epi64(key_lo, step);
+        key_hi = _mm_add_epi64(key_hi, step);
+    }
+
+    _mm_storeu_si128((__m128i*)&lanes[0], acc_lo);
+    _mm_storeu_si128((__m128i*)&lanes[2], acc_hi);
+}
+
+// The same as `hash_stripes_sse2`, with both halves of a stripe in a single register.
+// This yields the same lanes.
+__attribute__((target("avx2")))
+static void hash_stripes_avx2(const unsigned char* p, size_t stripes, uint64_t lanes[4]) {
+    __m256i acc = _mm256_loadu_si256((const __m256i*)lanes);
+    __m256i key = _mm256_loadu_si256((const __m256i*)hash_keys);
+    __m256i step = _mm256_set1_epi64x((long long)HASH_KEY_STEP);
+
+    for (size_t i = 0; i < stripes; i++, p += HASH_STRIPE) {
+        __m256i data = _mm256_loadu_si256((const __m256i*)p);
+        __m256i mixed = _mm256_xor_si256(data, key);
+        __m256i product = _mm256_mul_epu32(mixed, _mm256_srli_epi64(mixed, 32));
+        __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+        acc = _mm256_add_epi64(acc, _mm256_add_epi64(product, swapped));
+        key = _mm256_add_epi64(key, step);
+    }
+
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+}
+
+uint64_t std_strhash(string_t s) {
+    ENSURE_STR_VALID(s);
+
+    const uint64_t k0 = HASH_K0;
+    const uint64_t k1 = HASH_K1;
+
+    const unsigned char* p = (const unsigned char*)s.str;
+    size_t remaining = (size_t)s.length;
+    uint64_t h = k0 ^ (uint64_t)s.length;
+
+    // Longer strings are first consumed in stripes by independent vector lanes, which
+    // are then folded into the hash. Both variants compute the same lanes, so the hash
+    // doesn't depend on the processor.
+    if (remaining >= HASH_STRIPE) {
+        size_t stripes = remaining / HASH_STRIPE;
+        uint64_t lanes[4] = { k0, k1, k1, k0 };
+
+        if (cpu_get_features()->avx2) {
+            hash_stripes_avx2(p, stripes, lanes);
+        }
+        else {
+            hash_stripes_sse2(p, stripes, lanes);
         }
+
+        for (int i = 0; i < 4; i++) {
+            h = fold_mul(h ^ lanes[i], k1);
+        }
+
+        p += stripes * HASH_STRIPE;
+        remaining -= stripes * HASH_STRIPE;
+    }
+
+    // We consume the string 8 bytes at a time. Each word is mixed in through a
+    // 64x64->128 multiplication, which is a single instruction on x86-64.
+    while (remaining >= 8) {
+        uint64_t word;
+        __builtin_memcpy(&word, p, 8);
+        h = fold_mul(h ^ word, k1);
+        p += 8;
+        remaining -= 8;
+    }
+
+    uint64_t tail = 0;
+    for (size_t i = 0; i < remaining; i++) {
+        tail |= (uint64_t)p[i] << (i * 8);
     }
 
-    return true;
+    return fold_mul(h ^ tail ^ k1, k0 ^ (uint64_t)s.length);
 }
 
 string_t std_strconcat_array(const string_t* strings, int n) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "stdbool.h"
+#include <stdint.h>
 #include "safety.h"
 
 // Represents an immutable C string with an associated length.
@@ -17,6 +18,14 @@ typedef struct string {
 // Returns `true` if `s1` and `s2` are equal.
 bool std_strequ(string_t s1, string_t s2);
 
+// Lexicographically compares the bytes of `s1` and `s2`. Returns a negative value if `s1`
+// is ordered first, a positive value if `s2` is, and 0 if they are equal.
+int std_strcompare(string_t s1, string_t s2);
+
+// Computes a 64-bit hash of the contents of the given string. Equal strings always have
+// equal hashes.
+uint64_t std_strhash(string_t s);
+
 // Combines multiple strings into one. The recommended way to use this function is
 // via the `std_strconcat` macro.
 string_t std_strconcat_array(const string_t* strings, int n);
@@ -1,5 +1,7 @@
 #include "stringop.h"
 
+#include <emmintrin.h>
+#include <stdint.h>
 #include "memory.h"
 #include "safety.h"
 #include "sys/mm.h"
@@ -17,16 +19,29 @@ int strcmp(const char* s1, const char* s2) {
 }
 
 size_t strlen(const char* str) {
-    const char* p;
-
     if (str == NULL)
         return 0;
 
-    p = str;
-    while (*p != '\0')  {
-        p++; 
-    }
+    // We don't know how long the string is, so we can't read past its terminator with
+    // unaligned loads - they might cross into an unmapped page. Aligned 16-byte loads never
+    // cross a page boundary, so we start at the block the string is in, and ignore the
+    // bytes before it.
+    uintptr_t offset = (uintptr_t)str & 15;
+    const __m128i* block = (const __m128i*)(str - offset);
+    __m128i zero = _mm_setzero_si128();
+
+    uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128(block), zero));
+    mask >>= offset;
 
-    return p - str;
+    if (mask != 0)
+        return __builtin_ctz(mask);
+
+    while (true) {
+        block++;
+
+        mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128(block), zero));
+        if (mask != 0)
+            return (const char*)block + __builtin_ctz(mask) - str;
+    }
 }
 
@@ -0,0 +1,286 @@
+#include "strscan.h"
+
+#include <immintrin.h>
+#include "safety.h"
+#include "../sys/cpu.h"
+
+// Returns `true` if the AVX2 variants of the kernels can be used.
+static inline bool use_avx2(void) {
+    return cpu_get_features()->avx2;
+}
+
+static inline __m128i load16(const void* p) {
+    return _mm_loadu_si128((const __m128i*)p);
+}
+
+AVX2 static inline __m256i load32(const void* p) {
+    return _mm256_loadu_si256((const __m256i*)p);
+}
+
+// Returns a bit mask of the bytes that differ between the 16 bytes at `a` and `b`.
+static inline uint32_t diff16(const unsigned char* a, const unsigned char* b) {
+    return ~(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(load16(a), load16(b))) & 0xFFFF;
+}
+
+// Returns a bit mask of the bytes that differ between the 32 bytes at `a` and `b`.
+AVX2 static inline uint32_t diff32(const unsigned char* a, const unsigned char* b) {
+    return ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(load32(a), load32(b)));
+}
+
+// Finds the first `c` in `s[i..n]`, where all bytes before `i` are already known to differ.
+static const char* memchr_tail(const char* s, char c, size_t i, size_t n) {
+    for (; i + 16 <= n; i += 16) {
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(load16(&s[i]), _mm_set1_epi8(c)));
+        if (mask != 0)
+            return &s[i + __builtin_ctz(mask)];
+    }
+
+    for (; i < n; i++) {
+        if (s[i] == c)
+            return &s[i];
+    }
+
+    return NULL;
+}
+
+AVX2 static const char* memchr_avx2(const char* s, char c, size_t n) {
+    __m256i pattern = _mm256_set1_epi8(c);
+    size_t i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(load32(&s[i]), pattern));
+        if (mask != 0)
+            return &s[i + __builtin_ctz(mask)];
+    }
+
+    return memchr_tail(s, c, i, n);
+}
+
+const char* std_memchr(const char* s, char c, size_t n) {
+    if (n == 0)
+        return NULL;
+
+    ENSURE_NOT_NULL(s);
+
+    if (n >= 32 && use_avx2())
+        return memchr_avx2(s, c, n);
+
+    return memchr_tail(s, c, 0, n);
+}
+
+// Returns the index of the first byte that differs between `a[i..n]` and `b[i..n]`, or `n`
+// if there is none.
+static size_t mismatch_tail(const unsigned char* a, const unsigned char* b, size_t i, size_t n) {
+    for (; i + 16 <= n; i += 16) {
+        uint32_t mask = diff16(&a[i], &b[i]);
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+
+    for (; i < n; i++) {
+        if (a[i] != b[i])
+            return i;
+    }
+
+    return n;
+}
+
+AVX2 static size_t mismatch_avx2(const unsigned char* a, const unsigned char* b, size_t n) {
+    size_t i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        uint32_t mask = diff32(&a[i], &b[i]);
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+
+    return mismatch_tail(a, b, i, n);
+}
+
+// Returns the index of the first byte that differs between `a` and `b`, or `n` if the first
+// `n` bytes are equal.
+static size_t mismatch(const unsigned char* a, const unsigned char* b, size_t n) {
+    if (n >= 32 && use_avx2())
+        return mismatch_avx2(a, b, n);
+
+    return mismatch_tail(a, b, 0, n);
+}
+
+bool std_memequ(const void* a, const void* b, size_t n) {
+    if (n == 0 || a == b)
+        return true;
+
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+
+    const unsigned char* pa = a;
+    const unsigned char* pb = b;
+
+    // Strings that are compared for equality are often short, and we expect most of them to
+    // differ early - so, for up to 16 bytes, we compare both ends with two overlapping loads
+    // when possible, without having to go through a loop.
+    if (n < 16) {
+        if (n >= 8) {
+            uint64_t a0, a1, b0, b1;
+            __builtin_memcpy(&a0, pa, 8);
+            __builtin_memcpy(&b0, pb, 8);
+            __builtin_memcpy(&a1, pa + n - 8, 8);
+            __builtin_memcpy(&b1, pb + n - 8, 8);
+            return ((a0 ^ b0) | (a1 ^ b1)) == 0;
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            if (pa[i] != pb[i])
+                return false;
+        }
+
+        return true;
+    }
+
+    if (diff16(pa + n - 16, pb + n - 16) != 0)
+        return false;
+
+    return mismatch(pa, pb, n - 16) == n - 16;
+}
+
+int std_memcmp(const void* a, const void* b, size_t n) {
+    if (n == 0 || a == b)
+        return 0;
+
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+
+    const unsigned char* pa = a;
+    const unsigned char* pb = b;
+
+    size_t i = mismatch(pa, pb, n);
+    return i == n ? 0 : (int)pa[i] - (int)pb[i];
+}
+
+// Verifies the candidate positions in `mask`, where the first and last byte of `needle`
+// match `haystack` at `base + bit index`. Returns the first position that also matches in
+// its middle, or -1 if there is none.
+static inline int verify_candidates(uint32_t mask, const char* haystack, size_t base, string_t needle) {
+    while (mask != 0) {
+        size_t i = base + __builtin_ctz(mask);
+
+        if (std_memequ(&haystack[i + 1], &needle.str[1], (size_t)needle.length - 2))
+            return (int)i;
+
+        mask &= mask - 1;
+    }
+
+    return -1;
+}
+
+// Searches for `needle` in `haystack[from..]`, after all candidates before `from` have
+// been ruled out. `needle` must be at least 2 characters long.
+static int find_tail(string_t haystack, string_t needle, size_t from) {
+    size_t n = (size_t)needle.length;
+    size_t length = (size_t)haystack.length;
+
+    __m128i first = _mm_set1_epi8(needle.str[0]);
+    __m128i last = _mm_set1_epi8(needle.str[n - 1]);
+
+    // We compare the first and last byte of the needle against 16 positions at once, and
+    // only compare the whole needle at the positions where both match. This rules out
+    // most positions even when the first byte is common.
+    size_t i = from;
+    for (; i + n - 1 + 16 <= length; i += 16) {
+        __m128i eq_first = _mm_cmpeq_epi8(load16(&haystack.str[i]), first);
+        __m128i eq_last = _mm_cmpeq_epi8(load16(&haystack.str[i + n - 1]), last);
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(eq_first, eq_last));
+
+        int found = verify_candidates(mask, haystack.str, i, needle);
+        if (found >= 0)
+            return found;
+    }
+
+    for (; i + n <= length; i++) {
+        if (haystack.str[i] == needle.str[0] && std_memequ(&haystack.str[i + 1], &needle.str[1], n - 1))
+            return (int)i;
+    }
+
+    return -1;
+}
+
+AVX2 static int find_avx2(string_t haystack, string_t needle) {
+    size_t n = (size_t)needle.length;
+    size_t length = (size_t)haystack.length;
+
+    __m256i first = _mm256_set1_epi8(needle.str[0]);
+    __m256i last = _mm256_set1_epi8(needle.str[n - 1]);
+
+    size_t i = 0;
+    for (; i + n - 1 + 32 <= length; i += 32) {
+        __m256i eq_first = _mm256_cmpeq_epi8(load32(&haystack.str[i]), first);
+        __m256i eq_last = _mm256_cmpeq_epi8(load32(&haystack.str[i + n - 1]), last);
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(eq_first, eq_last));
+
+        int found = verify_candidates(mask, haystack.str, i, needle);
+        if (found >= 0)
+            return found;
+    }
+
+    return find_tail(haystack, needle, i);
+}
+
+int std_strfind(string_t haystack, string_t needle) {
+    ENSURE_STR_VALID(haystack);
+    ENSURE_STR_VALID(needle);
+
+    if (needle.length == 0)
+        return 0;
+
+    if (needle.length > haystack.length)
+        return -1;
+
+    if (needle.length == 1) {
+        const char* found = std_memchr(haystack.str, needle.str[0], (size_t)haystack.length);
+        return found == NULL ? -1 : (int)(found - haystack.str);
+    }
+
+    if ((size_t)haystack.length >= 32 + (size_t)needle.length && use_avx2())
+        return find_avx2(haystack, needle);
+
+    return find_tail(haystack, needle, 0);
+}
+
+int std_strrfind(string_t haystack, string_t needle) {
+    ENSURE_STR_VALID(haystack);
+    ENSURE_STR_VALID(needle);
+
+    if (needle.length > haystack.length)
+        return -1;
+
+    // Searching backwards is rare enough that we don't have a vectorized kernel for it -
+    // we only use one for the comparisons themselves.
+    for (int i = haystack.length - needle.length; i >= 0; i--) {
+        if (std_memequ(&haystack.str[i], needle.str, (size_t)needle.length))
+            return i;
+    }
+
+    return -1;
+}
+
+size_t std_strcount(string_t haystack, string_t needle) {
+    ENSURE_STR_VALID(haystack);
+    ENSURE_STR_VALID(needle);
+
+    if (needle.length == 0)
+        return (size_t)haystack.length + 1;
+
+    size_t count = 0;
+
+    while (true) {
+        int found = std_strfind(haystack, needle);
+        if (found < 0)
+            return count;
+
+        count++;
+
+        int next = found + needle.length;
+        haystack.str += next;
+        haystack.length -= next;
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "string.h"
+
+// Vectorized kernels for searching and comparing runs of bytes. Each kernel processes
+// 32 bytes at a time with AVX2 if the processor supports it, and 16 bytes at a time with
+// SSE2 otherwise - as SSE2 is part of x86-64, it is always available. Inputs that are
+// shorter than a single vector, as well as the remainders of longer ones, are handled
+// by scalar code.
+
+// Returns a pointer to the first occurrence of `c` in the first `n` bytes of `s`, or
+// `NULL` if there is none.
+const char* std_memchr(const char* s, char c, size_t n);
+
+// Returns `true` if the first `n` bytes of `a` and `b` are equal.
+bool std_memequ(const void* a, const void* b, size_t n);
+
+// Lexicographically compares the first `n` bytes of `a` and `b`, treating them as unsigned.
+// Returns a negative value if `a` is ordered first, a positive value if `b` is, and 0 if
+// they are equal.
+int std_memcmp(const void* a, const void* b, size_t n);
+
+// Returns the index of the first occurrence of `needle` in `haystack`, or -1 if there is
+// none. An empty needle is found at index 0.
+int std_strfind(string_t haystack, string_t needle);
+
+// Returns the index of the last occurrence of `needle` in `haystack`, or -1 if there is
+// none. An empty needle is found at the end of `haystack`.
+int std_strrfind(string_t haystack, string_t needle);
+
+// Returns the number of non-overlapping occurrences of `needle` in `haystack`. An empty
+// needle occurs `haystack.length + 1` times.
+size_t std_strcount(string_t haystack, string_t needle);
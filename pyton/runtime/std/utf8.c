@@ -0,0 +1,109 @@
+#include "utf8.h"
+
+#include <immintrin.h>
+#include <stdint.h>
+#include "safety.h"
+#include "../sys/cpu.h"
+
+// Continuation bytes are in the range of 0x80..0xBF, i.e. -128..-65 when signed.
+#define CONTINUATION_MAX (-65)
+
+// We count code points in 8-bit lanes, which we have to flush every 255 blocks.
+#define MAX_BLOCKS_PER_FLUSH 255
+
+// Returns `true` if the given byte starts a code point.
+static inline bool is_lead(char c) {
+    return (signed char)c > CONTINUATION_MAX;
+}
+
+// Adds up the 8-bit lanes of `counts`.
+static inline uint64_t sum_lanes(__m128i counts) {
+    __m128i sums = _mm_sad_epu8(counts, _mm_setzero_si128());
+    return (uint64_t)_mm_cvtsi128_si64(sums) + (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums));
+}
+
+// Counts the code points in `s[i..]`, ORing all bytes into `*high` - their sign bits tell
+// whether there were any non-ASCII characters.
+static int analyze_tail(string_t s, size_t i, uint8_t* high) {
+    size_t length = (size_t)s.length;
+    __m128i threshold = _mm_set1_epi8(CONTINUATION_MAX);
+    __m128i all = _mm_setzero_si128();
+    uint64_t count = 0;
+
+    while (i + 16 <= length) {
+        // Comparisons yield -1 for each lead byte, so subtracting them counts upwards.
+        __m128i counts = _mm_setzero_si128();
+
+        for (int blocks = 0; blocks < MAX_BLOCKS_PER_FLUSH && i + 16 <= length; blocks++, i += 16) {
+            __m128i data = _mm_loadu_si128((const __m128i*)&s.str[i]);
+            all = _mm_or_si128(all, data);
+            counts = _mm_sub_epi8(counts, _mm_cmpgt_epi8(data, threshold));
+        }
+
+        count += sum_lanes(counts);
+    }
+
+    if (_mm_movemask_epi8(all) != 0) {
+        *high |= 0x80;
+    }
+
+    for (; i < length; i++) {
+        *high |= (uint8_t)s.str[i];
+        count += is_lead(s.str[i]);
+    }
+
+    return (int)count;
+}
+
+__attribute__((target("avx2")))
+static int analyze_avx2(string_t s, bool* out_ascii) {
+    size_t length = (size_t)s.length;
+    __m256i threshold = _mm256_set1_epi8(CONTINUATION_MAX);
+    __m256i all = _mm256_setzero_si256();
+    uint64_t count = 0;
+    size_t i = 0;
+
+    while (i + 32 <= length) {
+        __m256i counts = _mm256_setzero_si256();
+
+        for (int blocks = 0; blocks < MAX_BLOCKS_PER_FLUSH && i + 32 <= length; blocks++, i += 32) {
+            __m256i data = _mm256_loadu_si256((const __m256i*)&s.str[i]);
+            all = _mm256_or_si256(all, data);
+            counts = _mm256_sub_epi8(counts, _mm256_cmpgt_epi8(data, threshold));
+        }
+
+        count += sum_lanes(_mm256_castsi256_si128(counts));
+        count += sum_lanes(_mm256_extracti128_si256(counts, 1));
+    }
+
+    uint8_t high = _mm256_movemask_epi8(all) != 0 ? 0x80 : 0;
+    count += (uint64_t)analyze_tail(s, i, &high);
+
+    *out_ascii = (high & 0x80) == 0;
+    return (int)count;
+}
+
+int std_utf8_analyze(string_t s, bool* out_ascii) {
+    ENSURE_STR_VALID(s);
+    ENSURE_NOT_NULL(out_ascii);
+
+    if (s.length >= 64 && cpu_get_features()->avx2)
+        return analyze_avx2(s, out_ascii);
+
+    uint8_t high = 0;
+    int count = analyze_tail(s, 0, &high);
+
+    *out_ascii = (high & 0x80) == 0;
+    return count;
+}
+
+int std_utf8_skip(string_t s, int offset, int count) {
+    ENSURE_STR_VALID(s);
+    ASSERT(offset >= 0 && offset <= s.length);
+
+    for (; count > 0 && offset < s.length; count--) {
+        offset += std_utf8_sequence_length(s.str[offset]);
+    }
+
+    return offset;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "string.h"
+
+// Helpers for UTF-8 encoded strings. The strings are assumed to be valid UTF-8 - a code
+// point is counted for every byte that doesn't continue a multi-byte sequence.
+
+// Counts the code points in the given string, and sets `out_ascii` to `true` if all of
+// them are ASCII characters. This is done in a single vectorized pass.
+int std_utf8_analyze(string_t s, bool* out_ascii);
+
+// Returns the byte offset of the code point that comes `count` code points after the one
+// at the byte offset `offset`.
+int std_utf8_skip(string_t s, int offset, int count);
+
+// Returns the number of bytes the UTF-8 sequence starting with the given byte occupies.
+static inline int std_utf8_sequence_length(char lead) {
+    unsigned char c = (unsigned char)lead;
+
+    if (c < 0x80)
+        return 1;
+
+    if (c < 0xE0)
+        return 2;
+
+    return c < 0xF0 ? 3 : 4;
+}
@@ -9,6 +9,9 @@
 // Returns the smaller of `$a` and `$b`.
 #define MIN($a, $b) ((($a) < ($b)) ? ($a) : ($b))
 
+// Returns the larger of `$a` and `$b`.
+#define MAX($a, $b) ((($a) > ($b)) ? ($a) : ($b))
+
 // Performs null-coalescing across two values:
 //     - if the evaluation of `$a` is not `NULL`, it is returned, otherwise:
 //     - `$b` is returned.
@@ -28,35 +28,35 @@ void std_vector_any_append(vector_any_t* vec, unit_t value) {
     ENSURE_NOT_NULL(value.data);
     ASSERT(value.size > 0);
 
-    if (vec->elements == NULL || vec->length == 0 || vec->capacity == 0) {
-        // This vector hasn't been initialized yet.
-        // Start with a capacity of 4.
-        vec->elements = mm_heap_alloc(4 * value.size);
-        vec->length = 1;
-        vec->capacity = 4;
-        std_vector_any_set(vec, 0, value);
-        return;
+    if (vec->length == vec->capacity) {
+        std_vector_any_reserve(vec, vec->length + 1, value.size);
     }
 
-    // Check if we're over capacity.
-    if (vec->length == vec->capacity) {
-        // If so, we need to expand the vector.
-        void* old_elements = vec->elements;
-        size_t old_length = vec->length;
+    vec->length++;
+    std_vector_any_set(vec, vec->length - 1, value);
+}
+
+void std_vector_any_reserve(vector_any_t* vec, size_t capacity, size_t unit_size) {
+    ENSURE_NOT_NULL(vec);
+    ASSERT(unit_size > 0);
+
+    if (capacity <= vec->capacity)
+        return;
 
-        vec->capacity *= 2; // exponential expansion policy
-        vec->elements = mm_heap_alloc(vec->capacity * value.size);
+    // Exponential expansion policy - this is what makes appending amortized O(1). We
+    // start with a capacity of 4.
+    size_t new_capacity = MAX(capacity, MAX(vec->capacity * 2, 4));
 
-        // Copy what was previously in our old element array
-        memcpy(vec->elements, old_elements, old_length * value.size);
+    void* old_elements = vec->elements;
+    vec->elements = mm_heap_alloc(new_capacity * unit_size);
+    vec->capacity = new_capacity;
 
-        // The newly allocated array is now our backing store. We can safely free the
-        // previous one.
+    if (old_elements != NULL) {
+        // Copy what was previously in our old element array. The newly allocated array
+        // is now our backing store, so we can safely free the previous one.
+        memcpy(vec->elements, old_elements, vec->length * unit_size);
         mm_heap_free(old_elements);
     }
-
-    vec->length++;
-    std_vector_any_set(vec, vec->length - 1, value);
 }
 
 void std_vector_any_remove(vector_any_t* vec, int index, size_t unit_size) {
@@ -81,4 +81,4 @@ void std_vector_any_remove(vector_any_t* vec, int index, size_t unit_size) {
 
     std_memmove_back(dest, area_size, unit_size);
     vec->length--;
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <stddef.h>
 #include "unit.h"
 #include "util.h"
+#include "safety.h"
 
 // Defines the fields used by all vector structures (i.e. both the generic and type-erased versions).
 #define VECTOR_T_FIELDS(T)   \
@@ -29,18 +30,43 @@ typedef struct vector_any { VECTOR_T_FIELDS(void) } vector_any_t;
 // ```
 #define vector_t(T) struct vector_##T
 
-// Appends a new element, expanding the vector if necessary.
+// Returns the size of a single element of the given vector.
+#define std_vector_unit_size($vector) sizeof(*($vector)->elements)
+
+// Ensures that the vector can hold at least `$capacity` elements without being expanded.
+#define std_vector_reserve($vector, $capacity)                                       \
+    std_vector_any_reserve((vector_any_t*)($vector), $capacity, std_vector_unit_size($vector))
+
+// Appends a new element, expanding the vector if necessary. The vector grows exponentially,
+// so appending is amortized O(1). The element is stored directly, without going through
+// a `unit_t`.
 #define std_vector_append($vector, $element)                                         \
     {                                                                                \
-        __typeof__(($element)) element = ($element);                                 \
-        std_vector_any_append(                                                       \
-            (vector_any_t*)($vector),                                                \
-            (unit_t) { .data = (void*)&element, .size = sizeof(element) }            \
-        );                                                                           \
+        __typeof__(($vector)) vector = ($vector);                                    \
+        if (vector->length == vector->capacity) {                                    \
+            std_vector_reserve(vector, vector->length + 1);                          \
+        }                                                                            \
+        vector->elements[vector->length++] = ($element);                             \
     }
 
-// Returns the size of a single element of the given vector.
-#define std_vector_unit_size($vector) sizeof(*($vector)->elements)
+// Inserts a new element at the given index, moving all elements at and after it one
+// position to the right. `$index` may be equal to the length of the vector.
+#define std_vector_insert($vector, $index, $element)                                 \
+    {                                                                                \
+        __typeof__(($vector)) vector = ($vector);                                    \
+        size_t insert_at = ($index);                                                 \
+        ASSERT(insert_at <= vector->length);                                         \
+        if (vector->length == vector->capacity) {                                    \
+            std_vector_reserve(vector, vector->length + 1);                          \
+        }                                                                            \
+        memmove(                                                                     \
+            &vector->elements[insert_at + 1],                                        \
+            &vector->elements[insert_at],                                            \
+            (vector->length - insert_at) * std_vector_unit_size(vector)              \
+        );                                                                           \
+        vector->elements[insert_at] = ($element);                                    \
+        vector->length++;                                                            \
+    }
 
 // Removes the element at the given index.
 #define std_vector_remove($vector, $index)  \
@@ -54,6 +80,11 @@ void std_vector_any_set(vector_any_t* vec, int index, unit_t value);
 // function, and should be avoided if possible. See `std_vector_append` instead.
 void std_vector_any_append(vector_any_t* vec, unit_t value);
 
+// Ensures that the vector can hold at least `capacity` elements of size `unit_size`. When
+// expanding, the capacity is at least doubled. This is a non-generic (type-erased) function,
+// and should be avoided if possible. See `std_vector_reserve` instead.
+void std_vector_any_reserve(vector_any_t* vec, size_t capacity, size_t unit_size);
+
 // Removes the element at the given index. This is a non-generic (type-erased)
 // function, and should be avoided if possible. See `std_vector_remove` instead.
 void std_vector_any_remove(vector_any_t* vec, int index, size_t unit_size);
@@ -0,0 +1,724 @@
+#include "strings.h"
+
+#include "ints.h"
+#include "formatting.h"
+#include "lists.h"
+#include "std/memory.h"
+#include "std/safety.h"
+#include "std/strscan.h"
+#include "std/utf8.h"
+#include "std/util.h"
+#include "sys/mm.h"
+
+// All single-character ASCII strings, which indexing returns instead of allocating new ones.
+static pyobj_t ascii_chars[128];
+static char ascii_chars_data[128];
+
+void py_str_analyze(pyobj_t* str) {
+    ENSURE_NOT_NULL(str);
+
+    if (str->str_flags & PY_STR_ANALYZED)
+        return;
+
+    bool is_ascii;
+    str->str_codepoints = std_utf8_analyze(str->as_str, &is_ascii);
+    str->str_flags |= PY_STR_ANALYZED | (is_ascii ? PY_STR_ASCII : 0);
+}
+
+pyobj_t* py_alloc_str_analyzed(string_t x, int codepoints, bool is_ascii) {
+    pyobj_t* obj = mm_heap_alloc(sizeof(pyobj_t));
+    obj->type = &py_type_str;
+    obj->as_str = x;
+    obj->str_hash = 0;
+    obj->str_builder = NULL;
+    obj->str_flags = PY_STR_ANALYZED | (is_ascii ? PY_STR_ASCII : 0);
+    obj->str_codepoints = codepoints;
+    obj->str_index = NULL;
+    return obj;
+}
+
+int py_str_length(pyobj_t* str) {
+    py_str_analyze(str);
+    return str->str_codepoints;
+}
+
+bool py_str_is_ascii(pyobj_t* str) {
+    py_str_analyze(str);
+    return (str->str_flags & PY_STR_ASCII) != 0;
+}
+
+// Builds the sparse index of code point offsets of the given non-ASCII string.
+static const int* build_index(pyobj_t* str) {
+    int entries = str->str_codepoints / PY_STR_INDEX_STRIDE + 1;
+    int* index = mm_heap_alloc((size_t)entries * sizeof(int));
+
+    int offset = 0;
+    for (int i = 0; i < entries; i++) {
+        index[i] = offset;
+        offset = std_utf8_skip(str->as_str, offset, PY_STR_INDEX_STRIDE);
+    }
+
+    return index;
+}
+
+int py_str_offset(pyobj_t* str, int index) {
+    ENSURE_NOT_NULL(str);
+    ASSERT(index >= 0 && index <= py_str_length(str));
+
+    if (py_str_is_ascii(str))
+        return index;
+
+    if (index == str->str_codepoints)
+        return str->as_str.length;
+
+    if (str->str_index == NULL) {
+        str->str_index = build_index(str);
+    }
+
+    int base = str->str_index[index / PY_STR_INDEX_STRIDE];
+    return std_utf8_skip(str->as_str, base, index % PY_STR_INDEX_STRIDE);
+}
+
+// Returns the code point index of the character at the given byte offset.
+static int codepoint_index(pyobj_t* str, int offset) {
+    if (py_str_is_ascii(str))
+        return offset;
+
+    bool is_ascii;
+    return std_utf8_analyze((string_t) { .str = str->as_str.str, .length = offset }, &is_ascii);
+}
+
+// Returns the `str` that consists of the given ASCII character.
+static pyobj_t* ascii_char(char c) {
+    pyobj_t* str = &ascii_chars[(unsigned char)c];
+
+    if (str->type == NULL) {
+        ascii_chars_data[(unsigned char)c] = c;
+        *str = (pyobj_t) {
+            .type = &py_type_str,
+            .as_str = { .str = &ascii_chars_data[(unsigned char)c], .length = 1 },
+            .str_flags = PY_STR_ANALYZED | PY_STR_ASCII,
+            .str_codepoints = 1
+        };
+    }
+
+    return str;
+}
+
+pyreturn_t py_str_getitem(pyobj_t* str, pyobj_t* index) {
+    ENSURE_NOT_NULL(str);
+    ENSURE_NOT_NULL(index);
+
+    if (index->type != &py_type_int)
+        RAISE(TypeError, "string indices must be integers");
+
+    int64_t length = py_str_length(str);
+    int64_t i = index->as_int;
+
+    if (PY_INT_IS_SMALL(index) && i < 0) {
+        i += length;
+    }
+
+    if (!PY_INT_IS_SMALL(index) || i < 0 || i >= length)
+        RAISE(IndexError, "string index out of range");
+
+    int offset = py_str_offset(str, (int)i);
+    char lead = str->as_str.str[offset];
+
+    if (std_utf8_sequence_length(lead) == 1)
+        return WITH_RESULT(ascii_char(lead));
+
+    string_t character = {
+        .str = &str->as_str.str[offset],
+        .length = std_utf8_sequence_length(lead)
+    };
+
+    return WITH_RESULT(py_alloc_str_analyzed(character, 1, false));
+}
+
+// Allocates a `str` with the contents of the given builder, that can be appended to
+// in-place. Its contents consist of `codepoints` code points.
+static pyobj_t* alloc_from_builder(strbuilder_t* builder, int codepoints, bool is_ascii) {
+    pyobj_t* str = py_alloc_str_analyzed(std_strbuilder_view(builder), codepoints, is_ascii);
+    str->str_builder = builder;
+    return str;
+}
+
+// Allocates a `str` that holds a part of `parent`. The contents of the part only need to
+// be analyzed if `parent` isn't made up of ASCII characters.
+static pyobj_t* alloc_part(pyobj_t* parent, string_t part) {
+    if (py_str_is_ascii(parent))
+        return py_alloc_str_analyzed(part, part.length, true);
+
+    return py_alloc_str(part);
+}
+
+pyreturn_t py_str_of(pyobj_t* x) {
+    ENSURE_NOT_NULL(x);
+
+    if (x->type == &py_type_str)
+        return WITH_RESULT(x);
+
+    if (x == &py_none)
+        return WITH_RESULT(PY_STR("None"));
+
+    // Numbers are converted directly, without looking up and calling their `__str__`.
+    if (x->type == &py_type_int || x->type == &py_type_float || x->type == &py_type_bool)
+        return py_format_builtin(x, STR(""));
+
+    pyobj_t* method_str;
+    bool is_unbound = py_get_method_attribute(x, STR("__str__"), &method_str);
+
+    if (method_str == NULL)
+        return WITH_RESULT(PY_STR("<object>"));
+
+    pyobj_t* result = UNWRAP(py_call(method_str, 0, NULL, 0, NULL, is_unbound ? x : NULL));
+    if (NOT_NULL(result)->type != &py_type_str)
+        RAISE(TypeError, "__str__ returned non-string");
+
+    return WITH_RESULT(result);
+}
+
+pyobj_t* py_str_concat(pyobj_t* a, pyobj_t* b) {
+    ENSURE_NOT_NULL(a);
+    ENSURE_NOT_NULL(b);
+    ASSERT(a->type == &py_type_str && b->type == &py_type_str);
+
+    if (b->as_str.length == 0)
+        return a;
+
+    if (a->as_str.length == 0)
+        return b;
+
+    // We can only append to the builder of `a` if `a` covers all of its contents - otherwise,
+    // we'd overwrite the characters of another string that shares the builder.
+    strbuilder_t* builder = a->str_builder;
+    bool can_append = builder != NULL &&
+        builder->data == a->as_str.str &&
+        builder->length == (size_t)a->as_str.length;
+
+    if (!can_append) {
+        // We leave room for more appends, as strings that are concatenated once often end
+        // up being concatenated again.
+        size_t length = (size_t)a->as_str.length + (size_t)b->as_str.length;
+        builder = std_strbuilder_alloc(length * 2);
+        std_strbuilder_append(builder, a->as_str);
+    }
+
+    std_strbuilder_append(builder, b->as_str);
+
+    return alloc_from_builder(
+        builder,
+        py_str_length(a) + py_str_length(b),
+        py_str_is_ascii(a) && py_str_is_ascii(b)
+    );
+}
+
+pyobj_t* py_str_build(pyobj_t** parts, int count) {
+    ASSERT(count >= 0);
+
+    size_t length = 0;
+    int codepoints = 0;
+    bool is_ascii = true;
+
+    for (int i = 0; i < count; i++) {
+        ASSERT(NOT_NULL(parts[i])->type == &py_type_str);
+        length += (size_t)parts[i]->as_str.length;
+        codepoints += py_str_length(parts[i]);
+        is_ascii = is_ascii && py_str_is_ascii(parts[i]);
+    }
+
+    strbuilder_t* builder = std_strbuilder_alloc(length);
+    for (int i = 0; i < count; i++) {
+        std_strbuilder_append(builder, parts[i]->as_str);
+    }
+
+    return alloc_from_builder(builder, codepoints, is_ascii);
+}
+
+pyreturn_t py_str_join(pyobj_t* separator, pyobj_t* iterable) {
+    ENSURE_NOT_NULL(separator);
+    ENSURE_NOT_NULL(iterable);
+    ASSERT(separator->type == &py_type_str);
+
+    // We need to go over the items twice - once to compute the final length, and then to
+    // copy them - so we collect them into a list first, unless we already have one.
+    pyobj_t* items = iterable;
+    if (iterable->type != &py_type_list && iterable->type != &py_type_tuple) {
+        items = py_alloc_list(0);
+
+        pyobj_t* exception = py_list_extend(items, iterable);
+        if (exception != NULL)
+            return WITH_EXCEPTION(exception);
+    }
+
+    size_t count = items->as_list.length;
+    if (count == 0)
+        return WITH_RESULT(PY_STR(""));
+
+    size_t length = (size_t)separator->as_str.length * (count - 1);
+    int codepoints = py_str_length(separator) * (int)(count - 1);
+    bool is_ascii = py_str_is_ascii(separator);
+
+    for (size_t i = 0; i < count; i++) {
+        pyobj_t* item = items->as_list.elements[i];
+        if (item->type != &py_type_str)
+            RAISE(TypeError, "sequence item: expected str instance");
+
+        length += (size_t)item->as_str.length;
+        codepoints += py_str_length(item);
+        is_ascii = is_ascii && py_str_is_ascii(item);
+    }
+
+    if (count == 1)
+        return WITH_RESULT(items->as_list.elements[0]);
+
+    strbuilder_t* builder = std_strbuilder_alloc(length);
+    for (size_t i = 0; i < count; i++) {
+        if (i != 0) {
+            std_strbuilder_append(builder, separator->as_str);
+        }
+
+        std_strbuilder_append(builder, items->as_list.elements[i]->as_str);
+    }
+
+    return WITH_RESULT(alloc_from_builder(builder, codepoints, is_ascii));
+}
+
+// Returns `true` if `repr()` includes the given code point as-is. Outside of ASCII, this
+// only covers the control, format, separator and private use characters that are the most
+// common among the ones Python considers non-printable.
+static bool is_printable(uint32_t c) {
+    if (c < 0x80)
+        return c >= 0x20 && c != 0x7F;
+
+    return !(
+        c <= 0xA0 || c == 0xAD || c == 0x1680 ||
+        (c >= 0x2000 && c <= 0x200F) || (c >= 0x2028 && c <= 0x202F) ||
+        (c >= 0x205F && c <= 0x206F) || c == 0x3000 ||
+        (c >= 0xD800 && c <= 0xF8FF) || c == 0xFEFF
+    );
+}
+
+// Decodes the UTF-8 sequence of the given length that `p` points to.
+static uint32_t decode_codepoint(const uint8_t* p, int length) {
+    if (length == 1)
+        return p[0];
+
+    uint32_t c = p[0] & (0x7F >> length);
+    for (int i = 1; i < length; i++) {
+        c = (c << 6) | (p[i] & 0x3F);
+    }
+
+    return c;
+}
+
+pyobj_t* py_str_repr(pyobj_t* str, bool ascii_only) {
+    ENSURE_NOT_NULL(str);
+    ASSERT(str->type == &py_type_str);
+
+    const uint8_t* data = (const uint8_t*)str->as_str.str;
+    size_t length = (size_t)str->as_str.length;
+
+    // Like Python, we only use double quotes if they avoid escaping single quotes.
+    bool has_single = std_memchr((const char*)data, '\'', length) != NULL;
+    bool has_double = std_memchr((const char*)data, '"', length) != NULL;
+    char quote = has_single && !has_double ? '"' : '\'';
+
+    // A code point is escaped as at most `\UNNNNNNNN`, which takes up 10 characters -
+    // that's at most 4 characters for each of its bytes. Then, we have the quotes.
+    char* result = mm_heap_alloc(length * 4 + 2);
+    int n = 0;
+    int codepoints = 2;
+    bool is_ascii = true;
+
+    result[n++] = quote;
+
+    for (size_t i = 0; i < length; codepoints++) {
+        int sequence_length = std_utf8_sequence_length((char)data[i]);
+        uint32_t c = decode_codepoint(data + i, sequence_length);
+
+        if (c == (uint8_t)quote || c == '\\') {
+            result[n++] = '\\';
+            result[n++] = (char)c;
+            codepoints++;
+        }
+        else if (c == '\t' || c == '\n' || c == '\r') {
+            result[n++] = '\\';
+            result[n++] = c == '\t' ? 't' : (c == '\n' ? 'n' : 'r');
+            codepoints++;
+        }
+        else if (!is_printable(c) || (ascii_only && c >= 0x80)) {
+            int digits = c < 0x100 ? 2 : (c < 0x10000 ? 4 : 8);
+
+            result[n++] = '\\';
+            result[n++] = digits == 2 ? 'x' : (digits == 4 ? 'u' : 'U');
+
+            for (int shift = (digits - 1) * 4; shift >= 0; shift -= 4) {
+                result[n++] = "0123456789abcdef"[(c >> shift) & 0xF];
+            }
+
+            codepoints += digits + 1;
+        }
+        else {
+            memcpy(result + n, data + i, (size_t)sequence_length);
+            n += sequence_length;
+            is_ascii &= sequence_length == 1;
+        }
+
+        i += (size_t)sequence_length;
+    }
+
+    result[n++] = quote;
+
+    string_t s = { .str = result, .length = n };
+    return py_alloc_str_analyzed(s, codepoints, is_ascii);
+}
+
+pyreturn_t py_str_convert(pyobj_t* x, int conversion) {
+    ENSURE_NOT_NULL(x);
+
+    if (conversion == 1)
+        return py_str_of(x);
+
+    // TODO: Use __repr__ once we support it. Until then, only strings are represented
+    //       differently from their `str()` form.
+    if (x->type == &py_type_str)
+        return WITH_RESULT(py_str_repr(x, conversion == 3));
+
+    return py_str_of(x);
+}
+
+// Returns the characters of `s` in the range of `start..end`. The result refers to the
+// contents of `s`.
+static inline string_t substring(string_t s, int start, int end) {
+    return (string_t) { .str = s.str + start, .length = end - start };
+}
+
+// Returns `true` if `c` is a whitespace character, as defined by `str.isspace`.
+static inline bool is_space(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r') || (c >= '\x1c' && c <= '\x1f');
+}
+
+// Returns `true` if `str.strip(chars)` should remove the given code point, where `chars`
+// is either a `str` or `NULL` for whitespace.
+static inline bool should_strip(string_t character, pyobj_t* chars) {
+    if (chars == NULL)
+        return character.length == 1 && is_space(character.str[0]);
+
+    // As UTF-8 is self-synchronizing, a whole code point can only be found at the start
+    // of another one.
+    return std_strfind(chars->as_str, character) >= 0;
+}
+
+// Resolves a single `start` or `end` argument, which may be `None`, in the same way the
+// bounds of a slice are resolved. Returns an exception or NULL.
+static pyobj_t* resolve_bound(pyobj_t* bound, int length, int* out_index) {
+    if (bound == &py_none)
+        return NULL;
+
+    if (bound->type != &py_type_int)
+        return NEW_EXCEPTION_INLINE(TypeError, "slice indices must be integers or None");
+
+    if (!PY_INT_IS_SMALL(bound)) {
+        *out_index = bound->as_bigint->negative ? 0 : length;
+        return NULL;
+    }
+
+    int64_t index = bound->as_int;
+    if (index < 0) {
+        index = MAX(index + length, 0);
+    }
+
+    *out_index = (int)MIN(index, (int64_t)length);
+    return NULL;
+}
+
+// Resolves the optional `start` and `end` arguments of a `str` method in `argv`, which
+// are code point indices, to byte offsets. If `start` lies past the end of the string,
+// `out_start` is set to a value larger than its length in bytes, as some methods need to
+// tell that case apart from empty ranges. Returns an exception or NULL.
+static pyobj_t* resolve_bounds(pyobj_t* str, int argc, pyobj_t** argv, int* out_start, int* out_end) {
+    *out_start = 0;
+    *out_end = 0;
+
+    if (argc > 2)
+        return NEW_EXCEPTION_INLINE(TypeError, "expected at most 2 bounds");
+
+    int length = py_str_length(str);
+    int start = 0;
+    int end = length;
+
+    if (argc >= 1) {
+        pyobj_t* bound = NOT_NULL(argv)[0];
+
+        // A `start` past the end is not clamped, so that e.g. `"".find("", 1)` fails.
+        if (bound->type == &py_type_int && PY_INT_IS_SMALL(bound) && bound->as_int > length) {
+            start = -1;
+        }
+        else {
+            pyobj_t* exception = resolve_bound(bound, length, &start);
+            if (exception != NULL)
+                return exception;
+        }
+    }
+
+    if (argc == 2) {
+        pyobj_t* exception = resolve_bound(NOT_NULL(argv)[1], length, &end);
+        if (exception != NULL)
+            return exception;
+    }
+
+    *out_start = start < 0 ? str->as_str.length + 1 : py_str_offset(str, start);
+    *out_end = py_str_offset(str, end);
+    return NULL;
+}
+
+pyreturn_t py_str_find(pyobj_t* str, pyobj_t* sub, int argc, pyobj_t** argv, bool reverse) {
+    ENSURE_NOT_NULL(str);
+    ENSURE_NOT_NULL(sub);
+
+    if (sub->type != &py_type_str)
+        RAISE(TypeError, "must be str");
+
+    int start, end;
+    pyobj_t* exception = resolve_bounds(str, argc, argv, &start, &end);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    if (start > str->as_str.length || end - start < sub->as_str.length)
+        return WITH_RESULT(py_alloc_int(-1));
+
+    string_t range = substring(str->as_str, start, end);
+    int found = reverse
+        ? std_strrfind(range, sub->as_str)
+        : std_strfind(range, sub->as_str);
+
+    if (found < 0)
+        return WITH_RESULT(py_alloc_int(-1));
+
+    return WITH_RESULT(py_alloc_int(codepoint_index(str, start + found)));
+}
+
+pyreturn_t py_str_count(pyobj_t* str, pyobj_t* sub, int argc, pyobj_t** argv) {
+    ENSURE_NOT_NULL(str);
+    ENSURE_NOT_NULL(sub);
+
+    if (sub->type != &py_type_str)
+        RAISE(TypeError, "must be str");
+
+    int start, end;
+    pyobj_t* exception = resolve_bounds(str, argc, argv, &start, &end);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    if (start > str->as_str.length || end < start)
+        return WITH_RESULT(py_alloc_int(0));
+
+    // An empty substring occurs between every pair of code points, not bytes.
+    if (sub->as_str.length == 0) {
+        int codepoints = codepoint_index(str, end) - codepoint_index(str, start);
+        return WITH_RESULT(py_alloc_int(codepoints + 1));
+    }
+
+    size_t count = std_strcount(substring(str->as_str, start, end), sub->as_str);
+    return WITH_RESULT(py_alloc_int((int64_t)count));
+}
+
+pyreturn_t py_str_startswith(pyobj_t* str, pyobj_t* prefix, int argc, pyobj_t** argv, bool at_end) {
+    ENSURE_NOT_NULL(str);
+    ENSURE_NOT_NULL(prefix);
+
+    int start, end;
+    pyobj_t* exception = resolve_bounds(str, argc, argv, &start, &end);
+    if (exception != NULL)
+        return WITH_EXCEPTION(exception);
+
+    // A tuple matches if any of its elements do.
+    pyobj_t* const* candidates = &prefix;
+    size_t count = 1;
+
+    if (prefix->type == &py_type_tuple) {
+        candidates = prefix->as_list.elements;
+        count = prefix->as_list.length;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (NOT_NULL(candidates[i])->type != &py_type_str)
+            RAISE(TypeError, "first arg must be str or a tuple of str");
+
+        string_t candidate = candidates[i]->as_str;
+
+        if (start > str->as_str.length || end - start < candidate.length)
+            continue;
+
+        int offset = at_end ? end - candidate.length : start;
+        if (std_memequ(str->as_str.str + offset, candidate.str, (size_t)candidate.length))
+            return WITH_RESULT(&py_true);
+    }
+
+    return WITH_RESULT(&py_false);
+}
+
+// Splits the given string on runs of whitespace, like `str.split()` does.
+static pyobj_t* split_whitespace(pyobj_t* str, int64_t maxsplit) {
+    string_t s = str->as_str;
+    pyobj_t* list = py_alloc_list(0);
+    int i = 0;
+
+    while (true) {
+        while (i < s.length && is_space(s.str[i])) {
+            i++;
+        }
+
+        if (i == s.length)
+            return list;
+
+        // Once we've split enough times, the rest of the string - without its leading
+        // whitespace - is the last element.
+        if (maxsplit-- == 0) {
+            py_list_append(list, alloc_part(str, substring(s, i, s.length)));
+            return list;
+        }
+
+        int start = i;
+        while (i < s.length && !is_space(s.str[i])) {
+            i++;
+        }
+
+        py_list_append(list, alloc_part(str, substring(s, start, i)));
+    }
+}
+
+pyreturn_t py_str_split(pyobj_t* str, pyobj_t* sep, int64_t maxsplit) {
+    ENSURE_NOT_NULL(str);
+
+    if (sep == NULL || sep == &py_none)
+        return WITH_RESULT(split_whitespace(str, maxsplit));
+
+    if (sep->type != &py_type_str)
+        RAISE(TypeError, "must be str or None");
+
+    if (sep->as_str.length == 0)
+        RAISE(ValueError, "empty separator");
+
+    string_t rest = str->as_str;
+    string_t separator = sep->as_str;
+
+    // We know exactly how many elements we'll end up with if we don't have to stop early,
+    // so we count them first.
+    size_t count = std_strcount(rest, separator) + 1;
+    if (maxsplit >= 0 && (size_t)maxsplit + 1 < count) {
+        count = (size_t)maxsplit + 1;
+    }
+
+    pyobj_t* list = py_alloc_list(count);
+
+    for (size_t i = 0; i < count - 1; i++) {
+        int found = std_strfind(rest, separator);
+        ASSERT(found >= 0);
+
+        py_list_append(list, alloc_part(str, substring(rest, 0, found)));
+        rest = substring(rest, found + separator.length, rest.length);
+    }
+
+    py_list_append(list, alloc_part(str, rest));
+    return WITH_RESULT(list);
+}
+
+pyreturn_t py_str_replace(pyobj_t* str, pyobj_t* old, pyobj_t* new, int64_t count) {
+    ENSURE_NOT_NULL(str);
+    ENSURE_NOT_NULL(old);
+    ENSURE_NOT_NULL(new);
+
+    if (old->type != &py_type_str || new->type != &py_type_str)
+        RAISE(TypeError, "replace() arguments must be str");
+
+    string_t s = str->as_str;
+    string_t pattern = old->as_str;
+    string_t replacement = new->as_str;
+
+    // An empty pattern occurs between every pair of code points, not bytes.
+    size_t occurrences = pattern.length == 0
+        ? (size_t)py_str_length(str) + 1
+        : std_strcount(s, pattern);
+
+    if (count >= 0 && (size_t)count < occurrences) {
+        occurrences = (size_t)count;
+    }
+
+    if (occurrences == 0)
+        return WITH_RESULT(str);
+
+    size_t length = (size_t)s.length + occurrences * (size_t)replacement.length
+        - occurrences * (size_t)pattern.length;
+
+    int codepoints = py_str_length(str)
+        + (int)occurrences * (py_str_length(new) - py_str_length(old));
+
+    strbuilder_t* builder = std_strbuilder_alloc(length);
+
+    for (size_t i = 0; i < occurrences; i++) {
+        // An empty pattern occurs before every character, and at the very end. After the
+        // first replacement, we thus step over a single character each time.
+        int found = pattern.length == 0
+            ? (i == 0 ? 0 : std_utf8_sequence_length(s.str[0]))
+            : std_strfind(s, pattern);
+
+        ASSERT(found >= 0);
+
+        std_strbuilder_append(builder, substring(s, 0, found));
+        std_strbuilder_append(builder, replacement);
+        s = substring(s, found + pattern.length, s.length);
+    }
+
+    std_strbuilder_append(builder, s);
+
+    bool is_ascii = py_str_is_ascii(str) && py_str_is_ascii(new);
+    return WITH_RESULT(alloc_from_builder(builder, codepoints, is_ascii));
+}
+
+pyreturn_t py_str_strip(pyobj_t* str, pyobj_t* chars, bool left, bool right) {
+    ENSURE_NOT_NULL(str);
+
+    if (chars == &py_none) {
+        chars = NULL;
+    }
+
+    if (chars != NULL && chars->type != &py_type_str)
+        RAISE(TypeError, "strip arg must be None or str");
+
+    string_t s = str->as_str;
+    int start = 0;
+    int end = s.length;
+
+    if (left) {
+        while (start < end) {
+            int next = start + std_utf8_sequence_length(s.str[start]);
+            if (!should_strip(substring(s, start, next), chars))
+                break;
+
+            start = next;
+        }
+    }
+
+    if (right) {
+        while (end > start) {
+            // We walk back over the continuation bytes of the last code point.
+            int previous = end - 1;
+            while (previous > start && (s.str[previous] & 0xC0) == 0x80) {
+                previous--;
+            }
+
+            if (!should_strip(substring(s, previous, end), chars))
+                break;
+
+            end = previous;
+        }
+    }
+
+    if (start == 0 && end == s.length)
+        return WITH_RESULT(str);
+
+    return WITH_RESULT(alloc_part(str, substring(s, start, end)));
+}
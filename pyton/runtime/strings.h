@@ -0,0 +1,101 @@
+#pragma once
+
+#include "objects.h"
+#include "exceptions.h"
+#include "std/strbuilder.h"
+
+// Python `str` objects are immutable views over their characters (`as_str`). Strings that
+// were created by concatenation additionally point to the `strbuilder_t` that holds their
+// characters, in `str_builder`. Multiple strings may share the same builder - each one is
+// a prefix of its contents.
+//
+// When the left operand of `a + b` is the longest string in its builder, `b` is appended to
+// the builder in-place, and the result shares the builder with `a`. This makes repeatedly
+// appending to a string with `s += x` take amortized O(len(x)) time, as opposed to copying
+// `s` on every iteration. As the strings stay flat, nothing has to be done when they're
+// read.
+//
+// The contents of a `str` are encoded in UTF-8. Each `str` also caches the number of code
+// points it consists of, and whether all of them are ASCII characters, which are computed
+// in a single pass when it's created - or, for literals, when they're first needed. This
+// makes `len(s)` O(1). If a string is made up of ASCII characters only, each code point
+// is a single byte, and so indexing it is O(1) as well. Other strings build a sparse index
+// that holds the offset of every `PY_STR_INDEX_STRIDE`-th code point once they are first
+// indexed, from which we only have to walk over the remaining code points.
+
+// Set in `str_flags` once the string has been analyzed - i.e. `str_codepoints` and the
+// `PY_STR_ASCII` flag are valid.
+#define PY_STR_ANALYZED (1 << 0)
+
+// Set in `str_flags` if all characters of the string are ASCII characters.
+#define PY_STR_ASCII (1 << 1)
+
+// The number of code points between the entries of the sparse index of non-ASCII strings.
+#define PY_STR_INDEX_STRIDE 32
+
+// Computes the number of code points in the given `str`, and whether they are all ASCII
+// characters, if that hasn't been done yet.
+void py_str_analyze(pyobj_t* str);
+
+// Allocates a `str` with the given contents, which are already known to consist of
+// `codepoints` code points. This avoids the analysis `py_alloc_str` performs.
+pyobj_t* py_alloc_str_analyzed(string_t x, int codepoints, bool is_ascii);
+
+// Returns the number of code points in the given `str`, like Python's `len(str)`.
+int py_str_length(pyobj_t* str);
+
+// Returns `true` if all characters of the given `str` are ASCII characters.
+bool py_str_is_ascii(pyobj_t* str);
+
+// Returns the byte offset of the code point at the given index, which may also be equal to
+// the length of the string.
+int py_str_offset(pyobj_t* str, int index);
+
+// Implements `str[index]`, where `index` is an `int`.
+pyreturn_t py_str_getitem(pyobj_t* str, pyobj_t* index);
+
+// Converts the given object to a `str`, like Python's `str(x)`.
+pyreturn_t py_str_of(pyobj_t* x);
+
+// Implements `a + b`, where both operands are `str`s.
+pyobj_t* py_str_concat(pyobj_t* a, pyobj_t* b);
+
+// Concatenates the given `str`s into a new one, allocating its contents once.
+pyobj_t* py_str_build(pyobj_t** parts, int count);
+
+// Implements `separator.join(iterable)`.
+pyreturn_t py_str_join(pyobj_t* separator, pyobj_t* iterable);
+
+// Implements `str.find(sub[, start[, end]])`, or `str.rfind` if `reverse` is `true`. `argv`
+// holds the optional `start` and `end` arguments.
+pyreturn_t py_str_find(pyobj_t* str, pyobj_t* sub, int argc, pyobj_t** argv, bool reverse);
+
+// Implements `str.count(sub[, start[, end]])`. `argv` holds the optional `start` and `end`
+// arguments.
+pyreturn_t py_str_count(pyobj_t* str, pyobj_t* sub, int argc, pyobj_t** argv);
+
+// Implements `str.startswith(prefix[, start[, end]])`, or `str.endswith` if `at_end` is
+// `true`. `prefix` may also be a `tuple` of prefixes. `argv` holds the optional `start`
+// and `end` arguments.
+pyreturn_t py_str_startswith(pyobj_t* str, pyobj_t* prefix, int argc, pyobj_t** argv, bool at_end);
+
+// Implements `str.split(sep, maxsplit)`, where `sep` may be `NULL` or `None` to split on
+// runs of whitespace, and a negative `maxsplit` means that there is no limit.
+pyreturn_t py_str_split(pyobj_t* str, pyobj_t* sep, int64_t maxsplit);
+
+// Implements `str.replace(old, new, count)`, where a negative `count` replaces all
+// occurrences.
+pyreturn_t py_str_replace(pyobj_t* str, pyobj_t* old, pyobj_t* new, int64_t count);
+
+// Implements `str.strip(chars)`, where `chars` may be `NULL` or `None` to strip whitespace.
+// Only the start or the end of the string is stripped if `left` or `right` is `false`,
+// respectively.
+pyreturn_t py_str_strip(pyobj_t* str, pyobj_t* chars, bool left, bool right);
+
+// Returns the representation of the given `str`, like Python's `repr(str)`. If `ascii_only`
+// is `true`, all non-ASCII characters are escaped, like Python's `ascii(str)` does.
+pyobj_t* py_str_repr(pyobj_t* str, bool ascii_only);
+
+// Implements the conversions of f-string replacement fields - `{x!s}` if `conversion` is
+// 1, and `{x!r}` or `{x!a}` if it's 2 or 3, respectively.
+pyreturn_t py_str_convert(pyobj_t* x, int conversion);
@@ -28,6 +28,12 @@ static volatile struct limine_framebuffer_request framebuffer_request = {
     .revision = 0
 };
 
+__attribute__((used, section(".limine_requests")))
+static volatile struct limine_kernel_file_request kernel_file_request = {
+    .id = LIMINE_KERNEL_FILE_REQUEST,
+    .revision = 0
+};
+
 __attribute__((used, section(".limine_requests_start")))
 static volatile LIMINE_REQUESTS_START_MARKER;
 
@@ -63,4 +69,12 @@ bl_framebuffer_t bl_get_framebuffer(void) {
     }
 
     return framebuffer_request.response->framebuffers[0];
+}
+
+const char* bl_get_cmdline(void) {
+    if (kernel_file_request.response == NULL)
+        return "";
+
+    const char* cmdline = kernel_file_request.response->kernel_file->cmdline;
+    return cmdline == NULL ? "" : cmdline;
 } 
\ No newline at end of file
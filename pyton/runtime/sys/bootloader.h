@@ -30,3 +30,7 @@ bl_memmap_entry_t* bl_get_memmap_entries(void);
 
 // Gets the framebuffer for the primary display device.
 bl_framebuffer_t bl_get_framebuffer(void);
+
+// Gets the command line the kernel was booted with, i.e. the `cmdline` option of its
+// entry in `limine.conf`. Returns an empty string if there isn't one.
+const char* bl_get_cmdline(void);
@@ -0,0 +1,128 @@
+#include "clock.h"
+
+#include "cpu.h"
+#include "io.h"
+#include "timer.h"
+#include "terminal.h"
+#include "interrupts.h"
+
+#define PIT_CHANNEL2 0x42
+#define PIT_COMMAND  0x43
+
+// Channel 2, lobyte/hibyte access, mode 0 (interrupt on terminal count), binary.
+#define PIT_MODE_ONE_SHOT 0xB0
+
+// Port 0x61 controls the gate of channel 2 (bit 0) and the PC speaker (bit 1), and
+// reflects the output of channel 2 (bit 5).
+#define PIT_GATE_PORT    0x61
+#define PIT_GATE_CH2     0x01
+#define PIT_GATE_SPEAKER 0x02
+#define PIT_GATE_OUT2    0x20
+
+// The number of times the output of channel 2 is polled before we give up on a run. As
+// each `in` takes about a microsecond, this is at least a hundred times the expected wait.
+#define CALIBRATION_MAX_POLLS 1000000
+
+#define NS_PER_TICK (1000000000 / TIMER_HZ)
+
+static clock_info_t info;
+
+// The time-stamp counter at the end of calibration, which is where the clock starts.
+static uint64_t tsc_origin;
+
+// Nanoseconds per cycle of the time-stamp counter, as a 32.32 fixed-point value.
+static uint64_t ns_per_cycle;
+
+// Reads the time-stamp counter. The `lfence` keeps the read from being executed before
+// any preceding instructions.
+static inline uint64_t read_tsc(void) {
+    uint32_t low, high;
+    __asm__ volatile ("lfence; rdtsc" : "=a"(low), "=d"(high) :: "memory");
+    return ((uint64_t)high << 32) | low;
+}
+
+// Returns the number of time-stamp counter cycles that channel 2 of the PIT takes to
+// count down `CLOCK_CALIBRATION_CYCLES` cycles, or 0 if its output never went high.
+static uint64_t calibration_run(void) {
+    uint8_t gate = io_inb(PIT_GATE_PORT);
+    io_outb(PIT_GATE_PORT, (gate & ~PIT_GATE_SPEAKER) | PIT_GATE_CH2);
+
+    // Channel 2 starts counting down as soon as the count has been written, and its output
+    // stays low until it reaches zero.
+    io_outb(PIT_COMMAND, PIT_MODE_ONE_SHOT);
+    io_outb(PIT_CHANNEL2, CLOCK_CALIBRATION_CYCLES & 0xFF);
+    io_outb(PIT_CHANNEL2, CLOCK_CALIBRATION_CYCLES >> 8);
+
+    uint64_t start = read_tsc();
+    uint64_t cycles = 0;
+
+    for (int i = 0; i < CALIBRATION_MAX_POLLS; i++) {
+        if ((io_inb(PIT_GATE_PORT) & PIT_GATE_OUT2) != 0) {
+            cycles = read_tsc() - start;
+            break;
+        }
+    }
+
+    io_outb(PIT_GATE_PORT, gate);
+    return cycles;
+}
+
+void clock_init(void) {
+    const cpu_features_t* features = cpu_get_features();
+    info.source = CLOCK_SOURCE_TIMER;
+
+    if (!features->tsc)
+        return;
+
+    uint64_t shortest = UINT64_MAX;
+    for (int i = 0; i < CLOCK_CALIBRATION_RUNS; i++) {
+        uint64_t cycles = calibration_run();
+        if (cycles == 0)
+            return; // channel 2 isn't there, keep using the timer
+
+        shortest = cycles < shortest ? cycles : shortest;
+    }
+
+    // The numerator can't overflow for any frequency below ~1 PHz.
+    info.tsc_frequency = shortest * PIT_BASE_FREQUENCY / CLOCK_CALIBRATION_CYCLES;
+    info.invariant = features->invariant_tsc;
+
+    if (info.tsc_frequency == 0)
+        return;
+
+    ns_per_cycle = (1000000000ull << 32) / info.tsc_frequency;
+    tsc_origin = read_tsc();
+    info.source = CLOCK_SOURCE_TSC;
+}
+
+clock_info_t clock_get_info(void) {
+    return info;
+}
+
+uint64_t clock_now_ns(void) {
+    if (info.source != CLOCK_SOURCE_TSC)
+        return timer_ticks() * NS_PER_TICK;
+
+    uint64_t cycles = read_tsc() - tsc_origin;
+    return (uint64_t)(((unsigned __int128)cycles * ns_per_cycle) >> 32);
+}
+
+void clock_sleep_ns(uint64_t ns) {
+    uint64_t start = clock_now_ns();
+    uint64_t deadline = start + ns < start ? UINT64_MAX : start + ns;
+
+    while (true) {
+        uint64_t now = clock_now_ns();
+        if (now >= deadline)
+            return;
+
+        // The next tick arrives within `NS_PER_TICK`, and wakes us up before the deadline.
+        if (deadline - now > NS_PER_TICK && int_are_enabled()) {
+            terminal_poll();
+            int_wait();
+        }
+        else {
+            __builtin_ia32_pause();
+        }
+    }
+}
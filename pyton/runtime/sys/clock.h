@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// The monotonic clock. When the processor has a time-stamp counter, the clock is derived
+// from it, after measuring its frequency against the PIT at boot - which yields a
+// resolution of a fraction of a nanosecond, at the cost of a single `rdtsc`. Otherwise,
+// the clock advances with the ticks of the system timer (see `timer.h`).
+
+// The sources the monotonic clock can be derived from.
+typedef enum clock_source {
+    CLOCK_SOURCE_TIMER, // the ticks of the system timer
+    CLOCK_SOURCE_TSC    // the time-stamp counter
+} clock_source_t;
+
+// Describes the outcome of the calibration performed by `clock_init`.
+typedef struct clock_info {
+    clock_source_t source;
+
+    // The frequency of the time-stamp counter, in Hz, or 0 if it isn't used.
+    uint64_t tsc_frequency;
+
+    // `true` if the time-stamp counter runs at a constant rate in all power states. If it
+    // doesn't, the clock may drift when the processor changes its frequency.
+    bool invariant;
+} clock_info_t;
+
+// The length of a single calibration run, in PIT input clock cycles (about 10 ms).
+#define CLOCK_CALIBRATION_CYCLES 11932
+
+// The number of calibration runs. The shortest one is used, as anything that delays our
+// observation of the end of a run (e.g. an SMI) can only make it longer.
+#define CLOCK_CALIBRATION_RUNS 3
+
+// Measures the frequency of the time-stamp counter against channel 2 of the PIT, and
+// selects the clock source. Must be called before interrupts are enabled, so that they
+// don't disturb the measurement.
+void clock_init(void);
+
+// Returns the outcome of the calibration performed by `clock_init`.
+clock_info_t clock_get_info(void);
+
+// Returns the number of nanoseconds since `clock_init` was called.
+uint64_t clock_now_ns(void);
+
+// Waits until at least `ns` nanoseconds have passed. The processor is halted until the
+// last timer tick before the deadline, and the remainder is spent spinning. Requires
+// interrupts to be enabled for the halting part - otherwise, the whole wait is spent spinning.
+void clock_sleep_ns(uint64_t ns);
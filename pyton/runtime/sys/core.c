@@ -1,6 +1,8 @@
 #include "core.h"
 
 #include <stddef.h>
+#include <stdbool.h>
+#include "clock.h"
 #include "terminal.h"
 
 noreturn void sys_panic(const char* message) {
@@ -13,5 +15,23 @@ noreturn void sys_panic(const char* message) {
         terminal_println(message);
     }
 
-    while (true) {}
-}
\ No newline at end of file
+    sys_halt();
+}
+
+noreturn void sys_halt(void) {
+    // Whatever is still buffered or queued for transmission would otherwise be lost, as
+    // interrupts are about to be disabled for good.
+    if (terminal_is_initialized()) {
+        terminal_sync();
+    }
+
+    // With interrupts disabled, `hlt` only returns on NMIs or SMIs - so we loop in
+    // case one of those wakes us up.
+    while (true) {
+        __asm__ volatile ("cli; hlt");
+    }
+}
+
+uint64_t sys_now_ns(void) {
+    return clock_now_ns();
+}
@@ -1,8 +1,17 @@
 #pragma once
 
+#include <stdint.h>
 #include <stdnoreturn.h>
 
 // Called when something goes very wrong. Currently, this is used instead of exceptions.
 // When `sys_panic` is called, the system cannot recover, and must be restarted in order
 // to continue.
 noreturn void sys_panic(const char* message);
+
+// Disables interrupts and halts the processor indefinitely. Unlike a busy loop, this
+// leaves the CPU idle.
+noreturn void sys_halt(void);
+
+// Returns the number of nanoseconds since boot, from the monotonic clock (see `clock.h`).
+// This is what runtime subsystems should use to measure time.
+uint64_t sys_now_ns(void);
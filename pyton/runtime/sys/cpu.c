@@ -0,0 +1,93 @@
+#include "cpu.h"
+
+#include <stdint.h>
+
+#define CR0_MP (1ull << 1)  // monitor co-processor
+#define CR0_EM (1ull << 2)  // x87 emulation
+#define CR0_TS (1ull << 3)  // task switched
+#define CR0_NE (1ull << 5)  // native x87 exceptions
+
+#define CR4_OSFXSR     (1ull << 9)  // FXSAVE/FXRSTOR and SSE instructions
+#define CR4_OSXMMEXCPT (1ull << 10) // unmasked SSE exceptions raise #XM
+#define CR4_OSXSAVE    (1ull << 18) // XSAVE and XGETBV/XSETBV
+
+#define XCR0_X87 (1ull << 0)
+#define XCR0_SSE (1ull << 1)
+#define XCR0_AVX (1ull << 2)
+
+static cpu_features_t cpu_features;
+
+static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t* a, uint32_t* b, uint32_t* c, uint32_t* d) {
+    __asm__ volatile ("cpuid" : "=a"(*a), "=b"(*b), "=c"(*c), "=d"(*d) : "a"(leaf), "c"(subleaf));
+}
+
+static uint64_t read_cr0(void) {
+    uint64_t value;
+    __asm__ volatile ("mov %0, cr0" : "=r"(value));
+    return value;
+}
+
+static void write_cr0(uint64_t value) {
+    __asm__ volatile ("mov cr0, %0" :: "r"(value) : "memory");
+}
+
+static uint64_t read_cr4(void) {
+    uint64_t value;
+    __asm__ volatile ("mov %0, cr4" : "=r"(value));
+    return value;
+}
+
+static void write_cr4(uint64_t value) {
+    __asm__ volatile ("mov cr4, %0" :: "r"(value) : "memory");
+}
+
+static void write_xcr0(uint64_t value) {
+    __asm__ volatile ("xsetbv" :: "c"(0), "a"((uint32_t)value), "d"((uint32_t)(value >> 32)));
+}
+
+void cpu_init(void) {
+    uint32_t max_leaf, a, b, c, d;
+    cpuid(0, 0, &max_leaf, &b, &c, &d);
+    cpuid(1, 0, &a, &b, &c, &d);
+
+    // x86-64 guarantees SSE and SSE2, so we only have to switch them on.
+    write_cr0((read_cr0() & ~(CR0_EM | CR0_TS)) | CR0_MP | CR0_NE);
+    write_cr4(read_cr4() | CR4_OSFXSR | CR4_OSXMMEXCPT);
+    __asm__ volatile ("fninit");
+
+    cpu_features.sse3 = (c & (1 << 0)) != 0;
+    cpu_features.ssse3 = (c & (1 << 9)) != 0;
+    cpu_features.sse41 = (c & (1 << 19)) != 0;
+    cpu_features.sse42 = (c & (1 << 20)) != 0;
+    cpu_features.popcnt = (c & (1 << 23)) != 0;
+    cpu_features.xsave = (c & (1 << 26)) != 0;
+    cpu_features.pat = (d & (1 << 16)) != 0;
+    cpu_features.tsc = (d & (1 << 4)) != 0;
+
+    uint32_t max_extended_leaf, unused, power_management;
+    cpuid(0x80000000, 0, &max_extended_leaf, &unused, &unused, &unused);
+
+    if (max_extended_leaf >= 0x80000007) {
+        cpuid(0x80000007, 0, &unused, &unused, &unused, &power_management);
+        cpu_features.invariant_tsc = (power_management & (1 << 8)) != 0;
+    }
+
+    if (!cpu_features.xsave)
+        return;
+
+    // The AVX register state can only be enabled through XCR0.
+    write_cr4(read_cr4() | CR4_OSXSAVE);
+
+    bool has_avx = (c & (1 << 28)) != 0;
+    write_xcr0(XCR0_X87 | XCR0_SSE | (has_avx ? XCR0_AVX : 0));
+    cpu_features.avx = has_avx;
+
+    if (has_avx && max_leaf >= 7) {
+        cpuid(7, 0, &a, &b, &c, &d);
+        cpu_features.avx2 = (b & (1 << 5)) != 0;
+    }
+}
+
+const cpu_features_t* cpu_get_features(void) {
+    return &cpu_features;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdbool.h>
+
+// Represents the optional instruction set extensions the processor supports. A feature
+// is only reported if the state it requires has also been enabled by `cpu_init`.
+typedef struct cpu_features {
+    bool sse3;
+    bool ssse3;
+    bool sse41;
+    bool sse42;
+    bool popcnt;
+    bool xsave;
+    bool avx;
+    bool avx2;
+    bool pat;
+    bool tsc;
+
+    // `true` if the time-stamp counter runs at a constant rate in all power states.
+    bool invariant_tsc;
+} cpu_features_t;
+
+// Enables the x87 FPU and SSE, and, if supported, XSAVE and the AVX register state.
+// The runtime is compiled with SSE2, so this must be called before any other code runs.
+void cpu_init(void);
+
+// Returns the instruction set extensions available to the runtime.
+const cpu_features_t* cpu_get_features(void);
+
+// Compiles a function for processors with AVX2 or SSE4.1. Such functions may only be
+// called once `cpu_get_features` has reported the extension.
+#define AVX2 __attribute__((target("avx2")))
+#define SSE41 __attribute__((target("sse4.1")))
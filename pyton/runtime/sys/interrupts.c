@@ -0,0 +1,309 @@
+#include "interrupts.h"
+
+#include <stddef.h>
+#include "core.h"
+#include "io.h"
+#include "std/safety.h"
+
+#define PIC1_COMMAND 0x20
+#define PIC1_DATA    0x21
+#define PIC2_COMMAND 0xA0
+#define PIC2_DATA    0xA1
+
+#define PIC_EOI        0x20
+#define PIC_READ_ISR   0x0B
+#define PIC_ICW1_INIT  0x11 // initialization, ICW4 will be present
+#define PIC_ICW4_8086  0x01
+
+// The number of vectors we provide entry stubs for - CPU exceptions, followed by IRQs.
+#define INT_STUB_COUNT (INT_IRQ_BASE + INT_IRQ_COUNT)
+
+typedef struct __attribute__((packed)) idt_entry {
+    uint16_t offset_low;
+    uint16_t selector;
+    uint8_t ist;
+    uint8_t flags;
+    uint16_t offset_mid;
+    uint32_t offset_high;
+    uint32_t reserved;
+} idt_entry_t;
+
+typedef struct __attribute__((packed)) idt_descriptor {
+    uint16_t limit;
+    uint64_t base;
+} idt_descriptor_t;
+
+// Present, DPL 0, 64-bit interrupt gate (interrupts are disabled on entry).
+#define IDT_GATE_INTERRUPT 0x8E
+
+static idt_entry_t idt[256];
+static int_irq_handler_t irq_handlers[INT_IRQ_COUNT];
+
+// Mirrors the mask registers of both PICs (bit N = IRQ N). We start with everything masked,
+// except for the cascade line (IRQ 2), which connects the secondary PIC to the primary one.
+static uint16_t irq_mask = 0xFFFF & ~(1 << 2);
+
+static const char* exception_names[INT_IRQ_BASE] = {
+    "CPU exception: division error",
+    "CPU exception: debug",
+    "CPU exception: non-maskable interrupt",
+    "CPU exception: breakpoint",
+    "CPU exception: overflow",
+    "CPU exception: bound range exceeded",
+    "CPU exception: invalid opcode",
+    "CPU exception: device not available",
+    "CPU exception: double fault",
+    "CPU exception: coprocessor segment overrun",
+    "CPU exception: invalid TSS",
+    "CPU exception: segment not present",
+    "CPU exception: stack-segment fault",
+    "CPU exception: general protection fault",
+    "CPU exception: page fault",
+    "CPU exception: reserved (15)",
+    "CPU exception: x87 floating-point exception",
+    "CPU exception: alignment check",
+    "CPU exception: machine check",
+    "CPU exception: SIMD floating-point exception",
+    "CPU exception: virtualization exception",
+    "CPU exception: control protection exception",
+    "CPU exception: reserved (22)",
+    "CPU exception: reserved (23)",
+    "CPU exception: reserved (24)",
+    "CPU exception: reserved (25)",
+    "CPU exception: reserved (26)",
+    "CPU exception: reserved (27)",
+    "CPU exception: hypervisor injection exception",
+    "CPU exception: VMM communication exception",
+    "CPU exception: security exception",
+    "CPU exception: reserved (31)"
+};
+
+// Entry stubs. Each stub normalizes the stack so that it always holds an error code (the CPU
+// only pushes one for some exceptions), pushes its vector number, and then jumps to the common
+// stub, which saves the general-purpose registers and calls `int_dispatch` with a pointer
+// to the resulting `int_frame_t`.
+//
+// The runtime is compiled with SSE enabled, so handlers may clobber the x87/SSE registers
+// of the interrupted code - the common stub saves them with `fxsave` below the frame. We
+// never use AVX in handlers, and legacy SSE instructions leave the upper halves of the
+// YMM registers untouched, so `fxsave` is enough even when AVX is enabled.
+//
+// On entry, the CPU aligns the stack to 16 bytes before pushing the 5-qword interrupt frame.
+// Together with the error code, vector, and 15 saved registers, that's 22 qwords - so the
+// stack remains aligned for `fxsave` (which requires it) and when calling into C.
+#define INT_STUB_NOERR($n)                              \
+    ".global int_stub_" #$n "\n"                        \
+    "int_stub_" #$n ":\n"                               \
+    "    push 0\n"                                      \
+    "    push " #$n "\n"                                \
+    "    jmp int_stub_common\n"
+
+#define INT_STUB_ERR($n)                                \
+    ".global int_stub_" #$n "\n"                        \
+    "int_stub_" #$n ":\n"                               \
+    "    push " #$n "\n"                                \
+    "    jmp int_stub_common\n"
+
+__asm__ (
+    ".section .text\n"
+    "int_stub_common:\n"
+    "    push rax\n"
+    "    push rcx\n"
+    "    push rdx\n"
+    "    push rbx\n"
+    "    push rbp\n"
+    "    push rsi\n"
+    "    push rdi\n"
+    "    push r8\n"
+    "    push r9\n"
+    "    push r10\n"
+    "    push r11\n"
+    "    push r12\n"
+    "    push r13\n"
+    "    push r14\n"
+    "    push r15\n"
+    "    mov rdi, rsp\n"
+    "    sub rsp, 512\n"
+    "    fxsave [rsp]\n"
+    "    cld\n"
+    "    call int_dispatch\n"
+    "    fxrstor [rsp]\n"
+    "    add rsp, 512\n"
+    "    pop r15\n"
+    "    pop r14\n"
+    "    pop r13\n"
+    "    pop r12\n"
+    "    pop r11\n"
+    "    pop r10\n"
+    "    pop r9\n"
+    "    pop r8\n"
+    "    pop rdi\n"
+    "    pop rsi\n"
+    "    pop rbp\n"
+    "    pop rbx\n"
+    "    pop rdx\n"
+    "    pop rcx\n"
+    "    pop rax\n"
+    "    add rsp, 16\n" // vector + error code
+    "    iretq\n"
+
+    INT_STUB_NOERR(0)  INT_STUB_NOERR(1)  INT_STUB_NOERR(2)  INT_STUB_NOERR(3)
+    INT_STUB_NOERR(4)  INT_STUB_NOERR(5)  INT_STUB_NOERR(6)  INT_STUB_NOERR(7)
+    INT_STUB_ERR(8)    INT_STUB_NOERR(9)  INT_STUB_ERR(10)   INT_STUB_ERR(11)
+    INT_STUB_ERR(12)   INT_STUB_ERR(13)   INT_STUB_ERR(14)   INT_STUB_NOERR(15)
+    INT_STUB_NOERR(16) INT_STUB_ERR(17)   INT_STUB_NOERR(18) INT_STUB_NOERR(19)
+    INT_STUB_NOERR(20) INT_STUB_ERR(21)   INT_STUB_NOERR(22) INT_STUB_NOERR(23)
+    INT_STUB_NOERR(24) INT_STUB_NOERR(25) INT_STUB_NOERR(26) INT_STUB_NOERR(27)
+    INT_STUB_NOERR(28) INT_STUB_ERR(29)   INT_STUB_ERR(30)   INT_STUB_NOERR(31)
+    INT_STUB_NOERR(32) INT_STUB_NOERR(33) INT_STUB_NOERR(34) INT_STUB_NOERR(35)
+    INT_STUB_NOERR(36) INT_STUB_NOERR(37) INT_STUB_NOERR(38) INT_STUB_NOERR(39)
+    INT_STUB_NOERR(40) INT_STUB_NOERR(41) INT_STUB_NOERR(42) INT_STUB_NOERR(43)
+    INT_STUB_NOERR(44) INT_STUB_NOERR(45) INT_STUB_NOERR(46) INT_STUB_NOERR(47)
+
+    ".section .rodata\n"
+    ".balign 8\n"
+    "int_stub_table:\n"
+    "    .quad int_stub_0,  int_stub_1,  int_stub_2,  int_stub_3\n"
+    "    .quad int_stub_4,  int_stub_5,  int_stub_6,  int_stub_7\n"
+    "    .quad int_stub_8,  int_stub_9,  int_stub_10, int_stub_11\n"
+    "    .quad int_stub_12, int_stub_13, int_stub_14, int_stub_15\n"
+    "    .quad int_stub_16, int_stub_17, int_stub_18, int_stub_19\n"
+    "    .quad int_stub_20, int_stub_21, int_stub_22, int_stub_23\n"
+    "    .quad int_stub_24, int_stub_25, int_stub_26, int_stub_27\n"
+    "    .quad int_stub_28, int_stub_29, int_stub_30, int_stub_31\n"
+    "    .quad int_stub_32, int_stub_33, int_stub_34, int_stub_35\n"
+    "    .quad int_stub_36, int_stub_37, int_stub_38, int_stub_39\n"
+    "    .quad int_stub_40, int_stub_41, int_stub_42, int_stub_43\n"
+    "    .quad int_stub_44, int_stub_45, int_stub_46, int_stub_47\n"
+    ".section .text\n"
+);
+
+extern const uint64_t int_stub_table[INT_STUB_COUNT];
+
+static void pic_write_mask(void) {
+    io_outb(PIC1_DATA, irq_mask & 0xFF);
+    io_outb(PIC2_DATA, irq_mask >> 8);
+}
+
+static void pic_init(void) {
+    // Remap both PICs so that IRQs don't overlap with the CPU exception vectors.
+    io_outb(PIC1_COMMAND, PIC_ICW1_INIT); io_wait();
+    io_outb(PIC2_COMMAND, PIC_ICW1_INIT); io_wait();
+    io_outb(PIC1_DATA, INT_IRQ_BASE);     io_wait(); // ICW2: vector offset
+    io_outb(PIC2_DATA, INT_IRQ_BASE + 8); io_wait();
+    io_outb(PIC1_DATA, 1 << 2);           io_wait(); // ICW3: secondary PIC is on IRQ 2
+    io_outb(PIC2_DATA, 2);                io_wait(); // ICW3: cascade identity
+    io_outb(PIC1_DATA, PIC_ICW4_8086);    io_wait();
+    io_outb(PIC2_DATA, PIC_ICW4_8086);    io_wait();
+
+    pic_write_mask();
+}
+
+// Returns `true` if the given IRQ line is actually being serviced. The PICs raise IRQ 7
+// (or IRQ 15) spuriously when a line gets de-asserted before the CPU acknowledges it.
+static bool pic_is_genuine(int irq) {
+    if (irq != 7 && irq != 15)
+        return true;
+
+    uint16_t port = irq == 7 ? PIC1_COMMAND : PIC2_COMMAND;
+    io_outb(port, PIC_READ_ISR);
+    return (io_inb(port) & (1 << 7)) != 0;
+}
+
+static void pic_send_eoi(int irq) {
+    if (irq >= 8) {
+        io_outb(PIC2_COMMAND, PIC_EOI);
+    }
+
+    io_outb(PIC1_COMMAND, PIC_EOI);
+}
+
+// Called by `int_stub_common`.
+void int_dispatch(int_frame_t* frame);
+
+void int_dispatch(int_frame_t* frame) {
+    if (frame->vector < INT_IRQ_BASE) {
+        sys_panic(exception_names[frame->vector]);
+    }
+
+    int irq = (int)frame->vector - INT_IRQ_BASE;
+
+    if (!pic_is_genuine(irq)) {
+        // A spurious IRQ 15 still needs an EOI for the primary PIC, as it did
+        // see a genuine IRQ 2 from the secondary one.
+        if (irq == 15) {
+            io_outb(PIC1_COMMAND, PIC_EOI);
+        }
+
+        return;
+    }
+
+    if (irq_handlers[irq] != NULL) {
+        irq_handlers[irq](irq);
+    }
+
+    pic_send_eoi(irq);
+}
+
+void int_init(void) {
+    uint16_t code_selector;
+    __asm__ volatile ("mov %0, cs" : "=r"(code_selector));
+
+    for (int i = 0; i < INT_STUB_COUNT; i++) {
+        uint64_t handler = int_stub_table[i];
+
+        idt[i] = (idt_entry_t) {
+            .offset_low = handler & 0xFFFF,
+            .selector = code_selector,
+            .ist = 0,
+            .flags = IDT_GATE_INTERRUPT,
+            .offset_mid = (handler >> 16) & 0xFFFF,
+            .offset_high = handler >> 32,
+            .reserved = 0
+        };
+    }
+
+    idt_descriptor_t descriptor = {
+        .limit = sizeof(idt) - 1,
+        .base = (uint64_t)&idt
+    };
+
+    __asm__ volatile ("lidt %0" : : "m"(descriptor) : "memory");
+
+    pic_init();
+}
+
+void int_set_irq_handler(int irq, int_irq_handler_t handler) {
+    ASSERT(irq >= 0 && irq < INT_IRQ_COUNT);
+
+    irq_handlers[irq] = handler;
+
+    if (handler != NULL) {
+        irq_mask &= ~(1 << irq);
+    }
+    else if (irq != 2) {
+        irq_mask |= (1 << irq);
+    }
+
+    pic_write_mask();
+}
+
+void int_enable(void) {
+    __asm__ volatile ("sti" ::: "memory");
+}
+
+void int_disable(void) {
+    __asm__ volatile ("cli" ::: "memory");
+}
+
+bool int_are_enabled(void) {
+    uint64_t rflags;
+    __asm__ volatile ("pushfq; pop %0" : "=r"(rflags) : : "memory");
+    return (rflags & (1 << 9)) != 0; // IF
+}
+
+void int_wait(void) {
+    // `sti` only takes effect after the next instruction, so an interrupt cannot be
+    // delivered in-between the two.
+    __asm__ volatile ("sti; hlt" ::: "memory");
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// The vector that the first hardware IRQ line (IRQ 0) is remapped to. The vectors before
+// this one are reserved for CPU exceptions.
+#define INT_IRQ_BASE 32
+
+// The number of IRQ lines provided by the (chained) legacy 8259 PICs.
+#define INT_IRQ_COUNT 16
+
+// Represents the state of the interrupted context, as pushed by the interrupt entry stubs.
+typedef struct int_frame {
+    uint64_t r15, r14, r13, r12, r11, r10, r9, r8;
+    uint64_t rdi, rsi, rbp, rbx, rdx, rcx, rax;
+    uint64_t vector;
+    uint64_t error_code;
+    uint64_t rip, cs, rflags, rsp, ss;
+} int_frame_t;
+
+// Represents a handler for a hardware IRQ. Handlers run with interrupts disabled, and must
+// not allocate memory or call into Python code - they should only record that an event
+// happened, and let the code running outside of the interrupt context react to it.
+typedef void (*int_irq_handler_t)(int irq);
+
+// Sets up the IDT and remaps the legacy PICs. All IRQ lines start out masked, and
+// interrupts stay disabled until `int_enable` is called.
+void int_init(void);
+
+// Registers a handler for the given IRQ line, and unmasks it. Passing `NULL` as the
+// handler masks the line again.
+void int_set_irq_handler(int irq, int_irq_handler_t handler);
+
+// Enables maskable interrupts.
+void int_enable(void);
+
+// Disables maskable interrupts.
+void int_disable(void);
+
+// Returns `true` if maskable interrupts are enabled, i.e. if the caller isn't running in
+// the interrupt context, or in a section that has disabled them.
+bool int_are_enabled(void);
+
+// Enables interrupts and halts the processor until the next interrupt arrives. When
+// called with interrupts disabled, there is no window between checking for pending work
+// and halting in which an interrupt could get lost.
+void int_wait(void);
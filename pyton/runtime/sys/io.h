@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+
+// Port-mapped I/O primitives. The runtime is compiled with `-masm=intel`, and so are
+// the assembly templates below - this header should not be consumed from transpiled code.
+
+// Writes a single byte to the given I/O port.
+static inline void io_outb(uint16_t port, uint8_t value) {
+    __asm__ volatile ("out dx, al" : : "a"(value), "d"(port) : "memory");
+}
+
+// Reads a single byte from the given I/O port.
+static inline uint8_t io_inb(uint16_t port) {
+    uint8_t value;
+    __asm__ volatile ("in al, dx" : "=a"(value) : "d"(port) : "memory");
+    return value;
+}
+
+// Waits a very small amount of time (1 to 4 microseconds), by writing to an unused port.
+// Used by legacy devices (e.g. the 8259 PIC) that need some time to react to commands.
+static inline void io_wait(void) {
+    io_outb(0x80, 0);
+}
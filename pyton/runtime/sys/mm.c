@@ -94,19 +94,82 @@ void* mm_phys_to_virt(physaddr_t address) {
     return (void*)(bl_get_hhdm_start() + address);
 }
 
+// Allocates `count` pages that are contiguous in memory. Pages freed via `mm_page_free`
+// are appended to the end of the free-list, so the start of the list usually consists of
+// long runs of untouched, ascending pages.
+static void* mm_page_alloc_contiguous(size_t count) {
+    mm_freelist_entry_t* prev = NULL;
+    mm_freelist_entry_t* run_start = NULL;
+    mm_freelist_entry_t* before_run = NULL; // the entry that precedes `run_start`
+    size_t run_length = 0;
+
+    for (mm_freelist_entry_t* entry = mm_freelist_first; entry != NULL; prev = entry, entry = entry->next) {
+        if (run_length != 0 && (size_t)entry == (size_t)prev + PAGE_SIZE) {
+            run_length++;
+        }
+        else {
+            run_start = entry;
+            before_run = prev;
+            run_length = 1;
+        }
+
+        if (run_length != count)
+            continue;
+
+        // Unlink the whole run from the free-list.
+        if (before_run == NULL) {
+            mm_freelist_first = entry->next;
+        }
+        else {
+            before_run->next = entry->next;
+        }
+
+        if (mm_freelist_last == entry) {
+            mm_freelist_last = before_run;
+        }
+
+        return run_start;
+    }
+
+    sys_panic("Out of contiguous physical memory.");
+}
+
+// Precedes allocations that span multiple pages. Such allocations are never page-aligned,
+// which is how `mm_heap_free` tells them apart from single-page ones.
+typedef struct mm_multipage_header {
+    size_t page_count;
+    size_t _reserved; // keeps the returned pointer 16-byte aligned
+} mm_multipage_header_t;
+
 void* mm_heap_alloc(size_t count) {
     ENSURE_INITIALIZED("mm_alloc");
 
     // TODO: Actual heap allocator
-    // Right now we fail for allocs > 4KiB since we just forward everything to the page allocator.
-    // This will most probably change in the future
-    if (count <= 4096) {
+    // Right now we just forward everything to the page allocator - small allocations
+    // get a whole page, and larger ones get a run of contiguous pages.
+    if (count <= PAGE_SIZE) {
         return mm_page_alloc();
     }
 
-    sys_panic("Allocations larger than 4KiB aren't supported.");
+    size_t page_count = (count + sizeof(mm_multipage_header_t) + PAGE_SIZE - 1) / PAGE_SIZE;
+    mm_multipage_header_t* header = mm_page_alloc_contiguous(page_count);
+    header->page_count = page_count;
+    return header + 1;
 }
 
 void mm_heap_free(void* ptr) {
-    mm_page_free(NOT_NULL(ptr));
-}
\ No newline at end of file
+    ENSURE_NOT_NULL(ptr);
+
+    if ((size_t)ptr % PAGE_SIZE == 0) {
+        mm_page_free(ptr);
+        return;
+    }
+
+    mm_multipage_header_t* header = (mm_multipage_header_t*)ptr - 1;
+    ASSERT((size_t)header % PAGE_SIZE == 0);
+
+    size_t page_count = header->page_count;
+    for (size_t i = 0; i < page_count; i++) {
+        mm_page_free((char*)header + (i * PAGE_SIZE));
+    }
+}
\ No newline at end of file
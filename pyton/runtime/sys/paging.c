@@ -0,0 +1,102 @@
+#include "paging.h"
+
+#include <stdint.h>
+#include "cpu.h"
+#include "mm.h"
+
+#define MSR_IA32_PAT 0x277
+
+// The PAT entry we use for write-combining mappings, and the memory type we program into
+// it. Entries 0 to 3, which are selected by all mappings that don't set the PAT bit, are
+// left alone.
+#define PAT_WC_INDEX 5
+#define PAT_TYPE_WC  0x01
+
+#define PTE_PRESENT   (1ull << 0)
+#define PTE_PWT       (1ull << 3)
+#define PTE_PCD       (1ull << 4)
+#define PTE_HUGE      (1ull << 7)  // in PDPT and PD entries, marks a 1 GiB or 2 MiB page
+#define PTE_PAT       (1ull << 7)  // in PT entries
+#define PTE_PAT_HUGE  (1ull << 12) // in PDPT and PD entries that map a page
+#define PTE_ADDRESS   0x000FFFFFFFFFF000ull
+
+static uint64_t read_msr(uint32_t msr) {
+    uint32_t low, high;
+    __asm__ volatile ("rdmsr" : "=a"(low), "=d"(high) : "c"(msr));
+    return ((uint64_t)high << 32) | low;
+}
+
+static void write_msr(uint32_t msr, uint64_t value) {
+    __asm__ volatile ("wrmsr" :: "c"(msr), "a"((uint32_t)value), "d"((uint32_t)(value >> 32)) : "memory");
+}
+
+static uint64_t read_cr3(void) {
+    uint64_t value;
+    __asm__ volatile ("mov %0, cr3" : "=r"(value));
+    return value;
+}
+
+
+// Returns the page table that the given entry points to.
+static uint64_t* next_table(uint64_t entry) {
+    return mm_phys_to_virt((physaddr_t)(entry & PTE_ADDRESS));
+}
+
+// Selects `PAT_WC_INDEX` (PAT:PCD:PWT = 1:0:1) for the page mapped by the given entry,
+// which contains `virt`, and flushes its stale translation.
+static void select_wc(uint64_t* entry, uint64_t pat_bit, uint64_t virt) {
+    *entry = (*entry & ~PTE_PCD) | PTE_PWT | pat_bit;
+    __asm__ volatile ("invlpg [%0]" :: "r"(virt) : "memory");
+}
+
+bool paging_set_write_combining(void* address, size_t length) {
+    if (!cpu_get_features()->pat)
+        return false;
+
+    uint64_t pat = read_msr(MSR_IA32_PAT);
+    pat &= ~(0xFFull << (PAT_WC_INDEX * 8));
+    pat |= (uint64_t)PAT_TYPE_WC << (PAT_WC_INDEX * 8);
+    write_msr(MSR_IA32_PAT, pat);
+
+    uint64_t* pml4 = next_table(read_cr3());
+    uint64_t virt = (uint64_t)address & ~(uint64_t)(PAGE_SIZE - 1);
+    uint64_t end = (uint64_t)address + length;
+
+    while (virt < end) {
+        uint64_t* pml4e = &pml4[(virt >> 39) & 0x1FF];
+        if ((*pml4e & PTE_PRESENT) == 0)
+            return false;
+
+        uint64_t* pdpte = &next_table(*pml4e)[(virt >> 30) & 0x1FF];
+        if ((*pdpte & PTE_PRESENT) == 0)
+            return false;
+
+        if ((*pdpte & PTE_HUGE) != 0) {
+            select_wc(pdpte, PTE_PAT_HUGE, virt);
+            virt = (virt | ((1ull << 30) - 1)) + 1;
+            continue;
+        }
+
+        uint64_t* pde = &next_table(*pdpte)[(virt >> 21) & 0x1FF];
+        if ((*pde & PTE_PRESENT) == 0)
+            return false;
+
+        if ((*pde & PTE_HUGE) != 0) {
+            select_wc(pde, PTE_PAT_HUGE, virt);
+            virt = (virt | ((1ull << 21) - 1)) + 1;
+            continue;
+        }
+
+        uint64_t* pte = &next_table(*pde)[(virt >> 12) & 0x1FF];
+        if ((*pte & PTE_PRESENT) == 0)
+            return false;
+
+        select_wc(pte, PTE_PAT, virt);
+        virt += PAGE_SIZE;
+    }
+
+    // Lines cached under the old memory type have to be written back before the new one
+    // takes effect.
+    __asm__ volatile ("wbinvd" ::: "memory");
+    return true;
+}
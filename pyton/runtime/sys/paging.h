@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Adjustments to the page tables the bootloader has set up. The runtime never creates
+// mappings of its own - everything it needs is already mapped via the HHDM.
+
+// Makes the pages that back the given virtual memory range write-combining, through the
+// PAT. Writes to such memory are buffered and issued in bursts, which makes bulk copies to
+// video memory several times faster than with the uncached mappings devices get by
+// default. Returns `false` if the processor doesn't support the PAT, or if part of the
+// range isn't mapped.
+bool paging_set_write_combining(void* address, size_t length);
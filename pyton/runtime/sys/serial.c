@@ -0,0 +1,165 @@
+#include "serial.h"
+
+#include <stdint.h>
+#include "interrupts.h"
+#include "io.h"
+#include "std/safety.h"
+
+#define COM1 0x3F8
+#define COM1_IRQ 4
+
+// UART registers, as offsets from the base port. `DLL`/`DLM` replace `DATA`/`IER` while
+// the divisor latch access bit is set in `LCR`.
+#define UART_DATA 0
+#define UART_IER  1
+#define UART_DLL  0
+#define UART_DLM  1
+#define UART_FCR  2
+#define UART_LCR  3
+#define UART_MCR  4
+#define UART_LSR  5
+
+#define UART_IER_THRE         0x02 // interrupt when the transmit holding register empties
+#define UART_FCR_ENABLE_CLEAR 0xC7 // enable and clear the FIFOs, 14-byte RX threshold
+#define UART_LCR_DLAB         0x80
+#define UART_LCR_8N1          0x03
+#define UART_MCR_LOOPBACK     0x1E // loopback mode, with RTS, OUT1 and OUT2 set
+#define UART_MCR_NORMAL       0x0F // DTR, RTS, OUT1 and OUT2 (which gates the IRQ) set
+#define UART_LSR_THRE         0x20 // the transmit FIFO is empty
+
+// The size of the 16550's transmit FIFO. Once `UART_LSR_THRE` is set, this many bytes can
+// be written without checking again.
+#define UART_FIFO_SIZE 16
+
+// The UART's input clock divided by 16, i.e. the rate it transmits at with a divisor of 1.
+#define UART_BASE_BAUD_RATE 115200
+
+// The transmit ring buffer. `tx_head` is only advanced by `serial_write`, and `tx_tail`
+// only by whoever drains the buffer into the UART - the IRQ handler, or `serial_write`
+// itself when interrupts are disabled.
+static char tx_buffer[SERIAL_TX_BUFFER_SIZE];
+static volatile size_t tx_head;
+static volatile size_t tx_tail;
+static bool tx_interrupts;
+
+// Hands up to a whole FIFO of queued bytes to the UART, which must have signaled that its
+// FIFO is empty.
+static void fill_fifo(void) {
+    for (int i = 0; i < UART_FIFO_SIZE && tx_tail != tx_head; i++) {
+        io_outb(COM1 + UART_DATA, (uint8_t)tx_buffer[tx_tail % SERIAL_TX_BUFFER_SIZE]);
+        tx_tail++;
+    }
+}
+
+static void serial_irq_handler(int irq) {
+    if ((io_inb(COM1 + UART_LSR) & UART_LSR_THRE) == 0)
+        return;
+
+    fill_fifo();
+
+    if (tx_tail == tx_head) {
+        // Nothing left to send - `serial_write` re-arms the interrupt.
+        io_outb(COM1 + UART_IER, 0);
+    }
+}
+
+bool serial_init(void) {
+    io_outb(COM1 + UART_IER, 0);
+    io_outb(COM1 + UART_LCR, UART_LCR_DLAB);
+    io_outb(COM1 + UART_DLL, (UART_BASE_BAUD_RATE / SERIAL_BAUD_RATE) & 0xFF);
+    io_outb(COM1 + UART_DLM, (UART_BASE_BAUD_RATE / SERIAL_BAUD_RATE) >> 8);
+    io_outb(COM1 + UART_LCR, UART_LCR_8N1);
+    io_outb(COM1 + UART_FCR, UART_FCR_ENABLE_CLEAR);
+
+    // A byte sent in loopback mode should come right back - if it doesn't, there's no
+    // (working) UART on the port.
+    io_outb(COM1 + UART_MCR, UART_MCR_LOOPBACK);
+    io_outb(COM1 + UART_DATA, 0xAE);
+
+    if (io_inb(COM1 + UART_DATA) != 0xAE)
+        return false;
+
+    io_outb(COM1 + UART_MCR, UART_MCR_NORMAL);
+    return true;
+}
+
+void serial_enable_tx_interrupts(void) {
+    int_set_irq_handler(COM1_IRQ, &serial_irq_handler);
+    tx_interrupts = true;
+}
+
+// Transmits the given bytes directly, a FIFO at a time, bypassing the ring buffer.
+static void write_polled(const char* str, size_t length) {
+    while (length != 0) {
+        while ((io_inb(COM1 + UART_LSR) & UART_LSR_THRE) == 0) {
+            __asm__ volatile ("pause");
+        }
+
+        size_t count = length < UART_FIFO_SIZE ? length : UART_FIFO_SIZE;
+        for (size_t i = 0; i < count; i++) {
+            io_outb(COM1 + UART_DATA, (uint8_t)str[i]);
+        }
+
+        str += count;
+        length -= count;
+    }
+}
+
+// Drains the ring buffer by polling. Must only be called with interrupts disabled, as
+// the IRQ handler would otherwise race us for `tx_tail`.
+static void drain_polled(void) {
+    while (tx_tail != tx_head) {
+        while ((io_inb(COM1 + UART_LSR) & UART_LSR_THRE) == 0) {
+            __asm__ volatile ("pause");
+        }
+
+        fill_fifo();
+    }
+}
+
+void serial_write(const char* str, size_t length) {
+    ENSURE_NOT_NULL(str);
+
+    if (!tx_interrupts) {
+        write_polled(str, length);
+        return;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        if (tx_head - tx_tail == SERIAL_TX_BUFFER_SIZE) {
+            if (int_are_enabled()) {
+                // Let the UART catch up.
+                io_outb(COM1 + UART_IER, UART_IER_THRE);
+                while (tx_head - tx_tail == SERIAL_TX_BUFFER_SIZE) {
+                    __asm__ volatile ("pause");
+                }
+            }
+            else {
+                // The IRQ handler can't run, so we need to make room ourselves.
+                drain_polled();
+            }
+        }
+
+        tx_buffer[tx_head % SERIAL_TX_BUFFER_SIZE] = str[i];
+        __asm__ volatile ("" ::: "memory");
+        tx_head++;
+    }
+
+    // Enabling the interrupt while the FIFO is already empty raises it right away, which
+    // starts the transmission.
+    io_outb(COM1 + UART_IER, UART_IER_THRE);
+}
+
+void serial_drain(void) {
+    if (!tx_interrupts)
+        return;
+
+    if (int_are_enabled()) {
+        while (tx_tail != tx_head) {
+            __asm__ volatile ("pause");
+        }
+    }
+    else {
+        drain_polled();
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// A driver for the first serial port (COM1), backed by a 16550-compatible UART. Output is
+// transmitted a whole FIFO at a time - by polling the line status by default, or, once
+// `serial_enable_tx_interrupts` has been called, from a ring buffer that the UART drains
+// in the background via IRQ 4.
+
+// The capacity of the transmit ring buffer, in bytes. Must be a power of two.
+#define SERIAL_TX_BUFFER_SIZE 16384
+
+// The rate at which COM1 transmits, in bits per second.
+#define SERIAL_BAUD_RATE 115200
+
+// Initializes COM1 at `SERIAL_BAUD_RATE` baud, 8N1, with its FIFOs enabled. Returns `false` if no UART
+// responds on the port, in which case no other `serial_*` function may be called.
+bool serial_init(void);
+
+// Switches to interrupt-driven transmission. Requires `int_init` to have been called.
+void serial_enable_tx_interrupts(void);
+
+// Transmits `length` bytes of the given string. In polled mode, this returns once the
+// last byte has been handed to the UART; in interrupt-driven mode, once it has been
+// queued, unless the transmit buffer is full.
+void serial_write(const char* str, size_t length);
+
+// Waits until everything queued by `serial_write` has been handed to the UART.
+void serial_drain(void);
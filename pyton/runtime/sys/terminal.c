@@ -1,23 +1,170 @@
 #include "terminal.h"
 
 #include "bootloader.h"
+#include "mm.h"
+#include "paging.h"
+#include "serial.h"
+#include "timer.h"
+#include "std/memory.h"
 #include "std/stringop.h"
 #include "std/safety.h"
 #include <flanterm/src/flanterm.h>
 #include <flanterm/src/flanterm_backends/fb.h>
 
 typedef struct flanterm_context flanterm_context_t;
+typedef struct flanterm_fb_context flanterm_fb_context_t;
+typedef struct flanterm_fb_char flanterm_fb_char_t;
 
 static flanterm_context_t* global_terminal;
 static bool terminal_initialized = false;
 
-void terminal_init(void) {
+static bool to_framebuffer;
+static bool to_serial;
+static bool serial_interrupts;
+
+// The renderer draws into a back-buffer in regular memory, and the parts of it that have
+// changed are copied to the framebuffer in bulk once a batch of output has been rendered.
+// Reads from video memory are very slow, and uncached writes aren't combined into bursts,
+// so this is much faster than letting the renderer touch the framebuffer directly.
+static uint8_t* front_buffer;
+static uint8_t* back_buffer;
+static size_t screen_pitch;
+static size_t screen_width;
+static size_t screen_height;
+static size_t bytes_per_pixel;
+
+// The area of the back-buffer that has changed since it was last copied, in pixels. The
+// area is empty when `dirty_left >= dirty_right`.
+static size_t dirty_left, dirty_top, dirty_right, dirty_bottom;
+
+// The renderer's own character plotting routine, which we wrap to track dirty areas.
+static void (*render_char)(flanterm_context_t* ctx, flanterm_fb_char_t* c, size_t x, size_t y);
+
+// The buffered output. `buffer_head` and `buffer_tail` only ever increase - their
+// difference is the amount of buffered bytes, and they're wrapped around when indexing.
+static char buffer[TERMINAL_BUFFER_SIZE];
+static size_t buffer_head;
+static size_t buffer_tail;
+static int buffered_lines;
+
+// Set by the timer once buffered output has been waiting for `TERMINAL_IDLE_FLUSH_TICKS`.
+// Rendering is too expensive to be done in the interrupt context, so the output is only
+// flushed by the next `terminal_write` or `terminal_poll`.
+static volatile bool flush_pending;
+
+// The tick during which output was last written.
+static volatile uint64_t last_write_tick;
+
+static volatile uint64_t bytes_written;
+static volatile uint64_t flush_count;
+static uint64_t bytes_per_second;
+static uint64_t flushes_per_second;
+
+// The counters as of the start of the current second.
+static uint64_t second_start_bytes;
+static uint64_t second_start_flushes;
+
+// Returns `true` if the space-separated list of boot options contains `option`.
+static bool has_boot_option(const char* cmdline, const char* option) {
+    size_t option_length = strlen(option);
+
+    while (*cmdline != '\0') {
+        size_t length = 0;
+        while (cmdline[length] != '\0' && cmdline[length] != ' ') {
+            length++;
+        }
+
+        if (length == option_length) {
+            size_t i = 0;
+            while (i < length && cmdline[i] == option[i]) {
+                i++;
+            }
+
+            if (i == length)
+                return true;
+        }
+
+        cmdline += length;
+        while (*cmdline == ' ') {
+            cmdline++;
+        }
+    }
+
+    return false;
+}
+
+static void* renderer_alloc(size_t size) {
+    return mm_heap_alloc(size);
+}
+
+static void renderer_free(void* ptr, size_t size) {
+    mm_heap_free(ptr);
+}
+
+// Extends the dirty area to include the given rectangle.
+static void mark_dirty(size_t left, size_t top, size_t right, size_t bottom) {
+    right = right < screen_width ? right : screen_width;
+    bottom = bottom < screen_height ? bottom : screen_height;
+
+    if (dirty_left >= dirty_right) {
+        dirty_left = left;
+        dirty_top = top;
+        dirty_right = right;
+        dirty_bottom = bottom;
+        return;
+    }
+
+    dirty_left = left < dirty_left ? left : dirty_left;
+    dirty_top = top < dirty_top ? top : dirty_top;
+    dirty_right = right > dirty_right ? right : dirty_right;
+    dirty_bottom = bottom > dirty_bottom ? bottom : dirty_bottom;
+}
+
+// Plots a character into the back-buffer, and marks the cell it occupies as dirty.
+static void plot_char_tracked(flanterm_context_t* ctx, flanterm_fb_char_t* c, size_t x, size_t y) {
+    flanterm_fb_context_t* fb_ctx = (flanterm_fb_context_t*)ctx;
+    size_t left = fb_ctx->offset_x + x * fb_ctx->glyph_width;
+    size_t top = fb_ctx->offset_y + y * fb_ctx->glyph_height;
+
+    mark_dirty(left, top, left + fb_ctx->glyph_width, top + fb_ctx->glyph_height);
+    render_char(ctx, c, x, y);
+}
+
+// Copies the dirty area of the back-buffer to the framebuffer.
+static void present(void) {
+    if (!to_framebuffer || dirty_left >= dirty_right)
+        return;
+
+    size_t offset = dirty_top * screen_pitch + dirty_left * bytes_per_pixel;
+    size_t row_length = (dirty_right - dirty_left) * bytes_per_pixel;
+
+    for (size_t y = dirty_top; y < dirty_bottom; y++) {
+        memcpy(front_buffer + offset, back_buffer + offset, row_length);
+        offset += screen_pitch;
+    }
+
+    dirty_left = dirty_right = 0;
+}
+
+static void init_framebuffer(void) {
     bl_framebuffer_t fb = bl_get_framebuffer();
 
+    front_buffer = fb->address;
+    screen_pitch = fb->pitch;
+    screen_width = fb->width;
+    screen_height = fb->height;
+    bytes_per_pixel = fb->bpp / 8;
+
+    back_buffer = mm_heap_alloc(screen_pitch * screen_height);
+    memset(back_buffer, 0, screen_pitch * screen_height);
+
+    // If the PAT isn't available, the copies still work - they're just slower.
+    paging_set_write_combining(front_buffer, screen_pitch * screen_height);
+
     global_terminal = flanterm_fb_init(
-        NULL, // TODO: Provide custom heap allocation functions here
-        NULL,
-        fb->address,
+        &renderer_alloc,
+        &renderer_free,
+        (uint32_t*)back_buffer,
         fb->width,
         fb->height,
         fb->pitch,
@@ -36,20 +183,160 @@ void terminal_init(void) {
         0 // margin
     );
 
+    flanterm_fb_context_t* fb_ctx = (flanterm_fb_context_t*)global_terminal;
+    render_char = fb_ctx->plot_char;
+    fb_ctx->plot_char = &plot_char_tracked;
+
+    // The renderer has cleared the whole screen, margins included.
+    mark_dirty(0, 0, screen_width, screen_height);
+    present();
+}
+
+void terminal_init(void) {
+    const char* cmdline = bl_get_cmdline();
+
+    if (has_boot_option(cmdline, "console=serial") || has_boot_option(cmdline, "console=both")) {
+        to_serial = serial_init();
+        serial_interrupts = to_serial && has_boot_option(cmdline, "serial=irq");
+    }
+
+    to_framebuffer = !to_serial || has_boot_option(cmdline, "console=both");
+
+    if (to_framebuffer) {
+        init_framebuffer();
+    }
+
     terminal_initialized = true;
 }
 
+void terminal_enable_interrupts(void) {
+    if (serial_interrupts) {
+        serial_enable_tx_interrupts();
+    }
+}
+
+// Writes the given output to all sinks.
+static void emit(const char* str, size_t length) {
+    if (to_framebuffer) {
+        flanterm_write(global_terminal, str, length);
+    }
+
+    if (to_serial) {
+        serial_write(str, length);
+    }
+}
+
+// Renders all buffered output.
+static void flush_buffer(void) {
+    flush_pending = false;
+
+    if (buffer_head == buffer_tail)
+        return;
+
+    size_t start = buffer_tail % TERMINAL_BUFFER_SIZE;
+    size_t length = buffer_head - buffer_tail;
+
+    if (start + length <= TERMINAL_BUFFER_SIZE) {
+        emit(buffer + start, length);
+    }
+    else {
+        // The buffered output wraps around the end of the buffer.
+        size_t first = TERMINAL_BUFFER_SIZE - start;
+        emit(buffer + start, first);
+        emit(buffer, length - first);
+    }
+
+    present();
+
+    buffer_tail = buffer_head;
+    buffered_lines = 0;
+    flush_count++;
+}
+
 void terminal_println(const char* str) {
     ENSURE_NOT_NULL(str);
-    flanterm_write(global_terminal, str, strlen(str) + 1); // we add 1 to account for the \0
+    terminal_write(str, strlen(str));
     terminal_newline();
 }
 
+void terminal_write(const char* str, size_t length) {
+    ENSURE_NOT_NULL(str);
+
+    bytes_written += length;
+    last_write_tick = timer_ticks();
+
+    if (length > TERMINAL_BUFFER_SIZE - (buffer_head - buffer_tail)) {
+        flush_buffer();
+
+        if (length >= TERMINAL_BUFFER_SIZE) {
+            // Too large to be buffered - there's no point in copying it.
+            emit(str, length);
+            present();
+            flush_count++;
+            length = 0;
+        }
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        buffer[buffer_head++ % TERMINAL_BUFFER_SIZE] = str[i];
+
+        if (str[i] == '\n') {
+            buffered_lines++;
+        }
+    }
+
+    // Output the timer asked us to flush goes out together with the new output.
+    if (buffered_lines >= TERMINAL_FLUSH_LINES || flush_pending) {
+        flush_buffer();
+    }
+}
+
+void terminal_flush(void) {
+    flush_buffer();
+}
+
+void terminal_poll(void) {
+    if (flush_pending) {
+        flush_buffer();
+    }
+}
+
+void terminal_sync(void) {
+    terminal_flush();
+
+    if (to_serial) {
+        serial_drain();
+    }
+}
+
 void terminal_newline(void) {
-    const char newline[] = "\n";
-    flanterm_write(global_terminal, newline, sizeof(newline));
+    terminal_write("\n", 1);
 }
 
 bool terminal_is_initialized(void) {
     return terminal_initialized;
-}
\ No newline at end of file
+}
+
+void terminal_tick(uint64_t ticks) {
+    // We're running in the interrupt context here, with interrupts disabled - we only
+    // request the flush, which the code we've interrupted carries out once it's idle.
+    if (buffer_head != buffer_tail && ticks - last_write_tick >= TERMINAL_IDLE_FLUSH_TICKS) {
+        flush_pending = true;
+    }
+
+    if (ticks % TIMER_HZ == 0) {
+        bytes_per_second = bytes_written - second_start_bytes;
+        flushes_per_second = flush_count - second_start_flushes;
+        second_start_bytes = bytes_written;
+        second_start_flushes = flush_count;
+    }
+}
+
+terminal_stats_t terminal_get_stats(void) {
+    return (terminal_stats_t) {
+        .bytes_written = bytes_written,
+        .flushes = flush_count,
+        .bytes_per_second = bytes_per_second,
+        .flushes_per_second = flushes_per_second
+    };
+}
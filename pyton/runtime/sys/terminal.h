@@ -1,15 +1,73 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
-// Initializes the on-screen terminal.
+// The terminal writes to the framebuffer, to the first serial port, or to both (which is
+// useful for capturing output from headless runs, e.g. `qemu -serial stdio`). The sinks are
+// selected with the `console=framebuffer|serial|both` boot option, and the serial port
+// transmits from an interrupt-driven ring buffer when `serial=irq` is given as well.
+//
+// Output written to the terminal is collected in a ring buffer, and only rendered once
+// `TERMINAL_FLUSH_LINES` lines have accumulated, the buffer fills up, `terminal_flush` is
+// called, or no output has been written for `TERMINAL_IDLE_FLUSH_TICKS` timer ticks. This
+// lets chatty scripts render many lines in one pass, instead of one or two per `print`.
+//
+// Idle output isn't rendered by the timer interrupt itself - it's flushed by the next write,
+// or by `terminal_poll`, which is called whenever the kernel waits for something.
+
+// The capacity of the output buffer, in bytes. Must be a power of two.
+#define TERMINAL_BUFFER_SIZE 8192
+
+// The amount of buffered new-lines that causes the buffer to be flushed.
+#define TERMINAL_FLUSH_LINES 32
+
+// The amount of timer ticks without any output after which buffered output gets flushed.
+#define TERMINAL_IDLE_FLUSH_TICKS 10
+
+// Represents statistics about the output written to the terminal.
+typedef struct terminal_stats {
+    uint64_t bytes_written;      // the total amount of bytes written
+    uint64_t flushes;            // the total amount of times the buffer was rendered
+    uint64_t bytes_per_second;   // the amount of bytes written during the last second
+    uint64_t flushes_per_second; // the amount of flushes during the last second
+} terminal_stats_t;
+
+// Initializes the terminal, and the sinks selected by the boot options. If the serial port
+// was requested but isn't present, output goes to the framebuffer instead.
 void terminal_init(void);
 
+// Enables interrupt-driven output for the sinks that support it and were configured to
+// use it. Requires `int_init` to have been called.
+void terminal_enable_interrupts(void);
+
 // Prints the given line to the on-screen terminal.
 void terminal_println(const char* str);
 
+// Prints `length` characters of the given string to the on-screen terminal. The string
+// doesn't need to be null-terminated.
+void terminal_write(const char* str, size_t length);
+
+// Renders all buffered output.
+void terminal_flush(void);
+
+// Renders all buffered output if the timer has requested it, as no output has been written
+// for `TERMINAL_IDLE_FLUSH_TICKS`. Must not be called from the interrupt context.
+void terminal_poll(void);
+
+// Renders all buffered output, and waits until the sinks have finished writing it out.
+void terminal_sync(void);
+
 // Returns `true` if the terminal has been initialized.
 bool terminal_is_initialized(void);
 
 // Prints a single new-line character.
-void terminal_newline(void);
\ No newline at end of file
+void terminal_newline(void);
+
+// Called by the system timer on each tick. Requests a flush of output that has been waiting
+// for longer than `TERMINAL_IDLE_FLUSH_TICKS`, and updates the per-second statistics.
+void terminal_tick(uint64_t ticks);
+
+// Returns statistics about the output written to the terminal so far.
+terminal_stats_t terminal_get_stats(void);
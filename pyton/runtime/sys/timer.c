@@ -0,0 +1,32 @@
+#include "timer.h"
+
+#include "interrupts.h"
+#include "io.h"
+#include "terminal.h"
+
+#define PIT_CHANNEL0 0x40
+#define PIT_COMMAND  0x43
+
+// Channel 0, lobyte/hibyte access, mode 2 (rate generator), binary.
+#define PIT_MODE_RATE_GENERATOR 0x34
+
+static volatile uint64_t tick_count;
+
+static void timer_irq_handler(int irq) {
+    tick_count++;
+    terminal_tick(tick_count);
+}
+
+void timer_init(void) {
+    uint16_t divisor = PIT_BASE_FREQUENCY / TIMER_HZ;
+
+    io_outb(PIT_COMMAND, PIT_MODE_RATE_GENERATOR);
+    io_outb(PIT_CHANNEL0, divisor & 0xFF);
+    io_outb(PIT_CHANNEL0, divisor >> 8);
+
+    int_set_irq_handler(0, &timer_irq_handler);
+}
+
+uint64_t timer_ticks(void) {
+    return tick_count;
+}
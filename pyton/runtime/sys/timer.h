@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+
+// The frequency, in Hz, at which the system timer ticks.
+#define TIMER_HZ 1000
+
+// The frequency of the PIT's input clock, in Hz.
+#define PIT_BASE_FREQUENCY 1193182
+
+// Programs the PIT to fire IRQ 0 at `TIMER_HZ`. Requires `int_init` to have been called.
+void timer_init(void);
+
+// Returns the number of timer ticks since `timer_init` was called.
+uint64_t timer_ticks(void);
@@ -1,3 +1,6 @@
+import dis
+from typing import Container
+
 # https://github.com/python/cpython/blob/8865b4f95b32097099d252111669b88ec7c1eb7f/Include/opcode.h#L9
 NB_ADD                                  = 0
 NB_AND                                  = 1
@@ -25,4 +28,78 @@ NB_INPLACE_RSHIFT                       = 22
 NB_INPLACE_SUBTRACT                     = 23
 NB_INPLACE_TRUE_DIVIDE                  = 24
 NB_INPLACE_XOR                          = 25
-NB_SUBSCR                               = 26
\ No newline at end of file
+NB_SUBSCR                               = 26
+
+def find_global_calls(
+    instructions: list[dis.Instruction],
+    names: Container[str],
+    label_offsets: set[int]
+) -> dict[int, tuple[str, list[dis.Instruction]]]:
+    """
+    Finds all calls of the globals in `names` that pass all arguments positionally. Returns
+    a dictionary that maps the indices of the `CALL` instructions to the names of the called
+    globals, and the instructions that push the arguments.
+    """
+    calls: dict[int, tuple[str, list[dis.Instruction]]] = {}
+
+    for i, instr in enumerate(instructions):
+        # Functions load the callable with LOAD_GLOBAL, which pushes the NULL itself, while
+        # module-level code does LOAD_NAME, followed by PUSH_NULL.
+        if instr.opname == "LOAD_GLOBAL" and instr.arg is not None and (instr.arg & 1) == 1:
+            args_idx = i + 1
+        elif instr.opname == "LOAD_NAME" and i + 1 < len(instructions) and instructions[i + 1].opname == "PUSH_NULL":
+            args_idx = i + 2
+        else:
+            continue
+
+        if instr.argval not in names:
+            continue
+
+        call_idx = find_consuming_call(instructions, args_idx, label_offsets)
+        if call_idx is not None:
+            calls[call_idx] = (instr.argval, instructions[args_idx:call_idx])
+
+    return calls
+
+def single_value_args(arg_instrs: list[dis.Instruction], argc: int):
+    """
+    Returns the instructions that push the arguments of a call, as returned by
+    `find_global_calls`, if each of the `argc` arguments is pushed by a single instruction.
+    In that case, we know which ones are constants. Otherwise, returns `None`.
+    """
+    if len(arg_instrs) == argc and all(pushes_single_value(x) for x in arg_instrs):
+        return arg_instrs
+
+    return None
+
+def pushes_single_value(instr: dis.Instruction):
+    "Returns `True` if the given instruction only pushes a single value, without popping any."
+    return (
+        instr.opname.startswith("LOAD_") and
+        instr.opname not in ("LOAD_ATTR", "LOAD_SUPER_ATTR") and
+        dis.stack_effect(instr.opcode, instr.arg, jump = False) == 1
+    )
+
+def find_consuming_call(instructions: list[dis.Instruction], start: int, label_offsets: set[int]):
+    """
+    Finds the CALL that consumes the callable pushed right before `instructions[start]`
+    (along with its NULL), which is the first one that has all values pushed from `start`
+    onwards as its arguments. Returns the index of the CALL, or `None` if it couldn't be
+    found. Any control flow in between (e.g. a conditional expression in an argument)
+    makes us give up.
+    """
+    depth = 0
+
+    for i in range(start, len(instructions)):
+        instr = instructions[i]
+        if instr.offset in label_offsets or instr.opcode in dis.hasjrel or instr.opcode in dis.hasjabs:
+            return None
+
+        if instr.opname == "CALL" and instr.arg == depth:
+            return i
+
+        depth += dis.stack_effect(instr.opcode, instr.arg, jump = False)
+        if depth < 0:
+            return None
+
+    return None
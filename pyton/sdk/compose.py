@@ -15,11 +15,8 @@ def path_to_libname(path: str):
 COMMON_GCC_FLAGS = [
     "-fno-stack-protector",
     "-fno-stack-check",
-    "-mno-80387",
-    "-mno-mmx",
-    "-mno-sse",
+    "-mno-red-zone",
     "-mcmodel=kernel",
-    "-mno-sse2",
     "-ffreestanding",
     "-nostdlib",
     "-g",
@@ -214,6 +211,7 @@ def create_iso(
     root: str,
     limine_repo: str,
     output_path: str,
+    cmdline: str = "",
 ):
     print("(...) creating ISO...")
     if os.path.exists(root):
@@ -222,6 +220,11 @@ def create_iso(
     # copy all pre-defined template files (e.g. limine configuration)
     shutil.copytree(iso_template, root)
 
+    # boot options are passed to the kernel via the command line of its boot entry
+    if cmdline:
+        with open(os.path.join(root, "boot/limine/limine.conf"), "a") as f:
+            f.write(f"\n    cmdline: {cmdline}\n")
+
     # these files are dynamically generated, so they cannot be included in the template
     copy_many(root, [
         (kernel_binary, "boot/kernel.elf"),
@@ -258,4 +261,4 @@ def create_iso(
     print("(...) - making ISO BIOS-bootable")
     run([os.path.join(limine_repo, "limine"), "bios-install", output_path])
 
-    print(f"(ok!) ISO file created at {output_path}!")
\ No newline at end of file
+    print(f"(ok!) ISO file created at {output_path}!")
\ No newline at end of file
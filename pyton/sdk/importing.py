@@ -5,6 +5,17 @@ from dataclasses import dataclass
 
 from .util import unwrap, error
 
+NATIVE_MODULES = { "asyncio", "struct", "array", "matrix", "time", "heapq", "math" }
+"""
+Modules implemented by the runtime. Importing from these does not translate any Python
+source - for `from <module> import <name>`, the imported global is expected to be
+provided by the runtime as `pyglobal__<module>_<name>`.
+"""
+
+def is_native_module(name: str):
+    "Returns `True` if the module with the given import name is provided by the runtime."
+    return name in NATIVE_MODULES
+
 @dataclass
 class Import:
     name: str
@@ -4,7 +4,8 @@ from typing import Literal
 from textwrap import dedent
 from dataclasses import dataclass
 
-from .util import omit, unwrap
+from .util import error, unwrap
+from .bytecode import find_global_calls, single_value_args
 
 InteropType = Literal[
     "INT",      # int <-> int64_t
@@ -18,12 +19,15 @@ InteropType = Literal[
 @dataclass
 class ExternSpec:
     """
-    Represents the specification for an `@extern` function, holding the details
-    about the target symbol and their parameter types.
+    Represents the specification for an `@extern` or `@c_function` function, holding the
+    details about the target symbol and their parameter types.
     """
 
+    name: str
+    "The name of the Python function."
+
     symbol: str
-    "The name of the symbol to import."
+    "The name of the symbol to import, or, for `@c_function`s, of the generated C function."
 
     param_types: dict[str, InteropType]
     "A map of parameter names to their types."
@@ -31,10 +35,26 @@ class ExternSpec:
     return_type: InteropType
     "The return type of the function."
 
+    body: str | None = None
+    "For `@c_function`s, the C code of the body of the function. `None` for `@extern`s."
+
     def c_name(self):
         "Returns the `PY_DEFINE` name of the function."
         return f"_extern_{self.symbol}"
 
+@dataclass
+class ExternCall:
+    "Represents a call to an `@extern` function that can call its symbol directly."
+
+    spec: ExternSpec
+    "The called function."
+
+    checked: list[bool]
+    """
+    For every argument, `False` if it's known to be of the parameter type at compile-time,
+    and `True` if its type has to be checked at run-time.
+    """
+
 @dataclass
 class ExternFunction:
     "Represents a specific occurence of an `@extern` function."
@@ -60,17 +80,45 @@ def _get_interop_type(value: str | None) -> InteropType:
 
     return "OBJ"
 
-def _interop_to_c_type(target: InteropType):
+def _interop_to_c_type(target: InteropType, is_param: bool = False):
     match target:
         case "BOOL": return "bool"
         case "FLOAT": return "double"
         case "INT": return "int64_t"
-        case "NONE": return "void"
+        case "NONE": return "void*" if is_param else "void"
         case "OBJ": return "pyobj_t*"
         case "STRING": return "string_t"
 
-def get_all_externs(bytecode: dis.Bytecode) -> list[ExternFunction]:
-    "Finds all functions decorated with `@extern` in the bytecode of a function."
+def _interop_to_marshal_suffix(target: InteropType):
+    "Returns the suffix of the `*MARSHAL*` macros (see `runtime/fragments.h`) for the given type."
+    return "STR" if target == "STRING" else target
+
+def _interop_to_py_name(target: InteropType):
+    match target:
+        case "BOOL": return "bool"
+        case "FLOAT": return "float"
+        case "INT": return "int"
+        case "NONE": return "None"
+        case "OBJ": return "object"
+        case "STRING": return "str"
+
+def _is_constant_of_type(instr: dis.Instruction, target: InteropType):
+    if instr.opname != "LOAD_CONST":
+        return False
+
+    match target:
+        case "BOOL": return type(instr.argval) is bool
+        case "FLOAT": return type(instr.argval) is float
+        case "INT": return type(instr.argval) is int and -2**63 <= instr.argval < 2**63
+        case "NONE": return instr.argval is None
+        case "OBJ": return True
+        case "STRING": return type(instr.argval) is str
+
+def get_all_externs(bytecode: dis.Bytecode, module: str) -> list[ExternFunction]:
+    """
+    Finds all functions decorated with `@extern` or `@c_function` in the bytecode of the
+    `<module>` function of `module`.
+    """
 
     fn = bytecode.codeobj
     body = [*bytecode]
@@ -78,7 +126,7 @@ def get_all_externs(bytecode: dis.Bytecode) -> list[ExternFunction]:
     externs: list[ExternFunction] = []
 
     for i in range(len(body)):
-        result = _scan_single(body, fn, i)
+        result = _scan_single(body, fn, i, module)
         if result is None:
             continue
 
@@ -86,12 +134,14 @@ def get_all_externs(bytecode: dis.Bytecode) -> list[ExternFunction]:
 
     return externs
         
-def _scan_single(body: list[dis.Instruction], fn: CodeType, i: int) -> ExternFunction | None:
+def _scan_single(body: list[dis.Instruction], fn: CodeType, i: int, module: str) -> ExternFunction | None:
     start_idx = i
 
-    if body[i].opname != "LOAD_NAME" or fn.co_names[unwrap(body[i].arg)] != "extern":
+    if body[i].opname != "LOAD_NAME" or fn.co_names[unwrap(body[i].arg)] not in ("extern", "c_function"):
         return None
 
+    decorator = fn.co_names[unwrap(body[i].arg)]
+
     # For a definition like this:
     #       @extern
     #       def func(p1: int, p2: str) -> None: ...
@@ -113,6 +163,21 @@ def _scan_single(body: list[dis.Instruction], fn: CodeType, i: int) -> ExternFun
     annotations: dict[str, InteropType] = {}
 
     i += 1
+    if body[i].opname == "LOAD_CONST" and type(body[i].argval) is CodeType:
+        # A function without any annotations, which is only useful for `@c_function`s that
+        # only take objects.
+        return _scan_definition(body, fn, start_idx, i, annotations, decorator, module)
+
+    if body[i].opname == "LOAD_CONST" and type(body[i].argval) is tuple:
+        # When all annotations are constants (e.g. for `def func() -> None: ...`), the
+        # tuple is folded into a single constant.
+        pairs = body[i].argval
+        for pname, ptype in zip(pairs[0::2], pairs[1::2]):
+            annotations[pname] = _get_interop_type(ptype)
+
+        i += 1
+        return _scan_definition(body, fn, start_idx, i, annotations, decorator, module)
+
     while body[i].opname == "LOAD_CONST" and body[i + 1].opname in ("LOAD_NAME", "LOAD_CONST"):
         pname_instr = body[i]
         ptype_instr = body[i + 1]
@@ -127,61 +192,224 @@ def _scan_single(body: list[dis.Instruction], fn: CodeType, i: int) -> ExternFun
 
         annotations[pname] = ptype
 
-        i += 1 # skip the corresponding type load instruction
+        i += 2 # skip both the name and the type load instruction
+
+    if body[i].opname != "BUILD_TUPLE":
+        return None
+
+    return _scan_definition(body, fn, start_idx, i + 1, annotations, decorator, module)
+
+def _scan_definition(
+    body: list[dis.Instruction],
+    fn: CodeType,
+    start_idx: int,
+    i: int,
+    annotations: dict[str, InteropType],
+    decorator: str,
+    module: str
+) -> ExternFunction | None:
+    """
+    Scans the definition of an `@extern` or `@c_function` function that follows its
+    annotations, starting at `body[i]`.
+    """
 
-    if (
-        body[i + 0].opname != "BUILD_TUPLE" or
-        body[i + 1].opname != "LOAD_CONST" or
-        body[i + 2].opname != "MAKE_FUNCTION" or
-        body[i + 3].opname != "SET_FUNCTION_ATTRIBUTE" or
-        body[i + 4].opname != "CALL" or
-        body[i + 5].opname != "STORE_NAME"
-    ):
+    if body[i].opname != "LOAD_CONST" or body[i + 1].opname != "MAKE_FUNCTION":
         return None
-    
-    end_idx = i + 5 # points to STORE_NAME
-    
-    sym_name = fn.co_names[unwrap(body[i + 5].arg)]
+
+    code = body[i].argval
+    assert type(code) is CodeType
+
+    i += 2
+    if len(annotations) != 0:
+        if body[i].opname != "SET_FUNCTION_ATTRIBUTE" or body[i].arg != 4:
+            return None # e.g. a function with default values
+
+        i += 1
+
+    if body[i].opname != "CALL" or body[i + 1].opname != "STORE_NAME":
+        return None
+
+    end_idx = i + 1 # points to STORE_NAME
+
+    name = fn.co_names[unwrap(body[end_idx].arg)]
+
+    # Parameters without annotations take objects, and are ordered as in the signature.
+    param_types: dict[str, InteropType] = {
+        pname: annotations.get(pname, "OBJ")
+        for pname in code.co_varnames[:code.co_argcount]
+    }
+
+    return_type = annotations.get("return", "NONE")
+
+    if decorator == "extern":
+        return ExternFunction(start_idx, end_idx, ExternSpec(name, name, param_types, return_type))
 
     return ExternFunction(
         start_idx,
         end_idx,
         ExternSpec(
-            sym_name,
-            omit(annotations, "return"),
-            annotations.get("return", "NONE")
+            name,
+            f"pycfn__{module}_{name}",
+            param_types,
+            return_type,
+            _get_c_function_body(code)
         )
     )
 
-def create_marshalling_stub(extern: ExternSpec):
-    "Returns the definition of a marshalling stub representing the given extern function."
+def _get_c_function_body(code: CodeType):
+    "Returns the C code returned by the function of a `@c_function`."
+
+    # The only thing the function may do is returning a string literal, e.g.:
+    #       RESUME                   0
+    #       RETURN_CONST             1 ('uint16_t pport = port; ...')
+    instrs = [x for x in dis.get_instructions(code) if x.opname not in ("RESUME", "NOP")]
+
+    if len(instrs) == 1 and instrs[0].opname == "RETURN_CONST" and type(instrs[0].argval) is str:
+        return dedent(instrs[0].argval).strip()
+
+    error(f"the @c_function '{code.co_name}' must only return a string literal of C code!")
+    raise Exception("Invalid @c_function body.")
+
+def find_extern_calls(
+    instructions: list[dis.Instruction],
+    extern_names: dict[str, ExternSpec],
+    label_offsets: set[int]
+) -> dict[int, ExternCall]:
+    """
+    Finds all calls to the `@extern` functions in `extern_names`, which maps the names of
+    globals to the functions assigned to them, that pass all parameters positionally.
+    Returns a dictionary that maps the indices of the `CALL` instructions to the calls.
+    """
+    calls: dict[int, ExternCall] = {}
+
+    for call_idx, (name, arg_instrs) in find_global_calls(instructions, extern_names, label_offsets).items():
+        spec = extern_names[name]
+        param_types = list(spec.param_types.values())
+
+        if instructions[call_idx].arg != len(param_types):
+            continue # a wrong argument count is reported by the marshalling stub
+
+        # Constant arguments of the parameter type don't need to be checked.
+        single_args = single_value_args(arg_instrs, len(param_types))
+        if single_args is not None:
+            checked = [not _is_constant_of_type(x, t) for x, t in zip(single_args, param_types)]
+        else:
+            checked = [True] * len(param_types)
+
+        calls[call_idx] = ExternCall(spec, checked)
+
+    return calls
+
+def create_extern_declaration(extern: ExternSpec):
+    """
+    Returns the C declaration of the symbol imported by the given extern function - or, for
+    a `@c_function`, the definition of the `static inline` function that holds its body.
+    """
 
     ret = _interop_to_c_type(extern.return_type)
-    decl_params = ", ".join(f"{_interop_to_c_type(x[1])} {x[0]}" for x in extern.param_types.items())
+    decl_params = ", ".join(f"{_interop_to_c_type(x[1], True)} {x[0]}" for x in extern.param_types.items())
+
+    if extern.body is None:
+        return [f"extern {ret} {extern.symbol}({decl_params or 'void'});"]
+
+    return [
+        f"// @c_function {extern.name}",
+        f"static inline {ret} {extern.symbol}({decl_params or 'void'}) {{",
+        *(f"    {x}" if x != "" else "" for x in extern.body.splitlines()),
+        "}"
+    ]
+
+def create_marshalling_stub(extern: ExternSpec):
+    """
+    Returns the definition of a marshalling stub representing the given extern function,
+    along with the function object that wraps over it. The stub is used whenever the
+    function is called in a way `create_direct_call` doesn't cover.
+    """
+
+    argc = len(extern.param_types)
     call_params = ", ".join(f"arg_{x}" for x in extern.param_types.keys())
 
     body: list[str] = [
-        f"ASSERT(argc == {len(extern.param_types)});",
-        "ENSURE_NOT_NULL(argv);"
+        f"if (argc != {argc})",
+        f'    RAISE(TypeError, "{extern.name}() takes exactly {argc} argument{"" if argc == 1 else "s"}");',
+        ""
     ]
 
-    for i, (pname, ptype) in enumerate(extern.param_types.items()):
-        body.append(f"{_interop_to_c_type(ptype)} arg_{pname} = argv[{i}];")
+    if argc != 0:
+        body.append("ENSURE_NOT_NULL(argv);")
 
-    body.append(f"{_interop_to_c_type(extern.return_type)} ret = {extern.symbol}({call_params});")
+    for i, (pname, ptype) in enumerate(extern.param_types.items()):
+        c_type = _interop_to_c_type(ptype, True)
+        suffix = _interop_to_marshal_suffix(ptype)
+
+        if ptype == "INT":
+            body.extend([
+                f"if (argv[{i}]->type == &py_type_int && !PY_INT_IS_SMALL(argv[{i}]))",
+                f'    RAISE(OverflowError, "{extern.name}() argument \'{pname}\' is too large to convert to a C int64_t");'
+            ])
+
+        body.extend([
+            f"if (!IS_MARSHALLABLE_{suffix}(argv[{i}]))",
+            f'    RAISE(TypeError, "{extern.name}() argument \'{pname}\' must be {_interop_to_py_name(ptype)}");',
+            f"{c_type} arg_{pname} = UNMARSHAL_{suffix}(argv[{i}]);",
+            ""
+        ])
+
+    if extern.return_type == "NONE":
+        body.append(f"{extern.symbol}({call_params});")
+        body.append("return WITH_RESULT(&py_none);")
+    else:
+        body.append(f"{_interop_to_c_type(extern.return_type)} ret = {extern.symbol}({call_params});")
+        body.append(f"return MARSHALLED_{_interop_to_marshal_suffix(extern.return_type)}(ret);")
 
-    match extern.return_type:
-        case "INT":     body.append("return MARSHALLED_INT(ret);")
-        case "STRING":  body.append("return MARSHALLED_STR(ret);")
-        case "BOOL":    body.append("return MARSHALLED_BOOL(ret);")
-        case "FLOAT":   body.append("return MARSHALLED_FLOAT(ret);")
-        case "NONE":    body.append("return WITH_RESULT(&py_none);")
-        case "OBJ":     raise Exception("Cannot marshal a return type to pyobj_t*.")
-        
     return [
-        f"extern {ret} {extern.symbol}({decl_params});",
+        *create_extern_declaration(extern),
         "",
         f"PY_DEFINE({extern.c_name()}) {{",
-        *(f"    {x}" for x in body),
+        *(f"    {x}" if x != "" else "" for x in body),
+        "}",
+        "",
+        f"static pyobj_t FUNCTION_WRAPPER({extern.c_name()}) = {{",
+        "    .type = &py_type_function,",
+        f"    .as_function = &{extern.c_name()}",
+        "};"
+    ]
+
+def create_direct_call(call: ExternCall, exc_depth: int, exc_lasti: int):
+    """
+    Returns the C code that replaces a `CALL` to an `@extern` function with a direct call of
+    its symbol, with the arguments unboxed in place, and only the result being boxed. If the
+    called object turns out not to be the function, or an argument can't be marshalled, a
+    regular call is made - which, for the latter, raises the appropriate exception.
+    """
+    spec = call.spec
+    argc = len(spec.param_types)
+
+    conditions = [f"PY_IS_FUNCTION_CALL({spec.c_name()}, {argc})"]
+    args: list[str] = []
+
+    for i, (ptype, checked) in enumerate(zip(spec.param_types.values(), call.checked)):
+        suffix = _interop_to_marshal_suffix(ptype)
+        item = f"((pyobj_t*)STACK_ITEM({argc - i}))"
+
+        if checked:
+            conditions.append(f"IS_MARSHALLABLE_{suffix}({item})")
+
+        args.append(f"UNMARSHAL_{suffix}({item})")
+
+    invocation = f"{spec.symbol}({', '.join(args)})"
+
+    if spec.return_type == "NONE":
+        result = [f"    {invocation};", "    pyobj_t* extern_result = &py_none;"]
+    else:
+        result = [f"    pyobj_t* extern_result = MARSHAL_{_interop_to_marshal_suffix(spec.return_type)}({invocation});"]
+
+    return [
+        f"if ({' && '.join(conditions)}) {{",
+        *result,
+        f"    stack_current -= {argc + 2};",
+        "    STACK_PUSH() = extern_result;",
+        "} else {",
+        f"    PY_OPCODE_CALL({argc}, {exc_depth}, {exc_lasti});",
         "}"
     ]
@@ -0,0 +1,70 @@
+import dis
+from dataclasses import dataclass
+
+from .bytecode import find_global_calls, single_value_args
+
+MATH_KERNELS = {
+    "sqrt": ("std_sqrt", 1),
+    "fabs": ("std_fabs", 1),
+    "exp": ("std_exp", 1),
+    "log": ("std_log", 1),
+    "sin": ("std_sin", 1),
+    "cos": ("std_cos", 1),
+    "atan2": ("std_atan2", 2),
+    "pow": ("std_pow", 2)
+}
+"""
+Functions of the native `math` module that take and return `float`s, mapped to the C
+kernels that implement them and their argument counts. Calls to these are compiled to
+direct calls of the kernels. See `runtime/modules/math.h` and `runtime/std/fmath.h`.
+"""
+
+@dataclass
+class MathCall:
+    "Represents a call to a function of the `math` module that can call its kernel directly."
+
+    function: str
+    "The name of the called function, e.g. `sqrt`."
+
+    kernel: str
+    "The name of the C function that implements the function for `float` arguments."
+
+    checked: list[bool]
+    """
+    For every argument, `False` if it's known to be a `float` at compile-time, and `True`
+    if its type has to be checked at run-time.
+    """
+
+def _is_float_constant(instr: dis.Instruction):
+    return instr.opname == "LOAD_CONST" and type(instr.argval) is float
+
+def find_math_calls(
+    instructions: list[dis.Instruction],
+    math_names: dict[str, str],
+    label_offsets: set[int]
+) -> dict[int, MathCall]:
+    """
+    Finds all calls to the functions of the `math` module in `MATH_KERNELS`. `math_names`
+    maps the names of globals to the functions of the `math` module they were imported from.
+    Returns a dictionary that maps the indices of the `CALL` instructions to the calls.
+    """
+    calls: dict[int, MathCall] = {}
+    names = { name for name, function in math_names.items() if function in MATH_KERNELS }
+
+    for call_idx, (name, arg_instrs) in find_global_calls(instructions, names, label_offsets).items():
+        function = math_names[name]
+        kernel, expected_argc = MATH_KERNELS[function]
+
+        if instructions[call_idx].arg != expected_argc:
+            continue # e.g. log(x, base), which is left to the runtime
+
+        # When we know which arguments are constants, we know which ones are certainly `float`s.
+        single_args = single_value_args(arg_instrs, expected_argc)
+        if single_args is not None:
+            checked = [not _is_float_constant(x) for x in single_args]
+        else:
+            checked = [True] * expected_argc
+
+        calls[call_idx] = MathCall(function, kernel, checked)
+
+    return calls
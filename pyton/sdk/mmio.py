@@ -0,0 +1,132 @@
+import dis
+from dataclasses import dataclass
+
+from .bytecode import NB_AND, find_global_calls, single_value_args
+
+MMIO_BUILTINS = {
+    "read8": ("read", 8),
+    "read16": ("read", 16),
+    "read32": ("read", 32),
+    "read64": ("read", 64),
+    "write8": ("write", 8),
+    "write16": ("write", 16),
+    "write32": ("write", 32),
+    "write64": ("write", 64)
+}
+"""
+The builtins that access a single device register, mapped to their kind and the width
+of the access. Calls to these are compiled to inline volatile loads and stores. See
+`runtime/mmio.h`.
+"""
+
+@dataclass
+class MmioOperation:
+    """
+    Represents a `&` or a comparison with a non-negative `int` constant, applied to the
+    value returned by a register read. The two instructions of the operation - loading
+    the constant, and the operation itself - come right after the `CALL`.
+    """
+
+    operator: str
+    "The C operator that is applied to the value and the constant."
+
+    constant: int
+    "The constant operand."
+
+    const_index: int
+    "The index of the constant in `co_consts`."
+
+    instr: dis.Instruction
+    "The `BINARY_OP` or `COMPARE_OP` instruction."
+
+@dataclass
+class MmioCall:
+    "Represents a call to one of the `MMIO_BUILTINS`."
+
+    kind: str
+    "Either `'read'` or `'write'`."
+
+    width: int
+    "The width of the access, in bits."
+
+    checked: list[bool]
+    """
+    For every argument, `False` if it's known to be valid at compile-time - i.e. it's an
+    `int` constant that is a valid address or value - and `True` if it has to be checked
+    at run-time.
+    """
+
+    operation: MmioOperation | None = None
+    """
+    For reads, the operation the value is immediately used in, which is then compiled
+    together with the read, so that the value is never boxed.
+    """
+
+def _is_unsigned_constant(instr: dis.Instruction, width: int):
+    return (
+        instr.opname == "LOAD_CONST" and
+        type(instr.argval) is int and
+        0 <= instr.argval < min(2**width, 2**63)
+    )
+
+def _find_operation(
+    instructions: list[dis.Instruction],
+    call_idx: int,
+    label_offsets: set[int]
+) -> MmioOperation | None:
+    """
+    Returns the operation the result of the read `CALL` at `call_idx` is immediately used
+    in, if it's one that can be applied to the value before it's boxed.
+    """
+    if call_idx + 2 >= len(instructions):
+        return None
+
+    const_instr, op_instr = instructions[call_idx + 1], instructions[call_idx + 2]
+    if const_instr.offset in label_offsets or op_instr.offset in label_offsets:
+        return None
+
+    if not _is_unsigned_constant(const_instr, 64) or const_instr.arg is None:
+        return None
+
+    if op_instr.opname == "BINARY_OP" and op_instr.arg == NB_AND:
+        operator = "&"
+    elif op_instr.opname == "COMPARE_OP" and op_instr.arg is not None:
+        operator = dis.cmp_op[op_instr.arg >> 5]
+    else:
+        return None
+
+    return MmioOperation(operator, const_instr.argval, const_instr.arg, op_instr)
+
+def find_mmio_calls(
+    instructions: list[dis.Instruction],
+    shadowed_names: set[str],
+    label_offsets: set[int]
+) -> dict[int, MmioCall]:
+    """
+    Finds all calls to the `MMIO_BUILTINS`, except for the ones in `shadowed_names`, which
+    are known to refer to something else. Returns a dictionary that maps the indices of the
+    `CALL` instructions to the calls.
+    """
+    calls: dict[int, MmioCall] = {}
+    names = MMIO_BUILTINS.keys() - shadowed_names
+
+    for call_idx, (name, arg_instrs) in find_global_calls(instructions, names, label_offsets).items():
+        kind, width = MMIO_BUILTINS[name]
+        argc = 1 if kind == "read" else 2
+
+        if instructions[call_idx].arg != argc:
+            continue # the builtin reports the wrong argument count
+
+        # Constant addresses and values are proven to be valid, and are passed unchecked.
+        single_args = single_value_args(arg_instrs, argc)
+        if single_args is not None:
+            checked = [not _is_unsigned_constant(single_args[0], 64)]
+            if kind == "write":
+                checked.append(not _is_unsigned_constant(single_args[1], width))
+        else:
+            checked = [True] * argc
+
+        operation = _find_operation(instructions, call_idx, label_offsets) if kind == "read" else None
+        calls[call_idx] = MmioCall(kind, width, checked, operation)
+
+    return calls
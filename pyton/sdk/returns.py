@@ -0,0 +1,143 @@
+import dis
+import inspect
+from types import CodeType
+from dataclasses import dataclass
+
+from .bytecode import find_consuming_call
+
+@dataclass
+class ValuesCall:
+    """
+    Represents a call to a module-level function that always returns a tuple of the same
+    length, where the tuple is unpacked right after the call.
+    """
+
+    target: CodeType
+    "The code object of the function the callable is expected to be."
+
+    argc: int
+    "The amount of positional arguments passed to the function."
+
+    count: int
+    "The amount of values returned by the function."
+
+def get_return_count(fn: CodeType) -> int | None:
+    """
+    If every `return` of the given function returns a tuple of the same length, either built
+    right before returning (e.g. `return a, b`) or constant, returns the length. Otherwise,
+    returns `None`. Such functions are transpiled to a variant that returns the values through
+    an array, which is wrapped by the regular function - see `PY_DEFINE_VALUES` in the runtime.
+    """
+    if fn.co_name == "<module>":
+        return None
+
+    if (fn.co_flags & (inspect.CO_GENERATOR | inspect.CO_COROUTINE | inspect.CO_ASYNC_GENERATOR)) != 0:
+        return None
+
+    instructions = list(dis.get_instructions(fn))
+    label_offsets = set(dis.findlabels(fn.co_code)) # type: ignore
+    count = None
+
+    for i, instr in enumerate(instructions):
+        if instr.opname == "RETURN_VALUE":
+            # If we can jump right to the RETURN_VALUE, the tuple might not have been built
+            # by the instruction before it.
+            previous = instructions[i - 1] if i != 0 else None
+            if previous is None or previous.opname != "BUILD_TUPLE" or instr.offset in label_offsets:
+                return None
+
+            returned = previous.arg
+        elif instr.opname == "RETURN_CONST":
+            if type(instr.argval) is not tuple:
+                return None
+
+            returned = len(instr.argval)
+        else:
+            continue
+
+        if count is not None and returned != count:
+            return None
+
+        count = returned
+
+    return count if count != 0 else None
+
+def find_function_globals(module_fn: CodeType) -> dict[str, CodeType]:
+    """
+    Finds all globals of a module that are only ever assigned once, by a `def` statement
+    in the module-level code. Returns a dictionary that maps the names of the globals to
+    the code objects of the functions.
+    """
+    instructions = list(dis.get_instructions(module_fn))
+    functions: dict[str, CodeType] = {}
+    assignments: dict[str, int] = {}
+
+    for i, instr in enumerate(instructions):
+        if instr.opname not in ("STORE_NAME", "STORE_GLOBAL", "DELETE_NAME", "DELETE_GLOBAL"):
+            continue
+
+        assignments[instr.argval] = assignments.get(instr.argval, 0) + 1
+
+        # A `def` statement compiles to the following, where the annotations (if present)
+        # are set with SET_FUNCTION_ATTRIBUTE:
+        #       LOAD_CONST               0 (<code object f at 0x7f8c7028b2f0, file "<dis>", line 1>)
+        #       MAKE_FUNCTION
+        #       STORE_NAME               0 (f)
+        j = i - 1
+        while j > 0 and instructions[j].opname == "SET_FUNCTION_ATTRIBUTE" and instructions[j].arg == 0x04:
+            j -= 1
+
+        if j < 1 or instructions[j].opname != "MAKE_FUNCTION":
+            continue
+
+        code = instructions[j - 1].argval
+        if instructions[j - 1].opname == "LOAD_CONST" and type(code).__name__ == "code":
+            functions[instr.argval] = code
+
+    return { name: code for name, code in functions.items() if assignments[name] == 1 }
+
+def find_values_calls(
+    instructions: list[dis.Instruction],
+    functions: dict[str, CodeType],
+    label_offsets: set[int]
+) -> dict[int, ValuesCall]:
+    """
+    Finds all calls to the given functions (as returned by `find_function_globals`) that
+    always return a tuple of the same length, which is unpacked right away by an
+    `UNPACK_SEQUENCE` of that length. Returns a dictionary that maps the indices of the
+    `CALL` instructions to the calls.
+    """
+    calls: dict[int, ValuesCall] = {}
+
+    for i, instr in enumerate(instructions):
+        # Functions load the callable with LOAD_GLOBAL, which pushes the NULL itself, while
+        # module-level code does LOAD_NAME, followed by PUSH_NULL.
+        if instr.opname == "LOAD_GLOBAL" and instr.arg is not None and (instr.arg & 1) == 1:
+            args_idx = i + 1
+        elif instr.opname == "LOAD_NAME" and i + 1 < len(instructions) and instructions[i + 1].opname == "PUSH_NULL":
+            args_idx = i + 2
+        else:
+            continue
+
+        target = functions.get(instr.argval)
+        if target is None:
+            continue
+
+        count = get_return_count(target)
+        if count is None:
+            continue
+
+        call_idx = find_consuming_call(instructions, args_idx, label_offsets)
+        if call_idx is None or call_idx + 1 >= len(instructions):
+            continue
+
+        following = instructions[call_idx + 1]
+        if following.opname != "UNPACK_SEQUENCE" or following.arg != count or following.offset in label_offsets:
+            continue
+
+        argc = instructions[call_idx].arg
+        assert argc is not None
+
+        calls[call_idx] = ValuesCall(target, argc, count)
+
+    return calls
@@ -0,0 +1,260 @@
+import dis
+from dataclasses import dataclass
+
+from .bytecode import find_consuming_call
+
+STRUCT_FUNCTIONS = { "pack", "pack_into", "unpack", "unpack_from" }
+"""
+Functions of the native `struct` module that are specialized when called with a constant
+format string. See `runtime/modules/struct.h`.
+"""
+
+@dataclass
+class StructField:
+    code: str
+    "The format character of the field."
+
+    offset: int
+    "The offset of the field, in bytes."
+
+    size: int
+    "The size of the field, in bytes. For `s`, this is the length of the string."
+
+@dataclass
+class StructLayout:
+    size: int
+    "The total size of the format, in bytes."
+
+    little_endian: bool
+    "`True` if multi-byte values are stored in little-endian order."
+
+    fields: list[StructField]
+    "The fields that produce or consume a value, in order. Padding bytes do not have fields."
+
+@dataclass
+class StructCall:
+    "Represents a call to a function of the `struct` module with a constant format."
+
+    function: str
+    "The name of the called function, e.g. `unpack_from`."
+
+    format: str
+    "The format string, used for diagnostics."
+
+    layout: StructLayout
+    "The layout described by the format string."
+
+    argc: int
+    "The number of arguments of the call, including the format string."
+
+    destructured: bool
+    "`True` if the result of the call is immediately unpacked by an `UNPACK_SEQUENCE`."
+
+def _field_width(code: str, native: bool):
+    "Must match `field_width` in `runtime/modules/struct.c`."
+    match code:
+        case "x" | "c" | "b" | "B" | "?" | "s": return 1
+        case "h" | "H": return 2
+        case "i" | "I" | "f": return 4
+        case "l" | "L": return 8 if native else 4
+        case "q" | "Q" | "d": return 8
+        case "n" | "N" | "P": return 8 if native else 0
+        case _: return 0
+
+def get_struct_layout(fmt: str | bytes) -> StructLayout | None:
+    """
+    Computes the layout of the given `struct` format string, in the same way as the runtime
+    does. Returns `None` if the format is not valid, or uses format characters that kernels
+    are not generated for (`e` and `p`) - in which case the call is left to the runtime.
+    """
+    if isinstance(fmt, bytes):
+        try:
+            fmt = fmt.decode("ascii")
+        except UnicodeDecodeError:
+            return None
+
+    i = 0
+    native = True
+    little_endian = True
+
+    if fmt[:1] in ("@", "=", "<", ">", "!"):
+        native = fmt[0] == "@"
+        little_endian = fmt[0] not in (">", "!")
+        i = 1
+
+    size = 0
+    fields: list[StructField] = []
+
+    while i < len(fmt):
+        code = fmt[i]
+        if code in " \t\n\r":
+            i += 1
+            continue
+
+        repeat = 1
+        if code.isdigit():
+            start = i
+            while i < len(fmt) and fmt[i].isdigit():
+                i += 1
+
+            if i == len(fmt):
+                return None
+
+            repeat = int(fmt[start:i])
+            code = fmt[i]
+
+        i += 1
+
+        width = _field_width(code, native)
+        if width == 0:
+            return None
+
+        if native:
+            size = (size + width - 1) // width * width
+
+        if code == "s":
+            fields.append(StructField(code, size, repeat))
+            size += repeat
+        elif code == "x":
+            size += repeat
+        else:
+            for _ in range(repeat):
+                fields.append(StructField(code, size, width))
+                size += width
+
+        # Don't unroll huge formats - the runtime interprets those just fine.
+        if len(fields) > 64:
+            return None
+
+    return StructLayout(size, little_endian, fields)
+
+def find_struct_calls(
+    instructions: list[dis.Instruction],
+    struct_names: dict[str, str],
+    label_offsets: set[int]
+) -> dict[int, StructCall]:
+    """
+    Finds all calls to functions of the `struct` module with a constant format string.
+    `struct_names` maps the names of globals to the functions of the `struct` module they
+    were imported from. Returns a dictionary that maps the indices of the `CALL` instructions
+    to the calls.
+    """
+    calls: dict[int, StructCall] = {}
+
+    for i, instr in enumerate(instructions):
+        # Functions load the callable with LOAD_GLOBAL, which pushes the NULL itself, while
+        # module-level code does LOAD_NAME, followed by PUSH_NULL.
+        if instr.opname == "LOAD_GLOBAL" and instr.arg is not None and (instr.arg & 1) == 1:
+            fmt_idx = i + 1
+        elif instr.opname == "LOAD_NAME" and i + 1 < len(instructions) and instructions[i + 1].opname == "PUSH_NULL":
+            fmt_idx = i + 2
+        else:
+            continue
+
+        function = struct_names.get(instr.argval)
+        if function not in STRUCT_FUNCTIONS or fmt_idx >= len(instructions):
+            continue
+
+        fmt_instr = instructions[fmt_idx]
+        if fmt_instr.opname != "LOAD_CONST" or not isinstance(fmt_instr.argval, (str, bytes)):
+            continue
+
+        layout = get_struct_layout(fmt_instr.argval)
+        if layout is None:
+            continue
+
+        call_idx = find_consuming_call(instructions, fmt_idx, label_offsets)
+        if call_idx is None:
+            continue
+
+        argc = instructions[call_idx].arg
+        assert argc is not None
+
+        count = len(layout.fields)
+        expected_argc = {
+            "pack": (1 + count,),
+            "pack_into": (3 + count,),
+            "unpack": (2,),
+            "unpack_from": (2, 3)
+        }[function]
+
+        if argc not in expected_argc:
+            continue # let the runtime raise the exception
+
+        following = instructions[call_idx + 1] if call_idx + 1 < len(instructions) else None
+        destructured = (
+            function in ("unpack", "unpack_from") and
+            count != 0 and
+            following is not None and
+            following.opname == "UNPACK_SEQUENCE" and
+            following.arg == count and
+            following.offset not in label_offsets
+        )
+
+        calls[call_idx] = StructCall(function, fmt_instr.argval, layout, argc, destructured)
+
+    return calls
+
+def emit_unpack_kernel(name: str, call: StructCall):
+    "Emits a C function that unpacks all fields of the given call's layout."
+    layout = call.layout
+    le = "true" if layout.little_endian else "false"
+
+    lines = [
+        f"// Unpacks struct format {call.format!r} ({layout.size} bytes)",
+        f"static inline void {name}(const uint8_t* data, pyobj_t** out) {{"
+    ]
+
+    for i, field in enumerate(layout.fields):
+        at = f"data + {field.offset}"
+
+        match field.code:
+            case "c" | "s":
+                value = f"py_alloc_bytes({at}, {field.size})"
+            case "?":
+                value = f"AS_PY_BOOL(data[{field.offset}] != 0)"
+            case "f" | "d":
+                value = f"py_struct_box_float(py_struct_load({at}, {field.size}, {le}), {field.size})"
+            case _:
+                is_signed = "true" if field.code.islower() else "false"
+                value = f"py_struct_box_int(py_struct_load({at}, {field.size}, {le}), {field.size}, {is_signed})"
+
+        lines.append(f"    out[{i}] = {value};")
+
+    lines.append("}")
+    return "\n".join(lines)
+
+def emit_pack_kernel(name: str, call: StructCall):
+    """
+    Emits a C function that packs values into all fields of the given call's layout. The
+    bytes it writes to have to be zeroed beforehand.
+    """
+    layout = call.layout
+    le = "true" if layout.little_endian else "false"
+
+    lines = [
+        f"// Packs struct format {call.format!r} ({layout.size} bytes)",
+        f"static inline pyobj_t* {name}(uint8_t* data, pyobj_t** values) {{"
+    ]
+
+    for i, field in enumerate(layout.fields):
+        at = f"data + {field.offset}"
+
+        match field.code:
+            case "c":
+                store = f"py_struct_store_bytes({at}, 1, true, values[{i}])"
+            case "s":
+                store = f"py_struct_store_bytes({at}, {field.size}, false, values[{i}])"
+            case "?":
+                store = f"py_struct_store_bool({at}, values[{i}])"
+            case "f" | "d":
+                store = f"py_struct_store_float({at}, {field.size}, {le}, values[{i}])"
+            case _:
+                is_signed = "true" if field.code.islower() else "false"
+                store = f"py_struct_store_int({at}, {field.size}, {is_signed}, {le}, '{field.code}', values[{i}])"
+
+        lines.append(f"    PY_STRUCT_TRY({store});")
+
+    lines.append("    return NULL;")
+    lines.append("}")
+    return "\n".join(lines)
@@ -8,17 +8,65 @@ from typing import Protocol, Any
 from dataclasses import dataclass
 
 from .bytecode import *
-from .importing import FullImport, SelectiveImport, get_all_imports, resolve_import
+from .importing import FullImport, SelectiveImport, get_all_imports, resolve_import, is_native_module
 from .util import error, find, flatten
 from .simplification import simplify_bytecode
-from .interop import ExternSpec, get_all_externs
+from .interop import ExternSpec, get_all_externs, find_extern_calls, create_marshalling_stub, create_direct_call
+from .structs import StructCall, find_struct_calls, emit_pack_kernel, emit_unpack_kernel
+from .maths import MathCall, find_math_calls
+from .mmio import MmioCall, find_mmio_calls
+from .returns import ValuesCall, get_return_count, find_function_globals, find_values_calls
+
+# Must match `PY_SET_BITSET_LIMIT` in `runtime/sets.h`.
+SET_BITSET_LIMIT = 4096
+
+# Maps the operators of `COMPARE_OP` to the names `PY_OPCODE_COMPARISON` takes.
+COMPARISON_OPS = {
+    "<": "lt",
+    "<=": "lte",
+    "==": "equ",
+    "!=": "neq",
+    ">": "gt",
+    ">=": "gte"
+}
 
 def c_bool(x: bool):
     return "true" if x else "false"
 
+def c_string_literal(x: str):
+    "Converts `x` to a C string literal holding its UTF-8 encoding."
+    return c_bytes_literal(x.encode("utf-8", "surrogatepass"))
+
+def c_bytes_literal(x: bytes):
+    "Converts `x` to a C string literal holding the given bytes."
+    escaped = []
+    for byte in x:
+        char = chr(byte)
+        if char in ('"', "\\"):
+            escaped.append("\\" + char)
+        elif 0x20 <= byte < 0x7F:
+            escaped.append(char)
+        else:
+            # Octal escapes are at most 3 digits long, so unlike hex escapes, they can't
+            # swallow the characters that come after them.
+            escaped.append(f"\\{byte:03o}")
+
+    return '"' + "".join(escaped) + '"'
+
 def sanitize_identifier(x: str):
     return re.sub(r"[^_A-Za-z0-9]", "__", x)
 
+def const_key(const) -> Any:
+    "Returns a key that identifies `const` by both its type and its exact value."
+    if type(const) is float:
+        return (float, const.hex())
+    elif type(const) is tuple:
+        return (tuple, tuple(const_key(item) for item in const))
+    elif type(const) is frozenset:
+        return (frozenset, frozenset(const_key(item) for item in const))
+
+    return (type(const), const)
+
 def wellknown_global_macro(name: str):
     return f"PY_GLOBAL_{sanitize_identifier(name)}_WELLKNOWN"
 
@@ -33,6 +81,26 @@ class ExceptionTableEntry(Protocol):
 class TranspiledFunction:
     body: str
     origin: CodeType
+    resumable_body: str | None = None
+    """
+    For generators and coroutines, the body of the `PY_DEFINE_RESUMABLE` function that
+    holds the actual code. In this case, `body` only creates the frame.
+    """
+
+    return_count: int | None = None
+    """
+    For functions that always return a tuple of the same length, the length of the tuple.
+    In this case, `body` is the body of the `PY_DEFINE_VALUES` function that returns the
+    items of the tuple.
+    """
+
+def resumable_name(mangled_name: str):
+    "Returns the name of the `PY_DEFINE_RESUMABLE` function for a generator or coroutine."
+    return f"{mangled_name}__resume"
+
+def values_name(mangled_name: str):
+    "Returns the name of the `PY_DEFINE_VALUES` function for a function that returns a fixed-size tuple."
+    return f"{mangled_name}__values"
 
 class Module:
     "Represents data exclusive to a single module."
@@ -47,6 +115,15 @@ class Module:
         self.transpiled: dict[str, TranspiledFunction] = {}
         "Stores mappings between mangled function names and their C function bodies."
 
+        self.native_globals: dict[str, tuple[str, str]] = {}
+        "Maps the names of globals imported from native modules to their `(module, name)` origin."
+
+        self.function_globals: dict[str, CodeType] = {}
+        "Maps the names of globals that are only ever assigned by a `def` statement to the code objects of the functions."
+
+        self.extern_globals: dict[str, ExternSpec] = {}
+        "Maps the names of globals assigned by `@extern` and `@c_function` definitions to the specifications of the functions."
+
 class TranslationUnit:
     """
     Represents a single translation unit, which contains C function bodies that
@@ -63,10 +140,17 @@ class TranslationUnit:
         self.const_definitions: list[str] = []
         "C definitions of known constants."
 
+        self.struct_kernels: dict[tuple[str, str | bytes], str] = {}
+        "Maps `(kind, format)` pairs to the names of the `struct` kernels generated for them."
+
+        self.struct_kernel_definitions: list[str] = []
+        "C definitions of the generated `struct` kernels."
+
         self.modules: dict[str, Module] = {}
         "All defined modules."
 
-        self.externs: list[ExternSpec]
+        self.externs: dict[str, ExternSpec] = {}
+        "Maps the symbols imported by `@extern` functions, and generated for `@c_function`s, to their specifications."
 
     def all_transpiled(self):
         "Returns a dictionary of all transpiled functions across all modules."
@@ -102,10 +186,14 @@ class TranslationUnit:
         - `int`,
         - `float`,
         - `tuple`,
+        - `frozenset`,
         - `code`.
         """
-        if const in self.known_consts:
-            return self.known_consts[const]
+        # Equal constants of different types (e.g. `1`, `1.0` and `True`) have to map
+        # to different objects - and so do `0.0` and `-0.0`.
+        key = const_key(const)
+        if key in self.known_consts:
+            return self.known_consts[key]
         
         if type(const) is bool:
             return "py_true" if const else "py_false";
@@ -114,14 +202,52 @@ class TranslationUnit:
 
         name = f"py_const_{self.next_const_id}"
         self.next_const_id += 1
-        self.known_consts[const] = name
+        self.known_consts[key] = name
 
         if type(const) is str:
-            self.const_definitions.append(f'static pyobj_t {name} = {{ .type = &py_type_str, .as_str = STR("{const.replace("\n", "\\n").replace("\r", "")}") }};')
+            # We analyze the string here, so that the runtime doesn't have to.
+            flags = "PY_STR_ANALYZED | PY_STR_ASCII" if const.isascii() else "PY_STR_ANALYZED"
+            self.const_definitions.append(
+                f"static pyobj_t {name} = {{ .type = &py_type_str, .as_str = STR({c_string_literal(const)}), "
+                f".str_flags = {flags}, .str_codepoints = {len(const)} }};"
+            )
+        elif type(const) is bytes:
+            self.const_definitions.append(
+                f"static pyobj_t {name} = {{ .type = &py_type_bytes, .as_buffer = {{ "
+                f".data = (uint8_t*){c_bytes_literal(const)}, .length = {len(const)}, .capacity = {len(const)}, "
+                ".format = 'B', .itemsize = 1, .readonly = true } };"
+            )
         elif type(const) is int:
-            self.const_definitions.append(f"static pyobj_t {name} = {{ .type = &py_type_int, .as_int = {const} }};")
+            if -(2 ** 63) < const < 2 ** 63:
+                self.const_definitions.append(f"static pyobj_t {name} = {{ .type = &py_type_int, .as_int = {const} }};")
+            elif const == -(2 ** 63):
+                # The literal 9223372036854775808 doesn't fit in an int64_t, so we can't negate it.
+                self.const_definitions.append(f"static pyobj_t {name} = {{ .type = &py_type_int, .as_int = INT64_MIN }};")
+            else:
+                # The constant doesn't fit in 64 bits - we store it as a big integer, with
+                # its magnitude split into 64-bit limbs, least significant first.
+                magnitude = abs(const)
+                limbs: list[str] = []
+                while magnitude != 0:
+                    limbs.append(f"{hex(magnitude & 0xFFFFFFFFFFFFFFFF)}ull")
+                    magnitude >>= 64
+
+                self.const_definitions.append(f"static const bigint_limb_t {name}_limbs[] = {{ {', '.join(limbs)} }};")
+                self.const_definitions.append(
+                    f"static bigint_t {name}_bigint = {{ .limbs = {name}_limbs, .length = {len(limbs)}, .negative = {c_bool(const < 0)} }};"
+                )
+                self.const_definitions.append(f"static pyobj_t {name} = {{ .type = &py_type_int, .as_bigint = &{name}_bigint }};")
         elif type(const) is float:
-            self.const_definitions.append(f"static pyobj_t {name} = {{ .type = &py_type_float, .as_float = {const} }};")
+            # Hexadecimal literals represent the value exactly, which `repr` does not
+            # guarantee once the C compiler parses it back.
+            if const != const:
+                value = '__builtin_nan("")'
+            elif const in (float("inf"), float("-inf")):
+                value = "__builtin_inf()" if const > 0 else "-__builtin_inf()"
+            else:
+                value = const.hex()
+
+            self.const_definitions.append(f"static pyobj_t {name} = {{ .type = &py_type_float, .as_float = {value} }};")
         elif type(const) is tuple:
             items: list[str] = []
             for item in const:
@@ -141,6 +267,32 @@ class TranslationUnit:
             self.const_definitions.append(f"        .capacity = {len(const)}")
             self.const_definitions.append("    }")
             self.const_definitions.append("};")
+        elif type(const) is frozenset:
+            if all(type(item) is int and 0 <= item < SET_BITSET_LIMIT for item in const):
+                # Sets of small non-negative integers are stored as bitsets, which we can
+                # build right here.
+                words = [0] * ((max(const, default = -1) // 64) + 1)
+                for item in const:
+                    words[item // 64] |= 1 << (item % 64)
+
+                if len(words) != 0:
+                    self.const_definitions.append(
+                        f"static uint64_t {name}_bits[] = " + "{ " + ", ".join(f"{hex(word)}ull" for word in words) + " };"
+                    )
+
+                bits = f"{name}_bits" if len(words) != 0 else "NULL"
+                self.const_definitions.append(
+                    f"static set_data_t {name}_data = {{ .length = {len(const)}, .is_bitset = true, .bits = {bits}, .words = {len(words)} }};"
+                )
+            else:
+                # Otherwise, we'd have to compute the hashes of the elements - instead,
+                # we let the runtime add them once the set is first used.
+                elements = self.get_or_create_const(tuple(const), source_bytecode, source_fn, source_path, source_module)
+                self.const_definitions.append(
+                    f"static set_data_t {name}_data = {{ .is_bitset = true, .pending = &{elements} }};"
+                )
+
+            self.const_definitions.append(f"static pyobj_t {name} = {{ .type = &py_type_frozenset, .as_set = &{name}_data }};")
         elif type(const).__name__ == "code":
             # If we have a 'code' constant, this means that this is a callable.
             code: CodeType = const
@@ -158,8 +310,9 @@ class TranslationUnit:
 
                     continue
 
-                # We've encountered a LOAD_BUILD_CLASS instruction, now we
-                # check if any LOAD_CONST's appear that reference this code constant
+                # We've encountered a LOAD_BUILD_CLASS instruction, now we check if
+                # the first LOAD_CONST after it references this code constant. Code
+                # constants loaded later on belong to other functions.
                 if instr.opname != "LOAD_CONST":
                     continue
 
@@ -167,6 +320,8 @@ class TranslationUnit:
                     code_is_class_body = True
                     break
 
+                searching_for_build_class = True
+
             target_fn = self.translate(code, source_path, source_module, code_is_class_body)
             self.const_definitions.append(f"static pyobj_t {name} = {{ .type = &py_type_function, .as_function = &{target_fn} }};")
         else:
@@ -178,6 +333,134 @@ class TranslationUnit:
 
         return name
 
+    def get_or_create_struct_kernel(self, call: StructCall, kind: str):
+        """
+        Gets or creates the kernel that packs (if `kind` is `'pack'`) or unpacks (if `kind`
+        is `'unpack'`) values of the format of the given `struct` call, and returns its name.
+        """
+        key = (kind, call.format)
+        if key in self.struct_kernels:
+            return self.struct_kernels[key]
+
+        name = f"py_structfmt_{len(self.struct_kernels) + 1}_{kind}"
+        self.struct_kernels[key] = name
+
+        emit = emit_pack_kernel if kind == "pack" else emit_unpack_kernel
+        self.struct_kernel_definitions.append(emit(name, call))
+        self.struct_kernel_definitions.append("")
+        return name
+
+    def specialize_struct_call(self, call: StructCall, exc_depth: int, exc_lasti: int):
+        """
+        Returns the C code that replaces a `CALL` to a function of the `struct` module with a
+        constant format - and, if `call.destructured` is set, the `UNPACK_SEQUENCE` after it.
+        If the called object turns out not to be the `struct` function, a regular call is made.
+        """
+        size = call.layout.size
+        count = len(call.layout.fields)
+        argc = call.argc
+
+        match call.function:
+            case "unpack" | "unpack_from":
+                kernel = self.get_or_create_struct_kernel(call, "unpack")
+                macro = "PY_STRUCT_UNPACK_CONST_DESTRUCTURED" if call.destructured else "PY_STRUCT_UNPACK_CONST"
+                exact = c_bool(call.function == "unpack")
+                specialized = f"{macro}({kernel}, {size}, {count}, {argc}, {exact}, {exc_depth}, {exc_lasti});"
+            case "pack":
+                kernel = self.get_or_create_struct_kernel(call, "pack")
+                specialized = f"PY_STRUCT_PACK_CONST({kernel}, {size}, {argc}, {exc_depth}, {exc_lasti});"
+            case "pack_into":
+                kernel = self.get_or_create_struct_kernel(call, "pack")
+                specialized = f"PY_STRUCT_PACK_INTO_CONST({kernel}, {size}, {argc}, {exc_depth}, {exc_lasti});"
+            case _:
+                raise Exception(f"Unknown struct function: {call.function}")
+
+        lines = [
+            f"if (PY_STRUCT_IS_CALL({call.function}, {argc})) {{",
+            f"    {specialized}",
+            "} else {",
+            f"    PY_OPCODE_CALL({argc}, {exc_depth}, {exc_lasti});"
+        ]
+
+        if call.destructured:
+            lines.append(f"    PY_OPCODE_UNPACK_SEQUENCE({count}, {exc_depth}, {exc_lasti});")
+
+        lines.append("}")
+        return lines
+
+    def specialize_math_call(self, call: MathCall, exc_depth: int, exc_lasti: int):
+        """
+        Returns the C code that replaces a `CALL` to a function of the `math` module with a
+        direct call of its kernel. If the called object turns out not to be the `math`
+        function, or the arguments aren't `float`s, a regular call is made.
+        """
+        argc = len(call.checked)
+        checked = ", ".join(c_bool(x) for x in call.checked)
+
+        return [
+            f"if (!PY_MATH_TRY_CALL{argc}({call.function}, {call.kernel}, {checked})) {{",
+            f"    PY_OPCODE_CALL({argc}, {exc_depth}, {exc_lasti});",
+            "}"
+        ]
+
+    def specialize_mmio_call(self, call: MmioCall, exc_depth: int, exc_lasti: int):
+        """
+        Returns the C code that replaces a `CALL` to one of the register access builtins with
+        an inline volatile load or store. If the called object turns out not to be the
+        builtin, or the arguments aren't valid, a regular call is made.
+
+        If the value that is read is immediately masked or compared with a constant, the
+        operation is applied to the unboxed value, and the code replaces the instructions
+        of the operation as well.
+        """
+        argc = len(call.checked)
+        checked = ", ".join(c_bool(x) for x in call.checked)
+        operation = call.operation
+
+        if operation is None:
+            macro = "PY_MMIO_TRY_READ" if call.kind == "read" else "PY_MMIO_TRY_WRITE"
+            return [
+                f"if (!{macro}({call.width}, {checked})) {{",
+                f"    PY_OPCODE_CALL({argc}, {exc_depth}, {exc_lasti});",
+                "}"
+            ]
+
+        if operation.operator == "&":
+            fast_path = f"PY_MMIO_TRY_READ_AND({call.width}, {checked}, {hex(operation.constant)})"
+            slow_path = f"PY_OPCODE_OPERATION(and, {exc_depth}, {exc_lasti});"
+        else:
+            assert operation.instr.arg is not None
+            coerce_bool = (operation.instr.arg & 16) != 0
+            op = COMPARISON_OPS[operation.operator]
+
+            fast_path = f"PY_MMIO_TRY_READ_COMPARE({call.width}, {checked}, {operation.operator}, {hex(operation.constant)})"
+            slow_path = f"PY_OPCODE_COMPARISON({op}, {c_bool(coerce_bool)}, {exc_depth}, {exc_lasti});"
+
+        return [
+            f"if (!{fast_path}) {{",
+            f"    PY_OPCODE_CALL({argc}, {exc_depth}, {exc_lasti});",
+            f"    stack[++stack_current] = &const_{operation.const_index};",
+            f"    {slow_path}",
+            "}"
+        ]
+
+    def specialize_values_call(self, call: ValuesCall, module: str, exc_depth: int, exc_lasti: int):
+        """
+        Returns the C code that replaces a `CALL` to a function that returns a fixed-size
+        tuple, along with the `UNPACK_SEQUENCE` after it. If the called object turns out not
+        to be the function, a regular call is made.
+        """
+        target = self.mangle(call.target, module)
+
+        return [
+            f"if (PY_IS_FUNCTION_CALL({target}, {call.argc})) {{",
+            f"    PY_CALL_VALUES({values_name(target)}, {call.argc}, {call.count}, {exc_depth}, {exc_lasti});",
+            "} else {",
+            f"    PY_OPCODE_CALL({call.argc}, {exc_depth}, {exc_lasti});",
+            f"    PY_OPCODE_UNPACK_SEQUENCE({call.count}, {exc_depth}, {exc_lasti});",
+            "}"
+        ]
+
     def translate(
         self,
         fn: CodeType,
@@ -201,17 +484,44 @@ class TranslationUnit:
         if is_module:
             assert not is_class_body
             self.modules[module] = Module(module)
+            self.modules[module].function_globals = find_function_globals(fn)
+
+        if (fn.co_flags & inspect.CO_ASYNC_GENERATOR) != 0:
+            raise Exception("Asynchronous generators are not yet supported.")
+
+        # Generators and coroutines keep their state in a heap-allocated frame, so that
+        # they can be suspended and resumed. See `generators.h` in the runtime.
+        is_resumable = (fn.co_flags & (inspect.CO_GENERATOR | inspect.CO_COROUTINE)) != 0
+        is_coroutine = (fn.co_flags & inspect.CO_COROUTINE) != 0
+        assert not (is_resumable and (is_module or is_class_body))
+
+        # Functions that always return a tuple of the same length return its items through
+        # an array instead - see `PY_DEFINE_VALUES` in the runtime.
+        return_count = get_return_count(fn) if not is_class_body else None
 
         defined_preprocessor_syms = ["PY__EXCEPTION_HANDLER_LABEL"]
 
         body = [
-            f"// Function {fn.co_qualname} of module {module}, declared on line {fn.co_firstlineno}, class body: {'yes' if is_class_body else 'no'}",
-            f"void* stack[{fn.co_stacksize + 1}] = {{}};",
-            f"int stack_current = -1;",
-            f"pyobj_t* caught_exception = NULL;",
-            f"#define PY__EXCEPTION_HANDLER_LABEL L_uncaught_exception"
+            f"// Function {fn.co_qualname} of module {module}, declared on line {fn.co_firstlineno}, class body: {'yes' if is_class_body else 'no'}"
         ]
 
+        if not is_resumable:
+            body.append(f"void* stack[{fn.co_stacksize + 1}] = {{}};")
+            body.append(f"int stack_current = -1;")
+            body.append(f"pyobj_t* caught_exception = NULL;")
+        else:
+            # The value stack, locals and the exception being handled all live in the frame.
+            body.append("#define stack (frame->stack)")
+            body.append("#define stack_current (frame->stack_current)")
+            body.append("#define caught_exception (frame->caught_exception)")
+            defined_preprocessor_syms.extend(["stack", "stack_current", "caught_exception"])
+
+            for i, name in enumerate(fn.co_varnames):
+                body.append(f"#define loc_{name} (frame->locals[{i}])")
+                defined_preprocessor_syms.append(f"loc_{name}")
+
+        body.append(f"#define PY__EXCEPTION_HANDLER_LABEL L_uncaught_exception")
+
         if is_module:
             body.append("")
             body.append(f"MODULE_PROLOGUE({module});")
@@ -222,10 +532,36 @@ class TranslationUnit:
         bytecode = dis.Bytecode(fn)
         exc_table: list[ExceptionTableEntry] = bytecode.exception_entries
         
-        externs = get_all_externs(bytecode)
+        externs = get_all_externs(bytecode, module) if is_module else []
         imports = get_all_imports(bytecode)
+
+        for extern in externs:
+            previous = self.externs.get(extern.spec.symbol)
+            if previous is not None and previous != extern.spec:
+                error(f"the symbol '{extern.spec.symbol}' is defined by multiple @extern or @c_function functions that differ!")
+                raise Exception("Conflicting @extern or @c_function declarations.")
+
+            # The definition is replaced by an assignment of the function object that wraps
+            # over the marshalling stub - see the STORE_NAME that ends it below.
+            self.externs[extern.spec.symbol] = extern.spec
+            self.modules[module].extern_globals[extern.spec.name] = extern.spec
         
         for imprt in imports:
+            if is_native_module(imprt.name):
+                if type(imprt) is not SelectiveImport:
+                    error(f"the native module '{imprt.name}' can only be imported selectively!")
+                    error(f"try 'from {imprt.name} import ...' instead.")
+                    raise Exception("Full imports are not yet supported.")
+
+                # Native modules are provided by the runtime - there's nothing to translate
+                # or initialize, we only need to copy over the globals.
+                body.append(f"// from {imprt.name} import {', '.join(f'({x} as {y})' for x, y in imprt.targets)} (native)")
+                for from_target, to_target in imprt.targets:
+                    body.append(f"{self.mangle_global(to_target, module)} = {self.mangle_global(from_target, imprt.name)};")
+                    self.modules[module].native_globals[to_target] = (imprt.name, from_target)
+
+                continue
+
             path = resolve_import(source_path, imprt.name)
 
             # This function is the <module> function of the imported module.
@@ -265,9 +601,29 @@ class TranslationUnit:
                 for from_target, to_target in imprt.targets:
                     body.append(f"{self.mangle_global(to_target, module)} = {self.mangle_global(from_target, imprt.name)};")
 
-        ignore_ranges = [(x.start, x.end) for x in imports] + simplify_bytecode(bytecode)
+        ignore_ranges = [(x.start, x.end) for x in imports + externs] + simplify_bytecode(bytecode)
+        extern_stores = { x.end: x.spec for x in externs }
+
+        # The constants that native imports load (their level and fromlist) never make it
+        # into the generated code, as we copy over the globals directly. Unless something
+        # else loads them too, we don't create them, as they'd be unused.
+        native_import_ranges = [(x.start, x.end) for x in imports if is_native_module(x.name)]
+        loaded_consts: set[int] = set()
+        native_import_consts: set[int] = set()
+
+        for instr_idx, instr in enumerate(bytecode):
+            if instr.opcode not in dis.hasconst or instr.arg is None:
+                continue
+
+            if any(instr_idx >= r[0] and instr_idx <= r[1] for r in native_import_ranges):
+                native_import_consts.add(instr.arg)
+            else:
+                loaded_consts.add(instr.arg)
 
         for i, const in enumerate(fn.co_consts):
+            if i in native_import_consts and i not in loaded_consts:
+                continue
+
             const_sym = self.get_or_create_const(const, bytecode, fn, source_path, module)
             body.append(f"#define const_{i} ({const_sym})")
             defined_preprocessor_syms.append(f"const_{i}")
@@ -278,11 +634,16 @@ class TranslationUnit:
         # Locals behave differently in both the module and class body scope.
         # In modules, locals are equivalent to globals.
         # In class bodies, locals are equivalent to `self`.
+        # For resumable functions, the arguments are bound by the function that creates
+        # the frame instead.
+        arg_binding = body if not is_resumable else []
+
         if not is_module and not is_class_body:
-            body.append("int argc_all = argc + (( self != NULL ? 1 : 0 ));")
+            arg_binding.append("int argc_all = argc + (( self != NULL ? 1 : 0 ));")
 
-            for name in fn.co_varnames:
-                body.append(f"pyobj_t* loc_{name} = NULL;")
+            if not is_resumable:
+                for name in fn.co_varnames:
+                    arg_binding.append(f"pyobj_t* loc_{name} = NULL;")
 
             # Arguments also boil down to variables - their names are in the following order
             # in the co_varnames list:
@@ -292,26 +653,39 @@ class TranslationUnit:
             #   - varargs tuple name e.g. `*args` (if inspect.CO_VARARGS is set),
             #   - varkeywords tuple name e.g. `**kwargs` (if inspect.CO_VARKEYWORDS is set).
             
+            # TODO: Transpiled functions don't bind keyword arguments yet - they can only be
+            #       passed to functions provided by the runtime.
+            arg_binding.append("PY_NO_KW_ARGS();")
+
             if (fn.co_flags & inspect.CO_VARARGS) == 0:
                 # We don't have a varargs tuple, so we may encounter a situation where
                 # we have too many positional arguments.
-                body.append(f"PY_POS_ARG_MAX({fn.co_argcount});")
+                arg_binding.append(f"PY_POS_ARG_MAX({fn.co_argcount});")
             
             if fn.co_argcount != 0:
                 # TODO: This will need to change when we add support for default arguments, which
                 #       Python implements in an extremely silly way, where they are not even part
                 #       of the code object itself.
-                body.append(f"PY_POS_ARG_MIN({fn.co_argcount});")
+                arg_binding.append(f"PY_POS_ARG_MIN({fn.co_argcount});")
+
+            if is_resumable:
+                arg_binding.append(f"py_frame_t* frame = py_alloc_frame({fn.co_stacksize + 1}, {len(fn.co_varnames)});")
 
             # Copy positional-or-keyword + positional arguments
-            body.append(
+            arg_binding.append(
                 "pyobj_t** pos_args[] = { " + ", ".join(
-                    f"&loc_{fn.co_varnames[i]}" for i in range(fn.co_argcount)
+                    f"&loc_{fn.co_varnames[i]}" if not is_resumable else f"&frame->locals[{i}]"
+                    for i in range(fn.co_argcount)
                 ) + " };"
             )
 
             # This will also account for 'self'.
-            body.append(f"PY_POS_ARGS_TO_VARS({fn.co_argcount});")
+            arg_binding.append(f"PY_POS_ARGS_TO_VARS({fn.co_argcount});")
+
+            if is_resumable:
+                arg_binding.append(
+                    f"return WITH_RESULT(py_alloc_generator(frame, &{resumable_name(mangled_name)}, {c_bool(is_coroutine)}));"
+                )
 
         if is_class_body:
             # For class bodies, self must ALWAYS be provided. This is special-cased
@@ -330,6 +704,9 @@ class TranslationUnit:
 
         body.append("")
         body.append("// (function body start)")
+
+        if is_resumable:
+            body.append("PY_RESUMABLE_PROLOGUE();")
         
         # This maps label indices (instr.label) to offsets.
         labels = sorted([
@@ -342,8 +719,69 @@ class TranslationUnit:
             return next((f"L{i + 1}" for i, x in enumerate(labels) if x == offset), None)
 
         prev_handler_region: str | None = None
-
-        for instr_idx, instr in enumerate(bytecode):
+        instructions = list(bytecode)
+
+        # Calls to the `struct` module with constant formats are compiled to specialized
+        # kernels. When the result of such a call is destructured right away, the call also
+        # takes care of the UNPACK_SEQUENCE.
+        struct_calls = find_struct_calls(
+            instructions,
+            {
+                name: origin for name, (origin_module, origin) in self.modules[module].native_globals.items()
+                if origin_module == "struct"
+            },
+            set(labels)
+        )
+
+        # Calls to the `float` functions of the `math` module call their kernels directly.
+        math_calls = find_math_calls(
+            instructions,
+            {
+                name: origin for name, (origin_module, origin) in self.modules[module].native_globals.items()
+                if origin_module == "math"
+            },
+            set(labels)
+        )
+
+        # Calls to `@extern` and `@c_function` functions pass the unboxed arguments to their
+        # symbols directly.
+        extern_calls = find_extern_calls(instructions, self.modules[module].extern_globals, set(labels))
+
+        # Calls to the builtins that access a single device register are compiled to inline
+        # volatile loads and stores.
+        mmio_calls = find_mmio_calls(
+            instructions,
+            set(self.modules[module].native_globals) | set(self.modules[module].extern_globals),
+            set(labels)
+        )
+
+        # The instructions of operations that are compiled together with the register read
+        # before them are skipped.
+        ignore_ranges += [(idx + 1, idx + 2) for idx, call in mmio_calls.items() if call.operation is not None]
+
+        # Calls to functions of this module that return a tuple of the same length, which is
+        # unpacked right away, call the variant that returns the items without the tuple.
+        values_calls = find_values_calls(instructions, self.modules[module].function_globals, set(labels))
+
+        # A tuple that is unpacked right after it is built (e.g. `a, b, c, d = d, c, b, a`)
+        # is never allocated - the items only have to be reversed.
+        unpacked_tuples = {
+            idx for idx, (x, y) in enumerate(zip(instructions, instructions[1:]))
+            if x.opname == "BUILD_TUPLE" and y.opname == "UNPACK_SEQUENCE" and x.arg == y.arg and y.offset not in labels
+        }
+
+        returned_tuples = {
+            idx for idx, (x, y) in enumerate(zip(instructions, instructions[1:]))
+            if x.opname == "BUILD_TUPLE" and y.opname == "RETURN_VALUE"
+        } if return_count is not None else set()
+
+        fused_unpacks = {
+            *(idx + 1 for idx, call in struct_calls.items() if call.destructured),
+            *(idx + 1 for idx in values_calls),
+            *(idx + 1 for idx in unpacked_tuples)
+        }
+
+        for instr_idx, instr in enumerate(instructions):
             body.append(f"// {instr.offset}: {str(instr).strip()}")
 
             label = label_by_offset(instr.offset)
@@ -378,6 +816,11 @@ class TranslationUnit:
             exc_depth = exc_info.depth if exc_info is not None else 0
             exc_lasti = instr.offset if exc_info is not None else -1
 
+            extern_store = extern_stores.get(instr_idx)
+            if extern_store is not None:
+                body.append(f"{self.mangle_global(extern_store.name, module)} = &FUNCTION_WRAPPER({extern_store.c_name()});")
+                continue
+
             if any(instr_idx >= r[0] and instr_idx <= r[1] for r in ignore_ranges):
                 continue
 
@@ -440,16 +883,169 @@ class TranslationUnit:
                     else:
                         body.append(f'{STACK_PUSH} = NOT_NULL(py_get_attribute(self, "{fn.co_varnames[instr.arg >> 4]}"));')
                         body.append(f'{STACK_PUSH} = NOT_NULL(py_get_attribute(self, "{fn.co_varnames[instr.arg & 15]}"));')
+                case "LOAD_FAST_AND_CLEAR":
+                    # Emitted by inlined comprehensions to save the outer value of the
+                    # iteration variable, which is restored later with STORE_FAST.
+                    assert instr.arg is not None
+
+                    if is_class_body:
+                        raise Exception("Comprehensions are not yet supported in class bodies.")
+
+                    name = fn.co_varnames[instr.arg]
+                    body.append(f"{STACK_PUSH} = loc_{name};")
+                    body.append(f"loc_{name} = NULL;")
+                case "STORE_FAST_LOAD_FAST" | "STORE_FAST_STORE_FAST":
+                    assert instr.arg is not None
+
+                    if is_class_body:
+                        raise Exception(f"{instr.opname} is not yet supported in class bodies.")
+
+                    body.append(f"loc_{fn.co_varnames[instr.arg >> 4]} = (pyobj_t*)({STACK_POP});")
+
+                    if instr.opname == "STORE_FAST_LOAD_FAST":
+                        body.append(f"{STACK_PUSH} = loc_{fn.co_varnames[instr.arg & 15]};")
+                    else:
+                        body.append(f"loc_{fn.co_varnames[instr.arg & 15]} = (pyobj_t*)({STACK_POP});")
+                case "BUILD_LIST":
+                    assert instr.arg is not None
+
+                    # List comprehensions start with the following sequence, where the
+                    # iterator is on top of the stack when the list is built:
+                    #       BUILD_LIST               0
+                    #       SWAP                     2
+                    #       FOR_ITER                 ...
+                    following = instructions[instr_idx + 1 : instr_idx + 3]
+                    is_comprehension = (
+                        instr.arg == 0 and
+                        [x.opname for x in following] == ["SWAP", "FOR_ITER"] and
+                        following[0].arg == 2
+                    )
+
+                    if is_comprehension:
+                        body.append("PY_OPCODE_BUILD_LIST_PRESIZED();")
+                    else:
+                        body.append(f"PY_OPCODE_BUILD_LIST({instr.arg});")
+                case "BUILD_TUPLE":
+                    if instr_idx in returned_tuples:
+                        body.append("// (returned through the values array)")
+                    elif instr_idx in unpacked_tuples:
+                        body.append(f"PY_OPCODE_BUILD_TUPLE_UNPACKED({instr.arg});")
+                    else:
+                        body.append(f"PY_OPCODE_BUILD_TUPLE({instr.arg});")
+                case "LIST_APPEND":
+                    body.append(f"PY_OPCODE_LIST_APPEND({instr.arg});")
+                case "LIST_EXTEND":
+                    body.append(f"PY_OPCODE_LIST_EXTEND({instr.arg}, {exc_depth}, {exc_lasti});")
+                case "BUILD_MAP":
+                    body.append(f"PY_OPCODE_BUILD_MAP({instr.arg}, {exc_depth}, {exc_lasti});")
+                case "BUILD_CONST_KEY_MAP":
+                    body.append(f"PY_OPCODE_BUILD_CONST_KEY_MAP({instr.arg}, {exc_depth}, {exc_lasti});")
+                case "MAP_ADD":
+                    body.append(f"PY_OPCODE_MAP_ADD({instr.arg}, {exc_depth}, {exc_lasti});")
+                case "DICT_UPDATE":
+                    body.append(f"PY_OPCODE_DICT_UPDATE({instr.arg}, {exc_depth}, {exc_lasti});")
+                case "CONTAINS_OP":
+                    # An argument of 1 means that this is a "not in" check.
+                    body.append(f"PY_OPCODE_CONTAINS_OP({'true' if instr.arg == 1 else 'false'}, {exc_depth}, {exc_lasti});")
+                case "BUILD_SET":
+                    body.append(f"PY_OPCODE_BUILD_SET({instr.arg}, {exc_depth}, {exc_lasti});")
+                case "SET_ADD":
+                    body.append(f"PY_OPCODE_SET_ADD({instr.arg}, {exc_depth}, {exc_lasti});")
+                case "SET_UPDATE":
+                    body.append(f"PY_OPCODE_SET_UPDATE({instr.arg}, {exc_depth}, {exc_lasti});")
+                case "BUILD_STRING":
+                    body.append(f"PY_OPCODE_BUILD_STRING({instr.arg});")
+                case "FORMAT_SIMPLE":
+                    body.append(f"PY_OPCODE_FORMAT_SIMPLE({exc_depth}, {exc_lasti});")
+                case "FORMAT_WITH_SPEC":
+                    body.append(f"PY_OPCODE_FORMAT_WITH_SPEC({exc_depth}, {exc_lasti});")
+                case "CONVERT_VALUE":
+                    body.append(f"PY_OPCODE_CONVERT_VALUE({instr.arg}, {exc_depth}, {exc_lasti});")
+                case "BINARY_SUBSCR":
+                    body.append(f"PY_OPCODE_OPERATION(subscr, {exc_depth}, {exc_lasti});")
+                case "STORE_SUBSCR":
+                    body.append(f"PY_OPCODE_STORE_SUBSCR({exc_depth}, {exc_lasti});")
+                case "DELETE_SUBSCR":
+                    body.append(f"PY_OPCODE_DELETE_SUBSCR({exc_depth}, {exc_lasti});")
+                case "BINARY_SLICE":
+                    body.append(f"PY_OPCODE_BINARY_SLICE({exc_depth}, {exc_lasti});")
+                case "STORE_SLICE":
+                    body.append(f"PY_OPCODE_STORE_SLICE({exc_depth}, {exc_lasti});")
+                case "BUILD_SLICE":
+                    body.append(f"PY_OPCODE_BUILD_SLICE({instr.arg});")
+                case "TO_BOOL":
+                    body.append(f"PY_OPCODE_TO_BOOL({exc_depth}, {exc_lasti});")
                 case "CALL":
-                    body.append(f"PY_OPCODE_CALL({instr.arg}, {exc_depth}, {exc_lasti});")
+                    struct_call = struct_calls.get(instr_idx)
+                    values_call = values_calls.get(instr_idx)
+                    math_call = math_calls.get(instr_idx)
+                    extern_call = extern_calls.get(instr_idx)
+                    mmio_call = mmio_calls.get(instr_idx)
+                    if struct_call is not None:
+                        body.extend(self.specialize_struct_call(struct_call, exc_depth, exc_lasti))
+                    elif math_call is not None:
+                        body.extend(self.specialize_math_call(math_call, exc_depth, exc_lasti))
+                    elif extern_call is not None:
+                        body.extend(create_direct_call(extern_call, exc_depth, exc_lasti))
+                    elif mmio_call is not None:
+                        body.extend(self.specialize_mmio_call(mmio_call, exc_depth, exc_lasti))
+                    elif values_call is not None:
+                        body.extend(self.specialize_values_call(values_call, module, exc_depth, exc_lasti))
+                    else:
+                        body.append(f"PY_OPCODE_CALL({instr.arg}, {exc_depth}, {exc_lasti});")
+                case "CALL_KW":
+                    body.append(f"PY_OPCODE_CALL_KW({instr.arg}, {exc_depth}, {exc_lasti});")
+                case "CALL_FUNCTION_EX":
+                    body.append(f"PY_OPCODE_CALL_FUNCTION_EX({instr.arg}, {exc_depth}, {exc_lasti});")
+                case "UNPACK_SEQUENCE":
+                    if instr_idx in fused_unpacks:
+                        body.append("// (fused with the preceding instruction)")
+                    else:
+                        body.append(f"PY_OPCODE_UNPACK_SEQUENCE({instr.arg}, {exc_depth}, {exc_lasti});")
                 case "RETURN_VALUE":
                     # We don't do STACK_POP here, since it would be redundant to decrement
                     # the stack_current counter.
-                    body.append(f"return WITH_RESULT(stack[stack_current]);")
+                    if return_count is not None:
+                        body.append(f"PY_RETURN_VALUES({return_count});")
+                    elif not is_resumable:
+                        body.append(f"return WITH_RESULT(stack[stack_current]);")
+                    else:
+                        body.append(f"PY_RESUMABLE_RETURN(stack[stack_current]);")
                 case "POP_TOP":
                     body.append(f"stack_current--;")
                 case "RETURN_CONST":
-                    body.append(f"return WITH_RESULT(&const_{instr.arg});")
+                    if return_count is not None:
+                        body.append(f"PY_RETURN_CONST_VALUES(const_{instr.arg}, {return_count});")
+                    elif not is_resumable:
+                        body.append(f"return WITH_RESULT(&const_{instr.arg});")
+                    else:
+                        body.append(f"PY_RESUMABLE_RETURN(&const_{instr.arg});")
+                case "RETURN_GENERATOR":
+                    assert is_resumable
+                    body.append("PY_OPCODE_RETURN_GENERATOR();")
+                case "YIELD_VALUE":
+                    assert is_resumable
+                    body.append(f"PY_OPCODE_YIELD_VALUE(L_resume_{instr.offset});")
+                case "GET_AWAITABLE":
+                    body.append(f"PY_OPCODE_GET_AWAITABLE({exc_depth}, {exc_lasti});")
+                case "GET_YIELD_FROM_ITER":
+                    body.append(f"PY_OPCODE_GET_YIELD_FROM_ITER({exc_depth}, {exc_lasti});")
+                case "SEND":
+                    target_label = label_by_offset(instr.jump_target)
+                    body.append(f"PY_OPCODE_SEND({target_label}, {exc_depth}, {exc_lasti});")
+                case "END_SEND":
+                    body.append("PY_OPCODE_END_SEND();")
+                case "CLEANUP_THROW":
+                    body.append(f"PY_OPCODE_CLEANUP_THROW({exc_depth}, {exc_lasti});")
+                case "CALL_INTRINSIC_1":
+                    if instr.arg == 3:
+                        # INTRINSIC_STOPITERATION_ERROR
+                        body.append("PY_OPCODE_INTRINSIC_STOPITERATION_ERROR();")
+                    elif instr.arg == 6:
+                        # INTRINSIC_LIST_TO_TUPLE
+                        body.append("PY_OPCODE_INTRINSIC_LIST_TO_TUPLE();")
+                    else:
+                        raise Exception(f"CALL_INTRINSIC_1 with intrinsic {instr.argrepr} is not yet supported")
                 case "STORE_NAME":
                     assert instr.arg is not None
                     name = fn.co_names[instr.arg]
@@ -487,16 +1083,11 @@ class TranslationUnit:
                     operation = dis.cmp_op[instr.arg >> 5]
                     coerce_bool = (instr.arg & 16) != 0 # fifth lowest bit
 
-                    op = {
-                        "<": "lt",
-                        "<=": "lte",
-                        "==": "equ",
-                        "!=": "neq",
-                        ">": "gt",
-                        ">=": "gte"
-                    }[operation]
+                    op = COMPARISON_OPS[operation]
 
                     body.append(f"PY_OPCODE_COMPARISON({op}, {c_bool(coerce_bool)}, {exc_depth}, {exc_lasti});")
+                case "UNARY_NEGATIVE":
+                    body.append(f"PY_OPCODE_UNARY_NEGATIVE({exc_depth}, {exc_lasti});")
                 case "POP_JUMP_IF_FALSE":
                     target_label = label_by_offset(instr.jump_target)
                     body.append(f"PY_OPCODE_POP_JUMP_IF_FALSE({target_label});")
@@ -517,7 +1108,7 @@ class TranslationUnit:
                         NB_POWER: "pow",
                         NB_RSHIFT: "rsh",
                         NB_SUBTRACT: "sub",
-                        NB_TRUE_DIVIDE: "floordiv", # TODO!
+                        NB_TRUE_DIVIDE: "truediv",
                         NB_XOR: "xor",
                         NB_INPLACE_ADD: "iadd",
                         NB_INPLACE_AND: "iand",
@@ -530,7 +1121,7 @@ class TranslationUnit:
                         NB_INPLACE_POWER: "ipow",
                         NB_INPLACE_RSHIFT: "irsh",
                         NB_INPLACE_SUBTRACT: "isub",
-                        NB_INPLACE_TRUE_DIVIDE: "ifloordiv", # TODO!!
+                        NB_INPLACE_TRUE_DIVIDE: "itruediv",
                         NB_INPLACE_XOR: "ixor",
                         NB_SUBSCR: "subscr"
                     }[instr.arg]
@@ -593,8 +1184,11 @@ class TranslationUnit:
                     target_label = label_by_offset(instr.jump_target)
                     body.append(f"PY_OPCODE_FOR_ITER({target_label}, {exc_depth}, {exc_lasti});")
                 case "END_FOR":
-                    # Removes the top-of-stack item. Equivalent to POP_TOP.
-                    body.append(f"stack_current--;")
+                    # Removes the top-of-stack item. END_FOR is only ever reached by the
+                    # jump FOR_ITER makes when its iterator is exhausted - and unlike in
+                    # CPython, we don't push anything in that case. The POP_TOP that
+                    # follows removes the iterator itself.
+                    body.append(f"// (nothing to remove)")
                 case _:
                     error(f"unknown opcode '{instr.opname}'!")
                     error(f"the full disassembly of the target function is displayed below")
@@ -615,7 +1209,17 @@ class TranslationUnit:
         for sym in defined_preprocessor_syms:
             body.append(f"#undef {sym}")
 
-        self.modules[module].transpiled[mangled_name] = TranspiledFunction("\n".join(body), fn)
+        if not is_resumable:
+            transpiled = TranspiledFunction("\n".join(body), fn, return_count = return_count)
+        else:
+            frame_body = [
+                f"// Creates the frame for {fn.co_qualname} - see {resumable_name(mangled_name)}",
+                *arg_binding
+            ]
+
+            transpiled = TranspiledFunction("\n".join(frame_body), fn, "\n".join(body))
+
+        self.modules[module].transpiled[mangled_name] = transpiled
         return mangled_name
 
     def transpile(self, entrypoint: str | None = None):
@@ -636,9 +1240,15 @@ class TranslationUnit:
         lines.append("")
 
         lines.append("// Transpiled function declarations")
-        for fn_name in self.all_transpiled().keys():
+        for fn_name, fn_transpiled in self.all_transpiled().items():
             lines.append(f"PY_DEFINE({fn_name});")
 
+            if fn_transpiled.resumable_body is not None:
+                lines.append(f"PY_DEFINE_RESUMABLE({resumable_name(fn_name)});")
+
+            if fn_transpiled.return_count is not None:
+                lines.append(f"PY_DEFINE_VALUES({values_name(fn_name)});")
+
         lines.append("")
         lines.append("// Module-specific definitions/declarations")
         for module in self.modules.values():
@@ -663,6 +1273,16 @@ class TranslationUnit:
         lines.extend(self.const_definitions)
         lines.append("")
 
+        if len(self.struct_kernel_definitions) != 0:
+            lines.append("// Specialized struct kernels")
+            lines.extend(self.struct_kernel_definitions)
+
+        if len(self.externs) != 0:
+            lines.append("// Marshalling stubs for @extern and @c_function functions")
+            for spec in self.externs.values():
+                lines.extend(create_marshalling_stub(spec))
+                lines.append("")
+
         if entrypoint is not None:
             lines.append(f"DEFINE_ENTRYPOINT({entrypoint});")
             lines.append("")
@@ -672,6 +1292,17 @@ class TranslationUnit:
             for fn_name, fn_transpiled in module.transpiled.items():
                 fn_body = fn_transpiled.body
 
+                if fn_transpiled.return_count is not None:
+                    lines.append("PY_DEFINE(" + fn_name + ") {")
+                    lines.append(f"    PY_RETURN_VALUES_AS_TUPLE({values_name(fn_name)}, {fn_transpiled.return_count});")
+                    lines.append("}")
+                    lines.append("")
+                    lines.append("PY_DEFINE_VALUES(" + values_name(fn_name) + ") {")
+                    lines.append(textwrap.indent(fn_body, "    "))
+                    lines.append("}")
+                    lines.append("")
+                    continue
+
                 lines.append("PY_DEFINE(" + fn_name + ") {")
 
                 if module.name != "__main__" and fn_transpiled.origin.co_name == "<module>":
@@ -690,5 +1321,11 @@ class TranslationUnit:
                 lines.append("}")
                 lines.append("")
 
+                if fn_transpiled.resumable_body is not None:
+                    lines.append("PY_DEFINE_RESUMABLE(" + resumable_name(fn_name) + ") {")
+                    lines.append(textwrap.indent(fn_transpiled.resumable_body, "    "))
+                    lines.append("}")
+                    lines.append("")
+
         return "\n".join(lines)
-    
\ No newline at end of file
+    
\ No newline at end of file